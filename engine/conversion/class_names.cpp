@@ -6,5 +6,7 @@ namespace lexgine::conversion::class_names
 
 extern char const TextureConverter[] = "lexgine::conversion::TextureConverter";
 extern char const ImageLoader[] = "lexgine::conversion::ImageLoader";
+extern char const Ktx2LevelStream[] = "lexgine::conversion::Ktx2LevelStream";
+extern char const TextureResidencyManager[] = "lexgine::conversion::TextureResidencyManager";
 
 }
\ No newline at end of file
@@ -6,6 +6,8 @@ namespace lexgine::conversion::class_names
 
 extern char const TextureConverter[];
 extern char const ImageLoader[];
+extern char const Ktx2LevelStream[];
+extern char const TextureResidencyManager[];
 
 }
 
@@ -100,24 +100,29 @@ void resizeImage(uint8_t const* src_image_data, size_t src_image_width, size_t s
 std::pair<bool, ImageLoader::Description> ImageLoader::load(std::filesystem::path const& uri, std::vector<uint8_t>& image_data_buffer)
 {
     Description description = {};
-    auto binary_data = core::misc::readBinaryDataFromSourceFile(uri.string());
-    if (!binary_data.isValid())
-    {
-        LEXGINE_LOG_ERROR(this, "Error while reading image '" + uri.string() + "'");
-        return { false, description };
-    }
     description.uri = uri.string();
     description.timestamp = getTimestampForUri(uri);
-    bool res = doLoad(*binary_data, image_data_buffer, description);
+    bool res = doLoadFromFile(uri, image_data_buffer, description);
     if (res)
     {
         glm::uvec3& dims = description.layers[0].mipmaps[0].dimensions;
         size_t texel_size = description.element_count * description.element_size;
-        image_data_buffer.resize(calculateMipmapPyramidCapacity(dims.x, dims.y, dims.z) * texel_size);
+        image_data_buffer.resize((std::max)(image_data_buffer.size(), calculateMipmapPyramidCapacity(dims.x, dims.y, dims.z) * texel_size));
     }
     return { res, description };
 }
 
+bool ImageLoader::doLoadFromFile(std::filesystem::path const& uri, std::vector<uint8_t>& image_data_buffer, Description& desc)
+{
+    auto binary_data = core::misc::readBinaryDataFromSourceFile(uri.string());
+    if (!binary_data.isValid())
+    {
+        LEXGINE_LOG_ERROR(this, "Error while reading image '" + uri.string() + "'");
+        return false;
+    }
+    return doLoad(*binary_data, image_data_buffer, desc);
+}
+
 inline unsigned int pow2(unsigned int value, unsigned int power)
 {
     return 1 << value * power;
@@ -74,6 +74,11 @@ public:
 
 protected:
     virtual bool doLoad(std::vector<uint8_t> const& raw_binary_data, std::vector<uint8_t>& image_data_buffer, Description& desc) = 0;
+
+    /*! Loads image from its source file. The default implementation reads the whole file into memory and forwards it to doLoad(...).
+     Loaders capable of reading the image data from the file selectively may override this function to avoid the intermediate copy
+    */
+    virtual bool doLoadFromFile(std::filesystem::path const& uri, std::vector<uint8_t>& image_data_buffer, Description& desc);
     
     // Internal utility functions
     uint32_t roundToNextMultipleOf4(uint32_t x, ImageCompressedDataFormat compression)
@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "3rd_party/zlib/zlib.h"
+#include "3rd_party/ktx/lib/basisu/zstd/zstd.h"
+
+#include <engine/core/misc/log.h>
+#include "ktx2_level_stream.h"
+
+namespace lexgine::conversion
+{
+
+namespace
+{
+
+constexpr std::array<uint8_t, 12> c_ktx2_identifier = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+constexpr size_t c_ktx2_header_size = 80U;    // identifier, image properties and the index of DFD, KVD and SGD blocks
+constexpr size_t c_ktx2_level_index_entry_size = 24U;
+constexpr uint64_t c_maximal_deflate_ratio = 1032U;    // deflate cannot expand the data by more than this factor
+constexpr size_t c_maximal_zstd_frame_header_size = 18U;
+
+template<typename T>
+T readLittleEndian(uint8_t const* p_data)
+{
+    T rv{};
+    for (size_t i = 0; i < sizeof(T); ++i)
+    {
+        rv |= static_cast<T>(p_data[i]) << (8 * i);
+    }
+    return rv;
+}
+
+}    // namespace
+
+
+Ktx2LevelStream::Ktx2LevelStream(std::filesystem::path const& uri)
+    : m_uri{ uri }
+    , m_file_stream{ uri, std::ios_base::in | std::ios_base::binary }
+    , m_is_valid{ false }
+    , m_vk_format{ 0 }
+    , m_layer_count{ 1 }
+    , m_face_count{ 1 }
+    , m_supercompression_scheme{ SupercompressionScheme::none }
+{
+    std::error_code error_code{};
+    uint64_t const file_size = static_cast<uint64_t>(std::filesystem::file_size(uri, error_code));
+    if (!m_file_stream || error_code)
+    {
+        LEXGINE_LOG_ERROR(this, "Unable to open KTX2 file '" + m_uri.string() + "'");
+        return;
+    }
+
+    std::array<uint8_t, c_ktx2_header_size> header{};
+    if (!m_file_stream.read(reinterpret_cast<char*>(header.data()), header.size())
+        || !std::equal(c_ktx2_identifier.begin(), c_ktx2_identifier.end(), header.begin()))
+    {
+        LEXGINE_LOG_ERROR(this, "File '" + m_uri.string() + "' is not a valid KTX2 file");
+        return;
+    }
+
+    m_vk_format = readLittleEndian<uint32_t>(header.data() + 12);
+    m_layer_count = (std::max)(readLittleEndian<uint32_t>(header.data() + 32), 1U);
+    m_face_count = (std::max)(readLittleEndian<uint32_t>(header.data() + 36), 1U);
+    uint32_t const level_count = (std::max)(readLittleEndian<uint32_t>(header.data() + 40), 1U);
+    m_supercompression_scheme = static_cast<SupercompressionScheme>(readLittleEndian<uint32_t>(header.data() + 44));
+
+    // none of the fields read from the header is trusted before it is checked against the size of the file
+    if (level_count > (file_size - c_ktx2_header_size) / c_ktx2_level_index_entry_size)
+    {
+        LEXGINE_LOG_ERROR(this, "Level index of KTX2 file '" + m_uri.string() + "' does not fit into the file");
+        return;
+    }
+
+    std::vector<uint8_t> level_index_data(level_count * c_ktx2_level_index_entry_size);
+    if (!m_file_stream.read(reinterpret_cast<char*>(level_index_data.data()), level_index_data.size()))
+    {
+        LEXGINE_LOG_ERROR(this, "Unable to read level index of KTX2 file '" + m_uri.string() + "'");
+        return;
+    }
+
+    m_level_index.resize(level_count);
+    for (uint32_t level = 0; level < level_count; ++level)
+    {
+        uint8_t const* p_entry = level_index_data.data() + level * c_ktx2_level_index_entry_size;
+        m_level_index[level] = LevelIndexEntry{
+            .byte_offset = readLittleEndian<uint64_t>(p_entry),
+            .byte_length = readLittleEndian<uint64_t>(p_entry + 8),
+            .uncompressed_byte_length = readLittleEndian<uint64_t>(p_entry + 16)
+        };
+
+        if (!isLevelIndexEntryValid(level, file_size))
+        {
+            LEXGINE_LOG_ERROR(this, "Level index of KTX2 file '" + m_uri.string() + "' is corrupt at level " + std::to_string(level));
+            m_level_index.clear();
+            return;
+        }
+    }
+
+    m_is_valid = true;
+}
+
+bool Ktx2LevelStream::isLevelIndexEntryValid(uint32_t level, uint64_t file_size)
+{
+    LevelIndexEntry const& entry = m_level_index[level];
+    if (entry.byte_offset > file_size || entry.byte_length > file_size - entry.byte_offset
+        || entry.uncompressed_byte_length % imageCountPerLevel() != 0)
+    {
+        return false;
+    }
+
+    switch (m_supercompression_scheme)
+    {
+    case SupercompressionScheme::none:
+        return entry.uncompressed_byte_length == entry.byte_length;
+
+    case SupercompressionScheme::zlib:
+        return entry.uncompressed_byte_length <= entry.byte_length * c_maximal_deflate_ratio;
+
+    case SupercompressionScheme::zstd:
+    {
+        // Zstd frames record the size of their content, so that the uncompressed length can be verified before anything is allocated for it
+        std::array<uint8_t, c_maximal_zstd_frame_header_size> frame_header{};
+        size_t const frame_header_size = static_cast<size_t>((std::min)(entry.byte_length, uint64_t{ c_maximal_zstd_frame_header_size }));
+        if (!m_file_stream.seekg(static_cast<std::streamoff>(entry.byte_offset))
+            || !m_file_stream.read(reinterpret_cast<char*>(frame_header.data()), static_cast<std::streamsize>(frame_header_size)))
+        {
+            m_file_stream.clear();
+            return false;
+        }
+        return ZSTD_getFrameContentSize(frame_header.data(), frame_header_size) == entry.uncompressed_byte_length;
+    }
+
+    default:
+        // the levels are not decoded by the stream
+        return true;
+    }
+}
+
+bool Ktx2LevelStream::supportsPerLevelDecoding() const
+{
+    switch (m_supercompression_scheme)
+    {
+    case SupercompressionScheme::none:
+    case SupercompressionScheme::zstd:
+    case SupercompressionScheme::zlib:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+bool Ktx2LevelStream::readRawLevel(uint32_t level, std::vector<uint8_t>& raw_level_data)
+{
+    LevelIndexEntry const& entry = m_level_index[level];
+    raw_level_data.resize(static_cast<size_t>(entry.byte_length));
+
+    std::scoped_lock<std::mutex> lock{ m_file_stream_access_mutex };
+    if (!m_file_stream.seekg(static_cast<std::streamoff>(entry.byte_offset))
+        || !m_file_stream.read(reinterpret_cast<char*>(raw_level_data.data()), static_cast<std::streamsize>(raw_level_data.size())))
+    {
+        m_file_stream.clear();
+        LEXGINE_LOG_ERROR(this, "Unable to read level " + std::to_string(level) + " from KTX2 file '" + m_uri.string() + "'");
+        return false;
+    }
+
+    return true;
+}
+
+bool Ktx2LevelStream::decodeLevel(uint32_t level, std::span<uint8_t const> raw_level_data, std::span<uint8_t> destination) const
+{
+    LevelIndexEntry const& entry = m_level_index[level];
+    if (destination.size() < entry.uncompressed_byte_length)
+    {
+        LEXGINE_LOG_ERROR(this, "Destination buffer is too small to receive level " + std::to_string(level) + " of KTX2 file '" + m_uri.string() + "'");
+        return false;
+    }
+
+    switch (m_supercompression_scheme)
+    {
+    case SupercompressionScheme::none:
+        std::copy(raw_level_data.begin(), raw_level_data.end(), destination.begin());
+        return true;
+
+    case SupercompressionScheme::zstd:
+    {
+        size_t const result = ZSTD_decompress(destination.data(), destination.size(), raw_level_data.data(), raw_level_data.size());
+        if (ZSTD_isError(result) || result != entry.uncompressed_byte_length)
+        {
+            LEXGINE_LOG_ERROR(this, "Unable to inflate Zstd-supercompressed level " + std::to_string(level) + " of KTX2 file '" + m_uri.string() + "'");
+            return false;
+        }
+        return true;
+    }
+
+    case SupercompressionScheme::zlib:
+    {
+        uLongf inflated_size = static_cast<uLongf>(destination.size());
+        if (uncompress(destination.data(), &inflated_size, raw_level_data.data(), static_cast<uLong>(raw_level_data.size())) != Z_OK
+            || inflated_size != entry.uncompressed_byte_length)
+        {
+            LEXGINE_LOG_ERROR(this, "Unable to inflate ZLIB-supercompressed level " + std::to_string(level) + " of KTX2 file '" + m_uri.string() + "'");
+            return false;
+        }
+        return true;
+    }
+
+    default:
+        LEXGINE_LOG_ERROR(this, "Supercompression scheme of KTX2 file '" + m_uri.string() + "' does not allow to decode levels independently");
+        return false;
+    }
+}
+
+bool Ktx2LevelStream::readLevel(uint32_t level, std::span<uint8_t> destination)
+{
+    if (m_supercompression_scheme == SupercompressionScheme::none)
+    {
+        LevelIndexEntry const& entry = m_level_index[level];
+        if (destination.size() < entry.byte_length)
+        {
+            LEXGINE_LOG_ERROR(this, "Destination buffer is too small to receive level " + std::to_string(level) + " of KTX2 file '" + m_uri.string() + "'");
+            return false;
+        }
+
+        std::scoped_lock<std::mutex> lock{ m_file_stream_access_mutex };
+        if (!m_file_stream.seekg(static_cast<std::streamoff>(entry.byte_offset))
+            || !m_file_stream.read(reinterpret_cast<char*>(destination.data()), static_cast<std::streamsize>(entry.byte_length)))
+        {
+            m_file_stream.clear();
+            LEXGINE_LOG_ERROR(this, "Unable to read level " + std::to_string(level) + " from KTX2 file '" + m_uri.string() + "'");
+            return false;
+        }
+        return true;
+    }
+
+    std::vector<uint8_t> raw_level_data{};
+    return readRawLevel(level, raw_level_data) && decodeLevel(level, raw_level_data, destination);
+}
+
+}
@@ -0,0 +1,83 @@
+#ifndef LEXGINE_CONVERSION_KTX2_LEVEL_STREAM_H
+#define LEXGINE_CONVERSION_KTX2_LEVEL_STREAM_H
+
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include <engine/core/entity.h>
+#include "class_names.h"
+
+namespace lexgine::conversion
+{
+
+/*! Provides random access to individual mipmap levels of a KTX2 file. Only the header and the level index are read
+ on construction, the level data are read from the file (and decoded when supercompressed) on demand.
+ The level index is validated against the size of the file, so that the sizes of the buffers allocated for the levels
+ are bounded by the file even if the file is corrupt.
+ Reading from the file is serialized internally, while decoding of already read levels can run on any number of threads
+*/
+class Ktx2LevelStream final : public core::NamedEntity<class_names::Ktx2LevelStream>
+{
+public:
+    enum class SupercompressionScheme : uint32_t
+    {
+        none = 0,
+        basis_lz = 1,
+        zstd = 2,
+        zlib = 3
+    };
+
+    struct LevelIndexEntry
+    {
+        uint64_t byte_offset;    //!< offset of the level data from the beginning of the file
+        uint64_t byte_length;    //!< size of the level data as stored in the file
+        uint64_t uncompressed_byte_length;    //!< size of the level data after supercompression has been removed
+    };
+
+public:
+    Ktx2LevelStream(std::filesystem::path const& uri);
+
+    operator bool() const { return m_is_valid; }    //! returns 'true' if the header and the level index of the file were successfully parsed
+
+    uint32_t vkFormat() const { return m_vk_format; }
+    uint32_t layerCount() const { return m_layer_count; }
+    uint32_t faceCount() const { return m_face_count; }
+    uint32_t levelCount() const { return static_cast<uint32_t>(m_level_index.size()); }
+    uint32_t imageCountPerLevel() const { return m_layer_count * m_face_count; }    //! number of images (i.e. array layers times cubemap faces) stored in each level
+    SupercompressionScheme supercompressionScheme() const { return m_supercompression_scheme; }
+    LevelIndexEntry const& levelIndexEntry(uint32_t level) const { return m_level_index[level]; }
+
+    //! returns 'true' if the levels can be decoded independently from each other (BasisLZ needs global codebooks and is not supported)
+    bool supportsPerLevelDecoding() const;
+
+    //! reads data of the given level as it is stored in the file, i.e. without removing supercompression
+    bool readRawLevel(uint32_t level, std::vector<uint8_t>& raw_level_data);
+
+    //! removes supercompression from the raw level data. The destination must be at least LevelIndexEntry::uncompressed_byte_length bytes large
+    bool decodeLevel(uint32_t level, std::span<uint8_t const> raw_level_data, std::span<uint8_t> destination) const;
+
+    //! reads the given level and places its decoded data into the destination. Levels with no supercompression are read directly into the destination
+    bool readLevel(uint32_t level, std::span<uint8_t> destination);
+
+private:
+    bool isLevelIndexEntryValid(uint32_t level, uint64_t file_size);    //! checks that the level lies within the file and that its uncompressed size is plausible
+
+private:
+    std::filesystem::path m_uri;
+    std::ifstream m_file_stream;
+    std::mutex m_file_stream_access_mutex;
+    bool m_is_valid;
+
+    uint32_t m_vk_format;
+    uint32_t m_layer_count;
+    uint32_t m_face_count;
+    SupercompressionScheme m_supercompression_scheme;
+    std::vector<LevelIndexEntry> m_level_index;
+};
+
+}
+
+#endif
@@ -7,6 +7,8 @@ extern "C" {
 }
 #undef KHRONOS_STATIC
 
+#include <engine/core/misc/misc.h>
+#include "ktx2_level_stream.h"
 #include "ktx_image_loader.h"
 
 namespace lexgine::conversion
@@ -105,7 +107,7 @@ ImageCompressedDataFormat ktxTexture_GetCompressionFormat(ktxTexture* p_ktx_text
 bool KtxImageLoader::canLoad(std::filesystem::path const& uri) const
 {
     std::string ext = core::misc::toLowerCase(uri.extension().string());
-    return ext == ".ktx";
+    return ext == ".ktx" || ext == ".ktx2";
 }
 
 bool KtxImageLoader::doLoad(std::vector<uint8_t> const& raw_binary_data, std::vector<uint8_t>& image_data_buffer, Description& desc)
@@ -120,32 +122,12 @@ bool KtxImageLoader::doLoad(std::vector<uint8_t> const& raw_binary_data, std::ve
 
 
     size_t num_layers{}, num_levels{ p_ktx_texture->numLevels }, ktx_texture_data_size{ static_cast<size_t>(p_ktx_texture->dataSize) };
+    if (!readKtxTextureMetadata(p_ktx_texture, desc))
     {
-        // fill in texture metadata
-        desc.is_cubemap = p_ktx_texture->numLayers == 1 && p_ktx_texture->numFaces == 6;
-        num_layers = desc.is_cubemap ? 6 : p_ktx_texture->numLayers;
-        auto texel_size = ktxTexture_GetElementSize(p_ktx_texture);
-        desc.element_count = ktxTexture_GetElementCount(p_ktx_texture);
-        desc.element_size = texel_size / desc.element_count;
-        desc.compression_format = ktxTexture_GetCompressionFormat(p_ktx_texture);
-        desc.subresource_count = num_layers * num_levels;
-
-        if (desc.compression_format == ImageCompressedDataFormat::unknown)
-        {
-            LEXGINE_LOG_ERROR(this, "Unable to parse KTX texture: the texture appears to be compressed, but its compression format is not supported");
-            return false;
-        }
-
-        if (desc.element_count < 1 || desc.element_count > 4)
-        {
-            LEXGINE_LOG_ERROR(this, "Unable to parse KTX texture: the element size of " + std::to_string(desc.element_count) + "is not supported");
-            return false;
-        }
-
-        if (desc.element_count == 4 || desc.element_count == 3) {
-            desc.color_space = ImageColorSpace::srgb;
-        }
+        ktxTexture_Destroy(p_ktx_texture);
+        return false;
     }
+    num_layers = desc.is_cubemap ? 6 : p_ktx_texture->numLayers;
 
 
     {
@@ -276,4 +258,164 @@ bool KtxImageLoader::doLoad(std::vector<uint8_t> const& raw_binary_data, std::ve
     return true;
 }
 
-}
\ No newline at end of file
+bool KtxImageLoader::doLoadFromFile(std::filesystem::path const& uri, std::vector<uint8_t>& image_data_buffer, Description& desc)
+{
+    if (core::misc::toLowerCase(uri.extension().string()) != ".ktx2")
+    {
+        return ImageLoader::doLoadFromFile(uri, image_data_buffer, desc);
+    }
+
+    std::unique_ptr<Ktx2LevelStream> level_stream = openKtx2LevelStream(uri, desc);
+    if (!level_stream)
+    {
+        // either the file is broken or its levels cannot be decoded independently, in both cases the whole file goes through libktx
+        desc = Description{ .uri = desc.uri, .timestamp = desc.timestamp };
+        return ImageLoader::doLoadFromFile(uri, image_data_buffer, desc);
+    }
+
+    Layer const& last_layer = desc.layers.back();
+    Mipmap const& last_mipmap = last_layer.mipmaps.back();
+    image_data_buffer.resize(last_mipmap.offset
+        + static_cast<size_t>(level_stream->levelIndexEntry(level_stream->levelCount() - 1).uncompressed_byte_length / level_stream->imageCountPerLevel()));
+
+    // Each level is read on its own starting from the smallest one in the order, in which the levels are stored in the file.
+    // The loader runs on the texture conversion threads, so that the levels are read by a single reader and the parallelism
+    // comes from converting several textures at once
+    bool is_read_successful{ true };
+    for (uint32_t level = level_stream->levelCount(); level-- > 0 && is_read_successful;)
+    {
+        is_read_successful = readKtx2Level(*level_stream, level, desc, image_data_buffer);
+    }
+
+    if (!is_read_successful)
+    {
+        LEXGINE_LOG_ERROR(this, "Error while streaming image data from KTX2 file '" + desc.uri + "'");
+    }
+    return is_read_successful;
+}
+
+std::unique_ptr<Ktx2LevelStream> KtxImageLoader::openKtx2LevelStream(std::filesystem::path const& uri, Description& desc)
+{
+    auto level_stream = std::make_unique<Ktx2LevelStream>(uri);
+    if (!*level_stream || !level_stream->supportsPerLevelDecoding())
+    {
+        return nullptr;
+    }
+
+    glm::uvec3 base_level_dimensions{};
+    {
+        // Only the header, DFD and key-value data are read here, the image data stay in the file
+        ktxTexture* p_ktx_texture;
+        if (ktxTexture_CreateFromNamedFile(uri.string().c_str(), KTX_TEXTURE_CREATE_NO_FLAGS, &p_ktx_texture) != KTX_SUCCESS)
+        {
+            LEXGINE_LOG_ERROR(this, "Error while reading KTX image '" + uri.string() + "'");
+            return nullptr;
+        }
+
+        bool const metadata_parsed = readKtxTextureMetadata(p_ktx_texture, desc);
+        base_level_dimensions = glm::uvec3{ p_ktx_texture->baseWidth, p_ktx_texture->baseHeight, p_ktx_texture->baseDepth };
+        ktxTexture_Destroy(p_ktx_texture);
+        if (!metadata_parsed)
+        {
+            return nullptr;
+        }
+    }
+
+    uint32_t const num_layers = level_stream->imageCountPerLevel();
+    uint32_t const num_levels = level_stream->levelCount();
+    if (num_layers != (desc.is_cubemap ? 6U : level_stream->layerCount()))
+    {
+        LEXGINE_LOG_ERROR(this, "Unable to parse KTX texture '" + uri.string() + "': cubemap arrays are not supported");
+        return nullptr;
+    }
+    desc.subresource_count = num_layers * num_levels;
+
+    // Lay the images out layer by layer with all mipmap levels of a layer packed together
+    size_t layer_size{ 0 };
+    for (uint32_t level = 0; level < num_levels; ++level)
+    {
+        layer_size += static_cast<size_t>(level_stream->levelIndexEntry(level).uncompressed_byte_length / num_layers);
+    }
+
+    desc.layers.resize(num_layers);
+    for (uint32_t layer = 0; layer < num_layers; ++layer)
+    {
+        size_t offset = layer * layer_size;
+        desc.layers[layer].offset = offset;
+        desc.layers[layer].mipmaps.resize(num_levels);
+        for (uint32_t level = 0; level < num_levels; ++level)
+        {
+            desc.layers[layer].mipmaps[level] = Mipmap{
+                .offset = offset,
+                .dimensions = glm::max(base_level_dimensions >> level, glm::uvec3{ 1U })
+            };
+            offset += static_cast<size_t>(level_stream->levelIndexEntry(level).uncompressed_byte_length / num_layers);
+        }
+    }
+
+    return level_stream;
+}
+
+bool KtxImageLoader::readKtx2Level(Ktx2LevelStream& level_stream, uint32_t level, Description const& desc, std::span<uint8_t> image_data)
+{
+    uint32_t const num_layers = level_stream.imageCountPerLevel();
+    size_t const image_size = static_cast<size_t>(level_stream.levelIndexEntry(level).uncompressed_byte_length / num_layers);
+    for (uint32_t layer = 0; layer < num_layers; ++layer)
+    {
+        if (desc.layers[layer].mipmaps[level].offset + image_size > image_data.size())
+        {
+            LEXGINE_LOG_ERROR(this, "Unable to read level " + std::to_string(level) + " of KTX2 file '" + desc.uri + "': the image data buffer is too small");
+            return false;
+        }
+    }
+
+    if (num_layers == 1 && level_stream.supercompressionScheme() == Ktx2LevelStream::SupercompressionScheme::none)
+    {
+        // the level can go straight into its final location
+        return level_stream.readLevel(level, image_data.subspan(desc.layers[0].mipmaps[level].offset, image_size));
+    }
+
+    std::vector<uint8_t> level_data(static_cast<size_t>(level_stream.levelIndexEntry(level).uncompressed_byte_length));
+    if (!level_stream.readLevel(level, level_data))
+    {
+        return false;
+    }
+
+    for (uint32_t layer = 0; layer < num_layers; ++layer)
+    {
+        std::copy(level_data.begin() + layer * image_size, level_data.begin() + (layer + 1) * image_size,
+            image_data.begin() + desc.layers[layer].mipmaps[level].offset);
+    }
+    return true;
+}
+
+bool KtxImageLoader::readKtxTextureMetadata(ktxTexture* p_ktx_texture, Description& desc) const
+{
+    desc.is_cubemap = p_ktx_texture->numLayers == 1 && p_ktx_texture->numFaces == 6;
+    size_t const num_layers = desc.is_cubemap ? 6 : p_ktx_texture->numLayers;
+    auto texel_size = ktxTexture_GetElementSize(p_ktx_texture);
+    desc.element_count = ktxTexture_GetElementCount(p_ktx_texture);
+    desc.compression_format = ktxTexture_GetCompressionFormat(p_ktx_texture);
+    desc.subresource_count = num_layers * p_ktx_texture->numLevels;
+
+    if (desc.compression_format == ImageCompressedDataFormat::unknown)
+    {
+        LEXGINE_LOG_ERROR(this, "Unable to parse KTX texture: the texture appears to be compressed, but its compression format is not supported");
+        return false;
+    }
+
+    if (desc.element_count < 1 || desc.element_count > 4)
+    {
+        LEXGINE_LOG_ERROR(this, "Unable to parse KTX texture: the element size of " + std::to_string(desc.element_count) + "is not supported");
+        return false;
+    }
+    desc.element_size = texel_size / desc.element_count;
+
+    if (desc.element_count == 4 || desc.element_count == 3) {
+        desc.color_space = ImageColorSpace::srgb;
+    }
+
+    return true;
+}
+
+}
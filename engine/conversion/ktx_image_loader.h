@@ -1,7 +1,13 @@
 #ifndef LEXGINE_CONVERSION_KTX_IMAGE_LOADER_H
 #define LEXGINE_CONVERSION_KTX_IMAGE_LOADER_H
 
+#include <memory>
+#include <span>
+
 #include "image_loader.h"
+#include "lexgine_conversion_fwd.h"
+
+struct ktxTexture;
 
 namespace lexgine::conversion
 {
@@ -11,8 +17,25 @@ class KtxImageLoader final : public ImageLoader
 public:
     KtxImageLoader() = default;
     bool canLoad(std::filesystem::path const& uri) const override;
+
+    /*! Opens KTX2 file for reading its mipmap levels on demand. Only the header, the level index and the metadata are read here, none of the level
+     data are read. The description receives the layout, in which the layers (or cubemap faces) follow each other
+     with all mipmap levels of a layer packed together. Unlike the images decoded from the whole file by libktx, the dimensions of uncompressed images
+     are not rounded up to multiples of 4.
+     Returns nullptr if the file is not a valid KTX2 file or if its levels cannot be decoded independently
+    */
+    std::unique_ptr<Ktx2LevelStream> openKtx2LevelStream(std::filesystem::path const& uri, Description& desc);
+
+    //! reads and decodes the given mipmap level of every layer of the image and scatters it into the image data at the offsets recorded in the description
+    bool readKtx2Level(Ktx2LevelStream& level_stream, uint32_t level, Description const& desc, std::span<uint8_t> image_data);
+
 private:
     bool doLoad(std::vector<uint8_t> const& raw_binary_data, std::vector<uint8_t>& image_data_buffer, Description& desc) override;
+
+    //! KTX2 files are read level by level through Ktx2LevelStream, other files are loaded into memory as a whole
+    bool doLoadFromFile(std::filesystem::path const& uri, std::vector<uint8_t>& image_data_buffer, Description& desc) override;
+
+    bool readKtxTextureMetadata(ktxTexture* p_ktx_texture, Description& desc) const;    //! fills in image description using the header of KTX texture
 };
 
 }
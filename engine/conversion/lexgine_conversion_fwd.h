@@ -4,5 +4,8 @@ class TextureConverter;
 class ImageLoaderPool;
 class TextureConversionTask;
 class TextureUploadWork;
+class Ktx2LevelStream;
+class TextureMipmapUploader;
+class TextureResidencyManager;
 
 }
\ No newline at end of file
@@ -1,9 +1,8 @@
 #include "DirectXTex.h"
 
-#include <bcrypt.h>
-
 #include <algorithm>
 #include <iterator>
+#include <numeric>
 #include <filesystem>
 
 #include <engine/core/global_settings.h>
@@ -13,10 +12,10 @@
 #include <engine/core/exception.h>
 #include <engine/core/misc/strict_weak_ordering.h>
 #include <engine/core/misc/misc.h>
+#include <engine/core/concurrency/abstract_task.h>
+#include <engine/core/concurrency/asset_scheduler.h>
 #include "texture_converter.h"
 
-#define STATUS_SUCCESS 0
-
 using namespace lexgine::core;
 
 namespace lexgine::conversion
@@ -34,6 +33,28 @@ union value_packer
 
 using uint64_t_packer = value_packer<uint64_t>;
 
+//! Runs conversion of a single texture on the asset scheduler
+class TextureConversionSchedulerTask final : public core::concurrency::AbstractTask
+{
+public:
+    explicit TextureConversionSchedulerTask(TextureConversionTask& conversion_task)
+        : AbstractTask{ "TextureConversion", false }
+        , m_conversion_task{ conversion_task }
+    {
+    }
+
+    bool doTask(uint8_t worker_id, uint64_t user_data) override
+    {
+        m_conversion_task();
+        return true;    // failures are reported through the status of the conversion task
+    }
+
+    core::concurrency::TaskType type() const override { return core::concurrency::TaskType::cpu; }
+
+private:
+    TextureConversionTask& m_conversion_task;
+};
+
 core::GlobalSettings const* getGlobalSettings(core::Globals const& globals)
 {
     return globals.get<core::GlobalSettings>();
@@ -183,50 +204,35 @@ size_t calculateBlobPreambleSizeForImage(conversion::ImageLoader::Description co
     return all_mipmaps_count * 24 + sizeof(UUID) + 8 + hash_size;
 }
 
-}  // anonymous namespace
-
-
-TextureConverter::sha256_provider::sha256_provider(TextureConverter* context)
-    : m_context{ context }
-{
-    BCRYPT_ALG_HANDLE sha256_algorithm_handle{};
-    LEXGINE_THROW_ERROR_IF_FAILED(context, BCryptOpenAlgorithmProvider(&sha256_algorithm_handle, BCRYPT_SHA256_ALGORITHM, nullptr, BCRYPT_HASH_REUSABLE_FLAG), STATUS_SUCCESS);
-    m_algorithm_handle = static_cast<void*>(sha256_algorithm_handle);
-
-    union {
-        DWORD value;
-        unsigned char bytes[sizeof(DWORD)];
-    }dword_buf{ 0 };
-
-    ULONG bytes_written{ 0 };
-    LEXGINE_THROW_ERROR_IF_FAILED(context, BCryptGetProperty(sha256_algorithm_handle, BCRYPT_OBJECT_LENGTH, static_cast<PUCHAR>(dword_buf.bytes), sizeof(dword_buf), &bytes_written, NULL), STATUS_SUCCESS);
-    m_hash_object_buffer.resize(dword_buf.value);
-
-
-    BCRYPT_HASH_HANDLE hash_handle{};
-    LEXGINE_THROW_ERROR_IF_FAILED(context, BCryptCreateHash(sha256_algorithm_handle, &hash_handle, static_cast<unsigned char*>(m_hash_object_buffer.data()), static_cast<ULONG>(m_hash_object_buffer.size()), NULL, 0, BCRYPT_HASH_REUSABLE_FLAG), STATUS_SUCCESS);
-    m_hash_object_handle = static_cast<void*>(hash_handle);
-
-    dword_buf.value = 0;
-    LEXGINE_THROW_ERROR_IF_FAILED(context, BCryptGetProperty(sha256_algorithm_handle, BCRYPT_HASH_LENGTH, static_cast<PUCHAR>(dword_buf.bytes), sizeof(dword_buf), &bytes_written, NULL), STATUS_SUCCESS);
-    assert(dword_buf.value == sha256_provider::c_hash_length);
-}
-
-TextureConverter::sha256_provider::~sha256_provider()
+struct MipmapBlobLayout
 {
-    LEXGINE_LOG_ERROR_IF_FAILED(m_context, BCryptDestroyHash(static_cast<BCRYPT_HASH_HANDLE>(m_hash_object_handle)), STATUS_SUCCESS);
-    LEXGINE_LOG_ERROR_IF_FAILED(m_context, BCryptCloseAlgorithmProvider(static_cast<BCRYPT_ALG_HANDLE>(m_algorithm_handle), NULL), STATUS_SUCCESS);
-}
+    size_t size;
+    size_t row_pitch;
+    size_t slice_pitch;
+};
 
-std::array<uint8_t, TextureConverter::sha256_provider::c_hash_length> TextureConverter::sha256_provider::hash(std::span<uint8_t const> data) const
+//! Predicts how a mipmap level will be laid out in the texture blob after conversion, which allows to allocate the blob only once
+MipmapBlobLayout predictMipmapBlobLayout(conversion::ImageLoader::Description const& source_image_desc, glm::uvec3 const& dimensions,
+    conversion::ImageCompressedDataFormat target_compression_format)
 {
-    std::array<uint8_t, c_hash_length> rv{};
-    LEXGINE_THROW_ERROR_IF_FAILED(m_context, BCryptHashData(static_cast<BCRYPT_HASH_HANDLE>(m_hash_object_handle), static_cast<PUCHAR>(const_cast<uint8_t*>(data.data())), static_cast<ULONG>(data.size_bytes()), NULL), STATUS_SUCCESS);
-    LEXGINE_THROW_ERROR_IF_FAILED(m_context, BCryptFinishHash(static_cast<BCRYPT_HASH_HANDLE>(m_hash_object_handle), static_cast<PUCHAR>(rv.data()), static_cast<ULONG>(rv.size()), NULL), STATUS_SUCCESS);
+    if (source_image_desc.compression_format == conversion::ImageCompressedDataFormat::no_compression
+        && target_compression_format != conversion::ImageCompressedDataFormat::no_compression)
+    {
+        size_t row_pitch{}, slice_pitch{};
+        if (SUCCEEDED(DirectX::ComputePitch(static_cast<DXGI_FORMAT>(target_compression_format), dimensions.x, dimensions.y, row_pitch, slice_pitch)))
+        {
+            return { slice_pitch, row_pitch, slice_pitch };
+        }
+    }
 
-    return rv;
+    // the mipmap level is stored as is
+    size_t const row_pitch = dimensions.x * source_image_desc.element_count * source_image_desc.element_size;
+    size_t const slice_pitch = row_pitch * dimensions.y;
+    return { slice_pitch, row_pitch, slice_pitch };
 }
 
+}  // anonymous namespace
+
 
 TextureConversionTaskKey::TextureConversionTaskKey(std::string const& name)
     : name{}
@@ -277,48 +283,60 @@ TextureConversionTask::TextureConversionTask(
 
 void TextureConversionTask::operator()(void)
 {
-    std::scoped_lock<std::mutex> lock{ m_texture_converter.m_texture_cache_mutex };
     m_status.store(static_cast<int>(TextureConversionStatus::in_progress), std::memory_order_release);
 
     TextureConversionTaskKey key = TextureConverter::createConversionTaskKey(m_source_image);
 
-    bool should_convert = !m_texture_converter.m_compressed_textures_cache->doesEntryExist(key);
-    std::array<uint8_t, 32U> sha256{};    // hash value of the source image (calculated only when should_convert is true)
-    if (should_convert)
+    bool should_convert{};
+    misc::DateTime cached_entry_timestamp{};
     {
-        if (m_skip_source_image_load || !m_source_image.load())
+        std::scoped_lock<std::mutex> lock{ m_texture_converter.m_texture_cache_mutex };
+        should_convert = !m_texture_converter.m_compressed_textures_cache->doesEntryExist(key);
+        if (!should_convert)
         {
-            m_status.store(static_cast<int>(TextureConversionStatus::error), std::memory_order_release);
+            cached_entry_timestamp = m_texture_converter.m_compressed_textures_cache->getEntryTimestamp(key);
         }
-
-        sha256 = m_texture_converter.m_sha256_provider->hash(std::span<std::uint8_t const>{m_source_image.data(), m_source_image.size()});
     }
-    else if(!m_skip_source_image_load)
+
+    // Hash value of the raw source image data (calculated only when the texture has to be converted or when the cached entry is outdated).
+    // Hashing is done outside of the cache lock, so that validation of one texture does not stall conversion of the others
+    misc::Sha256::Digest sha256{};
+    if (should_convert)
     {
-        if (!m_source_image.load())
+        if (m_skip_source_image_load)
         {
             m_status.store(static_cast<int>(TextureConversionStatus::error), std::memory_order_release);
+            return;
         }
 
-        misc::DateTime datestamp = m_texture_converter.m_compressed_textures_cache->getEntryTimestamp(key);
-        if (datestamp < m_source_image.description().timestamp)
+        sha256 = TextureConverter::hashSourceImage(m_source_image);
+    }
+    else if (!m_skip_source_image_load
+        && cached_entry_timestamp < TextureConverter::getSourceImageTimestamp(m_source_image))
+    {
+        // Only the time stamp of the source has changed so far, compare the contents
+        sha256 = TextureConverter::hashSourceImage(m_source_image);
+
+        misc::Sha256::Digest cached_sha256{};
         {
-            // Calculate hash value of the source image
-            sha256 = m_texture_converter.m_sha256_provider->hash(std::span<std::uint8_t const>{m_source_image.data(), m_source_image.size()});
+            std::scoped_lock<std::mutex> lock{ m_texture_converter.m_texture_cache_mutex };
             lexgine::core::SharedDataChunk data_chunk = m_texture_converter.m_compressed_textures_cache->retrieveEntry(key);
             void* p_data = data_chunk.data();
-            std::array<uint8_t, 32U> cached_sha256{};
             std::copy(static_cast<uint8_t*>(p_data), static_cast<uint8_t*>(p_data) + cached_sha256.size(), cached_sha256.begin());
-            should_convert = !std::equal(sha256.begin(), sha256.end(), cached_sha256.begin());
         }
+        should_convert = sha256 != cached_sha256;
+    }
+
+    if (should_convert && !m_source_image.load())
+    {
+        m_status.store(static_cast<int>(TextureConversionStatus::error), std::memory_order_release);
+        return;
     }
 
     if (should_convert) {
         auto image_desc = m_source_image.description();
 
         misc::UUID uuid = misc::UUID::generate();
-        core::SharedDataChunk scratch_blob_data{ m_source_image.size() + calculateBlobPreambleSizeForImage(image_desc, TextureConverter::sha256_provider::c_hash_length) };
-
         auto p_device = m_texture_converter.m_globals.get<core::dx::d3d12::Device>();
         auto nativeD3d11Device = p_device->nativeD3d11();
 
@@ -394,6 +412,8 @@ void TextureConversionTask::operator()(void)
                 // use GPU compression
                 compressor = [this, nativeD3d11Device, target_compression_format, compression_flags](DirectX::Image const& srcImage, DirectX::ScratchImage& dstImage)
                     {
+                        // GPU compression goes through the immediate context of the D3D11 device, which is not free-threaded
+                        std::scoped_lock<std::mutex> gpu_compression_lock{ m_texture_converter.m_gpu_compression_mutex };
                         LEXGINE_LOG_ERROR_IF_FAILED(m_texture_converter, DirectX::Compress(nativeD3d11Device.Get(), srcImage, static_cast<DXGI_FORMAT>(target_compression_format), compression_flags, DirectX::TEX_THRESHOLD_DEFAULT, dstImage), S_OK);
                         return true;
                     };
@@ -429,18 +449,33 @@ void TextureConversionTask::operator()(void)
             // Store image in the texture cache (while compressing it when required) and prepare texture upload task
             auto& layers = image_desc.layers;
 
-            std::copy(sha256.begin(), sha256.end(), static_cast<uint8_t*>(scratch_blob_data.data()));
-            size_t blob_data_write_offset{ TextureConverter::sha256_provider::c_hash_length };
+            // Converted mipmap levels are placed directly into the final blob of predicted size, which is then shared by the cache and by the upload work
+            std::vector<MipmapBlobLayout> predicted_mipmap_layouts{};
+            predicted_mipmap_layouts.reserve(image_desc.subresource_count);
+            size_t blob_size = calculateBlobPreambleSizeForImage(image_desc, misc::Sha256::c_digest_length);
+            for (auto const& layer : layers)
+            {
+                for (auto const& mipmap_level : layer.mipmaps)
+                {
+                    predicted_mipmap_layouts.push_back(predictMipmapBlobLayout(image_desc, mipmap_level.dimensions, target_compression_format));
+                    blob_size += predicted_mipmap_layouts.back().size;
+                }
+            }
+            core::SharedDataChunk blob_data{ blob_size };
+
+            std::copy(sha256.begin(), sha256.end(), static_cast<uint8_t*>(blob_data.data()));
+            size_t blob_data_write_offset{ misc::Sha256::c_digest_length };
 
 
-            packUint64ToArray(uuid.hiPart(), static_cast<uint8_t*>(scratch_blob_data.data()), blob_data_write_offset);
-            packUint64ToArray(uuid.loPart(), static_cast<uint8_t*>(scratch_blob_data.data()), blob_data_write_offset);
+            packUint64ToArray(uuid.hiPart(), static_cast<uint8_t*>(blob_data.data()), blob_data_write_offset);
+            packUint64ToArray(uuid.loPart(), static_cast<uint8_t*>(blob_data.data()), blob_data_write_offset);
 
-            packUint64ToArray(static_cast<uint64_t>(target_compression_format), static_cast<uint8_t*>(scratch_blob_data.data()), blob_data_write_offset);
+            packUint64ToArray(static_cast<uint64_t>(target_compression_format), static_cast<uint8_t*>(blob_data.data()), blob_data_write_offset);
 
             dx::d3d12::ResourceDataUploader::TextureSourceDescriptor texture_source_descriptor{};
             texture_source_descriptor.subresources.reserve(image_desc.subresource_count);
 
+            size_t subresource_id{ 0 };
             for (size_t layer_id = 0; layer_id < layers.size(); ++layer_id)
             {
                 auto& current_layer = layers[layer_id];
@@ -485,11 +520,20 @@ void TextureConversionTask::operator()(void)
                             compressed_img_row_pitch = img.rowPitch;
                         }
                     }
-                    packUint64ToArray(compressed_img_size, static_cast<uint8_t*>(scratch_blob_data.data()), blob_data_write_offset);
-                    packUint64ToArray(compressed_img_row_pitch, static_cast<uint8_t*>(scratch_blob_data.data()), blob_data_write_offset);
-                    packUint64ToArray(compressed_img_slice_pitch, static_cast<uint8_t*>(scratch_blob_data.data()), blob_data_write_offset);
 
-                    uint8_t* subresource_address = static_cast<uint8_t*>(scratch_blob_data.data()) + blob_data_write_offset;
+                    if (compressed_img_size != predicted_mipmap_layouts[subresource_id++].size)
+                    {
+                        LEXGINE_LOG_ERROR(m_texture_converter, "Unexpected size of converted mipmap level " + std::to_string(mipmap_level_id)
+                            + " of layer " + std::to_string(layer_id) + " in texture '" + key.toString() + "'");
+                        m_status.store(static_cast<int>(TextureConversionStatus::error), std::memory_order_release);
+                        return;
+                    }
+
+                    packUint64ToArray(compressed_img_size, static_cast<uint8_t*>(blob_data.data()), blob_data_write_offset);
+                    packUint64ToArray(compressed_img_row_pitch, static_cast<uint8_t*>(blob_data.data()), blob_data_write_offset);
+                    packUint64ToArray(compressed_img_slice_pitch, static_cast<uint8_t*>(blob_data.data()), blob_data_write_offset);
+
+                    uint8_t* subresource_address = static_cast<uint8_t*>(blob_data.data()) + blob_data_write_offset;
                     std::copy(compressed_img_pixels, compressed_img_pixels + compressed_img_size, subresource_address);
                     blob_data_write_offset += compressed_img_size;
 
@@ -497,19 +541,22 @@ void TextureConversionTask::operator()(void)
                 }
             }
 
-            // add compressed data to the cache
+            assert(blob_data_write_offset == blob_data.size());
 
-            SharedDataChunk blob_data{ blob_data_write_offset };
-            std::copy(static_cast<uint8_t*>(scratch_blob_data.data()), static_cast<uint8_t*>(scratch_blob_data.data()) + blob_data_write_offset, static_cast<uint8_t*>(blob_data.data()));
-            m_texture_converter.m_compressed_textures_cache->addEntry(TextureConverter::TextureCache::entry_type{ key, blob_data });
+            // add compressed data to the cache
+            {
+                std::scoped_lock<std::mutex> lock{ m_texture_converter.m_texture_cache_mutex };
+                m_texture_converter.m_compressed_textures_cache->addEntry(TextureConverter::TextureCache::entry_type{ key, blob_data });
+            }
 
             conversion::ImageLoader::Description compressed_texture_description = image_desc;
             compressed_texture_description.compression_format = target_compression_format;
-            m_texture_upload_work = std::make_unique<TextureUploadWork>(m_texture_converter, key, uuid, scratch_blob_data, compressed_texture_description, texture_source_descriptor);
+            m_texture_upload_work = std::make_unique<TextureUploadWork>(m_texture_converter, key, uuid, blob_data, compressed_texture_description, texture_source_descriptor);
         }
     }
     else {
         misc::UUID uuid{};
+        std::scoped_lock<std::mutex> lock{ m_texture_converter.m_texture_cache_mutex };
         auto cached_texture_data = m_texture_converter.readTextureFromCache(key, uuid);
         m_texture_upload_work = std::make_unique<TextureUploadWork>(m_texture_converter, key, uuid, cached_texture_data.data, cached_texture_data.description, cached_texture_data.source_descriptor);
     }
@@ -552,7 +599,19 @@ TextureUploadWork::TextureUploadWork(TextureConverter& texture_converter,
     , m_texture_uuid{ texture_uuid }
     , m_converted_texture_data{ converted_texture_data }
     , m_src_desc{ source_descriptor }
+    , m_layer_count{ static_cast<uint32_t>(texture_description.layers.size()) }
+    , m_mipmap_level_count{ static_cast<uint32_t>(texture_description.layers[0].mipmaps.size()) }
+    , m_mipmap_level_sizes(m_mipmap_level_count, 0)
 {
+    assert(m_src_desc.subresources.size() == m_layer_count * m_mipmap_level_count);
+    for (uint32_t layer = 0; layer < m_layer_count; ++layer)
+    {
+        for (uint32_t level = 0; level < m_mipmap_level_count; ++level)
+        {
+            m_mipmap_level_sizes[level] += m_src_desc.subresources[layer * m_mipmap_level_count + level].slice_pitch;
+        }
+    }
+
     glm::uvec3 dimensions = texture_description.layers[0].mipmaps[0].dimensions;
     auto desc = core::dx::d3d12::ResourceDescriptor::CreateTexture2D(static_cast<uint32_t>(dimensions.x), static_cast<uint32_t>(dimensions.y), static_cast<uint32_t>(dimensions.z),
         static_cast<DXGI_FORMAT>(texture_description.compression_format), static_cast<uint32_t>(texture_description.layers[0].mipmaps.size()),
@@ -571,6 +630,13 @@ TextureUploadWork::TextureUploadWork(TextureConverter& texture_converter,
 
 bool TextureUploadWork::schedule()
 {
+    return scheduleMipmapLevels(0, m_mipmap_level_count);
+}
+
+bool TextureUploadWork::scheduleMipmapLevels(uint32_t first_level, uint32_t level_count)
+{
+    assert(first_level + level_count <= m_mipmap_level_count);
+
     if (m_converted_texture_data.isNull())
     {
         auto cached_texture_data = m_texture_converter.readTextureFromCache(m_conversion_key, m_texture_uuid);
@@ -578,37 +644,47 @@ bool TextureUploadWork::schedule()
         m_src_desc = cached_texture_data.source_descriptor;
     }
 
-    core::dx::d3d12::ResourceDataUploader::DestinationDescriptor::DestinationSegment destination_segment {};
-    destination_segment.subresources = core::dx::d3d12::ResourceDataUploader::DestinationDescriptor::SubresourceSegment { .first_subresource = 0, .num_subresources = static_cast<uint32_t>(m_src_desc.subresources.size()) };
-
-    core::dx::d3d12::ResourceDataUploader::DestinationDescriptor data_upload_destination_descriptor {
-        .p_destination_resource = &m_texture,
-        .destination_resource_state = core::dx::d3d12::ResourceState::base_values::common,
-        .segment = destination_segment
-    };
-
-
-    if (m_texture_converter.m_data_uploader.availableCapacity() < m_converted_texture_data.size())
+    uint64_t const upload_size = std::accumulate(m_mipmap_level_sizes.begin() + first_level, m_mipmap_level_sizes.begin() + first_level + level_count, uint64_t{ 0 });
+    if (m_texture_converter.m_data_uploader.availableCapacity() < upload_size)
     {
         // Even theoretically, there's no remaining capacity in staging buffer to add more data for uploading
         m_texture_converter.m_data_uploader.upload();
         m_texture_converter.m_data_uploader.waitUntilUploadIsFinished();
     }
-    if (!m_texture_converter.m_data_uploader.addResourceForUpload(data_upload_destination_descriptor, m_src_desc))
+
+    // D3D12 enumerates subresources layer by layer, so the requested levels form a contiguous subresource segment within each layer
+    for (uint32_t layer = 0; layer < m_layer_count; ++layer)
     {
-        // If allocation is unsuccessful so far, that means too much data is in fragmented state (probably, a rare scenario), so we again need to enforce upload of staged resources
-        m_texture_converter.m_data_uploader.upload();
-        m_texture_converter.m_data_uploader.waitUntilUploadIsFinished();
+        uint32_t const first_subresource = layer * m_mipmap_level_count + first_level;
+
+        core::dx::d3d12::ResourceDataUploader::DestinationDescriptor::DestinationSegment destination_segment{};
+        destination_segment.subresources = core::dx::d3d12::ResourceDataUploader::DestinationDescriptor::SubresourceSegment{ .first_subresource = first_subresource, .num_subresources = level_count };
+
+        core::dx::d3d12::ResourceDataUploader::DestinationDescriptor data_upload_destination_descriptor{
+            .p_destination_resource = &m_texture,
+            .destination_resource_state = core::dx::d3d12::ResourceState::base_values::common,
+            .segment = destination_segment
+        };
 
-        if (!m_texture_converter.m_data_uploader.addResourceForUpload(data_upload_destination_descriptor, m_src_desc))
+        core::dx::d3d12::ResourceDataUploader::TextureSourceDescriptor source_descriptor{};
+        source_descriptor.subresources.assign(m_src_desc.subresources.begin() + first_subresource, m_src_desc.subresources.begin() + first_subresource + level_count);
+
+        if (!m_texture_converter.m_data_uploader.addResourceForUpload(data_upload_destination_descriptor, source_descriptor))
         {
-            // Last try. If unsuccessful, we are out of options and this can only mean that the staging buffer is too small to upload requested resource
-            LEXGINE_LOG_ERROR(m_texture_converter, "Unable to upload resource " + m_texture.getStringName() + ", UUID{" + m_texture_uuid.toString() + "}: "
-                + "staging buffer is too small to upload " + std::to_string(m_converted_texture_data.size()) + " bytes of data");
-            return false;
+            // If allocation is unsuccessful so far, that means too much data is in fragmented state (probably, a rare scenario), so we again need to enforce upload of staged resources
+            m_texture_converter.m_data_uploader.upload();
+            m_texture_converter.m_data_uploader.waitUntilUploadIsFinished();
+
+            if (!m_texture_converter.m_data_uploader.addResourceForUpload(data_upload_destination_descriptor, source_descriptor))
+            {
+                // Last try. If unsuccessful, we are out of options and this can only mean that the staging buffer is too small to upload requested resource
+                LEXGINE_LOG_ERROR(m_texture_converter, "Unable to upload resource " + m_texture.getStringName() + ", UUID{" + m_texture_uuid.toString() + "}: "
+                    + "staging buffer is too small to upload " + std::to_string(upload_size) + " bytes of data");
+                return false;
+            }
         }
     }
-    
+
     m_controlling_signal = m_texture_converter.m_data_uploader.recordingWork();
     return true;
 }
@@ -627,9 +703,18 @@ bool TextureUploadWork::waitForCompletion() const
     return true;
 }
 
+uint32_t TextureUploadWork::sampledMostDetailedLevel() const
+{
+    return m_texture_converter.residentMostDetailedMipmapLevel(m_texture_uuid);
+}
+
+void TextureUploadWork::requestMipmapLevel(uint32_t most_detailed_level, float priority) const
+{
+    m_texture_converter.requestTextureMipmapLevel(m_texture_uuid, most_detailed_level, priority);
+}
+
 TextureConverter::TextureConverter(core::Globals& globals)
     : m_globals{ globals }
-    , m_sha256_provider{ new sha256_provider{this} }
     , m_upload_stream_allocator{ createUploadStreamAllocator(globals) }
     , m_data_uploader{ globals, m_upload_stream_allocator, core::dx::d3d12::ResourceUploadPolicy::non_blocking }
 {
@@ -671,6 +756,7 @@ TextureConverter::TextureConverter(core::Globals& globals)
 
 TextureConverter::~TextureConverter()
 {
+    waitForTextureConversionCompletion();
     m_compressed_textures_cache->finalize();
     m_cache_stream.close();
 }
@@ -686,74 +772,124 @@ TextureConversionTask const* TextureConverter::addTextureConversionTask(scenegra
     return &task;
 }
 
-void TextureConverter::convertTextures(uint32_t thread_count)
+void TextureConverter::convertTextures()
 {
     waitForTextureConversionCompletion();
 
-    if (thread_count == static_cast<uint32_t>(-1))
-        thread_count = std::thread::hardware_concurrency();
+    core::concurrency::AssetScheduler* p_asset_scheduler = m_globals.get<core::concurrency::AssetScheduler>();
+    if (!p_asset_scheduler)
+    {
+        for (auto& [_, conversion_task] : m_texture_conversion_tasks) conversion_task();
+        return;
+    }
 
-    struct TextureConversionThreadBucket
+    // each texture is converted by a separate task, so that the scheduler balances the textures of different sizes across its workers
+    m_texture_conversion_scheduler_tasks.clear();
+    m_texture_conversion_scheduler_tasks.reserve(m_texture_conversion_tasks.size());
+    std::vector<core::concurrency::AbstractTask*> tasks{};
+    tasks.reserve(m_texture_conversion_tasks.size());
+    for (auto& [_, conversion_task] : m_texture_conversion_tasks)
     {
-        size_t first;
-        size_t count;
-    };
-    std::array<TextureConversionThreadBucket, 128> thread_buckets{};
-    static std::vector<TextureConversionTask*> conversion_tasks_buffer{};
-    conversion_tasks_buffer.resize(m_texture_conversion_tasks.size());
-    std::transform(
-        m_texture_conversion_tasks.begin(), 
-        m_texture_conversion_tasks.end(), 
-        conversion_tasks_buffer.begin(),
-        [](std::pair<TextureConversionTaskKey const, TextureConversionTask>& e) { return &e.second; }
-    );
+        m_texture_conversion_scheduler_tasks.push_back(std::make_unique<TextureConversionSchedulerTask>(conversion_task));
+        tasks.push_back(m_texture_conversion_scheduler_tasks.back().get());
+    }
+    m_texture_conversion_job = p_asset_scheduler->submit(tasks, core::concurrency::AssetJobPriority::normal);
+}
 
-    size_t bucket_size = conversion_tasks_buffer.size() / thread_count;
-    size_t remainder = conversion_tasks_buffer.size() % thread_count;
+void TextureConverter::uploadTextures()
+{
+    waitForTextureConversionCompletion();
 
-    uint32_t active_threads = bucket_size > 0 ? thread_count : remainder;
-    for (size_t i = 0; i < active_threads; ++i)
+    auto global_settings = getGlobalSettings(m_globals);
+    if (global_settings->getTextureStreamingMemoryBudget() > 0 && !m_texture_residency_manager)
     {
-        thread_buckets[i].first = i * bucket_size + (i < remainder ? i : remainder);
-        thread_buckets[i].count = bucket_size + (i < remainder ? 1 : 0);
+        m_texture_residency_manager = std::make_unique<TextureResidencyManager>(*this, global_settings->getTextureStreamingMemoryBudget(),
+            global_settings->getTextureStreamingMipmapTailBudget(), global_settings->getTextureStreamingUploadBudgetPerFrame());
     }
 
-    auto task_workload = [](TextureConversionThreadBucket const& threadBucket)
+    for (auto& [_, task] : m_texture_conversion_tasks)
+    {
+        TextureUploadWork* p_upload_work = task.getUploadWork();
+        assert(p_upload_work);
+
+        if (m_texture_residency_manager)
         {
-            size_t first = threadBucket.first;
-            size_t last = first + threadBucket.count;
+            core::misc::UUID const uuid = p_upload_work->uuid();
+            if (m_streamed_textures.contains(uuid)) continue;    // streamed since one of the previous calls
 
-            for (size_t i = first; i < last; ++i)
+            // the residency manager uploads the mipmap tail of the texture through uploadMipmapLevels()
+            m_streamed_textures.emplace(uuid, StreamedTexture{ .p_upload_work = p_upload_work, .sampled_level = p_upload_work->mipmapLevelCount() });
+            if (m_texture_residency_manager->registerTexture(uuid, p_upload_work->mipmapLevelSizes()))
             {
-                TextureConversionTask& task = *conversion_tasks_buffer[i];
-                task();
+                m_streamed_textures[uuid].sampled_level = m_texture_residency_manager->residentMostDetailedLevel(uuid);    // the upload is waited for below
             }
-        };
+            else
+            {
+                // the texture is not streamed and gets uploaded as a whole
+                m_streamed_textures.erase(uuid);
+                p_upload_work->schedule();
+            }
+        }
+        else
+        {
+            p_upload_work->schedule();
+        }
+    }
+    m_data_uploader.upload();
+    m_data_uploader.waitUntilUploadIsFinished();
+}
 
-    m_texture_conversion_futures.clear();
-    m_texture_conversion_futures.resize(active_threads);
-    for (uint32_t i = 0; i < active_threads; ++i)
+void TextureConverter::requestTextureMipmapLevel(core::misc::UUID const& texture_uuid, uint32_t most_detailed_level, float priority)
+{
+    if (m_texture_residency_manager)
     {
-        m_texture_conversion_futures[i] = std::async(std::launch::async, task_workload, thread_buckets[i]);
+        m_texture_residency_manager->requestMipmapLevel(texture_uuid, most_detailed_level, priority);
     }
 }
 
-void TextureConverter::uploadTextures()
+void TextureConverter::updateTextureResidency()
 {
-    waitForTextureConversionCompletion();
-    for (auto& [_, task] : m_texture_conversion_tasks)
+    if (!m_texture_residency_manager) return;
+
+    // levels streamed in during the previous updates become available for sampling once their upload has completed
+    for (auto& [uuid, streamed_texture] : m_streamed_textures)
     {
-        TextureUploadWork* p_upload_work = task.getUploadWork();
-        assert(p_upload_work);
-        p_upload_work->schedule();
+        if (streamed_texture.p_upload_work->isCompleted())
+        {
+            streamed_texture.sampled_level = m_texture_residency_manager->residentMostDetailedLevel(uuid);
+        }
+    }
+
+    m_texture_residency_manager->update();
+    m_data_uploader.upload();    // does not wait for the upload to finish
+}
+
+uint32_t TextureConverter::residentMostDetailedMipmapLevel(core::misc::UUID const& texture_uuid) const
+{
+    auto p = m_streamed_textures.find(texture_uuid);
+    return p != m_streamed_textures.end() ? p->second.sampled_level : 0U;
+}
+
+bool TextureConverter::uploadMipmapLevels(core::misc::UUID const& texture_uuid, uint32_t first_level, uint32_t level_count)
+{
+    auto p = m_streamed_textures.find(texture_uuid);
+    return p != m_streamed_textures.end() && p->second.p_upload_work->scheduleMipmapLevels(first_level, level_count);
+}
+
+void TextureConverter::releaseMipmapLevels(core::misc::UUID const& texture_uuid, uint32_t first_level, uint32_t level_count)
+{
+    // Textures are committed resources with complete mipmap chains, so demoted levels keep their memory and
+    // are only excluded from sampling by clamping the views to residentMostDetailedMipmapLevel()
+    auto p = m_streamed_textures.find(texture_uuid);
+    if (p != m_streamed_textures.end())
+    {
+        p->second.sampled_level = (std::max)(p->second.sampled_level, first_level + level_count);
     }
-    m_data_uploader.upload();
-    m_data_uploader.waitUntilUploadIsFinished();
 }
 
 bool TextureConverter::isTextureConversionCompleted() const
 {
-    return std::all_of(m_texture_conversion_futures.begin(), m_texture_conversion_futures.end(), [](std::future<void> const& e) { return e.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready; });
+    return !m_texture_conversion_job || m_texture_conversion_job->isFinished();
 }
 
 bool TextureConverter::isTextureUploadCompleted() const
@@ -763,11 +899,7 @@ bool TextureConverter::isTextureUploadCompleted() const
 
 void TextureConverter::waitForTextureConversionCompletion()
 {
-    while (!isTextureConversionCompleted())
-    {
-        std::this_thread::yield();
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    }
+    if (m_texture_conversion_job) m_texture_conversion_job->wait();
 }
 
 void TextureConverter::waitForTextureUploadCompletion()
@@ -782,7 +914,7 @@ TextureConverter::CachedTextureData TextureConverter::readTextureFromCache(Textu
     auto blob_data = m_compressed_textures_cache->retrieveEntry(key, &valid_blob_size);
 
     dx::d3d12::ResourceDataUploader::TextureSourceDescriptor texture_source_descriptor{};
-    size_t blob_data_read_offset{ sha256_provider::c_hash_length };
+    size_t blob_data_read_offset{ misc::Sha256::c_digest_length };
 
     {
         uint64_t uuid_hi_part{}, uuid_lo_part{};
@@ -841,6 +973,26 @@ TextureConverter::CachedTextureData TextureConverter::readTextureFromCache(Textu
     return { blob_data, image_description, texture_source_descriptor };
 }
 
+misc::Sha256::Digest TextureConverter::hashSourceImage(scenegraph::Image const& source_image)
+{
+    // Hash raw bytes of the source file when the image has one: this is much cheaper than hashing decoded (and possibly mipmapped) data
+    // and does not require the image to be decoded at all
+    std::filesystem::path const source_path{ source_image.uri() };
+    if (std::filesystem::is_regular_file(source_path))
+    {
+        auto file_hash = misc::Sha256::hashFile(source_path);
+        if (file_hash.isValid()) return *file_hash;
+    }
+
+    return misc::Sha256::hash(std::span<uint8_t const>{ source_image.data(), source_image.size() });
+}
+
+misc::DateTime TextureConverter::getSourceImageTimestamp(scenegraph::Image const& source_image)
+{
+    auto file_timestamp = misc::getFileLastUpdatedTimeStamp(source_image.uri());
+    return file_timestamp.isValid() ? *file_timestamp : source_image.description().timestamp;
+}
+
 TextureConversionTaskKey TextureConverter::createConversionTaskKey(scenegraph::Image& source_image)
 {
     TextureConversionTaskKey key;
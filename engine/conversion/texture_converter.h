@@ -2,9 +2,13 @@
 #define LEXGINE_CONVERSION_TEXTURE_CONTERTER_H
 
 #include <unordered_map>
+#include <map>
 #include <fstream>
 #include <span>
-#include <future>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
 #include <mutex>
 #include <limits>
 
@@ -14,10 +18,13 @@
 #include <engine/core/streamed_cache.h>
 #include <engine/core/entity.h>
 #include <engine/core/misc/uuid.h>
+#include <engine/core/misc/sha256.h>
 #include <engine/core/dx/d3d12/resource.h>
 #include <engine/core/dx/d3d12/resource_data_uploader.h>
 #include <engine/core/dx/d3d12/upload_buffer_allocator.h>
+#include <engine/core/concurrency/lexgine_core_concurrency_fwd.h>
 #include <engine/conversion/class_names.h>
+#include <engine/conversion/texture_residency_manager.h>
 #include <engine/scenegraph/image.h>
 
 #include "lexgine_conversion_fwd.h"
@@ -83,7 +90,11 @@ public:
         conversion::ImageLoader::Description& texture_description,
         core::dx::d3d12::ResourceDataUploader::TextureSourceDescriptor const& source_descriptor);
 
-    bool schedule();
+    bool schedule();    //! schedules upload of all mipmap levels of the texture
+
+    //! schedules upload of mipmap levels [first_level, first_level + level_count) of all array layers of the texture
+    bool scheduleMipmapLevels(uint32_t first_level, uint32_t level_count);
+
     void evict() { m_converted_texture_data = nullptr; }
     void clear() { m_texture = nullptr; }
     bool isCompleted() const;
@@ -92,6 +103,15 @@ public:
 
     core::dx::d3d12::Resource resource() const { return m_texture; }
 
+    uint32_t mipmapLevelCount() const { return m_mipmap_level_count; }
+    std::vector<uint64_t> const& mipmapLevelSizes() const { return m_mipmap_level_sizes; }    //! sizes of the mipmap levels of the texture combined over all array layers
+
+    //! returns the most detailed mipmap level of the texture that is safe to sample from, which is always 0 unless the texture is streamed
+    uint32_t sampledMostDetailedLevel() const;
+
+    //! requests the mipmap levels of the texture starting from the given one to be streamed in, has no effect unless the texture is streamed
+    void requestMipmapLevel(uint32_t most_detailed_level, float priority) const;
+
 private:
     TextureConverter& m_texture_converter;
     TextureConversionTaskKey m_conversion_key;
@@ -99,6 +119,9 @@ private:
     core::SharedDataChunk m_converted_texture_data;
     core::dx::d3d12::ResourceDataUploader::TextureSourceDescriptor m_src_desc;
     core::dx::d3d12::Resource m_texture;
+    uint32_t m_layer_count;
+    uint32_t m_mipmap_level_count;
+    std::vector<uint64_t> m_mipmap_level_sizes;
     uint64_t m_controlling_signal{ s_invalid_value };
 };
 
@@ -121,27 +144,11 @@ namespace std
 namespace lexgine::conversion
 {
 
-class TextureConverter : public core::NamedEntity<class_names::TextureConverter>
+class TextureConverter : public core::NamedEntity<class_names::TextureConverter>, public TextureMipmapUploader
 {
     friend class TextureConversionTask;
     friend class TextureUploadWork;
 private:
-    class sha256_provider final
-    {
-    public:
-        static constexpr unsigned c_hash_length = 32;
-
-        sha256_provider(TextureConverter* context);
-        ~sha256_provider();
-        std::array<uint8_t, c_hash_length> hash(std::span<uint8_t const> data) const;
-
-    private:
-        TextureConverter* m_context;
-        void* m_algorithm_handle;
-        void* m_hash_object_handle;
-        std::vector<uint8_t> m_hash_object_buffer;
-    };
-
     struct CachedTextureData
     {
         core::SharedDataChunk data;
@@ -159,9 +166,32 @@ public:
     TextureConversionTask const* addTextureConversionTask(scenegraph::Image& source_image, bool skip_source_image_load);
     core::dx::d3d12::ResourceDataUploader& getDataUploader() { return m_data_uploader; }
 
-    void convertTextures(uint32_t thread_count = static_cast<uint32_t>(-1));
+    /*! Schedules conversion of the added textures on the asset scheduler and returns immediately. The textures are converted
+     on the calling thread if the scheduler is not available
+    */
+    void convertTextures();
+
+    /*! Uploads converted textures to the GPU. When texture streaming is enabled only the mipmap tails of the textures are uploaded,
+     while more detailed mipmap levels are streamed in by updateTextureResidency() as requested by the renderer
+    */
     void uploadTextures();
 
+    bool isTextureStreamingEnabled() const { return m_texture_residency_manager != nullptr; }
+
+    //! Requests the texture to have all mipmap levels starting from the given one resident. Priority is normally given by screen coverage of the texture
+    void requestTextureMipmapLevel(core::misc::UUID const& texture_uuid, uint32_t most_detailed_level, float priority);
+
+    //! Streams in mipmap levels requested since the previous call and demotes the least recently used ones when the memory budget is exceeded. Expected to be called once per frame
+    void updateTextureResidency();
+
+    /*! Returns the most detailed mipmap level of the texture that is safe to sample from, i.e. the level which is resident and has finished uploading.
+     When streaming is disabled this is always 0
+    */
+    uint32_t residentMostDetailedMipmapLevel(core::misc::UUID const& texture_uuid) const;
+
+    bool uploadMipmapLevels(core::misc::UUID const& texture_uuid, uint32_t first_level, uint32_t level_count) override;
+    void releaseMipmapLevels(core::misc::UUID const& texture_uuid, uint32_t first_level, uint32_t level_count) override;
+
     bool isTextureConversionCompleted() const;
     bool isTextureUploadCompleted() const;
 
@@ -171,6 +201,8 @@ public:
 private:
     CachedTextureData readTextureFromCache(TextureConversionTaskKey const& key, core::misc::UUID& uuid) const;
     static [[nodiscard]] TextureConversionTaskKey createConversionTaskKey(scenegraph::Image& source_image);
+    static [[nodiscard]] core::misc::Sha256::Digest hashSourceImage(scenegraph::Image const& source_image);
+    static [[nodiscard]] core::misc::DateTime getSourceImageTimestamp(scenegraph::Image const& source_image);
 
 private:
     core::Globals& m_globals;
@@ -178,13 +210,22 @@ private:
     core::dx::d3d12::DedicatedUploadDataStreamAllocator m_upload_stream_allocator;
     core::dx::d3d12::ResourceDataUploader m_data_uploader;
 
-    std::unique_ptr<sha256_provider> m_sha256_provider;
     TextureTasksCache m_texture_conversion_tasks;
-    std::vector<std::future<void>> m_texture_conversion_futures;
+    std::vector<std::unique_ptr<core::concurrency::AbstractTask>> m_texture_conversion_scheduler_tasks;    //!< conversion tasks wrapped for the asset scheduler
+    std::shared_ptr<core::concurrency::AssetJob> m_texture_conversion_job;
 
     std::mutex m_texture_cache_mutex;
+    std::mutex m_gpu_compression_mutex;
     std::fstream m_cache_stream;
     std::unique_ptr<TextureCache> m_compressed_textures_cache;
+
+    struct StreamedTexture
+    {
+        TextureUploadWork* p_upload_work;
+        uint32_t sampled_level;    //!< the most detailed mipmap level, for which the upload has been completed on the GPU
+    };
+    std::map<core::misc::UUID, StreamedTexture> m_streamed_textures;
+    std::unique_ptr<TextureResidencyManager> m_texture_residency_manager;
 };
 
 }
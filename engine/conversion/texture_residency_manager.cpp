@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <cassert>
+
+#include <engine/core/misc/log.h>
+#include "texture_residency_manager.h"
+
+namespace lexgine::conversion
+{
+
+TextureResidencyManager::TextureResidencyManager(TextureMipmapUploader& uploader, uint64_t memory_budget, uint64_t mipmap_tail_budget, uint64_t upload_budget_per_update)
+    : m_uploader{ uploader }
+    , m_memory_budget{ memory_budget }
+    , m_mipmap_tail_budget{ mipmap_tail_budget }
+    , m_upload_budget_per_update{ upload_budget_per_update }
+    , m_resident_memory{ 0 }
+    , m_current_frame{ 0 }
+{
+
+}
+
+bool TextureResidencyManager::registerTexture(core::misc::UUID const& texture_uuid, std::vector<uint64_t> const& mipmap_level_sizes)
+{
+    if (mipmap_level_sizes.empty())
+    {
+        LEXGINE_LOG_ERROR(this, "Unable to register texture UUID{" + texture_uuid.toString() + "} for streaming: the texture has no mipmap levels");
+        return false;
+    }
+
+    if (m_textures.contains(texture_uuid))
+    {
+        LEXGINE_LOG_ERROR(this, "Texture UUID{" + texture_uuid.toString() + "} is already registered for streaming");
+        return false;
+    }
+
+    // the tail always includes the least detailed level even if it alone exceeds the tail budget
+    uint32_t const level_count = static_cast<uint32_t>(mipmap_level_sizes.size());
+    uint32_t tail_level = level_count - 1;
+    uint64_t tail_size = mipmap_level_sizes[tail_level];
+    while (tail_level > 0 && tail_size + mipmap_level_sizes[tail_level - 1] <= m_mipmap_tail_budget)
+    {
+        tail_size += mipmap_level_sizes[--tail_level];
+    }
+
+    if (!m_uploader.uploadMipmapLevels(texture_uuid, tail_level, level_count - tail_level))
+    {
+        LEXGINE_LOG_ERROR(this, "Unable to upload mipmap tail of texture UUID{" + texture_uuid.toString() + "}");
+        return false;
+    }
+
+    m_textures.emplace(texture_uuid, TextureResidency{
+        .mipmap_level_sizes = mipmap_level_sizes,
+        .resident_level = tail_level,
+        .tail_level = tail_level,
+        .requested_level = tail_level,
+        .priority = 0.f,
+        .last_request_frame = m_current_frame,
+        .lru_position = m_lru_list.insert(m_lru_list.end(), texture_uuid)
+    });
+    m_resident_memory += tail_size;
+
+    return true;
+}
+
+void TextureResidencyManager::unregisterTexture(core::misc::UUID const& texture_uuid)
+{
+    auto p = m_textures.find(texture_uuid);
+    if (p == m_textures.end()) return;
+
+    TextureResidency const& residency = p->second;
+    for (uint32_t level = residency.resident_level; level < residency.mipmap_level_sizes.size(); ++level)
+    {
+        m_resident_memory -= residency.mipmap_level_sizes[level];
+    }
+    m_lru_list.erase(residency.lru_position);
+    m_textures.erase(p);
+}
+
+void TextureResidencyManager::requestMipmapLevel(core::misc::UUID const& texture_uuid, uint32_t most_detailed_level, float priority)
+{
+    auto p = m_textures.find(texture_uuid);
+    if (p == m_textures.end()) return;    // the texture is not streamed
+
+    TextureResidency& residency = p->second;
+    most_detailed_level = (std::min)(most_detailed_level, residency.tail_level);
+    if (residency.last_request_frame == m_current_frame)
+    {
+        // the texture has already been requested during this frame (e.g. it is used by several objects), so the request is merged with the previous one
+        residency.requested_level = (std::min)(residency.requested_level, most_detailed_level);
+        residency.priority = (std::max)(residency.priority, priority);
+    }
+    else
+    {
+        residency.requested_level = most_detailed_level;
+        residency.priority = priority;
+        residency.last_request_frame = m_current_frame;
+    }
+    m_lru_list.splice(m_lru_list.end(), m_lru_list, residency.lru_position);
+}
+
+void TextureResidencyManager::update()
+{
+    std::vector<residency_map::value_type*> upgrade_candidates{};
+    for (auto& e : m_textures)
+    {
+        TextureResidency const& residency = e.second;
+        if (residency.last_request_frame == m_current_frame && residency.requested_level < residency.resident_level)
+        {
+            upgrade_candidates.push_back(&e);
+        }
+    }
+    std::sort(upgrade_candidates.begin(), upgrade_candidates.end(),
+        [](residency_map::value_type const* a, residency_map::value_type const* b) { return a->second.priority > b->second.priority; });
+
+    uint64_t uploaded_size{ 0 };
+    bool can_upload{ true };
+    for (auto it = upgrade_candidates.begin(); it != upgrade_candidates.end() && can_upload; ++it)
+    {
+        TextureResidency& residency = (*it)->second;
+        while (residency.resident_level > residency.requested_level)
+        {
+            uint64_t const level_size = residency.mipmap_level_sizes[residency.resident_level - 1];
+
+            // a level exceeding the upload budget on its own is still allowed to go through, but only as the first upload of the update
+            if (uploaded_size > 0 && uploaded_size + level_size > m_upload_budget_per_update)
+            {
+                can_upload = false;
+                break;
+            }
+
+            if (m_resident_memory + level_size > m_memory_budget && !makeRoom(level_size, **it))
+            {
+                break;    // textures with lower priority may still have smaller levels that fit into the budget
+            }
+
+            if (!upgrade(**it))
+            {
+                can_upload = false;    // the uploader cannot accept more data during this update
+                break;
+            }
+            uploaded_size += level_size;
+        }
+    }
+
+    ++m_current_frame;
+}
+
+uint32_t TextureResidencyManager::residentMostDetailedLevel(core::misc::UUID const& texture_uuid) const
+{
+    auto p = m_textures.find(texture_uuid);
+    return p == m_textures.end() ? 0U : p->second.resident_level;    // textures that are not streamed are always fully resident
+}
+
+bool TextureResidencyManager::upgrade(residency_map::value_type& texture)
+{
+    TextureResidency& residency = texture.second;
+    assert(residency.resident_level > 0);
+
+    uint32_t const level = residency.resident_level - 1;
+    if (!m_uploader.uploadMipmapLevels(texture.first, level, 1))
+    {
+        return false;
+    }
+
+    residency.resident_level = level;
+    m_resident_memory += residency.mipmap_level_sizes[level];
+    return true;
+}
+
+void TextureResidencyManager::demote(residency_map::value_type& texture)
+{
+    TextureResidency& residency = texture.second;
+    assert(residency.resident_level < residency.tail_level);
+
+    m_uploader.releaseMipmapLevels(texture.first, residency.resident_level, 1);
+    m_resident_memory -= residency.mipmap_level_sizes[residency.resident_level];
+    ++residency.resident_level;
+}
+
+bool TextureResidencyManager::makeRoom(uint64_t required_size, residency_map::value_type const& requesting_texture)
+{
+    // returns the least detailed level, down to which the texture can be demoted in favor of the requesting texture
+    auto demotion_limit = [this, &requesting_texture](residency_map::value_type const& texture)
+        {
+            TextureResidency const& residency = texture.second;
+            if (&texture == &requesting_texture) return residency.resident_level;
+
+            if (residency.last_request_frame < m_current_frame || residency.priority < requesting_texture.second.priority)
+            {
+                return residency.tail_level;
+            }
+
+            // the texture is in use during the current frame with the same or higher priority, so only the levels it did not ask for can be dropped
+            return (std::max)(residency.resident_level, residency.requested_level);
+        };
+
+    uint64_t const excess_size = m_resident_memory + required_size - m_memory_budget;
+
+    // check first that enough memory can be reclaimed so that nothing gets demoted in vain
+    uint64_t reclaimable_size{ 0 };
+    for (auto it = m_lru_list.begin(); it != m_lru_list.end() && reclaimable_size < excess_size; ++it)
+    {
+        auto const& texture = *m_textures.find(*it);
+        for (uint32_t level = texture.second.resident_level; level < demotion_limit(texture); ++level)
+        {
+            reclaimable_size += texture.second.mipmap_level_sizes[level];
+        }
+    }
+    if (reclaimable_size < excess_size)
+    {
+        return false;
+    }
+
+    for (auto it = m_lru_list.begin(); it != m_lru_list.end() && m_resident_memory + required_size > m_memory_budget; ++it)
+    {
+        auto& texture = *m_textures.find(*it);
+        uint32_t const limit = demotion_limit(texture);
+        while (texture.second.resident_level < limit && m_resident_memory + required_size > m_memory_budget)
+        {
+            demote(texture);
+        }
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,94 @@
+#ifndef LEXGINE_CONVERSION_TEXTURE_RESIDENCY_MANAGER_H
+#define LEXGINE_CONVERSION_TEXTURE_RESIDENCY_MANAGER_H
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <vector>
+
+#include <engine/core/entity.h>
+#include <engine/core/misc/uuid.h>
+#include "class_names.h"
+
+namespace lexgine::conversion
+{
+
+//! Interface of the object performing actual transfer of mipmap levels requested by texture residency manager
+class TextureMipmapUploader
+{
+public:
+    virtual ~TextureMipmapUploader() = default;
+
+    /*! Schedules mipmap levels [first_level, first_level + level_count) of all array layers of the texture for upload.
+     Returns 'false' if the upload could not be scheduled at the moment
+    */
+    virtual bool uploadMipmapLevels(core::misc::UUID const& texture_uuid, uint32_t first_level, uint32_t level_count) = 0;
+
+    //! Notifies that mipmap levels [first_level, first_level + level_count) of the texture are no longer resident and must not be sampled
+    virtual void releaseMipmapLevels(core::misc::UUID const& texture_uuid, uint32_t first_level, uint32_t level_count) = 0;
+};
+
+
+/*! Implements CPU-side part of texture mipmap streaming. When a texture is registered only its mipmap tail (i.e. the least detailed
+ levels fitting into the tail budget) is uploaded. More detailed levels are requested by the renderer each frame together with the
+ priority of the request (e.g. screen coverage of the texture) and are uploaded on update() in the order of decreasing priority,
+ one level at a time, while respecting both the per-update upload budget and the global memory budget. When the memory budget
+ is exceeded the textures least recently requested are demoted by dropping their most detailed levels; the mipmap tail is never demoted.
+ The manager is not thread-safe and is expected to be driven from the thread running the frame loop
+*/
+class TextureResidencyManager final : public core::NamedEntity<class_names::TextureResidencyManager>
+{
+public:
+    TextureResidencyManager(TextureMipmapUploader& uploader, uint64_t memory_budget, uint64_t mipmap_tail_budget, uint64_t upload_budget_per_update);
+
+    /*! Registers texture for streaming and uploads its mipmap tail. Sizes of the mipmap levels are given starting from the most
+     detailed level and must include data of all array layers of the texture
+    */
+    bool registerTexture(core::misc::UUID const& texture_uuid, std::vector<uint64_t> const& mipmap_level_sizes);
+    void unregisterTexture(core::misc::UUID const& texture_uuid);
+
+    //! Requests mipmap levels of the texture starting from the given most detailed level to become resident. Only the latest request made before update() is taken into account
+    void requestMipmapLevel(core::misc::UUID const& texture_uuid, uint32_t most_detailed_level, float priority);
+
+    //! Uploads and demotes mipmap levels according to the requests made since the previous update
+    void update();
+
+    uint32_t residentMostDetailedLevel(core::misc::UUID const& texture_uuid) const;    //! returns the most detailed mipmap level of the texture available for sampling
+    uint64_t residentMemory() const { return m_resident_memory; }    //! returns total size of all mipmap levels currently resident
+    uint64_t memoryBudget() const { return m_memory_budget; }
+    uint64_t currentFrame() const { return m_current_frame; }
+
+private:
+    struct TextureResidency
+    {
+        std::vector<uint64_t> mipmap_level_sizes;
+        uint32_t resident_level;    //!< most detailed level that is resident; all less detailed levels are resident too
+        uint32_t tail_level;    //!< most detailed level of the mipmap tail, which is never demoted
+        uint32_t requested_level;
+        float priority;
+        uint64_t last_request_frame;
+        std::list<core::misc::UUID>::iterator lru_position;
+    };
+
+    using residency_map = std::map<core::misc::UUID, TextureResidency>;
+
+private:
+    bool upgrade(residency_map::value_type& texture);    //! makes the next more detailed mipmap level of the texture resident
+    void demote(residency_map::value_type& texture);    //! drops the most detailed resident mipmap level of the texture
+    bool makeRoom(uint64_t required_size, residency_map::value_type const& requesting_texture);
+
+private:
+    TextureMipmapUploader& m_uploader;
+    uint64_t m_memory_budget;
+    uint64_t m_mipmap_tail_budget;
+    uint64_t m_upload_budget_per_update;
+
+    residency_map m_textures;
+    std::list<core::misc::UUID> m_lru_list;    //!< textures sorted from the least to the most recently requested
+    uint64_t m_resident_memory;
+    uint64_t m_current_frame;
+};
+
+}
+
+#endif
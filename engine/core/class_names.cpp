@@ -27,6 +27,7 @@ extern char const D3D12_ResourceDataUploader[] = "lexgine::core::dx:d3d12::Resou
 extern char const Task[] = "lexgine::core::concurrency::AbstractTask";
 extern char const TaskGraph[] = "lexgine::core::concurrency::TaskGraph";
 extern char const TaskSink[] = "lexgine::core::concurrency::TaskSink";
+extern char const AssetScheduler[] = "lexgine::core::concurrency::AssetScheduler";
 extern char const D3D12_PSOXMLParser[] = "lexgine::core::dx::d3d12::D3D12PSOXMLParser";
 extern char const ShaderSourceCodePreprocessor[] = "lexgine::core::ShaderSourceCodePreprocessor";
 extern char const Globals[] = "lexgine::core::Globals";
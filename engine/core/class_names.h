@@ -28,6 +28,7 @@ extern char const D3D12_ResourceDataUploader[];
 extern char const Task[];
 extern char const TaskGraph[];
 extern char const TaskSink[];
+extern char const AssetScheduler[];
 extern char const D3D12_PSOXMLParser[];
 extern char const ShaderSourceCodePreprocessor[];
 extern char const Globals[];
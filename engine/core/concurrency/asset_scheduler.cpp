@@ -0,0 +1,298 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+
+#include "asset_scheduler.h"
+#include "abstract_task.h"
+#include "task_graph_node.h"
+#include "engine/core/exception.h"
+#include "engine/core/misc/misc.h"
+
+using namespace lexgine::core::concurrency;
+using namespace lexgine::core::misc;
+
+
+AssetJob::AssetJob(AssetScheduler& scheduler, AssetJobPriority priority, uint32_t task_count)
+    : m_priority{ priority }
+    , m_is_cancelled{ false }
+    , m_failed_task{ nullptr }
+    , m_pending_task_count{ task_count }
+    , m_scheduler_ptr{ task_count ? &scheduler : nullptr }
+    , m_finish_time{ std::chrono::steady_clock::now() }    // jobs without tasks are finished on creation
+{
+
+}
+
+void AssetJob::cancel()
+{
+    m_is_cancelled.store(true, std::memory_order_release);
+
+    // the tasks of the job waiting for their dependencies must be dropped even if the dependencies never complete
+    AssetScheduler* p_scheduler{ nullptr };
+    {
+        std::lock_guard<std::mutex> lock{ m_completion_mutex };
+        p_scheduler = m_scheduler_ptr;
+    }
+    if (p_scheduler) p_scheduler->wakeDeferredTasks();
+}
+
+void AssetJob::wait() const
+{
+    std::unique_lock<std::mutex> lock{ m_completion_mutex };
+    assert(m_pending_task_count == 0 || !m_scheduler_ptr->isWorkerThread());    // the worker would wait for the tasks it is supposed to execute
+    m_completion_condition.wait(lock, [this]() { return m_pending_task_count == 0; });
+}
+
+bool AssetJob::isCancelled() const
+{
+    return m_is_cancelled.load(std::memory_order_acquire);
+}
+
+bool AssetJob::isFinished() const
+{
+    return pendingTaskCount() == 0;
+}
+
+bool AssetJob::hasFailed() const
+{
+    return failedTask() != nullptr;
+}
+
+AbstractTask const* AssetJob::failedTask() const
+{
+    return m_failed_task.load(std::memory_order_acquire);
+}
+
+uint32_t AssetJob::pendingTaskCount() const
+{
+    std::lock_guard<std::mutex> lock{ m_completion_mutex };
+    return m_pending_task_count;
+}
+
+std::chrono::steady_clock::time_point AssetJob::finishTime() const
+{
+    std::lock_guard<std::mutex> lock{ m_completion_mutex };
+    return m_finish_time;
+}
+
+void AssetJob::taskFinished()
+{
+    std::lock_guard<std::mutex> lock{ m_completion_mutex };
+    assert(m_pending_task_count > 0);
+    if (--m_pending_task_count == 0)
+    {
+        m_finish_time = std::chrono::steady_clock::now();
+        m_scheduler_ptr = nullptr;
+        m_completion_condition.notify_all();
+    }
+}
+
+void AssetJob::taskFailed(AbstractTask const& task)
+{
+    // only the first failure is reported, the remaining tasks of the job are dropped the same way as on cancellation
+    AbstractTask const* p_no_failure{ nullptr };
+    m_failed_task.compare_exchange_strong(p_no_failure, &task, std::memory_order_acq_rel);
+    cancel();
+}
+
+
+
+AssetScheduler::AssetScheduler(uint8_t num_workers, std::string const& debug_name)
+    : m_is_shutting_down{ false }
+{
+    setStringName(debug_name);
+
+    num_workers = (std::max)(num_workers, uint8_t{ 1 });
+    logger().out(formatString("Starting asset scheduler %s with %i worker threads", getStringName().c_str(), num_workers), LogMessageType::information);
+
+    m_workers.reserve(num_workers);
+    for (uint8_t i = 0; i < num_workers; ++i)
+    {
+        m_workers.emplace_back(&AssetScheduler::dispatch, this, i);
+
+        #ifdef _WIN32
+        SetThreadDescription(m_workers.back().native_handle(), std::format(L"{} thread #{}", asciiStringToWstring(getStringName()), i).c_str());
+        #endif
+    }
+}
+
+AssetScheduler::~AssetScheduler()
+{
+    logger().out(formatString("Asset scheduler %s is shutting down", getStringName().c_str()), LogMessageType::information);
+
+    {
+        std::lock_guard<std::mutex> lock{ m_queue_mutex };
+        m_is_shutting_down = true;
+    }
+    m_queue_condition.notify_all();
+
+    for (std::thread& worker : m_workers)
+    {
+        worker.join();
+    }
+
+    // the tasks that have never been started are dropped, so that nobody keeps waiting for their jobs. The jobs are only marked
+    // as cancelled, since cancel() would wake the deferred tasks, which are being dropped here as well
+    auto drop_task = [](QueuedTask& task)
+        {
+            task.job->m_is_cancelled.store(true, std::memory_order_release);
+            task.job->taskFinished();
+        };
+    for (std::deque<QueuedTask>& queue : m_queues)
+    {
+        std::for_each(queue.begin(), queue.end(), drop_task);
+        queue.clear();
+    }
+    std::for_each(m_deferred_tasks.begin(), m_deferred_tasks.end(), drop_task);
+    m_deferred_tasks.clear();
+}
+
+std::shared_ptr<AssetJob> AssetScheduler::submit(std::vector<AbstractTask*> const& tasks, AssetJobPriority priority, uint64_t user_data)
+{
+    assert(priority < AssetJobPriority::count);
+
+    std::shared_ptr<AssetJob> job{ new AssetJob{ *this, priority, static_cast<uint32_t>(tasks.size()) } };
+    if (tasks.empty()) return job;
+
+    {
+        std::lock_guard<std::mutex> lock{ m_queue_mutex };
+        assert(!m_is_shutting_down);
+
+        std::deque<QueuedTask>& queue = m_queues[static_cast<size_t>(priority)];
+        for (AbstractTask* p_task : tasks)
+        {
+            TaskGraphNode* p_task_graph_node = dynamic_cast<TaskGraphNode*>(p_task);
+            if (p_task_graph_node)
+            {
+                p_task_graph_node->setUserData(user_data);
+            }
+            queue.push_back(QueuedTask{ .p_task = p_task, .p_task_graph_node = p_task_graph_node, .user_data = user_data, .job = job });
+        }
+    }
+    m_queue_condition.notify_all();
+
+    return job;
+}
+
+size_t AssetScheduler::queuedTaskCount() const
+{
+    std::lock_guard<std::mutex> lock{ m_queue_mutex };
+
+    size_t rv{ m_deferred_tasks.size() };
+    for (std::deque<QueuedTask> const& queue : m_queues)
+    {
+        rv += queue.size();
+    }
+    return rv;
+}
+
+void AssetScheduler::wakeDeferredTasks()
+{
+    {
+        std::lock_guard<std::mutex> lock{ m_queue_mutex };
+        if (m_deferred_tasks.empty()) return;
+
+        // the deferred tasks have been queued before the tasks remaining in the queues, so they are returned to the front of the queues
+        for (auto p = m_deferred_tasks.rbegin(); p != m_deferred_tasks.rend(); ++p)
+        {
+            m_queues[static_cast<size_t>(p->job->priority())].push_front(std::move(*p));
+        }
+        m_deferred_tasks.clear();
+    }
+    m_queue_condition.notify_all();
+}
+
+bool AssetScheduler::isWorkerThread() const
+{
+    std::thread::id const current_thread_id = std::this_thread::get_id();
+    return std::any_of(m_workers.begin(), m_workers.end(),
+        [current_thread_id](std::thread const& worker) { return worker.get_id() == current_thread_id; });
+}
+
+void AssetScheduler::dispatch(uint8_t worker_id)
+{
+    QueuedTask task{};
+    while (acquireTask(task))
+    {
+        if (executeTask(worker_id, task))
+        {
+            // the dependents of the completed task graph node may be deferred
+            if (task.p_task_graph_node && task.p_task_graph_node->isCompleted()) wakeDeferredTasks();
+            task.job->taskFinished();
+        }
+        else
+        {
+            {
+                std::lock_guard<std::mutex> lock{ m_queue_mutex };
+                m_queues[static_cast<size_t>(task.job->priority())].push_back(std::move(task));
+            }
+            m_queue_condition.notify_one();
+        }
+        task = QueuedTask{};
+    }
+}
+
+bool AssetScheduler::acquireTask(QueuedTask& task)
+{
+    std::unique_lock<std::mutex> lock{ m_queue_mutex };
+    while (!m_is_shutting_down)
+    {
+        for (std::deque<QueuedTask>& queue : m_queues)
+        {
+            while (!queue.empty())
+            {
+                QueuedTask candidate = std::move(queue.front());
+                queue.pop_front();
+
+                if (candidate.job->isCancelled())
+                {
+                    candidate.job->taskFinished();
+                    continue;
+                }
+
+                // the tasks that are not ready yet are parked until one of the dependencies completes, see wakeDeferredTasks()
+                if (candidate.p_task_graph_node && !candidate.p_task_graph_node->isReadyToLaunch())
+                {
+                    m_deferred_tasks.push_back(std::move(candidate));
+                    continue;
+                }
+
+                task = std::move(candidate);
+                return true;
+            }
+        }
+
+        m_queue_condition.wait(lock);
+    }
+    return false;
+}
+
+bool AssetScheduler::executeTask(uint8_t worker_id, QueuedTask const& task)
+{
+    bool is_completed{ false };
+    bool has_thrown{ false };
+    try
+    {
+        is_completed = task.p_task_graph_node
+            ? task.p_task_graph_node->execute(worker_id)
+            : task.p_task->execute(worker_id, task.user_data);
+    }
+    catch (lexgine::core::Exception const&)
+    {
+        // the tasks log their errors themselves when calling raiseError(...), which also puts them into erroneous state
+        has_thrown = true;
+    }
+
+    if (has_thrown || task.p_task->getErrorState())
+    {
+        task.job->taskFailed(*task.p_task);
+        return true;
+    }
+
+    if (!is_completed && task.p_task_graph_node)
+    {
+        // the node must be allowed to get executed again
+        task.p_task_graph_node->resetExecutionStatus();
+    }
+    return is_completed;
+}
@@ -0,0 +1,137 @@
+#ifndef LEXGINE_CORE_CONCURRENCY_ASSET_SCHEDULER_H
+#define LEXGINE_CORE_CONCURRENCY_ASSET_SCHEDULER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "engine/core/entity.h"
+#include "engine/core/class_names.h"
+#include "lexgine_core_concurrency_fwd.h"
+
+namespace lexgine::core::concurrency {
+
+//! Priority of asset processing jobs. Tasks of jobs with higher priority are always dispatched before the tasks of the jobs with lower priority
+enum class AssetJobPriority : uint8_t
+{
+    high = 0,
+    normal,
+    low,
+    count
+};
+
+
+/*! Handle of a group of tasks submitted to the asset scheduler. The job is finished once each of its tasks
+ has either been completed or dropped due to cancellation or a failure of another task of the job
+*/
+class AssetJob final
+{
+    friend class AssetScheduler;
+
+public:
+    AssetJob(AssetJob const&) = delete;
+    AssetJob& operator=(AssetJob const&) = delete;
+
+    /*! Cancels the job. The tasks of the job that have not been started yet are dropped, while the tasks being executed
+     at the moment of cancellation are still allowed to complete
+    */
+    void cancel();
+
+    /*! Blocks the calling thread until the job is finished. Must not be called from the worker threads of the scheduler the job
+     has been submitted to unless the job is known to be finished: the waiting worker would not be able to execute the tasks of the
+     job, so that the pool could deadlock once all of its workers are waiting
+    */
+    void wait() const;
+
+    bool isCancelled() const;    //! returns 'true' if the job has been cancelled either explicitly or due to a failure of one of its tasks
+    bool isFinished() const;    //! returns 'true' if none of the tasks of the job is either queued or being executed
+    bool hasFailed() const;    //! returns 'true' if one of the tasks of the job has failed
+    AbstractTask const* failedTask() const;    //! returns the task that has caused the job to fail or nullptr if the job has not failed
+
+    AssetJobPriority priority() const { return m_priority; }
+    uint32_t pendingTaskCount() const;    //! returns number of tasks of the job that are either queued or being executed
+    std::chrono::steady_clock::time_point finishTime() const;    //! returns the moment the last task of the job has finished, only valid once the job is finished
+
+private:
+    AssetJob(AssetScheduler& scheduler, AssetJobPriority priority, uint32_t task_count);
+
+    void taskFinished();
+    void taskFailed(AbstractTask const& task);
+
+private:
+    AssetJobPriority const m_priority;
+    std::atomic_bool m_is_cancelled;
+    std::atomic<AbstractTask const*> m_failed_task;
+
+    mutable std::mutex m_completion_mutex;
+    mutable std::condition_variable m_completion_condition;
+    uint32_t m_pending_task_count;    //!< guarded by m_completion_mutex
+    AssetScheduler* m_scheduler_ptr;    //!< scheduler executing the tasks of the job, reset once the job is finished. Guarded by m_completion_mutex
+    std::chrono::steady_clock::time_point m_finish_time;    //!< guarded by m_completion_mutex
+};
+
+
+/*! Persistent pool of worker threads executing asset processing tasks, e.g. assembly of materials, conversion of textures or
+ processing of meshes. Unlike TaskSink, the scheduler is not bound to a single task graph: it is created once and accepts jobs
+ from any number of concurrent scene loads. Tasks are dispatched in the order of priorities of their jobs and, within the same
+ priority, in the order of submission. Tasks that are also task graph nodes are only dispatched once their dependencies have
+ been completed, and the tasks returning 'false' from doTask() are re-queued for later execution. The tasks waiting for their
+ dependencies are parked and only get re-examined when a task graph node completes on the scheduler, when a job gets cancelled
+ or when wakeDeferredTasks() is called
+*/
+class AssetScheduler final : public NamedEntity<class_names::AssetScheduler>
+{
+public:
+    AssetScheduler(uint8_t num_workers, std::string const& debug_name = "");
+    ~AssetScheduler();
+
+    AssetScheduler(AssetScheduler const&) = delete;
+    AssetScheduler& operator=(AssetScheduler const&) = delete;
+
+    /*! Queues the tasks for execution and returns handle of the job they constitute. The tasks must stay alive until
+     the job is finished. The user data are forwarded to each of the tasks on execution. Tasks executed by the scheduler
+     may submit further jobs, but must not wait for them (see AssetJob::wait())
+    */
+    std::shared_ptr<AssetJob> submit(std::vector<AbstractTask*> const& tasks, AssetJobPriority priority = AssetJobPriority::normal, uint64_t user_data = 0U);
+
+    /*! Re-examines the tasks waiting for their task graph dependencies. The dependencies executed by the scheduler wake their
+     dependents automatically, so this only has to be called when a dependency of a submitted task gets completed elsewhere
+    */
+    void wakeDeferredTasks();
+
+    uint8_t getNumberOfWorkerThreads() const { return static_cast<uint8_t>(m_workers.size()); }
+    size_t queuedTaskCount() const;    //! returns number of tasks waiting for execution
+    bool isWorkerThread() const;    //! returns 'true' if called from one of the worker threads of the scheduler
+
+private:
+    struct QueuedTask
+    {
+        AbstractTask* p_task;
+        TaskGraphNode* p_task_graph_node;    //!< task graph node of the task or nullptr if the task is not a part of a task graph
+        uint64_t user_data;
+        std::shared_ptr<AssetJob> job;
+    };
+
+private:
+    void dispatch(uint8_t worker_id);    //! function looped by worker threads
+    bool acquireTask(QueuedTask& task);    //! blocks until a task is ready for execution. Returns 'false' if the scheduler is shutting down
+    bool executeTask(uint8_t worker_id, QueuedTask const& task);    //! returns 'false' if the task has to be re-queued
+
+private:
+    std::vector<std::thread> m_workers;
+
+    mutable std::mutex m_queue_mutex;
+    std::condition_variable m_queue_condition;
+    std::deque<QueuedTask> m_queues[static_cast<size_t>(AssetJobPriority::count)];    //!< task queues per job priority, guarded by m_queue_mutex
+    std::vector<QueuedTask> m_deferred_tasks;    //!< tasks waiting for their dependencies, guarded by m_queue_mutex
+    bool m_is_shutting_down;    //!< guarded by m_queue_mutex
+};
+
+}
+
+#endif    // LEXGINE_CORE_CONCURRENCY_ASSET_SCHEDULER_H
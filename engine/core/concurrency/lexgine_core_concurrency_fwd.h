@@ -11,6 +11,8 @@ class TaskGraph;
 class TaskSink;
 class TaskGraphNode;
 class TaskGraphRootNode;
+class AssetJob;
+class AssetScheduler;
 
 
 }}}
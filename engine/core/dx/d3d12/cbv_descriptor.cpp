@@ -9,6 +9,7 @@ namespace lexgine::core::dx::d3d12
 CBVDescriptor::CBVDescriptor(Resource const& resource,
     uint32_t offset_from_start, uint32_t view_size_in_bytes) 
     : m_resource_ref{ resource }
+    , m_native()
 {
     auto resource_desc = resource.descriptor();
 
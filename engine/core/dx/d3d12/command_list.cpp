@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 
 #include "command_list.h"
 #include "device.h"
@@ -37,9 +38,42 @@ RECT convertRectangleToDXGINativeRECT(math::Rectangle const& rectangle)
     return rv;
 }
 
+StateCacheBindPoint stateCacheBindPoint(CommandType cmd_list_type, BundleInvocationContext bundle_invokation_context)
+{
+    return cmd_list_type == CommandType::direct || bundle_invokation_context == BundleInvocationContext::direct
+        ? StateCacheBindPoint::graphics
+        : StateCacheBindPoint::compute;
+}
+
+// the state cache shadows the views in API-agnostic layouts matching the native ones
+static_assert(sizeof(CommandStreamVertexBufferView) == sizeof(D3D12_VERTEX_BUFFER_VIEW)
+    && offsetof(CommandStreamVertexBufferView, stride_in_bytes) == offsetof(D3D12_VERTEX_BUFFER_VIEW, StrideInBytes));
+static_assert(sizeof(CommandStreamIndexBufferView) == sizeof(D3D12_INDEX_BUFFER_VIEW)
+    && offsetof(CommandStreamIndexBufferView, format) == offsetof(D3D12_INDEX_BUFFER_VIEW, Format));
+
 }
 
 
+//! Records the barriers emitted by the resource state tracker into the command list
+class CommandList::ResourceBarrierSink final : public AbstractResourceBarrierSink
+{
+public:
+    ResourceBarrierSink(CommandList const& command_list)
+        : m_command_list{ command_list }
+    {
+
+    }
+
+    void applyBarriers(std::vector<TrackedResourceBarrier> const& barriers) override
+    {
+        m_command_list.recordResourceBarriers(static_cast<uint32_t>(barriers.size()), barriers.data());
+    }
+
+private:
+    CommandList const& m_command_list;
+};
+
+
 uint32_t CommandList::getNodeMask() const
 {
     return m_node_mask;
@@ -67,6 +101,8 @@ void CommandList::reset(PipelineState const* initial_pipeline_state)
         S_OK);
 
     m_initial_pipeline_state = initial_pipeline_state;
+    m_resource_state_tracker.reset();
+    m_state_cache.invalidate();
 }
 
 void CommandList::close() const
@@ -80,28 +116,96 @@ void CommandList::close() const
 void CommandList::clearState() const
 {
     m_command_list->ClearState(m_initial_pipeline_state->native().Get());
+    m_state_cache.invalidate();
 }
 
 void CommandList::resourceBarrier(uint32_t num_barriers, void const* resource_barriers_data_ptr) const
 {
     D3D12_RESOURCE_BARRIER const* p_barriers = static_cast<D3D12_RESOURCE_BARRIER const*>(resource_barriers_data_ptr);
+    for (uint32_t i = 0; i < num_barriers; ++i)
+    {
+        D3D12_RESOURCE_BARRIER const& e = p_barriers[i];
+        if (e.Type != D3D12_RESOURCE_BARRIER_TYPE_TRANSITION || e.Flags == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY) continue;
+
+        m_resource_state_tracker.recordManualTransition(Resource::uniqueId(e.Transition.pResource),
+            e.Transition.Subresource == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES ? TrackedResourceBarrier::c_all_subresources : e.Transition.Subresource,
+            ResourceState{ static_cast<int>(e.Transition.StateAfter) });
+    }
+
     m_command_list->ResourceBarrier(num_barriers, p_barriers);
 }
 
+void CommandList::resourceBarrier(uint32_t num_barriers, TrackedResourceBarrier const* p_barriers) const
+{
+    for (uint32_t i = 0; i < num_barriers; ++i)
+    {
+        TrackedResourceBarrier const& e = p_barriers[i];
+        if (e.type != TrackedResourceBarrierType::transition || e.split_flags == SplitResourceBarrierFlags::begin) continue;
+
+        m_resource_state_tracker.recordManualTransition(e.p_resource->uniqueId(), e.subresource, e.state_after);
+    }
+
+    recordResourceBarriers(num_barriers, p_barriers);
+}
+
+void CommandList::recordResourceBarriers(uint32_t num_barriers, TrackedResourceBarrier const* p_barriers) const
+{
+    std::vector<D3D12_RESOURCE_BARRIER> native_barriers(num_barriers);
+    std::transform(p_barriers, p_barriers + num_barriers, native_barriers.begin(),
+        [](TrackedResourceBarrier const& e)
+        {
+            D3D12_RESOURCE_BARRIER rv{};
+            rv.Flags = static_cast<D3D12_RESOURCE_BARRIER_FLAGS>(e.split_flags);
+            if (e.type == TrackedResourceBarrierType::uav)
+            {
+                rv.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+                rv.UAV.pResource = e.p_resource->native().Get();
+            }
+            else
+            {
+                rv.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+                rv.Transition.pResource = e.p_resource->native().Get();
+                rv.Transition.Subresource = e.subresource == TrackedResourceBarrier::c_all_subresources
+                    ? D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES : e.subresource;
+                rv.Transition.StateBefore = static_cast<D3D12_RESOURCE_STATES>(e.state_before.getValue());
+                rv.Transition.StateAfter = static_cast<D3D12_RESOURCE_STATES>(e.state_after.getValue());
+            }
+            return rv;
+        }
+    );
+
+    m_command_list->ResourceBarrier(static_cast<UINT>(num_barriers), native_barriers.data());
+}
+
+void CommandList::flushResourceBarriers()
+{
+    ResourceBarrierSink sink{ *this };
+    m_resource_state_tracker.flush(sink);
+}
+
+void CommandList::finalizeResourceBarriers()
+{
+    ResourceBarrierSink sink{ *this };
+    m_resource_state_tracker.finalize(sink);
+}
+
 void CommandList::drawInstanced(uint32_t vertex_count_per_instance, uint32_t instance_count, uint32_t start_vertex_location, uint32_t start_instance_location) const
 {
+    m_state_cache.commitRootParameters(StateCacheBindPoint::graphics);
     m_command_list->DrawInstanced(static_cast<UINT>(vertex_count_per_instance), static_cast<UINT>(instance_count),
         static_cast<UINT>(start_vertex_location), static_cast<UINT>(start_instance_location));
 }
 
 void CommandList::drawIndexedInstanced(uint32_t index_count_per_instance, uint32_t instance_count, uint32_t start_index_location, uint32_t base_vertex_location, uint32_t start_instance_location) const
 {
+    m_state_cache.commitRootParameters(StateCacheBindPoint::graphics);
     m_command_list->DrawIndexedInstanced(static_cast<UINT>(index_count_per_instance), static_cast<UINT>(instance_count),
         static_cast<UINT>(start_index_location), static_cast<UINT>(base_vertex_location), static_cast<UINT>(start_instance_location));
 }
 
 void CommandList::dispatch(uint32_t thread_group_x, uint32_t thread_group_y, uint32_t thread_group_z) const
 {
+    m_state_cache.commitRootParameters(StateCacheBindPoint::compute);
     m_command_list->Dispatch(
         static_cast<UINT>(thread_group_x),
         static_cast<UINT>(thread_group_y),
@@ -199,6 +303,8 @@ void CommandList::resolveSubresource(Resource const& dst_resource, uint32_t dst_
 
 void CommandList::inputAssemblySetPrimitiveTopology(PrimitiveTopology primitive_topology) const
 {
+    if (!m_state_cache.setPrimitiveTopology(primitive_topology)) return;
+
     uint8_t native_topology = d3d12Convert(primitive_topology);
     
 
@@ -230,7 +336,8 @@ void CommandList::inputAssemblySetVertexBuffers(VertexBufferBinding const& vb_bi
         }
         else
         {
-            m_command_list->IASetVertexBuffers(static_cast<UINT>(base), static_cast<UINT>(offset_old - base + 1), &native_vb_views[base]);
+            inputAssemblySetVertexBuffers(static_cast<uint32_t>(base),
+                reinterpret_cast<CommandStreamVertexBufferView const*>(&native_vb_views[base]), static_cast<uint32_t>(offset_old - base + 1));
             base = offset;
             buffers_set = true;
         }
@@ -240,10 +347,24 @@ void CommandList::inputAssemblySetVertexBuffers(VertexBufferBinding const& vb_bi
     }
 }
 
+void CommandList::inputAssemblySetVertexBuffers(uint32_t start_slot, CommandStreamVertexBufferView const* p_views, uint32_t count)
+{
+    if (!m_state_cache.setVertexBuffers(start_slot, p_views, count)) return;
+
+    m_command_list->IASetVertexBuffers(static_cast<UINT>(start_slot), static_cast<UINT>(count),
+        reinterpret_cast<D3D12_VERTEX_BUFFER_VIEW const*>(p_views));
+}
+
 void CommandList::inputAssemblySetIndexBuffer(IndexBufferBinding const& ib_binding)
 {
-    D3D12_INDEX_BUFFER_VIEW const& native_ib_view = ib_binding.indexBufferView();
-    m_command_list->IASetIndexBuffer(&native_ib_view);
+    inputAssemblySetIndexBuffer(reinterpret_cast<CommandStreamIndexBufferView const&>(ib_binding.indexBufferView()));
+}
+
+void CommandList::inputAssemblySetIndexBuffer(CommandStreamIndexBufferView const& view)
+{
+    if (!m_state_cache.setIndexBuffer(view)) return;
+
+    m_command_list->IASetIndexBuffer(reinterpret_cast<D3D12_INDEX_BUFFER_VIEW const*>(&view));
 }
 
 void CommandList::rasterizerStateSetViewports(misc::StaticVector<Viewport, c_maximal_viewport_count> const& viewports) const
@@ -402,6 +523,8 @@ void CommandList::clearUnorderedAccessView(DescriptorTable const& uav_descriptor
 
 void CommandList::setPipelineState(PipelineState const& pipeline_state) const
 {
+    if (!m_state_cache.setPipelineState(&pipeline_state)) return;
+
     m_command_list->SetPipelineState(pipeline_state.native().Get());
 }
 
@@ -413,6 +536,7 @@ void CommandList::setDescriptorHeaps(std::array<DescriptorHeap const*, 2> const&
     // the bundle must correspond to the heaps set by the invoking command list, so this API is 
     // essentially useless for bundles and therefore, we disallow it
     assert((cmd_list_type == CommandType::direct || cmd_list_type == CommandType::compute));
+    if (!m_state_cache.setDescriptorHeaps(descriptor_heaps[0], descriptor_heaps[1])) return;
 
     std::array<ID3D12DescriptorHeap*, 2> native_descriptor_heaps{};
     native_descriptor_heaps[0] = descriptor_heaps[0]->native().Get();
@@ -422,7 +546,7 @@ void CommandList::setDescriptorHeaps(std::array<DescriptorHeap const*, 2> const&
 }
 
 
-void CommandList::setRootSignature(std::string const& cached_root_signature_friendly_name, 
+void CommandList::setRootSignature(std::string_view cached_root_signature_friendly_name, 
     BundleInvocationContext bundle_invokation_context) const
 {
     auto cmd_list_type = commandType();
@@ -437,11 +561,13 @@ void CommandList::setRootSignature(std::string const& cached_root_signature_frie
     if (!rs)
     {
         LEXGINE_THROW_ERROR_FROM_NAMED_ENTITY(this, "Cannot set root signature for command list \""
-        + getStringName() + "\": the root signature is identified to have friendly name \"" + cached_root_signature_friendly_name
+        + getStringName() + "\": the root signature is identified to have friendly name \"" + std::string{ cached_root_signature_friendly_name }
         + "\", but no root signature with this friendly name and the node mask " + std::to_string(m_node_mask)
         + " exists in the device cache. This usually means that the root signature has not been created for "
         " the node mask required by the command list attempting to set this root signature");
     }
+
+    if (!m_state_cache.setRootSignature(stateCacheBindPoint(cmd_list_type, bundle_invokation_context), rs.Get())) return;
     
     cmd_list_type == CommandType::direct || bundle_invokation_context == BundleInvocationContext::direct
         ? m_command_list->SetGraphicsRootSignature(rs.Get())
@@ -459,6 +585,9 @@ void CommandList::setRootDescriptorTable(uint32_t root_signature_slot,
         || cmd_list_type == CommandType::bundle
         && (bundle_invokation_context == BundleInvocationContext::direct || bundle_invokation_context == BundleInvocationContext::compute));
 
+    if (!m_state_cache.setRootDescriptorTable(stateCacheBindPoint(cmd_list_type, bundle_invokation_context),
+        root_signature_slot, virtual_gpu_memory_address)) return;
+
     cmd_list_type == CommandType::direct || bundle_invokation_context == BundleInvocationContext::direct
         ? m_command_list->SetGraphicsRootDescriptorTable(static_cast<UINT>(root_signature_slot),
             D3D12_GPU_DESCRIPTOR_HANDLE{ virtual_gpu_memory_address })
@@ -476,6 +605,9 @@ void CommandList::setRoot32BitConstant(uint32_t root_signature_slot, uint32_t da
         || cmd_list_type == CommandType::bundle
         && (bundle_invokation_context == BundleInvocationContext::direct || bundle_invokation_context == BundleInvocationContext::compute));
 
+    if (!m_state_cache.setRoot32BitConstants(stateCacheBindPoint(cmd_list_type, bundle_invokation_context),
+        root_signature_slot, &data, 1U, offset_in_32_bit_values)) return;
+
     cmd_list_type == CommandType::direct || bundle_invokation_context == BundleInvocationContext::direct
         ? m_command_list->SetGraphicsRoot32BitConstant(static_cast<UINT>(root_signature_slot),
             static_cast<UINT>(data), static_cast<UINT>(offset_in_32_bit_values))
@@ -485,6 +617,12 @@ void CommandList::setRoot32BitConstant(uint32_t root_signature_slot, uint32_t da
 
 void CommandList::setRoot32BitConstants(uint32_t root_signature_slot, std::vector<uint32_t> const& data, 
     uint32_t offset_in_32_bit_values, BundleInvocationContext bundle_invokation_context) const
+{
+    setRoot32BitConstants(root_signature_slot, data.data(), static_cast<uint32_t>(data.size()), offset_in_32_bit_values, bundle_invokation_context);
+}
+
+void CommandList::setRoot32BitConstants(uint32_t root_signature_slot, uint32_t const* p_data, uint32_t count,
+    uint32_t offset_in_32_bit_values, BundleInvocationContext bundle_invokation_context) const
 {
     auto cmd_list_type = commandType();
 
@@ -493,11 +631,14 @@ void CommandList::setRoot32BitConstants(uint32_t root_signature_slot, std::vecto
         || cmd_list_type == CommandType::bundle
         && (bundle_invokation_context == BundleInvocationContext::direct || bundle_invokation_context == BundleInvocationContext::compute));
 
+    if (!m_state_cache.setRoot32BitConstants(stateCacheBindPoint(cmd_list_type, bundle_invokation_context),
+        root_signature_slot, p_data, count, offset_in_32_bit_values)) return;
+
     cmd_list_type == CommandType::direct || bundle_invokation_context == BundleInvocationContext::direct
         ? m_command_list->SetGraphicsRoot32BitConstants(static_cast<UINT>(root_signature_slot),
-            static_cast<UINT>(data.size()), data.data(), static_cast<UINT>(offset_in_32_bit_values))
+            static_cast<UINT>(count), p_data, static_cast<UINT>(offset_in_32_bit_values))
         : m_command_list->SetComputeRoot32BitConstants(static_cast<UINT>(root_signature_slot),
-            static_cast<UINT>(data.size()), data.data(), static_cast<UINT>(offset_in_32_bit_values));
+            static_cast<UINT>(count), p_data, static_cast<UINT>(offset_in_32_bit_values));
 }
 
 void CommandList::setRootShaderResourceView(uint32_t root_signature_slot, 
@@ -511,6 +652,9 @@ void CommandList::setRootShaderResourceView(uint32_t root_signature_slot,
         || cmd_list_type == CommandType::bundle
         && (bundle_invokation_context == BundleInvocationContext::direct || bundle_invokation_context == BundleInvocationContext::compute));
 
+    if (!m_state_cache.setRootShaderResourceView(stateCacheBindPoint(cmd_list_type, bundle_invokation_context),
+        root_signature_slot, gpu_virtual_address)) return;
+
     cmd_list_type == CommandType::direct || bundle_invokation_context == BundleInvocationContext::direct
         ? m_command_list->SetGraphicsRootShaderResourceView(static_cast<UINT>(root_signature_slot),
             static_cast<D3D12_GPU_VIRTUAL_ADDRESS>(gpu_virtual_address))
@@ -529,6 +673,9 @@ void CommandList::setRootUnorderedAccessView(uint32_t root_signature_slot,
         || cmd_list_type == CommandType::bundle
         && (bundle_invokation_context == BundleInvocationContext::direct || bundle_invokation_context == BundleInvocationContext::compute));
 
+    if (!m_state_cache.setRootUnorderedAccessView(stateCacheBindPoint(cmd_list_type, bundle_invokation_context),
+        root_signature_slot, gpu_virtual_address)) return;
+
     cmd_list_type == CommandType::direct || bundle_invokation_context == BundleInvocationContext::direct
         ? m_command_list->SetGraphicsRootUnorderedAccessView(static_cast<UINT>(root_signature_slot),
             static_cast<D3D12_GPU_VIRTUAL_ADDRESS>(gpu_virtual_address))
@@ -561,6 +708,9 @@ void CommandList::setRootConstantBufferView(uint32_t root_signature_slot,
         || cmd_list_type == CommandType::bundle
         && (bundle_invokation_context == BundleInvocationContext::direct || bundle_invokation_context == BundleInvocationContext::compute));
 
+    if (!m_state_cache.setRootConstantBufferView(stateCacheBindPoint(cmd_list_type, bundle_invokation_context),
+        root_signature_slot, gpu_virtual_address)) return;
+
     cmd_list_type == CommandType::direct || bundle_invokation_context == BundleInvocationContext::direct
         ? m_command_list->SetGraphicsRootConstantBufferView(static_cast<UINT>(root_signature_slot),
             static_cast<D3D12_GPU_VIRTUAL_ADDRESS>(gpu_virtual_address))
@@ -4,6 +4,7 @@
 #include <wrl.h>
 #include <d3d12.h>
 
+#include <string_view>
 #include <variant>
 
 #include "engine/core/entity.h"
@@ -19,8 +20,10 @@
 
 #include "lexgine_core_dx_d3d12_fwd.h"
 #include "command_allocator_ring.h"
+#include "command_list_state_cache.h"
 #include "descriptor_heap.h"
 #include "fence.h"
+#include "resource_state_tracker.h"
 #include "signal.h"
 
 
@@ -96,7 +99,18 @@ public:
 
     void setPipelineState(PipelineState const& pipeline_state) const;
 
-    void resourceBarrier(uint32_t num_barriers, void const* resource_barriers_data_ptr) const;    //! records resource barriers into the command list
+    /*! records resource barriers into the command list. The transitions recorded this way bypass requests of the resource states, but are
+     reported to the resource state tracker, so that the registry of the resource states keeps following the transitioned resources
+    */
+    void resourceBarrier(uint32_t num_barriers, void const* resource_barriers_data_ptr) const;
+
+    void resourceBarrier(uint32_t num_barriers, TrackedResourceBarrier const* p_barriers) const;    //! records resource barriers described in API-agnostic form into the command list, the transitions are reported to the tracker
+
+    ResourceStateTracker& resourceStateTracker() { return m_resource_state_tracker; }    //! returns tracker of the states of the resources accessed by the command list
+
+    void flushResourceBarriers();    //! records the barriers required by the resource states requested from the tracker since the last flush
+
+    void finalizeResourceBarriers();    //! flushes the resource state tracker and completes the split barriers started by the command list
 
     void drawInstanced(uint32_t vertex_count_per_instance, uint32_t instance_count,
         uint32_t start_vertex_location, uint32_t start_instance_location) const;
@@ -123,7 +137,9 @@ public:
     void inputAssemblySetPrimitiveTopology(PrimitiveTopology primitive_topology) const;
 
     void inputAssemblySetVertexBuffers(VertexBufferBinding const& vb_binding);
+    void inputAssemblySetVertexBuffers(uint32_t start_slot, CommandStreamVertexBufferView const* p_views, uint32_t count);
     void inputAssemblySetIndexBuffer(IndexBufferBinding const& ib_binding);
+    void inputAssemblySetIndexBuffer(CommandStreamIndexBufferView const& view);
 
     void rasterizerStateSetViewports(misc::StaticVector<Viewport, c_maximal_viewport_count> const& viewports) const;
 
@@ -161,7 +177,7 @@ public:
 
     void setDescriptorHeaps(std::array<DescriptorHeap const*, 2> const& descriptor_heaps) const;
 
-    void setRootSignature(std::string const& cached_root_signature_friendly_name,
+    void setRootSignature(std::string_view cached_root_signature_friendly_name,
         BundleInvocationContext bundle_invokation_context = BundleInvocationContext::none) const;
 
     void setRootDescriptorTable(uint32_t root_signature_slot, uint64_t virtual_gpu_memory_address,
@@ -173,6 +189,9 @@ public:
     void setRoot32BitConstants(uint32_t root_signature_slot, std::vector<uint32_t> const& data, uint32_t offset_in_32_bit_values,
         BundleInvocationContext bundle_invokation_context = BundleInvocationContext::none) const;
 
+    void setRoot32BitConstants(uint32_t root_signature_slot, uint32_t const* p_data, uint32_t count, uint32_t offset_in_32_bit_values,
+        BundleInvocationContext bundle_invokation_context = BundleInvocationContext::none) const;
+
     void setRootConstantBufferView(uint32_t root_signature_slot, uint64_t gpu_virtual_address,
         BundleInvocationContext bundle_invokation_context = BundleInvocationContext::none) const;
 
@@ -197,6 +216,8 @@ public:
 
     Device& device() const;    //! returns reference for the device that created this command list
 
+    CommandListStateCache const& stateCache() const { return m_state_cache; }    //! returns shadow copy of the state bound to the command list, which is used to skip redundant binding calls
+
 public:
     CommandList(CommandList const&) = delete;
     CommandList(CommandList&&) = default;
@@ -208,12 +229,19 @@ private:
     void defineSignalingCommandList(CommandList& signaling_command_list);
     Signal* getJobCompletionSignalPtr();
 
+    void recordResourceBarriers(uint32_t num_barriers, TrackedResourceBarrier const* p_barriers) const;    //! records the barriers without reporting them to the tracker
+
+private:
+    class ResourceBarrierSink;
+
 private:
     CommandAllocatorRing m_allocator_ring;    //!< command allocator to which the command list belongs
     uint32_t m_node_mask;    //!< node mask determining on which node the command list resides
     ComPtr<ID3D12GraphicsCommandList> m_command_list;    //!< pointer to the native Direct3D12 command list interface
     Signal m_signal;    //!< signal, which fires when the batch, as part of which this command list is submitted for execution is completed
     PipelineState const* m_initial_pipeline_state;    //!< pointer to the pipeline state the command list was initialized with
+    mutable ResourceStateTracker m_resource_state_tracker;    //!< states of the resources as seen by the commands recorded into the list
+    mutable CommandListStateCache m_state_cache;    //!< state bound by the commands recorded into the list
 };
 
 
@@ -244,6 +272,12 @@ private:
     {
         return parent_command_list.getJobCompletionSignalPtr();
     }
+
+    //! records the transitions resolved against the registry of the resource states, which must not be reported back to the registry
+    static void recordPatchBarriers(CommandList& patch_command_list, std::vector<TrackedResourceBarrier> const& barriers)
+    {
+        patch_command_list.recordResourceBarriers(static_cast<uint32_t>(barriers.size()), barriers.data());
+    }
 };
 
 
@@ -0,0 +1,233 @@
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+#include "command_list_state_cache.h"
+
+using namespace lexgine::core;
+using namespace lexgine::core::dx::d3d12;
+
+namespace {
+
+bool areVertexBufferViewsEqual(CommandStreamVertexBufferView const& a, CommandStreamVertexBufferView const& b)
+{
+    return a.buffer_location == b.buffer_location && a.size_in_bytes == b.size_in_bytes && a.stride_in_bytes == b.stride_in_bytes;
+}
+
+bool areIndexBufferViewsEqual(CommandStreamIndexBufferView const& a, CommandStreamIndexBufferView const& b)
+{
+    return a.buffer_location == b.buffer_location && a.size_in_bytes == b.size_in_bytes && a.format == b.format;
+}
+
+uint64_t rangeMask(uint32_t offset, uint32_t count)
+{
+    uint64_t const mask = count >= 64U ? ~0ULL : (1ULL << count) - 1ULL;
+    return mask << offset;
+}
+
+}
+
+
+size_t StateCacheStatistics::totalIssuedCallCount() const
+{
+    return std::accumulate(issued_calls.begin(), issued_calls.end(), size_t{ 0U });
+}
+
+size_t StateCacheStatistics::totalFilteredCallCount() const
+{
+    return std::accumulate(filtered_calls.begin(), filtered_calls.end(), size_t{ 0U });
+}
+
+
+CommandListStateCache::CommandListStateCache()
+{
+    invalidate();
+    resetStatistics();
+}
+
+bool CommandListStateCache::setPipelineState(PipelineState const* p_pipeline_state)
+{
+    bool const is_redundant = m_p_pipeline_state == p_pipeline_state;
+    m_p_pipeline_state = p_pipeline_state;
+    return filter(StateCacheCallType::pipeline_state, is_redundant);
+}
+
+bool CommandListStateCache::setRootSignature(StateCacheBindPoint bind_point, void const* p_root_signature)
+{
+    BindPointState& bind_point_state = m_bind_points[static_cast<size_t>(bind_point)];
+    bool const is_redundant = bind_point_state.p_root_signature == p_root_signature;
+    if (!is_redundant)
+    {
+        // the arguments bound to the previous root signature are not retained
+        invalidateRootArguments(bind_point_state);
+        bind_point_state.p_root_signature = p_root_signature;
+    }
+    return filter(StateCacheCallType::root_signature, is_redundant);
+}
+
+bool CommandListStateCache::setDescriptorHeaps(DescriptorHeap const* p_cbv_srv_uav_heap, DescriptorHeap const* p_sampler_heap)
+{
+    bool const is_redundant = m_descriptor_heaps[0] == p_cbv_srv_uav_heap && m_descriptor_heaps[1] == p_sampler_heap;
+    if (!is_redundant)
+    {
+        // descriptor tables point into the heaps that were bound when the tables were set
+        for (auto& bind_point_state : m_bind_points)
+        {
+            for (uint32_t i = 0; i < c_maximal_root_parameter_count; ++i)
+            {
+                RootArgument& argument = bind_point_state.root_arguments[i];
+                if (argument.kind != RootArgumentKind::descriptor_table) continue;
+
+                argument.kind = RootArgumentKind::none;
+                bind_point_state.bound_mask &= ~(1ULL << i);
+            }
+        }
+        m_descriptor_heaps = { p_cbv_srv_uav_heap, p_sampler_heap };
+    }
+    return filter(StateCacheCallType::descriptor_heaps, is_redundant);
+}
+
+bool CommandListStateCache::setRootDescriptorTable(StateCacheBindPoint bind_point, uint32_t root_signature_slot, uint64_t gpu_descriptor_handle)
+{
+    return filter(StateCacheCallType::root_descriptor_table,
+        !setRootArgument(bind_point, root_signature_slot, RootArgumentKind::descriptor_table, gpu_descriptor_handle));
+}
+
+bool CommandListStateCache::setRoot32BitConstants(StateCacheBindPoint bind_point, uint32_t root_signature_slot,
+    uint32_t const* p_data, uint32_t count, uint32_t offset_in_32bit_values)
+{
+    assert(root_signature_slot < c_maximal_root_parameter_count && offset_in_32bit_values + count <= 64U);
+
+    BindPointState& bind_point_state = m_bind_points[static_cast<size_t>(bind_point)];
+    RootArgument& argument = bind_point_state.root_arguments[root_signature_slot];
+    if (argument.kind != RootArgumentKind::constants)
+    {
+        argument.kind = RootArgumentKind::constants;
+        argument.constants_mask = 0U;
+    }
+
+    uint64_t const mask = rangeMask(offset_in_32bit_values, count);
+    bool const is_redundant = (argument.constants_mask & mask) == mask
+        && std::equal(p_data, p_data + count, argument.constants.begin() + offset_in_32bit_values);
+    if (!is_redundant)
+    {
+        if (argument.constants.size() < offset_in_32bit_values + count) argument.constants.resize(offset_in_32bit_values + count);
+        std::copy(p_data, p_data + count, argument.constants.begin() + offset_in_32bit_values);
+        argument.constants_mask |= mask;
+
+        bind_point_state.bound_mask |= 1ULL << root_signature_slot;
+        bind_point_state.dirty_mask |= 1ULL << root_signature_slot;
+    }
+    return filter(StateCacheCallType::root_constants, is_redundant);
+}
+
+bool CommandListStateCache::setRootConstantBufferView(StateCacheBindPoint bind_point, uint32_t root_signature_slot, uint64_t gpu_virtual_address)
+{
+    return filter(StateCacheCallType::root_descriptor,
+        !setRootArgument(bind_point, root_signature_slot, RootArgumentKind::constant_buffer_view, gpu_virtual_address));
+}
+
+bool CommandListStateCache::setRootShaderResourceView(StateCacheBindPoint bind_point, uint32_t root_signature_slot, uint64_t gpu_virtual_address)
+{
+    return filter(StateCacheCallType::root_descriptor,
+        !setRootArgument(bind_point, root_signature_slot, RootArgumentKind::shader_resource_view, gpu_virtual_address));
+}
+
+bool CommandListStateCache::setRootUnorderedAccessView(StateCacheBindPoint bind_point, uint32_t root_signature_slot, uint64_t gpu_virtual_address)
+{
+    return filter(StateCacheCallType::root_descriptor,
+        !setRootArgument(bind_point, root_signature_slot, RootArgumentKind::unordered_access_view, gpu_virtual_address));
+}
+
+bool CommandListStateCache::setPrimitiveTopology(PrimitiveTopology primitive_topology)
+{
+    bool const is_redundant = m_primitive_topology != PrimitiveTopology::undefined && m_primitive_topology == primitive_topology;
+    m_primitive_topology = primitive_topology;
+    return filter(StateCacheCallType::primitive_topology, is_redundant);
+}
+
+bool CommandListStateCache::setVertexBuffers(uint32_t start_slot, CommandStreamVertexBufferView const* p_views, uint32_t count)
+{
+    assert(start_slot + count <= c_vertex_buffer_slot_count);
+
+    uint32_t const mask = static_cast<uint32_t>(rangeMask(start_slot, count));
+    bool is_redundant = (m_vertex_buffers_mask & mask) == mask;
+    for (uint32_t i = 0; i < count && is_redundant; ++i)
+    {
+        is_redundant = areVertexBufferViewsEqual(m_vertex_buffers[start_slot + i], p_views[i]);
+    }
+
+    if (!is_redundant)
+    {
+        std::copy(p_views, p_views + count, m_vertex_buffers.begin() + start_slot);
+        m_vertex_buffers_mask |= mask;
+    }
+    return filter(StateCacheCallType::vertex_buffers, is_redundant);
+}
+
+bool CommandListStateCache::setIndexBuffer(CommandStreamIndexBufferView const& view)
+{
+    bool const is_redundant = m_is_index_buffer_known && areIndexBufferViewsEqual(m_index_buffer, view);
+    m_index_buffer = view;
+    m_is_index_buffer_known = true;
+    return filter(StateCacheCallType::index_buffer, is_redundant);
+}
+
+uint64_t CommandListStateCache::commitRootParameters(StateCacheBindPoint bind_point)
+{
+    BindPointState& bind_point_state = m_bind_points[static_cast<size_t>(bind_point)];
+    uint64_t rv = bind_point_state.dirty_mask;
+    bind_point_state.dirty_mask = 0U;
+    return rv;
+}
+
+void CommandListStateCache::invalidate()
+{
+    m_p_pipeline_state = nullptr;
+    m_descriptor_heaps = { nullptr, nullptr };
+    for (auto& bind_point_state : m_bind_points)
+    {
+        bind_point_state.p_root_signature = nullptr;
+        invalidateRootArguments(bind_point_state);
+    }
+    m_primitive_topology = PrimitiveTopology::undefined;
+    m_vertex_buffers_mask = 0U;
+    m_is_index_buffer_known = false;
+}
+
+void CommandListStateCache::resetStatistics()
+{
+    m_statistics = StateCacheStatistics{ .issued_calls = {}, .filtered_calls = {} };
+}
+
+bool CommandListStateCache::filter(StateCacheCallType call_type, bool is_redundant)
+{
+    ++(is_redundant ? m_statistics.filtered_calls : m_statistics.issued_calls)[static_cast<size_t>(call_type)];
+    return !is_redundant;
+}
+
+bool CommandListStateCache::setRootArgument(StateCacheBindPoint bind_point, uint32_t root_signature_slot, RootArgumentKind kind, uint64_t value)
+{
+    assert(root_signature_slot < c_maximal_root_parameter_count);
+
+    BindPointState& bind_point_state = m_bind_points[static_cast<size_t>(bind_point)];
+    RootArgument& argument = bind_point_state.root_arguments[root_signature_slot];
+    if (argument.kind == kind && argument.value == value) return false;
+
+    argument.kind = kind;
+    argument.value = value;
+    bind_point_state.bound_mask |= 1ULL << root_signature_slot;
+    bind_point_state.dirty_mask |= 1ULL << root_signature_slot;
+    return true;
+}
+
+void CommandListStateCache::invalidateRootArguments(BindPointState& bind_point_state)
+{
+    for (auto& argument : bind_point_state.root_arguments)
+    {
+        argument.kind = RootArgumentKind::none;
+        argument.constants_mask = 0U;
+    }
+    bind_point_state.bound_mask = 0U;
+    bind_point_state.dirty_mask = 0U;
+}
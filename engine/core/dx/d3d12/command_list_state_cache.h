@@ -0,0 +1,134 @@
+#ifndef LEXGINE_CORE_DX_D3D12_COMMAND_LIST_STATE_CACHE_H
+#define LEXGINE_CORE_DX_D3D12_COMMAND_LIST_STATE_CACHE_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "engine/core/primitive_topology.h"
+
+#include "lexgine_core_dx_d3d12_fwd.h"
+#include "command_stream.h"
+
+namespace lexgine::core::dx::d3d12 {
+
+//! Pipeline, to which the root signature and the root arguments are bound
+enum class StateCacheBindPoint : uint8_t
+{
+    graphics,
+    compute
+};
+
+//! Kinds of the binding calls filtered by the state cache
+enum class StateCacheCallType : uint8_t
+{
+    pipeline_state,
+    root_signature,
+    descriptor_heaps,
+    root_descriptor_table,
+    root_constants,
+    root_descriptor,    //!< root constant buffer, shader resource or unordered access view
+    primitive_topology,
+    vertex_buffers,
+    index_buffer,
+
+    count
+};
+
+//! Counters of the binding calls seen by the state cache
+struct StateCacheStatistics final
+{
+    std::array<size_t, static_cast<size_t>(StateCacheCallType::count)> issued_calls;    //!< calls forwarded to the API
+    std::array<size_t, static_cast<size_t>(StateCacheCallType::count)> filtered_calls;    //!< calls skipped since they would not change the bound state
+
+    size_t totalIssuedCallCount() const;
+    size_t totalFilteredCallCount() const;
+};
+
+
+/*! Shadow copy of the state bound to a command list. Each binding routine of the cache returns 'true' if the call changes the
+ bound state and must be forwarded to the API, and 'false' if the call is redundant and can be skipped. Following the D3D12 rules,
+ changing the root signature of a bind point discards the root arguments of the bind point, and changing the descriptor heaps
+ discards the bound descriptor tables. A root parameter becomes dirty when its argument changes and remains dirty until the dirty
+ parameters of the bind point are committed, which normally happens at draw or dispatch.
+ The cache starts with the state unknown and must be invalidated whenever the state of the command list becomes undefined (e.g. on
+ reset)
+*/
+class CommandListStateCache final
+{
+public:
+    static constexpr uint32_t c_maximal_root_parameter_count = 64U;
+    static constexpr uint32_t c_vertex_buffer_slot_count = 16U;
+
+public:
+    CommandListStateCache();
+
+    bool setPipelineState(PipelineState const* p_pipeline_state);
+    bool setRootSignature(StateCacheBindPoint bind_point, void const* p_root_signature);    //! p_root_signature identifies the native root signature object
+    bool setDescriptorHeaps(DescriptorHeap const* p_cbv_srv_uav_heap, DescriptorHeap const* p_sampler_heap);
+    bool setRootDescriptorTable(StateCacheBindPoint bind_point, uint32_t root_signature_slot, uint64_t gpu_descriptor_handle);
+    bool setRoot32BitConstants(StateCacheBindPoint bind_point, uint32_t root_signature_slot,
+        uint32_t const* p_data, uint32_t count, uint32_t offset_in_32bit_values);
+    bool setRootConstantBufferView(StateCacheBindPoint bind_point, uint32_t root_signature_slot, uint64_t gpu_virtual_address);
+    bool setRootShaderResourceView(StateCacheBindPoint bind_point, uint32_t root_signature_slot, uint64_t gpu_virtual_address);
+    bool setRootUnorderedAccessView(StateCacheBindPoint bind_point, uint32_t root_signature_slot, uint64_t gpu_virtual_address);
+    bool setPrimitiveTopology(PrimitiveTopology primitive_topology);
+    bool setVertexBuffers(uint32_t start_slot, CommandStreamVertexBufferView const* p_views, uint32_t count);
+    bool setIndexBuffer(CommandStreamIndexBufferView const& view);
+
+    uint64_t boundRootParameters(StateCacheBindPoint bind_point) const { return m_bind_points[static_cast<size_t>(bind_point)].bound_mask; }    //! returns mask of the root parameters with known arguments
+    uint64_t dirtyRootParameters(StateCacheBindPoint bind_point) const { return m_bind_points[static_cast<size_t>(bind_point)].dirty_mask; }    //! returns mask of the root parameters changed since the last commit
+    uint64_t commitRootParameters(StateCacheBindPoint bind_point);    //! clears the dirty root parameters of the bind point and returns their mask
+
+    void invalidate();    //! forgets the bound state, so that the following binding calls are all issued
+
+    StateCacheStatistics const& statistics() const { return m_statistics; }
+    void resetStatistics();
+
+private:
+    enum class RootArgumentKind : uint8_t
+    {
+        none,
+        descriptor_table,
+        constants,
+        constant_buffer_view,
+        shader_resource_view,
+        unordered_access_view
+    };
+
+    struct RootArgument
+    {
+        RootArgumentKind kind;
+        uint64_t value;    //!< descriptor handle or GPU virtual address
+        std::vector<uint32_t> constants;
+        uint64_t constants_mask;    //!< mask of the 32-bit constants with known values
+    };
+
+    struct BindPointState
+    {
+        void const* p_root_signature;
+        std::array<RootArgument, c_maximal_root_parameter_count> root_arguments;
+        uint64_t bound_mask;
+        uint64_t dirty_mask;
+    };
+
+private:
+    bool filter(StateCacheCallType call_type, bool is_redundant);
+    bool setRootArgument(StateCacheBindPoint bind_point, uint32_t root_signature_slot, RootArgumentKind kind, uint64_t value);
+    void invalidateRootArguments(BindPointState& bind_point_state);
+
+private:
+    PipelineState const* m_p_pipeline_state;
+    std::array<DescriptorHeap const*, 2> m_descriptor_heaps;
+    std::array<BindPointState, 2> m_bind_points;
+    PrimitiveTopology m_primitive_topology;
+    std::array<CommandStreamVertexBufferView, c_vertex_buffer_slot_count> m_vertex_buffers;
+    uint32_t m_vertex_buffers_mask;    //!< mask of the vertex buffer slots with known views
+    CommandStreamIndexBufferView m_index_buffer;
+    bool m_is_index_buffer_known;
+    StateCacheStatistics m_statistics;
+};
+
+}
+
+#endif
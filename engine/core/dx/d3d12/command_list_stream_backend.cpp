@@ -0,0 +1,157 @@
+#include "command_list_stream_backend.h"
+#include "resource.h"
+
+using namespace lexgine::core;
+using namespace lexgine::core::dx::d3d12;
+
+
+// the stream stores the viewports, rectangles and descriptor handles in the layouts of their native counterparts,
+// so that they can be passed to the API as is
+static_assert(sizeof(CommandStreamViewport) == sizeof(D3D12_VIEWPORT));
+static_assert(sizeof(CommandStreamRectangle) == sizeof(D3D12_RECT));
+static_assert(sizeof(uint64_t) == sizeof(D3D12_CPU_DESCRIPTOR_HANDLE));
+static_assert(static_cast<uint32_t>(CommandStreamDSVClearFlags::clear_depth) == D3D12_CLEAR_FLAG_DEPTH
+    && static_cast<uint32_t>(CommandStreamDSVClearFlags::clear_stencil) == D3D12_CLEAR_FLAG_STENCIL);
+
+
+CommandListStreamBackend::CommandListStreamBackend(CommandList& target_command_list,
+    BundleInvocationContext bundle_invocation_context)
+    : m_target_command_list{ target_command_list }
+    , m_bundle_invocation_context{ bundle_invocation_context }
+{
+
+}
+
+void CommandListStreamBackend::setPipelineState(PipelineState const* p_pipeline_state)
+{
+    m_target_command_list.setPipelineState(*p_pipeline_state);
+}
+
+void CommandListStreamBackend::setRootSignature(std::string_view cached_root_signature_friendly_name)
+{
+    m_target_command_list.setRootSignature(cached_root_signature_friendly_name, m_bundle_invocation_context);
+}
+
+void CommandListStreamBackend::setDescriptorHeaps(DescriptorHeap const* p_cbv_srv_uav_heap, DescriptorHeap const* p_sampler_heap)
+{
+    m_target_command_list.setDescriptorHeaps({ p_cbv_srv_uav_heap, p_sampler_heap });
+}
+
+void CommandListStreamBackend::setRootDescriptorTable(uint32_t root_signature_slot, uint64_t gpu_descriptor_handle)
+{
+    m_target_command_list.setRootDescriptorTable(root_signature_slot, gpu_descriptor_handle, m_bundle_invocation_context);
+}
+
+void CommandListStreamBackend::setRoot32BitConstants(uint32_t root_signature_slot, uint32_t const* p_data,
+    uint32_t count, uint32_t offset_in_32bit_values)
+{
+    m_target_command_list.setRoot32BitConstants(root_signature_slot, p_data, count, offset_in_32bit_values, m_bundle_invocation_context);
+}
+
+void CommandListStreamBackend::setRootConstantBufferView(uint32_t root_signature_slot, uint64_t gpu_virtual_address)
+{
+    m_target_command_list.setRootConstantBufferView(root_signature_slot, gpu_virtual_address, m_bundle_invocation_context);
+}
+
+void CommandListStreamBackend::setRootShaderResourceView(uint32_t root_signature_slot, uint64_t gpu_virtual_address)
+{
+    m_target_command_list.setRootShaderResourceView(root_signature_slot, gpu_virtual_address, m_bundle_invocation_context);
+}
+
+void CommandListStreamBackend::setRootUnorderedAccessView(uint32_t root_signature_slot, uint64_t gpu_virtual_address)
+{
+    m_target_command_list.setRootUnorderedAccessView(root_signature_slot, gpu_virtual_address, m_bundle_invocation_context);
+}
+
+void CommandListStreamBackend::setPrimitiveTopology(PrimitiveTopology primitive_topology)
+{
+    m_target_command_list.inputAssemblySetPrimitiveTopology(primitive_topology);
+}
+
+void CommandListStreamBackend::setVertexBuffers(uint32_t start_slot, CommandStreamVertexBufferView const* p_views, uint32_t count)
+{
+    m_target_command_list.inputAssemblySetVertexBuffers(start_slot, p_views, count);
+}
+
+void CommandListStreamBackend::setIndexBuffer(CommandStreamIndexBufferView const& view)
+{
+    m_target_command_list.inputAssemblySetIndexBuffer(view);
+}
+
+void CommandListStreamBackend::setViewports(CommandStreamViewport const* p_viewports, uint32_t count)
+{
+    m_target_command_list.native()->RSSetViewports(static_cast<UINT>(count), reinterpret_cast<D3D12_VIEWPORT const*>(p_viewports));
+}
+
+void CommandListStreamBackend::setScissorRectangles(CommandStreamRectangle const* p_rectangles, uint32_t count)
+{
+    m_target_command_list.native()->RSSetScissorRects(static_cast<UINT>(count), reinterpret_cast<D3D12_RECT const*>(p_rectangles));
+}
+
+void CommandListStreamBackend::setBlendFactor(std::array<float, 4> const& blend_factor)
+{
+    m_target_command_list.native()->OMSetBlendFactor(blend_factor.data());
+}
+
+void CommandListStreamBackend::setStencilReference(uint32_t reference_value)
+{
+    m_target_command_list.outputMergerSetStencilReference(reference_value);
+}
+
+void CommandListStreamBackend::setRenderTargets(uint64_t const* p_rtv_handles, uint32_t rtv_count, uint64_t dsv_handle)
+{
+    D3D12_CPU_DESCRIPTOR_HANDLE dsv_cpu_handle{ static_cast<SIZE_T>(dsv_handle) };
+    m_target_command_list.native()->OMSetRenderTargets(static_cast<UINT>(rtv_count),
+        rtv_count ? reinterpret_cast<D3D12_CPU_DESCRIPTOR_HANDLE const*>(p_rtv_handles) : NULL,
+        FALSE, dsv_handle ? &dsv_cpu_handle : NULL);
+}
+
+void CommandListStreamBackend::clearRenderTargetView(uint64_t rtv_handle, std::array<float, 4> const& rgba_clear_value,
+    CommandStreamRectangle const* p_rectangles, uint32_t rectangle_count)
+{
+    m_target_command_list.native()->ClearRenderTargetView(D3D12_CPU_DESCRIPTOR_HANDLE{ static_cast<SIZE_T>(rtv_handle) },
+        rgba_clear_value.data(), static_cast<UINT>(rectangle_count),
+        rectangle_count ? reinterpret_cast<D3D12_RECT const*>(p_rectangles) : NULL);
+}
+
+void CommandListStreamBackend::clearDepthStencilView(uint64_t dsv_handle, CommandStreamDSVClearFlags clear_flags,
+    float depth_clear_value, uint8_t stencil_clear_value, CommandStreamRectangle const* p_rectangles, uint32_t rectangle_count)
+{
+    m_target_command_list.native()->ClearDepthStencilView(D3D12_CPU_DESCRIPTOR_HANDLE{ static_cast<SIZE_T>(dsv_handle) },
+        static_cast<D3D12_CLEAR_FLAGS>(clear_flags), depth_clear_value, stencil_clear_value, static_cast<UINT>(rectangle_count),
+        rectangle_count ? reinterpret_cast<D3D12_RECT const*>(p_rectangles) : NULL);
+}
+
+void CommandListStreamBackend::resourceBarriers(TrackedResourceBarrier const* p_barriers, uint32_t count)
+{
+    m_target_command_list.resourceBarrier(count, p_barriers);
+}
+
+void CommandListStreamBackend::drawInstanced(uint32_t vertex_count_per_instance, uint32_t instance_count,
+    uint32_t start_vertex_location, uint32_t start_instance_location)
+{
+    m_target_command_list.drawInstanced(vertex_count_per_instance, instance_count, start_vertex_location, start_instance_location);
+}
+
+void CommandListStreamBackend::drawIndexedInstanced(uint32_t index_count_per_instance, uint32_t instance_count,
+    uint32_t start_index_location, int32_t base_vertex_location, uint32_t start_instance_location)
+{
+    m_target_command_list.native()->DrawIndexedInstanced(static_cast<UINT>(index_count_per_instance), static_cast<UINT>(instance_count),
+        static_cast<UINT>(start_index_location), static_cast<INT>(base_vertex_location), static_cast<UINT>(start_instance_location));
+}
+
+void CommandListStreamBackend::dispatch(uint32_t thread_group_x, uint32_t thread_group_y, uint32_t thread_group_z)
+{
+    m_target_command_list.dispatch(thread_group_x, thread_group_y, thread_group_z);
+}
+
+void CommandListStreamBackend::copyBufferRegion(Resource const* p_dst_buffer, uint64_t dst_buffer_offset,
+    Resource const* p_src_buffer, uint64_t src_buffer_offset, uint64_t num_bytes)
+{
+    m_target_command_list.copyBufferRegion(*p_dst_buffer, dst_buffer_offset, *p_src_buffer, src_buffer_offset, num_bytes);
+}
+
+void CommandListStreamBackend::copyResource(Resource const* p_dst_resource, Resource const* p_src_resource)
+{
+    m_target_command_list.copyResource(*p_dst_resource, *p_src_resource);
+}
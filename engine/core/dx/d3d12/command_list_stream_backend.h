@@ -0,0 +1,56 @@
+#ifndef LEXGINE_CORE_DX_D3D12_COMMAND_LIST_STREAM_BACKEND_H
+#define LEXGINE_CORE_DX_D3D12_COMMAND_LIST_STREAM_BACKEND_H
+
+#include "command_list.h"
+#include "command_stream.h"
+
+namespace lexgine::core::dx::d3d12 {
+
+/*! Translates the commands replayed from a command stream into the native D3D12 command list. The command list must be
+ open for recording during the replay
+*/
+class CommandListStreamBackend final : public AbstractCommandStreamBackend
+{
+public:
+    CommandListStreamBackend(CommandList& target_command_list,
+        BundleInvocationContext bundle_invocation_context = BundleInvocationContext::none);
+
+    // AbstractCommandStreamBackend interface
+    void setPipelineState(PipelineState const* p_pipeline_state) override;
+    void setRootSignature(std::string_view cached_root_signature_friendly_name) override;
+    void setDescriptorHeaps(DescriptorHeap const* p_cbv_srv_uav_heap, DescriptorHeap const* p_sampler_heap) override;
+    void setRootDescriptorTable(uint32_t root_signature_slot, uint64_t gpu_descriptor_handle) override;
+    void setRoot32BitConstants(uint32_t root_signature_slot, uint32_t const* p_data, uint32_t count, uint32_t offset_in_32bit_values) override;
+    void setRootConstantBufferView(uint32_t root_signature_slot, uint64_t gpu_virtual_address) override;
+    void setRootShaderResourceView(uint32_t root_signature_slot, uint64_t gpu_virtual_address) override;
+    void setRootUnorderedAccessView(uint32_t root_signature_slot, uint64_t gpu_virtual_address) override;
+    void setPrimitiveTopology(PrimitiveTopology primitive_topology) override;
+    void setVertexBuffers(uint32_t start_slot, CommandStreamVertexBufferView const* p_views, uint32_t count) override;
+    void setIndexBuffer(CommandStreamIndexBufferView const& view) override;
+    void setViewports(CommandStreamViewport const* p_viewports, uint32_t count) override;
+    void setScissorRectangles(CommandStreamRectangle const* p_rectangles, uint32_t count) override;
+    void setBlendFactor(std::array<float, 4> const& blend_factor) override;
+    void setStencilReference(uint32_t reference_value) override;
+    void setRenderTargets(uint64_t const* p_rtv_handles, uint32_t rtv_count, uint64_t dsv_handle) override;
+    void clearRenderTargetView(uint64_t rtv_handle, std::array<float, 4> const& rgba_clear_value,
+        CommandStreamRectangle const* p_rectangles, uint32_t rectangle_count) override;
+    void clearDepthStencilView(uint64_t dsv_handle, CommandStreamDSVClearFlags clear_flags, float depth_clear_value, uint8_t stencil_clear_value,
+        CommandStreamRectangle const* p_rectangles, uint32_t rectangle_count) override;
+    void resourceBarriers(TrackedResourceBarrier const* p_barriers, uint32_t count) override;
+    void drawInstanced(uint32_t vertex_count_per_instance, uint32_t instance_count,
+        uint32_t start_vertex_location, uint32_t start_instance_location) override;
+    void drawIndexedInstanced(uint32_t index_count_per_instance, uint32_t instance_count,
+        uint32_t start_index_location, int32_t base_vertex_location, uint32_t start_instance_location) override;
+    void dispatch(uint32_t thread_group_x, uint32_t thread_group_y, uint32_t thread_group_z) override;
+    void copyBufferRegion(Resource const* p_dst_buffer, uint64_t dst_buffer_offset,
+        Resource const* p_src_buffer, uint64_t src_buffer_offset, uint64_t num_bytes) override;
+    void copyResource(Resource const* p_dst_resource, Resource const* p_src_resource) override;
+
+private:
+    CommandList& m_target_command_list;
+    BundleInvocationContext m_bundle_invocation_context;
+};
+
+}
+
+#endif
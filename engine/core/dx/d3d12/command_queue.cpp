@@ -1,22 +1,49 @@
 #include "command_queue.h"
 #include "device.h"
 #include "command_list.h"
+#include "resource_state_tracker.h"
 
 #include "engine/core/exception.h"
 #include "engine/core/misc/misc.h"
 
-#include <functional>
+#include <algorithm>
+#include <iterator>
+#include <mutex>
 
 using namespace lexgine::core::dx::d3d12;
 using namespace lexgine::core::misc;
 
 
+namespace {
+
+void submitCommandLists(ID3D12CommandQueue* p_command_queue, std::vector<CommandList*> const& command_lists)
+{
+    if (command_lists.empty()) return;
+
+    std::vector<ID3D12CommandList*> native_command_lists(command_lists.size());
+    std::transform(command_lists.begin(), command_lists.end(), native_command_lists.begin(),
+        [](CommandList* p_command_list) { return p_command_list->native().Get(); });
+    p_command_queue->ExecuteCommandLists(static_cast<UINT>(native_command_lists.size()), native_command_lists.data());
+}
+
+}
+
+
+struct CommandQueue::PatchCommandLists
+{
+    std::mutex submission_mutex;    //!< serializes resolution of the resource states with the submission, so that the registry follows the order of execution
+    std::mutex pool_mutex;    //!< guards the pool of the idle patch lists
+    std::vector<std::unique_ptr<CommandList>> idle_command_lists;    //!< closed patch lists that are ready to be reset
+};
+
+
 CommandQueue::CommandQueue(Device& device, WorkloadType type, uint32_t node_mask, CommandQueuePriority priority, CommandQueueFlags flags) :
     m_type{ type },
     m_priority{ priority },
     m_flags{ flags },
     m_node_mask{ node_mask },
-    m_device{ device }
+    m_device{ device },
+    m_patch_command_lists{ std::make_unique<PatchCommandLists>() }
 {
     D3D12_COMMAND_QUEUE_DESC desc;
     desc.Type = static_cast<D3D12_COMMAND_LIST_TYPE>(type);
@@ -31,33 +58,122 @@ CommandQueue::CommandQueue(Device& device, WorkloadType type, uint32_t node_mask
     );
 }
 
+CommandQueue::~CommandQueue() = default;
+
 void CommandQueue::executeCommandLists(CommandList** command_list_array, size_t num_command_lists) const
 {
     // only the last command list in the batch signals job completion to avoid redundancy
-    auto* last_command_list_ptr = command_list_array[num_command_lists - 1];
+    CommandList* last_command_list_ptr = command_list_array[num_command_lists - 1];
 
-    std::vector<ID3D12CommandList*> native_command_lists(num_command_lists);
-    for (size_t i = 0U; i < num_command_lists; ++i)
+    size_t const tracked_command_list_count = static_cast<size_t>(std::count_if(command_list_array, command_list_array + num_command_lists,
+        [](CommandList* p_command_list) { return !p_command_list->resourceStateTracker().isEmpty(); }));
+    if (!tracked_command_list_count)
     {
-        CommandListAttorney<CommandQueue>::defineSignalingCommandListForTargetCommandList(*command_list_array[i], *last_command_list_ptr);
-        native_command_lists[i] = command_list_array[i]->native().Get();
+        // the lists neither depend on nor affect the registry of the resource states, hence no patches are needed
+        std::vector<CommandList*> submitted_command_lists{ command_list_array, command_list_array + num_command_lists };
+        for (CommandList* p_command_list : submitted_command_lists)
+            CommandListAttorney<CommandQueue>::defineSignalingCommandListForTargetCommandList(*p_command_list, *last_command_list_ptr);
+        submitCommandLists(m_command_queue.Get(), submitted_command_lists);
+        CommandListAttorney<CommandQueue>::getJobCompletionSignalPtrForCommandList(*last_command_list_ptr)->signalFromGPU(*this);
+        return;
     }
 
-    m_command_queue->ExecuteCommandLists(static_cast<UINT>(num_command_lists), native_command_lists.data());
+    // the patch lists are reset before the submission is locked, since the allocator ring of a patch list
+    // may have to wait until the GPU releases the allocator
+    std::vector<std::unique_ptr<CommandList>> patch_command_lists = acquirePatchCommandLists(tracked_command_list_count);
+    for (auto& patch_command_list : patch_command_lists) patch_command_list->reset();
+
+    {
+        std::lock_guard<std::mutex> lock{ m_patch_command_lists->submission_mutex };
+
+        // copy and compute queues do not support most of the transitions, so that their patches are executed on the default queue,
+        // which is direct, and this queue waits for the patch before it proceeds with the patched command list
+        bool const are_patches_executed_on_this_queue = m_type == WorkloadType::direct;
+        CommandQueue const& patching_queue = are_patches_executed_on_this_queue ? *this : m_device.defaultCommandQueue();
+
+        // the transitions into the initial states required by a command list are recorded into a patch list preceding it
+        ResourceStateRegistry& resource_state_registry = m_device.resourceStateRegistry();
+        std::vector<CommandList*> submitted_command_lists;
+        submitted_command_lists.reserve(num_command_lists + patch_command_lists.size());
+        size_t used_patch_command_list_count{ 0U };
+        for (size_t i = 0U; i < num_command_lists; ++i)
+        {
+            CommandList& command_list = *command_list_array[i];
+            CommandListAttorney<CommandQueue>::defineSignalingCommandListForTargetCommandList(command_list, *last_command_list_ptr);
+
+            std::vector<TrackedResourceBarrier> patch_barriers = command_list.resourceStateTracker().isEmpty()
+                ? std::vector<TrackedResourceBarrier>{}
+                : resource_state_registry.resolve(command_list.resourceStateTracker());
+            if (!patch_barriers.empty())
+            {
+                CommandList& patch_command_list = *patch_command_lists[used_patch_command_list_count++];
+                CommandListAttorney<CommandQueue>::recordPatchBarriers(patch_command_list, patch_barriers);
+                patch_command_list.close();
+
+                if (are_patches_executed_on_this_queue)
+                {
+                    CommandListAttorney<CommandQueue>::defineSignalingCommandListForTargetCommandList(patch_command_list, *last_command_list_ptr);
+                    submitted_command_lists.push_back(&patch_command_list);
+                }
+                else
+                {
+                    // the lists preceding the patch are submitted first, so that the wait for the patch does not hold them back
+                    submitCommandLists(m_command_queue.Get(), submitted_command_lists);
+                    submitted_command_lists.clear();
+
+                    CommandListAttorney<CommandQueue>::defineSignalingCommandListForTargetCommandList(patch_command_list, patch_command_list);
+                    submitCommandLists(patching_queue.native().Get(), { &patch_command_list });
+                    Signal* patch_completion_signal_ptr = CommandListAttorney<CommandQueue>::getJobCompletionSignalPtrForCommandList(patch_command_list);
+                    patch_completion_signal_ptr->signalFromGPU(patching_queue);
+                    patch_completion_signal_ptr->waitOnGPUQueue(*this, patch_completion_signal_ptr->lastValueRecorded());
+                }
+            }
+            submitted_command_lists.push_back(&command_list);
+        }
+
+        submitCommandLists(m_command_queue.Get(), submitted_command_lists);
+        CommandListAttorney<CommandQueue>::getJobCompletionSignalPtrForCommandList(*last_command_list_ptr)->signalFromGPU(*this);    // signal job completion
+
+        // the patch lists that turned out to be unneeded are closed, so that they can be reset again when reused
+        for (size_t i = used_patch_command_list_count; i < patch_command_lists.size(); ++i)
+            patch_command_lists[i]->close();
+    }
 
-    Signal* job_completion_signal_ptr = CommandListAttorney<CommandQueue>::getJobCompletionSignalPtrForCommandList(*last_command_list_ptr);
-    job_completion_signal_ptr->signalFromGPU(*this);    // signal job completion
+    releasePatchCommandLists(std::move(patch_command_lists));
 }
 
-void CommandQueue::executeCommandList(CommandList& command_list) const
+std::vector<std::unique_ptr<CommandList>> CommandQueue::acquirePatchCommandLists(size_t count) const
 {
-    CommandListAttorney<CommandQueue>::defineSignalingCommandListForTargetCommandList(command_list, command_list);
+    std::vector<std::unique_ptr<CommandList>> patch_command_lists;
+    patch_command_lists.reserve(count);
 
-    ID3D12CommandList* native_command_list = command_list.native().Get();
-    m_command_queue->ExecuteCommandLists(1U, &native_command_list);
+    {
+        std::lock_guard<std::mutex> lock{ m_patch_command_lists->pool_mutex };
+        std::vector<std::unique_ptr<CommandList>>& idle_command_lists = m_patch_command_lists->idle_command_lists;
+        while (patch_command_lists.size() < count && !idle_command_lists.empty())
+        {
+            patch_command_lists.push_back(std::move(idle_command_lists.back()));
+            idle_command_lists.pop_back();
+        }
+    }
+
+    // the newly created lists are closed as the pooled ones are
+    while (patch_command_lists.size() < count)
+        patch_command_lists.push_back(std::make_unique<CommandList>(m_device.createCommandList(CommandType::direct, m_node_mask)));
 
-    Signal* job_completion_signal_ptr = CommandListAttorney<CommandQueue>::getJobCompletionSignalPtrForCommandList(command_list);
-    job_completion_signal_ptr->signalFromGPU(*this);    // signal job completion
+    return patch_command_lists;
+}
+
+void CommandQueue::releasePatchCommandLists(std::vector<std::unique_ptr<CommandList>>&& patch_command_lists) const
+{
+    std::lock_guard<std::mutex> lock{ m_patch_command_lists->pool_mutex };
+    std::move(patch_command_lists.begin(), patch_command_lists.end(), std::back_inserter(m_patch_command_lists->idle_command_lists));
+}
+
+void CommandQueue::executeCommandList(CommandList& command_list) const
+{
+    CommandList* command_list_ptr = &command_list;
+    executeCommandLists(&command_list_ptr, 1U);
 }
 
 Device& CommandQueue::device() const
@@ -4,6 +4,7 @@
 #include <wrl.h>
 #include <d3d12.h>
 
+#include <memory>
 #include <vector>
 
 #include "lexgine_core_dx_d3d12_fwd.h"
@@ -50,7 +51,11 @@ class CommandQueue final : public NamedEntity<class_names::D3D12_CommandQueue>
 
 public:
 
-    void executeCommandLists(CommandList** command_list_array, size_t num_command_lists) const;   //! sends set of command lists into the command queue for execution
+    /*! sends set of command lists into the command queue for execution. The initial resource states required by each list are resolved
+     against the resource state registry of the device, and the transitions into these states are submitted right ahead of the list.
+     The transitions required by the lists executed on copy and compute queues are submitted to the default queue, which the list then waits for
+    */
+    void executeCommandLists(CommandList** command_list_array, size_t num_command_lists) const;
 
     void executeCommandList(CommandList& command_list) const;    //! executes the command list on this command queue
 
@@ -80,6 +85,14 @@ public:
 
     CommandQueue(CommandQueue const&) = delete;
     CommandQueue(CommandQueue&&) = default;
+    ~CommandQueue();
+
+private:
+    struct PatchCommandLists;
+
+private:
+    std::vector<std::unique_ptr<CommandList>> acquirePatchCommandLists(size_t count) const;    //! takes closed direct command lists from the pool of the patch lists
+    void releasePatchCommandLists(std::vector<std::unique_ptr<CommandList>>&& patch_command_lists) const;    //! returns closed patch lists back into the pool
 
 private:
     CommandQueue(Device& device,
@@ -95,6 +108,7 @@ private:
     CommandQueueFlags m_flags;    //!< flags specified during creation of the command queue
     uint32_t m_node_mask;    //!< node mask determining the physical node to which the command queue is assigned
     Device& m_device;    //!< Direct3D12 device that has created the command queue
+    std::unique_ptr<PatchCommandLists> m_patch_command_lists;    //!< command lists recording the transitions submitted ahead of the executed lists
 };
 
 
@@ -0,0 +1,723 @@
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <numeric>
+#include <type_traits>
+
+#include "command_stream.h"
+
+using namespace lexgine::core;
+using namespace lexgine::core::dx::d3d12;
+
+namespace {
+
+constexpr size_t c_command_alignment = 8U;
+
+constexpr size_t alignCommandSize(size_t size)
+{
+    return (size + c_command_alignment - 1) & ~(c_command_alignment - 1);
+}
+
+//! Header preceding the arguments of each command in the stream
+struct CommandHeader
+{
+    CommandStreamCommandType type;
+    uint32_t size;    //!< total size of the command including the header, its arguments and the payload
+};
+static_assert(sizeof(CommandHeader) <= c_command_alignment);
+
+
+struct PipelineStateArguments
+{
+    PipelineState const* p_pipeline_state;
+};
+
+struct RootSignatureArguments
+{
+    uint32_t name_length;    //!< the name characters follow the arguments
+};
+
+struct DescriptorHeapsArguments
+{
+    DescriptorHeap const* p_cbv_srv_uav_heap;
+    DescriptorHeap const* p_sampler_heap;
+};
+
+struct RootParameterArguments
+{
+    uint64_t value;    //!< GPU descriptor handle of the table or virtual address of the root descriptor
+    uint32_t root_signature_slot;
+};
+
+struct Root32BitConstantsArguments
+{
+    uint32_t root_signature_slot;
+    uint32_t count;    //!< the constants follow the arguments
+    uint32_t offset_in_32bit_values;
+};
+
+struct PrimitiveTopologyArguments
+{
+    PrimitiveTopology primitive_topology;
+};
+
+struct VertexBuffersArguments
+{
+    uint32_t start_slot;
+    uint32_t count;    //!< the views follow the arguments
+};
+
+//! Arguments of the commands, which only carry an array payload
+struct ArrayArguments
+{
+    uint32_t count;
+};
+
+struct BlendFactorArguments
+{
+    std::array<float, 4> blend_factor;
+};
+
+struct StencilReferenceArguments
+{
+    uint32_t reference_value;
+};
+
+struct RenderTargetsArguments
+{
+    uint64_t dsv_handle;
+    uint32_t rtv_count;    //!< the render target view handles follow the arguments
+};
+
+struct ClearRenderTargetViewArguments
+{
+    uint64_t rtv_handle;
+    std::array<float, 4> rgba_clear_value;
+    uint32_t rectangle_count;    //!< the clear rectangles follow the arguments
+};
+
+struct ClearDepthStencilViewArguments
+{
+    uint64_t dsv_handle;
+    CommandStreamDSVClearFlags clear_flags;
+    float depth_clear_value;
+    uint8_t stencil_clear_value;
+    uint32_t rectangle_count;    //!< the clear rectangles follow the arguments
+};
+
+struct DrawInstancedArguments
+{
+    uint32_t vertex_count_per_instance;
+    uint32_t instance_count;
+    uint32_t start_vertex_location;
+    uint32_t start_instance_location;
+};
+
+struct DrawIndexedInstancedArguments
+{
+    uint32_t index_count_per_instance;
+    uint32_t instance_count;
+    uint32_t start_index_location;
+    int32_t base_vertex_location;
+    uint32_t start_instance_location;
+};
+
+struct DispatchArguments
+{
+    uint32_t thread_group_x;
+    uint32_t thread_group_y;
+    uint32_t thread_group_z;
+};
+
+struct CopyBufferRegionArguments
+{
+    Resource const* p_dst_buffer;
+    Resource const* p_src_buffer;
+    uint64_t dst_buffer_offset;
+    uint64_t src_buffer_offset;
+    uint64_t num_bytes;
+};
+
+struct CopyResourceArguments
+{
+    Resource const* p_dst_resource;
+    Resource const* p_src_resource;
+};
+
+
+template<typename T>
+T readArguments(uint8_t const* p_command)
+{
+    T rv;
+    std::memcpy(&rv, p_command + c_command_alignment, sizeof(T));
+    return rv;
+}
+
+template<typename T, typename P>
+P const* payload(uint8_t const* p_command)
+{
+    return reinterpret_cast<P const*>(p_command + c_command_alignment + alignCommandSize(sizeof(T)));
+}
+
+}
+
+
+CommandStream::CommandStream(size_t chunk_size)
+    : m_chunk_size{ chunk_size }
+    , m_current_chunk{ 0U }
+    , m_command_count{ 0U }
+{
+    assert(chunk_size > 0);
+}
+
+void CommandStream::setPipelineState(PipelineState const& pipeline_state)
+{
+    record(CommandStreamCommandType::set_pipeline_state, PipelineStateArguments{ .p_pipeline_state = &pipeline_state });
+}
+
+void CommandStream::setRootSignature(std::string_view cached_root_signature_friendly_name)
+{
+    record(CommandStreamCommandType::set_root_signature,
+        RootSignatureArguments{ .name_length = static_cast<uint32_t>(cached_root_signature_friendly_name.size()) },
+        cached_root_signature_friendly_name.data(), cached_root_signature_friendly_name.size());
+}
+
+void CommandStream::setDescriptorHeaps(DescriptorHeap const& cbv_srv_uav_heap, DescriptorHeap const& sampler_heap)
+{
+    record(CommandStreamCommandType::set_descriptor_heaps,
+        DescriptorHeapsArguments{ .p_cbv_srv_uav_heap = &cbv_srv_uav_heap, .p_sampler_heap = &sampler_heap });
+}
+
+void CommandStream::setRootDescriptorTable(uint32_t root_signature_slot, uint64_t gpu_descriptor_handle)
+{
+    record(CommandStreamCommandType::set_root_descriptor_table,
+        RootParameterArguments{ .value = gpu_descriptor_handle, .root_signature_slot = root_signature_slot });
+}
+
+void CommandStream::setRoot32BitConstant(uint32_t root_signature_slot, uint32_t data, uint32_t offset_in_32bit_values)
+{
+    record(CommandStreamCommandType::set_root_32bit_constants,
+        Root32BitConstantsArguments{ .root_signature_slot = root_signature_slot, .count = 1U, .offset_in_32bit_values = offset_in_32bit_values },
+        &data, sizeof(uint32_t));
+}
+
+void CommandStream::setRoot32BitConstants(uint32_t root_signature_slot, std::vector<uint32_t> const& data, uint32_t offset_in_32bit_values)
+{
+    record(CommandStreamCommandType::set_root_32bit_constants,
+        Root32BitConstantsArguments{ .root_signature_slot = root_signature_slot,
+            .count = static_cast<uint32_t>(data.size()), .offset_in_32bit_values = offset_in_32bit_values },
+        data.data(), data.size() * sizeof(uint32_t));
+}
+
+void CommandStream::setRootConstantBufferView(uint32_t root_signature_slot, uint64_t gpu_virtual_address)
+{
+    record(CommandStreamCommandType::set_root_constant_buffer_view,
+        RootParameterArguments{ .value = gpu_virtual_address, .root_signature_slot = root_signature_slot });
+}
+
+void CommandStream::setRootShaderResourceView(uint32_t root_signature_slot, uint64_t gpu_virtual_address)
+{
+    record(CommandStreamCommandType::set_root_shader_resource_view,
+        RootParameterArguments{ .value = gpu_virtual_address, .root_signature_slot = root_signature_slot });
+}
+
+void CommandStream::setRootUnorderedAccessView(uint32_t root_signature_slot, uint64_t gpu_virtual_address)
+{
+    record(CommandStreamCommandType::set_root_unordered_access_view,
+        RootParameterArguments{ .value = gpu_virtual_address, .root_signature_slot = root_signature_slot });
+}
+
+void CommandStream::setPrimitiveTopology(PrimitiveTopology primitive_topology)
+{
+    record(CommandStreamCommandType::set_primitive_topology, PrimitiveTopologyArguments{ .primitive_topology = primitive_topology });
+}
+
+void CommandStream::setVertexBuffers(uint32_t start_slot, std::vector<CommandStreamVertexBufferView> const& views)
+{
+    setVertexBuffers(start_slot, views.data(), static_cast<uint32_t>(views.size()));
+}
+
+void CommandStream::setVertexBuffers(uint32_t start_slot, CommandStreamVertexBufferView const* p_views, uint32_t count)
+{
+    record(CommandStreamCommandType::set_vertex_buffers,
+        VertexBuffersArguments{ .start_slot = start_slot, .count = count },
+        p_views, count * sizeof(CommandStreamVertexBufferView));
+}
+
+void CommandStream::setIndexBuffer(CommandStreamIndexBufferView const& view)
+{
+    record(CommandStreamCommandType::set_index_buffer, view);
+}
+
+void CommandStream::setViewports(std::vector<CommandStreamViewport> const& viewports)
+{
+    record(CommandStreamCommandType::set_viewports, ArrayArguments{ .count = static_cast<uint32_t>(viewports.size()) },
+        viewports.data(), viewports.size() * sizeof(CommandStreamViewport));
+}
+
+void CommandStream::setScissorRectangles(std::vector<CommandStreamRectangle> const& rectangles)
+{
+    record(CommandStreamCommandType::set_scissor_rectangles, ArrayArguments{ .count = static_cast<uint32_t>(rectangles.size()) },
+        rectangles.data(), rectangles.size() * sizeof(CommandStreamRectangle));
+}
+
+void CommandStream::setBlendFactor(std::array<float, 4> const& blend_factor)
+{
+    record(CommandStreamCommandType::set_blend_factor, BlendFactorArguments{ .blend_factor = blend_factor });
+}
+
+void CommandStream::setStencilReference(uint32_t reference_value)
+{
+    record(CommandStreamCommandType::set_stencil_reference, StencilReferenceArguments{ .reference_value = reference_value });
+}
+
+void CommandStream::setRenderTargets(std::vector<uint64_t> const& rtv_handles, uint64_t dsv_handle)
+{
+    record(CommandStreamCommandType::set_render_targets,
+        RenderTargetsArguments{ .dsv_handle = dsv_handle, .rtv_count = static_cast<uint32_t>(rtv_handles.size()) },
+        rtv_handles.data(), rtv_handles.size() * sizeof(uint64_t));
+}
+
+void CommandStream::clearRenderTargetView(uint64_t rtv_handle, std::array<float, 4> const& rgba_clear_value,
+    std::vector<CommandStreamRectangle> const& clear_rectangles)
+{
+    record(CommandStreamCommandType::clear_render_target_view,
+        ClearRenderTargetViewArguments{ .rtv_handle = rtv_handle, .rgba_clear_value = rgba_clear_value,
+            .rectangle_count = static_cast<uint32_t>(clear_rectangles.size()) },
+        clear_rectangles.data(), clear_rectangles.size() * sizeof(CommandStreamRectangle));
+}
+
+void CommandStream::clearDepthStencilView(uint64_t dsv_handle, CommandStreamDSVClearFlags clear_flags,
+    float depth_clear_value, uint8_t stencil_clear_value, std::vector<CommandStreamRectangle> const& clear_rectangles)
+{
+    record(CommandStreamCommandType::clear_depth_stencil_view,
+        ClearDepthStencilViewArguments{ .dsv_handle = dsv_handle, .clear_flags = clear_flags, .depth_clear_value = depth_clear_value,
+            .stencil_clear_value = stencil_clear_value, .rectangle_count = static_cast<uint32_t>(clear_rectangles.size()) },
+        clear_rectangles.data(), clear_rectangles.size() * sizeof(CommandStreamRectangle));
+}
+
+void CommandStream::resourceBarriers(std::vector<TrackedResourceBarrier> const& barriers)
+{
+    if (barriers.empty()) return;
+
+    record(CommandStreamCommandType::resource_barriers, ArrayArguments{ .count = static_cast<uint32_t>(barriers.size()) },
+        barriers.data(), barriers.size() * sizeof(TrackedResourceBarrier));
+}
+
+void CommandStream::drawInstanced(uint32_t vertex_count_per_instance, uint32_t instance_count,
+    uint32_t start_vertex_location, uint32_t start_instance_location)
+{
+    record(CommandStreamCommandType::draw_instanced,
+        DrawInstancedArguments{ .vertex_count_per_instance = vertex_count_per_instance, .instance_count = instance_count,
+            .start_vertex_location = start_vertex_location, .start_instance_location = start_instance_location });
+}
+
+void CommandStream::drawIndexedInstanced(uint32_t index_count_per_instance, uint32_t instance_count,
+    uint32_t start_index_location, int32_t base_vertex_location, uint32_t start_instance_location)
+{
+    record(CommandStreamCommandType::draw_indexed_instanced,
+        DrawIndexedInstancedArguments{ .index_count_per_instance = index_count_per_instance, .instance_count = instance_count,
+            .start_index_location = start_index_location, .base_vertex_location = base_vertex_location,
+            .start_instance_location = start_instance_location });
+}
+
+void CommandStream::dispatch(uint32_t thread_group_x, uint32_t thread_group_y, uint32_t thread_group_z)
+{
+    record(CommandStreamCommandType::dispatch,
+        DispatchArguments{ .thread_group_x = thread_group_x, .thread_group_y = thread_group_y, .thread_group_z = thread_group_z });
+}
+
+void CommandStream::copyBufferRegion(Resource const* p_dst_buffer, uint64_t dst_buffer_offset,
+    Resource const* p_src_buffer, uint64_t src_buffer_offset, uint64_t num_bytes)
+{
+    record(CommandStreamCommandType::copy_buffer_region,
+        CopyBufferRegionArguments{ .p_dst_buffer = p_dst_buffer, .p_src_buffer = p_src_buffer,
+            .dst_buffer_offset = dst_buffer_offset, .src_buffer_offset = src_buffer_offset, .num_bytes = num_bytes });
+}
+
+void CommandStream::copyResource(Resource const* p_dst_resource, Resource const* p_src_resource)
+{
+    record(CommandStreamCommandType::copy_resource,
+        CopyResourceArguments{ .p_dst_resource = p_dst_resource, .p_src_resource = p_src_resource });
+}
+
+void CommandStream::replay(AbstractCommandStreamBackend& backend) const
+{
+    if (isEmpty()) return;
+
+    for (size_t i = 0; i <= m_current_chunk; ++i)
+    {
+        Chunk const& chunk = m_chunks[i];
+        for (size_t offset = 0; offset < chunk.size;)
+        {
+            uint8_t const* p_command = chunk.data.get() + offset;
+            CommandHeader header;
+            std::memcpy(&header, p_command, sizeof(CommandHeader));
+
+            switch (header.type)
+            {
+            case CommandStreamCommandType::set_pipeline_state:
+                backend.setPipelineState(readArguments<PipelineStateArguments>(p_command).p_pipeline_state);
+                break;
+
+            case CommandStreamCommandType::set_root_signature:
+            {
+                auto arguments = readArguments<RootSignatureArguments>(p_command);
+                backend.setRootSignature(std::string_view{ payload<RootSignatureArguments, char>(p_command), arguments.name_length });
+                break;
+            }
+
+            case CommandStreamCommandType::set_descriptor_heaps:
+            {
+                auto arguments = readArguments<DescriptorHeapsArguments>(p_command);
+                backend.setDescriptorHeaps(arguments.p_cbv_srv_uav_heap, arguments.p_sampler_heap);
+                break;
+            }
+
+            case CommandStreamCommandType::set_root_descriptor_table:
+            {
+                auto arguments = readArguments<RootParameterArguments>(p_command);
+                backend.setRootDescriptorTable(arguments.root_signature_slot, arguments.value);
+                break;
+            }
+
+            case CommandStreamCommandType::set_root_32bit_constants:
+            {
+                auto arguments = readArguments<Root32BitConstantsArguments>(p_command);
+                backend.setRoot32BitConstants(arguments.root_signature_slot, payload<Root32BitConstantsArguments, uint32_t>(p_command),
+                    arguments.count, arguments.offset_in_32bit_values);
+                break;
+            }
+
+            case CommandStreamCommandType::set_root_constant_buffer_view:
+            {
+                auto arguments = readArguments<RootParameterArguments>(p_command);
+                backend.setRootConstantBufferView(arguments.root_signature_slot, arguments.value);
+                break;
+            }
+
+            case CommandStreamCommandType::set_root_shader_resource_view:
+            {
+                auto arguments = readArguments<RootParameterArguments>(p_command);
+                backend.setRootShaderResourceView(arguments.root_signature_slot, arguments.value);
+                break;
+            }
+
+            case CommandStreamCommandType::set_root_unordered_access_view:
+            {
+                auto arguments = readArguments<RootParameterArguments>(p_command);
+                backend.setRootUnorderedAccessView(arguments.root_signature_slot, arguments.value);
+                break;
+            }
+
+            case CommandStreamCommandType::set_primitive_topology:
+                backend.setPrimitiveTopology(readArguments<PrimitiveTopologyArguments>(p_command).primitive_topology);
+                break;
+
+            case CommandStreamCommandType::set_vertex_buffers:
+            {
+                auto arguments = readArguments<VertexBuffersArguments>(p_command);
+                backend.setVertexBuffers(arguments.start_slot,
+                    payload<VertexBuffersArguments, CommandStreamVertexBufferView>(p_command), arguments.count);
+                break;
+            }
+
+            case CommandStreamCommandType::set_index_buffer:
+                backend.setIndexBuffer(readArguments<CommandStreamIndexBufferView>(p_command));
+                break;
+
+            case CommandStreamCommandType::set_viewports:
+                backend.setViewports(payload<ArrayArguments, CommandStreamViewport>(p_command),
+                    readArguments<ArrayArguments>(p_command).count);
+                break;
+
+            case CommandStreamCommandType::set_scissor_rectangles:
+                backend.setScissorRectangles(payload<ArrayArguments, CommandStreamRectangle>(p_command),
+                    readArguments<ArrayArguments>(p_command).count);
+                break;
+
+            case CommandStreamCommandType::set_blend_factor:
+                backend.setBlendFactor(readArguments<BlendFactorArguments>(p_command).blend_factor);
+                break;
+
+            case CommandStreamCommandType::set_stencil_reference:
+                backend.setStencilReference(readArguments<StencilReferenceArguments>(p_command).reference_value);
+                break;
+
+            case CommandStreamCommandType::set_render_targets:
+            {
+                auto arguments = readArguments<RenderTargetsArguments>(p_command);
+                backend.setRenderTargets(payload<RenderTargetsArguments, uint64_t>(p_command), arguments.rtv_count, arguments.dsv_handle);
+                break;
+            }
+
+            case CommandStreamCommandType::clear_render_target_view:
+            {
+                auto arguments = readArguments<ClearRenderTargetViewArguments>(p_command);
+                backend.clearRenderTargetView(arguments.rtv_handle, arguments.rgba_clear_value,
+                    payload<ClearRenderTargetViewArguments, CommandStreamRectangle>(p_command), arguments.rectangle_count);
+                break;
+            }
+
+            case CommandStreamCommandType::clear_depth_stencil_view:
+            {
+                auto arguments = readArguments<ClearDepthStencilViewArguments>(p_command);
+                backend.clearDepthStencilView(arguments.dsv_handle, arguments.clear_flags,
+                    arguments.depth_clear_value, arguments.stencil_clear_value,
+                    payload<ClearDepthStencilViewArguments, CommandStreamRectangle>(p_command), arguments.rectangle_count);
+                break;
+            }
+
+            case CommandStreamCommandType::resource_barriers:
+                backend.resourceBarriers(payload<ArrayArguments, TrackedResourceBarrier>(p_command),
+                    readArguments<ArrayArguments>(p_command).count);
+                break;
+
+            case CommandStreamCommandType::draw_instanced:
+            {
+                auto arguments = readArguments<DrawInstancedArguments>(p_command);
+                backend.drawInstanced(arguments.vertex_count_per_instance, arguments.instance_count,
+                    arguments.start_vertex_location, arguments.start_instance_location);
+                break;
+            }
+
+            case CommandStreamCommandType::draw_indexed_instanced:
+            {
+                auto arguments = readArguments<DrawIndexedInstancedArguments>(p_command);
+                backend.drawIndexedInstanced(arguments.index_count_per_instance, arguments.instance_count,
+                    arguments.start_index_location, arguments.base_vertex_location, arguments.start_instance_location);
+                break;
+            }
+
+            case CommandStreamCommandType::dispatch:
+            {
+                auto arguments = readArguments<DispatchArguments>(p_command);
+                backend.dispatch(arguments.thread_group_x, arguments.thread_group_y, arguments.thread_group_z);
+                break;
+            }
+
+            case CommandStreamCommandType::copy_buffer_region:
+            {
+                auto arguments = readArguments<CopyBufferRegionArguments>(p_command);
+                backend.copyBufferRegion(arguments.p_dst_buffer, arguments.dst_buffer_offset,
+                    arguments.p_src_buffer, arguments.src_buffer_offset, arguments.num_bytes);
+                break;
+            }
+
+            case CommandStreamCommandType::copy_resource:
+            {
+                auto arguments = readArguments<CopyResourceArguments>(p_command);
+                backend.copyResource(arguments.p_dst_resource, arguments.p_src_resource);
+                break;
+            }
+
+            default:
+                assert(false);
+            }
+
+            offset += header.size;
+        }
+    }
+}
+
+size_t CommandStream::size() const
+{
+    if (isEmpty()) return 0U;
+
+    return std::accumulate(m_chunks.begin(), m_chunks.begin() + m_current_chunk + 1, size_t{ 0U },
+        [](size_t sum, Chunk const& chunk) { return sum + chunk.size; });
+}
+
+size_t CommandStream::capacity() const
+{
+    return std::accumulate(m_chunks.begin(), m_chunks.end(), size_t{ 0U },
+        [](size_t sum, Chunk const& chunk) { return sum + chunk.capacity; });
+}
+
+void CommandStream::clear()
+{
+    for (auto& chunk : m_chunks) chunk.size = 0U;
+    m_current_chunk = 0U;
+    m_command_count = 0U;
+}
+
+template<typename T>
+void CommandStream::record(CommandStreamCommandType type, T const& arguments, void const* p_payload, size_t payload_size)
+{
+    static_assert(std::is_trivially_copyable_v<T> && alignof(T) <= c_command_alignment);
+
+    size_t const arguments_size = alignCommandSize(sizeof(T));
+    size_t const command_size = c_command_alignment + arguments_size + alignCommandSize(payload_size);
+
+    // commands never straddle the chunks, the commands exceeding the chunk size are given a dedicated chunk
+    if (m_chunks.empty() || m_chunks[m_current_chunk].size + command_size > m_chunks[m_current_chunk].capacity)
+    {
+        size_t const next_chunk = m_chunks.empty() || m_chunks[m_current_chunk].size == 0U ? m_current_chunk : m_current_chunk + 1;
+        if (next_chunk == m_chunks.size()) m_chunks.push_back(Chunk{ .data = nullptr, .capacity = 0U, .size = 0U });
+
+        Chunk& chunk = m_chunks[next_chunk];
+        if (chunk.capacity < command_size)
+        {
+            chunk.capacity = (std::max)(m_chunk_size, command_size);
+            chunk.data.reset(new uint8_t[chunk.capacity]);
+        }
+        chunk.size = 0U;
+        m_current_chunk = next_chunk;
+    }
+
+    Chunk& chunk = m_chunks[m_current_chunk];
+    uint8_t* p_command = chunk.data.get() + chunk.size;
+
+    CommandHeader header{ .type = type, .size = static_cast<uint32_t>(command_size) };
+    std::memcpy(p_command, &header, sizeof(CommandHeader));
+    std::memcpy(p_command + c_command_alignment, &arguments, sizeof(T));
+    if (payload_size) std::memcpy(p_command + c_command_alignment + arguments_size, p_payload, payload_size);
+
+    chunk.size += command_size;
+    ++m_command_count;
+}
+
+
+NullCommandStreamBackend::NullCommandStreamBackend()
+{
+    reset();
+}
+
+size_t NullCommandStreamBackend::totalCommandCount() const
+{
+    return std::accumulate(m_statistics.command_counts.begin(), m_statistics.command_counts.end(), size_t{ 0U });
+}
+
+void NullCommandStreamBackend::reset()
+{
+    m_statistics = NullCommandStreamBackendStatistics{ .command_counts = {}, .barrier_count = 0U, .vertex_count = 0U, .thread_group_count = 0U };
+}
+
+void NullCommandStreamBackend::setPipelineState(PipelineState const* p_pipeline_state)
+{
+    countCommand(CommandStreamCommandType::set_pipeline_state);
+}
+
+void NullCommandStreamBackend::setRootSignature(std::string_view cached_root_signature_friendly_name)
+{
+    countCommand(CommandStreamCommandType::set_root_signature);
+}
+
+void NullCommandStreamBackend::setDescriptorHeaps(DescriptorHeap const* p_cbv_srv_uav_heap, DescriptorHeap const* p_sampler_heap)
+{
+    countCommand(CommandStreamCommandType::set_descriptor_heaps);
+}
+
+void NullCommandStreamBackend::setRootDescriptorTable(uint32_t root_signature_slot, uint64_t gpu_descriptor_handle)
+{
+    countCommand(CommandStreamCommandType::set_root_descriptor_table);
+}
+
+void NullCommandStreamBackend::setRoot32BitConstants(uint32_t root_signature_slot, uint32_t const* p_data, uint32_t count, uint32_t offset_in_32bit_values)
+{
+    countCommand(CommandStreamCommandType::set_root_32bit_constants);
+}
+
+void NullCommandStreamBackend::setRootConstantBufferView(uint32_t root_signature_slot, uint64_t gpu_virtual_address)
+{
+    countCommand(CommandStreamCommandType::set_root_constant_buffer_view);
+}
+
+void NullCommandStreamBackend::setRootShaderResourceView(uint32_t root_signature_slot, uint64_t gpu_virtual_address)
+{
+    countCommand(CommandStreamCommandType::set_root_shader_resource_view);
+}
+
+void NullCommandStreamBackend::setRootUnorderedAccessView(uint32_t root_signature_slot, uint64_t gpu_virtual_address)
+{
+    countCommand(CommandStreamCommandType::set_root_unordered_access_view);
+}
+
+void NullCommandStreamBackend::setPrimitiveTopology(PrimitiveTopology primitive_topology)
+{
+    countCommand(CommandStreamCommandType::set_primitive_topology);
+}
+
+void NullCommandStreamBackend::setVertexBuffers(uint32_t start_slot, CommandStreamVertexBufferView const* p_views, uint32_t count)
+{
+    countCommand(CommandStreamCommandType::set_vertex_buffers);
+}
+
+void NullCommandStreamBackend::setIndexBuffer(CommandStreamIndexBufferView const& view)
+{
+    countCommand(CommandStreamCommandType::set_index_buffer);
+}
+
+void NullCommandStreamBackend::setViewports(CommandStreamViewport const* p_viewports, uint32_t count)
+{
+    countCommand(CommandStreamCommandType::set_viewports);
+}
+
+void NullCommandStreamBackend::setScissorRectangles(CommandStreamRectangle const* p_rectangles, uint32_t count)
+{
+    countCommand(CommandStreamCommandType::set_scissor_rectangles);
+}
+
+void NullCommandStreamBackend::setBlendFactor(std::array<float, 4> const& blend_factor)
+{
+    countCommand(CommandStreamCommandType::set_blend_factor);
+}
+
+void NullCommandStreamBackend::setStencilReference(uint32_t reference_value)
+{
+    countCommand(CommandStreamCommandType::set_stencil_reference);
+}
+
+void NullCommandStreamBackend::setRenderTargets(uint64_t const* p_rtv_handles, uint32_t rtv_count, uint64_t dsv_handle)
+{
+    countCommand(CommandStreamCommandType::set_render_targets);
+}
+
+void NullCommandStreamBackend::clearRenderTargetView(uint64_t rtv_handle, std::array<float, 4> const& rgba_clear_value,
+    CommandStreamRectangle const* p_rectangles, uint32_t rectangle_count)
+{
+    countCommand(CommandStreamCommandType::clear_render_target_view);
+}
+
+void NullCommandStreamBackend::clearDepthStencilView(uint64_t dsv_handle, CommandStreamDSVClearFlags clear_flags,
+    float depth_clear_value, uint8_t stencil_clear_value, CommandStreamRectangle const* p_rectangles, uint32_t rectangle_count)
+{
+    countCommand(CommandStreamCommandType::clear_depth_stencil_view);
+}
+
+void NullCommandStreamBackend::resourceBarriers(TrackedResourceBarrier const* p_barriers, uint32_t count)
+{
+    countCommand(CommandStreamCommandType::resource_barriers);
+    m_statistics.barrier_count += count;
+}
+
+void NullCommandStreamBackend::drawInstanced(uint32_t vertex_count_per_instance, uint32_t instance_count,
+    uint32_t start_vertex_location, uint32_t start_instance_location)
+{
+    countCommand(CommandStreamCommandType::draw_instanced);
+    m_statistics.vertex_count += static_cast<uint64_t>(vertex_count_per_instance) * instance_count;
+}
+
+void NullCommandStreamBackend::drawIndexedInstanced(uint32_t index_count_per_instance, uint32_t instance_count,
+    uint32_t start_index_location, int32_t base_vertex_location, uint32_t start_instance_location)
+{
+    countCommand(CommandStreamCommandType::draw_indexed_instanced);
+    m_statistics.vertex_count += static_cast<uint64_t>(index_count_per_instance) * instance_count;
+}
+
+void NullCommandStreamBackend::dispatch(uint32_t thread_group_x, uint32_t thread_group_y, uint32_t thread_group_z)
+{
+    countCommand(CommandStreamCommandType::dispatch);
+    m_statistics.thread_group_count += static_cast<uint64_t>(thread_group_x) * thread_group_y * thread_group_z;
+}
+
+void NullCommandStreamBackend::copyBufferRegion(Resource const* p_dst_buffer, uint64_t dst_buffer_offset,
+    Resource const* p_src_buffer, uint64_t src_buffer_offset, uint64_t num_bytes)
+{
+    countCommand(CommandStreamCommandType::copy_buffer_region);
+}
+
+void NullCommandStreamBackend::copyResource(Resource const* p_dst_resource, Resource const* p_src_resource)
+{
+    countCommand(CommandStreamCommandType::copy_resource);
+}
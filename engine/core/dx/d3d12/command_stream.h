@@ -0,0 +1,283 @@
+#ifndef LEXGINE_CORE_DX_D3D12_COMMAND_STREAM_H
+#define LEXGINE_CORE_DX_D3D12_COMMAND_STREAM_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "engine/core/primitive_topology.h"
+
+#include "lexgine_core_dx_d3d12_fwd.h"
+#include "resource_state_tracker.h"
+
+namespace lexgine::core::dx::d3d12 {
+
+//! Commands that can be recorded into a command stream
+enum class CommandStreamCommandType : uint8_t
+{
+    set_pipeline_state,
+    set_root_signature,
+    set_descriptor_heaps,
+    set_root_descriptor_table,
+    set_root_32bit_constants,
+    set_root_constant_buffer_view,
+    set_root_shader_resource_view,
+    set_root_unordered_access_view,
+    set_primitive_topology,
+    set_vertex_buffers,
+    set_index_buffer,
+    set_viewports,
+    set_scissor_rectangles,
+    set_blend_factor,
+    set_stencil_reference,
+    set_render_targets,
+    clear_render_target_view,
+    clear_depth_stencil_view,
+    resource_barriers,
+    draw_instanced,
+    draw_indexed_instanced,
+    dispatch,
+    copy_buffer_region,
+    copy_resource,
+
+    count
+};
+
+//! Vertex buffer view, binary compatible with D3D12_VERTEX_BUFFER_VIEW
+struct CommandStreamVertexBufferView final
+{
+    uint64_t buffer_location;    //!< GPU virtual address of the buffer
+    uint32_t size_in_bytes;
+    uint32_t stride_in_bytes;
+};
+
+//! Index buffer view, binary compatible with D3D12_INDEX_BUFFER_VIEW
+struct CommandStreamIndexBufferView final
+{
+    uint64_t buffer_location;    //!< GPU virtual address of the buffer
+    uint32_t size_in_bytes;
+    uint32_t format;    //!< DXGI format of the indices
+};
+
+//! Viewport, binary compatible with D3D12_VIEWPORT
+struct CommandStreamViewport final
+{
+    float top_left_x;
+    float top_left_y;
+    float width;
+    float height;
+    float min_depth;
+    float max_depth;
+};
+
+//! Rectangle in pixels, binary compatible with D3D12_RECT
+struct CommandStreamRectangle final
+{
+    int32_t left;
+    int32_t top;
+    int32_t right;
+    int32_t bottom;
+};
+
+//! Flags of the depth-stencil view clear, the values are the same as those of DSVClearFlags
+enum class CommandStreamDSVClearFlags : uint32_t
+{
+    clear_depth = 1,
+    clear_stencil = 2,
+    clear_depth_and_stencil = 3
+};
+
+
+/*! Receiver of the commands replayed from a command stream. The array arguments point into the stream and are only valid
+ for the duration of the call. The descriptor handles are the values of the CPU descriptor handles as used by D3D12
+*/
+class AbstractCommandStreamBackend
+{
+public:
+    virtual ~AbstractCommandStreamBackend() = default;
+
+    virtual void setPipelineState(PipelineState const* p_pipeline_state) = 0;
+    virtual void setRootSignature(std::string_view cached_root_signature_friendly_name) = 0;
+    virtual void setDescriptorHeaps(DescriptorHeap const* p_cbv_srv_uav_heap, DescriptorHeap const* p_sampler_heap) = 0;
+    virtual void setRootDescriptorTable(uint32_t root_signature_slot, uint64_t gpu_descriptor_handle) = 0;
+    virtual void setRoot32BitConstants(uint32_t root_signature_slot, uint32_t const* p_data, uint32_t count, uint32_t offset_in_32bit_values) = 0;
+    virtual void setRootConstantBufferView(uint32_t root_signature_slot, uint64_t gpu_virtual_address) = 0;
+    virtual void setRootShaderResourceView(uint32_t root_signature_slot, uint64_t gpu_virtual_address) = 0;
+    virtual void setRootUnorderedAccessView(uint32_t root_signature_slot, uint64_t gpu_virtual_address) = 0;
+
+    virtual void setPrimitiveTopology(PrimitiveTopology primitive_topology) = 0;
+    virtual void setVertexBuffers(uint32_t start_slot, CommandStreamVertexBufferView const* p_views, uint32_t count) = 0;
+    virtual void setIndexBuffer(CommandStreamIndexBufferView const& view) = 0;
+    virtual void setViewports(CommandStreamViewport const* p_viewports, uint32_t count) = 0;
+    virtual void setScissorRectangles(CommandStreamRectangle const* p_rectangles, uint32_t count) = 0;
+    virtual void setBlendFactor(std::array<float, 4> const& blend_factor) = 0;
+    virtual void setStencilReference(uint32_t reference_value) = 0;
+    virtual void setRenderTargets(uint64_t const* p_rtv_handles, uint32_t rtv_count, uint64_t dsv_handle) = 0;    //! dsv_handle is 0 when no depth-stencil view is bound
+
+    virtual void clearRenderTargetView(uint64_t rtv_handle, std::array<float, 4> const& rgba_clear_value,
+        CommandStreamRectangle const* p_rectangles, uint32_t rectangle_count) = 0;
+    virtual void clearDepthStencilView(uint64_t dsv_handle, CommandStreamDSVClearFlags clear_flags, float depth_clear_value, uint8_t stencil_clear_value,
+        CommandStreamRectangle const* p_rectangles, uint32_t rectangle_count) = 0;
+
+    virtual void resourceBarriers(TrackedResourceBarrier const* p_barriers, uint32_t count) = 0;
+
+    virtual void drawInstanced(uint32_t vertex_count_per_instance, uint32_t instance_count,
+        uint32_t start_vertex_location, uint32_t start_instance_location) = 0;
+    virtual void drawIndexedInstanced(uint32_t index_count_per_instance, uint32_t instance_count,
+        uint32_t start_index_location, int32_t base_vertex_location, uint32_t start_instance_location) = 0;
+    virtual void dispatch(uint32_t thread_group_x, uint32_t thread_group_y, uint32_t thread_group_z) = 0;
+
+    virtual void copyBufferRegion(Resource const* p_dst_buffer, uint64_t dst_buffer_offset,
+        Resource const* p_src_buffer, uint64_t src_buffer_offset, uint64_t num_bytes) = 0;
+    virtual void copyResource(Resource const* p_dst_resource, Resource const* p_src_resource) = 0;
+};
+
+
+/*! Compact recording of GPU commands independent of the graphics API. The commands are packed one after another into
+ linear memory chunks, so that recording costs roughly a copy of the arguments and no API calls are made. The stream is
+ not thread-safe: each recording thread is supposed to own its stream, and the streams are then translated into the native
+ command lists in a single pass by replaying them in the order of submission. Clearing the stream retains the allocated chunks,
+ so that the same stream can be recorded every frame without touching the heap.
+ Replaying the stream into NullCommandStreamBackend counts the recorded commands without translating them
+*/
+class CommandStream final
+{
+public:
+    static constexpr size_t c_default_chunk_size = 64U * 1024U;
+
+public:
+    CommandStream(size_t chunk_size = c_default_chunk_size);
+
+    void setPipelineState(PipelineState const& pipeline_state);
+    void setRootSignature(std::string_view cached_root_signature_friendly_name);
+    void setDescriptorHeaps(DescriptorHeap const& cbv_srv_uav_heap, DescriptorHeap const& sampler_heap);
+    void setRootDescriptorTable(uint32_t root_signature_slot, uint64_t gpu_descriptor_handle);
+    void setRoot32BitConstant(uint32_t root_signature_slot, uint32_t data, uint32_t offset_in_32bit_values);
+    void setRoot32BitConstants(uint32_t root_signature_slot, std::vector<uint32_t> const& data, uint32_t offset_in_32bit_values);
+    void setRootConstantBufferView(uint32_t root_signature_slot, uint64_t gpu_virtual_address);
+    void setRootShaderResourceView(uint32_t root_signature_slot, uint64_t gpu_virtual_address);
+    void setRootUnorderedAccessView(uint32_t root_signature_slot, uint64_t gpu_virtual_address);
+
+    void setPrimitiveTopology(PrimitiveTopology primitive_topology);
+    void setVertexBuffers(uint32_t start_slot, std::vector<CommandStreamVertexBufferView> const& views);
+    void setVertexBuffers(uint32_t start_slot, CommandStreamVertexBufferView const* p_views, uint32_t count);
+    void setIndexBuffer(CommandStreamIndexBufferView const& view);
+    void setViewports(std::vector<CommandStreamViewport> const& viewports);
+    void setScissorRectangles(std::vector<CommandStreamRectangle> const& rectangles);
+    void setBlendFactor(std::array<float, 4> const& blend_factor);
+    void setStencilReference(uint32_t reference_value);
+    void setRenderTargets(std::vector<uint64_t> const& rtv_handles, uint64_t dsv_handle = 0U);
+
+    void clearRenderTargetView(uint64_t rtv_handle, std::array<float, 4> const& rgba_clear_value,
+        std::vector<CommandStreamRectangle> const& clear_rectangles = {});
+    void clearDepthStencilView(uint64_t dsv_handle, CommandStreamDSVClearFlags clear_flags, float depth_clear_value, uint8_t stencil_clear_value,
+        std::vector<CommandStreamRectangle> const& clear_rectangles = {});
+
+    void resourceBarriers(std::vector<TrackedResourceBarrier> const& barriers);
+
+    void drawInstanced(uint32_t vertex_count_per_instance, uint32_t instance_count,
+        uint32_t start_vertex_location = 0U, uint32_t start_instance_location = 0U);
+    void drawIndexedInstanced(uint32_t index_count_per_instance, uint32_t instance_count,
+        uint32_t start_index_location = 0U, int32_t base_vertex_location = 0, uint32_t start_instance_location = 0U);
+    void dispatch(uint32_t thread_group_x, uint32_t thread_group_y = 1U, uint32_t thread_group_z = 1U);
+
+    void copyBufferRegion(Resource const* p_dst_buffer, uint64_t dst_buffer_offset,
+        Resource const* p_src_buffer, uint64_t src_buffer_offset, uint64_t num_bytes);
+    void copyResource(Resource const* p_dst_resource, Resource const* p_src_resource);
+
+    void replay(AbstractCommandStreamBackend& backend) const;    //! replays the recorded commands into the backend in the order of recording
+
+    size_t commandCount() const { return m_command_count; }
+    size_t size() const;    //! returns amount of memory in bytes occupied by the recorded commands
+    size_t capacity() const;    //! returns amount of memory in bytes allocated by the stream
+    bool isEmpty() const { return m_command_count == 0U; }
+
+    void clear();    //! removes all recorded commands, the allocated memory is retained
+
+private:
+    struct Chunk
+    {
+        std::unique_ptr<uint8_t[]> data;
+        size_t capacity;
+        size_t size;
+    };
+
+private:
+    template<typename T>
+    void record(CommandStreamCommandType type, T const& arguments, void const* p_payload = nullptr, size_t payload_size = 0U);
+
+private:
+    size_t m_chunk_size;
+    std::vector<Chunk> m_chunks;
+    size_t m_current_chunk;    //!< index of the chunk, into which the commands are currently recorded
+    size_t m_command_count;
+};
+
+
+//! Statistics collected by the null backend
+struct NullCommandStreamBackendStatistics final
+{
+    std::array<size_t, static_cast<size_t>(CommandStreamCommandType::count)> command_counts;    //!< number of the replayed commands of each type
+    size_t barrier_count;    //!< total number of resource barriers
+    uint64_t vertex_count;    //!< total number of vertices and indices submitted by the draw calls including instancing
+    uint64_t thread_group_count;    //!< total number of compute thread groups dispatched
+};
+
+
+/*! Backend, which only counts the commands replayed into it. It allows running the recording code and measuring its cost
+ on the systems without GPU. The backends inspecting the arguments of the commands (e.g. for testing) may derive from it
+ and only override the commands they are interested in
+*/
+class NullCommandStreamBackend : public AbstractCommandStreamBackend
+{
+public:
+    NullCommandStreamBackend();
+
+    NullCommandStreamBackendStatistics const& statistics() const { return m_statistics; }
+    size_t commandCount(CommandStreamCommandType type) const { return m_statistics.command_counts[static_cast<size_t>(type)]; }
+    size_t totalCommandCount() const;
+    void reset();    //! resets the statistics
+
+    // AbstractCommandStreamBackend interface
+    void setPipelineState(PipelineState const* p_pipeline_state) override;
+    void setRootSignature(std::string_view cached_root_signature_friendly_name) override;
+    void setDescriptorHeaps(DescriptorHeap const* p_cbv_srv_uav_heap, DescriptorHeap const* p_sampler_heap) override;
+    void setRootDescriptorTable(uint32_t root_signature_slot, uint64_t gpu_descriptor_handle) override;
+    void setRoot32BitConstants(uint32_t root_signature_slot, uint32_t const* p_data, uint32_t count, uint32_t offset_in_32bit_values) override;
+    void setRootConstantBufferView(uint32_t root_signature_slot, uint64_t gpu_virtual_address) override;
+    void setRootShaderResourceView(uint32_t root_signature_slot, uint64_t gpu_virtual_address) override;
+    void setRootUnorderedAccessView(uint32_t root_signature_slot, uint64_t gpu_virtual_address) override;
+    void setPrimitiveTopology(PrimitiveTopology primitive_topology) override;
+    void setVertexBuffers(uint32_t start_slot, CommandStreamVertexBufferView const* p_views, uint32_t count) override;
+    void setIndexBuffer(CommandStreamIndexBufferView const& view) override;
+    void setViewports(CommandStreamViewport const* p_viewports, uint32_t count) override;
+    void setScissorRectangles(CommandStreamRectangle const* p_rectangles, uint32_t count) override;
+    void setBlendFactor(std::array<float, 4> const& blend_factor) override;
+    void setStencilReference(uint32_t reference_value) override;
+    void setRenderTargets(uint64_t const* p_rtv_handles, uint32_t rtv_count, uint64_t dsv_handle) override;
+    void clearRenderTargetView(uint64_t rtv_handle, std::array<float, 4> const& rgba_clear_value,
+        CommandStreamRectangle const* p_rectangles, uint32_t rectangle_count) override;
+    void clearDepthStencilView(uint64_t dsv_handle, CommandStreamDSVClearFlags clear_flags, float depth_clear_value, uint8_t stencil_clear_value,
+        CommandStreamRectangle const* p_rectangles, uint32_t rectangle_count) override;
+    void resourceBarriers(TrackedResourceBarrier const* p_barriers, uint32_t count) override;
+    void drawInstanced(uint32_t vertex_count_per_instance, uint32_t instance_count,
+        uint32_t start_vertex_location, uint32_t start_instance_location) override;
+    void drawIndexedInstanced(uint32_t index_count_per_instance, uint32_t instance_count,
+        uint32_t start_index_location, int32_t base_vertex_location, uint32_t start_instance_location) override;
+    void dispatch(uint32_t thread_group_x, uint32_t thread_group_y, uint32_t thread_group_z) override;
+    void copyBufferRegion(Resource const* p_dst_buffer, uint64_t dst_buffer_offset,
+        Resource const* p_src_buffer, uint64_t src_buffer_offset, uint64_t num_bytes) override;
+    void copyResource(Resource const* p_dst_resource, Resource const* p_src_resource) override;
+
+private:
+    void countCommand(CommandStreamCommandType type) { ++m_statistics.command_counts[static_cast<size_t>(type)]; }
+
+private:
+    NullCommandStreamBackendStatistics m_statistics;
+};
+
+}
+
+#endif
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cstring>
 #include <numeric>
 
 #include "constant_buffer_data_mapper.h"
@@ -9,40 +11,138 @@ ConstantBufferDataMapper::ConstantBufferDataMapper(ConstantBufferReflection cons
 {
 }
 
+ConstantBufferDataMapper::ConstantBufferDataMapper(ConstantBufferDataMapper&& other)
+    : m_reflection{ other.m_reflection }
+    , m_writers{ std::move(other.m_writers) }
+    , m_write_plan{ std::move(other.m_write_plan) }
+    , m_write_plan_reflection_revision{ other.m_write_plan_reflection_revision.load(std::memory_order_relaxed) }
+{
+    other.m_write_plan_reflection_revision.store(c_invalid_revision, std::memory_order_relaxed);
+}
+
 void ConstantBufferDataMapper::writeAllBoundData(uint64_t constant_buffer_allocation_base_address) const
 {
-    for (auto& w : m_writers)
+    for (WriteOperation const& op : writePlan())
     {
-        auto reflection_entry = m_reflection[w.first];
-        
-        auto row_and_column_count =
-            ConstantBufferReflection
-            ::getReflectionEntryBaseTypeDimensions(reflection_entry.desc().base_type);
-
-        uint64_t dst_address = constant_buffer_allocation_base_address
-            + reflection_entry.offset();
-
-        auto [row_count, column_count] = row_and_column_count;
-        size_t element_count = w.second->dataElementCount();
-        size_t total_element_count{ row_count * column_count * element_count };
-        if (total_element_count > 1)
+        if (!op.p_source)
+        {
+            writeVariableLengthData(op, constant_buffer_allocation_base_address);
+            continue;
+        }
+
+        char* p_destination = reinterpret_cast<char*>(constant_buffer_allocation_base_address + op.destination_offset);
+        char const* p_source = static_cast<char const*>(op.p_source);
+        switch (op.conversion)
         {
-            for (size_t i = 0; i < element_count; ++i)
+        case ConstantDataConversion::none:
+            for (size_t i = 0; i < op.count; ++i)
             {
-                void const* source_data = w.second->fetchDataElement(i);
-
-                for (size_t j = 0; j < column_count; ++j)
-                {
-                    memcpy(reinterpret_cast<void*>(dst_address + (i*column_count + j) * 16),
-                        static_cast<char const*>(source_data) + j * row_and_column_count.first * 4,
-                        row_and_column_count.first * 4);
-                }
+                memcpy(p_destination + i * op.destination_stride, p_source + i * op.source_stride, op.size);
             }
+            break;
+
+        case ConstantDataConversion::bool_to_uint:
+        {
+            uint32_t const value = *reinterpret_cast<bool const*>(p_source) ? 1U : 0U;
+            memcpy(p_destination, &value, sizeof(value));
+            break;
+        }
+        }
+    }
+}
+
+std::vector<ConstantBufferDataMapper::WriteOperation> const& ConstantBufferDataMapper::writePlan() const
+{
+    uint64_t const reflection_revision = m_reflection.revision();
+    if (m_write_plan_reflection_revision.load(std::memory_order_acquire) != reflection_revision)
+    {
+        // the writes racing for an outdated plan are serialized here, only the first of them compiles it
+        std::lock_guard<std::mutex> lock{ m_write_plan_mutex };
+        if (m_write_plan_reflection_revision.load(std::memory_order_relaxed) != reflection_revision)
+        {
+            compileWritePlan();
+            m_write_plan_reflection_revision.store(reflection_revision, std::memory_order_release);
         }
-        else
+    }
+    return m_write_plan;
+}
+
+void ConstantBufferDataMapper::compileWritePlan() const
+{
+    m_write_plan.clear();
+    m_write_plan.reserve(m_writers.size());
+    for (size_t i = 0; i < m_writers.size(); ++i)
+    {
+        auto const& [variable_name, p_provider] = m_writers[i];
+        auto reflection_entry = m_reflection[variable_name];
+
+        // each column of a matrix occupies its own 16-byte register
+        auto [row_count, column_count] = ConstantBufferReflection::getReflectionEntryBaseTypeDimensions(reflection_entry.desc().base_type);
+        size_t const column_size = row_count * 4;
+        m_write_plan.push_back(WriteOperation{
+            .p_source = p_provider->hasFixedLayout() ? p_provider->fetchDataElement() : nullptr,
+            .destination_offset = reflection_entry.offset(),
+            .size = column_size,
+            .count = column_count,
+            .source_stride = column_size,
+            .destination_stride = 16U,
+            .conversion = row_count * column_count > 1 ? ConstantDataConversion::none : p_provider->conversion(),
+            .writer_index = i
+            });
+    }
+
+    // blocks that are contiguous both in the source and in the destination are copied at once
+    for (WriteOperation& op : m_write_plan)
+    {
+        if (op.p_source && op.count > 1 && op.source_stride == op.size && op.destination_stride == op.size)
+        {
+            op.size *= op.count;
+            op.count = 1;
+        }
+    }
+
+    // copies of the data adjacent both in the source and in the destination are merged
+    std::stable_sort(m_write_plan.begin(), m_write_plan.end(),
+        [](WriteOperation const& a, WriteOperation const& b) { return a.destination_offset < b.destination_offset; });
+
+    auto is_mergeable_copy = [](WriteOperation const& op)
+    {
+        return op.p_source && op.count == 1 && op.conversion == ConstantDataConversion::none;
+    };
+
+    size_t merged_op_count{ 0U };
+    for (WriteOperation const& op : m_write_plan)
+    {
+        if (merged_op_count > 0)
+        {
+            WriteOperation& previous_op = m_write_plan[merged_op_count - 1];
+            if (is_mergeable_copy(previous_op) && is_mergeable_copy(op)
+                && previous_op.destination_offset + previous_op.size == op.destination_offset
+                && static_cast<char const*>(previous_op.p_source) + previous_op.size == op.p_source)
+            {
+                previous_op.size += op.size;
+                previous_op.source_stride = previous_op.destination_stride = previous_op.size;
+                continue;
+            }
+        }
+        m_write_plan[merged_op_count++] = op;
+    }
+    m_write_plan.resize(merged_op_count);
+}
+
+void ConstantBufferDataMapper::writeVariableLengthData(WriteOperation const& op, uint64_t constant_buffer_allocation_base_address) const
+{
+    AbstractConstantDataProvider const& provider = *m_writers[op.writer_index].second;
+
+    // every element of an array starts from a new 16-byte register
+    char* p_destination = reinterpret_cast<char*>(constant_buffer_allocation_base_address + op.destination_offset);
+    size_t const element_count = provider.dataElementCount();
+    for (size_t i = 0; i < element_count; ++i)
+    {
+        char const* p_source = static_cast<char const*>(provider.fetchDataElement(i));
+        for (size_t j = 0; j < op.count; ++j)
         {
-            void const* source_data = w.second->fetchDataElement();
-            memcpy(reinterpret_cast<void*>(dst_address), source_data, row_and_column_count.first * 4);
+            memcpy(p_destination + (i * op.count + j) * op.destination_stride, p_source + j * op.source_stride, op.size);
         }
     }
 }
@@ -1,7 +1,10 @@
 #ifndef LEXGINE_CORE_DX_D3D12_CONSTANT_BUFFER_DATA_MAPPER_H
 #define LEXGINE_CORE_DX_D3D12_CONSTANT_BUFFER_DATA_MAPPER_H
 
+#include <atomic>
+#include <limits>
 #include <list>
+#include <mutex>
 #include "engine/core/misc/hashed_string.h"
 #include "engine/core/misc/static_vector.h"
 #include "engine/core/math/vector_types.h"
@@ -10,17 +13,28 @@
 
 namespace lexgine::core::dx::d3d12 {
 
+//! Conversion applied to the source data when it gets written into a constant buffer
+enum class ConstantDataConversion : uint8_t
+{
+    none,    //!< the data is copied as is
+    bool_to_uint    //!< single-byte boolean is expanded into 32-bit HLSL boolean
+};
+
 template<typename T>
 struct ConstantElementProvider final
 {
     static_assert(std::is_scalar<T>::value, "type is not supported");
 
+    static constexpr ConstantDataConversion conversion = std::is_same_v<T, bool> ? ConstantDataConversion::bool_to_uint : ConstantDataConversion::none;
+
     static void const* fetch(T const& element) { return &element; }
 };
 
 template<typename T, uint32_t nrows, uint32_t ncolumns, glm::qualifier Q>
 struct ConstantElementProvider<math::matrix<T, nrows, ncolumns, Q>> final
 {
+    static constexpr ConstantDataConversion conversion = ConstantDataConversion::none;
+
     static void const* fetch(math::matrix<T, nrows, ncolumns, Q> const& element)
     { 
         return element.getRawData();
@@ -30,6 +44,8 @@ struct ConstantElementProvider<math::matrix<T, nrows, ncolumns, Q>> final
 template<typename T, uint32_t nelements, glm::qualifier Q>
 struct ConstantElementProvider<math::vector<T, nelements, Q>> final
 {
+    static constexpr ConstantDataConversion conversion = ConstantDataConversion::none;
+
     static void const* fetch(math::vector<T, nelements, Q> const& element) { return element.getRawData(); }
 };
 
@@ -41,6 +57,11 @@ public:
 
     virtual void const* fetchDataElement(size_t element_index = 0U) const = 0;
     virtual size_t dataElementCount() const = 0;
+
+    //! returns 'true' if the address and the number of the data elements never change, so that they can be resolved once in advance
+    virtual bool hasFixedLayout() const = 0;
+
+    virtual ConstantDataConversion conversion() const = 0;
 };
 
 template<typename T> class ConstantDataProvider : public AbstractConstantDataProvider
@@ -59,6 +80,10 @@ public:
 
     size_t dataElementCount() const override { return 1; }
 
+    bool hasFixedLayout() const override { return true; }
+
+    ConstantDataConversion conversion() const override { return ConstantElementProvider<T>::conversion; }
+
 private:
     T const& m_value;
 };
@@ -81,30 +106,71 @@ public:
 
     size_t dataElementCount() const override { return m_value.size(); }
 
+    bool hasFixedLayout() const override { return false; }
+
+    ConstantDataConversion conversion() const override { return ConstantElementProvider<T>::conversion; }
+
 private:
     std::vector<T> const& m_value;
 };
 
 
+/*! Maps data sources onto the variables of a constant buffer. On the first write after the bindings or the reflection of the constant
+ buffer have changed the bindings are compiled into a flat write plan: the reflection entries are resolved, the addresses of the data
+ sources are fetched and the copies of adjacent data are merged together. Subsequent writes only execute the plan, which involves
+ neither name lookups nor virtual calls. The only exception are bindings to std::vector, which data are fetched on every write as
+ the address and the size of the data may change. Concurrent writes using the same mapper are allowed: the first of them compiles the plan
+ under a lock, while the others wait for it to complete. The bindings and the reflection must not be changed concurrently with the writes
+*/
 class ConstantBufferDataMapper final
 {
+public:
+    //! Single operation of the write plan
+    struct WriteOperation
+    {
+        void const* p_source;    //!< source data or nullptr for the bindings to std::vector, which data are fetched on every write
+        size_t destination_offset;    //!< offset of the data from the beginning of the constant buffer
+        size_t size;    //!< size of a single copied block in bytes
+        size_t count;    //!< number of the copied blocks
+        size_t source_stride;
+        size_t destination_stride;
+        ConstantDataConversion conversion;
+        size_t writer_index;    //!< data binding written by the operation
+    };
+
 public:
     explicit ConstantBufferDataMapper(ConstantBufferReflection const& reflection);
+    ConstantBufferDataMapper(ConstantBufferDataMapper&& other);    //! the mapper being moved must not be used concurrently
 
     template<typename T>
     void addDataBinding(std::string const& target_variable_name, T const& data_source)
     {
         m_writers.emplace_back(misc::HashedString{ target_variable_name },
             std::unique_ptr<AbstractConstantDataProvider>{new ConstantDataProvider<std::remove_const_t<std::remove_reference_t<T>>>{ data_source }});
+        m_write_plan_reflection_revision.store(c_invalid_revision, std::memory_order_relaxed);
     }
 
     void writeAllBoundData(uint64_t constant_buffer_allocation_base_address) const;
 
     size_t mappedDataSize() const { return m_reflection.size(); }
 
+    //! returns write plan compiled for the current bindings, compiling it if needed
+    std::vector<WriteOperation> const& writePlan() const;
+
+private:
+    void compileWritePlan() const;
+    void writeVariableLengthData(WriteOperation const& op, uint64_t constant_buffer_allocation_base_address) const;    //! writes data of a binding to std::vector
+
 private:
+    static constexpr uint64_t c_invalid_revision = (std::numeric_limits<uint64_t>::max)();
+
     ConstantBufferReflection const& m_reflection;
     std::vector<std::pair<misc::HashedString, std::unique_ptr<AbstractConstantDataProvider>>> m_writers;
+
+    // the write plan is compiled lazily, since the reflection may not be complete when the bindings are added
+    mutable std::vector<WriteOperation> m_write_plan;
+    mutable std::atomic_uint64_t m_write_plan_reflection_revision{ c_invalid_revision };    //!< revision of the reflection the plan has been compiled for
+    mutable std::mutex m_write_plan_mutex;
 };
 
 }
@@ -1,3 +1,4 @@
+#include <atomic>
 #include <cassert>
 
 #include "engine/core/exception.h"
@@ -8,6 +9,13 @@ using namespace lexgine::core::misc;
 using namespace lexgine::core::dx::d3d12;
 
 
+namespace {
+
+std::atomic_uint64_t reflection_revision_counter{ 0U };
+
+}
+
+
 std::pair<unsigned, unsigned> ConstantBufferReflection::getReflectionEntryBaseTypeDimensions(ReflectionEntryBaseType entry_base_type)
 {
     int type_idx = static_cast<int>(entry_base_type);
@@ -41,6 +49,7 @@ bool ConstantBufferReflection::addElement(std::string const& name, ReflectionEnt
 
     ReflectionEntry entry{ start_address, entry_descriptor, data_size };
     m_current_offset = start_address + data_size;
+    m_revision = ++reflection_revision_counter;
 
     return m_reflection_data.insert(std::make_pair(hash, entry)).second;
 }
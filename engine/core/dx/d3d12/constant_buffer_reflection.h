@@ -2,6 +2,7 @@
 #define LEXGINE_CORE_DX_D3D12_CONSTANT_BUFFER_REFLECTION_H
 
 #include <map>
+#include <unordered_map>
 
 #include "engine/core/entity.h"
 #include "engine/core/class_names.h"
@@ -68,7 +69,8 @@ public:
 
 public:
     ConstantBufferReflection()
-        : m_current_offset{ 0 } {}
+        : m_current_offset{ 0 }
+        , m_revision{ 0 } {}
 
     /*! Inserts new element into the constant buffer reflection and returns 'true' in case of success
      or 'false' if element with provided name already exists in the reflection
@@ -81,8 +83,14 @@ public:
     //! returns reflection entry corresponding to the given hash
     ReflectionEntry const& operator[](misc::HashedString const& hash) const;
 
+    /*! Returns revision of the reflection. Each modification assigns the reflection a new revision, which is unique among all reflections,
+     while copies of the reflection share its revision. Hence, the data laid out against a reflection only needs to be updated when its revision changes
+    */
+    uint64_t revision() const { return m_revision; }
+
 private:
     size_t m_current_offset;
+    uint64_t m_revision;
     std::unordered_map<misc::HashedString, ReflectionEntry> m_reflection_data;
 };
 
@@ -64,3 +64,15 @@ PerFrameUploadDataStreamAllocator::address_type ConstantBufferStream::allocateAn
     update(allocation, data_mapper);
     return allocation;
 }
+
+PerFrameUploadDataStreamAllocator::address_type ConstantBufferStream::allocateAndUpdate(std::span<uint8_t const> serialized_data)
+{
+    auto allocation = m_allocator->allocate(serialized_data.size());
+    memcpy(allocation->cpuAddress(), serialized_data.data(), serialized_data.size());
+    return allocation;
+}
+
+uint64_t ConstantBufferStream::recordingFrame() const
+{
+    return m_allocator->recordingWork();
+}
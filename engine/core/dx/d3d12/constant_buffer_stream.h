@@ -2,6 +2,7 @@
 #define LEXGINE_CORE_DX_D3D12_CONSTANT_BUFFER_STREAM_H
 
 #include <memory>
+#include <span>
 
 #include "engine/core/entity.h"
 #include "engine/core/class_names.h"
@@ -25,6 +26,11 @@ public:
 
     PerFrameUploadDataStreamAllocator::address_type allocateAndUpdate(ConstantBufferDataMapper const& data_mapper);
 
+    //! allocates space in the stream and copies pre-serialized constant data into it
+    PerFrameUploadDataStreamAllocator::address_type allocateAndUpdate(std::span<uint8_t const> serialized_data);
+
+    uint64_t recordingFrame() const;    //!< returns index of the frame, which the allocations made by the stream are currently attributed to
+
 
 private:
     std::unique_ptr<PerFrameUploadDataStreamAllocator> m_allocator;
@@ -0,0 +1,34 @@
+#include <cassert>
+
+#include "constant_data_cache.h"
+
+using namespace lexgine::core::dx::d3d12;
+
+ConstantDataCache::ConstantDataCache(size_t data_size, uint32_t group_count)
+    : m_data(data_size, 0)
+    , m_all_groups_mask{ group_count >= 64 ? ~uint64_t{ 0 } : (uint64_t{ 1 } << group_count) - 1 }
+    , m_dirty_groups{ m_all_groups_mask }
+{
+    assert(group_count > 0 && group_count <= 64);
+}
+
+void ConstantDataCache::resize(size_t data_size)
+{
+    if (data_size == m_data.size()) return;
+
+    m_data.assign(data_size, 0);
+    invalidateAll();
+}
+
+void ConstantDataCache::invalidate(uint32_t group)
+{
+    assert(group < 64 && ((uint64_t{ 1 } << group) & m_all_groups_mask));
+    m_dirty_groups |= uint64_t{ 1 } << group;
+    m_is_upload_valid = false;
+}
+
+void ConstantDataCache::invalidateAll()
+{
+    m_dirty_groups = m_all_groups_mask;
+    m_is_upload_valid = false;
+}
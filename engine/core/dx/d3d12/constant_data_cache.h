@@ -0,0 +1,80 @@
+#ifndef LEXGINE_CORE_DX_D3D12_CONSTANT_DATA_CACHE_H
+#define LEXGINE_CORE_DX_D3D12_CONSTANT_DATA_CACHE_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace lexgine::core::dx::d3d12 {
+
+/*! Pre-serialized constant buffer data split into parameter groups, each of which is re-serialized only after it has been
+ invalidated. The serialized block is uploaded at most once per frame: repeated binds during the same frame reuse the
+ upload allocation made by the first bind, unless the data has been invalidated in between. Since the constant data stream
+ recycles its allocations once the frame they were made for has completed, the block has to be copied again on the first
+ bind of every frame, which costs a single memory copy instead of walking the data bindings
+*/
+class ConstantDataCache final
+{
+public:
+    ConstantDataCache(size_t data_size, uint32_t group_count);
+
+    //! changes size of the serialized block. All groups are invalidated if the size changes
+    void resize(size_t data_size);
+    size_t size() const { return m_data.size(); }
+
+    //! marks parameter group as changed, so that it gets re-serialized and uploaded on the next bind
+    void invalidate(uint32_t group);
+    void invalidateAll();
+
+    bool isDirty() const { return m_dirty_groups != 0; }
+    uint64_t uploadCount() const { return m_upload_count; }    //!< returns number of upload allocations made for the block since the cache was created
+
+    /*! Re-serializes the invalidated groups by calling write_group(group, p_block) for each of them and returns the serialized block.
+     The writer must only write the data belonging to the given group
+    */
+    template<typename GroupWriter>
+    std::span<uint8_t const> update(GroupWriter&& write_group)
+    {
+        for (uint32_t group = 0; m_dirty_groups != 0; ++group)
+        {
+            uint64_t const group_mask = uint64_t{ 1 } << group;
+            if (m_dirty_groups & group_mask)
+            {
+                write_group(group, static_cast<void*>(m_data.data()));
+                m_dirty_groups &= ~group_mask;
+                m_is_upload_valid = false;
+            }
+        }
+        return m_data;
+    }
+
+    /*! Returns virtual GPU address of the serialized block uploaded during the given frame. If the block has not been uploaded during
+     this frame yet or has changed since the last upload, upload(data) is called to allocate upload memory, copy the data into it and
+     return the address of the allocation. The block must be up to date, i.e. update() must have been called after the last invalidation
+    */
+    template<typename Uploader>
+    uint64_t gpuAddress(uint64_t frame_index, Uploader&& upload)
+    {
+        if (!m_is_upload_valid || m_upload_frame_index != frame_index)
+        {
+            m_upload_gpu_address = upload(std::span<uint8_t const>{ m_data });
+            m_upload_frame_index = frame_index;
+            m_is_upload_valid = true;
+            ++m_upload_count;
+        }
+        return m_upload_gpu_address;
+    }
+
+private:
+    std::vector<uint8_t> m_data;
+    uint64_t m_all_groups_mask;
+    uint64_t m_dirty_groups;
+    bool m_is_upload_valid = false;
+    uint64_t m_upload_frame_index = 0U;
+    uint64_t m_upload_gpu_address = 0U;
+    uint64_t m_upload_count = 0U;
+};
+
+}
+
+#endif
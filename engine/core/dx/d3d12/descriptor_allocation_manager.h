@@ -2,6 +2,7 @@
 #define LEXGINE_CORE_DX_D3D12_DESCRIPTOR_ALLOCATION_MANAGER_H
 
 #include <atomic>
+#include <memory>
 #include <vector>
 #include <type_traits>
 
@@ -37,7 +38,15 @@ public:
 
     }
 
-    bool build(size_t allocator_capacity)
+    virtual ~DescriptorAllocationManager() = default;
+
+    //! returns copy of the allocation manager preserving its dynamic type
+    virtual std::unique_ptr<DescriptorAllocationManager> clone() const
+    {
+        return std::make_unique<DescriptorAllocationManager>(*this);
+    }
+
+    virtual bool build(size_t allocator_capacity)
     {
         if (m_descriptor_table.offset != INVALID_POINTER)
             return allocator_capacity <= m_descriptor_table.descriptor_count;
@@ -69,6 +78,13 @@ public:
     }
 
 protected:
+    //! initializes the manager with an already allocated descriptor table
+    explicit DescriptorAllocationManager(DescriptorTable const& descriptor_table)
+        : m_descriptor_table{ descriptor_table }
+    {
+
+    }
+
     template<typename T>
     size_t createDescriptor(size_t offset_hint, T const& descriptor, uint64_t(DescriptorHeap::* descriptor_creator)(size_t, T const&))
     {
@@ -0,0 +1,199 @@
+#include <algorithm>
+#include <cassert>
+
+#include "descriptor_cache.h"
+
+using namespace lexgine::core;
+using namespace lexgine::core::dx::d3d12;
+
+namespace {
+
+DescriptorRange const c_null_range{ .offset = 0U, .count = 0U, .block = DescriptorRange::c_invalid_block, .generation = 0U };
+
+}
+
+
+DescriptorCache::DescriptorCache(range_allocator_type const& range_allocator, range_releaser_type const& range_releaser,
+    size_t unreferenced_entry_budget, uint32_t shard_count)
+    : m_range_allocator{ range_allocator }
+    , m_range_releaser{ range_releaser }
+    , m_unreferenced_entry_budget_per_shard{ (unreferenced_entry_budget + (std::max)(shard_count, 1U) - 1) / (std::max)(shard_count, 1U) }
+    , m_shards{ new Shard[(std::max)(shard_count, 1U)] }
+    , m_shard_count{ (std::max)(shard_count, 1U) }
+    , m_hits{ 0U }
+    , m_misses{ 0U }
+    , m_evictions{ 0U }
+    , m_failed_allocations{ 0U }
+{
+    for (uint32_t i = 0; i < m_shard_count; ++i)
+    {
+        m_shards[i].p_least_recently_used = m_shards[i].p_most_recently_used = nullptr;
+        m_shards[i].unreferenced_entry_count = 0U;
+    }
+}
+
+DescriptorCache::~DescriptorCache() = default;
+
+DescriptorCacheLookup DescriptorCache::acquire(misc::HashValue const& key, uint32_t descriptor_count, descriptor_writer_type const& descriptor_writer)
+{
+    Shard& shard = shardOf(key);
+    bool is_eviction_deferred{ false };
+    for (bool has_evicted_other_shards = false; ; has_evicted_other_shards = true)
+    {
+        {
+            std::lock_guard<std::mutex> lock{ shard.mutex };
+
+            auto [p, is_inserted] = shard.entries.try_emplace(key,
+                Entry{ .p_key = nullptr, .range = c_null_range, .reference_count = 0U,
+                    .p_previous_unreferenced = nullptr, .p_next_unreferenced = nullptr });
+            Entry& entry = p->second;
+            entry.p_key = &p->first;
+
+            if (!is_inserted)
+            {
+                if (entry.reference_count++ == 0) unlinkUnreferenced(shard, entry);
+                m_hits.fetch_add(1, std::memory_order_relaxed);
+                return DescriptorCacheLookup{ .range = entry.range, .is_hit = true };
+            }
+
+            // on exhaustion of the heap the unreferenced entries of the own shard are sacrificed first, until an evicted range
+            // turns out to be retired rather than freed
+            DescriptorRange range = m_range_allocator(descriptor_count);
+            eviction_result last_eviction_result{ eviction_result::none };
+            while (range.isNull() && (last_eviction_result = evictLeastRecentlyUsed(shard)) == eviction_result::freed)
+            {
+                range = m_range_allocator(descriptor_count);
+            }
+            is_eviction_deferred = last_eviction_result == eviction_result::deferred;
+
+            if (!range.isNull())
+            {
+                try
+                {
+                    descriptor_writer(range);
+                }
+                catch (...)
+                {
+                    shard.entries.erase(p);
+                    m_range_releaser(range);
+                    throw;
+                }
+
+                entry.range = range;
+                entry.reference_count = 1U;
+                m_misses.fetch_add(1, std::memory_order_relaxed);
+                return DescriptorCacheLookup{ .range = range, .is_hit = false };
+            }
+
+            shard.entries.erase(p);
+        }
+
+        // the other shards can only be locked after the own shard has been unlocked, otherwise concurrent lookups could deadlock
+        if (has_evicted_other_shards || is_eviction_deferred || !evictUnreferencedUntilDeferred())
+        {
+            m_failed_allocations.fetch_add(1, std::memory_order_relaxed);
+            return DescriptorCacheLookup{ .range = c_null_range, .is_hit = false };
+        }
+    }
+}
+
+void DescriptorCache::release(misc::HashValue const& key)
+{
+    Shard& shard = shardOf(key);
+    std::lock_guard<std::mutex> lock{ shard.mutex };
+
+    auto p = shard.entries.find(key);
+    assert(p != shard.entries.end() && p->second.reference_count > 0);
+    if (--p->second.reference_count > 0) return;
+
+    linkUnreferenced(shard, p->second);
+    while (shard.unreferenced_entry_count > m_unreferenced_entry_budget_per_shard)
+    {
+        evictLeastRecentlyUsed(shard);
+    }
+}
+
+size_t DescriptorCache::evictUnreferenced()
+{
+    size_t rv{ 0U };
+    for (uint32_t i = 0; i < m_shard_count; ++i)
+    {
+        std::lock_guard<std::mutex> lock{ m_shards[i].mutex };
+        while (evictLeastRecentlyUsed(m_shards[i]) != eviction_result::none) ++rv;
+    }
+    return rv;
+}
+
+bool DescriptorCache::evictUnreferencedUntilDeferred()
+{
+    bool rv{ false };
+    for (uint32_t i = 0; i < m_shard_count; ++i)
+    {
+        std::lock_guard<std::mutex> lock{ m_shards[i].mutex };
+        for (eviction_result result; (result = evictLeastRecentlyUsed(m_shards[i])) != eviction_result::none; rv = true)
+        {
+            if (result == eviction_result::deferred) return rv;
+        }
+    }
+    return rv;
+}
+
+DescriptorCacheStatistics DescriptorCache::statistics() const
+{
+    DescriptorCacheStatistics rv{
+        .hits = m_hits.load(std::memory_order_relaxed),
+        .misses = m_misses.load(std::memory_order_relaxed),
+        .evictions = m_evictions.load(std::memory_order_relaxed),
+        .failed_allocations = m_failed_allocations.load(std::memory_order_relaxed),
+        .entry_count = 0U,
+        .unreferenced_entry_count = 0U
+    };
+
+    for (uint32_t i = 0; i < m_shard_count; ++i)
+    {
+        std::lock_guard<std::mutex> lock{ m_shards[i].mutex };
+        rv.entry_count += m_shards[i].entries.size();
+        rv.unreferenced_entry_count += m_shards[i].unreferenced_entry_count;
+    }
+    return rv;
+}
+
+DescriptorCache::Shard& DescriptorCache::shardOf(misc::HashValue const& key) const
+{
+    // the buckets within the shards are selected by the first half of the key, so the shards are selected by the second one
+    return m_shards[key.part2() % m_shard_count];
+}
+
+void DescriptorCache::linkUnreferenced(Shard& shard, Entry& entry)
+{
+    entry.p_previous_unreferenced = shard.p_most_recently_used;
+    entry.p_next_unreferenced = nullptr;
+    if (shard.p_most_recently_used) shard.p_most_recently_used->p_next_unreferenced = &entry;
+    else shard.p_least_recently_used = &entry;
+    shard.p_most_recently_used = &entry;
+    ++shard.unreferenced_entry_count;
+}
+
+void DescriptorCache::unlinkUnreferenced(Shard& shard, Entry& entry)
+{
+    if (entry.p_previous_unreferenced) entry.p_previous_unreferenced->p_next_unreferenced = entry.p_next_unreferenced;
+    else shard.p_least_recently_used = entry.p_next_unreferenced;
+    if (entry.p_next_unreferenced) entry.p_next_unreferenced->p_previous_unreferenced = entry.p_previous_unreferenced;
+    else shard.p_most_recently_used = entry.p_previous_unreferenced;
+    entry.p_previous_unreferenced = entry.p_next_unreferenced = nullptr;
+    --shard.unreferenced_entry_count;
+}
+
+DescriptorCache::eviction_result DescriptorCache::evictLeastRecentlyUsed(Shard& shard)
+{
+    Entry* p_entry = shard.p_least_recently_used;
+    if (!p_entry) return eviction_result::none;
+
+    unlinkUnreferenced(shard, *p_entry);
+    bool const is_freed = m_range_releaser(p_entry->range);
+
+    misc::HashValue key = *p_entry->p_key;
+    shard.entries.erase(key);
+    m_evictions.fetch_add(1, std::memory_order_relaxed);
+    return is_freed ? eviction_result::freed : eviction_result::deferred;
+}
@@ -0,0 +1,123 @@
+#ifndef LEXGINE_CORE_DX_D3D12_DESCRIPTOR_CACHE_H
+#define LEXGINE_CORE_DX_D3D12_DESCRIPTOR_CACHE_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "engine/core/misc/hash_value.h"
+#include "descriptor_range_allocator.h"
+
+namespace lexgine::core::dx::d3d12 {
+
+//! Result of descriptor cache lookup
+struct DescriptorCacheLookup final
+{
+    DescriptorRange range;    //!< descriptor range holding the cached descriptors or null range if the descriptors could not be allocated
+    bool is_hit;    //!< 'true' if the descriptors have already been present in the cache
+};
+
+struct DescriptorCacheStatistics final
+{
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    uint64_t failed_allocations;    //!< lookups that could not allocate descriptors even after eviction of the unreferenced entries
+    size_t entry_count;
+    size_t unreferenced_entry_count;
+};
+
+
+/*! Content-addressed cache of descriptors shared by all users of a descriptor heap. Entries are keyed by the 128-bit hash
+ of the descriptors they contain, so that equivalent descriptors (or equivalent descriptor tables) are created only once and
+ occupy a single range of the heap. The cache is split into independently locked shards selected by the key, and each lookup
+ probes the shard only once. Entries are reference counted: the entries that are no longer referenced are kept in LRU order
+ and are evicted either when the number of unreferenced entries in a shard exceeds the budget or when the heap gets exhausted.
+ The descriptor ranges are allocated and released by the functions provided on construction, and the release function receives the evicted ranges,
+ which may still be referenced by the GPU work in flight. The release function reports whether the range has been freed right away or only retired until
+ the GPU stops using it, in which case the eviction on heap exhaustion stops, since evicting more entries would not make room for the lookup either.
+ The ranges of the entries that are still cached when the cache is destroyed are not released and are expected to be reclaimed along with the heap
+*/
+class DescriptorCache final
+{
+public:
+    using range_allocator_type = std::function<DescriptorRange(uint32_t descriptor_count)>;    //!< must return null range if the heap is exhausted
+    using range_releaser_type = std::function<bool(DescriptorRange const& range)>;    //!< must return 'false' if the range does not become available for allocation immediately
+    using descriptor_writer_type = std::function<void(DescriptorRange const& range)>;
+
+public:
+    DescriptorCache(range_allocator_type const& range_allocator, range_releaser_type const& range_releaser,
+        size_t unreferenced_entry_budget, uint32_t shard_count = 16U);
+    ~DescriptorCache();
+
+    DescriptorCache(DescriptorCache const&) = delete;
+    DescriptorCache& operator=(DescriptorCache const&) = delete;
+
+    /*! Returns range containing the descriptors with the given content key and adds reference to it. If the descriptors are not
+     cached yet, a range of "descriptor_count" descriptors is allocated and filled by the writer, which is invoked while the shard
+     of the key is locked, so that the concurrent lookups of the same key wait until the descriptors are written
+    */
+    DescriptorCacheLookup acquire(misc::HashValue const& key, uint32_t descriptor_count, descriptor_writer_type const& descriptor_writer);
+
+    void release(misc::HashValue const& key);    //! drops reference acquired by acquire(...)
+
+    size_t evictUnreferenced();    //! evicts all entries that are not referenced and returns the number of evicted entries
+
+    DescriptorCacheStatistics statistics() const;
+
+private:
+    struct Entry
+    {
+        misc::HashValue const* p_key;    //!< key of the entry stored in the hash map node
+        DescriptorRange range;
+        uint32_t reference_count;
+        Entry* p_previous_unreferenced;    //!< links of the LRU list of unreferenced entries
+        Entry* p_next_unreferenced;
+    };
+
+    struct KeyHasher
+    {
+        size_t operator()(misc::HashValue const& key) const { return static_cast<size_t>(key.part1()); }
+    };
+
+    struct alignas(64) Shard
+    {
+        std::mutex mutex;
+        std::unordered_map<misc::HashValue, Entry, KeyHasher> entries;
+        Entry* p_least_recently_used;
+        Entry* p_most_recently_used;
+        size_t unreferenced_entry_count;
+    };
+
+    enum class eviction_result
+    {
+        none,    //!< the shard has no unreferenced entries
+        freed,    //!< the range of the evicted entry has been freed
+        deferred    //!< the range of the evicted entry has been retired and cannot be allocated yet
+    };
+
+private:
+    Shard& shardOf(misc::HashValue const& key) const;
+    void linkUnreferenced(Shard& shard, Entry& entry);
+    void unlinkUnreferenced(Shard& shard, Entry& entry);
+    eviction_result evictLeastRecentlyUsed(Shard& shard);    //! requires the shard to be locked
+    bool evictUnreferencedUntilDeferred();    //! evicts unreferenced entries of all shards until an eviction is deferred. Returns 'true' if any range has been freed
+
+private:
+    range_allocator_type const m_range_allocator;
+    range_releaser_type const m_range_releaser;
+    size_t const m_unreferenced_entry_budget_per_shard;
+    std::unique_ptr<Shard[]> m_shards;
+    uint32_t const m_shard_count;
+
+    std::atomic_uint64_t m_hits;
+    std::atomic_uint64_t m_misses;
+    std::atomic_uint64_t m_evictions;
+    std::atomic_uint64_t m_failed_allocations;
+};
+
+}
+
+#endif
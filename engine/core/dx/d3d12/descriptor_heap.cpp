@@ -44,7 +44,8 @@ uint64_t DescriptorHeap::getBaseGPUPointer() const
 
 void DescriptorHeap::reset()
 {
-    m_num_descriptors_allocated.store(0, std::memory_order_release);
+    std::lock_guard<std::mutex> lock{ m_allocator_mutex };
+    m_allocator.reset();
 }
 
 uint32_t DescriptorHeap::capacity() const
@@ -54,39 +55,112 @@ uint32_t DescriptorHeap::capacity() const
 
 uint32_t DescriptorHeap::descriptorsAllocated() const
 {
-    return (std::min)(m_num_descriptors_allocated.load(std::memory_order::memory_order_acquire), m_descriptor_capacity);
+    std::lock_guard<std::mutex> lock{ m_allocator_mutex };
+    return m_allocator.allocatedCount();
 }
 
 uint32_t DescriptorHeap::reserveDescriptors(uint32_t count)
 {
-    uint32_t offset;
-    if (count <= m_descriptor_capacity - descriptorsAllocated())
+    // empty reservations do not occupy the heap, as it has been the case with the former bump allocation
+    if (!count) return 0U;
+
+    return allocateDescriptorRange(count).offset;
+}
+
+DescriptorTable DescriptorHeap::allocateDescriptorTable(uint32_t capacity)
+{
+    if (!capacity)
     {
-        offset = m_num_descriptors_allocated.fetch_add(count, std::memory_order::memory_order_acq_rel);
+        // empty tables do not occupy the heap
+        return getDescriptorTable(DescriptorRange{ .offset = 0U, .count = 0U, .block = DescriptorRange::c_invalid_block, .generation = 0U });
     }
-    else
+
+    return getDescriptorTable(allocateDescriptorRange(capacity));
+}
+
+DescriptorRange DescriptorHeap::allocateDescriptorRange(uint32_t count)
+{
+    DescriptorRange rv = tryAllocateDescriptorRange(count);
+    if (rv.isNull())
     {
+        uint32_t largest_free_range;
+        {
+            std::lock_guard<std::mutex> lock{ m_allocator_mutex };
+            largest_free_range = m_allocator.largestFreeRange();
+        }
+
         LEXGINE_THROW_ERROR_FROM_NAMED_ENTITY(*this,
             "Unable to reserve " + std::to_string(count) + " descriptors from descriptor heap \""
-            + getStringName() + "\": the descriptor heap is exhausted");
+            + getStringName() + "\": the descriptor heap is exhausted (largest free range contains "
+            + std::to_string(largest_free_range) + " descriptors)");
     }
 
-    return offset;
+    return rv;
 }
 
-DescriptorTable DescriptorHeap::allocateDescriptorTable(uint32_t capacity)
+DescriptorRange DescriptorHeap::tryAllocateDescriptorRange(uint32_t count)
+{
+    std::lock_guard<std::mutex> lock{ m_allocator_mutex };
+    return m_allocator.allocate(count);
+}
+
+DescriptorTable DescriptorHeap::getDescriptorTable(DescriptorRange const& range)
 {
-    uint32_t offset = reserveDescriptors(capacity);
     return {
-        .offset = offset,
-        .cpu_pointer = getBaseCPUPointer() + m_descriptor_size * offset,
-        .gpu_pointer = getBaseGPUPointer() + m_descriptor_size * offset,
-        .descriptor_count = capacity,
+        .offset = range.offset,
+        .cpu_pointer = getBaseCPUPointer() + m_descriptor_size * range.offset,
+        .gpu_pointer = getBaseGPUPointer() + m_descriptor_size * range.offset,
+        .descriptor_count = range.count,
         .descriptor_size = m_descriptor_size,
-        .p_heap = this
+        .p_heap = this,
+        .range = range
     };
 }
 
+void DescriptorHeap::freeDescriptorRange(DescriptorRange const& range)
+{
+    bool is_released;
+    {
+        std::lock_guard<std::mutex> lock{ m_allocator_mutex };
+        is_released = m_allocator.free(range);
+    }
+
+    if (!is_released)
+    {
+        LEXGINE_THROW_ERROR_FROM_NAMED_ENTITY(*this,
+            "Unable to release descriptor range at offset " + std::to_string(range.offset) + " from descriptor heap \""
+            + getStringName() + "\": the range has already been released or retired");
+    }
+}
+
+void DescriptorHeap::retireDescriptorRange(DescriptorRange const& range, uint64_t fence_value)
+{
+    bool is_retired;
+    {
+        std::lock_guard<std::mutex> lock{ m_allocator_mutex };
+        is_retired = m_allocator.retire(range, fence_value);
+    }
+
+    if (!is_retired)
+    {
+        LEXGINE_THROW_ERROR_FROM_NAMED_ENTITY(*this,
+            "Unable to retire descriptor range at offset " + std::to_string(range.offset) + " from descriptor heap \""
+            + getStringName() + "\": the range has already been released or retired");
+    }
+}
+
+void DescriptorHeap::releaseRetiredDescriptorRanges(uint64_t completed_fence_value)
+{
+    std::lock_guard<std::mutex> lock{ m_allocator_mutex };
+    m_allocator.releaseCompleted(completed_fence_value);
+}
+
+bool DescriptorHeap::isDescriptorRangeValid(DescriptorRange const& range) const
+{
+    std::lock_guard<std::mutex> lock{ m_allocator_mutex };
+    return m_allocator.isValid(range);
+}
+
 uint64_t DescriptorHeap::createConstantBufferViewDescriptor(size_t offset, CBVDescriptor const& cbv_descriptor)
 {
     assert(m_type == DescriptorHeapType::cbv_srv_uav);
@@ -224,7 +298,7 @@ DescriptorHeap::DescriptorHeap(Device& device, DescriptorHeapType type, uint32_t
     m_descriptor_size{ device.native()->GetDescriptorHandleIncrementSize(static_cast<D3D12_DESCRIPTOR_HEAP_TYPE>(type)) },
     m_descriptor_capacity{ descriptor_capacity },
     m_node_mask{ node_mask },
-    m_num_descriptors_allocated{ 0U }
+    m_allocator{ descriptor_capacity }
 {
     D3D12_DESCRIPTOR_HEAP_DESC desc;
     desc.Type = static_cast<D3D12_DESCRIPTOR_HEAP_TYPE>(type);
@@ -5,10 +5,11 @@
 #include "engine/core/class_names.h"
 
 #include "lexgine_core_dx_d3d12_fwd.h"
+#include "descriptor_range_allocator.h"
 
 #include <d3d12.h>
 #include <wrl.h>
-#include <atomic>
+#include <mutex>
 
 using namespace Microsoft::WRL;
 
@@ -30,6 +31,7 @@ struct DescriptorTable final {
     uint32_t descriptor_count;       // descriptor capacity of the table
     uint32_t descriptor_size;        // size of singe descriptor
     DescriptorHeap* p_heap;          // pointer to owning heap
+    DescriptorRange range;           // handle of the descriptor range backing the table, which can be used to release the table
 };
 
 class DescriptorHeap final : public NamedEntity<class_names::D3D12_DescriptorHeap>
@@ -50,17 +52,40 @@ public:
 
     DescriptorHeapType type() const { return m_type; }
 
-    void reset();    // resets the descriptor heap
+    void reset();    // resets the descriptor heap. All descriptor ranges allocated from the heap, including the retired ones, are released
 
     uint32_t capacity() const;
 
     
-    uint32_t descriptorsAllocated() const;    //! descriptor count reserved in the descriptor heap by the moment this function was invoked
+    uint32_t descriptorsAllocated() const;    //! descriptor count reserved in the descriptor heap by the moment this function was invoked, including the retired ranges
 
-    uint32_t reserveDescriptors(uint32_t count);    //! reserves "count" descriptors in the descriptor heap and returns offset of the first descriptor reserved
+    /*! reserves "count" descriptors in the descriptor heap and returns offset of the first descriptor reserved. The descriptors are only released when the heap is reset.
+     Reserving zero descriptors never fails and returns zero offset
+    */
+    uint32_t reserveDescriptors(uint32_t count);
 
     DescriptorTable allocateDescriptorTable(uint32_t capacity);
 
+    //! allocates range of "count" descriptors, which can later be released individually
+    DescriptorRange allocateDescriptorRange(uint32_t count);
+
+    //! same as allocateDescriptorRange(...), but returns null range instead of throwing when the descriptor heap is exhausted
+    DescriptorRange tryAllocateDescriptorRange(uint32_t count);
+
+    DescriptorTable getDescriptorTable(DescriptorRange const& range);    //! returns descriptor table occupying the given range of the heap
+
+    //! releases the descriptor range immediately. The range must not be referenced by the GPU work that is still in flight
+    void freeDescriptorRange(DescriptorRange const& range);
+
+    /*! retires the descriptor range, which is then released once releaseRetiredDescriptorRanges(...) is called with completed fence
+     value not less than "fence_value"
+    */
+    void retireDescriptorRange(DescriptorRange const& range, uint64_t fence_value);
+
+    void releaseRetiredDescriptorRanges(uint64_t completed_fence_value);    //! releases the retired ranges, which the GPU is no longer using
+
+    bool isDescriptorRangeValid(DescriptorRange const& range) const;    //! returns 'false' if the range has been released or the handle is stale
+
     /*! creates single CBV descriptor and places it into descriptor heap starting at position provided by
      the offset value. The offset can be obtained using reserveDescriptors(...).
      The return value of this function is GPU address of the created descriptor.
@@ -152,7 +177,8 @@ private:
     uint32_t const m_descriptor_size;    //!< size of a single descriptor in the heap
     uint32_t const m_descriptor_capacity;    //!< number of descriptors that could be stored in the heap
     uint32_t m_node_mask;    //!< mask determining adapter, to which the heap is assigned
-    std::atomic<uint32_t> m_num_descriptors_allocated;    //!< number of currently allocated descriptors
+    mutable std::mutex m_allocator_mutex;
+    DescriptorRangeAllocator m_allocator;    //!< allocator of descriptor slots of the heap, guarded by m_allocator_mutex
 
     size_t m_heap_start_cpu_address;    //!< CPU address of the beginning of the heap
     uint64_t m_heap_start_gpu_address;    //!< GPU address of the beginning of the heap
@@ -0,0 +1,291 @@
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+#include "descriptor_range_allocator.h"
+
+using namespace lexgine::core::dx::d3d12;
+
+namespace {
+
+constexpr uint32_t c_null_block = DescriptorRange::c_invalid_block;
+
+DescriptorRange const c_null_range{ .offset = 0U, .count = 0U, .block = c_null_block, .generation = 0U };
+
+}
+
+
+DescriptorRangeAllocator::DescriptorRangeAllocator(uint32_t capacity)
+    : m_capacity{ capacity }
+{
+    reset();
+}
+
+DescriptorRange DescriptorRangeAllocator::allocate(uint32_t count)
+{
+    if (count == 0 || count > m_capacity) return c_null_range;
+
+    // any block from the size classes starting from ceil(log2(count)) fits the request, so that the lookup is done without scanning the lists
+    uint32_t const size_class = ceilSizeClass(count);
+    uint32_t const suitable_size_classes = size_class < c_size_class_count ? m_non_empty_size_classes & (~0U << size_class) : 0U;
+
+    uint32_t block{ c_null_block };
+    if (suitable_size_classes)
+    {
+        block = m_free_list_heads[std::countr_zero(suitable_size_classes)];
+    }
+    else
+    {
+        // the request may still be satisfied by one of the blocks from the size class of the request rounded down
+        for (uint32_t b = m_free_list_heads[floorSizeClass(count)]; b != c_null_block; b = m_blocks[b].next_free)
+        {
+            if (m_blocks[b].count >= count)
+            {
+                block = b;
+                break;
+            }
+        }
+    }
+    if (block == c_null_block) return c_null_range;
+
+    removeFreeBlock(block);
+
+    // the remainder of the block is split off back into the free lists
+    if (m_blocks[block].count > count)
+    {
+        uint32_t remainder = acquireBlockRecord();
+        Block& b = m_blocks[block];
+        Block& r = m_blocks[remainder];
+        r.offset = b.offset + count;
+        r.count = b.count - count;
+        r.previous_physical = block;
+        r.next_physical = b.next_physical;
+        if (b.next_physical != c_null_block) m_blocks[b.next_physical].previous_physical = remainder;
+        b.next_physical = remainder;
+        b.count = count;
+        insertFreeBlock(remainder);
+    }
+
+    Block& b = m_blocks[block];
+    b.state = block_state::allocated;
+    m_allocated_count += count;
+
+    return DescriptorRange{ .offset = b.offset, .count = b.count, .block = block, .generation = b.generation };
+}
+
+bool DescriptorRangeAllocator::free(DescriptorRange const& range)
+{
+    if (!isValid(range)) return false;
+
+    releaseBlock(range.block);
+    return true;
+}
+
+bool DescriptorRangeAllocator::retire(DescriptorRange const& range, uint64_t fence_value)
+{
+    if (!isValid(range)) return false;
+
+    m_blocks[range.block].state = block_state::retired;
+    m_retired_count += range.count;
+
+    // the retired ranges are kept ordered by their fence values, which normally only requires appending to the queue
+    RetiredRange retired_range{ .block = range.block, .fence_value = fence_value };
+    if (m_retired_ranges.empty() || m_retired_ranges.back().fence_value <= fence_value)
+    {
+        m_retired_ranges.push_back(retired_range);
+    }
+    else
+    {
+        auto p = std::upper_bound(m_retired_ranges.begin(), m_retired_ranges.end(), fence_value,
+            [](uint64_t value, RetiredRange const& e) { return value < e.fence_value; });
+        m_retired_ranges.insert(p, retired_range);
+    }
+    return true;
+}
+
+size_t DescriptorRangeAllocator::releaseCompleted(uint64_t completed_fence_value)
+{
+    size_t released_range_count{ 0U };
+    while (!m_retired_ranges.empty() && m_retired_ranges.front().fence_value <= completed_fence_value)
+    {
+        uint32_t block = m_retired_ranges.front().block;
+        m_retired_ranges.pop_front();
+
+        assert(m_blocks[block].state == block_state::retired);
+        m_retired_count -= m_blocks[block].count;
+        releaseBlock(block);
+        ++released_range_count;
+    }
+    return released_range_count;
+}
+
+bool DescriptorRangeAllocator::isValid(DescriptorRange const& range) const
+{
+    if (range.block >= m_blocks.size()) return false;
+
+    Block const& b = m_blocks[range.block];
+    return b.state == block_state::allocated && b.generation == range.generation
+        && b.offset == range.offset && b.count == range.count;
+}
+
+void DescriptorRangeAllocator::reset()
+{
+    // the block records are kept along with their generations, so that the handles issued before the reset get invalidated
+    for (Block& b : m_blocks)
+    {
+        ++b.generation;
+        b.state = block_state::unused;
+    }
+    std::fill(std::begin(m_free_list_heads), std::end(m_free_list_heads), c_null_block);
+    m_non_empty_size_classes = 0U;
+    m_unused_blocks_head = c_null_block;
+    for (uint32_t i = static_cast<uint32_t>(m_blocks.size()); i-- > 0;)
+    {
+        m_blocks[i].next_free = m_unused_blocks_head;
+        m_unused_blocks_head = i;
+    }
+    m_retired_ranges.clear();
+    m_allocated_count = 0U;
+    m_retired_count = 0U;
+
+    if (m_capacity == 0) return;
+
+    uint32_t block = acquireBlockRecord();
+    Block& b = m_blocks[block];
+    b.offset = 0U;
+    b.count = m_capacity;
+    b.previous_physical = c_null_block;
+    b.next_physical = c_null_block;
+    insertFreeBlock(block);
+}
+
+uint32_t DescriptorRangeAllocator::largestFreeRange() const
+{
+    if (!m_non_empty_size_classes) return 0U;
+
+    uint32_t rv{ 0U };
+    for (uint32_t b = m_free_list_heads[std::bit_width(m_non_empty_size_classes) - 1]; b != c_null_block; b = m_blocks[b].next_free)
+    {
+        rv = (std::max)(rv, m_blocks[b].count);
+    }
+    return rv;
+}
+
+size_t DescriptorRangeAllocator::freeRangeCount() const
+{
+    size_t rv{ 0U };
+    for (uint32_t head : m_free_list_heads)
+    {
+        for (uint32_t b = head; b != c_null_block; b = m_blocks[b].next_free) ++rv;
+    }
+    return rv;
+}
+
+uint32_t DescriptorRangeAllocator::floorSizeClass(uint32_t count)
+{
+    assert(count > 0);
+    return static_cast<uint32_t>(std::bit_width(count)) - 1U;
+}
+
+uint32_t DescriptorRangeAllocator::ceilSizeClass(uint32_t count)
+{
+    assert(count > 0);
+    return static_cast<uint32_t>(std::bit_width(count - 1U));
+}
+
+uint32_t DescriptorRangeAllocator::acquireBlockRecord()
+{
+    uint32_t block;
+    if (m_unused_blocks_head != c_null_block)
+    {
+        block = m_unused_blocks_head;
+        m_unused_blocks_head = m_blocks[block].next_free;
+    }
+    else
+    {
+        block = static_cast<uint32_t>(m_blocks.size());
+        m_blocks.push_back(Block{
+            .offset = 0U,
+            .count = 0U,
+            .generation = 0U,
+            .previous_physical = c_null_block,
+            .next_physical = c_null_block,
+            .previous_free = c_null_block,
+            .next_free = c_null_block,
+            .state = block_state::unused
+            });
+    }
+
+    Block& b = m_blocks[block];
+    b.previous_free = b.next_free = c_null_block;
+    b.state = block_state::free;
+    return block;
+}
+
+void DescriptorRangeAllocator::releaseBlockRecord(uint32_t block)
+{
+    Block& b = m_blocks[block];
+    ++b.generation;
+    b.state = block_state::unused;
+    b.next_free = m_unused_blocks_head;
+    m_unused_blocks_head = block;
+}
+
+void DescriptorRangeAllocator::insertFreeBlock(uint32_t block)
+{
+    Block& b = m_blocks[block];
+    uint32_t size_class = floorSizeClass(b.count);
+
+    b.state = block_state::free;
+    b.previous_free = c_null_block;
+    b.next_free = m_free_list_heads[size_class];
+    if (b.next_free != c_null_block) m_blocks[b.next_free].previous_free = block;
+    m_free_list_heads[size_class] = block;
+    m_non_empty_size_classes |= 1U << size_class;
+}
+
+void DescriptorRangeAllocator::removeFreeBlock(uint32_t block)
+{
+    Block& b = m_blocks[block];
+    assert(b.state == block_state::free);
+    uint32_t size_class = floorSizeClass(b.count);
+
+    if (b.previous_free != c_null_block) m_blocks[b.previous_free].next_free = b.next_free;
+    else m_free_list_heads[size_class] = b.next_free;
+    if (b.next_free != c_null_block) m_blocks[b.next_free].previous_free = b.previous_free;
+    if (m_free_list_heads[size_class] == c_null_block) m_non_empty_size_classes &= ~(1U << size_class);
+
+    b.previous_free = b.next_free = c_null_block;
+}
+
+void DescriptorRangeAllocator::releaseBlock(uint32_t block)
+{
+    assert(m_allocated_count >= m_blocks[block].count);
+    m_allocated_count -= m_blocks[block].count;
+
+    // each handle refers to a certain generation of the block, hence the handles of the released range become stale
+    ++m_blocks[block].generation;
+
+    uint32_t next = m_blocks[block].next_physical;
+    if (next != c_null_block && m_blocks[next].state == block_state::free)
+    {
+        removeFreeBlock(next);
+        m_blocks[block].count += m_blocks[next].count;
+        m_blocks[block].next_physical = m_blocks[next].next_physical;
+        if (m_blocks[next].next_physical != c_null_block) m_blocks[m_blocks[next].next_physical].previous_physical = block;
+        releaseBlockRecord(next);
+    }
+
+    uint32_t previous = m_blocks[block].previous_physical;
+    if (previous != c_null_block && m_blocks[previous].state == block_state::free)
+    {
+        removeFreeBlock(previous);
+        m_blocks[previous].count += m_blocks[block].count;
+        m_blocks[previous].next_physical = m_blocks[block].next_physical;
+        if (m_blocks[block].next_physical != c_null_block) m_blocks[m_blocks[block].next_physical].previous_physical = previous;
+        releaseBlockRecord(block);
+        block = previous;
+    }
+
+    insertFreeBlock(block);
+}
@@ -0,0 +1,115 @@
+#ifndef LEXGINE_CORE_DX_D3D12_DESCRIPTOR_RANGE_ALLOCATOR_H
+#define LEXGINE_CORE_DX_D3D12_DESCRIPTOR_RANGE_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace lexgine::core::dx::d3d12 {
+
+//! Handle of a range of descriptor slots allocated from a descriptor heap
+struct DescriptorRange final
+{
+    static constexpr uint32_t c_invalid_block = static_cast<uint32_t>(-1);
+
+    uint32_t offset;    //!< number of descriptor slots preceding the range in the heap
+    uint32_t count;    //!< number of descriptor slots in the range
+    uint32_t block;    //!< internal index of the allocator block backing the range
+    uint32_t generation;    //!< generation of the backing block at the moment of allocation, used to detect stale handles
+
+    bool isNull() const { return block == c_invalid_block; }
+};
+
+
+/*! Allocator of contiguous ranges of descriptor slots. It only hands out the slot indices, the descriptors are written by the owner of the heap. Free ranges
+ are kept in power-of-two size-class free lists, so that allocation and release are done in constant time, and the neighbouring
+ free ranges are coalesced on release. The ranges that may still be referenced by the GPU are retired with a fence value and
+ only become free once the fence is reported to have passed this value. Each handle carries generation of its backing block,
+ so that the use of a handle after its range has been released or the allocator has been reset is detected.
+ The allocator is not thread-safe
+*/
+class DescriptorRangeAllocator final
+{
+public:
+    explicit DescriptorRangeAllocator(uint32_t capacity);
+
+    //! allocates a range of 'count' descriptor slots. Returns null range if no free range of sufficient size is available
+    DescriptorRange allocate(uint32_t count);
+
+    //! releases the range immediately. Returns 'false' if the handle is stale, in which case nothing is released
+    bool free(DescriptorRange const& range);
+
+    /*! retires the range, which then gets released by the first call of releaseCompleted(...) with completed fence value not less than
+     'fence_value'. Retired range can neither be freed nor retired again. Returns 'false' if the handle is stale. Retirement is cheapest
+     when the fence values do not decrease
+    */
+    bool retire(DescriptorRange const& range, uint64_t fence_value);
+
+    //! releases the retired ranges with fence values not exceeding 'completed_fence_value'. Returns number of released ranges
+    size_t releaseCompleted(uint64_t completed_fence_value);
+
+    bool isValid(DescriptorRange const& range) const;    //! returns 'true' if the range is allocated and neither released nor retired
+
+    //! releases all ranges including the retired ones. All handles issued before the reset become stale
+    void reset();
+
+    uint32_t capacity() const { return m_capacity; }
+    uint32_t allocatedCount() const { return m_allocated_count; }    //! number of slots either allocated or retired
+    uint32_t retiredCount() const { return m_retired_count; }    //! number of slots waiting for their fences
+    uint32_t largestFreeRange() const;
+    size_t freeRangeCount() const;    //! number of free ranges, which is the measure of fragmentation
+
+private:
+    enum class block_state : uint8_t
+    {
+        free,
+        allocated,
+        retired,
+        unused    //!< block record is not backing any range and can be reused
+    };
+
+    struct Block
+    {
+        uint32_t offset;
+        uint32_t count;
+        uint32_t generation;
+        uint32_t previous_physical;    //!< block covering the slots right before this block
+        uint32_t next_physical;    //!< block covering the slots right after this block
+        uint32_t previous_free;    //!< links of the size-class free list (or of the list of unused blocks)
+        uint32_t next_free;
+        block_state state;
+    };
+
+    struct RetiredRange
+    {
+        uint32_t block;
+        uint64_t fence_value;
+    };
+
+    static constexpr uint32_t c_size_class_count = 32U;
+
+private:
+    static uint32_t floorSizeClass(uint32_t count);
+    static uint32_t ceilSizeClass(uint32_t count);
+
+    uint32_t acquireBlockRecord();
+    void releaseBlockRecord(uint32_t block);
+    void insertFreeBlock(uint32_t block);
+    void removeFreeBlock(uint32_t block);
+    void releaseBlock(uint32_t block);    //! marks the block free and coalesces it with its free neighbours
+
+private:
+    uint32_t const m_capacity;
+    std::vector<Block> m_blocks;
+    uint32_t m_free_list_heads[c_size_class_count];    //!< size class k holds the free blocks of size in range [2^k, 2^(k+1))
+    uint32_t m_non_empty_size_classes;    //!< bit k is set when the free list of size class k is not empty
+    uint32_t m_unused_blocks_head;
+    std::deque<RetiredRange> m_retired_ranges;
+    uint32_t m_allocated_count;
+    uint32_t m_retired_count;
+};
+
+}
+
+#endif
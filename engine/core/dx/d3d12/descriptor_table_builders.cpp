@@ -1,5 +1,6 @@
 #include "descriptor_table_builders.h"
 #include "engine/core/globals.h"
+#include "engine/core/exception.h"
 #include "engine/core/dx/d3d12/dx_resource_factory.h"
 
 #include "device.h"
@@ -15,6 +16,44 @@
 using namespace lexgine::core;
 using namespace lexgine::core::dx::d3d12;
 
+namespace {
+
+// the descriptors are hashed by their native representation and by the identifiers of the resources they refer to, which
+// unlike the addresses of the native resources are never reused after the resources are destroyed
+
+void combineDescriptorHash(misc::HashValue& hash, CBVDescriptor const& descriptor)
+{
+    D3D12_CONSTANT_BUFFER_VIEW_DESC native = descriptor.nativeDescriptor();
+    hash.combine(&native, sizeof(native));
+}
+
+void combineDescriptorHash(misc::HashValue& hash, SRVDescriptor const& descriptor)
+{
+    D3D12_SHADER_RESOURCE_VIEW_DESC native = descriptor.nativeDescriptor();
+    uint64_t const resource_id = descriptor.associatedResource().uniqueId();
+    hash.combine(&native, sizeof(native));
+    hash.combine(&resource_id, sizeof(resource_id));
+}
+
+void combineDescriptorHash(misc::HashValue& hash, UAVDescriptor const& descriptor)
+{
+    D3D12_UNORDERED_ACCESS_VIEW_DESC native = descriptor.nativeDescriptor();
+    uint64_t const resource_ids[] = {
+        descriptor.associatedResource().uniqueId(),
+        descriptor.associatedCounterResourcePtr() ? descriptor.associatedCounterResourcePtr()->uniqueId() : 0U
+    };
+    hash.combine(&native, sizeof(native));
+    hash.combine(resource_ids, sizeof(resource_ids));
+}
+
+void combineDescriptorHash(misc::HashValue& hash, SamplerDescriptor const& descriptor)
+{
+    D3D12_SAMPLER_DESC native = descriptor.nativeDescriptor();
+    hash.combine(&native, sizeof(native));
+}
+
+}
+
 ResourceViewDescriptorTableBuilder::ResourceViewDescriptorTableBuilder(Globals& globals, uint32_t target_descriptor_heap_page_id) :
     m_globals{ globals },
     m_target_descriptor_heap_page_id{ target_descriptor_heap_page_id },
@@ -81,39 +120,88 @@ DescriptorTable ResourceViewDescriptorTableBuilder::build() const
         }
     );
 
-    auto& target_descriptor_heap =
-        m_globals.get<DxResourceFactory>()->retrieveDescriptorHeap(*m_globals.get<Device>(),
-            DescriptorHeapType::cbv_srv_uav, m_target_descriptor_heap_page_id);
+    DxResourceFactory& dx_resource_factory = *m_globals.get<DxResourceFactory>();
+    auto& target_descriptor_heap = dx_resource_factory.retrieveDescriptorHeap(*m_globals.get<Device>(),
+        DescriptorHeapType::cbv_srv_uav, m_target_descriptor_heap_page_id);
 
-    DescriptorTable rv = target_descriptor_heap.allocateDescriptorTable(total_descriptor_count);
-    size_t offset = rv.offset;
+    if (!total_descriptor_count) return target_descriptor_heap.allocateDescriptorTable(0);
+
+    DescriptorCacheLookup lookup = dx_resource_factory.retrieveDescriptorCache(target_descriptor_heap).acquire(hash(), total_descriptor_count,
+        [this, &target_descriptor_heap](DescriptorRange const& range)
+        {
+            size_t offset = range.offset;
+            for (auto& footprint_range : m_descriptor_table_footprint)
+            {
+                switch (footprint_range.cache_type)
+                {
+                case descriptor_cache_type::cbv:
+                    target_descriptor_heap.createConstantBufferViewDescriptors(offset,
+                        std::vector<CBVDescriptor>{m_cbv_descriptors.begin() + footprint_range.start,
+                        m_cbv_descriptors.begin() + footprint_range.end});
+                    break;
+
+                case descriptor_cache_type::srv:
+                    target_descriptor_heap.createShaderResourceViewDescriptors(offset,
+                        std::vector<SRVDescriptor>{m_srv_descriptors.begin() + footprint_range.start,
+                        m_srv_descriptors.begin() + footprint_range.end});
+                    break;
+
+                case descriptor_cache_type::uav:
+                    target_descriptor_heap.createUnorderedAccessViewDescriptors(offset,
+                        std::vector<UAVDescriptor>{m_uav_descriptors.begin() + footprint_range.start,
+                        m_uav_descriptors.begin() + footprint_range.end});
+                    break;
+                }
+                offset += footprint_range.end - footprint_range.start;
+            }
+        });
+
+    if (lookup.range.isNull())
+    {
+        LEXGINE_THROW_ERROR("Unable to allocate " + std::to_string(total_descriptor_count) + " descriptors from descriptor heap \""
+            + target_descriptor_heap.getStringName() + "\": the descriptor heap is exhausted");
+    }
+
+    return target_descriptor_heap.getDescriptorTable(lookup.range);
+}
+
+void ResourceViewDescriptorTableBuilder::release() const
+{
+    if (m_descriptor_table_footprint.empty()) return;
+
+    DxResourceFactory& dx_resource_factory = *m_globals.get<DxResourceFactory>();
+    auto& target_descriptor_heap = dx_resource_factory.retrieveDescriptorHeap(*m_globals.get<Device>(),
+        DescriptorHeapType::cbv_srv_uav, m_target_descriptor_heap_page_id);
+    dx_resource_factory.retrieveDescriptorCache(target_descriptor_heap).release(hash());
+}
+
+misc::HashValue ResourceViewDescriptorTableBuilder::hash() const
+{
+    // the layout of the table is hashed along with the descriptors, so that CBV, SRV and UAV with coinciding native representations are told apart
+    misc::HashValue rv{ nullptr, 0U };
     for (auto& range : m_descriptor_table_footprint)
     {
-        switch (range.cache_type)
+        size_t const range_layout[] = { static_cast<size_t>(range.cache_type), range.end - range.start };
+        rv.combine(range_layout, sizeof(range_layout));
+
+        for (size_t i = range.start; i < range.end; ++i)
         {
-        case descriptor_cache_type::cbv:
-            target_descriptor_heap.createConstantBufferViewDescriptors(offset,
-                std::vector<CBVDescriptor>{m_cbv_descriptors.begin() + range.start,
-                m_cbv_descriptors.begin() + range.end});
-            offset += static_cast<uint32_t>(range.end - range.start);
-            break;
-
-        case descriptor_cache_type::srv:
-            target_descriptor_heap.createShaderResourceViewDescriptors(offset,
-                std::vector<SRVDescriptor>{m_srv_descriptors.begin() + range.start,
-                m_srv_descriptors.begin() + range.end});
-            offset += static_cast<uint32_t>(range.end - range.start);
-            break;
-
-        case descriptor_cache_type::uav:
-            target_descriptor_heap.createUnorderedAccessViewDescriptors(offset,
-                std::vector<UAVDescriptor>{m_uav_descriptors.begin() + range.start,
-                m_uav_descriptors.begin() + range.end});
-            offset += static_cast<uint32_t>(range.end - range.start);
-            break;
+            switch (range.cache_type)
+            {
+            case descriptor_cache_type::cbv:
+                combineDescriptorHash(rv, m_cbv_descriptors[i]);
+                break;
+
+            case descriptor_cache_type::srv:
+                combineDescriptorHash(rv, m_srv_descriptors[i]);
+                break;
+
+            case descriptor_cache_type::uav:
+                combineDescriptorHash(rv, m_uav_descriptors[i]);
+                break;
+            }
         }
     }
-
     return rv;
 }
 
@@ -130,13 +218,45 @@ void SamplerDescriptorTableBuilder::addDescriptor(SamplerDescriptor const& descr
 
 DescriptorTable SamplerDescriptorTableBuilder::build() const
 {
-    auto& target_descriptor_heap = m_globals.get<DxResourceFactory>()->retrieveDescriptorHeap(
+    DxResourceFactory& dx_resource_factory = *m_globals.get<DxResourceFactory>();
+    auto& target_descriptor_heap = dx_resource_factory.retrieveDescriptorHeap(
         *m_globals.get<Device>(), DescriptorHeapType::sampler, m_target_descriptor_heap_page_id);
 
-    DescriptorTable rv = target_descriptor_heap.allocateDescriptorTable(static_cast<uint32_t>(m_sampler_descriptors.size()));
-    size_t offset = rv.offset;
-    target_descriptor_heap.createSamplerDescriptors(offset, m_sampler_descriptors);
+    if (m_sampler_descriptors.empty()) return target_descriptor_heap.allocateDescriptorTable(0);
+
+    uint32_t const descriptor_count = static_cast<uint32_t>(m_sampler_descriptors.size());
+    DescriptorCacheLookup lookup = dx_resource_factory.retrieveDescriptorCache(target_descriptor_heap).acquire(hash(), descriptor_count,
+        [this, &target_descriptor_heap](DescriptorRange const& range)
+        {
+            target_descriptor_heap.createSamplerDescriptors(range.offset, m_sampler_descriptors);
+        });
+
+    if (lookup.range.isNull())
+    {
+        LEXGINE_THROW_ERROR("Unable to allocate " + std::to_string(descriptor_count) + " descriptors from descriptor heap \""
+            + target_descriptor_heap.getStringName() + "\": the descriptor heap is exhausted");
+    }
+
+    return target_descriptor_heap.getDescriptorTable(lookup.range);
+}
+
+void SamplerDescriptorTableBuilder::release() const
+{
+    if (m_sampler_descriptors.empty()) return;
 
+    DxResourceFactory& dx_resource_factory = *m_globals.get<DxResourceFactory>();
+    auto& target_descriptor_heap = dx_resource_factory.retrieveDescriptorHeap(
+        *m_globals.get<Device>(), DescriptorHeapType::sampler, m_target_descriptor_heap_page_id);
+    dx_resource_factory.retrieveDescriptorCache(target_descriptor_heap).release(hash());
+}
+
+misc::HashValue SamplerDescriptorTableBuilder::hash() const
+{
+    misc::HashValue rv{ nullptr, 0U };
+    for (SamplerDescriptor const& descriptor : m_sampler_descriptors)
+    {
+        combineDescriptorHash(rv, descriptor);
+    }
     return rv;
 }
 
@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "engine/core/lexgine_core_fwd.h"
+#include "engine/core/misc/hash_value.h"
 #include "lexgine_core_dx_d3d12_fwd.h"
 #include "engine/core/dx/d3d12/srv_descriptor.h"
 #include "engine/core/dx/d3d12/uav_descriptor.h"
@@ -24,8 +25,16 @@ public:
     void addDescriptor(SRVDescriptor const& descriptor);
     void addDescriptor(UAVDescriptor const& descriptor);
     
+    /*! Returns descriptor table containing the added descriptors. The tables are shared through the descriptor cache of the target heap,
+     so that building a table identical to one that is still alive reuses the existing table instead of creating the descriptors anew.
+     Each call of build() must be matched by a call of release() once the table is no longer used
+    */
     DescriptorTable build() const;
 
+    void release() const;    //! drops the reference to the shared descriptor table acquired by build()
+
+    misc::HashValue hash() const;    //! returns hash of the content of the descriptor table
+
 private:
     enum class descriptor_cache_type
     {
@@ -67,8 +76,13 @@ public:
 
     void addDescriptor(SamplerDescriptor const& descriptor);
 
+    //! returns shared descriptor table containing the added samplers. Each call must be matched by a call of release()
     DescriptorTable build() const;
 
+    void release() const;    //! drops the reference to the shared descriptor table acquired by build()
+
+    misc::HashValue hash() const;    //! returns hash of the content of the descriptor table
+
 private:
     Globals& m_globals;
     uint32_t m_target_descriptor_heap_page_id;
@@ -408,7 +408,7 @@ ComPtr<ID3D12RootSignature> Device::createRootSignature(lexgine::core::D3DDataBl
     return m_rs_cache.findOrCreate(*this, root_signature_friendly_name, node_mask, serialized_root_signature);
 }
 
-ComPtr<ID3D12RootSignature> Device::retrieveRootSignature(std::string const& root_signature_friendly_name, uint32_t node_mask)
+ComPtr<ID3D12RootSignature> Device::retrieveRootSignature(std::string_view root_signature_friendly_name, uint32_t node_mask)
 {
     return m_rs_cache.find(root_signature_friendly_name, node_mask);
 }
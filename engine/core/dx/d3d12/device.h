@@ -21,6 +21,7 @@
 #include "command_queue.h"
 #include "command_allocator_ring.h"
 #include "frame_progress_tracker.h"
+#include "resource_state_tracker.h"
 #include "engine/core/misc/flags.h"
 
 
@@ -354,7 +355,7 @@ public:
     void setStringName(std::string const& entity_string_name) override;	//! sets new user-friendly string name for the Direct3D 12 device
 
     ComPtr<ID3D12RootSignature> createRootSignature(D3DDataBlob const& serialized_root_signature, std::string const& root_signature_friendly_name, uint32_t node_mask = 1);    //! creates native Direct3D 12 root signature interface based on serialized root signature data
-    ComPtr<ID3D12RootSignature> retrieveRootSignature(std::string const& root_signature_friendly_name, uint32_t node_mask = 1);
+    ComPtr<ID3D12RootSignature> retrieveRootSignature(std::string_view root_signature_friendly_name, uint32_t node_mask = 1);
 
     Fence createFence(FenceSharing sharing = FenceSharing::none);    //! creates synchronization fence
 
@@ -388,6 +389,11 @@ public:
 
     QueryCache* queryCache() const { return m_query_cache.get(); }
 
+    /*! returns states, in which the resources are left by the command lists submitted to the queues of the device. The registry is keyed
+     by the unique identifiers of the native resources, so the records of the destroyed resources are never matched by the new ones
+    */
+    ResourceStateRegistry& resourceStateRegistry() { return m_resource_state_registry; }
+
     Device(Device const&) = delete;
     Device(Device&&) = delete;
 
@@ -414,6 +420,7 @@ private:
     std::unique_ptr<QueryCache> m_query_cache;    //!< cache structure containing device query data
 
     uint32_t m_max_frames_in_flight;
+    ResourceStateRegistry m_resource_state_registry;    //!< must outlive the command queues
     CommandQueue m_default_command_queue;
     CommandQueue m_async_command_queue;
     CommandQueue m_copy_command_queue;
@@ -28,6 +28,7 @@ DxResourceFactory::DxResourceFactory(GlobalSettings const& global_settings,
     for (auto& adapter : m_hw_adapter_enumerator)
     {
         Device& dev_ref = adapter->device();
+        m_completed_frames_counts[&dev_ref].store(0U, std::memory_order_relaxed);
 
         uint32_t node_mask = 1;
 
@@ -47,10 +48,11 @@ DxResourceFactory::DxResourceFactory(GlobalSettings const& global_settings,
 				new_descriptor_heap_ref->setStringName(
                     dev_ref.getStringName() + "__cbv_srv_uav#" + std::to_string(i)
                 );
+                createDescriptorCache(dev_ref, *new_descriptor_heap_ref);
 				m_unordered_descriptor_allocators.emplace(
 					std::piecewise_construct,
 					std::forward_as_tuple(new_descriptor_heap_ref.get()),
-					std::forward_as_tuple(*new_descriptor_heap_ref)
+					std::forward_as_tuple(*new_descriptor_heap_ref, *m_descriptor_caches.at(new_descriptor_heap_ref.get()))
 				);
 			}
 
@@ -64,6 +66,7 @@ DxResourceFactory::DxResourceFactory(GlobalSettings const& global_settings,
                 new_descriptor_heap_ref->setStringName(
                     dev_ref.getStringName() + "__sampler#" + std::to_string(i)
                 );
+                createDescriptorCache(dev_ref, *new_descriptor_heap_ref);
             }
 		}
         pool.rtv_heap = dev_ref.createDescriptorHeap(
@@ -126,11 +129,53 @@ DescriptorHeap& DxResourceFactory::retrieveDescriptorHeap(Device const& device,
     }
 }
 
+void DxResourceFactory::releaseRetiredDescriptors(Device const& device, uint64_t completed_frames_count)
+{
+    m_completed_frames_counts.at(&device).store(completed_frames_count, std::memory_order_release);
+
+    descriptor_heap_pool& pool = m_descriptor_heaps[&device];
+    for (auto& heap : pool.cbv_srv_uav_heaps) heap->releaseRetiredDescriptorRanges(completed_frames_count);
+    for (auto& heap : pool.sampler_heaps) heap->releaseRetiredDescriptorRanges(completed_frames_count);
+    pool.rtv_heap->releaseRetiredDescriptorRanges(completed_frames_count);
+    pool.dsv_heap->releaseRetiredDescriptorRanges(completed_frames_count);
+}
+
+DescriptorCache& DxResourceFactory::retrieveDescriptorCache(DescriptorHeap const& descriptor_heap)
+{
+    return *m_descriptor_caches.at(&descriptor_heap);
+}
+
 Heap& DxResourceFactory::retrieveUploadHeap(Device const& device)
 {
     return m_upload_heaps.at(&device);
 }
 
+void DxResourceFactory::createDescriptorCache(Device const& device, DescriptorHeap& descriptor_heap)
+{
+    // the evicted descriptors may still be referenced by the frames in flight, including the frame being recorded
+    uint64_t const retirement_latency = m_global_settings.getMaxFramesInFlight() + 1;
+    std::atomic_uint64_t const& completed_frames_count = m_completed_frames_counts.at(&device);
+
+    m_descriptor_caches.emplace(&descriptor_heap, std::make_unique<DescriptorCache>(
+        [&descriptor_heap, &completed_frames_count](uint32_t descriptor_count)
+        {
+            DescriptorRange rv = descriptor_heap.tryAllocateDescriptorRange(descriptor_count);
+            if (rv.isNull())
+            {
+                // the ranges retired since the last frame boundary may have already been completed, which is cheaper to check than to evict
+                descriptor_heap.releaseRetiredDescriptorRanges(completed_frames_count.load(std::memory_order_acquire));
+                rv = descriptor_heap.tryAllocateDescriptorRange(descriptor_count);
+            }
+            return rv;
+        },
+        [&descriptor_heap, &completed_frames_count, retirement_latency](DescriptorRange const& range)
+        {
+            descriptor_heap.retireDescriptorRange(range, completed_frames_count.load(std::memory_order_acquire) + retirement_latency);
+            return false;
+        },
+        descriptor_heap.capacity() / c_descriptor_cache_budget_divisor));
+}
+
 UnorderedSRVTableAllocationManager& DxResourceFactory::retrieveBindlessSRVAllocationManager(DescriptorHeap const& descriptor_heap)
 {
     return m_unordered_descriptor_allocators.at(&descriptor_heap);
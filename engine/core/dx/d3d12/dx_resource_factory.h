@@ -1,6 +1,7 @@
 #ifndef LEXGINE_CORE_DX_D3D12_DX_RESOURCE_FACTORY_H
 #define LEXGINE_CORE_DX_D3D12_DX_RESOURCE_FACTORY_H
 
+#include <atomic>
 #include <vector>
 #include <unordered_map>
 #include <array>
@@ -9,6 +10,7 @@
 #include "engine/core/dx/dxgi/hw_adapter_enumerator.h"
 #include "engine/core/dx/d3d12/d3d12_tools.h"
 #include "engine/core/dx/d3d12/upload_buffer_allocator.h"
+#include "engine/core/dx/d3d12/descriptor_cache.h"
 #include "engine/core/dx/dxcompilation/dx_compiler_proxy.h"
 #include "engine/core/misc/hashed_string.h"
 #include "lexgine_core_dx_d3d12_fwd.h"
@@ -46,6 +48,16 @@ public:
     Heap& retrieveUploadHeap(Device const& device);
     UnorderedSRVTableAllocationManager& retrieveBindlessSRVAllocationManager(DescriptorHeap const& descriptor_heap);
 
+    /*! Releases the descriptor ranges retired from the descriptor heaps of the given device, which are no longer used by the GPU.
+     The ranges must be retired with the count of frames that have to be completed before the GPU stops using them
+    */
+    void releaseRetiredDescriptors(Device const& device, uint64_t completed_frames_count);
+
+    /*! Returns content-addressed cache of descriptor tables shared by all users of the given CBV-SRV-UAV or sampler descriptor heap.
+     The ranges evicted from the cache are retired and only get reused after all frames, which could have referenced them, are completed
+    */
+    DescriptorCache& retrieveDescriptorCache(DescriptorHeap const& descriptor_heap);
+
     /*! Attempts to allocate a new named section in the given upload heap.
      Returns details of the new allocation in case of success or an empty misc::Optional<T>
      container if a section with the desired name already existed in the upload heap.
@@ -65,6 +77,12 @@ public:
     
     size_t getUploadHeapFreeSpace(Device const& owning_device) const;    //!< Returns size of unallocated space in the upload heap owned by given device
 
+private:
+    static constexpr uint32_t c_descriptor_cache_budget_divisor = 8U;    //!< unreferenced entries kept by a descriptor cache are limited by this fraction of the heap capacity
+
+private:
+    void createDescriptorCache(Device const& device, DescriptorHeap& descriptor_heap);
+
 private:
     struct descriptor_heap_pool
     {
@@ -88,7 +106,9 @@ private:
     std::unordered_map<Device const*, descriptor_heap_pool> m_descriptor_heaps;
     std::unordered_map<Device const*, Heap> m_upload_heaps;
     std::unordered_map<Heap const*, upload_heap_partitioning> m_upload_heap_partitions;
-    std::unordered_map<DescriptorHeap const*, UnorderedSRVTableAllocationManager> m_unordered_descriptor_allocators;
+    std::unordered_map<Device const*, std::atomic_uint64_t> m_completed_frames_counts;    //!< completed frame counts last reported to releaseRetiredDescriptors(...)
+    std::unordered_map<DescriptorHeap const*, std::unique_ptr<DescriptorCache>> m_descriptor_caches;    //!< must be destroyed before the descriptor heaps
+    std::unordered_map<DescriptorHeap const*, UnorderedSRVTableAllocationManager> m_unordered_descriptor_allocators;    //!< must be destroyed before the descriptor caches
 
     DxgiFormatFetcher const m_dxgiFormatFetcher;
     
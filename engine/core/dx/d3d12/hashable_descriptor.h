@@ -21,7 +21,7 @@ public:
     }
 
     HashableDescriptor(Resource const& resource, T const& native_ref)
-        : m_resource_ptr{ reinterpret_cast<uintptr_t>(resource.native().Get()) }
+        : m_resource_id{ resource.uniqueId() }
         , m_native_ref{ native_ref }
     {
 
@@ -30,7 +30,7 @@ public:
     misc::HashValue hash() const
     {
         misc::HashValue hash { &m_native_ref, sizeof(T) };
-        hash.combine(&m_resource_ptr, sizeof(uintptr_t));
+        hash.combine(&m_resource_id, sizeof(uint64_t));
         return hash;
     }
 
@@ -44,7 +44,7 @@ public:
 
         #ifdef _DEBUG
         assert((thisHash != otherHash 
-            || m_resource_ptr == other.m_resource_ptr
+            || m_resource_id == other.m_resource_id
             && std::equal(reinterpret_cast<uint8_t const*>(&m_native_ref), 
                 reinterpret_cast<uint8_t const*>(&m_native_ref) + sizeof(T), 
                 reinterpret_cast<uint8_t const*>(&other.m_native_ref))) && "Hash collision detected");
@@ -54,7 +54,7 @@ public:
     }
 
 private:
-    uintptr_t m_resource_ptr = 0;
+    uint64_t m_resource_id = 0;    //!< identifier of the native resource, which unlike its address is never reused
     T const& m_native_ref;
 };
 
@@ -1,6 +1,8 @@
 #include "heap_resource_placer.h"
 #include "device.h"
+#include "resource_barrier_pack.h"
 
+#include <algorithm>
 #include <cassert>
 
 using namespace lexgine::core::dx::d3d12;
@@ -15,18 +17,125 @@ HeapResourcePlacer::HeapResourcePlacer(Heap& heap) :
 
 PlacedResource HeapResourcePlacer::addResource(ResourceState const& initial_state, ResourceOptimizedClearValue const& optimized_clear_value, ResourceDescriptor const& descriptor)
 {
-    uint64_t resource_size = descriptor.getAllocationSize(m_heap.device(), m_heap.getExposureMask());
-    assert(resource_size <= m_heap.capacity() - m_current_offset);
+    ResourceAllocationInfo allocation_info = descriptor.getAllocationInfo(m_heap.device(), m_heap.getExposureMask());
+    uint64_t resource_offset = (m_current_offset + allocation_info.alignment - 1) & ~(allocation_info.alignment - 1);
+    assert(resource_offset <= m_heap.capacity() && allocation_info.size <= m_heap.capacity() - resource_offset);
 
-    PlacedResource rv{ m_heap, m_current_offset, initial_state, optimized_clear_value, descriptor };
-    m_current_offset += resource_size;
+    PlacedResource rv{ m_heap, resource_offset, initial_state, optimized_clear_value, descriptor };
+    m_current_offset = resource_offset + allocation_info.size;
 
     return rv;
 }
 
+PlacedResource HeapResourcePlacer::placeResource(uint64_t heap_offset, ResourceState const& initial_state,
+    misc::Optional<ResourceOptimizedClearValue> const& optimized_clear_value, ResourceDescriptor const& descriptor)
+{
+    ResourceAllocationInfo allocation_info = descriptor.getAllocationInfo(m_heap.device(), m_heap.getExposureMask());
+    assert(heap_offset % allocation_info.alignment == 0);
+    assert(heap_offset <= m_heap.capacity() && allocation_info.size <= m_heap.capacity() - heap_offset);
+
+    return PlacedResource{ m_heap, heap_offset, initial_state, optimized_clear_value, descriptor };
+}
+
 void HeapResourcePlacer::reset()
 {
     m_current_offset = 0;
 }
 
 
+TransientResourceAllocator::TransientResourceAllocator(Device& device, HeapCreationFlags heap_flags,
+    bool is_msaa_supported, uint32_t node_mask, uint32_t node_exposure_mask)
+    : m_device{ device }
+    , m_heap_flags{ heap_flags }
+    , m_is_msaa_supported{ is_msaa_supported }
+    , m_node_mask{ node_mask }
+    , m_node_exposure_mask{ node_exposure_mask }
+    , m_plan{ .heap_size = 0U, .unaliased_heap_size = 0U }
+{
+
+}
+
+uint32_t TransientResourceAllocator::declareResource(ResourceDescriptor const& descriptor, ResourceState const& initial_state,
+    misc::Optional<ResourceOptimizedClearValue> const& optimized_clear_value, uint32_t first_use, uint32_t last_use)
+{
+    ResourceAllocationInfo allocation_info = descriptor.getAllocationInfo(m_device, m_node_exposure_mask);
+    m_declarations.push_back(Declaration{ .descriptor = descriptor, .initial_state = initial_state, .optimized_clear_value = optimized_clear_value });
+    return m_planner.addResource(TransientResourceRequest{ .size = allocation_info.size, .alignment = allocation_info.alignment,
+        .first_use = first_use, .last_use = last_use });
+}
+
+void TransientResourceAllocator::build()
+{
+    releaseRetiredResources();
+
+    // the heap only grows, so that the transient resources of the subsequent frames can usually reuse it. The new heap is
+    // created before anything gets retired, so that a failure leaves the previous build intact
+    m_plan = m_planner.plan();
+    std::unique_ptr<Heap> new_heap{};
+    if (!m_declarations.empty() && (!m_heap || m_heap->capacity() < m_plan.heap_size))
+    {
+        new_heap = std::make_unique<Heap>(m_device.createHeap(AbstractHeapType::_default, m_plan.heap_size,
+            m_heap_flags, m_is_msaa_supported, m_node_mask, m_node_exposure_mask));
+    }
+
+    // the resources of the previous build may still be used by the frames in flight including the one being recorded
+    FrameProgressTracker const& frame_progress_tracker = m_device.frameProgressTracker();
+    RetiredBuild retired_build{ .completion_frames_count = frame_progress_tracker.currentFrameIndex() + 1,
+        .heap = new_heap ? std::move(m_heap) : nullptr, .resources = std::move(m_resources) };
+    m_resources.clear();
+    if (new_heap) m_heap = std::move(new_heap);
+
+    if (!retired_build.resources.empty() || retired_build.heap)
+    {
+        m_retired_builds.push_back(std::move(retired_build));
+    }
+
+    if (m_declarations.empty())
+    {
+        // heaps cannot be empty, and the heap of the previous builds is kept for the future ones
+        return;
+    }
+
+    HeapResourcePlacer placer{ *m_heap };
+    m_resources.reserve(m_declarations.size());
+    for (size_t i = 0; i < m_declarations.size(); ++i)
+    {
+        Declaration const& declaration = m_declarations[i];
+        m_resources.push_back(placer.placeResource(m_plan.offsets[i], declaration.initial_state,
+            declaration.optimized_clear_value, declaration.descriptor));
+    }
+}
+
+void TransientResourceAllocator::releaseRetiredResources()
+{
+    uint64_t const completed_frames_count = m_device.frameProgressTracker().completedFramesCount();
+    while (!m_retired_builds.empty() && m_retired_builds.front().completion_frames_count <= completed_frames_count)
+    {
+        m_retired_builds.pop_front();
+    }
+}
+
+PlacedResource const& TransientResourceAllocator::resource(uint32_t resource_id) const
+{
+    assert(resource_id < m_resources.size());
+    return m_resources[resource_id];
+}
+
+void TransientResourceAllocator::addAliasingBarriers(uint32_t use_index, ResourceBarrierPack& barrier_pack) const
+{
+    auto p = std::lower_bound(m_plan.barriers.begin(), m_plan.barriers.end(), use_index,
+        [](TransientAliasingBarrier const& e, uint32_t value) { return e.use_index < value; });
+    for (; p != m_plan.barriers.end() && p->use_index == use_index; ++p)
+    {
+        PlacedResource const* p_resource_before = p->resource_before == TransientAliasingBarrier::c_any_resource
+            ? nullptr : &m_resources[p->resource_before];
+        barrier_pack.addAliasingBarrier(p_resource_before, &m_resources[p->resource_after]);
+    }
+}
+
+void TransientResourceAllocator::reset()
+{
+    m_planner.clear();
+    m_declarations.clear();
+    m_plan = TransientAliasingPlan{ .heap_size = 0U, .unaliased_heap_size = 0U };
+}
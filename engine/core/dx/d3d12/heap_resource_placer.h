@@ -1,9 +1,14 @@
 #ifndef LEXGINE_CORE_DX_D3D12_HEAP_RESOURCE_PLACER_H
 #define LEXGINE_CORE_DX_D3D12_HEAP_RESOURCE_PLACER_H
 
+#include "lexgine_core_dx_d3d12_fwd.h"
 #include "resource.h"
+#include "transient_resource_aliasing_planner.h"
 
+#include <deque>
 #include <list>
+#include <memory>
+#include <vector>
 
 namespace lexgine::core::dx::d3d12 {
 
@@ -17,9 +22,13 @@ public:
     HeapResourcePlacer(HeapResourcePlacer const&) = delete;
     HeapResourcePlacer(HeapResourcePlacer&&) = default;
 
-    //! adds new resource to the heap and moves the current allocation offset caret accordingly
+    //! adds new resource to the heap at the next suitably aligned offset and moves the current allocation offset caret accordingly
     PlacedResource addResource(ResourceState const& initial_state, ResourceOptimizedClearValue const& optimized_clear_value, ResourceDescriptor const& descriptor);
 
+    //! places resource at the given offset without moving the allocation caret. The offset must satisfy the placement alignment of the resource
+    PlacedResource placeResource(uint64_t heap_offset, ResourceState const& initial_state,
+        misc::Optional<ResourceOptimizedClearValue> const& optimized_clear_value, ResourceDescriptor const& descriptor);
+
     //! resets heap allocation caret to zero. Could be used for resource aliasing
     void reset();
 
@@ -30,6 +39,75 @@ private:
 };
 
 
+/*! Allocates transient resources, which are only used within a frame, from a single heap, so that the resources with
+ non-overlapping lifetimes alias each other in memory. The resources are declared along with the indices of their first
+ and last uses within the frame, after which build() packs them using TransientResourceAliasingPlanner, (re-)creates
+ the heap if it is too small and places the resources. The aliasing barriers required by the plan must be recorded before
+ the corresponding uses by addAliasingBarriers(...), and every aliased resource must be fully initialized by its first use
+*/
+class TransientResourceAllocator final
+{
+public:
+    TransientResourceAllocator(Device& device,
+        HeapCreationFlags heap_flags = HeapCreationFlags{ HeapCreationFlags::base_values::allow_only_rt_ds },
+        bool is_msaa_supported = false, uint32_t node_mask = 0, uint32_t node_exposure_mask = 0);
+
+    TransientResourceAllocator(TransientResourceAllocator const&) = delete;
+    TransientResourceAllocator(TransientResourceAllocator&&) = default;
+
+    //! declares transient resource used by the frame between the given uses (inclusive) and returns its identifier
+    uint32_t declareResource(ResourceDescriptor const& descriptor, ResourceState const& initial_state,
+        misc::Optional<ResourceOptimizedClearValue> const& optimized_clear_value, uint32_t first_use, uint32_t last_use);
+
+    /*! packs the declared resources and creates them in the heap. The resources of the previous build and the heap, if it has to grow,
+     are retired until the GPU completes the frame being recorded. Building an empty frame only retires the resources of the previous build. THROWS
+    */
+    void build();
+
+    void releaseRetiredResources();    //! releases the resources and the heaps retired by the previous builds, which the GPU no longer uses
+
+    PlacedResource const& resource(uint32_t resource_id) const;    //! returns resource created by the last build()
+
+    //! adds aliasing barriers, which must precede the given use of the resources
+    void addAliasingBarriers(uint32_t use_index, ResourceBarrierPack& barrier_pack) const;
+
+    TransientAliasingPlan const& plan() const { return m_plan; }
+
+    Heap const* heap() const { return m_heap.get(); }
+
+    void reset();    //! forgets the declared resources. The heap and the resources of the last build are kept until the next build
+
+private:
+    struct Declaration
+    {
+        ResourceDescriptor descriptor;
+        ResourceState initial_state;
+        misc::Optional<ResourceOptimizedClearValue> optimized_clear_value;
+    };
+
+    struct RetiredBuild
+    {
+        uint64_t completion_frames_count;    //!< count of the completed frames, after which the GPU no longer uses the build
+        std::unique_ptr<Heap> heap;    //!< nullptr if the heap has been kept for the subsequent builds
+        std::vector<PlacedResource> resources;    //!< declared after the heap, so that the resources are released ahead of it
+    };
+
+private:
+    Device& m_device;
+    HeapCreationFlags m_heap_flags;
+    bool m_is_msaa_supported;
+    uint32_t m_node_mask;
+    uint32_t m_node_exposure_mask;
+
+    TransientResourceAliasingPlanner m_planner;
+    std::vector<Declaration> m_declarations;
+    TransientAliasingPlan m_plan;
+    std::unique_ptr<Heap> m_heap;
+    std::vector<PlacedResource> m_resources;    //!< resources placed by the last build in the order of declaration
+    std::deque<RetiredBuild> m_retired_builds;    //!< in the order of retirement
+};
+
+
 }
 
 #endif
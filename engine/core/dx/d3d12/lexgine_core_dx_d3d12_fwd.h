@@ -11,10 +11,12 @@ class DebugInterface;
 class CommandAllocatorRing;
 class CommandList;
 class CommandQueue;
+class CommandStream;
 class ConstantBuffer;
 class ConstantBufferReflection;
 class ConstantBufferDataWriter;
 class ConstantBufferDataMapper;
+class ConstantDataCache;
 class D3D12PSOXMLParser;
 class DebugInterface;
 class DescriptorHeap;
@@ -25,6 +27,7 @@ class DxResourceFactory;
 class Fence;
 class Heap;
 class ResourceDataUploader;
+class ResourceUploadPlanner;
 class HeapResourcePlacer;
 struct GraphicsPSODescriptor;
 struct ComputePSODescriptor;
@@ -0,0 +1,349 @@
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <unordered_map>
+
+#include "engine/core/exception.h"
+#include "render_graph.h"
+
+using namespace lexgine::core::dx::d3d12;
+
+namespace {
+
+using state_base_values = ResourceState::base_values;
+
+constexpr uint32_t c_none = static_cast<uint32_t>(-1);
+constexpr size_t c_queue_count = 3U;
+
+int const c_compute_queue_states = static_cast<int>(state_base_values::vertex_and_constant_buffer)
+    | static_cast<int>(state_base_values::unordered_access)
+    | static_cast<int>(state_base_values::non_pixel_shader)
+    | static_cast<int>(state_base_values::indirect_argument)
+    | static_cast<int>(state_base_values::copy_source)
+    | static_cast<int>(state_base_values::copy_destination);
+
+int const c_copy_queue_states = static_cast<int>(state_base_values::copy_source)
+    | static_cast<int>(state_base_values::copy_destination);
+
+//! returns 'true' if the command lists of the queue are able to access the resource in the given state and to transition it to and from this state
+bool isStateSupported(ResourceState state, RenderGraphQueue queue)
+{
+    switch (queue)
+    {
+    case RenderGraphQueue::compute:
+        return (state.getValue() & ~c_compute_queue_states) == 0;
+    case RenderGraphQueue::copy:
+        return (state.getValue() & ~c_copy_queue_states) == 0;
+    default:
+        return true;
+    }
+}
+
+uint64_t versionKey(uint32_t resource, uint32_t writer_pass)
+{
+    return (static_cast<uint64_t>(resource) << 32) | writer_pass;
+}
+
+}
+
+
+uint32_t RenderGraph::createResource(std::string const& name, ResourceState initial_state)
+{
+    m_resources.push_back(ResourceDeclaration{ .name = name, .is_imported = false, .initial_state = initial_state, .final_state = initial_state });
+    return static_cast<uint32_t>(m_resources.size() - 1);
+}
+
+uint32_t RenderGraph::importResource(std::string const& name, ResourceState initial_state, ResourceState final_state)
+{
+    m_resources.push_back(ResourceDeclaration{ .name = name, .is_imported = true, .initial_state = initial_state, .final_state = final_state });
+    return static_cast<uint32_t>(m_resources.size() - 1);
+}
+
+uint32_t RenderGraph::addPass(std::string const& name, RenderGraphQueue queue, bool has_side_effects)
+{
+    m_passes.push_back(PassDeclaration{ .name = name, .queue = queue, .has_side_effects = has_side_effects, .accesses = {} });
+    return static_cast<uint32_t>(m_passes.size() - 1);
+}
+
+void RenderGraph::addRead(uint32_t pass, uint32_t resource, ResourceState state)
+{
+    addAccess(pass, resource, state, false);
+}
+
+void RenderGraph::addWrite(uint32_t pass, uint32_t resource, ResourceState state)
+{
+    addAccess(pass, resource, state, true);
+}
+
+CompiledRenderGraph RenderGraph::compile(bool is_async_work_enabled) const
+{
+    uint32_t const pass_count = static_cast<uint32_t>(m_passes.size());
+    uint32_t const resource_count = static_cast<uint32_t>(m_resources.size());
+    CompiledRenderGraph rv{};
+
+    // the pass is needed if it has side effects, writes an imported resource or produces contents read by another needed pass
+    std::vector<std::vector<uint32_t>> producers(pass_count);
+    {
+        std::vector<uint32_t> last_writers(resource_count, c_none);
+        for (uint32_t p = 0; p < pass_count; ++p)
+        {
+            for (Access const& a : m_passes[p].accesses)
+            {
+                if (!a.is_read) continue;
+
+                if (last_writers[a.resource] != c_none) producers[p].push_back(last_writers[a.resource]);
+                else if (!m_resources[a.resource].is_imported)
+                {
+                    LEXGINE_THROW_ERROR("Pass \"" + m_passes[p].name + "\" reads transient resource \""
+                        + m_resources[a.resource].name + "\" before it has been written");
+                }
+            }
+
+            for (Access const& a : m_passes[p].accesses)
+            {
+                if (a.is_write) last_writers[a.resource] = p;
+            }
+        }
+    }
+
+    std::vector<bool> is_alive(pass_count, false);
+    for (uint32_t p = pass_count; p-- > 0;)
+    {
+        PassDeclaration const& pass = m_passes[p];
+        is_alive[p] = is_alive[p] || pass.has_side_effects
+            || std::any_of(pass.accesses.begin(), pass.accesses.end(),
+                [this](Access const& a) { return a.is_write && m_resources[a.resource].is_imported; });
+
+        if (!is_alive[p])
+        {
+            rv.culled_passes.push_back(p);
+            continue;
+        }
+
+        for (uint32_t producer : producers[p]) is_alive[producer] = true;
+    }
+    std::reverse(rv.culled_passes.begin(), rv.culled_passes.end());
+
+    // all passes reading the same version of a resource get it in the combination of their read states
+    std::unordered_map<uint64_t, ResourceState> read_states{};
+    {
+        std::vector<uint32_t> last_writers(resource_count, c_none);
+        for (uint32_t p = 0; p < pass_count; ++p)
+        {
+            if (!is_alive[p]) continue;
+
+            for (Access const& a : m_passes[p].accesses)
+            {
+                if (a.is_write) continue;
+
+                ResourceState& state = read_states.try_emplace(versionKey(a.resource, last_writers[a.resource]), ResourceState{}).first->second;
+                state = ResourceState{ state.getValue() | a.state.getValue() };
+            }
+
+            for (Access const& a : m_passes[p].accesses)
+            {
+                if (a.is_write) last_writers[a.resource] = p;
+            }
+        }
+    }
+
+    // transitions and dependencies of the compiled passes
+    struct ResourceTracking
+    {
+        ResourceState state;
+        uint32_t version_writer;    //!< declared pass that has written the current contents
+        uint32_t last_modifier;    //!< compiled pass that has last written or transitioned the resource
+        std::vector<uint32_t> readers;    //!< compiled passes that have read the resource since the last modification
+        uint32_t first_use;
+        uint32_t last_use;
+    };
+
+    std::vector<ResourceTracking> tracking(resource_count);
+    for (uint32_t r = 0; r < resource_count; ++r)
+    {
+        tracking[r] = ResourceTracking{ .state = m_resources[r].initial_state, .version_writer = c_none, .last_modifier = c_none,
+            .readers = {}, .first_use = c_none, .last_use = c_none };
+    }
+
+    std::vector<std::vector<uint32_t>> dependencies{};
+    auto add_compiled_pass = [&rv, &dependencies](uint32_t pass, RenderGraphQueue queue)
+    {
+        rv.passes.push_back(CompiledRenderGraphPass{ .pass = pass, .queue = queue, .barriers = {}, .waits = {}, .is_signaling = false });
+        dependencies.emplace_back();
+        return static_cast<uint32_t>(rv.passes.size() - 1);
+    };
+
+    auto modify_resource = [&tracking, &dependencies](uint32_t resource, uint32_t compiled_pass)
+    {
+        ResourceTracking& t = tracking[resource];
+        if (t.last_modifier != c_none) dependencies[compiled_pass].push_back(t.last_modifier);
+        dependencies[compiled_pass].insert(dependencies[compiled_pass].end(), t.readers.begin(), t.readers.end());
+        t.last_modifier = compiled_pass;
+        t.readers.clear();
+        if (t.first_use == c_none) t.first_use = compiled_pass;
+        t.last_use = compiled_pass;
+    };
+
+    auto read_resource = [&tracking, &dependencies](uint32_t resource, uint32_t compiled_pass)
+    {
+        ResourceTracking& t = tracking[resource];
+        if (t.last_modifier != c_none) dependencies[compiled_pass].push_back(t.last_modifier);
+        t.readers.push_back(compiled_pass);
+        if (t.first_use == c_none) t.first_use = compiled_pass;
+        t.last_use = compiled_pass;
+    };
+
+    std::vector<RenderGraphBarrier> barriers{};
+    std::vector<RenderGraphBarrier> direct_queue_barriers{};
+    for (uint32_t p = 0; p < pass_count; ++p)
+    {
+        if (!is_alive[p]) continue;
+
+        PassDeclaration const& pass = m_passes[p];
+        RenderGraphQueue const queue = is_async_work_enabled ? pass.queue : RenderGraphQueue::direct;
+
+        barriers.clear();
+        direct_queue_barriers.clear();
+        for (Access const& a : pass.accesses)
+        {
+            if (!isStateSupported(a.state, queue))
+            {
+                LEXGINE_THROW_ERROR("Pass \"" + pass.name + "\" requests resource \"" + m_resources[a.resource].name
+                    + "\" in a state not supported by the queue of the pass");
+            }
+
+            ResourceTracking const& t = tracking[a.resource];
+            ResourceState const target_state = a.is_write ? a.state : read_states.at(versionKey(a.resource, t.version_writer));
+            if (target_state == t.state) continue;
+
+            // e.g. compute queue cannot transition the resource out of the state, in which it has been used by graphics work
+            RenderGraphBarrier barrier{ .resource = a.resource, .state_before = t.state, .state_after = target_state };
+            if (isStateSupported(barrier.state_before, queue) && isStateSupported(barrier.state_after, queue)) barriers.push_back(barrier);
+            else direct_queue_barriers.push_back(barrier);
+        }
+
+        if (!direct_queue_barriers.empty())
+        {
+            uint32_t barrier_pass = add_compiled_pass(CompiledRenderGraphPass::c_barrier_only_pass, RenderGraphQueue::direct);
+            for (RenderGraphBarrier const& b : direct_queue_barriers)
+            {
+                modify_resource(b.resource, barrier_pass);
+                tracking[b.resource].state = b.state_after;
+            }
+            rv.passes[barrier_pass].barriers = direct_queue_barriers;
+        }
+
+        uint32_t compiled_pass = add_compiled_pass(p, queue);
+        for (Access const& a : pass.accesses)
+        {
+            bool is_transitioned = std::any_of(barriers.begin(), barriers.end(),
+                [&a](RenderGraphBarrier const& b) { return b.resource == a.resource; });
+
+            if (a.is_write || is_transitioned) modify_resource(a.resource, compiled_pass);
+            else read_resource(a.resource, compiled_pass);
+        }
+        for (RenderGraphBarrier const& b : barriers) tracking[b.resource].state = b.state_after;
+        for (Access const& a : pass.accesses)
+        {
+            if (a.is_write) tracking[a.resource].version_writer = p;
+        }
+        rv.passes[compiled_pass].barriers = barriers;
+    }
+
+    // the imported resources are returned to their final states after all other work of the frame
+    direct_queue_barriers.clear();
+    for (uint32_t r = 0; r < resource_count; ++r)
+    {
+        if (m_resources[r].is_imported && !(tracking[r].state == m_resources[r].final_state))
+        {
+            direct_queue_barriers.push_back(RenderGraphBarrier{ .resource = r, .state_before = tracking[r].state,
+                .state_after = m_resources[r].final_state });
+        }
+    }
+    if (!direct_queue_barriers.empty())
+    {
+        uint32_t barrier_pass = add_compiled_pass(CompiledRenderGraphPass::c_barrier_only_pass, RenderGraphQueue::direct);
+        for (RenderGraphBarrier const& b : direct_queue_barriers) modify_resource(b.resource, barrier_pass);
+        rv.passes[barrier_pass].barriers = direct_queue_barriers;
+    }
+
+    // the queues execute their passes in order, so that a wait also covers the earlier passes of the same queue
+    // and everything the awaited queue has already waited for itself
+    using known_completion_type = std::array<int64_t, c_queue_count>;
+    std::array<known_completion_type, c_queue_count> known_completions{};
+    for (known_completion_type& e : known_completions) e.fill(-1);
+    std::vector<known_completion_type> known_completions_after_pass(rv.passes.size());
+
+    for (uint32_t k = 0; k < static_cast<uint32_t>(rv.passes.size()); ++k)
+    {
+        CompiledRenderGraphPass& compiled_pass = rv.passes[k];
+        size_t const queue = static_cast<size_t>(compiled_pass.queue);
+        known_completion_type& known = known_completions[queue];
+
+        std::vector<uint32_t>& pass_dependencies = dependencies[k];
+        std::sort(pass_dependencies.begin(), pass_dependencies.end(), std::greater<uint32_t>{});
+        for (uint32_t d : pass_dependencies)
+        {
+            size_t const dependency_queue = static_cast<size_t>(rv.passes[d].queue);
+            if (dependency_queue == queue || known[dependency_queue] >= static_cast<int64_t>(d)) continue;
+
+            compiled_pass.waits.push_back(d);
+            rv.passes[d].is_signaling = true;
+            for (size_t i = 0; i < c_queue_count; ++i) known[i] = (std::max)(known[i], known_completions_after_pass[d][i]);
+        }
+        std::reverse(compiled_pass.waits.begin(), compiled_pass.waits.end());
+
+        known[queue] = k;
+        known_completions_after_pass[k] = known;
+    }
+
+    for (uint32_t r = 0; r < resource_count; ++r)
+    {
+        if (m_resources[r].is_imported || tracking[r].first_use == c_none) continue;
+
+        rv.transient_resource_lifetimes.push_back(RenderGraphResourceLifetime{ .resource = r,
+            .first_use = tracking[r].first_use, .last_use = tracking[r].last_use });
+    }
+
+    return rv;
+}
+
+void RenderGraph::clear()
+{
+    m_resources.clear();
+    m_passes.clear();
+}
+
+void RenderGraph::addAccess(uint32_t pass, uint32_t resource, ResourceState state, bool is_write)
+{
+    if (pass >= m_passes.size() || resource >= m_resources.size())
+    {
+        LEXGINE_THROW_ERROR("Invalid render graph pass or resource index");
+    }
+
+    std::vector<Access>& accesses = m_passes[pass].accesses;
+    auto p = std::find_if(accesses.begin(), accesses.end(), [resource](Access const& a) { return a.resource == resource; });
+    if (p == accesses.end())
+    {
+        accesses.push_back(Access{ .resource = resource, .state = state, .is_read = !is_write, .is_write = is_write });
+        return;
+    }
+
+    if (is_write)
+    {
+        if (p->is_write && !(p->state == state))
+        {
+            LEXGINE_THROW_ERROR("Pass \"" + m_passes[pass].name + "\" writes resource \"" + m_resources[resource].name
+                + "\" in two different states");
+        }
+
+        // the resource both read and written by the pass is accessed in the write state, e.g. as unordered access view
+        p->is_write = true;
+        p->state = state;
+    }
+    else
+    {
+        p->is_read = true;
+        if (!p->is_write) p->state = ResourceState{ p->state.getValue() | state.getValue() };
+    }
+}
@@ -0,0 +1,130 @@
+#ifndef LEXGINE_CORE_DX_D3D12_RENDER_GRAPH_H
+#define LEXGINE_CORE_DX_D3D12_RENDER_GRAPH_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "resource.h"
+
+namespace lexgine::core::dx::d3d12 {
+
+//! Hardware queue, on which a render graph pass is executed
+enum class RenderGraphQueue : uint32_t
+{
+    direct,
+    compute,
+    copy
+};
+
+//! Transition of a render graph resource
+struct RenderGraphBarrier final
+{
+    uint32_t resource;
+    ResourceState state_before;
+    ResourceState state_after;
+};
+
+//! Range of the compiled passes (inclusive), within which a transient resource is used
+struct RenderGraphResourceLifetime final
+{
+    uint32_t resource;
+    uint32_t first_use;
+    uint32_t last_use;
+};
+
+//! Pass of the compiled render graph
+struct CompiledRenderGraphPass final
+{
+    static constexpr uint32_t c_barrier_only_pass = static_cast<uint32_t>(-1);
+
+    uint32_t pass;    //!< index of the declared pass or c_barrier_only_pass for the transitions that cannot be recorded on the queue of the pass needing them
+    RenderGraphQueue queue;
+    std::vector<RenderGraphBarrier> barriers;    //!< transitions to be recorded on the queue of the pass before the pass is executed
+    std::vector<uint32_t> waits;    //!< indices of the compiled passes executed on the other queues, which must be completed before this pass begins
+    bool is_signaling;    //!< 'true' if one of the passes on the other queues waits for this pass
+};
+
+//! Result of render graph compilation
+struct CompiledRenderGraph final
+{
+    std::vector<CompiledRenderGraphPass> passes;    //!< passes in the order of submission, each queue executes its passes in this order
+    std::vector<uint32_t> culled_passes;    //!< indices of the declared passes, whose results are not consumed
+    std::vector<RenderGraphResourceLifetime> transient_resource_lifetimes;    //!< lifetimes of the transient resources used by the compiled passes
+};
+
+
+/*! Describes the work of a frame as a sequence of passes, which declare the resources they read and write along with the states
+ they need these resources in. The resources are either transient, i.e. only living within the frame, or imported, which means
+ that their contents are visible outside of the frame. Compilation of the graph, which is done entirely on the CPU,
+  - culls the passes, whose results are not consumed by the other passes, do not go to imported resources and have no side effects;
+  - derives the transitions needed by each pass. The read states requested by all passes reading the same version of a resource
+    are combined, so that the resource is transitioned only once per version;
+  - maps the passes to the direct, compute and copy queues and computes the minimal set of cross-queue waits. The transitions
+    the queue of the pass is not able to record are moved to barrier-only passes executed on the direct queue;
+  - returns the lifetimes of the transient resources suitable for TransientResourceAliasingPlanner.
+ The passes are executed in the order of their declaration, so that a read always observes the contents written by the latest
+ preceding pass writing the resource. The imported resources are returned to their final states by a barrier-only pass at the end
+ of the frame. Compilation THROWS if the graph reads undefined contents or the pass requests a state not supported by its queue
+*/
+class RenderGraph final
+{
+public:
+    //! declares transient resource, which is created in the given state and whose contents are undefined until written
+    uint32_t createResource(std::string const& name, ResourceState initial_state = ResourceState::base_values::common);
+
+    //! declares resource living outside of the frame, which resides in the initial state before the frame and must be left in the final state
+    uint32_t importResource(std::string const& name, ResourceState initial_state, ResourceState final_state);
+
+    //! declares pass executed after all passes declared so far. The passes with side effects are never culled
+    uint32_t addPass(std::string const& name, RenderGraphQueue queue = RenderGraphQueue::direct, bool has_side_effects = false);
+
+    void addRead(uint32_t pass, uint32_t resource, ResourceState state);    //! declares that the pass reads the resource in the given state. THROWS
+    void addWrite(uint32_t pass, uint32_t resource, ResourceState state);    //! declares that the pass writes the resource in the given state. THROWS
+
+    //! compiles the graph. When async work is disabled all passes are mapped to the direct queue. THROWS
+    CompiledRenderGraph compile(bool is_async_work_enabled = true) const;
+
+    std::string const& passName(uint32_t pass) const { return m_passes[pass].name; }
+    std::string const& resourceName(uint32_t resource) const { return m_resources[resource].name; }
+    size_t passCount() const { return m_passes.size(); }
+    size_t resourceCount() const { return m_resources.size(); }
+
+    void clear();    //! removes all passes and resources, so that the graph can be declared anew for the next frame
+
+private:
+    struct ResourceDeclaration
+    {
+        std::string name;
+        bool is_imported;
+        ResourceState initial_state;
+        ResourceState final_state;
+    };
+
+    struct Access
+    {
+        uint32_t resource;
+        ResourceState state;
+        bool is_read;
+        bool is_write;
+    };
+
+    struct PassDeclaration
+    {
+        std::string name;
+        RenderGraphQueue queue;
+        bool has_side_effects;
+        std::vector<Access> accesses;    //!< one entry per resource accessed by the pass
+    };
+
+private:
+    void addAccess(uint32_t pass, uint32_t resource, ResourceState state, bool is_write);
+
+private:
+    std::vector<ResourceDeclaration> m_resources;
+    std::vector<PassDeclaration> m_passes;
+};
+
+}
+
+#endif
@@ -1,4 +1,5 @@
 #include "engine/scenegraph/scene.h"
+#include "engine/conversion/texture_converter.h"
 
 #include "rendering_tasks.h"
 #include "engine/core/globals.h"
@@ -140,6 +141,10 @@ void RenderingTasks::render(RenderingTarget& rendering_target, const std::functi
 
     BasicRenderingServicesAttorney<RenderingTasks>::defineRenderingTarget(m_basic_rendering_services, rendering_target);
 
+    // mipmap levels streamed in during this frame become available for sampling in one of the following frames
+    if (m_current_scene) m_current_scene->updateTextureResidency();
+    m_globals.get<conversion::TextureConverter>()->updateTextureResidency();
+
     m_device.queryCache()->markFrameBegin();
     m_task_sink.submit(m_frame_progress_tracker.currentFrameIndex());
     presenter();
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 
 #include "resource.h"
@@ -9,12 +10,69 @@ using namespace lexgine::core::dx::d3d12;
 using namespace lexgine::core;
 
 
+namespace {
+
+// {6B3C4F1E-2D7A-4C58-9E41-0F8A7B2C5D93}, tags the native resources with the identifiers assigned by Resource::uniqueId()
+GUID const c_resource_unique_id_guid = { 0x6b3c4f1e, 0x2d7a, 0x4c58, { 0x9e, 0x41, 0x0f, 0x8a, 0x7b, 0x2c, 0x5d, 0x93 } };
+
+std::atomic_uint64_t resource_unique_id_counter{ 0U };
+
+//! returns identifier stored in the native resource or tags the resource with a new one, in which case 'tagging_result' receives result of the tagging
+uint64_t readOrAssignUniqueId(ID3D12Resource* p_native_resource, HRESULT& tagging_result)
+{
+    uint64_t rv{};
+    UINT data_size = sizeof(rv);
+    tagging_result = S_OK;
+    if (SUCCEEDED(p_native_resource->GetPrivateData(c_resource_unique_id_guid, &data_size, &rv)) && data_size == sizeof(rv))
+    {
+        return rv;
+    }
+
+    // the identifier is stored in the native object, so that all wrappers of the resource agree on it. If two threads tag
+    // the resource concurrently, the identifier obtained by one of them is simply never seen again
+    rv = ++resource_unique_id_counter;
+    tagging_result = p_native_resource->SetPrivateData(c_resource_unique_id_guid, sizeof(rv), &rv);
+    return rv;
+}
+
+}
+
+
 uint64_t ResourceDescriptor::getAllocationSize(Device const& device, uint32_t node_exposure_mask) const
 {
     D3D12_RESOURCE_DESC desc = native();
     return device.native()->GetResourceAllocationInfo(node_exposure_mask, 1, &desc).SizeInBytes;
 }
 
+ResourceAllocationInfo ResourceDescriptor::getAllocationInfo(Device const& device, uint32_t node_exposure_mask) const
+{
+    D3D12_RESOURCE_DESC desc = native();
+    D3D12_RESOURCE_ALLOCATION_INFO info = device.native()->GetResourceAllocationInfo(node_exposure_mask, 1, &desc);
+    return ResourceAllocationInfo{ .size = info.SizeInBytes, .alignment = info.Alignment };
+}
+
+uint32_t ResourceDescriptor::getSubresourceCount(Device const& device) const
+{
+    if (dimension == ResourceDimension::buffer) return 1U;
+
+    D3D12_FEATURE_DATA_FORMAT_INFO format_info{ .Format = format, .PlaneCount = 1 };
+    if (FAILED(device.native()->CheckFeatureSupport(D3D12_FEATURE_FORMAT_INFO, &format_info, sizeof(format_info))))
+    {
+        format_info.PlaneCount = 1;
+    }
+
+    // zero mipmap count stands for the full mipmap chain
+    uint32_t mipmap_count = num_mipmaps;
+    if (!mipmap_count)
+    {
+        uint64_t largest_dimension = (std::max)({ width, static_cast<uint64_t>(height), static_cast<uint64_t>(dimension == ResourceDimension::texture3d ? depth : 1U) });
+        for (; largest_dimension; largest_dimension >>= 1) ++mipmap_count;
+    }
+
+    uint32_t const array_size = dimension == ResourceDimension::texture3d ? 1U : depth;
+    return mipmap_count * array_size * format_info.PlaneCount;
+}
+
 D3D12_RESOURCE_DESC ResourceDescriptor::native() const
 {
     return D3D12_RESOURCE_DESC{
@@ -176,6 +234,29 @@ uint64_t Resource::getGPUVirtualAddress() const
     return m_resource->GetGPUVirtualAddress();
 }
 
+uint64_t Resource::uniqueId() const
+{
+    assert(m_resource != nullptr);
+
+    HRESULT tagging_result;
+    uint64_t rv = readOrAssignUniqueId(m_resource.Get(), tagging_result);
+    LEXGINE_LOG_ERROR_IF_FAILED(
+        this,
+        tagging_result,
+        S_OK
+    );
+    return rv;
+}
+
+uint64_t Resource::uniqueId(ID3D12Resource* p_native_resource)
+{
+    assert(p_native_resource != nullptr);
+
+    // there is no entity to report failure of the tagging on, the wrappers report it when they request the identifier
+    HRESULT tagging_result;
+    return readOrAssignUniqueId(p_native_resource, tagging_result);
+}
+
 ResourceDescriptor const& Resource::descriptor() const
 {
     assert(m_resource != nullptr);
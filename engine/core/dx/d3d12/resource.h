@@ -58,6 +58,14 @@ FLAG(allow_simultaneous_access, 0x20)
 END_FLAGS_DECLARATION(ResourceFlags);
 
 
+//! Size and placement alignment required by a resource in a heap
+struct ResourceAllocationInfo
+{
+    uint64_t size;    //!< size of the memory occupied by the resource in bytes
+    uint64_t alignment;    //!< alignment required for the offset of the resource in the heap
+};
+
+
 //! Thin class wrapper over D3D12_RESOURCE_DESC to simplify its creation
 struct ResourceDescriptor
 {
@@ -76,6 +84,12 @@ struct ResourceDescriptor
     //! it requires knowledge about device interface and about the nodes to which the resource is exposed, as both these parameters may in theory affect the final size
     uint64_t getAllocationSize(Device const& device, uint32_t node_exposure_mask) const;
 
+    //! Returns both the size and the placement alignment of the resource. The same considerations as for getAllocationSize(...) apply
+    ResourceAllocationInfo getAllocationInfo(Device const& device, uint32_t node_exposure_mask) const;
+
+    //! Returns number of the subresources of the resource, which includes all planes of the planar formats
+    uint32_t getSubresourceCount(Device const& device) const;
+
     D3D12_RESOURCE_DESC native() const;    // returns native D3D12 resource descriptor struct
 
     static ResourceDescriptor CreateBuffer(uint64_t size, ResourceFlags flags = ResourceFlags::base_values::none);    //! fills out the fields of the structure as required for buffers
@@ -164,6 +178,14 @@ public:
 
     uint64_t getGPUVirtualAddress() const;
 
+    /*! returns identifier of the native resource, which is never assigned to another native resource during the life time of the application.
+     Unlike the address of the native interface, the identifier can be used as a cache key that outlives the resource
+    */
+    uint64_t uniqueId() const;
+
+    //! returns identifier of the given native resource, which is the same as the one returned by uniqueId() of any wrapper of the resource
+    static uint64_t uniqueId(ID3D12Resource* p_native_resource);
+
     ResourceDescriptor const& descriptor() const;    //! returns descriptor of the resource
 
     ResourceState const& defaultState() const { return m_resource_default_state; }
@@ -3,16 +3,96 @@
 
 #include "resource_data_uploader.h"
 #include "device.h"
-#include "resource_barrier_pack.h"
+#include "resource_state_tracker.h"
 
 #include "engine/core/exception.h"
 #include "engine/core/globals.h"
 #include "engine/core/global_settings.h"
 
 #include "engine/core/math/box.h"
+#include "engine/core/misc/misc.h"
 
 namespace lexgine::core::dx::d3d12 {
 
+namespace {
+
+//! Records the copies planned by the uploader into the upload command list
+class CommandListUploadSink final : public AbstractUploadCommandSink
+{
+public:
+    CommandListUploadSink(Device& device, CommandList& command_list, Resource const& staging_buffer, bool is_async_copy_enabled)
+        : m_device{ device }
+        , m_command_list{ command_list }
+        , m_staging_buffer{ staging_buffer }
+        , m_is_async_copy_enabled{ is_async_copy_enabled }
+    {
+
+    }
+
+    void transitionDestinations(std::vector<UploadDestination> const& destinations, bool to_copy_destination_state) override
+    {
+        // copy queues do not need the destinations to be transitioned
+        if (m_is_async_copy_enabled)
+        {
+            return;
+        }
+
+        // the transitions are requested from the tracker, so that the registry of the resource states observes the upload. The states
+        // provided along with the destinations are only trusted for the resources that have not been used by the submitted command lists yet
+        ResourceState const copy_destination_state = ResourceState::base_values::copy_destination;
+        for (UploadDestination const& destination : destinations)
+        {
+            uint32_t const subresource_count = destination.p_resource->descriptor().getSubresourceCount(m_device);
+            if (to_copy_destination_state)
+            {
+                m_device.resourceStateRegistry().adoptResource(destination.p_resource, subresource_count, destination.state);
+            }
+            m_command_list.resourceStateTracker().requestState(destination.p_resource, subresource_count,
+                to_copy_destination_state ? copy_destination_state : destination.state);
+        }
+        m_command_list.flushResourceBarriers();
+    }
+
+    void copyBufferRegion(StagedBufferCopy const& copy) override
+    {
+        m_command_list.copyBufferRegion(*copy.p_destination_resource, copy.destination_offset,
+            m_staging_buffer, copy.staging_offset, copy.size);
+    }
+
+    void copyTextureRegion(StagedTextureCopy const& copy) override
+    {
+        TextureCopyLocation source_location{
+            m_staging_buffer,
+            copy.staging_offset,
+            copy.format,
+            copy.width,
+            copy.height,
+            copy.depth,
+            copy.row_pitch
+        };
+
+        TextureCopyLocation destination_location{
+            *copy.p_destination_resource,
+            copy.destination_subresource
+        };
+
+        m_command_list.copyTextureRegion(
+            destination_location,
+            misc::Optional<math::Vector3u>{ math::Vector3u{ copy.destination_offset_x, copy.destination_offset_y, copy.destination_offset_z } },
+            source_location,
+            {}
+        );
+    }
+
+private:
+    Device& m_device;
+    CommandList& m_command_list;
+    Resource const& m_staging_buffer;
+    bool m_is_async_copy_enabled;
+};
+
+}
+
 ResourceDataUploader::ResourceDataUploader(Globals& globals, DedicatedUploadDataStreamAllocator& upload_buffer_allocator, ResourceUploadPolicy upload_policy)
     : m_device{ *globals.get<Device>() }
     , m_is_async_copy_enabled{ globals.get<GlobalSettings>()->isAsyncCopyEnabled() }
@@ -71,14 +151,12 @@ bool ResourceDataUploader::addResourceForUpload(
         }
 
         bool is_allocation_blocking = m_upload_policy == ResourceUploadPolicy::blocking;
-        auto allocation = m_upload_buffer_allocator.allocate(task_size, is_allocation_blocking);
-        if (allocation == nullptr)
+        StagingAllocation allocation = allocateStagingMemory(task_size, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, is_allocation_blocking);
+        if (!allocation.p_cpu_address)
         {
             return false;    // staging buffer is exhausted
         }
 
-        beginCopy(destination_descriptor);
-        size_t offset = 0;
         for (uint32_t p = 0; p < num_subresources; ++p)
         {
             D3D12_PLACED_SUBRESOURCE_FOOTPRINT& footprint_desc = p_placed_subresource_footprints[p];
@@ -88,7 +166,7 @@ bool ResourceDataUploader::addResourceForUpload(
                 p_dst_region = &dst_regions[p];
             }
 
-            uint8_t* p_dst_subresource = static_cast<uint8_t*>(allocation->cpuAddress()) 
+            uint8_t* p_dst_subresource = allocation.p_cpu_address
                 + (p_dst_region ? allocation_buffer_offsets[p] : footprint_desc.Offset);
             uint8_t const* p_src_subresource = static_cast<uint8_t const*>(source_descriptor.subresources[p].p_data);
             
@@ -122,33 +200,22 @@ bool ResourceDataUploader::addResourceForUpload(
 
             uint32_t const dst_width = p_dst_region ? p_dst_region->width : footprint_desc.Footprint.Width;
             uint32_t const dst_height = p_dst_region ? p_dst_region->height : footprint_desc.Footprint.Height;
-            math::Vector3u dst_offset = p < dst_regions.size() 
-                ? math::Vector3u{dst_regions[p].offset_x, dst_regions[p].offset_y, dst_regions[p].offset_z}
-                : math::Vector3u{};
-
-            TextureCopyLocation source_location{
-                m_upload_buffer_allocator.getUploadResource(),
-                allocation->offset() + footprint_desc.Offset,
-                footprint_desc.Footprint.Format, 
-                dst_width,
-                dst_height,
-                dst_depth,
-                p < dst_regions.size() ? static_cast<uint32_t>(row_pitches[p]) : static_cast<uint32_t>(footprint_desc.Footprint.RowPitch) 
-            };
-
-            TextureCopyLocation destination_location{ 
-                *destination_descriptor.p_destination_resource,
-                p
-            };
-
-            m_upload_command_list.copyTextureRegion(
-                destination_location, 
-                misc::Optional<math::Vector3f>{dst_offset},
-                source_location, 
-                {}
-            );
+
+            m_upload_planner.addTextureCopy(destination_descriptor.destination_resource_state,
+                StagedTextureCopy{
+                    .p_destination_resource = destination_descriptor.p_destination_resource,
+                    .destination_subresource = destination_descriptor.segment.subresources.first_subresource + p,
+                    .destination_offset_x = p_dst_region ? p_dst_region->offset_x : 0U,
+                    .destination_offset_y = p_dst_region ? p_dst_region->offset_y : 0U,
+                    .destination_offset_z = p_dst_region ? p_dst_region->offset_z : 0U,
+                    .staging_offset = allocation.staging_offset + footprint_desc.Offset,
+                    .format = footprint_desc.Footprint.Format,
+                    .width = dst_width,
+                    .height = dst_height,
+                    .depth = dst_depth,
+                    .row_pitch = p_dst_region ? static_cast<uint32_t>(row_pitches[p]) : static_cast<uint32_t>(footprint_desc.Footprint.RowPitch)
+                });
         }
-        endCopy(destination_descriptor);
     }
     return true;
 }
@@ -159,23 +226,26 @@ bool ResourceDataUploader::addResourceForUpload(DestinationDescriptor const& des
     D3D12_RESOURCE_DESC d3d12_destination_resource_descriptor = destination_descriptor.p_destination_resource->descriptor().native();
     assert(d3d12_destination_resource_descriptor.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER);
 
-    auto allocation = m_upload_buffer_allocator.allocate(source_descriptor.buffer_size);
-    if (allocation == nullptr)
+    // buffer payloads are packed without gaps, so that the uploads into adjacent regions of the destination can be merged into a single copy
+    StagingAllocation allocation = allocateStagingMemory(source_descriptor.buffer_size, 1U, true);
+    if (!allocation.p_cpu_address)
     {
         return false;    // staging buffer is exhausted
     }
 
-    beginCopy(destination_descriptor);
-    uint8_t* p_upload_buffer_addr = static_cast<uint8_t*>(allocation->cpuAddress());
     std::copy(
         static_cast<uint8_t const*>(source_descriptor.p_data),
         static_cast<uint8_t const*>(source_descriptor.p_data) + source_descriptor.buffer_size,
-        p_upload_buffer_addr
+        allocation.p_cpu_address
     );
 
-    m_upload_command_list.copyBufferRegion(*destination_descriptor.p_destination_resource, destination_descriptor.segment.base_offset,
-        m_upload_buffer_allocator.getUploadResource(), allocation->offset(), source_descriptor.buffer_size);
-    endCopy(destination_descriptor);
+    m_upload_planner.addBufferCopy(destination_descriptor.destination_resource_state,
+        StagedBufferCopy{
+            .p_destination_resource = destination_descriptor.p_destination_resource,
+            .destination_offset = destination_descriptor.segment.base_offset,
+            .staging_offset = allocation.staging_offset,
+            .size = source_descriptor.buffer_size
+        });
 
     return true;
 }
@@ -183,12 +253,22 @@ bool ResourceDataUploader::addResourceForUpload(DestinationDescriptor const& des
 
 void ResourceDataUploader::upload()
 {
-    if (!m_upload_command_list_needs_reset)
+    if (m_upload_planner.empty())
     {
-        m_upload_command_list.close(); m_upload_command_list_needs_reset = true;
-        m_device.copyCommandQueue().executeCommandList(m_upload_command_list);
-        m_upload_buffer_allocator.signalAllocator(m_is_async_copy_enabled ? m_device.copyCommandQueue() : m_device.defaultCommandQueue());
+        return;
     }
+
+    m_upload_command_list.reset();
+    CommandListUploadSink upload_sink{ m_device, m_upload_command_list, m_upload_buffer_allocator.getUploadResource(), m_is_async_copy_enabled };
+    m_upload_planner.record(upload_sink);
+    m_upload_command_list.close();
+
+    m_device.copyCommandQueue().executeCommandList(m_upload_command_list);
+    m_upload_buffer_allocator.signalAllocator(m_is_async_copy_enabled ? m_device.copyCommandQueue() : m_device.defaultCommandQueue());
+
+    // the staging block has been submitted together with the copies and cannot receive more data
+    m_staging_block = nullptr;
+    m_staging_block_fill_size = 0U;
 }
 
 Resource const& ResourceDataUploader::sourceBuffer() const
@@ -215,42 +295,27 @@ uint64_t ResourceDataUploader::availableCapacity() const
     return m_upload_buffer_allocator.getUnpartitionedCapacity();
 }
 
-void ResourceDataUploader::beginCopy(DestinationDescriptor const& destination_descriptor)
+ResourceDataUploader::StagingAllocation ResourceDataUploader::allocateStagingMemory(size_t size, size_t alignment, bool is_blocking_call)
 {
-    if (m_upload_command_list_needs_reset)
+    if (size > c_max_packed_payload_size)
     {
-        m_upload_command_list.reset();
-        m_upload_command_list_needs_reset = false;
+        auto allocation = m_upload_buffer_allocator.allocate(size, is_blocking_call);
+        if (!allocation) return { nullptr, 0U };
+        return { static_cast<uint8_t*>(allocation->cpuAddress()), allocation->offset() };
     }
 
-    if (m_is_async_copy_enabled) 
+    uint64_t offset = misc::align(m_staging_block_fill_size, alignment);
+    if (!m_staging_block || offset + size > m_staging_block->capacity())
     {
-        return;
-    }
+        auto allocation = m_upload_buffer_allocator.allocate(c_staging_block_size, is_blocking_call);
+        if (!allocation) return { nullptr, 0U };
 
-    // begin-of-copy barrier
-
-    StaticResourceBarrierPack<1> barriers;
-
-    barriers.addTransitionBarrier(destination_descriptor.p_destination_resource,
-        destination_descriptor.destination_resource_state, ResourceState::base_values::copy_destination);
-    barriers.applyBarriers(m_upload_command_list);
-}
-
-void ResourceDataUploader::endCopy(DestinationDescriptor const& destination_descriptor)
-{
-    if (m_is_async_copy_enabled) 
-    {
-        return;
+        m_staging_block = allocation;
+        offset = 0U;
     }
+    m_staging_block_fill_size = offset + size;
 
-    // end-of-copy barrier
-
-    StaticResourceBarrierPack<1> barriers;
-
-    barriers.addTransitionBarrier(destination_descriptor.p_destination_resource,
-        ResourceState::base_values::copy_destination, destination_descriptor.destination_resource_state);
-    barriers.applyBarriers(m_upload_command_list);
+    return { static_cast<uint8_t*>(m_staging_block->cpuAddress()) + offset, m_staging_block->offset() + offset };
 }
 
-}
\ No newline at end of file
+}
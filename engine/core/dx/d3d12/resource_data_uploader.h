@@ -6,6 +6,7 @@
 #include "resource.h"
 #include "command_list.h"
 #include "upload_buffer_allocator.h"
+#include "resource_upload_planner.h"
 
 #include "engine/core/lexgine_core_fwd.h"
 #include "engine/core/entity.h"
@@ -21,7 +22,10 @@ enum class ResourceUploadPolicy
     non_blocking
 };
 
-//! Helper: implements uploading of placed subresources to the GPU-side
+/*! Helper: implements uploading of placed subresources to the GPU-side. The source data are staged immediately, while the copy commands
+ are batched until upload() is called, so that the copies can be merged and surrounded by a single pair of barrier sets. Small payloads
+ are packed tightly into shared staging blocks
+*/
 class ResourceDataUploader : public NamedEntity<class_names::D3D12_ResourceDataUploader>
 {
 public:
@@ -105,6 +109,8 @@ public:
     */
     void upload();
 
+    size_t pendingCopyCount() const { return m_upload_planner.pendingCopyCount(); }    //! returns number of copies waiting for upload() before merging
+
     Resource const& sourceBuffer() const;    //! returns source buffer used for data uploading
 
     void waitUntilUploadIsFinished() const;    //! blocks calling thread until all upload tasks are finished
@@ -117,8 +123,17 @@ public:
     uint64_t availableCapacity() const;    //! returns best estimate of available capacity of the staging buffer known at that point
 
 private:
-    void beginCopy(DestinationDescriptor const& destination_descriptor);
-    void endCopy(DestinationDescriptor const& destination_descriptor);
+    static constexpr uint32_t c_staging_block_size = UploadDataAllocator::c_chunk_size;
+    static constexpr uint32_t c_max_packed_payload_size = c_staging_block_size / 4;    //!< payloads up to this size are packed into shared staging blocks
+
+    struct StagingAllocation
+    {
+        uint8_t* p_cpu_address;    //!< nullptr if the staging buffer is exhausted
+        uint64_t staging_offset;    //!< offset of the allocation from the beginning of the staging buffer
+    };
+
+private:
+    StagingAllocation allocateStagingMemory(size_t size, size_t alignment, bool is_blocking_call);
 
 private:
     Device& m_device;    //!< device object corresponding to the uploader
@@ -126,7 +141,9 @@ private:
     DedicatedUploadDataStreamAllocator& m_upload_buffer_allocator;    //!< upload buffer allocation manager
     CommandList m_upload_command_list;    //!< command list intended to contain upload commands
     ResourceUploadPolicy m_upload_policy;    //!< resource upload policy (blocking - internal allocator waits until needed space becomes available; non_blocing - internal allocator fails in case if staging buffer is exhausted)
-    bool m_upload_command_list_needs_reset{ true };
+    ResourceUploadPlanner m_upload_planner;    //!< copies batched until the next call of upload()
+    DedicatedUploadDataStreamAllocator::address_type m_staging_block{ nullptr };    //!< staging block receiving small payloads
+    uint64_t m_staging_block_fill_size{ 0U };
 };
 
 }
@@ -0,0 +1,479 @@
+#include <algorithm>
+#include <cassert>
+
+#include "resource_state_tracker.h"
+
+using namespace lexgine::core::dx::d3d12;
+
+namespace {
+
+using state_base_values = ResourceState::base_values;
+
+int const c_read_only_states = static_cast<int>(state_base_values::vertex_and_constant_buffer)
+    | static_cast<int>(state_base_values::index_buffer)
+    | static_cast<int>(state_base_values::depth_read)
+    | static_cast<int>(state_base_values::non_pixel_shader)
+    | static_cast<int>(state_base_values::pixel_shader)
+    | static_cast<int>(state_base_values::indirect_argument)
+    | static_cast<int>(state_base_values::copy_source)
+    | static_cast<int>(state_base_values::resolve_source)
+    | static_cast<int>(state_base_values::generic_read)
+    | static_cast<int>(state_base_values::predication);
+
+bool isReadOnlyState(ResourceState state)
+{
+    // 'common' state has zero value, but it is not a read-only state
+    return state.getValue() != 0 && (state.getValue() & ~c_read_only_states) == 0;
+}
+
+//! returns 'true' if the subresource residing in 'current_state' can be accessed as required by 'requested_state' without a transition
+bool isStateIncluded(ResourceState requested_state, ResourceState current_state)
+{
+    if (requested_state == current_state) return true;
+
+    return isReadOnlyState(requested_state) && isReadOnlyState(current_state)
+        && (requested_state.getValue() & current_state.getValue()) == requested_state.getValue();
+}
+
+bool areBarriersMergeable(TrackedResourceBarrier const& a, TrackedResourceBarrier const& b)
+{
+    return a.state_before == b.state_before && a.state_after == b.state_after && a.split_flags == b.split_flags;
+}
+
+}
+
+
+void ResourceStateTracker::requestState(Resource const* p_resource, uint32_t subresource_count, ResourceState state, uint32_t subresource)
+{
+    addRequest(p_resource, subresource_count, state, subresource, false);
+}
+
+void ResourceStateTracker::beginTransition(Resource const* p_resource, uint32_t subresource_count, ResourceState state, uint32_t subresource)
+{
+    addRequest(p_resource, subresource_count, state, subresource, true);
+}
+
+void ResourceStateTracker::requestUAVBarrier(Resource const* p_resource)
+{
+    auto p = m_resource_indices.find(p_resource);
+    if (p == m_resource_indices.end())
+    {
+        // UAV barrier only orders the accesses recorded by this list, so it is not needed for the resources that have not been used yet
+        return;
+    }
+
+    TrackedResource& resource = m_resources[p->second];
+    if (!resource.has_pending_requests && !resource.has_pending_uav_barrier)
+    {
+        m_resources_with_pending_requests.push_back(p->second);
+    }
+    resource.has_pending_uav_barrier = true;
+}
+
+void ResourceStateTracker::recordManualTransition(uint64_t resource_id, uint32_t subresource, ResourceState state)
+{
+    m_manual_transitions.push_back(ManualTransition{ .resource_id = resource_id, .subresource = subresource, .state = state });
+}
+
+size_t ResourceStateTracker::flush(AbstractResourceBarrierSink& sink)
+{
+    m_barriers.clear();
+    for (uint32_t resource_index : m_resources_with_pending_requests)
+    {
+        flushResource(m_resources[resource_index]);
+    }
+    m_resources_with_pending_requests.clear();
+
+    if (!m_barriers.empty()) sink.applyBarriers(m_barriers);
+    return m_barriers.size();
+}
+
+size_t ResourceStateTracker::finalize(AbstractResourceBarrierSink& sink)
+{
+    size_t rv = flush(sink);
+
+    // the split transitions are completed by requesting the states the subresources are being transitioned into
+    for (TrackedResource& resource : m_resources)
+    {
+        uint32_t const subresource_count = static_cast<uint32_t>(resource.subresources.size());
+        for (uint32_t i = 0; i < subresource_count; ++i)
+        {
+            SubresourceState const& s = resource.subresources[i];
+            if (s.is_in_split_transition) addRequest(resource.p_resource, subresource_count, s.state, i, false);
+        }
+    }
+
+    return rv + flush(sink);
+}
+
+std::vector<ResourceStateTracker::FinalState> ResourceStateTracker::finalStates() const
+{
+    std::vector<FinalState> rv{};
+    rv.reserve(m_resources.size());
+    for (TrackedResource const& resource : m_resources)
+    {
+        uint32_t const subresource_count = static_cast<uint32_t>(resource.subresources.size());
+        SubresourceState const& first = resource.subresources[0];
+
+        bool is_uniform = std::all_of(resource.subresources.begin(), resource.subresources.end(),
+            [&first](SubresourceState const& s) { return s.is_known && s.state == first.state; });
+        if (is_uniform)
+        {
+            rv.push_back(FinalState{ .p_resource = resource.p_resource, .subresource_count = subresource_count,
+                .subresource = TrackedResourceBarrier::c_all_subresources, .state = first.state });
+            continue;
+        }
+
+        for (uint32_t i = 0; i < subresource_count; ++i)
+        {
+            if (!resource.subresources[i].is_known) continue;
+
+            rv.push_back(FinalState{ .p_resource = resource.p_resource, .subresource_count = subresource_count,
+                .subresource = i, .state = resource.subresources[i].state });
+        }
+    }
+    return rv;
+}
+
+void ResourceStateTracker::reset()
+{
+    m_resource_indices.clear();
+    m_resources.clear();
+    m_resources_with_pending_requests.clear();
+    m_initial_state_requirements.clear();
+    m_manual_transitions.clear();
+    m_statistics = Statistics{};
+}
+
+ResourceStateTracker::TrackedResource& ResourceStateTracker::trackedResource(Resource const* p_resource, uint32_t subresource_count)
+{
+    auto [p, is_inserted] = m_resource_indices.try_emplace(p_resource, static_cast<uint32_t>(m_resources.size()));
+    if (is_inserted)
+    {
+        assert(subresource_count > 0);
+
+        m_resources.push_back(TrackedResource{
+            .p_resource = p_resource,
+            .subresources = std::vector<SubresourceState>(subresource_count,
+                SubresourceState{ .state = ResourceState{}, .is_known = false, .is_in_split_transition = false, .split_state_before = ResourceState{} }),
+            .pending_requests = std::vector<PendingRequest>(subresource_count,
+                PendingRequest{ .state = ResourceState{}, .is_pending = false, .is_split_begin = false }),
+            .has_pending_requests = false,
+            .has_pending_uav_barrier = false
+            });
+    }
+
+    TrackedResource& rv = m_resources[p->second];
+    assert(rv.subresources.size() == subresource_count);
+    return rv;
+}
+
+void ResourceStateTracker::addRequest(Resource const* p_resource, uint32_t subresource_count, ResourceState state, uint32_t subresource, bool is_split_begin)
+{
+    TrackedResource& resource = trackedResource(p_resource, subresource_count);
+    if (!resource.has_pending_requests && !resource.has_pending_uav_barrier)
+    {
+        m_resources_with_pending_requests.push_back(m_resource_indices[p_resource]);
+    }
+    resource.has_pending_requests = true;
+    ++m_statistics.requested_transitions;
+
+    uint32_t const first = subresource == TrackedResourceBarrier::c_all_subresources ? 0U : subresource;
+    uint32_t const last = subresource == TrackedResourceBarrier::c_all_subresources ? subresource_count : subresource + 1U;
+    assert(first < last && last <= subresource_count);
+
+    for (uint32_t i = first; i < last; ++i)
+    {
+        PendingRequest& r = resource.pending_requests[i];
+        if (!r.is_pending)
+        {
+            r = PendingRequest{ .state = state, .is_pending = true, .is_split_begin = is_split_begin };
+            continue;
+        }
+
+        if (r.is_split_begin && !is_split_begin)
+        {
+            // the transition, which has been announced in advance, is needed before its beginning has been recorded
+            if (isStateIncluded(state, r.state)) ++m_statistics.promoted_split_transitions;
+            r = PendingRequest{ .state = isStateIncluded(state, r.state) ? r.state : state, .is_pending = true, .is_split_begin = false };
+        }
+        else if (!r.is_split_begin && !is_split_begin && isReadOnlyState(r.state) && isReadOnlyState(state))
+        {
+            // the subresource can be read in several ways by the commands that follow the flush
+            r.state = ResourceState{ r.state.getValue() | state.getValue() };
+        }
+        else if (!(r.is_split_begin && is_split_begin && isStateIncluded(state, r.state)))
+        {
+            r = PendingRequest{ .state = state, .is_pending = true, .is_split_begin = is_split_begin };
+        }
+    }
+}
+
+void ResourceStateTracker::flushResource(TrackedResource& resource)
+{
+    m_split_end_barriers.clear();
+    m_transition_barriers.clear();
+
+    uint32_t const subresource_count = static_cast<uint32_t>(resource.subresources.size());
+    size_t const first_new_requirement = m_initial_state_requirements.size();
+    bool is_transitioned{ false };
+
+    for (uint32_t i = 0; i < subresource_count && resource.has_pending_requests; ++i)
+    {
+        PendingRequest& r = resource.pending_requests[i];
+        if (!r.is_pending) continue;
+        r.is_pending = false;
+
+        SubresourceState& s = resource.subresources[i];
+        if (!s.is_known)
+        {
+            // the state of the subresource before the list is executed is only known at submission time
+            m_initial_state_requirements.push_back(InitialStateRequirement{ .p_resource = resource.p_resource,
+                .subresource_count = subresource_count, .subresource = i, .state = r.state });
+            s.state = r.state;
+            s.is_known = true;
+            ++m_statistics.dropped_transitions;
+            continue;
+        }
+
+        if (s.is_in_split_transition)
+        {
+            if (!r.is_split_begin && isStateIncluded(r.state, s.state))
+            {
+                m_split_end_barriers.push_back(TrackedResourceBarrier{ .type = TrackedResourceBarrierType::transition,
+                    .p_resource = resource.p_resource, .subresource = i, .state_before = s.split_state_before, .state_after = s.state,
+                    .split_flags = SplitResourceBarrierFlags::end });
+                s.is_in_split_transition = false;
+                continue;
+            }
+
+            // the subresource is requested in a state different from the one announced, so the split transition must be completed first
+            m_split_end_barriers.push_back(TrackedResourceBarrier{ .type = TrackedResourceBarrierType::transition,
+                .p_resource = resource.p_resource, .subresource = i, .state_before = s.split_state_before, .state_after = s.state,
+                .split_flags = SplitResourceBarrierFlags::end });
+            s.is_in_split_transition = false;
+        }
+
+        if (isStateIncluded(r.state, s.state))
+        {
+            ++m_statistics.dropped_transitions;
+            continue;
+        }
+
+        m_transition_barriers.push_back(TrackedResourceBarrier{ .type = TrackedResourceBarrierType::transition,
+            .p_resource = resource.p_resource, .subresource = i, .state_before = s.state, .state_after = r.state,
+            .split_flags = r.is_split_begin ? SplitResourceBarrierFlags::begin : SplitResourceBarrierFlags::none });
+        if (r.is_split_begin)
+        {
+            s.is_in_split_transition = true;
+            s.split_state_before = s.state;
+        }
+        s.state = r.state;
+    }
+
+    // the requirements of all subresources are merged if the whole resource is first used in the same state
+    if (m_initial_state_requirements.size() - first_new_requirement == subresource_count && subresource_count > 1
+        && std::all_of(m_initial_state_requirements.begin() + first_new_requirement, m_initial_state_requirements.end(),
+            [this, first_new_requirement](InitialStateRequirement const& e) { return e.state == m_initial_state_requirements[first_new_requirement].state; }))
+    {
+        m_initial_state_requirements.resize(first_new_requirement + 1);
+        m_initial_state_requirements.back().subresource = TrackedResourceBarrier::c_all_subresources;
+    }
+    else if (subresource_count == 1 && m_initial_state_requirements.size() > first_new_requirement)
+    {
+        m_initial_state_requirements.back().subresource = TrackedResourceBarrier::c_all_subresources;
+    }
+
+    is_transitioned = !m_split_end_barriers.empty() || !m_transition_barriers.empty();
+    emitBarriers(resource, m_split_end_barriers);
+    emitBarriers(resource, m_transition_barriers);
+
+    // transition barrier waits for all preceding accesses of the resource, which makes UAV barrier redundant
+    if (resource.has_pending_uav_barrier && !is_transitioned)
+    {
+        m_barriers.push_back(TrackedResourceBarrier{ .type = TrackedResourceBarrierType::uav, .p_resource = resource.p_resource,
+            .subresource = TrackedResourceBarrier::c_all_subresources, .state_before = ResourceState{}, .state_after = ResourceState{},
+            .split_flags = SplitResourceBarrierFlags::none });
+    }
+
+    resource.has_pending_requests = false;
+    resource.has_pending_uav_barrier = false;
+}
+
+void ResourceStateTracker::emitBarriers(TrackedResource const& resource, std::vector<TrackedResourceBarrier>& subresource_barriers)
+{
+    if (subresource_barriers.empty()) return;
+
+    m_statistics.emitted_transitions += subresource_barriers.size();
+
+    // when all subresources undergo the same transition they are transitioned by a single barrier
+    if (subresource_barriers.size() == resource.subresources.size()
+        && std::all_of(subresource_barriers.begin(), subresource_barriers.end(),
+            [&subresource_barriers](TrackedResourceBarrier const& e) { return areBarriersMergeable(e, subresource_barriers.front()); }))
+    {
+        m_statistics.emitted_transitions -= subresource_barriers.size() - 1;
+        m_barriers.push_back(subresource_barriers.front());
+        m_barriers.back().subresource = TrackedResourceBarrier::c_all_subresources;
+        return;
+    }
+
+    m_barriers.insert(m_barriers.end(), subresource_barriers.begin(), subresource_barriers.end());
+}
+
+
+ResourceStateRegistry::ResourceStateRegistry(resource_id_provider_type const& resource_id_provider)
+    : m_resource_id_provider{ resource_id_provider ? resource_id_provider : [](Resource const* p_resource) { return p_resource->uniqueId(); } }
+{
+}
+
+void ResourceStateRegistry::registerResource(Resource const* p_resource, uint32_t subresource_count, ResourceState state)
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    m_resources[m_resource_id_provider(p_resource)] = RegisteredResource{ .subresource_states = std::vector<ResourceState>(subresource_count, state), .manual_states = {} };
+}
+
+bool ResourceStateRegistry::adoptResource(Resource const* p_resource, uint32_t subresource_count, ResourceState state)
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    RegisteredResource& resource = m_resources[m_resource_id_provider(p_resource)];
+    if (!resource.subresource_states.empty()) return false;
+
+    // the manual transitions recorded so far have happened after the resource had been left in the given state
+    initializeSubresourceStates(resource, subresource_count, state);
+    return true;
+}
+
+void ResourceStateRegistry::unregisterResource(Resource const* p_resource)
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    m_resources.erase(m_resource_id_provider(p_resource));
+}
+
+bool ResourceStateRegistry::isRegistered(Resource const* p_resource) const
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    return m_resources.find(m_resource_id_provider(p_resource)) != m_resources.end();
+}
+
+ResourceState ResourceStateRegistry::state(Resource const* p_resource, uint32_t subresource) const
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    auto p = m_resources.find(m_resource_id_provider(p_resource));
+    assert(p != m_resources.end() && subresource < p->second.subresource_states.size());
+    return p->second.subresource_states[subresource];
+}
+std::vector<TrackedResourceBarrier> ResourceStateRegistry::resolve(ResourceStateTracker const& tracker)
+{
+    std::vector<TrackedResourceBarrier> rv{};
+    std::vector<TrackedResourceBarrier> subresource_barriers{};
+
+    std::lock_guard<std::mutex> lock{ m_mutex };
+
+    auto const& requirements = tracker.initialStateRequirements();
+    for (auto p = requirements.begin(); p != requirements.end();)
+    {
+        // the requirements recorded by the same flush for the same resource are adjacent and resolved together
+        Resource const* p_resource = p->p_resource;
+        uint32_t const subresource_count = p->subresource_count;
+        RegisteredResource& resource = registeredResource(p_resource, subresource_count);
+
+        subresource_barriers.clear();
+        for (; p != requirements.end() && p->p_resource == p_resource; ++p)
+        {
+            uint32_t const first = p->subresource == TrackedResourceBarrier::c_all_subresources ? 0U : p->subresource;
+            uint32_t const last = p->subresource == TrackedResourceBarrier::c_all_subresources ? subresource_count : p->subresource + 1U;
+            for (uint32_t i = first; i < last; ++i)
+            {
+                // the barriers recorded by the list expect the subresources to reside exactly in the required states
+                if (resource.subresource_states[i] == p->state) continue;
+
+                subresource_barriers.push_back(TrackedResourceBarrier{ .type = TrackedResourceBarrierType::transition,
+                    .p_resource = p_resource, .subresource = i, .state_before = resource.subresource_states[i], .state_after = p->state,
+                    .split_flags = SplitResourceBarrierFlags::none });
+            }
+        }
+
+        if (subresource_barriers.size() == subresource_count
+            && std::all_of(subresource_barriers.begin(), subresource_barriers.end(),
+                [&subresource_barriers](TrackedResourceBarrier const& e) { return areBarriersMergeable(e, subresource_barriers.front()); }))
+        {
+            rv.push_back(subresource_barriers.front());
+            rv.back().subresource = TrackedResourceBarrier::c_all_subresources;
+        }
+        else
+        {
+            rv.insert(rv.end(), subresource_barriers.begin(), subresource_barriers.end());
+        }
+    }
+
+    for (auto const& e : tracker.finalStates())
+    {
+        RegisteredResource& resource = registeredResource(e.p_resource, e.subresource_count);
+        if (e.subresource == TrackedResourceBarrier::c_all_subresources)
+        {
+            std::fill(resource.subresource_states.begin(), resource.subresource_states.end(), e.state);
+        }
+        else
+        {
+            resource.subresource_states[e.subresource] = e.state;
+        }
+    }
+
+    for (auto const& e : tracker.manualTransitions())
+    {
+        applyManualTransition(e);
+    }
+
+    return rv;
+}
+
+ResourceStateRegistry::RegisteredResource& ResourceStateRegistry::registeredResource(Resource const* p_resource, uint32_t subresource_count)
+{
+    RegisteredResource& rv = m_resources[m_resource_id_provider(p_resource)];
+    if (rv.subresource_states.empty())
+    {
+        // the resource has either never been seen or has only been transitioned manually since its creation
+        initializeSubresourceStates(rv, subresource_count, p_resource->defaultState());
+    }
+
+    assert(rv.subresource_states.size() == subresource_count);
+    return rv;
+}
+
+void ResourceStateRegistry::initializeSubresourceStates(RegisteredResource& resource, uint32_t subresource_count, ResourceState initial_state)
+{
+    resource.subresource_states.assign(subresource_count, initial_state);
+    for (auto const& [subresource, state] : resource.manual_states)
+    {
+        if (subresource == TrackedResourceBarrier::c_all_subresources) std::fill(resource.subresource_states.begin(), resource.subresource_states.end(), state);
+        else if (subresource < subresource_count) resource.subresource_states[subresource] = state;
+    }
+    resource.manual_states.clear();
+}
+
+void ResourceStateRegistry::applyManualTransition(ResourceStateTracker::ManualTransition const& transition)
+{
+    RegisteredResource& resource = m_resources[transition.resource_id];
+    if (!resource.subresource_states.empty())
+    {
+        if (transition.subresource == TrackedResourceBarrier::c_all_subresources)
+        {
+            std::fill(resource.subresource_states.begin(), resource.subresource_states.end(), transition.state);
+        }
+        else if (transition.subresource < resource.subresource_states.size())
+        {
+            resource.subresource_states[transition.subresource] = transition.state;
+        }
+        return;
+    }
+
+    // until the subresource count is known only the latest state of each subresource is kept, so that the record does not grow
+    // when the resource keeps being transitioned manually
+    auto& manual_states = resource.manual_states;
+    if (transition.subresource == TrackedResourceBarrier::c_all_subresources) manual_states.clear();
+
+    auto p = std::find_if(manual_states.begin(), manual_states.end(),
+        [&transition](std::pair<uint32_t, ResourceState> const& e) { return e.first == transition.subresource; });
+    if (p != manual_states.end()) p->second = transition.state;
+    else manual_states.emplace_back(transition.subresource, transition.state);
+}
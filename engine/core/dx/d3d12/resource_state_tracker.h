@@ -0,0 +1,231 @@
+#ifndef LEXGINE_CORE_DX_D3D12_RESOURCE_STATE_TRACKER_H
+#define LEXGINE_CORE_DX_D3D12_RESOURCE_STATE_TRACKER_H
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "lexgine_core_dx_d3d12_fwd.h"
+#include "resource.h"
+#include "resource_barrier_pack.h"
+
+namespace lexgine::core::dx::d3d12 {
+
+enum class TrackedResourceBarrierType
+{
+    transition,
+    uav
+};
+
+//! Resource barrier produced by the resource state tracker
+struct TrackedResourceBarrier
+{
+    static constexpr uint32_t c_all_subresources = 0xFFFFFFFF;
+
+    TrackedResourceBarrierType type;
+    Resource const* p_resource;
+    uint32_t subresource;    //!< index of the transitioned subresource or c_all_subresources
+    ResourceState state_before;
+    ResourceState state_after;
+    SplitResourceBarrierFlags split_flags;
+};
+
+//! Receives the resource barriers emitted by the resource state tracker
+class AbstractResourceBarrierSink
+{
+public:
+    virtual ~AbstractResourceBarrierSink() = default;
+
+    virtual void applyBarriers(std::vector<TrackedResourceBarrier> const& barriers) = 0;
+};
+
+
+/*! Tracks the states of the resources used by a single command list. Instead of recording the barriers directly, the users
+ request the states, in which the resources must reside for the commands that follow. The requests are accumulated until the
+ next flush, which emits all necessary transitions as a single batch:
+ - the requests of read-only states for the same subresource made between the flushes are combined;
+ - the transitions into the states the subresource already resides in (or into read-only states already included into its
+   current read-only state) are dropped;
+ - the transitions of all subresources of a resource between the same states are merged into a single barrier;
+ - UAV barriers are dropped for the resources that are transitioned by the same batch.
+ The transitions announced in advance by beginTransition(...) are recorded as split barriers, whose end is recorded by the flush
+ preceding the first use of the resource in the new state. If the use is requested before the beginning of the transition has been
+ flushed, the split barrier is promoted back to the ordinary one.
+ The states of the resources before the command list begins executing are not known while the list is recorded, so the first
+ request for each subresource is remembered as the initial state required by the list. These requirements are resolved against
+ ResourceStateRegistry when the command list is submitted. The transitions recorded by the barriers that did not come from the tracker
+ are remembered as well, so that the registry keeps following the resources transitioned manually. A list must not transition manually
+ the resources, which states it requests from the tracker
+*/
+class ResourceStateTracker final
+{
+public:
+    struct InitialStateRequirement
+    {
+        Resource const* p_resource;
+        uint32_t subresource_count;
+        uint32_t subresource;
+        ResourceState state;
+    };
+
+    struct FinalState
+    {
+        Resource const* p_resource;
+        uint32_t subresource_count;
+        uint32_t subresource;
+        ResourceState state;
+    };
+
+    struct ManualTransition
+    {
+        uint64_t resource_id;    //!< unique identifier of the transitioned resource, see Resource::uniqueId()
+        uint32_t subresource;
+        ResourceState state;    //!< state the subresource has been transitioned into
+    };
+
+    struct Statistics
+    {
+        uint64_t requested_transitions;    //!< number of requests for subresource states
+        uint64_t emitted_transitions;    //!< number of emitted transition barriers, including the halves of the split barriers
+        uint64_t dropped_transitions;    //!< number of requests that did not require a transition
+        uint64_t promoted_split_transitions;    //!< number of split transitions promoted back to ordinary ones
+    };
+
+public:
+    //! requests the resource to reside in the given state for the commands recorded after the next flush
+    void requestState(Resource const* p_resource, uint32_t subresource_count, ResourceState state,
+        uint32_t subresource = TrackedResourceBarrier::c_all_subresources);
+
+    /*! announces that the resource will later be requested in the given state and will not be used until then. The transition
+     is started by the next flush as a split barrier and is completed by the flush following the matching requestState(...)
+    */
+    void beginTransition(Resource const* p_resource, uint32_t subresource_count, ResourceState state,
+        uint32_t subresource = TrackedResourceBarrier::c_all_subresources);
+
+    void requestUAVBarrier(Resource const* p_resource);    //! requests UAV barrier to be recorded by the next flush
+
+    /*! remembers transition recorded into the command list bypassing the tracker. The beginnings of split transitions should not be reported.
+     The registry applies the manual transitions after the final states of the tracked resources, so a list should not request states of the resources it has transitioned manually
+    */
+    void recordManualTransition(uint64_t resource_id, uint32_t subresource, ResourceState state);
+
+    //! emits the barriers required by the requests made since the last flush. Returns number of emitted barriers
+    size_t flush(AbstractResourceBarrierSink& sink);
+
+    //! flushes the pending requests and completes all split transitions that have been started, but have not been ended yet
+    size_t finalize(AbstractResourceBarrierSink& sink);
+
+    std::vector<InitialStateRequirement> const& initialStateRequirements() const { return m_initial_state_requirements; }
+    std::vector<FinalState> finalStates() const;    //! returns the states, in which the resources used by the list are left
+    std::vector<ManualTransition> const& manualTransitions() const { return m_manual_transitions; }
+
+    //! returns 'true' if the list neither requested resource states nor transitioned resources manually, so that its submission does not affect the registry
+    bool isEmpty() const { return m_resources.empty() && m_manual_transitions.empty(); }
+
+    Statistics const& statistics() const { return m_statistics; }
+
+    void reset();    //! forgets all tracked states, should be called when the command list is reset
+
+private:
+    struct SubresourceState
+    {
+        ResourceState state;
+        bool is_known;    //!< 'false' until the first request for the subresource has been made by the list
+        bool is_in_split_transition;    //!< 'true' if split transition into 'state' has been started, but not completed
+        ResourceState split_state_before;    //!< state, from which the split transition has been started
+    };
+
+    struct PendingRequest
+    {
+        ResourceState state;
+        bool is_pending;
+        bool is_split_begin;
+    };
+
+    struct TrackedResource
+    {
+        Resource const* p_resource;
+        std::vector<SubresourceState> subresources;
+        std::vector<PendingRequest> pending_requests;
+        bool has_pending_requests;
+        bool has_pending_uav_barrier;
+    };
+
+private:
+    TrackedResource& trackedResource(Resource const* p_resource, uint32_t subresource_count);
+    void addRequest(Resource const* p_resource, uint32_t subresource_count, ResourceState state, uint32_t subresource, bool is_split_begin);
+    void flushResource(TrackedResource& resource);
+    void emitBarriers(TrackedResource const& resource, std::vector<TrackedResourceBarrier>& subresource_barriers);
+
+private:
+    std::unordered_map<Resource const*, uint32_t> m_resource_indices;
+    std::vector<TrackedResource> m_resources;
+    std::vector<uint32_t> m_resources_with_pending_requests;    //!< in the order of their first request after the last flush
+    std::vector<InitialStateRequirement> m_initial_state_requirements;
+    std::vector<ManualTransition> m_manual_transitions;
+    std::vector<TrackedResourceBarrier> m_barriers;    //!< barriers emitted by the flush in progress
+    std::vector<TrackedResourceBarrier> m_split_end_barriers;    //!< scratch lists of per-subresource barriers of the resource being flushed
+    std::vector<TrackedResourceBarrier> m_transition_barriers;
+    Statistics m_statistics{};
+};
+
+
+/*! Global record of the states, in which the resources are left by the command lists submitted for execution. At submission
+ time the initial state requirements of the command list are resolved against the registry into the transitions that have to
+ be executed before the list, after which the registry adopts the final states of the list and the manual transitions it has recorded.
+ The resources are keyed by their unique identifiers rather than by the addresses of the wrappers, so that the copies of a wrapper share
+ the state and the records of the destroyed resources can never be confused with the new ones. The registry is thread-safe
+*/
+class ResourceStateRegistry final
+{
+public:
+    using resource_id_provider_type = std::function<uint64_t(Resource const* p_resource)>;
+
+public:
+    //! the identifiers of the resources are provided by Resource::uniqueId() unless a different provider is given
+    explicit ResourceStateRegistry(resource_id_provider_type const& resource_id_provider = resource_id_provider_type{});
+
+    //! starts tracking the resource, which resides in the given state
+    void registerResource(Resource const* p_resource, uint32_t subresource_count, ResourceState state);
+
+    /*! starts tracking the resource in the given state unless its state is already known to the registry, which is the case if the resource
+     has been used by a submitted command list. Returns 'false' if the state has already been known
+    */
+    bool adoptResource(Resource const* p_resource, uint32_t subresource_count, ResourceState state);
+
+    void unregisterResource(Resource const* p_resource);
+
+    bool isRegistered(Resource const* p_resource) const;
+    ResourceState state(Resource const* p_resource, uint32_t subresource) const;
+
+    /*! returns transitions that bring the resources into the initial states required by the tracked command list and updates
+     the registry with the states, in which the list leaves the resources. The resources that have not been registered are
+     assumed to reside in their default states
+    */
+    std::vector<TrackedResourceBarrier> resolve(ResourceStateTracker const& tracker);
+
+private:
+    struct RegisteredResource
+    {
+        std::vector<ResourceState> subresource_states;    //!< empty until the resource is used by a tracked command list, which provides the subresource count
+        std::vector<std::pair<uint32_t, ResourceState>> manual_states;    //!< manual transitions made before the subresource count became known
+    };
+
+private:
+    RegisteredResource& registeredResource(Resource const* p_resource, uint32_t subresource_count);    //! requires the registry to be locked
+    void applyManualTransition(ResourceStateTracker::ManualTransition const& transition);    //! requires the registry to be locked
+
+    //! assigns the initial state to all subresources and replays the manual transitions recorded before the subresource count became known
+    static void initializeSubresourceStates(RegisteredResource& resource, uint32_t subresource_count, ResourceState initial_state);
+
+private:
+    resource_id_provider_type const m_resource_id_provider;
+    mutable std::mutex m_mutex;
+    std::unordered_map<uint64_t, RegisteredResource> m_resources;
+};
+
+}
+
+#endif
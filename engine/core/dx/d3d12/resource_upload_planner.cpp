@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <cassert>
+
+#include "resource_upload_planner.h"
+
+using namespace lexgine::core::dx::d3d12;
+
+void ResourceUploadPlanner::addBufferCopy(ResourceState destination_state, StagedBufferCopy const& copy)
+{
+    assert(copy.size > 0);
+
+    uint32_t destination_index = registerDestination(copy.p_destination_resource, destination_state);
+    m_buffer_copies.push_back(PendingBufferCopy{ .copy = copy, .destination_index = destination_index,
+        .submission_index = static_cast<uint32_t>(m_buffer_copies.size()) });
+}
+
+void ResourceUploadPlanner::addTextureCopy(ResourceState destination_state, StagedTextureCopy const& copy)
+{
+    uint32_t destination_index = registerDestination(copy.p_destination_resource, destination_state);
+    m_texture_copies.push_back(PendingTextureCopy{ .copy = copy, .destination_index = destination_index });
+}
+
+size_t ResourceUploadPlanner::record(AbstractUploadCommandSink& sink)
+{
+    if (empty()) return 0U;
+
+    // group the copies by destination
+    std::stable_sort(m_buffer_copies.begin(), m_buffer_copies.end(),
+        [](PendingBufferCopy const& a, PendingBufferCopy const& b) { return a.destination_index < b.destination_index; });
+    std::stable_sort(m_texture_copies.begin(), m_texture_copies.end(),
+        [](PendingTextureCopy const& a, PendingTextureCopy const& b) { return a.destination_index < b.destination_index; });
+
+    // order the copies into each buffer by destination offset, unless some of them overlap and therefore must retain their submission order
+    for (auto group_begin = m_buffer_copies.begin(); group_begin != m_buffer_copies.end();)
+    {
+        auto group_end = std::find_if(group_begin, m_buffer_copies.end(),
+            [group_begin](PendingBufferCopy const& e) { return e.destination_index != group_begin->destination_index; });
+
+        std::stable_sort(group_begin, group_end,
+            [](PendingBufferCopy const& a, PendingBufferCopy const& b) { return a.copy.destination_offset < b.copy.destination_offset; });
+
+        bool has_overlaps = std::adjacent_find(group_begin, group_end,
+            [](PendingBufferCopy const& a, PendingBufferCopy const& b) { return a.copy.destination_offset + a.copy.size > b.copy.destination_offset; }) != group_end;
+        if (has_overlaps)
+        {
+            std::sort(group_begin, group_end,
+                [](PendingBufferCopy const& a, PendingBufferCopy const& b) { return a.submission_index < b.submission_index; });
+        }
+
+        group_begin = group_end;
+    }
+
+    // merge the copies that are adjacent both in the destination and in the staging buffer
+    size_t merged_copy_count{ 0U };
+    for (PendingBufferCopy const& e : m_buffer_copies)
+    {
+        if (merged_copy_count > 0)
+        {
+            StagedBufferCopy& previous_copy = m_buffer_copies[merged_copy_count - 1].copy;
+            if (previous_copy.p_destination_resource == e.copy.p_destination_resource
+                && previous_copy.destination_offset + previous_copy.size == e.copy.destination_offset
+                && previous_copy.staging_offset + previous_copy.size == e.copy.staging_offset)
+            {
+                previous_copy.size += e.copy.size;
+                continue;
+            }
+        }
+        m_buffer_copies[merged_copy_count++] = e;
+    }
+    m_buffer_copies.resize(merged_copy_count);
+
+    sink.transitionDestinations(m_destinations, true);
+    for (PendingBufferCopy const& e : m_buffer_copies)
+    {
+        sink.copyBufferRegion(e.copy);
+    }
+    for (PendingTextureCopy const& e : m_texture_copies)
+    {
+        sink.copyTextureRegion(e.copy);
+    }
+    sink.transitionDestinations(m_destinations, false);
+
+    size_t rv = m_buffer_copies.size() + m_texture_copies.size();
+    clear();
+    return rv;
+}
+
+void ResourceUploadPlanner::clear()
+{
+    m_destinations.clear();
+    m_destination_indices.clear();
+    m_buffer_copies.clear();
+    m_texture_copies.clear();
+}
+
+uint32_t ResourceUploadPlanner::registerDestination(Resource const* p_resource, ResourceState state)
+{
+    auto [p, is_inserted] = m_destination_indices.emplace(p_resource, static_cast<uint32_t>(m_destinations.size()));
+    if (is_inserted)
+    {
+        m_destinations.push_back(UploadDestination{ .p_resource = p_resource, .state = state });
+    }
+
+    // the destination is transitioned only once per batch, so all of its uploads must expect it to reside in the same state
+    assert(m_destinations[p->second].state == state);
+    return p->second;
+}
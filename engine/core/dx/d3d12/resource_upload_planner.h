@@ -0,0 +1,106 @@
+#ifndef LEXGINE_CORE_DX_D3D12_RESOURCE_UPLOAD_PLANNER_H
+#define LEXGINE_CORE_DX_D3D12_RESOURCE_UPLOAD_PLANNER_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "lexgine_core_dx_d3d12_fwd.h"
+#include "resource.h"
+
+namespace lexgine::core::dx::d3d12 {
+
+//! Resource receiving uploaded data and the state, in which the resource resides outside of the uploads
+struct UploadDestination
+{
+    Resource const* p_resource;
+    ResourceState state;
+};
+
+//! Copy of the staged data into a region of a buffer
+struct StagedBufferCopy
+{
+    Resource const* p_destination_resource;
+    uint64_t destination_offset;
+    uint64_t staging_offset;    //!< offset of the source data in the staging buffer
+    uint64_t size;
+};
+
+//! Copy of the staged data into a subresource of a texture
+struct StagedTextureCopy
+{
+    Resource const* p_destination_resource;
+    uint32_t destination_subresource;
+    uint32_t destination_offset_x;
+    uint32_t destination_offset_y;
+    uint32_t destination_offset_z;
+    uint64_t staging_offset;    //!< offset of the placed footprint of the source data in the staging buffer
+    DXGI_FORMAT format;
+    uint32_t width;
+    uint32_t height;
+    uint32_t depth;
+    uint32_t row_pitch;
+};
+
+//! Receives the commands produced by the resource upload planner
+class AbstractUploadCommandSink
+{
+public:
+    virtual ~AbstractUploadCommandSink() = default;
+
+    /*! Transitions all destinations either into copy destination state (to_copy_destination_state = 'true') or back into
+     the states they reside in outside of the uploads (to_copy_destination_state = 'false')
+    */
+    virtual void transitionDestinations(std::vector<UploadDestination> const& destinations, bool to_copy_destination_state) = 0;
+
+    virtual void copyBufferRegion(StagedBufferCopy const& copy) = 0;
+    virtual void copyTextureRegion(StagedTextureCopy const& copy) = 0;
+};
+
+
+/*! Batches the copies of staged data scheduled for upload. When the batch is recorded, the copies are grouped by destination
+ resource and the copies into adjacent regions of the same buffer, which are also adjacent in the staging buffer, are merged
+ into a single copy command. All destinations are transitioned by a single barrier set before the copies and by another one
+ after the copies. Copies into overlapping regions of the same buffer retain their submission order
+*/
+class ResourceUploadPlanner final
+{
+public:
+    void addBufferCopy(ResourceState destination_state, StagedBufferCopy const& copy);
+    void addTextureCopy(ResourceState destination_state, StagedTextureCopy const& copy);
+
+    bool empty() const { return m_buffer_copies.empty() && m_texture_copies.empty(); }
+    size_t pendingCopyCount() const { return m_buffer_copies.size() + m_texture_copies.size(); }
+
+    //! Emits the batched copies into the sink and clears the batch. Returns number of emitted copy commands
+    size_t record(AbstractUploadCommandSink& sink);
+
+    void clear();    //! drops the batched copies without recording them
+
+private:
+    struct PendingBufferCopy
+    {
+        StagedBufferCopy copy;
+        uint32_t destination_index;
+        uint32_t submission_index;
+    };
+
+    struct PendingTextureCopy
+    {
+        StagedTextureCopy copy;
+        uint32_t destination_index;
+    };
+
+private:
+    uint32_t registerDestination(Resource const* p_resource, ResourceState state);
+
+private:
+    std::vector<UploadDestination> m_destinations;    //!< destinations in the order of their first appearance in the batch
+    std::unordered_map<Resource const*, uint32_t> m_destination_indices;
+    std::vector<PendingBufferCopy> m_buffer_copies;
+    std::vector<PendingTextureCopy> m_texture_copies;
+};
+
+}
+
+#endif
@@ -35,8 +35,8 @@ Microsoft::WRL::ComPtr<ID3D12RootSignature> RootSignatureCache::findOrCreate(
 }
 
 Microsoft::WRL::ComPtr<ID3D12RootSignature> RootSignatureCache::find(
-    std::string const& root_signature_friendly_name, uint32_t node_mask) const
+    std::string_view root_signature_friendly_name, uint32_t node_mask) const
 {
-    auto p = m_cached_root_signatures.find(key_type{ root_signature_friendly_name, node_mask });
+    auto p = m_cached_root_signatures.find(key_view_type{ root_signature_friendly_name, node_mask });
     return p != m_cached_root_signatures.end() ? p->second : nullptr;
 }
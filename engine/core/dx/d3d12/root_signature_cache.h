@@ -6,7 +6,9 @@
 
 #include <unordered_map>
 #include <mutex>
+#include <string_view>
 
+#include "engine/core/misc/hash_value.h"
 #include "engine/core/misc/hashed_string.h"
 #include "engine/core/lexgine_core_fwd.h"
 #include "engine/core/entity.h"
@@ -30,22 +32,26 @@ private:
         lexgine::core::D3DDataBlob const& serialized_root_signature);
 
     Microsoft::WRL::ComPtr<ID3D12RootSignature> find(
-        std::string const& root_signature_friendly_name, uint32_t node_mask) const;
+        std::string_view root_signature_friendly_name, uint32_t node_mask) const;
 
 private:
     using key_type = std::pair<std::string, uint32_t>;
+    using key_view_type = std::pair<std::string_view, uint32_t>;    //!< allows looking up the cache without copying the name
 
     class key_type_hasher_and_comparator
     {
     public:
-        size_t operator()(key_type const& key) const    // hasher
+        using is_transparent = void;
+
+        size_t operator()(key_view_type const& key) const    // hasher
         {
-            uint64_t hash = misc::HashedString{ key.first }.hash();
+            misc::HashValue name_hash{ key.first.data(), key.first.size() };
+            uint64_t hash = name_hash.part1() ^ name_hash.part2();
             hash ^= static_cast<uint64_t>(key.second);
             return static_cast<size_t>(hash);
         }
 
-        bool operator()(key_type const& a, key_type const& b) const    // comparator
+        bool operator()(key_view_type const& a, key_view_type const& b) const    // comparator
         {
             return a.first == b.first && a.second == b.second;
         }
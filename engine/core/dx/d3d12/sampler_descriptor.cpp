@@ -8,6 +8,7 @@ using namespace lexgine::core::dx::d3d12;
 
 SamplerDescriptor::SamplerDescriptor(FilterPack const& filter, math::Vector4f const& border_color)
     : HashableDescriptor{ m_native }
+    , m_native()
 {
     auto uv_address = filter.getWrapModeUV();
     m_native.AddressU = d3d12Convert(uv_address.first);
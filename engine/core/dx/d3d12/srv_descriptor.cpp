@@ -10,6 +10,7 @@ SRVDescriptor::SRVDescriptor(Resource const& resource,
     SRVBufferInfo const& buffer_info) 
     : HashableDescriptor{ resource, m_native }
     , m_resource_ref{ resource }
+    , m_native()
 {
     auto resource_desc = resource.descriptor();
 
@@ -29,6 +30,7 @@ SRVDescriptor::SRVDescriptor(Resource const& resource,
     SRVTextureInfo const& texture_info, bool is_cubemap) 
     : HashableDescriptor{ resource, m_native }
     , m_resource_ref{ resource }
+    , m_native()
 {
     auto resource_desc = resource.descriptor();
 
@@ -84,6 +86,7 @@ SRVDescriptor::SRVDescriptor(Resource const& resource,
     SRVTextureArrayInfo const& texture_array_info, bool is_cubemap) 
     : HashableDescriptor{ resource, m_native }
     , m_resource_ref{ resource }
+    , m_native()
 {
     auto resource_desc = resource.descriptor();
 
@@ -51,6 +51,8 @@ SwapChainLink::SwapChainLink(Globals& globals, dxgi::SwapChain& swap_chain_to_li
     , m_device{ *m_globals.get<Device>() }
     , m_linked_swap_chain{ swap_chain_to_link }
     , m_linked_rendering_tasks_ptr{ nullptr }
+    , m_transient_resources{ m_device, HeapCreationFlags::base_values::allow_only_rt_ds, false, 0x1, 0x1 }
+    , m_depth_buffer_id{ 0U }
     , m_depth_buffer_native_format{ static_cast<DXGI_FORMAT>(depth_buffer_format) }
     , m_depth_optimized_clear_value{ m_depth_buffer_native_format, math::Vector4f{1.f, 0.f, 0.f, 0.f} }
 {
@@ -64,7 +66,8 @@ SwapChainLink::SwapChainLink(SwapChainLink&& other)
     , m_linked_swap_chain{ other.m_linked_swap_chain }
     , m_linked_rendering_tasks_ptr{ other.m_linked_rendering_tasks_ptr }
     , m_color_buffers{ std::move(other.m_color_buffers) }
-    , m_depth_buffer{ std::move(other.m_depth_buffer) }
+    , m_transient_resources{ std::move(other.m_transient_resources) }
+    , m_depth_buffer_id{ other.m_depth_buffer_id }
     , m_depth_buffer_native_format{ other.m_depth_buffer_native_format }
     , m_depth_optimized_clear_value{ std::move(other.m_depth_optimized_clear_value) }
     , m_targets{ std::move(other.m_targets) }
@@ -115,6 +118,8 @@ void SwapChainLink::render()
             ++completed_frames_count;
             frame_progress_tracker.waitForFrameCompletion(completed_frames_count);
         }
+        m_globals.get<DxResourceFactory>()->releaseRetiredDescriptors(m_device, frame_progress_tracker.completedFramesCount());
+        m_transient_resources.releaseRetiredResources();
 
         m_linked_rendering_tasks_ptr->render(target, [this](void) { m_linked_swap_chain.present(); });
     }
@@ -164,7 +169,7 @@ void SwapChainLink::releaseBuffers()
     frame_progress_tracker.synchronize();
 
     m_color_buffers.clear();
-    m_depth_buffer.reset(nullptr);
+    m_transient_resources.reset();
     m_targets.clear();
 }
 
@@ -182,9 +187,12 @@ void SwapChainLink::acquireBuffers(uint32_t width, uint32_t height)
         ResourceDescriptor::CreateTexture2D(width, height, back_buffers_count,
             m_depth_buffer_native_format, 1, ResourceFlags::base_values::depth_stencil);
 
-    m_depth_buffer = std::make_unique<CommittedResource>(m_device, ResourceState::base_values::depth_read,
-        m_depth_optimized_clear_value, descriptor, AbstractHeapType::_default,
-        HeapCreationFlags::base_values::allow_all, 0x1, 0x1);
+    // the depth buffer of the previous size is retired by the build, and the new one is initialized by the clear made
+    // at the beginning of every frame, so it may reuse the memory of the retired buffer
+    m_depth_buffer_id = m_transient_resources.declareResource(descriptor, ResourceState::base_values::depth_read,
+        misc::makeOptional<ResourceOptimizedClearValue>(m_depth_optimized_clear_value), 0U, 0U);
+    m_transient_resources.build();
+    PlacedResource const& depth_buffer = m_transient_resources.resource(m_depth_buffer_id);
 
 
     for (uint16_t i = 0U; i < m_linked_swap_chain.backBufferCount(); ++i)
@@ -198,7 +206,7 @@ void SwapChainLink::acquireBuffers(uint32_t width, uint32_t height)
         dsv_texture_array_info.mip_level_slice = 0;
         dsv_texture_array_info.first_array_element = i;
         dsv_texture_array_info.num_array_elements = 1;
-        DepthTarget depth_target{ *m_depth_buffer, ResourceState::base_values::depth_read, dsv_texture_array_info };
+        DepthTarget depth_target{ depth_buffer, ResourceState::base_values::depth_read, dsv_texture_array_info };
         depth_target.target_view.overrideFormat(getValidDepthStencilFormatFromTypelessFormat(m_depth_buffer_native_format));
 
         m_targets.emplace_back(m_globals, std::vector<ColorTarget>{ color_target }, misc::makeOptional<DepthTarget>(depth_target));
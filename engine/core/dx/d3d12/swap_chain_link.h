@@ -13,6 +13,7 @@
 #include "engine/osinteraction/windows/window_listeners.h"
 
 #include "resource.h"
+#include "heap_resource_placer.h"
 #include "rendering_target.h"
 
 
@@ -68,7 +69,8 @@ private:
     bool m_suspend_rendering = false;
 
     std::vector<Resource> m_color_buffers;
-    std::unique_ptr<CommittedResource> m_depth_buffer;
+    TransientResourceAllocator m_transient_resources;    //!< allocates the depth buffer, which is cleared by every frame
+    uint32_t m_depth_buffer_id;
 
     DXGI_FORMAT m_depth_buffer_native_format;
     ResourceOptimizedClearValue m_depth_optimized_clear_value;
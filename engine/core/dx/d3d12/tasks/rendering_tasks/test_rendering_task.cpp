@@ -8,6 +8,7 @@
 #include "engine/core/math/utility.h"
 #include "engine/core/dx/d3d12/device.h"
 #include "engine/core/dx/d3d12/basic_rendering_services.h"
+#include "engine/core/dx/d3d12/command_list_stream_backend.h"
 #include "engine/core/dx/d3d12/task_caches/root_signature_compilation_task_cache.h"
 #include "engine/core/dx/d3d12/tasks/root_signature_compilation_task.h"
 #include "engine/core/dx/d3d12/tasks/hlsl_compilation_task.h"
@@ -258,20 +259,21 @@ bool TestRenderingTask::doTask(uint8_t worker_id, uint64_t user_data)
     //cmd_list.reset();
 
     m_basic_rendering_services.beginRendering(*m_cmd_list_ptr);
-    
-    m_cmd_list_ptr->setPipelineState(m_pso->getTaskData());
-    m_cmd_list_ptr->setRootSignature(m_rs->getCacheName());
 
     m_basic_rendering_services.setDefaultResources(*m_cmd_list_ptr);
     m_basic_rendering_services.setDefaultViewport(*m_cmd_list_ptr);
-
-    m_cmd_list_ptr->inputAssemblySetPrimitiveTopology(PrimitiveTopology::triangle_list);
-    m_vb.bind(*m_cmd_list_ptr);
-    m_ib.bind(*m_cmd_list_ptr);
-
     m_basic_rendering_services.setDefaultRenderingTarget(*m_cmd_list_ptr);
     m_basic_rendering_services.clearDefaultRenderingTarget(*m_cmd_list_ptr);
 
+    // the draw is recorded into the command stream, so that it can be inspected or replayed without the command list
+    m_command_stream.clear();
+    m_command_stream.setPipelineState(m_pso->getTaskData());
+    m_command_stream.setRootSignature(m_rs->getCacheName());
+
+    m_command_stream.setPrimitiveTopology(PrimitiveTopology::triangle_list);
+    m_vb.bind(m_command_stream);
+    m_ib.bind(m_command_stream);
+
     long long new_timestamp = std::chrono::high_resolution_clock::now().time_since_epoch().count();
     float duration = (new_timestamp - m_timestamp) / 1e9f;
     m_box_rotation_angle += static_cast<float>(math::pi * duration * .5f);
@@ -280,10 +282,13 @@ bool TestRenderingTask::doTask(uint8_t worker_id, uint64_t user_data)
     m_allocation =
         m_basic_rendering_services.constantDataStream().allocateAndUpdate(m_cb_data_mapping);
 
-    m_shader_function.bindRootConstantBuffer(*m_cmd_list_ptr, dxcompilation::ShaderFunctionConstantBufferRootIds::scene_uniforms, m_allocation->virtualGpuAddress());
-    m_shader_function.bindResourceDescriptors(*m_cmd_list_ptr, dxcompilation::ShaderFunction::ShaderInputKind::srv, 0);
-    m_shader_function.bindResourceDescriptors(*m_cmd_list_ptr, dxcompilation::ShaderFunction::ShaderInputKind::sampler, 0);
-    m_cmd_list_ptr->drawIndexedInstanced(36, 1, 0, 0, 0);
+    m_shader_function.bindRootConstantBuffer(m_command_stream, dxcompilation::ShaderFunctionConstantBufferRootIds::scene_uniforms, m_allocation->virtualGpuAddress());
+    m_shader_function.bindResourceDescriptors(m_command_stream, dxcompilation::ShaderFunction::ShaderInputKind::srv, 0);
+    m_shader_function.bindResourceDescriptors(m_command_stream, dxcompilation::ShaderFunction::ShaderInputKind::sampler, 0);
+    m_command_stream.drawIndexedInstanced(36, 1, 0, 0, 0);
+
+    CommandListStreamBackend command_list_backend{ *m_cmd_list_ptr };
+    m_command_stream.replay(command_list_backend);
 
     //cmd_list.close();
 
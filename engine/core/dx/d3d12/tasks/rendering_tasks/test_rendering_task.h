@@ -6,6 +6,7 @@
 #include "engine/core/dx/d3d12/tasks/lexgine_core_dx_d3d12_tasks_fwd.h"
 #include "engine/core/concurrency/schedulable_task.h"
 
+#include "engine/core/dx/d3d12/command_stream.h"
 #include "engine/core/dx/d3d12/resource_data_uploader.h"
 #include "engine/core/dx/d3d12/vertex_buffer.h"
 #include "engine/core/dx/d3d12/constant_buffer_data_mapper.h"
@@ -26,6 +27,8 @@ public:
 
     void updateRenderingConfiguration(RenderingConfigurationUpdateFlags update_flags, RenderingConfiguration const& rendering_configuration) override;
 
+    CommandStream const& commandStream() const { return m_command_stream; }    //! returns the draw commands recorded by the last execution of the task
+
 private:    // required by AbstractTask interface
     bool doTask(uint8_t worker_id, uint64_t user_data) override;
     concurrency::TaskType type() const override { return concurrency::TaskType::cpu; }
@@ -60,6 +63,7 @@ private:
     PerFrameUploadDataStreamAllocator::address_type m_allocation;
 
     CommandList* m_cmd_list_ptr = nullptr;
+    CommandStream m_command_stream;
 
     dxcompilation::ShaderFunction m_shader_function;
 };
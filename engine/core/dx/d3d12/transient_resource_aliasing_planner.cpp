@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+#include "transient_resource_aliasing_planner.h"
+
+using namespace lexgine::core::dx::d3d12;
+
+namespace {
+
+uint64_t alignOffset(uint64_t offset, uint64_t alignment)
+{
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+bool doLifetimesOverlap(TransientResourceRequest const& a, TransientResourceRequest const& b)
+{
+    return a.first_use <= b.last_use && b.first_use <= a.last_use;
+}
+
+}
+
+
+uint32_t TransientResourceAliasingPlanner::addResource(TransientResourceRequest const& request)
+{
+    assert(request.size > 0 && request.first_use <= request.last_use);
+    assert(request.alignment > 0 && (request.alignment & (request.alignment - 1)) == 0);
+
+    m_requests.push_back(request);
+    return static_cast<uint32_t>(m_requests.size() - 1);
+}
+
+TransientAliasingPlan TransientResourceAliasingPlanner::plan() const
+{
+    uint32_t const resource_count = static_cast<uint32_t>(m_requests.size());
+    TransientAliasingPlan rv{ .heap_size = 0U, .unaliased_heap_size = 0U, .offsets = std::vector<uint64_t>(resource_count, 0U), .barriers = {} };
+
+    for (uint32_t i = 0; i < resource_count; ++i)
+    {
+        rv.offsets[i] = alignOffset(rv.unaliased_heap_size, m_requests[i].alignment);
+        rv.unaliased_heap_size = rv.offsets[i] + m_requests[i].size;
+    }
+    rv.heap_size = rv.unaliased_heap_size;
+
+    // the resources that are the hardest to fit into the gaps left by the others are placed first. Since the padding
+    // caused by the alignment may outweigh the difference in size, the orders by alignment and by size are both tried
+    std::vector<uint32_t> placement_order(resource_count);
+    std::vector<uint64_t> offsets(resource_count);
+    std::vector<std::pair<uint64_t, uint64_t>> occupied_ranges{};
+    for (bool is_alignment_first : { true, false })
+    {
+        std::iota(placement_order.begin(), placement_order.end(), 0U);
+        std::sort(placement_order.begin(), placement_order.end(),
+            [this, is_alignment_first](uint32_t a, uint32_t b)
+            {
+                TransientResourceRequest const& ra = m_requests[a];
+                TransientResourceRequest const& rb = m_requests[b];
+                if (is_alignment_first && ra.alignment != rb.alignment) return ra.alignment > rb.alignment;
+                if (ra.size != rb.size) return ra.size > rb.size;
+                if (ra.first_use != rb.first_use) return ra.first_use < rb.first_use;
+                return a < b;
+            });
+
+        uint64_t heap_size{ 0U };
+        for (uint32_t k = 0; k < resource_count; ++k)
+        {
+            uint32_t const i = placement_order[k];
+            TransientResourceRequest const& request = m_requests[i];
+
+            // only the memory of the resources that are alive at the same time is unavailable
+            occupied_ranges.clear();
+            for (uint32_t l = 0; l < k; ++l)
+            {
+                uint32_t const j = placement_order[l];
+                if (doLifetimesOverlap(request, m_requests[j]))
+                {
+                    occupied_ranges.emplace_back(offsets[j], offsets[j] + m_requests[j].size);
+                }
+            }
+            std::sort(occupied_ranges.begin(), occupied_ranges.end());
+
+            uint64_t offset{ 0U };
+            for (auto const& [range_begin, range_end] : occupied_ranges)
+            {
+                if (alignOffset(offset, request.alignment) + request.size <= range_begin) break;
+                offset = (std::max)(offset, range_end);
+            }
+            offsets[i] = alignOffset(offset, request.alignment);
+            heap_size = (std::max)(heap_size, offsets[i] + request.size);
+        }
+
+        // the resources are only aliased when it saves memory compared to placing them one after another
+        if (heap_size < rv.heap_size)
+        {
+            rv.heap_size = heap_size;
+            rv.offsets = offsets;
+        }
+    }
+
+    // aliasing barriers
+    auto do_memory_ranges_overlap = [&rv, this](uint32_t a, uint32_t b)
+    {
+        return rv.offsets[a] < rv.offsets[b] + m_requests[b].size && rv.offsets[b] < rv.offsets[a] + m_requests[a].size;
+    };
+
+    std::vector<uint32_t> predecessors{};
+    for (uint32_t i = 0; i < resource_count; ++i)
+    {
+        TransientResourceRequest const& request = m_requests[i];
+
+        bool is_memory_shared{ false };
+        predecessors.clear();
+        for (uint32_t j = 0; j < resource_count; ++j)
+        {
+            if (j == i || !do_memory_ranges_overlap(i, j)) continue;
+
+            is_memory_shared = true;
+            if (m_requests[j].last_use < request.first_use) predecessors.push_back(j);
+        }
+        if (!is_memory_shared) continue;
+
+        // the predecessor is irrelevant if its part of the memory has been taken over by another predecessor later on
+        auto is_superseded = [&](uint32_t p)
+        {
+            uint64_t const shared_begin = (std::max)(rv.offsets[p], rv.offsets[i]);
+            uint64_t const shared_end = (std::min)(rv.offsets[p] + m_requests[p].size, rv.offsets[i] + request.size);
+            return std::any_of(predecessors.begin(), predecessors.end(),
+                [&](uint32_t q)
+                {
+                    return m_requests[q].first_use > m_requests[p].last_use
+                        && rv.offsets[q] <= shared_begin && shared_end <= rv.offsets[q] + m_requests[q].size;
+                });
+        };
+        uint32_t relevant_predecessor_count{ 0U };
+        uint32_t resource_before{ TransientAliasingBarrier::c_any_resource };
+        for (uint32_t p : predecessors)
+        {
+            if (is_superseded(p)) continue;
+            ++relevant_predecessor_count;
+            resource_before = p;
+        }
+
+        rv.barriers.push_back(TransientAliasingBarrier{ .use_index = request.first_use,
+            .resource_before = relevant_predecessor_count == 1 ? resource_before : TransientAliasingBarrier::c_any_resource,
+            .resource_after = i });
+    }
+
+    std::sort(rv.barriers.begin(), rv.barriers.end(),
+        [](TransientAliasingBarrier const& a, TransientAliasingBarrier const& b)
+        {
+            return a.use_index < b.use_index || a.use_index == b.use_index && a.resource_after < b.resource_after;
+        });
+
+    return rv;
+}
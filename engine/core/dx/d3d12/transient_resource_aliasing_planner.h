@@ -0,0 +1,63 @@
+#ifndef LEXGINE_CORE_DX_D3D12_TRANSIENT_RESOURCE_ALIASING_PLANNER_H
+#define LEXGINE_CORE_DX_D3D12_TRANSIENT_RESOURCE_ALIASING_PLANNER_H
+
+#include <cstdint>
+#include <vector>
+
+namespace lexgine::core::dx::d3d12 {
+
+//! Memory requirements and lifetime of a transient resource
+struct TransientResourceRequest final
+{
+    uint64_t size;    //!< size of the resource in bytes
+    uint64_t alignment;    //!< required placement alignment, must be a power of two
+    uint32_t first_use;    //!< index of the first use of the resource within the frame (e.g. index of the first pass accessing it)
+    uint32_t last_use;    //!< index of the last use of the resource within the frame, inclusive
+};
+
+//! Aliasing barrier, which must be recorded before the given use in order to activate the resource in the shared memory
+struct TransientAliasingBarrier final
+{
+    static constexpr uint32_t c_any_resource = static_cast<uint32_t>(-1);
+
+    uint32_t use_index;    //!< the barrier must precede this use
+    uint32_t resource_before;    //!< resource that has previously occupied the memory or c_any_resource if it is not unique
+    uint32_t resource_after;    //!< resource being activated
+};
+
+//! Placement of the transient resources within the shared heap
+struct TransientAliasingPlan final
+{
+    uint64_t heap_size;    //!< size of the heap needed to accommodate all resources with aliasing
+    uint64_t unaliased_heap_size;    //!< size of the heap needed if the resources were placed one after another without aliasing
+    std::vector<uint64_t> offsets;    //!< offsets of the resources in the heap in the order of their requests
+    std::vector<TransientAliasingBarrier> barriers;    //!< aliasing barriers sorted by their use indices
+};
+
+
+/*! Packs transient resources into a single heap so that the resources with non-overlapping lifetimes share memory. The placement
+ is found by the weighted variant of interval graph colouring: the resources are placed in the order of decreasing size, each at the
+ lowest suitably aligned offset, which does not intersect the memory of the already placed resources that are alive at the same time.
+ Whenever a resource begins its lifetime in memory previously occupied by another resource, an aliasing barrier is issued. The memory
+ shared with the resources that are used later in the frame is assumed to be occupied by them at the beginning of the frame, since
+ the plan is normally executed every frame.
+ Note that the contents of an aliased resource are undefined upon activation, so that its first use must fully initialize it
+ (e.g. by clear, discard or copy)
+*/
+class TransientResourceAliasingPlanner final
+{
+public:
+    uint32_t addResource(TransientResourceRequest const& request);    //! adds resource and returns its index in the plan
+
+    TransientAliasingPlan plan() const;
+
+    size_t resourceCount() const { return m_requests.size(); }
+    void clear() { m_requests.clear(); }
+
+private:
+    std::vector<TransientResourceRequest> m_requests;
+};
+
+}
+
+#endif
@@ -11,6 +11,7 @@ UAVDescriptor::UAVDescriptor(Resource const& resource,
     Resource const* p_counter_resource)
     : m_resource_ref{ resource }
     , m_counter_resource_ptr{ p_counter_resource }
+    , m_native()
 {
     auto resource_desc = resource.descriptor();
 
@@ -30,6 +31,7 @@ UAVDescriptor::UAVDescriptor(Resource const& resource,
     Resource const* p_counter_resource)
     : m_resource_ref{ resource }
     , m_counter_resource_ptr{ p_counter_resource }
+    , m_native()
 {
     auto resource_desc = resource.descriptor();
 
@@ -67,6 +69,7 @@ UAVDescriptor::UAVDescriptor(Resource const& resource,
     Resource const* p_counter_resource)
     : m_resource_ref{ resource }
     , m_counter_resource_ptr{ p_counter_resource }
+    , m_native()
 {
     auto resource_desc = resource.descriptor();
 
@@ -7,20 +7,63 @@
 
 namespace lexgine::core::dx::d3d12 {
 
-UnorderedSRVTableAllocationManager::UnorderedSRVTableAllocationManager(DescriptorHeap& descriptor_heap)
-    : DescriptorAllocationManager{ descriptor_heap }
+UnorderedSRVTableAllocationManager::UnorderedSRVTableAllocationManager(DescriptorHeap& descriptor_heap, DescriptorCache& descriptor_cache)
+    : DescriptorAllocationManager{ descriptor_heap.getDescriptorTable(DescriptorRange{
+        .offset = 0U, .count = descriptor_heap.capacity(), .block = DescriptorRange::c_invalid_block, .generation = 0U }) }
+    , m_descriptor_cache{ descriptor_cache }
 {
     
 }
 
-size_t UnorderedSRVTableAllocationManager::getOrCreateDescriptor(size_t offset_hint, SRVDescriptor const& desc)
+UnorderedSRVTableAllocationManager::UnorderedSRVTableAllocationManager(UnorderedSRVTableAllocationManager const& other)
+    : DescriptorAllocationManager{ other }
+    , m_descriptor_cache{ other.m_descriptor_cache }
 {
-    if (!m_srv_lut.count(desc))
+
+}
+
+UnorderedSRVTableAllocationManager::~UnorderedSRVTableAllocationManager()
+{
+    for (auto const& [descriptor_hash, offset] : m_srv_lut)
+    {
+        m_descriptor_cache.release(descriptor_hash);
+    }
+}
+
+std::unique_ptr<DescriptorAllocationManager> UnorderedSRVTableAllocationManager::clone() const
+{
+    return std::make_unique<UnorderedSRVTableAllocationManager>(*this);
+}
+
+bool UnorderedSRVTableAllocationManager::build(size_t /* allocator_capacity */)
+{
+    return true;
+}
+
+size_t UnorderedSRVTableAllocationManager::getOrCreateDescriptor(size_t /* offset_hint */, SRVDescriptor const& desc)
+{
+    // the hint is ignored: the slot is chosen by the descriptor cache, and the equivalent descriptors share the slot
+    misc::HashValue const descriptor_hash = desc.hash();
+
+    std::lock_guard<std::mutex> lock{ m_srv_lut_mutex };
+    if (auto p = m_srv_lut.find(descriptor_hash); p != m_srv_lut.end())
+    {
+        return p->second;
+    }
+
+    DescriptorHeap& descriptor_heap = *getDescriptorTable().p_heap;
+    DescriptorCacheLookup lookup = m_descriptor_cache.acquire(descriptor_hash, 1U,
+        [&descriptor_heap, &desc](DescriptorRange const& range)
+        {
+            descriptor_heap.createShaderResourceViewDescriptor(range.offset, desc);
+        });
+    if (lookup.range.isNull())
     {
-        m_srv_lut[desc] = createDescriptor(offset_hint, desc, &DescriptorHeap::createShaderResourceViewDescriptor);
+        return INVALID_POINTER;
     }
 
-    return m_srv_lut[desc];
+    m_srv_lut.emplace(descriptor_hash, lookup.range.offset);
+    return lookup.range.offset;
 }
 
 }
\ No newline at end of file
@@ -1,7 +1,7 @@
 #ifndef LEXGINE_CORE_DX_D3D12_UNORDERED_SRV_TABLE_ALLOCATION_MANAGER_H
 #define LEXGINE_CORE_DX_D3D12_UNORDERED_SRV_TABLE_ALLOCATION_MANAGER_H
 
-#include <atomic>
+#include <mutex>
 #include <unordered_map>
 
 #include "engine/core/class_names.h"
@@ -9,31 +9,45 @@
 #include "engine/core/dx/d3d12/hashable_descriptor.h"
 #include "engine/core/dx/d3d12/lexgine_core_dx_d3d12_fwd.h"
 #include "engine/core/dx/d3d12/descriptor_heap.h"
-#include "engine/core/dx/d3d12/descriptor_table_builders.h"
+#include "engine/core/dx/d3d12/descriptor_cache.h"
 
 #include "descriptor_allocation_manager.h"
 
 
 namespace lexgine::core::dx::d3d12 {
 
+/*! Bindless table of shader resource views, which spans the whole descriptor heap, so that the offsets returned by the manager
+ are indices of the descriptors in the heap. The descriptors are acquired from the descriptor cache of the heap and are thus shared
+ by all users of the heap. Each copy of the manager holds its own references to the descriptors it has created, which are released
+ when the copy is destroyed
+*/
 class UnorderedSRVTableAllocationManager final : public DescriptorAllocationManager
 {
 public:
-    UnorderedSRVTableAllocationManager(DescriptorHeap& descriptor_heap);
+    UnorderedSRVTableAllocationManager(DescriptorHeap& descriptor_heap, DescriptorCache& descriptor_cache);
+    UnorderedSRVTableAllocationManager(UnorderedSRVTableAllocationManager const& other);    //! the copy does not share the references of the original
+    ~UnorderedSRVTableAllocationManager();
+
+    UnorderedSRVTableAllocationManager& operator=(UnorderedSRVTableAllocationManager const&) = delete;
+
+    std::unique_ptr<DescriptorAllocationManager> clone() const override;
+    bool build(size_t allocator_capacity) override;    //! the table always spans the whole heap, so there is nothing to allocate
     size_t getOrCreateDescriptor(size_t offset_hint, SRVDescriptor const& desc) override;
     
 
 private:
-    struct DescriptorHasher
+    struct DescriptorHashHasher
     {
-        size_t operator()(const SRVDescriptor& descriptor) const
+        size_t operator()(misc::HashValue const& descriptor_hash) const
         {
-            return descriptor.hash().part1() ^ descriptor.hash().part2();
+            return static_cast<size_t>(descriptor_hash.part1());
         }
     };
 
 private:
-    std::unordered_map<SRVDescriptor, size_t, DescriptorHasher> m_srv_lut;
+    DescriptorCache& m_descriptor_cache;
+    std::mutex m_srv_lut_mutex;
+    std::unordered_map<misc::HashValue, size_t, DescriptorHashHasher> m_srv_lut;    //!< offsets of the descriptors referenced by this manager keyed by hashes of the descriptors
 };
 
 } // namespace lexgine::core::dx::d3d12
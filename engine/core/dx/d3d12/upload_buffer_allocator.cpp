@@ -1,5 +1,11 @@
+#include <algorithm>
+#include <format>
+#include <vector>
+
 #include "engine/core/globals.h"
 #include "engine/core/exception.h"
+#include "engine/core/global_settings.h"
+#include "engine/core/misc/misc.h"
 
 #include "engine/core/dx/d3d12/dx_resource_factory.h"
 #include "engine/core/dx/d3d12/heap.h"
@@ -61,69 +67,129 @@ UploadDataBlock::UploadDataBlock(UploadDataAllocator const& allocator,
 
 
 
+namespace
+{
+
+//! Small indices identifying the threads. Indices of the finished threads are reused by the threads created later
+class ThreadOrdinalRegistry final
+{
+public:
+    uint32_t acquire()
+    {
+        std::lock_guard<std::mutex> lock{ m_access_semaphore };
+        if (m_free_ordinals.empty()) return m_ordinal_count++;
+
+        uint32_t rv = m_free_ordinals.back();
+        m_free_ordinals.pop_back();
+        return rv;
+    }
+
+    void release(uint32_t ordinal)
+    {
+        std::lock_guard<std::mutex> lock{ m_access_semaphore };
+        m_free_ordinals.push_back(ordinal);
+    }
+
+private:
+    std::mutex m_access_semaphore;
+    std::vector<uint32_t> m_free_ordinals;
+    uint32_t m_ordinal_count = 0U;
+};
+
+ThreadOrdinalRegistry& threadOrdinalRegistry()
+{
+    static ThreadOrdinalRegistry registry{};
+    return registry;
+}
+
+struct ThreadOrdinal final
+{
+    ThreadOrdinal() : value{ threadOrdinalRegistry().acquire() } {}
+    ~ThreadOrdinal() { threadOrdinalRegistry().release(value); }
+
+    uint32_t const value;
+};
+
+uint32_t currentThreadOrdinal()
+{
+    thread_local ThreadOrdinal ordinal{};
+    return ordinal.value;
+}
+
+}
+
+
 UploadDataAllocator::UploadDataAllocator(Globals& globals,
     uint64_t offset_from_heap_start, size_t upload_buffer_size)
-    : m_upload_heap{ globals.get<DxResourceFactory>()->retrieveUploadHeap(*globals.get<Device>()) }
-    , m_upload_buffer{ m_upload_heap, offset_from_heap_start, ResourceState::base_values::generic_read,
-        misc::Optional<ResourceOptimizedClearValue>{}, ResourceDescriptor::CreateBuffer(upload_buffer_size) }
-    , m_max_non_blocking_allocation_timeout{ globals.get<GlobalSettings>()->getMaxNonBlockingUploadBufferAllocationTimeout() }
+    : m_max_non_blocking_allocation_timeout{ globals.get<GlobalSettings>()->getMaxNonBlockingUploadBufferAllocationTimeout() }
     , m_buffer_size{ upload_buffer_size }
-    , m_unpartitioned_chunk_size{ upload_buffer_size }
 {
-    assert(offset_from_heap_start + upload_buffer_size <= m_upload_heap.capacity());
+    Heap const& upload_heap = globals.get<DxResourceFactory>()->retrieveUploadHeap(*globals.get<Device>());
+    assert(offset_from_heap_start + upload_buffer_size <= upload_heap.capacity());
 
-    m_upload_buffer_cpu_address = m_upload_buffer.map();
-    m_upload_buffer_gpu_virtual_address = m_upload_buffer.getGPUVirtualAddress();
+    m_upload_buffer = std::make_unique<PlacedResource>(upload_heap, offset_from_heap_start, ResourceState::base_values::generic_read,
+        misc::Optional<ResourceOptimizedClearValue>{}, ResourceDescriptor::CreateBuffer(upload_buffer_size));
+    m_upload_buffer_cpu_address = m_upload_buffer->map();
+    m_upload_buffer_gpu_virtual_address = m_upload_buffer->getGPUVirtualAddress();
 
-    m_blocks.emplace_back(allocation_bucket{});
-    m_allocation_hint = { m_blocks.begin(), m_blocks.back().begin() };
+    initializeChunks();
+}
+
+UploadDataAllocator::UploadDataAllocator(void* upload_memory_cpu_address, uint64_t upload_memory_gpu_virtual_address, size_t upload_memory_size,
+    uint32_t max_non_blocking_allocation_timeout)
+    : m_max_non_blocking_allocation_timeout{ max_non_blocking_allocation_timeout }
+    , m_buffer_size{ upload_memory_size }
+    , m_upload_buffer_cpu_address{ upload_memory_cpu_address }
+    , m_upload_buffer_gpu_virtual_address{ upload_memory_gpu_virtual_address }
+{
+    initializeChunks();
 }
 
 UploadDataAllocator::~UploadDataAllocator()
 {
-    m_upload_buffer.unmap();
+    if (m_upload_buffer)
+    {
+        m_upload_buffer->unmap();
+    }
 }
 
 UploadDataAllocator::address_type UploadDataAllocator::allocate(size_t size_in_bytes, bool is_blocking_call)
 {
     assert(size_in_bytes != 0);
 
-    std::lock_guard<std::mutex> lock{ m_access_semaphore };
-	size_in_bytes = misc::align(size_in_bytes, 256);
-    
-    // try to allocate space in unpartitioned part of the buffer
-    if (m_unpartitioned_chunk_size >= size_in_bytes)
+    size_in_bytes = misc::align(size_in_bytes, c_allocation_alignment);
+    if (size_in_bytes > static_cast<uint64_t>(m_chunk_size) * m_chunk_count)
     {
-        uint32_t new_allocation_start = m_buffer_size - m_unpartitioned_chunk_size;
-        uint32_t new_allocation_end = static_cast<uint32_t>(new_allocation_start + size_in_bytes);
-        assert(new_allocation_end - new_allocation_start <= m_unpartitioned_chunk_size);
-		assert(new_allocation_end <= m_buffer_size);
-        memory_block_type& new_memory_block = allocateNewMemoryBlock(new_allocation_start, new_allocation_end);
-        m_unpartitioned_chunk_size -= (new_allocation_end - new_allocation_start);
-        assert(m_unpartitioned_chunk_size <= m_buffer_size);
-        return { &new_memory_block };
+        LEXGINE_LOG_ERROR(this,
+            std::format("Unable to allocate {} bytes in upload buffer. Requested size exceeds capacity of the buffer ({} bytes)",
+                size_in_bytes, m_buffer_size));
+        return { nullptr };
     }
 
-    // Attempt to allocate space at current allocation hint
-    address_type result = allocateInternal(size_in_bytes, is_blocking_call);
-    if (result) {
-        return result;
+    address_type result{ nullptr };
+    if (size_in_bytes > m_chunk_size / 4)
+    {
+        result = allocateChunkRun(static_cast<uint32_t>(size_in_bytes), is_blocking_call);
     }
-
-    // Allocation failed. Reset allocation hint and try allocating space at the beginning of the buffer
-    m_allocation_hint.bucket_iter = m_blocks.begin();
-    m_allocation_hint.block_iter = m_blocks.front().begin();
-    result = allocateInternal(size_in_bytes, is_blocking_call);
-    if (result) {
-        return result;
+    else if (uint32_t thread_ordinal = currentThreadOrdinal(); thread_ordinal < c_max_recording_threads)
+    {
+        result = suballocate(m_thread_chunks[thread_ordinal], static_cast<uint32_t>(size_in_bytes), is_blocking_call);
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock{ m_shared_chunk_access_semaphore };
+        result = suballocate(m_shared_chunk, static_cast<uint32_t>(size_in_bytes), is_blocking_call);
     }
 
-    // Unable to allocate more space, the buffer is exhausted
-    LEXGINE_LOG_ERROR(this,
-        std::format("Unable to allocate {} bytes in upload buffer. Requested size exceeds the remaining capacity of the buffer ({} bytes)",
-            size_in_bytes, m_unpartitioned_chunk_size));
+    if (!result)
+    {
+        // Unable to allocate more space, the buffer is exhausted
+        LEXGINE_LOG_ERROR(this,
+            std::format("Unable to allocate {} bytes in upload buffer. The buffer ({} bytes) is still in use",
+                size_in_bytes, m_buffer_size));
+    }
 
-    return { nullptr };
+    return result;
 }
 
 uint64_t UploadDataAllocator::completedWork() const
@@ -141,159 +207,158 @@ uint64_t UploadDataAllocator::recordingWork() const
     return nextValueOfControllingSignal();
 }
 
-size_t UploadDataAllocator::getPartitionsCount() const
+uint64_t UploadDataAllocator::getUnpartitionedCapacity() const
 {
-    return std::accumulate(m_blocks.begin(), m_blocks.end(), static_cast<size_t>(0),
-        [](size_t accumulator, allocation_bucket const& block) { return accumulator + block.size(); });
+    uint64_t issued_chunk_count = (std::min)(m_chunk_ticket_counter.load(std::memory_order_relaxed), static_cast<uint64_t>(m_chunk_count));
+    return (m_chunk_count - issued_chunk_count) * m_chunk_size;
 }
 
 Resource const& UploadDataAllocator::getUploadResource() const
 {
-    return m_upload_buffer;
+    assert(m_upload_buffer);
+    return *m_upload_buffer;
+}
+
+void UploadDataAllocator::initializeChunks()
+{
+    m_chunk_size = static_cast<uint32_t>((std::min)(m_buffer_size, static_cast<uint64_t>(c_chunk_size)) / c_allocation_alignment * c_allocation_alignment);
+    m_chunk_count = m_chunk_size > 0 ? static_cast<uint32_t>(m_buffer_size / m_chunk_size) : 0U;
+
+    m_chunk_ticket_counter.store(0U, std::memory_order_relaxed);
+    m_chunk_slots.reset(new ChunkSlot[m_chunk_count]);
+    m_thread_chunks.reset(new ThreadChunk[c_max_recording_threads]);
+}
+
+UploadDataAllocator::address_type UploadDataAllocator::suballocate(ThreadChunk& thread_chunk, uint32_t size_in_bytes, bool is_blocking_call)
+{
+    uint64_t next_controlling_signal_value = nextValueOfControllingSignal();
+    if (thread_chunk.controlling_signal_value != next_controlling_signal_value
+        || thread_chunk.allocation_end - thread_chunk.allocation_begin < size_in_bytes)
+    {
+        // the remainder of the current chunk is abandoned: it gets reclaimed together with the rest of the chunk
+        int64_t slot_index = acquireChunks(1U, next_controlling_signal_value, is_blocking_call);
+        if (slot_index < 0)
+        {
+            return { nullptr };
+        }
+
+        thread_chunk.slot_index = static_cast<uint32_t>(slot_index);
+        thread_chunk.allocation_begin = thread_chunk.slot_index * m_chunk_size;
+        thread_chunk.allocation_end = thread_chunk.allocation_begin + m_chunk_size;
+        thread_chunk.controlling_signal_value = next_controlling_signal_value;
+    }
+
+    memory_block_type& memory_block = emplaceMemoryBlock(thread_chunk.slot_index, next_controlling_signal_value,
+        thread_chunk.allocation_begin, thread_chunk.allocation_begin + size_in_bytes);
+    thread_chunk.allocation_begin += size_in_bytes;
+    return { &memory_block };
 }
 
-UploadDataAllocator::address_type UploadDataAllocator::allocateInternal(size_t size_in_bytes, bool is_blocking_call)
+UploadDataAllocator::address_type UploadDataAllocator::allocateChunkRun(uint32_t size_in_bytes, bool is_blocking_call)
 {
-	uint64_t next_controlling_signal_value = nextValueOfControllingSignal();
-    if (m_allocation_hint.bucket_iter->empty() || m_allocation_hint.block()->m_controlling_signal_value == next_controlling_signal_value)
+    uint64_t next_controlling_signal_value = nextValueOfControllingSignal();
+    uint32_t chunk_count = (size_in_bytes + m_chunk_size - 1) / m_chunk_size;
+    int64_t slot_index = acquireChunks(chunk_count, next_controlling_signal_value, is_blocking_call);
+    if (slot_index < 0)
     {
         return { nullptr };
     }
 
-    // attempt to allocate space within the "allocation hint" (wrap-around mode)
-    size_t space_retrieved{ 0 };
-    uint64_t controlling_signal_value{ 0 };
-	size_t begin_of_new_allocation = m_allocation_hint.block()->m_allocation_begin;
-	size_t trailing_end_allocation_addr{ begin_of_new_allocation };
-    list_of_allocation_buckets::iterator p{};
-    allocation_bucket::iterator q{};
-    for (p = m_allocation_hint.bucket_iter; p != m_blocks.end(); ++p) {
-        for (q = (p == m_allocation_hint.bucket_iter ? m_allocation_hint.block_iter : p->begin());
-            space_retrieved < size_in_bytes && q != p->end();
-            ++q) {
-            memory_block_type& memory_block = *q;
-            if (memory_block->m_controlling_signal_value == next_controlling_signal_value)
-            {
-                break;
-            }
+    uint32_t allocation_begin = static_cast<uint32_t>(slot_index) * m_chunk_size;
+    memory_block_type& memory_block = emplaceMemoryBlock(static_cast<uint32_t>(slot_index), next_controlling_signal_value,
+        allocation_begin, allocation_begin + size_in_bytes);
+    return { &memory_block };
+}
 
-            size_t current_end_addr = memory_block->m_allocation_end;
-            if (current_end_addr >= trailing_end_allocation_addr)
-            {
-                space_retrieved += (current_end_addr - trailing_end_allocation_addr);
-                trailing_end_allocation_addr = current_end_addr; 
-            }
-			controlling_signal_value = (std::max)(controlling_signal_value, memory_block->m_controlling_signal_value);
-        }
+int64_t UploadDataAllocator::acquireChunks(uint32_t chunk_count, uint64_t controlling_signal_value, bool is_blocking_call)
+{
+    assert(chunk_count > 0);
+    if (chunk_count > m_chunk_count) return -1;
 
-        if (space_retrieved >= size_in_bytes) {
-            break;
-        }
+    // runs of chunks never wrap around the end of the buffer, the trailing chunks that cannot fit the run are skipped
+    uint64_t ticket = m_chunk_ticket_counter.load(std::memory_order_relaxed);
+    uint64_t skipped_chunk_count{};
+    do
+    {
+        uint64_t first_chunk = ticket % m_chunk_count;
+        skipped_chunk_count = first_chunk + chunk_count > m_chunk_count ? m_chunk_count - first_chunk : 0U;
+    } while (!m_chunk_ticket_counter.compare_exchange_weak(ticket, ticket + skipped_chunk_count + chunk_count, std::memory_order_relaxed));
 
-        if (q != p->end() && (*q)->m_controlling_signal_value == next_controlling_signal_value) {
-            break;
-        }
+    for (uint64_t t = ticket; t < ticket + skipped_chunk_count; ++t)
+    {
+        passChunkSlot(m_chunk_slots[t % m_chunk_count], t / m_chunk_count, controlling_signal_value, false, is_blocking_call);
     }
 
-    if (p == m_blocks.end()) {
-        // all blocks seem to allow retirement, try to combine their space with unpartitioned remainder of the buffer
-        space_retrieved += m_unpartitioned_chunk_size;
+    // the tickets have already been taken, so the slots are passed to the next round even if the run cannot be acquired
+    uint64_t const first_ticket = ticket + skipped_chunk_count;
+    bool is_acquired{ true };
+    for (uint64_t t = first_ticket; t < first_ticket + chunk_count; ++t)
+    {
+        is_acquired = passChunkSlot(m_chunk_slots[t % m_chunk_count], t / m_chunk_count, controlling_signal_value, is_acquired, is_blocking_call);
     }
 
-    if (space_retrieved >= size_in_bytes) {
-        // allocation after the last block succeeded
+    return is_acquired ? static_cast<int64_t>(first_ticket % m_chunk_count) : -1;
+}
 
-        if (is_blocking_call) {
-            waitUntilControllingSignalValue(controlling_signal_value);
-        }
-        else if (!waitUntilControllingSignalValue(controlling_signal_value, m_max_non_blocking_allocation_timeout)) {
-            return { nullptr };
-        }
+bool UploadDataAllocator::passChunkSlot(ChunkSlot& slot, uint64_t round, uint64_t controlling_signal_value, bool reclaim, bool is_blocking_call)
+{
+    // the slot must be passed by the previous round first
+    for (uint64_t completed_round_count = slot.completed_round_count.load(std::memory_order_acquire);
+        completed_round_count < round;
+        completed_round_count = slot.completed_round_count.load(std::memory_order_acquire))
+    {
+        slot.completed_round_count.wait(completed_round_count, std::memory_order_acquire);
+    }
 
-        // Reclaim memory
-        for (auto p1 = m_allocation_hint.bucket_iter; p1 != (p != m_blocks.end() ? std::next(p) : m_blocks.end()); ++p1)
+    // the chunk still used by the work being recorded cannot be reclaimed without waiting for that very work, i.e. the buffer is exhausted
+    bool is_reclaimed{ false };
+    if (reclaim && slot.controlling_signal_value < controlling_signal_value)
+    {
+        is_reclaimed = lastSignaledValueOfControllingSignal() >= slot.controlling_signal_value;
+        if (!is_reclaimed)
         {
-            for (auto q1 = (p1 == m_allocation_hint.bucket_iter ? m_allocation_hint.block_iter : p1->begin());
-                q1 != (p1 != p ? p1->end() : q);
-                ++q1)
+            std::lock_guard<std::mutex> lock{ m_signal_wait_semaphore };
+            if (is_blocking_call)
             {
-                memory_block_type& memory_block = *q1;
-                memory_block->m_allocation_begin = memory_block->m_allocation_end = trailing_end_allocation_addr;
+                waitUntilControllingSignalValue(slot.controlling_signal_value);
+                is_reclaimed = true;
             }
-        }
-        
-        memory_block_type& reused_memory_block = m_allocation_hint.block();
-        size_t end_of_new_allocation = begin_of_new_allocation + size_in_bytes;
-        reused_memory_block->m_allocation_begin = begin_of_new_allocation;
-        reused_memory_block->m_allocation_end = end_of_new_allocation;
-        reused_memory_block->m_controlling_signal_value = next_controlling_signal_value;
-
-        ++m_allocation_hint.block_iter;
-        if (m_allocation_hint.block_iter == m_allocation_hint.bucket_iter->end()) {
-            ++m_allocation_hint.bucket_iter;
-            if (m_allocation_hint.bucket_iter != m_blocks.end()) {
-                m_allocation_hint.block_iter = m_allocation_hint.bucket_iter->begin();
-            }
-        }
-
-        if (trailing_end_allocation_addr > end_of_new_allocation) 
-        {
-            // some unpartitioned space remained, attempt to track it within one of retired memory blocks
-            if (m_allocation_hint.bucket_iter != m_blocks.end()) {
-                memory_block_type& memory_block = m_allocation_hint.block();
-                uint64_t last_value_of_control_signal = lastSignaledValueOfControllingSignal();
-                if (memory_block->m_controlling_signal_value <= last_value_of_control_signal)
-                {
-                    memory_block->m_allocation_begin = end_of_new_allocation;
-                    memory_block->m_allocation_end = (std::max)(static_cast<uint32_t>(trailing_end_allocation_addr), memory_block->m_allocation_end);
-                }
-                else
-                {
-                    reused_memory_block->m_allocation_end = trailing_end_allocation_addr;
-                }
-            }
-            else 
+            else
             {
-                // trailing memory partitions are exhausted, add the remaining space to unpartitioned chunk
-                m_unpartitioned_chunk_size += (trailing_end_allocation_addr - end_of_new_allocation);
-                assert(m_unpartitioned_chunk_size <= m_buffer_size);
+                is_reclaimed = waitUntilControllingSignalValue(slot.controlling_signal_value, m_max_non_blocking_allocation_timeout);
             }
         }
-        else if(p == m_blocks.end())
-        {
-            m_unpartitioned_chunk_size -= (end_of_new_allocation - trailing_end_allocation_addr);
-            assert(m_unpartitioned_chunk_size <= m_buffer_size);
-        }
-        else {
-            assert(trailing_end_allocation_addr == end_of_new_allocation);
-        }
 
-        if (m_allocation_hint.bucket_iter == m_blocks.end()) {
-            // wrap around
-            m_allocation_hint.bucket_iter = m_blocks.begin();
-            m_allocation_hint.block_iter = m_blocks.front().begin();
+        if (is_reclaimed)
+        {
+            slot.controlling_signal_value = controlling_signal_value;
+            slot.block_count = 0U;
         }
-
-		assert(reused_memory_block->m_allocation_end - reused_memory_block->m_allocation_begin >= size_in_bytes);
-		assert(reused_memory_block->m_allocation_end <= m_buffer_size);
-        return { &reused_memory_block };
     }
 
-
-    return { nullptr };
+    slot.completed_round_count.store(round + 1, std::memory_order_release);
+    slot.completed_round_count.notify_all();
+    return is_reclaimed;
 }
 
-UploadDataAllocator::memory_block_type& UploadDataAllocator::allocateNewMemoryBlock(uint32_t allocation_begin_address, uint32_t allocation_end_address)
+UploadDataAllocator::memory_block_type& UploadDataAllocator::emplaceMemoryBlock(uint32_t slot_index, uint64_t controlling_signal_value,
+    uint32_t allocation_begin, uint32_t allocation_end)
 {
-    if (m_blocks.back().exhausted())
+    assert(allocation_end <= m_buffer_size);
+
+    ChunkSlot& slot = m_chunk_slots[slot_index];
+    if (slot.block_count == slot.blocks.size())
     {
-        m_blocks.emplace_back(allocation_bucket{});
+        ++slot.block_count;
+        return slot.blocks.emplace_back(*this, m_upload_buffer_cpu_address, m_upload_buffer_gpu_virtual_address,
+            controlling_signal_value, allocation_begin, allocation_end);
     }
-    allocation_bucket& last_bucket = m_blocks.back();
-    last_bucket.emplace_back(*this, m_upload_buffer_cpu_address, m_upload_buffer_gpu_virtual_address,
-        nextValueOfControllingSignal(), allocation_begin_address, allocation_end_address);
 
-    return last_bucket.back();
+    memory_block_type& reused_memory_block = slot.blocks[slot.block_count++];
+    reused_memory_block->m_controlling_signal_value = controlling_signal_value;
+    reused_memory_block->m_allocation_begin = allocation_begin;
+    reused_memory_block->m_allocation_end = allocation_end;
+    return reused_memory_block;
 }
 
 
@@ -1,7 +1,9 @@
 #ifndef LEXGINE_CORE_DX_D3D12_UPLOAD_BUFFER_ALLOCATOR
 #define LEXGINE_CORE_DX_D3D12_UPLOAD_BUFFER_ALLOCATOR
 
-#include <list>
+#include <atomic>
+#include <deque>
+#include <memory>
 #include <mutex>
 
 #include "engine/core/entity.h"
@@ -10,7 +12,6 @@
 #include "engine/core/dx/d3d12/lexgine_core_dx_d3d12_fwd.h"
 #include "engine/core/dx/d3d12/resource.h"
 #include "engine/core/dx/d3d12/signal.h"
-#include "engine/core/misc/static_vector.h"
 
 
 namespace lexgine::core::dx::d3d12
@@ -47,12 +48,23 @@ private:
     uint32_t m_allocation_end;
 };
 
+/*! Ring allocator of upload memory shared by the recording threads. The buffer is split into chunks, which are handed out
+ to the threads by an atomic bump of the chunk ticket counter. A chunk can only be reused after the controlling signal has crossed
+ the value that was current when the chunk was handed out the last time. Each thread suballocates the small blocks privately
+ from its own chunk, so that no locks are taken on the way. Allocations larger than a quarter of a chunk receive a dedicated
+ contiguous run of chunks. All allocations are aligned on 256-byte boundaries. The allocations made while the controlling signal
+ has certain "next value" must be completed before this value gets signaled
+*/
 class UploadDataAllocator : public Allocator<UploadDataBlock>,
     public NamedEntity<class_names::D3D12_UploadBufferAllocator>
 {
 public:
     using address_type = t_address_type<memory_block_type*>;
 
+    static constexpr uint32_t c_allocation_alignment = 256U;
+    static constexpr uint32_t c_chunk_size = 1U << 16;
+    static constexpr uint32_t c_max_recording_threads = 64U;    //!< threads beyond this count share a single chunk guarded by a lock
+
 public:
     UploadDataAllocator(Globals& globals,
         uint64_t offset_from_heap_start, size_t upload_buffer_size);
@@ -66,21 +78,33 @@ public:
     uint64_t recordingWork() const;
     uint64_t totalCapacity() const { return m_buffer_size; }
 
-    size_t getPartitionsCount() const;
-    uint64_t getUnpartitionedCapacity() const { return m_unpartitioned_chunk_size; }
+    size_t getPartitionsCount() const { return m_chunk_count; }    //! returns number of chunks the buffer is split into
+    uint64_t getUnpartitionedCapacity() const;    //! returns capacity of the chunks that have never been handed out
 
     Resource const& getUploadResource() const;
 
+protected:
+    //! Creates allocator over the upload memory not owned by the allocator, e.g. the memory emulating upload buffer for testing purposes
+    UploadDataAllocator(void* upload_memory_cpu_address, uint64_t upload_memory_gpu_virtual_address, size_t upload_memory_size,
+        uint32_t max_non_blocking_allocation_timeout);
+
 private:
-    using allocation_bucket = misc::StaticVector<memory_block_type, 200>;
-    using list_of_allocation_buckets = std::list<allocation_bucket>;
-    
-    struct allocation_iterator
+    //! Chunk of the buffer. The chunks are handed out in rounds, each round visits every chunk of the buffer exactly once
+    struct alignas(64) ChunkSlot
     {
-        list_of_allocation_buckets::iterator bucket_iter;
-        allocation_bucket::iterator block_iter;
+        std::atomic_uint64_t completed_round_count{ 0U };    //!< number of rounds that have already passed the chunk
+        uint64_t controlling_signal_value{ 0U };    //!< signal value, after which the chunk can be reused
+        std::deque<memory_block_type> blocks;    //!< blocks allocated from the chunk, only accessed by the thread owning the chunk
+        size_t block_count{ 0U };    //!< number of the blocks in use, the remaining blocks are kept for reuse
+    };
 
-        memory_block_type& block() { return *block_iter; }
+    //! Chunk owned by a recording thread
+    struct alignas(64) ThreadChunk
+    {
+        uint32_t slot_index{ 0U };
+        uint32_t allocation_begin{ 0U };
+        uint32_t allocation_end{ 0U };
+        uint64_t controlling_signal_value{ 0U };
     };
 
 private:
@@ -90,24 +114,37 @@ private:
     virtual uint64_t lastSignaledValueOfControllingSignal() const = 0;
     virtual uint64_t lastRecordedValueOfControllingSignal() const = 0;
 
-    address_type allocateInternal(size_t size_in_bytes, bool is_blocking_call);
-    memory_block_type& allocateNewMemoryBlock(uint32_t allocation_begin_address, uint32_t allocation_end_address);
+    void initializeChunks();
+    address_type suballocate(ThreadChunk& thread_chunk, uint32_t size_in_bytes, bool is_blocking_call);
+    address_type allocateChunkRun(uint32_t size_in_bytes, bool is_blocking_call);
+
+    /*! Acquires run of contiguous chunks that can be filled with the data recorded while the controlling signal has the given value.
+     Returns index of the first acquired chunk or -1 if the chunks are still in use
+    */
+    int64_t acquireChunks(uint32_t chunk_count, uint64_t controlling_signal_value, bool is_blocking_call);
+
+    //! Passes the chunk slot to the next round. Returns 'true' if the slot has been reclaimed for the given signal value
+    bool passChunkSlot(ChunkSlot& slot, uint64_t round, uint64_t controlling_signal_value, bool reclaim, bool is_blocking_call);
+
+    memory_block_type& emplaceMemoryBlock(uint32_t slot_index, uint64_t controlling_signal_value, uint32_t allocation_begin, uint32_t allocation_end);
 
 private:
-    Heap const& m_upload_heap;
-    PlacedResource m_upload_buffer;
+    std::unique_ptr<PlacedResource> m_upload_buffer;    //!< upload buffer or nullptr if the allocator does not own the upload memory
     uint32_t const m_max_non_blocking_allocation_timeout;
 
     uint64_t const m_buffer_size{};
-    uint64_t m_unpartitioned_chunk_size;
+    uint32_t m_chunk_size;
+    uint32_t m_chunk_count;
 
     void* m_upload_buffer_cpu_address;
     uint64_t m_upload_buffer_gpu_virtual_address;
 
-    list_of_allocation_buckets m_blocks;
-    allocation_iterator m_allocation_hint;
-
-    std::mutex m_access_semaphore;
+    std::atomic_uint64_t m_chunk_ticket_counter;
+    std::unique_ptr<ChunkSlot[]> m_chunk_slots;
+    std::unique_ptr<ThreadChunk[]> m_thread_chunks;
+    ThreadChunk m_shared_chunk;
+    std::mutex m_shared_chunk_access_semaphore;
+    std::mutex m_signal_wait_semaphore;    //!< signals can only be waited for by one thread at a time
 };
 
 
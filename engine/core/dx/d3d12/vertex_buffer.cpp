@@ -84,6 +84,25 @@ void VertexBuffer::bind(CommandList& command_list) const
     command_list.inputAssemblySetVertexBuffers(m_vertex_buffer_binding);
 }
 
+void VertexBuffer::bind(CommandStream& command_stream) const
+{
+    // each contiguous range of the used slots is recorded by a single command
+    uint32_t const mask = m_vertex_buffer_binding.slotUsageMask();
+    uint32_t slot{ 0U };
+    while (mask >> slot)
+    {
+        while (!((mask >> slot) & 1U)) ++slot;
+
+        uint32_t range_end{ slot };
+        while ((mask >> range_end) & 1U) ++range_end;
+
+        command_stream.setVertexBuffers(slot,
+            reinterpret_cast<CommandStreamVertexBufferView const*>(&m_vertex_buffer_binding.vertexBufferViewAtSlot(static_cast<uint8_t>(slot))),
+            range_end - slot);
+        slot = range_end;
+    }
+}
+
 
 IndexBuffer::IndexBuffer(Device const& device, IndexDataType index_type, uint32_t indices_count,
     uint32_t node_mask/* = 0x1*/, uint32_t node_exposure_mask/* = 0x1*/, bool allow_cross_adapter/* = false*/)
@@ -131,3 +150,8 @@ void IndexBuffer::bind(CommandList& command_list)
 {
     command_list.inputAssemblySetIndexBuffer(*m_index_buffer_binding);
 }
+
+void IndexBuffer::bind(CommandStream& command_stream)
+{
+    command_stream.setIndexBuffer(reinterpret_cast<CommandStreamIndexBufferView const&>(m_index_buffer_binding->indexBufferView()));
+}
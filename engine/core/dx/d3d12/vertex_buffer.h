@@ -26,6 +26,7 @@ public:
     CommittedResource const& resource() const;
 
     void bind(CommandList& command_list) const;    //! records vertex buffer binding into the given command list
+    void bind(CommandStream& command_stream) const;    //! records vertex buffer binding into the given command stream
 
 
 private:
@@ -63,6 +64,7 @@ public:
     CommittedResource const& resource() const;
 
     void bind(CommandList& command_list);    //! records index buffer binding into the given command list
+    void bind(CommandStream& command_stream);    //! records index buffer binding into the given command stream
 
 private:
     std::unique_ptr<CommittedResource> m_index_buffer;
@@ -20,6 +20,7 @@
 #include "engine/core/dx/d3d12/task_caches/root_signature_compilation_task_cache.h"
 
 #include "engine/conversion/texture_converter.h"
+#include "engine/core/concurrency/asset_scheduler.h"
 
 
 using namespace lexgine;
@@ -108,12 +109,14 @@ D3D12Initializer::D3D12Initializer(D3D12EngineSettings const& settings)
         m_pso_cache = std::make_unique<dx::d3d12::task_caches::PSOCompilationTaskCache>();
         m_rs_cache = std::make_unique<dx::d3d12::task_caches::RootSignatureCompilationTaskCache>();
     }
+    m_asset_scheduler = std::make_unique<concurrency::AssetScheduler>(m_global_settings->getNumberOfWorkers(), "AssetScheduler");
     buildGlobals();
     setCurrentDevice(0);
 }
 
 D3D12Initializer::~D3D12Initializer()
 {
+    m_asset_scheduler.reset();    // the asset processing tasks still running may use any of the objects below
     m_texture_converter.reset();
     m_shader_cache.reset();
     m_rs_cache.reset();
@@ -196,6 +199,7 @@ void D3D12Initializer::buildGlobals()
     m_globals->put(m_shader_cache.get());
     m_globals->put(m_pso_cache.get());
     m_globals->put(m_rs_cache.get());
+    m_globals->put(m_asset_scheduler.get());
 }
 
 
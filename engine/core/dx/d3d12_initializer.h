@@ -14,6 +14,7 @@
 #include "engine/core/dx/d3d12/swap_chain_link.h"
 
 #include "engine/core/dx/d3d12/task_caches/lexgine_core_dx_d3d12_task_caches_fwd.h"
+#include "engine/core/concurrency/lexgine_core_concurrency_fwd.h"
 
 #include "engine/core/dx/d3d12/interface.h"
 #include "engine/core/dx/dxgi/interface.h"
@@ -94,6 +95,7 @@ private:
     std::unique_ptr<dx::d3d12::task_caches::PSOCompilationTaskCache> m_pso_cache;
     std::unique_ptr<dx::d3d12::task_caches::RootSignatureCompilationTaskCache> m_rs_cache;
     std::unique_ptr<conversion::TextureConverter> m_texture_converter;
+    std::unique_ptr<concurrency::AssetScheduler> m_asset_scheduler;    //!< worker pool shared by all asset processing jobs, e.g. assembly of materials during scene loads
 };
 
 }
@@ -8,6 +8,7 @@
 #include "engine/core/dx/d3d12/descriptor_heap.h"
 #include "engine/core/dx/d3d12/device.h"
 #include "engine/core/dx/d3d12/command_list.h"
+#include "engine/core/dx/d3d12/command_stream.h"
 #include "engine/core/dx/d3d12/tasks/root_signature_compilation_task.h"
 #include "shader_function.h"
 #include "shader_stage.h"
@@ -88,6 +89,13 @@ void ShaderFunction::bindRootConstantBuffer(core::dx::d3d12::CommandList& comman
     command_list.setRootConstantBufferView(m_root_uniforms_to_rs_slots_mapping[id], gpu_virtual_address);
 }
 
+void ShaderFunction::bindRootConstantBuffer(core::dx::d3d12::CommandStream& command_stream,
+    ShaderFunctionConstantBufferRootIds id,
+    uint64_t gpu_virtual_address)
+{
+    command_stream.setRootConstantBufferView(m_root_uniforms_to_rs_slots_mapping[id], gpu_virtual_address);
+}
+
 bool ShaderFunction::assignResourceDescriptors(ShaderInputKind resource_kind, uint32_t resource_space_id, const core::dx::d3d12::DescriptorAllocationManager& allocation_manager)
 {
     DescriptorTableKey key{ .kind = resource_kind, .space_id = resource_space_id };
@@ -104,23 +112,18 @@ bool ShaderFunction::assignResourceDescriptors(ShaderInputKind resource_kind, ui
         return false;
     }
 
-    if (!m_descriptor_table_allocators.count(key))
-    {
-        m_descriptor_table_allocators.insert(std::make_pair(key, allocation_manager));
-    }
-    else
-    {
-        m_descriptor_table_allocators.at(key) = allocation_manager;
-    }
+    // the manager is cloned, since the managers specializing descriptor creation must retain their dynamic type
+    m_descriptor_table_allocators[key] = allocation_manager.clone();
 
-    bool buildResult = m_descriptor_table_allocators.at(key).build(m_descriptor_table_capacities[key]);
+    bool buildResult = m_descriptor_table_allocators.at(key)->build(m_descriptor_table_capacities[key]);
     buildResult;
     assert(buildResult);
 
     return true;
 }
 
-bool ShaderFunction::bindResourceDescriptors(core::dx::d3d12::CommandList& command_list, ShaderInputKind kind, uint32_t space_id)
+template<typename T>
+bool ShaderFunction::bindResourceDescriptorsInternal(T& command_recorder, ShaderInputKind kind, uint32_t space_id)
 {
     DescriptorTableKey key{ .kind = kind, .space_id = space_id };
     if (m_descriptor_table_allocators.count(key) == 0)
@@ -136,12 +139,22 @@ bool ShaderFunction::bindResourceDescriptors(core::dx::d3d12::CommandList& comma
     }
 
     uint32_t root_signature_slot = m_descriptor_table_keys_to_rs_slots_mapping.at(key);
-    core::dx::d3d12::DescriptorAllocationManager const& descriptor_allocation_manager = m_descriptor_table_allocators.at(key);
-    command_list.setRootDescriptorTable(root_signature_slot, descriptor_allocation_manager.getDescriptorTable().gpu_pointer);
+    core::dx::d3d12::DescriptorAllocationManager const& descriptor_allocation_manager = *m_descriptor_table_allocators.at(key);
+    command_recorder.setRootDescriptorTable(root_signature_slot, descriptor_allocation_manager.getDescriptorTable().gpu_pointer);
     
     return true;
 }
 
+bool ShaderFunction::bindResourceDescriptors(core::dx::d3d12::CommandList& command_list, ShaderInputKind kind, uint32_t space_id)
+{
+    return bindResourceDescriptorsInternal(command_list, kind, space_id);
+}
+
+bool ShaderFunction::bindResourceDescriptors(core::dx::d3d12::CommandStream& command_stream, ShaderInputKind kind, uint32_t space_id)
+{
+    return bindResourceDescriptorsInternal(command_stream, kind, space_id);
+}
+
 void ShaderFunction::buildInternal()
 {
     if (!m_shader_function_stale) {
@@ -81,9 +81,13 @@ public:
     void bindRootConstantBuffer(core::dx::d3d12::CommandList& command_list, 
         ShaderFunctionConstantBufferRootIds id, 
         uint64_t gpu_virtual_address);
+    void bindRootConstantBuffer(core::dx::d3d12::CommandStream& command_stream,
+        ShaderFunctionConstantBufferRootIds id,
+        uint64_t gpu_virtual_address);
 
     bool assignResourceDescriptors(ShaderInputKind resource_kind, uint32_t resource_space_id, const core::dx::d3d12::DescriptorAllocationManager& allocation_manager);
     bool bindResourceDescriptors(core::dx::d3d12::CommandList& command_list, ShaderInputKind kind, uint32_t space_id);
+    bool bindResourceDescriptors(core::dx::d3d12::CommandStream& command_stream, ShaderInputKind kind, uint32_t space_id);
 
 private:
     struct ShaderInputDesc
@@ -114,6 +118,9 @@ private:
 private:
     void buildInternal();
 
+    template<typename T>
+    bool bindResourceDescriptorsInternal(T& command_recorder, ShaderInputKind kind, uint32_t space_id);    //! T is either a command list or a command stream
+
 private:
     d3d12::Device& m_device;
     ShaderFunctionRootUniformBuffers m_flags;
@@ -128,7 +135,7 @@ private:
     std::unordered_map<ShaderFunctionConstantBufferRootIds, uint32_t> m_root_uniforms_to_rs_slots_mapping;
     std::unordered_map<DescriptorTableKey, uint32_t, DescriptorTableKeyHash> m_descriptor_table_keys_to_rs_slots_mapping;
     std::unordered_map<DescriptorTableKey, size_t, DescriptorTableKeyHash> m_descriptor_table_capacities;
-    std::unordered_map<DescriptorTableKey, core::dx::d3d12::DescriptorAllocationManager, DescriptorTableKeyHash> m_descriptor_table_allocators;
+    std::unordered_map<DescriptorTableKey, std::unique_ptr<core::dx::d3d12::DescriptorAllocationManager>, DescriptorTableKeyHash> m_descriptor_table_allocators;
 
     uint32_t m_occupied_rs_slots{ 0 };
 
@@ -159,7 +166,7 @@ class ShaderFunctionAttorney<ShaderStage>
             return nullptr;
         }
 
-        return &shader_function.m_descriptor_table_allocators.at(key);
+        return shader_function.m_descriptor_table_allocators.at(key).get();
     }
 
     static AtomicCounterDesc allocateAtomicCounter(ShaderFunction& shader_function)
@@ -164,10 +164,10 @@ unsigned int ShaderStage::getInstructionCount()
     return static_cast<unsigned int>(m_shader_desc.InstructionCount);
 }
 
-BindingResult ShaderStage::bindTexture(misc::HashedString const& name, d3d12::Resource const& texture, uint32_t register_offset/* = 0*/)
+BindingResult ShaderStage::bindTexture(misc::HashedString const& name, d3d12::Resource const& texture, uint32_t register_offset/* = 0*/, float resource_min_lod_clamp/* = 0.f*/)
 {
     return bindInternal(name, register_offset,
-        [this, &texture, register_offset]
+        [this, &texture, register_offset, resource_min_lod_clamp]
         (ShaderFunction::ShaderBindingPoint const& binding_point, d3d12::DescriptorAllocationManager* p_allocator) -> size_t
         {
             assert(binding_point.kind == ShaderFunction::ShaderInputKind::srv);
@@ -178,6 +178,7 @@ BindingResult ShaderStage::bindTexture(misc::HashedString const& name, d3d12::Re
                 || texture_info.resource_type == TextureResourceType::texture3d);
 
             d3d12::SRVTextureInfo info {};
+            info.resource_min_lod_clamp = resource_min_lod_clamp;
             return p_allocator->getOrCreateDescriptor(binding_point.first_register + register_offset, core::dx::d3d12::SRVDescriptor { texture, info, texture_info.is_cube });
         }
     );
@@ -75,7 +75,10 @@ public:
 
     unsigned int getInstructionCount();
 
-    BindingResult bindTexture(misc::HashedString const& name, d3d12::Resource const& texture, uint32_t register_offset = 0);
+    /*! Binds texture to the shader. The view of the texture can be restricted to the mipmap levels starting from resource_min_lod_clamp,
+     so that the levels, which have not been streamed in yet, are never sampled
+    */
+    BindingResult bindTexture(misc::HashedString const& name, d3d12::Resource const& texture, uint32_t register_offset = 0, float resource_min_lod_clamp = 0.f);
     BindingResult bindTextureArray(misc::HashedString const& name, d3d12::Resource const& texture,
         uint32_t first_array_element, uint32_t array_element_count, uint32_t register_offset = 0);
     BindingResult bindTextureBuffer(misc::HashedString const& name, d3d12::Resource const& buffer_texture, uint64_t first_buffer_element, uint32_t buffer_element_stride, uint32_t register_offset = 0);
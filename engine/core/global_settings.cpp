@@ -89,6 +89,12 @@ GlobalSettings::GlobalSettings(std::filesystem::path const& json_settings_source
         m_enable_cache = true;
         m_enable_gpu_accelerated_texture_conversion = false;
         m_enable_inverse_depth_clip_space = true;
+        m_texture_streaming_memory_budget = 0;    // texture streaming is disabled by default
+        m_texture_streaming_mipmap_tail_budget = 1024 * 64;    // 64KBs by default
+        m_texture_streaming_upload_budget_per_frame = 1024 * 1024 * 32;    // 32MBs by default
+        m_optimize_meshes_on_import = false;
+        m_quantize_vertices_on_import = false;
+        m_build_meshlets_on_import = false;
 
         {
             // Descriptor heaps total and per-page capacity default settings
@@ -405,6 +411,69 @@ GlobalSettings::GlobalSettings(std::filesystem::path const& json_settings_source
                 m_enable_inverse_depth_clip_space);
 		}
 
+        if ((p = document.find("texture_streaming_memory_budget")) != document.end()
+            && p->is_number_unsigned())
+        {
+            m_texture_streaming_memory_budget = p->get<uint64_t>();
+        }
+        else
+        {
+            yield_warning_log_message("texture_streaming_memory_budget",
+                std::to_string(m_texture_streaming_memory_budget / 1024 / 1024) + "MBs");
+        }
+
+        if ((p = document.find("texture_streaming_mipmap_tail_budget")) != document.end()
+            && p->is_number_unsigned())
+        {
+            m_texture_streaming_mipmap_tail_budget = p->get<uint64_t>();
+        }
+        else
+        {
+            yield_warning_log_message("texture_streaming_mipmap_tail_budget",
+                std::to_string(m_texture_streaming_mipmap_tail_budget / 1024) + "KBs");
+        }
+
+        if ((p = document.find("texture_streaming_upload_budget_per_frame")) != document.end()
+            && p->is_number_unsigned())
+        {
+            m_texture_streaming_upload_budget_per_frame = p->get<uint64_t>();
+        }
+        else
+        {
+            yield_warning_log_message("texture_streaming_upload_budget_per_frame",
+                std::to_string(m_texture_streaming_upload_budget_per_frame / 1024 / 1024) + "MBs");
+        }
+
+        if ((p = document.find("optimize_meshes_on_import")) != document.end()
+            && p->is_boolean())
+        {
+            m_optimize_meshes_on_import = p->get<bool>();
+        }
+        else
+        {
+            yield_warning_log_message("optimize_meshes_on_import", m_optimize_meshes_on_import);
+        }
+
+        if ((p = document.find("quantize_vertices_on_import")) != document.end()
+            && p->is_boolean())
+        {
+            m_quantize_vertices_on_import = p->get<bool>();
+        }
+        else
+        {
+            yield_warning_log_message("quantize_vertices_on_import", m_quantize_vertices_on_import);
+        }
+
+        if ((p = document.find("build_meshlets_on_import")) != document.end()
+            && p->is_boolean())
+        {
+            m_build_meshlets_on_import = p->get<bool>();
+        }
+        else
+        {
+            yield_warning_log_message("build_meshlets_on_import", m_build_meshlets_on_import);
+        }
+
 
         {
             // Descriptor heaps total and per-page capacity settings
@@ -513,6 +582,12 @@ void GlobalSettings::serialize(std::string const& json_serialization_path) const
         { "enable_async_copy", m_enable_async_copy },
         { "max_frames_in_flight", m_max_frames_in_flight },
         { "max_non_blocking_upload_buffer_allocation_timeout", m_max_non_blocking_upload_buffer_allocation_timeout },
+        { "texture_streaming_memory_budget", m_texture_streaming_memory_budget },
+        { "texture_streaming_mipmap_tail_budget", m_texture_streaming_mipmap_tail_budget },
+        { "texture_streaming_upload_budget_per_frame", m_texture_streaming_upload_budget_per_frame },
+        { "optimize_meshes_on_import", m_optimize_meshes_on_import },
+        { "quantize_vertices_on_import", m_quantize_vertices_on_import },
+        { "build_meshlets_on_import", m_build_meshlets_on_import },
 
         { "resource_view_descriptors_count", m_descriptor_heap_capacity[static_cast<size_t>(DescriptorHeapType::cbv_srv_uav)] },
         { "sampler_descriptors_count", m_descriptor_heap_capacity[static_cast<size_t>(DescriptorHeapType::sampler)] },
@@ -651,6 +726,36 @@ bool GlobalSettings::isInverseDepthClipSpaceEnabled() const
     return m_enable_inverse_depth_clip_space;
 }
 
+uint64_t GlobalSettings::getTextureStreamingMemoryBudget() const
+{
+    return m_texture_streaming_memory_budget;
+}
+
+uint64_t GlobalSettings::getTextureStreamingMipmapTailBudget() const
+{
+    return m_texture_streaming_mipmap_tail_budget;
+}
+
+uint64_t GlobalSettings::getTextureStreamingUploadBudgetPerFrame() const
+{
+    return m_texture_streaming_upload_budget_per_frame;
+}
+
+bool GlobalSettings::isMeshOptimizationOnImportEnabled() const
+{
+    return m_optimize_meshes_on_import;
+}
+
+bool GlobalSettings::isVertexQuantizationOnImportEnabled() const
+{
+    return m_quantize_vertices_on_import;
+}
+
+bool GlobalSettings::isMeshletGenerationOnImportEnabled() const
+{
+    return m_build_meshlets_on_import;
+}
+
 void GlobalSettings::setNumberOfWorkers(uint8_t num_workers)
 {
     m_number_of_workers = num_workers;
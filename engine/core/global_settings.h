@@ -53,6 +53,13 @@ public:
     bool isGpuAcceleratedTextureConversionEnabled() const;
     bool isInverseDepthClipSpaceEnabled() const;
 
+    uint64_t getTextureStreamingMemoryBudget() const;    //! returns memory budget of streamed textures. Texture streaming is disabled when the budget is 0
+    uint64_t getTextureStreamingMipmapTailBudget() const;    //! returns maximal size of mipmap tail uploaded for each streamed texture before it gets requested by the renderer
+    uint64_t getTextureStreamingUploadBudgetPerFrame() const;    //! returns maximal size of mipmap levels streamed in during a single frame
+    bool isMeshOptimizationOnImportEnabled() const;    //! returns 'true' if index and vertex data of the scene meshes get reordered for the GPU caches when the scene is imported
+    bool isVertexQuantizationOnImportEnabled() const;    //! returns 'true' if vertex attributes of the scene meshes get re-encoded into compact formats when the scene is imported
+    bool isMeshletGenerationOnImportEnabled() const;    //! returns 'true' if the scene meshes get partitioned into meshlets with culling bounds when the scene is imported
+
 
     // *** the following functions are used to alter the global settings during run time. All functions return 'true' in case of success and 'false' if the parameter's value cannot be changed ***
 
@@ -92,6 +99,12 @@ private:
     bool m_enable_cache;
     bool m_enable_gpu_accelerated_texture_conversion;
     bool m_enable_inverse_depth_clip_space;
+    uint64_t m_texture_streaming_memory_budget;
+    uint64_t m_texture_streaming_mipmap_tail_budget;
+    uint64_t m_texture_streaming_upload_budget_per_frame;
+    bool m_optimize_meshes_on_import;
+    bool m_quantize_vertices_on_import;
+    bool m_build_meshlets_on_import;
 
     std::array<uint32_t, static_cast<size_t>(dx::d3d12::DescriptorHeapType::count)> m_descriptor_heap_capacity;
 };
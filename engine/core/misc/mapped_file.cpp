@@ -0,0 +1,37 @@
+#include <windows.h>
+
+#include "mapped_file.h"
+
+
+namespace lexgine::core::misc {
+
+std::unique_ptr<MappedFile> MappedFile::open(std::filesystem::path const& file_path)
+{
+    std::unique_ptr<MappedFile> rv{ new MappedFile{} };
+
+    HANDLE hfile = CreateFileW(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (hfile == INVALID_HANDLE_VALUE) return nullptr;
+    rv->m_file_handle = hfile;
+
+    LARGE_INTEGER file_size{};
+    if (!GetFileSizeEx(hfile, &file_size) || file_size.QuadPart <= 0) return nullptr;
+    rv->m_size = static_cast<size_t>(file_size.QuadPart);
+
+    HANDLE hmapping = CreateFileMappingW(hfile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!hmapping) return nullptr;
+    rv->m_mapping_handle = hmapping;
+
+    rv->m_p_view = static_cast<uint8_t const*>(MapViewOfFile(hmapping, FILE_MAP_READ, 0, 0, 0));
+    if (!rv->m_p_view) return nullptr;
+
+    return rv;
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_p_view) UnmapViewOfFile(m_p_view);
+    if (m_mapping_handle) CloseHandle(m_mapping_handle);
+    if (m_file_handle) CloseHandle(m_file_handle);
+}
+
+}
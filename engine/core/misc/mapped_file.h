@@ -0,0 +1,39 @@
+#ifndef LEXGINE_CORE_MISC_MAPPED_FILE_H
+#define LEXGINE_CORE_MISC_MAPPED_FILE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+
+namespace lexgine::core::misc {
+
+/*! Read-only view of a whole file mapped into the address space of the process. The view starts at a boundary of the
+ system allocation granularity, so that it is suitably aligned for any data type stored at aligned offsets of the file
+*/
+class MappedFile final
+{
+public:
+    //! Maps the file into memory. Returns nullptr if the file does not exist, is empty or cannot be mapped
+    static std::unique_ptr<MappedFile> open(std::filesystem::path const& file_path);
+
+    ~MappedFile();
+
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    std::span<uint8_t const> data() const { return { m_p_view, m_size }; }
+
+private:
+    MappedFile() = default;
+
+private:
+    void* m_file_handle{ nullptr };
+    void* m_mapping_handle{ nullptr };
+    uint8_t const* m_p_view{ nullptr };
+    size_t m_size{ 0 };
+};
+
+}
+
+#endif
@@ -0,0 +1,298 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define LEXGINE_SHA256_X64
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define LEXGINE_SHA256_TARGET_SHA
+#else
+#include <cpuid.h>
+#define LEXGINE_SHA256_TARGET_SHA __attribute__((target("sha,sse4.1")))
+#endif
+#endif
+
+#include "sha256.h"
+
+namespace lexgine::core::misc {
+
+namespace {
+
+constexpr std::array<uint32_t, 8> c_initial_state = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+alignas(16) constexpr uint32_t c_round_constants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+constexpr size_t c_file_streaming_chunk_size = 1U << 20;
+
+inline uint32_t rotr(uint32_t x, uint32_t n)
+{
+    return (x >> n) | (x << (32U - n));
+}
+
+inline uint32_t loadBigEndian32(uint8_t const* p)
+{
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16)
+        | (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+inline void storeBigEndian32(uint32_t value, uint8_t* p)
+{
+    p[0] = static_cast<uint8_t>(value >> 24);
+    p[1] = static_cast<uint8_t>(value >> 16);
+    p[2] = static_cast<uint8_t>(value >> 8);
+    p[3] = static_cast<uint8_t>(value);
+}
+
+void processBlocksGeneric(uint32_t* state, uint8_t const* p_blocks, size_t block_count)
+{
+    for (size_t b = 0; b < block_count; ++b, p_blocks += Sha256::c_block_length)
+    {
+        uint32_t w[64];
+        for (uint32_t i = 0; i < 16; ++i) w[i] = loadBigEndian32(p_blocks + 4 * i);
+        for (uint32_t i = 16; i < 64; ++i)
+        {
+            uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = state[0], b_ = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (uint32_t i = 0; i < 64; ++i)
+        {
+            uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + c_round_constants[i] + w[i];
+            uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b_) ^ (a & c) ^ (b_ & c));
+            h = g; g = f; f = e; e = d + t1;
+            d = c; c = b_; b_ = a; a = t1 + t2;
+        }
+
+        state[0] += a; state[1] += b_; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    }
+}
+
+#ifdef LEXGINE_SHA256_X64
+
+bool isShaExtensionSupported()
+{
+    // SHA extensions are reported by CPUID.(EAX=7,ECX=0):EBX[29]; SSE4.1 by CPUID.(EAX=1):ECX[19]
+#ifdef _MSC_VER
+    int regs[4]{};
+    __cpuid(regs, 0);
+    if (regs[0] < 7) return false;
+    __cpuidex(regs, 1, 0);
+    bool const has_sse41 = (regs[2] & (1 << 19)) != 0;
+    __cpuidex(regs, 7, 0);
+    bool const has_sha = (regs[1] & (1 << 29)) != 0;
+#else
+    unsigned int eax{}, ebx{}, ecx{}, edx{};
+    if (__get_cpuid_max(0, nullptr) < 7) return false;
+    __cpuid_count(1, 0, eax, ebx, ecx, edx);
+    bool const has_sse41 = (ecx & (1U << 19)) != 0;
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    bool const has_sha = (ebx & (1U << 29)) != 0;
+#endif
+    return has_sse41 && has_sha;
+}
+
+LEXGINE_SHA256_TARGET_SHA
+void processBlocksShaExtensions(uint32_t* state, uint8_t const* p_blocks, size_t block_count)
+{
+    __m128i const byte_swap_mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    // Repack the state from (A, B, C, D), (E, F, G, H) to (A, B, E, F), (C, D, G, H) as expected by sha256rnds2
+    __m128i tmp = _mm_loadu_si128(reinterpret_cast<__m128i const*>(state));
+    __m128i state1 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(state + 4));
+    tmp = _mm_shuffle_epi32(tmp, 0xb1);    // CDAB
+    state1 = _mm_shuffle_epi32(state1, 0x1b);    // EFGH
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);    // ABEF
+    state1 = _mm_blend_epi16(state1, tmp, 0xf0);    // CDGH
+
+    for (size_t b = 0; b < block_count; ++b, p_blocks += Sha256::c_block_length)
+    {
+        __m128i const abef_save = state0;
+        __m128i const cdgh_save = state1;
+
+        __m128i msg[4];
+        for (int i = 0; i < 4; ++i)
+        {
+            msg[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(p_blocks + 16 * i)), byte_swap_mask);
+        }
+
+        // 16 groups of 4 rounds each. The message schedule is extended in place using a ring of four registers
+        for (int i = 0; i < 16; ++i)
+        {
+            __m128i& current = msg[i & 3];
+            if (i >= 4)
+            {
+                // W[i..i+3] = sigma1(W[i-2]) + W[i-7] + sigma0(W[i-15]) + W[i-16]
+                __m128i const& prev1 = msg[(i - 1) & 3];
+                current = _mm_sha256msg1_epu32(current, msg[(i - 3) & 3]);
+                current = _mm_add_epi32(current, _mm_alignr_epi8(prev1, msg[(i - 2) & 3], 4));
+                current = _mm_sha256msg2_epu32(current, prev1);
+            }
+
+            __m128i m = _mm_add_epi32(current, _mm_load_si128(reinterpret_cast<__m128i const*>(c_round_constants + 4 * i)));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, m);
+            m = _mm_shuffle_epi32(m, 0x0e);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, m);
+        }
+
+        state0 = _mm_add_epi32(state0, abef_save);
+        state1 = _mm_add_epi32(state1, cdgh_save);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1b);    // FEBA
+    state1 = _mm_shuffle_epi32(state1, 0xb1);    // DCHG
+    state0 = _mm_blend_epi16(tmp, state1, 0xf0);    // DCBA
+    state1 = _mm_alignr_epi8(state1, tmp, 8);    // HGFE
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), state0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), state1);
+}
+
+bool const c_sha_extensions_available = isShaExtensionSupported();
+
+#endif
+
+thread_local Sha256 t_hashing_context{};
+
+}    // namespace
+
+
+Sha256::Sha256()
+{
+    reset();
+}
+
+void Sha256::reset()
+{
+    m_state = c_initial_state;
+    m_buffer_size = 0U;
+    m_total_size = 0U;
+}
+
+void Sha256::update(void const* p_data, size_t data_size)
+{
+    uint8_t const* p_bytes = static_cast<uint8_t const*>(p_data);
+    m_total_size += data_size;
+
+    if (m_buffer_size > 0)
+    {
+        size_t const bytes_to_buffer = (std::min)(c_block_length - m_buffer_size, data_size);
+        std::memcpy(m_buffer.data() + m_buffer_size, p_bytes, bytes_to_buffer);
+        m_buffer_size += bytes_to_buffer;
+        p_bytes += bytes_to_buffer;
+        data_size -= bytes_to_buffer;
+
+        if (m_buffer_size < c_block_length) return;
+
+        processBlocks(m_buffer.data(), 1);
+        m_buffer_size = 0;
+    }
+
+    size_t const full_block_count = data_size / c_block_length;
+    if (full_block_count)
+    {
+        processBlocks(p_bytes, full_block_count);
+        p_bytes += full_block_count * c_block_length;
+        data_size -= full_block_count * c_block_length;
+    }
+
+    if (data_size)
+    {
+        std::memcpy(m_buffer.data(), p_bytes, data_size);
+        m_buffer_size = data_size;
+    }
+}
+
+Sha256::Digest Sha256::finalize()
+{
+    uint64_t const total_size_in_bits = m_total_size * 8U;
+
+    // Pad the message with a single '1' bit followed by zeros so that there remain exactly 8 bytes in the last block for the message length
+    m_buffer[m_buffer_size++] = 0x80;
+    if (m_buffer_size > c_block_length - 8U)
+    {
+        std::fill(m_buffer.begin() + m_buffer_size, m_buffer.end(), static_cast<uint8_t>(0));
+        processBlocks(m_buffer.data(), 1);
+        m_buffer_size = 0;
+    }
+    std::fill(m_buffer.begin() + m_buffer_size, m_buffer.end() - 8, static_cast<uint8_t>(0));
+    for (size_t i = 0; i < 8; ++i)
+    {
+        m_buffer[c_block_length - 1 - i] = static_cast<uint8_t>(total_size_in_bits >> (8 * i));
+    }
+    processBlocks(m_buffer.data(), 1);
+
+    Digest rv{};
+    for (size_t i = 0; i < m_state.size(); ++i)
+    {
+        storeBigEndian32(m_state[i], rv.data() + 4 * i);
+    }
+
+    reset();
+    return rv;
+}
+
+Sha256::Digest Sha256::hash(std::span<uint8_t const> data)
+{
+    t_hashing_context.reset();
+    t_hashing_context.update(data);
+    return t_hashing_context.finalize();
+}
+
+Optional<Sha256::Digest> Sha256::hashFile(std::filesystem::path const& file_path)
+{
+    std::ifstream ifile{ file_path, std::ios_base::in | std::ios_base::binary };
+    if (!ifile) return Optional<Digest>{};
+
+    thread_local std::vector<char> streaming_buffer(c_file_streaming_chunk_size);
+
+    t_hashing_context.reset();
+    std::filebuf* p_read_buffer = ifile.rdbuf();
+    std::streamsize bytes_read{};
+    while ((bytes_read = p_read_buffer->sgetn(streaming_buffer.data(), static_cast<std::streamsize>(streaming_buffer.size()))) > 0)
+    {
+        t_hashing_context.update(streaming_buffer.data(), static_cast<size_t>(bytes_read));
+    }
+
+    return Optional<Digest>{ t_hashing_context.finalize() };
+}
+
+bool Sha256::isHardwareAccelerated()
+{
+#ifdef LEXGINE_SHA256_X64
+    return c_sha_extensions_available;
+#else
+    return false;
+#endif
+}
+
+void Sha256::processBlocks(uint8_t const* p_blocks, size_t block_count)
+{
+#ifdef LEXGINE_SHA256_X64
+    if (c_sha_extensions_available)
+    {
+        processBlocksShaExtensions(m_state.data(), p_blocks, block_count);
+        return;
+    }
+#endif
+    processBlocksGeneric(m_state.data(), p_blocks, block_count);
+}
+
+}
@@ -0,0 +1,56 @@
+#ifndef LEXGINE_CORE_MISC_SHA256_H
+#define LEXGINE_CORE_MISC_SHA256_H
+
+#include <cstdint>
+#include <array>
+#include <span>
+#include <filesystem>
+
+#include "optional.h"
+
+namespace lexgine::core::misc {
+
+/*! Portable streaming SHA-256 implementation. When the host CPU supports Intel SHA extensions the block transform
+ is executed using the corresponding SIMD instructions, otherwise the generic scalar implementation is used.
+ A single Sha256 object must not be shared between threads without synchronization; use the static hashing helpers,
+ which operate on thread-local contexts, when the hash is needed from several threads at once.
+*/
+class Sha256 final
+{
+public:
+    static constexpr size_t c_digest_length = 32U;
+    static constexpr size_t c_block_length = 64U;
+
+    using Digest = std::array<uint8_t, c_digest_length>;
+
+public:
+    Sha256();
+
+    void reset();    //! resets the context so that it can be used to calculate a new hash value
+    void update(void const* p_data, size_t data_size);    //! feeds the next portion of data into the hash context
+    void update(std::span<uint8_t const> data) { update(data.data(), data.size_bytes()); }
+    Digest finalize();    //! completes calculation of the hash value and resets the context
+
+    //! Calculates hash value of the given data using thread-local hashing context
+    static Digest hash(std::span<uint8_t const> data);
+
+    /*! Calculates hash value of the raw contents of the given file by streaming it through thread-local hashing context
+     in chunks. The file is never loaded to the memory in its entirety. Returns invalid Optional<> if the file cannot be read
+    */
+    static Optional<Digest> hashFile(std::filesystem::path const& file_path);
+
+    static bool isHardwareAccelerated();    //! returns 'true' if the block transform is executed using SHA CPU extensions
+
+private:
+    void processBlocks(uint8_t const* p_blocks, size_t block_count);
+
+private:
+    std::array<uint32_t, 8> m_state;
+    std::array<uint8_t, c_block_length> m_buffer;
+    size_t m_buffer_size;
+    uint64_t m_total_size;
+};
+
+}
+
+#endif
@@ -0,0 +1,615 @@
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+
+#include "engine/core/misc/misc.h"
+#include "baked_gltf_model.h"
+
+namespace lexgine::scenegraph
+{
+
+namespace
+{
+
+/* The tables are stored as they are laid out in memory, except for the pointers, which are replaced by offsets of the
+ data they refer to from the beginning of the image. The root of the tables (i.e. the model itself) is located at offset 0,
+ so that zero offset is never referred to and denotes null pointers. Each table of elements is relocated by the same set
+ of functions below, which visit all pointers stored in an element: TableWriter replaces the pointers by offsets while
+ copying the tables into the image, and TableReader replaces the offsets by pointers into the copy of the image after
+ checking that the referred data are located inside of the image
+*/
+
+class TableWriter;
+class TableReader;
+
+template<typename T, typename Relocator>
+    requires std::is_arithmetic_v<T>
+void relocate(T&, Relocator&)
+{
+    // plain values do not contain pointers
+}
+
+template<typename Relocator> void relocate(tg3_value& value, Relocator& relocator);
+
+template<typename Relocator>
+void relocate(tg3_kv_pair& pair, Relocator& relocator)
+{
+    relocator.string(pair.key);
+    relocate(pair.value, relocator);
+}
+
+template<typename Relocator>
+void relocate(tg3_value& value, Relocator& relocator)
+{
+    relocator.string(value.string_val);
+    relocator.array(value.array_data, value.array_count);
+    relocator.array(value.object_data, value.object_count);
+    relocator.array(value.binary_val.data, value.binary_val.count);
+}
+
+template<typename Relocator>
+void relocate(tg3_extension& extension, Relocator& relocator)
+{
+    relocator.string(extension.name);
+    relocate(extension.value, relocator);
+}
+
+template<typename Relocator>
+void relocate(tg3_extras_ext& ext, Relocator& relocator)
+{
+    relocator.array(ext.extras, ext.extras ? 1U : 0U);
+    relocator.array(ext.extensions, ext.extensions_count);
+    relocator.string(ext.extras_json);
+    relocator.string(ext.extensions_json);
+}
+
+template<typename Relocator>
+void relocate(tg3_str& str, Relocator& relocator)
+{
+    relocator.string(str);
+}
+
+template<typename Relocator>
+void relocate(tg3_str_int_pair& pair, Relocator& relocator)
+{
+    relocator.string(pair.key);
+}
+
+template<typename Relocator>
+void relocate(tg3_str_int_pair const*&, Relocator&)
+{
+    // morph targets are relocated by the relocators themselves, since the sizes of the targets are stored separately
+}
+
+template<typename Relocator>
+void relocate(tg3_asset& asset, Relocator& relocator)
+{
+    relocator.string(asset.version);
+    relocator.string(asset.generator);
+    relocator.string(asset.min_version);
+    relocator.string(asset.copyright);
+    relocate(asset.ext, relocator);
+}
+
+template<typename Relocator>
+void relocate(tg3_buffer& buffer, Relocator& relocator)
+{
+    relocator.string(buffer.name);
+    buffer.data = tg3_span_u8{ nullptr, 0 };    // the data of the buffers are provided separately
+    relocator.string(buffer.uri);
+    relocate(buffer.ext, relocator);
+}
+
+template<typename Relocator>
+void relocate(tg3_buffer_view& buffer_view, Relocator& relocator)
+{
+    relocator.string(buffer_view.name);
+    relocate(buffer_view.ext, relocator);
+}
+
+template<typename Relocator>
+void relocate(tg3_accessor& accessor, Relocator& relocator)
+{
+    relocator.string(accessor.name);
+    relocator.array(accessor.min_values, accessor.min_values_count);
+    relocator.array(accessor.max_values, accessor.max_values_count);
+    relocate(accessor.sparse.indices.ext, relocator);
+    relocate(accessor.sparse.values.ext, relocator);
+    relocate(accessor.sparse.ext, relocator);
+    relocate(accessor.ext, relocator);
+}
+
+template<typename Relocator>
+void relocate(tg3_image& image, Relocator& relocator)
+{
+    relocator.string(image.name);
+    relocator.array(image.image.data, image.image.count);
+    relocator.string(image.mime_type);
+    relocator.string(image.uri);
+    relocate(image.ext, relocator);
+}
+
+template<typename Relocator>
+void relocate(tg3_sampler& sampler, Relocator& relocator)
+{
+    relocator.string(sampler.name);
+    relocate(sampler.ext, relocator);
+}
+
+template<typename Relocator>
+void relocate(tg3_texture& texture, Relocator& relocator)
+{
+    relocator.string(texture.name);
+    relocate(texture.ext, relocator);
+}
+
+template<typename Relocator>
+void relocate(tg3_material& material, Relocator& relocator)
+{
+    relocator.string(material.name);
+    relocator.string(material.alpha_mode);
+    relocator.array(material.lods, material.lods_count);
+    relocate(material.pbr_metallic_roughness.base_color_texture.ext, relocator);
+    relocate(material.pbr_metallic_roughness.metallic_roughness_texture.ext, relocator);
+    relocate(material.pbr_metallic_roughness.ext, relocator);
+    relocate(material.normal_texture.ext, relocator);
+    relocate(material.occlusion_texture.ext, relocator);
+    relocate(material.emissive_texture.ext, relocator);
+    relocate(material.ext, relocator);
+}
+
+template<typename Relocator>
+void relocate(tg3_primitive& primitive, Relocator& relocator)
+{
+    relocator.array(primitive.attributes, primitive.attributes_count);
+    relocator.morphTargets(primitive);
+    relocate(primitive.ext, relocator);
+}
+
+template<typename Relocator>
+void relocate(tg3_mesh& mesh, Relocator& relocator)
+{
+    relocator.string(mesh.name);
+    relocator.array(mesh.primitives, mesh.primitives_count);
+    relocator.array(mesh.weights, mesh.weights_count);
+    relocate(mesh.ext, relocator);
+}
+
+template<typename Relocator>
+void relocate(tg3_node& node, Relocator& relocator)
+{
+    relocator.string(node.name);
+    relocator.array(node.lods, node.lods_count);
+    relocator.array(node.children, node.children_count);
+    relocator.array(node.weights, node.weights_count);
+    relocate(node.ext, relocator);
+}
+
+template<typename Relocator>
+void relocate(tg3_skin& skin, Relocator& relocator)
+{
+    relocator.string(skin.name);
+    relocator.array(skin.joints, skin.joints_count);
+    relocate(skin.ext, relocator);
+}
+
+template<typename Relocator>
+void relocate(tg3_animation_channel& channel, Relocator& relocator)
+{
+    relocator.string(channel.target.path);
+    relocate(channel.target.ext, relocator);
+    relocate(channel.ext, relocator);
+}
+
+template<typename Relocator>
+void relocate(tg3_animation_sampler& sampler, Relocator& relocator)
+{
+    relocator.string(sampler.interpolation);
+    relocate(sampler.ext, relocator);
+}
+
+template<typename Relocator>
+void relocate(tg3_animation& animation, Relocator& relocator)
+{
+    relocator.string(animation.name);
+    relocator.array(animation.channels, animation.channels_count);
+    relocator.array(animation.samplers, animation.samplers_count);
+    relocate(animation.ext, relocator);
+}
+
+template<typename Relocator>
+void relocate(tg3_camera& camera, Relocator& relocator)
+{
+    relocator.string(camera.name);
+    relocator.string(camera.type);
+    relocate(camera.perspective.ext, relocator);
+    relocate(camera.orthographic.ext, relocator);
+    relocate(camera.ext, relocator);
+}
+
+template<typename Relocator>
+void relocate(tg3_scene& scene, Relocator& relocator)
+{
+    relocator.string(scene.name);
+    relocator.array(scene.nodes, scene.nodes_count);
+    relocator.array(scene.audio_emitters, scene.audio_emitters_count);
+    relocate(scene.ext, relocator);
+}
+
+template<typename Relocator>
+void relocate(tg3_light& light, Relocator& relocator)
+{
+    relocator.string(light.name);
+    relocator.string(light.type);
+    relocate(light.spot.ext, relocator);
+    relocate(light.ext, relocator);
+}
+
+template<typename Relocator>
+void relocate(tg3_audio_emitter& emitter, Relocator& relocator)
+{
+    relocator.string(emitter.name);
+    relocator.string(emitter.type);
+    relocator.string(emitter.distance_model);
+    relocate(emitter.positional.ext, relocator);
+    relocate(emitter.ext, relocator);
+}
+
+template<typename Relocator>
+void relocate(tg3_audio_source& source, Relocator& relocator)
+{
+    relocator.string(source.name);
+    relocator.string(source.uri);
+    relocator.string(source.mime_type);
+    relocate(source.ext, relocator);
+}
+
+template<typename Relocator>
+void relocate(tg3_model& model, Relocator& relocator)
+{
+    model.arena_ = nullptr;
+    relocator.array(model.accessors, model.accessors_count);
+    relocator.array(model.animations, model.animations_count);
+    relocator.array(model.buffers, model.buffers_count);
+    relocator.array(model.buffer_views, model.buffer_views_count);
+    relocator.array(model.materials, model.materials_count);
+    relocator.array(model.meshes, model.meshes_count);
+    relocator.array(model.nodes, model.nodes_count);
+    relocator.array(model.textures, model.textures_count);
+    relocator.array(model.images, model.images_count);
+    relocator.array(model.skins, model.skins_count);
+    relocator.array(model.samplers, model.samplers_count);
+    relocator.array(model.cameras, model.cameras_count);
+    relocator.array(model.scenes, model.scenes_count);
+    relocator.array(model.lights, model.lights_count);
+    relocator.array(model.audio_emitters, model.audio_emitters_count);
+    relocator.array(model.audio_sources, model.audio_sources_count);
+    relocator.array(model.extensions_used, model.extensions_used_count);
+    relocator.array(model.extensions_required, model.extensions_required_count);
+    relocate(model.asset, relocator);
+    relocate(model.ext, relocator);
+}
+
+
+template<typename T>
+T const* offsetToPointer(size_t offset)
+{
+    return reinterpret_cast<T const*>(static_cast<uintptr_t>(offset));
+}
+
+template<typename T>
+size_t pointerToOffset(T const* ptr)
+{
+    return static_cast<size_t>(reinterpret_cast<uintptr_t>(ptr));
+}
+
+
+//! Copies the tables into the image replacing the pointers by offsets
+class TableWriter final
+{
+public:
+    explicit TableWriter(tg3_model const& model)
+        : m_image(sizeof(tg3_model), 0)
+    {
+        tg3_model root = model;
+        relocate(root, *this);
+        std::memcpy(m_image.data(), &root, sizeof(root));
+    }
+
+    std::vector<uint8_t>& image() { return m_image; }
+
+    template<typename T>
+    void array(T const*& p_elements, uint64_t count)
+    {
+        if (!p_elements || !count)
+        {
+            p_elements = nullptr;
+            return;
+        }
+
+        // the elements are relocated before they are copied, since relocation of the element appends its own tables to the image
+        size_t const offset = reserve<T>(count);
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            T element = p_elements[i];
+            relocate(element, *this);
+            std::memcpy(m_image.data() + offset + i * sizeof(T), &element, sizeof(T));
+        }
+        p_elements = offsetToPointer<T>(offset);
+    }
+
+    void string(tg3_str& str)
+    {
+        if (!str.data)
+        {
+            str.len = 0;
+            return;
+        }
+
+        // strings are stored null-terminated, which keeps the ones passed to C APIs valid
+        size_t const offset = reserve<char>(str.len + 1ULL);
+        std::memcpy(m_image.data() + offset, str.data, str.len);
+        str.data = offsetToPointer<char>(offset);
+    }
+
+    void morphTargets(tg3_primitive& primitive)
+    {
+        if (!primitive.targets || !primitive.target_attribute_counts || !primitive.targets_count)
+        {
+            primitive.targets = nullptr;
+            primitive.target_attribute_counts = nullptr;
+            primitive.targets_count = 0;
+            return;
+        }
+
+        std::vector<tg3_str_int_pair const*> targets{ primitive.targets, primitive.targets + primitive.targets_count };
+        for (uint32_t i = 0; i < primitive.targets_count; ++i)
+        {
+            array(targets[i], primitive.target_attribute_counts[i]);
+        }
+
+        // the targets already refer to the relocated attributes, so they are copied as they are
+        size_t const offset = reserve<tg3_str_int_pair const*>(targets.size());
+        std::memcpy(m_image.data() + offset, targets.data(), targets.size() * sizeof(tg3_str_int_pair const*));
+        primitive.targets = offsetToPointer<tg3_str_int_pair const*>(offset);
+        array(primitive.target_attribute_counts, primitive.targets_count);
+    }
+
+private:
+    template<typename T>
+    size_t reserve(uint64_t count)
+    {
+        size_t const offset = core::misc::align(m_image.size(), alignof(T));
+        m_image.resize(offset + count * sizeof(T), 0);
+        return offset;
+    }
+
+private:
+    std::vector<uint8_t> m_image;
+};
+
+
+//! Replaces the offsets stored in the copy of the image by pointers into the copy
+class TableReader final
+{
+public:
+    TableReader(uint8_t* p_image, size_t image_size)
+        : m_p_image{ p_image }
+        , m_image_size{ image_size }
+    {
+    }
+
+    bool isValid() const { return m_is_valid; }
+
+    template<typename T>
+    void array(T const*& p_elements, uint64_t count)
+    {
+        T* p_relocated = locate<T>(p_elements, count);
+        p_elements = p_relocated;
+        for (uint64_t i = 0; m_is_valid && p_relocated && i < count; ++i)
+        {
+            relocate(p_relocated[i], *this);
+        }
+    }
+
+    void string(tg3_str& str)
+    {
+        char* p_str = locate<char>(str.data, str.data || str.len ? str.len + 1ULL : 0ULL);
+        str.data = p_str;
+        if (p_str && p_str[str.len] != '\0') m_is_valid = false;
+    }
+
+    void morphTargets(tg3_primitive& primitive)
+    {
+        array(primitive.target_attribute_counts, primitive.targets_count);
+        array(primitive.targets, primitive.targets_count);
+        if (!m_is_valid || !primitive.targets) return;
+
+        auto targets = const_cast<tg3_str_int_pair const**>(primitive.targets);
+        for (uint32_t i = 0; m_is_valid && i < primitive.targets_count; ++i)
+        {
+            array(targets[i], primitive.target_attribute_counts[i]);
+        }
+    }
+
+private:
+    //! returns pointer to the elements stored at the given offset or nullptr if they are not located inside of the image
+    template<typename T>
+    T* locate(T const* p_offset, uint64_t count)
+    {
+        size_t const offset = pointerToOffset(p_offset);
+        if (!offset)
+        {
+            // null pointers are only valid for empty tables
+            if (count) m_is_valid = false;
+            return nullptr;
+        }
+
+        if (!m_is_valid || offset % alignof(T) != 0 || offset >= m_image_size || count > (m_image_size - offset) / sizeof(T))
+        {
+            m_is_valid = false;
+            return nullptr;
+        }
+        return reinterpret_cast<T*>(m_p_image + offset);
+    }
+
+private:
+    uint8_t* m_p_image;
+    size_t m_image_size;
+    bool m_is_valid{ true };
+};
+
+
+//! Returns 'true' if the index refers to one of 'count' elements, or is negative when the reference is optional
+bool isIndexValid(int64_t index, uint32_t count, bool is_optional = true)
+{
+    return (is_optional && index < 0) || (index >= 0 && index < static_cast<int64_t>(count));
+}
+
+/*! Checks the references between the tables, which are followed by the import without any checks, since the tables
+ restored from a corrupted image cannot be relied upon the same way as the tables produced by the parser
+*/
+bool areReferencesValid(tg3_model const& model)
+{
+    if (!isIndexValid(model.default_scene, model.scenes_count)) return false;
+
+    for (tg3_scene const& scene : std::span{ model.scenes, model.scenes_count })
+    {
+        for (int32_t node : std::span{ scene.nodes, scene.nodes_count })
+        {
+            if (!isIndexValid(node, model.nodes_count, false)) return false;
+        }
+    }
+
+    for (tg3_node const& node : std::span{ model.nodes, model.nodes_count })
+    {
+        if (!isIndexValid(node.mesh, model.meshes_count) || !isIndexValid(node.camera, model.cameras_count)
+            || !isIndexValid(node.light, model.lights_count) || !isIndexValid(node.skin, model.skins_count))
+        {
+            return false;
+        }
+        for (int32_t child : std::span{ node.children, node.children_count })
+        {
+            if (!isIndexValid(child, model.nodes_count, false)) return false;
+        }
+    }
+
+    for (tg3_mesh const& mesh : std::span{ model.meshes, model.meshes_count })
+    {
+        for (tg3_primitive const& primitive : std::span{ mesh.primitives, mesh.primitives_count })
+        {
+            if (!isIndexValid(primitive.material, model.materials_count) || !isIndexValid(primitive.indices, model.accessors_count)) return false;
+            for (tg3_str_int_pair const& attribute : std::span{ primitive.attributes, primitive.attributes_count })
+            {
+                if (!isIndexValid(attribute.value, model.accessors_count, false)) return false;
+            }
+            for (uint32_t i = 0; i < primitive.targets_count; ++i)
+            {
+                for (tg3_str_int_pair const& attribute : std::span{ primitive.targets[i], primitive.target_attribute_counts[i] })
+                {
+                    if (!isIndexValid(attribute.value, model.accessors_count, false)) return false;
+                }
+            }
+        }
+    }
+
+    for (tg3_material const& material : std::span{ model.materials, model.materials_count })
+    {
+        if (!isIndexValid(material.pbr_metallic_roughness.base_color_texture.index, model.textures_count)
+            || !isIndexValid(material.pbr_metallic_roughness.metallic_roughness_texture.index, model.textures_count)
+            || !isIndexValid(material.normal_texture.index, model.textures_count)
+            || !isIndexValid(material.occlusion_texture.index, model.textures_count)
+            || !isIndexValid(material.emissive_texture.index, model.textures_count))
+        {
+            return false;
+        }
+    }
+
+    for (tg3_texture const& texture : std::span{ model.textures, model.textures_count })
+    {
+        if (!isIndexValid(texture.sampler, model.samplers_count) || !isIndexValid(texture.source, model.images_count)) return false;
+    }
+
+    for (tg3_image const& image : std::span{ model.images, model.images_count })
+    {
+        if (!isIndexValid(image.buffer_view, model.buffer_views_count)) return false;
+    }
+
+    for (tg3_accessor const& accessor : std::span{ model.accessors, model.accessors_count })
+    {
+        if (!isIndexValid(accessor.buffer_view, model.buffer_views_count)) return false;
+        if (accessor.sparse.is_sparse
+            && (!isIndexValid(accessor.sparse.indices.buffer_view, model.buffer_views_count, false)
+                || !isIndexValid(accessor.sparse.values.buffer_view, model.buffer_views_count, false)))
+        {
+            return false;
+        }
+    }
+
+    for (tg3_buffer_view const& buffer_view : std::span{ model.buffer_views, model.buffer_views_count })
+    {
+        if (!isIndexValid(buffer_view.buffer, model.buffers_count, false)) return false;
+    }
+
+    for (tg3_skin const& skin : std::span{ model.skins, model.skins_count })
+    {
+        if (!isIndexValid(skin.inverse_bind_matrices, model.accessors_count) || !isIndexValid(skin.skeleton, model.nodes_count)) return false;
+        for (int32_t joint : std::span{ skin.joints, skin.joints_count })
+        {
+            if (!isIndexValid(joint, model.nodes_count, false)) return false;
+        }
+    }
+
+    for (tg3_animation const& animation : std::span{ model.animations, model.animations_count })
+    {
+        for (tg3_animation_channel const& channel : std::span{ animation.channels, animation.channels_count })
+        {
+            if (!isIndexValid(channel.sampler, animation.samplers_count, false) || !isIndexValid(channel.target.node, model.nodes_count)) return false;
+        }
+        for (tg3_animation_sampler const& sampler : std::span{ animation.samplers, animation.samplers_count })
+        {
+            if (!isIndexValid(sampler.input, model.accessors_count, false) || !isIndexValid(sampler.output, model.accessors_count, false)) return false;
+        }
+    }
+
+    return true;
+}
+
+}    // namespace
+
+
+std::vector<uint8_t> BakedGltfModel::serialize(tg3_model const& model)
+{
+    TableWriter writer{ model };
+    return std::move(writer.image());
+}
+
+std::unique_ptr<BakedGltfModel> BakedGltfModel::restore(std::span<uint8_t const> image)
+{
+    if (image.size() < sizeof(tg3_model)) return nullptr;
+
+    std::unique_ptr<BakedGltfModel> rv{ new BakedGltfModel{ image } };
+    TableReader reader{ reinterpret_cast<uint8_t*>(rv->m_tables.get()), image.size() };
+    relocate(*rv->m_model_ptr, reader);
+    if (!reader.isValid() || !areReferencesValid(*rv->m_model_ptr)) return nullptr;
+
+    return rv;
+}
+
+BakedGltfModel::BakedGltfModel(std::span<uint8_t const> image)
+    : m_tables{ new uint64_t[(image.size() + sizeof(uint64_t) - 1) / sizeof(uint64_t)] }
+    , m_model_ptr{ reinterpret_cast<tg3_model*>(m_tables.get()) }
+{
+    static_assert(alignof(tg3_model) <= alignof(uint64_t));
+    std::memcpy(m_tables.get(), image.data(), image.size());
+}
+
+void BakedGltfModel::setBufferData(uint32_t buffer, std::span<uint8_t const> data)
+{
+    assert(buffer < m_model_ptr->buffers_count);
+
+    // the tables are owned by the model, so they can be patched in place
+    const_cast<tg3_buffer&>(m_model_ptr->buffers[buffer]).data = tg3_span_u8{ data.data(), data.size() };
+}
+
+}
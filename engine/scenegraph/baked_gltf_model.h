@@ -0,0 +1,48 @@
+#ifndef LEXGINE_SCENEGRAPH_BAKED_GLTF_MODEL_H
+#define LEXGINE_SCENEGRAPH_BAKED_GLTF_MODEL_H
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <tinygltf/tiny_gltf_v3.h>
+
+namespace lexgine::scenegraph {
+
+/*! glTF model restored from the tables stored in a baked scene, which allows to import the scene without parsing its source.
+ The model owns relocated copy of the tables and does not reference the memory it has been restored from. The data of the
+ glTF buffers are not a part of the tables and must be provided using setBufferData() before the model is used
+*/
+class BakedGltfModel final
+{
+public:
+    /*! Serializes the tables of the model into a relocatable image, in which all pointers are replaced by offsets from
+     the beginning of the image. The data of the buffers are omitted
+    */
+    static std::vector<uint8_t> serialize(tg3_model const& model);
+
+    /*! Restores the model from the image produced by serialize(). Returns nullptr if the image is corrupted, i.e. if any
+     of its offsets points outside of the image or if any of the tables refers to an element, which does not exist
+    */
+    static std::unique_ptr<BakedGltfModel> restore(std::span<uint8_t const> image);
+
+    BakedGltfModel(BakedGltfModel const&) = delete;
+    BakedGltfModel& operator=(BakedGltfModel const&) = delete;
+
+    tg3_model const& model() const { return *m_model_ptr; }
+
+    //! Sets data of the given buffer of the model. The data are not copied and must outlive the model
+    void setBufferData(uint32_t buffer, std::span<uint8_t const> data);
+
+private:
+    BakedGltfModel(std::span<uint8_t const> image);
+
+private:
+    std::unique_ptr<uint64_t[]> m_tables;    //!< relocated copy of the image, aligned for any of the tables
+    tg3_model* m_model_ptr;    //!< root of the tables located at the beginning of m_tables
+};
+
+}
+
+#endif
@@ -0,0 +1,495 @@
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <thread>
+#include <type_traits>
+
+#include "engine/core/misc/misc.h"
+#include "baked_scene.h"
+
+namespace lexgine::scenegraph
+{
+
+namespace
+{
+
+constexpr char c_baked_scene_magic[8] = { 'L', 'X', 'G', 'B', 'A', 'K', 'E', 'D' };
+constexpr size_t c_section_alignment = 16U;
+
+//! Location of a section of the baked scene image
+struct Section
+{
+    uint64_t offset;
+    uint64_t size;
+};
+
+struct Header
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t processing_options;
+    core::misc::Sha256::Digest source_id;
+    uint32_t primitive_count;
+    uint32_t attribute_count;
+    uint32_t dependency_count;
+    uint32_t buffer_count;
+    Section primitive_table;
+    Section attribute_table;
+    Section dependency_table;
+    Section buffer_table;
+    Section model_tables;
+    uint64_t image_size;
+};
+
+enum PrimitiveFlags : uint32_t
+{
+    has_position_dequantization = 1U << 0,
+    has_meshlets = 1U << 1
+};
+
+struct PrimitiveRecord
+{
+    int32_t mesh_id;
+    uint32_t primitive_index;
+    uint32_t vertex_stride;
+    uint32_t position_offset;
+    uint32_t index_size;
+    uint32_t flags;
+    uint32_t first_attribute;
+    uint32_t attribute_count;
+    float dequantization_scale[3];
+    float dequantization_offset[3];
+    MeshletBufferLayout packed_meshlet_layout;
+    Section vertices;
+    Section index_data;
+    Section meshlets;
+    Section meshlet_bounds;
+    Section meshlet_vertex_indices;
+    Section meshlet_triangle_indices;
+    Section packed_meshlets;
+};
+
+struct AttributeRecord
+{
+    Section name;
+    uint32_t format;
+    uint32_t element_count;
+    uint32_t is_normalized;
+    uint32_t offset;
+};
+
+struct DependencyRecord
+{
+    Section uri;
+    core::misc::Sha256::Digest content_hash;
+    uint32_t is_needed_on_load;
+    uint32_t padding;
+};
+
+struct BufferRecord
+{
+    uint32_t source;
+    uint32_t dependency_index;
+    Section data;
+};
+
+static_assert(std::is_trivially_copyable_v<Header> && std::is_trivially_copyable_v<PrimitiveRecord>
+    && std::is_trivially_copyable_v<AttributeRecord> && std::is_trivially_copyable_v<DependencyRecord>
+    && std::is_trivially_copyable_v<BufferRecord>);
+static_assert(std::is_trivially_copyable_v<Meshlet> && std::is_trivially_copyable_v<MeshletBounds>);
+
+
+template<typename T>
+std::span<uint8_t const> asBytes(std::span<T const> data)
+{
+    return { reinterpret_cast<uint8_t const*>(data.data()), data.size_bytes() };
+}
+
+//! Appends the data to the image starting at the next aligned offset
+Section appendSection(std::vector<uint8_t>& image, std::span<uint8_t const> data)
+{
+    Section const rv{ .offset = core::misc::align(image.size(), c_section_alignment), .size = data.size() };
+    image.resize(rv.offset + rv.size, 0);
+    if (rv.size) std::memcpy(image.data() + rv.offset, data.data(), data.size());
+    return rv;
+}
+
+bool isSectionValid(Section const& section, std::span<uint8_t const> image, size_t element_size)
+{
+    return section.offset % c_section_alignment == 0
+        && section.offset <= image.size()
+        && section.size <= image.size() - section.offset
+        && section.size % element_size == 0;
+}
+
+std::span<uint8_t const> stringBytes(std::string_view str)
+{
+    return { reinterpret_cast<uint8_t const*>(str.data()), str.size() };
+}
+
+//! Returns typed view of the section. The section must have been validated with isSectionValid() beforehand
+template<typename T>
+std::span<T const> sectionView(Section const& section, std::span<uint8_t const> image)
+{
+    return { reinterpret_cast<T const*>(image.data() + section.offset), static_cast<size_t>(section.size / sizeof(T)) };
+}
+
+//! Returns 'true' if each index stored in the index data refers to one of the given number of vertices
+template<typename T>
+bool areIndicesValid(std::span<uint8_t const> index_data, size_t vertex_count)
+{
+    for (size_t offset = 0; offset + sizeof(T) <= index_data.size(); offset += sizeof(T))
+    {
+        T index;
+        std::memcpy(&index, index_data.data() + offset, sizeof(T));
+        if (index >= vertex_count) return false;
+    }
+    return true;
+}
+
+}    // namespace
+
+
+std::optional<BakedSceneKey> makeBakedSceneKey(std::filesystem::path const& source_path, std::string_view scene_selector, uint32_t processing_options)
+{
+    auto const source_hash = core::misc::Sha256::hashFile(source_path);
+    if (!source_hash.isValid()) return std::nullopt;
+
+    core::misc::Sha256 hash{};
+    hash.update(*source_hash);
+    hash.update(stringBytes(scene_selector));
+
+    return BakedSceneKey{ .source_id = hash.finalize(), .processing_options = processing_options };
+}
+
+std::vector<uint8_t> writeBakedScene(BakedSceneKey const& key, std::vector<BakedSceneDependency> const& dependencies,
+    std::vector<BakedBuffer> const& buffers, tg3_model const& model, std::vector<BakedPrimitive> const& primitives)
+{
+    assert(buffers.size() == model.buffers_count);
+
+    size_t attribute_count{ 0 };
+    for (BakedPrimitive const& primitive : primitives) attribute_count += primitive.attributes.size();
+
+    // the tables are reserved up front and filled in once the data sections have been laid out
+    std::vector<uint8_t> rv(sizeof(Header), 0);
+    Section const primitive_table = appendSection(rv, std::vector<uint8_t>(primitives.size() * sizeof(PrimitiveRecord), 0));
+    Section const attribute_table = appendSection(rv, std::vector<uint8_t>(attribute_count * sizeof(AttributeRecord), 0));
+    Section const dependency_table = appendSection(rv, std::vector<uint8_t>(dependencies.size() * sizeof(DependencyRecord), 0));
+    Section const buffer_table = appendSection(rv, std::vector<uint8_t>(buffers.size() * sizeof(BufferRecord), 0));
+    Section const model_tables = appendSection(rv, BakedGltfModel::serialize(model));
+
+    std::vector<DependencyRecord> dependency_records{};
+    dependency_records.reserve(dependencies.size());
+    for (BakedSceneDependency const& dependency : dependencies)
+    {
+        dependency_records.push_back(DependencyRecord{
+            .uri = appendSection(rv, stringBytes(dependency.uri)),
+            .content_hash = dependency.content_hash,
+            .is_needed_on_load = dependency.is_needed_on_load ? 1U : 0U,
+            .padding = 0
+            });
+    }
+
+    std::vector<BufferRecord> buffer_records{};
+    buffer_records.reserve(buffers.size());
+    for (BakedBuffer const& buffer : buffers)
+    {
+        buffer_records.push_back(BufferRecord{
+            .source = static_cast<uint32_t>(buffer.source),
+            .dependency_index = buffer.dependency_index,
+            .data = appendSection(rv, buffer.source == BakedBufferSource::baked ? buffer.data : std::span<uint8_t const>{})
+            });
+    }
+
+    std::vector<PrimitiveRecord> primitive_records{};
+    std::vector<AttributeRecord> attribute_records{};
+    primitive_records.reserve(primitives.size());
+    attribute_records.reserve(attribute_count);
+    for (BakedPrimitive const& primitive : primitives)
+    {
+        PrimitiveRecord record{
+            .mesh_id = primitive.mesh_id,
+            .primitive_index = primitive.primitive_index,
+            .vertex_stride = primitive.vertex_stride,
+            .position_offset = primitive.position_offset,
+            .index_size = primitive.index_size,
+            .flags = (primitive.position_dequantization ? has_position_dequantization : 0U) | (!primitive.meshlets.empty() ? has_meshlets : 0U),
+            .first_attribute = static_cast<uint32_t>(attribute_records.size()),
+            .attribute_count = static_cast<uint32_t>(primitive.attributes.size()),
+            .packed_meshlet_layout = primitive.packed_meshlet_layout
+        };
+
+        PositionDequantization const dequantization = primitive.position_dequantization.value_or(PositionDequantization{});
+        for (int i = 0; i < 3; ++i)
+        {
+            record.dequantization_scale[i] = dequantization.scale[i];
+            record.dequantization_offset[i] = dequantization.offset[i];
+        }
+
+        record.vertices = appendSection(rv, primitive.vertices);
+        record.index_data = appendSection(rv, primitive.index_data);
+        record.meshlets = appendSection(rv, asBytes(primitive.meshlets));
+        record.meshlet_bounds = appendSection(rv, asBytes(primitive.meshlet_bounds));
+        record.meshlet_vertex_indices = appendSection(rv, asBytes(primitive.meshlet_vertex_indices));
+        record.meshlet_triangle_indices = appendSection(rv, primitive.meshlet_triangle_indices);
+        record.packed_meshlets = appendSection(rv, primitive.packed_meshlets);
+        primitive_records.push_back(record);
+
+        for (VertexAttributeLayout const& attribute : primitive.attributes)
+        {
+            attribute_records.push_back(AttributeRecord{
+                .name = appendSection(rv, stringBytes(attribute.name)),
+                .format = static_cast<uint32_t>(attribute.format),
+                .element_count = attribute.element_count,
+                .is_normalized = attribute.is_normalized ? 1U : 0U,
+                .offset = attribute.offset
+                });
+        }
+    }
+    rv.resize(core::misc::align(rv.size(), c_section_alignment), 0);
+
+    Header header{
+        .version = c_baked_scene_format_version,
+        .processing_options = key.processing_options,
+        .source_id = key.source_id,
+        .primitive_count = static_cast<uint32_t>(primitives.size()),
+        .attribute_count = static_cast<uint32_t>(attribute_count),
+        .dependency_count = static_cast<uint32_t>(dependencies.size()),
+        .buffer_count = static_cast<uint32_t>(buffers.size()),
+        .primitive_table = primitive_table,
+        .attribute_table = attribute_table,
+        .dependency_table = dependency_table,
+        .buffer_table = buffer_table,
+        .model_tables = model_tables,
+        .image_size = rv.size()
+    };
+    std::memcpy(header.magic, c_baked_scene_magic, sizeof(c_baked_scene_magic));
+    std::memcpy(rv.data(), &header, sizeof(header));
+    if (!primitive_records.empty()) std::memcpy(rv.data() + primitive_table.offset, primitive_records.data(), primitive_table.size);
+    if (!attribute_records.empty()) std::memcpy(rv.data() + attribute_table.offset, attribute_records.data(), attribute_table.size);
+    if (!dependency_records.empty()) std::memcpy(rv.data() + dependency_table.offset, dependency_records.data(), dependency_table.size);
+    if (!buffer_records.empty()) std::memcpy(rv.data() + buffer_table.offset, buffer_records.data(), buffer_table.size);
+
+    return rv;
+}
+
+std::optional<BakedScene> readBakedScene(std::span<uint8_t const> baked_scene, BakedSceneKey const& expected_key)
+{
+    if (baked_scene.size() < sizeof(Header) || reinterpret_cast<uintptr_t>(baked_scene.data()) % c_section_alignment != 0) return std::nullopt;
+
+    Header header;
+    std::memcpy(&header, baked_scene.data(), sizeof(header));
+    if (std::memcmp(header.magic, c_baked_scene_magic, sizeof(c_baked_scene_magic)) != 0
+        || header.version != c_baked_scene_format_version
+        || header.image_size != baked_scene.size()
+        || header.source_id != expected_key.source_id
+        || header.processing_options != expected_key.processing_options)
+    {
+        return std::nullopt;
+    }
+
+    if (!isSectionValid(header.primitive_table, baked_scene, sizeof(PrimitiveRecord))
+        || header.primitive_table.size / sizeof(PrimitiveRecord) != header.primitive_count
+        || !isSectionValid(header.attribute_table, baked_scene, sizeof(AttributeRecord))
+        || header.attribute_table.size / sizeof(AttributeRecord) != header.attribute_count
+        || !isSectionValid(header.dependency_table, baked_scene, sizeof(DependencyRecord))
+        || header.dependency_table.size / sizeof(DependencyRecord) != header.dependency_count
+        || !isSectionValid(header.buffer_table, baked_scene, sizeof(BufferRecord))
+        || header.buffer_table.size / sizeof(BufferRecord) != header.buffer_count
+        || !isSectionValid(header.model_tables, baked_scene, 1))
+    {
+        return std::nullopt;
+    }
+
+    auto const primitive_records = sectionView<PrimitiveRecord>(header.primitive_table, baked_scene);
+    auto const attribute_records = sectionView<AttributeRecord>(header.attribute_table, baked_scene);
+    auto const dependency_records = sectionView<DependencyRecord>(header.dependency_table, baked_scene);
+    auto const buffer_records = sectionView<BufferRecord>(header.buffer_table, baked_scene);
+
+    BakedScene rv{};
+    rv.model = BakedGltfModel::restore(sectionView<uint8_t>(header.model_tables, baked_scene));
+    if (!rv.model || rv.model->model().buffers_count != buffer_records.size()) return std::nullopt;
+    tg3_model const& model = rv.model->model();
+
+    rv.dependencies.reserve(dependency_records.size());
+    for (DependencyRecord const& record : dependency_records)
+    {
+        if (!isSectionValid(record.uri, baked_scene, 1)) return std::nullopt;
+
+        auto const uri = sectionView<char>(record.uri, baked_scene);
+        rv.dependencies.push_back(BakedSceneDependency{
+            .uri = std::string{ uri.begin(), uri.end() },
+            .content_hash = record.content_hash,
+            .is_needed_on_load = record.is_needed_on_load != 0
+            });
+    }
+
+    rv.buffers.reserve(buffer_records.size());
+    for (BufferRecord const& record : buffer_records)
+    {
+        if (record.source >= static_cast<uint32_t>(BakedBufferSource::count)
+            || (record.source == static_cast<uint32_t>(BakedBufferSource::dependency) && record.dependency_index >= rv.dependencies.size())
+            || !isSectionValid(record.data, baked_scene, 1))
+        {
+            return std::nullopt;
+        }
+
+        rv.buffers.push_back(BakedBuffer{
+            .source = static_cast<BakedBufferSource>(record.source),
+            .dependency_index = record.dependency_index,
+            .data = sectionView<uint8_t>(record.data, baked_scene)
+            });
+    }
+
+    rv.primitives.resize(primitive_records.size());
+    for (size_t i = 0; i < primitive_records.size(); ++i)
+    {
+        PrimitiveRecord const& record = primitive_records[i];
+        if (record.mesh_id < 0 || static_cast<uint32_t>(record.mesh_id) >= model.meshes_count
+            || record.primitive_index >= model.meshes[record.mesh_id].primitives_count
+            || record.vertex_stride == 0 || record.position_offset >= record.vertex_stride
+            || (record.index_size != sizeof(uint16_t) && record.index_size != sizeof(uint32_t))
+            || record.first_attribute > attribute_records.size()
+            || record.attribute_count > attribute_records.size() - record.first_attribute
+            || !isSectionValid(record.vertices, baked_scene, record.vertex_stride)
+            || !isSectionValid(record.index_data, baked_scene, record.index_size)
+            || !isSectionValid(record.meshlets, baked_scene, sizeof(Meshlet))
+            || !isSectionValid(record.meshlet_bounds, baked_scene, sizeof(MeshletBounds))
+            || !isSectionValid(record.meshlet_vertex_indices, baked_scene, sizeof(uint32_t))
+            || !isSectionValid(record.meshlet_triangle_indices, baked_scene, 1)
+            || !isSectionValid(record.packed_meshlets, baked_scene, 1))
+        {
+            return std::nullopt;
+        }
+
+        BakedPrimitive& primitive = rv.primitives[i];
+        primitive.mesh_id = record.mesh_id;
+        primitive.primitive_index = record.primitive_index;
+        primitive.vertex_stride = record.vertex_stride;
+        primitive.position_offset = record.position_offset;
+        primitive.index_size = record.index_size;
+        primitive.vertices = sectionView<uint8_t>(record.vertices, baked_scene);
+        primitive.index_data = sectionView<uint8_t>(record.index_data, baked_scene);
+        if (record.flags & has_position_dequantization)
+        {
+            primitive.position_dequantization = PositionDequantization{
+                .scale = glm::vec3{ record.dequantization_scale[0], record.dequantization_scale[1], record.dequantization_scale[2] },
+                .offset = glm::vec3{ record.dequantization_offset[0], record.dequantization_offset[1], record.dequantization_offset[2] }
+            };
+        }
+        if (record.flags & has_meshlets)
+        {
+            primitive.meshlets = sectionView<Meshlet>(record.meshlets, baked_scene);
+            primitive.meshlet_bounds = sectionView<MeshletBounds>(record.meshlet_bounds, baked_scene);
+            primitive.meshlet_vertex_indices = sectionView<uint32_t>(record.meshlet_vertex_indices, baked_scene);
+            primitive.meshlet_triangle_indices = sectionView<uint8_t>(record.meshlet_triangle_indices, baked_scene);
+            primitive.packed_meshlets = sectionView<uint8_t>(record.packed_meshlets, baked_scene);
+            primitive.packed_meshlet_layout = record.packed_meshlet_layout;
+            if (primitive.meshlet_bounds.size() != primitive.meshlets.size()) return std::nullopt;
+
+            for (Meshlet const& meshlet : primitive.meshlets)
+            {
+                if (meshlet.vertex_offset > primitive.meshlet_vertex_indices.size()
+                    || meshlet.vertex_count > primitive.meshlet_vertex_indices.size() - meshlet.vertex_offset
+                    || meshlet.triangle_offset > primitive.meshlet_triangle_indices.size()
+                    || 3ULL * meshlet.triangle_count > primitive.meshlet_triangle_indices.size() - meshlet.triangle_offset)
+                {
+                    return std::nullopt;
+                }
+            }
+        }
+
+        // every attribute must fit into the vertex, and the position must be one of the attributes, so that the reads of the
+        // attributes of each vertex stay inside of the vertex data section
+        bool has_position{ false };
+        primitive.attributes.reserve(record.attribute_count);
+        for (AttributeRecord const& attribute : attribute_records.subspan(record.first_attribute, record.attribute_count))
+        {
+            uint32_t const attribute_size = dataFormatSize(static_cast<core::misc::DataFormat>(attribute.format)) * attribute.element_count;
+            if (!isSectionValid(attribute.name, baked_scene, 1)
+                || attribute_size == 0
+                || attribute.offset > record.vertex_stride
+                || attribute_size > record.vertex_stride - attribute.offset)
+            {
+                return std::nullopt;
+            }
+
+            auto const name = sectionView<char>(attribute.name, baked_scene);
+            primitive.attributes.push_back(VertexAttributeLayout{
+                .name = std::string{ name.begin(), name.end() },
+                .format = static_cast<core::misc::DataFormat>(attribute.format),
+                .element_count = static_cast<unsigned char>(attribute.element_count),
+                .is_normalized = attribute.is_normalized != 0,
+                .offset = attribute.offset
+                });
+
+            if (primitive.attributes.back().name == "POSITION" && attribute.offset == record.position_offset)
+            {
+                has_position = record.position_offset + attribute_size <= record.vertex_stride
+                    && record.vertices.size >= record.vertex_stride;
+            }
+        }
+        if (!has_position) return std::nullopt;
+
+        // the indices are dereferenced when the meshlets are culled and drawn, so they must not refer outside of the vertices
+        size_t const vertex_count = primitive.vertices.size() / primitive.vertex_stride;
+        bool const are_indices_valid = primitive.index_size == sizeof(uint16_t)
+            ? areIndicesValid<uint16_t>(primitive.index_data, vertex_count)
+            : areIndicesValid<uint32_t>(primitive.index_data, vertex_count);
+        if (!are_indices_valid) return std::nullopt;
+
+        for (uint32_t vertex_index : primitive.meshlet_vertex_indices)
+        {
+            if (vertex_index >= vertex_count) return std::nullopt;
+        }
+        for (Meshlet const& meshlet : primitive.meshlets)
+        {
+            for (uint8_t local_index : primitive.meshlet_triangle_indices.subspan(meshlet.triangle_offset, 3ULL * meshlet.triangle_count))
+            {
+                if (local_index >= meshlet.vertex_count) return std::nullopt;
+            }
+        }
+    }
+
+    return rv;
+}
+
+bool writeBakedSceneFile(std::filesystem::path const& file_path, std::span<uint8_t const> baked_scene)
+{
+    // the name of the temporary file combines the time, the writing thread and a counter, so that concurrent writers of the same baked scene do not share it
+    static std::atomic_uint32_t temporary_file_counter{ 0U };
+    std::filesystem::path temporary_file_path = file_path;
+    temporary_file_path += std::format(".{:x}.{:x}.{}.tmp",
+        static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()),
+        std::hash<std::thread::id>{}(std::this_thread::get_id()),
+        temporary_file_counter.fetch_add(1U));
+
+    if (!core::misc::writeBinaryDataToFile(temporary_file_path.string(), const_cast<uint8_t*>(baked_scene.data()), baked_scene.size()))
+    {
+        std::error_code error_code{};
+        std::filesystem::remove(temporary_file_path, error_code);
+        return false;
+    }
+
+    // the rename replaces the target atomically; it fails if the target is mapped by another import, which then keeps using the equivalent data
+    std::error_code error_code{};
+    std::filesystem::rename(temporary_file_path, file_path, error_code);
+    if (error_code)
+    {
+        std::filesystem::remove(temporary_file_path, error_code);
+        return false;
+    }
+    return true;
+}
+
+std::string bakedSceneFileName(BakedSceneKey const& key)
+{
+    std::string rv{};
+    rv.reserve(2 * key.source_id.size() + 32);
+    for (uint8_t e : key.source_id) rv += std::format("{:02x}", e);
+    return rv + std::format("_{:x}.bakedscene", key.processing_options);
+}
+
+}
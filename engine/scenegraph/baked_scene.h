@@ -0,0 +1,119 @@
+#ifndef LEXGINE_SCENEGRAPH_BAKED_SCENE_H
+#define LEXGINE_SCENEGRAPH_BAKED_SCENE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "engine/core/misc/sha256.h"
+#include "baked_gltf_model.h"
+#include "vertex_quantization.h"
+#include "meshlet_builder.h"
+
+namespace lexgine::scenegraph {
+
+constexpr uint32_t c_baked_scene_format_version = 3U;
+
+//! Identifies the source and the import options a baked scene has been produced from. Baked scenes are only reused when the whole key matches
+struct BakedSceneKey
+{
+    core::misc::Sha256::Digest source_id;    //!< hash of the contents of the scene source and of the selector of the scene in the source
+    uint32_t processing_options;    //!< bit mask of the mesh processing stages applied during the import
+};
+
+//! External file referenced by the scene source, e.g. a glTF buffer stored in a separate file
+struct BakedSceneDependency
+{
+    std::string uri;    //!< location of the file relative to the scene source
+    core::misc::Sha256::Digest content_hash;
+    bool is_needed_on_load;    //!< 'false' if the file only contains data replaced by the baked primitives, so that it need not be mapped when the baked scene is used
+};
+
+//! Location of the data of a glTF buffer, which are provided to the glTF model restored from a baked scene
+enum class BakedBufferSource : uint32_t
+{
+    none,    //!< the buffer only contains data replaced by the baked primitives and is left empty
+    dependency,    //!< the buffer is stored in an external file given by one of the dependencies
+    binary_chunk,    //!< the buffer is the binary chunk of the GLB source
+    baked,    //!< the buffer is embedded into the source as a data URI and is stored in the baked scene
+    count
+};
+
+struct BakedBuffer
+{
+    BakedBufferSource source;
+    uint32_t dependency_index;    //!< only used by the buffers stored in external files
+    std::span<uint8_t const> data;    //!< only used by the buffers stored in the baked scene
+};
+
+/*! Processed mesh primitive stored in a baked scene. The primitives returned by readBakedScene() reference the memory of the baked
+ scene directly, so this memory must outlive them
+*/
+struct BakedPrimitive
+{
+    int mesh_id;    //!< glTF mesh containing the primitive
+    uint32_t primitive_index;    //!< index of the primitive in the glTF mesh
+    uint32_t vertex_stride;
+    uint32_t position_offset;
+    uint32_t index_size;    //!< size of a single index in bytes (either 2 or 4)
+    std::span<uint8_t const> vertices;    //!< interleaved vertex data
+    std::span<uint8_t const> index_data;
+    std::vector<VertexAttributeLayout> attributes;
+    std::optional<PositionDequantization> position_dequantization;
+    std::span<Meshlet const> meshlets;    //!< empty if the primitive has not been partitioned into meshlets
+    std::span<MeshletBounds const> meshlet_bounds;
+    std::span<uint32_t const> meshlet_vertex_indices;
+    std::span<uint8_t const> meshlet_triangle_indices;
+    std::span<uint8_t const> packed_meshlets;    //!< meshlet data packed by packMeshlets()
+    MeshletBufferLayout packed_meshlet_layout;
+};
+
+//! Contents of a baked scene
+struct BakedScene
+{
+    std::vector<BakedSceneDependency> dependencies;    //!< external files, which contents must still match for the baked scene to be valid
+    std::vector<BakedBuffer> buffers;    //!< locations of the data of the buffers of the model
+    std::unique_ptr<BakedGltfModel> model;    //!< tables of the glTF source, which replace parsing of the source
+    std::vector<BakedPrimitive> primitives;
+};
+
+
+/*! Returns key of the baked scene produced from the given source with the given processing options. The scene selector distinguishes the
+ scenes stored in the same source (e.g. the index or the name of the scene). The key is derived from the contents of the source, so that
+ the baked scene is reused regardless of the location and of the modification time of the source. Returns std::nullopt if the source cannot be read
+*/
+std::optional<BakedSceneKey> makeBakedSceneKey(std::filesystem::path const& source_path, std::string_view scene_selector, uint32_t processing_options);
+
+
+/*! Serializes the glTF model together with the primitives into a baked scene. The baked scene is a flat, versioned image consisting of
+ a header, tables of fixed-size records (primitives, vertex attributes, dependencies and buffers), the relocatable tables of the glTF model
+ and the raw data sections referenced by the records. All sections are aligned to 16 bytes and all references are stored as offsets from the
+ beginning of the image, so that the primitives can be used in place, e.g. when mapped into memory, without any deserialization.
+ There must be one buffer record per each buffer of the model
+*/
+std::vector<uint8_t> writeBakedScene(BakedSceneKey const& key, std::vector<BakedSceneDependency> const& dependencies,
+    std::vector<BakedBuffer> const& buffers, tg3_model const& model, std::vector<BakedPrimitive> const& primitives);
+
+/*! Validates the baked scene image and returns its contents. The image must be aligned to 16 bytes. Returns std::nullopt if the image has
+ been produced by a different version of the format, from another source or with different options, or if it is corrupted, including the
+ primitives referring to the meshes missing from the model and the indices referring to the vertices missing from the primitive. The contents
+ of the dependencies are not checked against the file system
+*/
+std::optional<BakedScene> readBakedScene(std::span<uint8_t const> baked_scene, BakedSceneKey const& expected_key);
+
+/*! Writes the baked scene into the given file. The data are written into a temporary file first, which then replaces the target file,
+ so that concurrent imports of the same scene never observe partially written baked scene. Returns 'false' if the file could not be written
+*/
+bool writeBakedSceneFile(std::filesystem::path const& file_path, std::span<uint8_t const> baked_scene);
+
+//! Returns name of the file, under which the baked scene with the given key is stored in the cache
+std::string bakedSceneFileName(BakedSceneKey const& key);
+
+}
+
+#endif
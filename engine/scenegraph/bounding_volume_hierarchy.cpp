@@ -0,0 +1,284 @@
+#include <algorithm>
+#include <cassert>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define LEXGINE_BVH_SSE
+#include <xmmintrin.h>
+#endif
+
+#include "bounding_volume_hierarchy.h"
+
+namespace lexgine::scenegraph
+{
+
+namespace
+{
+
+constexpr uint32_t c_max_leaf_size = 4U;
+
+enum class FrustumIntersection
+{
+    outside,
+    intersecting,
+    inside
+};
+
+Aabb merge(Aabb const& a, Aabb const& b)
+{
+    return Aabb{ glm::min(a.min, b.min), glm::max(a.max, b.max) };
+}
+
+/*! Frustum planes rearranged for testing a box against all of them at once. The dot products are evaluated in the same
+ order as by Camera::isAabbVisible(), so that the classification of a box never disagrees with the brute-force test.
+ Since any box contained in another box has its vertex closest to the inner side of a plane not further from the plane than
+ that of the containing box (and vice versa for the furthest vertex), classification of the nodes is conservative
+*/
+class FrustumTester
+{
+public:
+    FrustumTester(BoundingVolumeHierarchy::FrustumPlanes const& planes)
+    {
+#ifdef LEXGINE_BVH_SSE
+        // the last two lanes are padded with the plane (0, 0, 0, 1), which every point lies in front of
+        alignas(16) float x[8]{}, y[8]{}, z[8]{}, w[8]{ 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 1.f, 1.f };
+        for (size_t i = 0; i < planes.size(); ++i)
+        {
+            x[i] = planes[i].x; y[i] = planes[i].y; z[i] = planes[i].z; w[i] = planes[i].w;
+        }
+
+        for (int i = 0; i < 2; ++i)
+        {
+            m_x[i] = _mm_load_ps(x + 4 * i);
+            m_y[i] = _mm_load_ps(y + 4 * i);
+            m_z[i] = _mm_load_ps(z + 4 * i);
+            m_w[i] = _mm_load_ps(w + 4 * i);
+            m_x_sign_mask[i] = _mm_cmpge_ps(m_x[i], _mm_setzero_ps());
+            m_y_sign_mask[i] = _mm_cmpge_ps(m_y[i], _mm_setzero_ps());
+            m_z_sign_mask[i] = _mm_cmpge_ps(m_z[i], _mm_setzero_ps());
+        }
+#else
+        m_planes = planes;
+#endif
+    }
+
+    FrustumIntersection classify(Aabb const& box, bool check_containment) const
+    {
+#ifdef LEXGINE_BVH_SSE
+        __m128 const min_x = _mm_set1_ps(box.min.x), min_y = _mm_set1_ps(box.min.y), min_z = _mm_set1_ps(box.min.z);
+        __m128 const max_x = _mm_set1_ps(box.max.x), max_y = _mm_set1_ps(box.max.y), max_z = _mm_set1_ps(box.max.z);
+
+        bool is_inside{ true };
+        for (int i = 0; i < 2; ++i)
+        {
+            // 'positive' vertex is the box vertex furthest along the plane normal, 'negative' vertex is the opposite one
+            __m128 const p_x = _mm_or_ps(_mm_and_ps(m_x_sign_mask[i], max_x), _mm_andnot_ps(m_x_sign_mask[i], min_x));
+            __m128 const p_y = _mm_or_ps(_mm_and_ps(m_y_sign_mask[i], max_y), _mm_andnot_ps(m_y_sign_mask[i], min_y));
+            __m128 const p_z = _mm_or_ps(_mm_and_ps(m_z_sign_mask[i], max_z), _mm_andnot_ps(m_z_sign_mask[i], min_z));
+            if (_mm_movemask_ps(_mm_cmplt_ps(distance(i, p_x, p_y, p_z), _mm_setzero_ps())))
+            {
+                return FrustumIntersection::outside;
+            }
+
+            if (check_containment && is_inside)
+            {
+                __m128 const n_x = _mm_or_ps(_mm_and_ps(m_x_sign_mask[i], min_x), _mm_andnot_ps(m_x_sign_mask[i], max_x));
+                __m128 const n_y = _mm_or_ps(_mm_and_ps(m_y_sign_mask[i], min_y), _mm_andnot_ps(m_y_sign_mask[i], max_y));
+                __m128 const n_z = _mm_or_ps(_mm_and_ps(m_z_sign_mask[i], min_z), _mm_andnot_ps(m_z_sign_mask[i], max_z));
+                is_inside = _mm_movemask_ps(_mm_cmplt_ps(distance(i, n_x, n_y, n_z), _mm_setzero_ps())) == 0;
+            }
+        }
+#else
+        bool is_inside{ true };
+        for (glm::vec4 const& plane : m_planes)
+        {
+            glm::vec3 positive_vertex = box.min, negative_vertex = box.max;
+            if (plane.x >= 0) { positive_vertex.x = box.max.x; negative_vertex.x = box.min.x; }
+            if (plane.y >= 0) { positive_vertex.y = box.max.y; negative_vertex.y = box.min.y; }
+            if (plane.z >= 0) { positive_vertex.z = box.max.z; negative_vertex.z = box.min.z; }
+
+            if (glm::dot(glm::vec3(plane), positive_vertex) + plane.w < 0)
+            {
+                return FrustumIntersection::outside;
+            }
+            is_inside = is_inside && glm::dot(glm::vec3(plane), negative_vertex) + plane.w >= 0;
+        }
+#endif
+        return check_containment && is_inside ? FrustumIntersection::inside : FrustumIntersection::intersecting;
+    }
+
+private:
+#ifdef LEXGINE_BVH_SSE
+    __m128 distance(int i, __m128 x, __m128 y, __m128 z) const
+    {
+        __m128 const dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m_x[i], x), _mm_mul_ps(m_y[i], y)), _mm_mul_ps(m_z[i], z));
+        return _mm_add_ps(dot, m_w[i]);
+    }
+
+    __m128 m_x[2], m_y[2], m_z[2], m_w[2];
+    __m128 m_x_sign_mask[2], m_y_sign_mask[2], m_z_sign_mask[2];
+#else
+    BoundingVolumeHierarchy::FrustumPlanes m_planes;
+#endif
+};
+
+}    // namespace
+
+
+Aabb Aabb::transform(core::math::Matrix4f const& m) const
+{
+    // transformed box is accumulated from contributions of each axis of the original box (valid for affine transforms)
+    Aabb rv{ glm::vec3{ m[3] }, glm::vec3{ m[3] } };
+    for (int i = 0; i < 3; ++i)
+    {
+        glm::vec3 const a = glm::vec3{ m[i] } * min[i];
+        glm::vec3 const b = glm::vec3{ m[i] } * max[i];
+        rv.min += glm::min(a, b);
+        rv.max += glm::max(a, b);
+    }
+    return rv;
+}
+
+void BoundingVolumeHierarchy::build(std::vector<Aabb> const& instance_bounds)
+{
+    uint32_t const instance_count = static_cast<uint32_t>(instance_bounds.size());
+
+    m_instance_bounds = instance_bounds;
+    m_instance_order.resize(instance_count);
+    m_instance_leaves.resize(instance_count);
+    for (uint32_t i = 0; i < instance_count; ++i) m_instance_order[i] = i;
+
+    std::vector<glm::vec3> centroids(instance_count);
+    for (uint32_t i = 0; i < instance_count; ++i)
+    {
+        centroids[i] = (instance_bounds[i].min + instance_bounds[i].max) * .5f;
+    }
+
+    m_nodes.clear();
+    m_nodes.reserve(instance_count > 0 ? 2 * ((instance_count + c_max_leaf_size - 1) / c_max_leaf_size) : 0);
+    if (instance_count > 0)
+    {
+        buildNode(0, instance_count, 0, centroids);
+    }
+    m_dirty_nodes.assign(m_nodes.size(), 0);
+    m_needs_refit = false;
+}
+
+uint32_t BoundingVolumeHierarchy::buildNode(uint32_t first, uint32_t count, uint32_t parent, std::vector<glm::vec3> const& centroids)
+{
+    uint32_t const node_index = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.push_back(BvhNode{ .bounds = m_instance_bounds[m_instance_order[first]], .first = first, .count = count, .right_child = 0, .parent = parent });
+
+    glm::vec3 centroid_min = centroids[m_instance_order[first]], centroid_max = centroid_min;
+    for (uint32_t i = first + 1; i < first + count; ++i)
+    {
+        uint32_t const instance = m_instance_order[i];
+        m_nodes[node_index].bounds = merge(m_nodes[node_index].bounds, m_instance_bounds[instance]);
+        centroid_min = glm::min(centroid_min, centroids[instance]);
+        centroid_max = glm::max(centroid_max, centroids[instance]);
+    }
+
+    if (count <= c_max_leaf_size)
+    {
+        for (uint32_t i = first; i < first + count; ++i) m_instance_leaves[m_instance_order[i]] = node_index;
+        return node_index;
+    }
+
+    // median split along the axis, in which the centroids are spread the most
+    glm::vec3 const centroid_extent = centroid_max - centroid_min;
+    int const axis = centroid_extent.x >= centroid_extent.y && centroid_extent.x >= centroid_extent.z ? 0 : (centroid_extent.y >= centroid_extent.z ? 1 : 2);
+    uint32_t const left_count = count / 2;
+    std::nth_element(m_instance_order.begin() + first, m_instance_order.begin() + first + left_count, m_instance_order.begin() + first + count,
+        [&centroids, axis](uint32_t a, uint32_t b) { return centroids[a][axis] < centroids[b][axis]; });
+
+    buildNode(first, left_count, node_index, centroids);
+    uint32_t const right_child = buildNode(first + left_count, count - left_count, node_index, centroids);
+    m_nodes[node_index].right_child = right_child;
+
+    return node_index;
+}
+
+void BoundingVolumeHierarchy::setInstanceBounds(uint32_t instance, Aabb const& bounds)
+{
+    m_instance_bounds[instance] = bounds;
+
+    // the ancestors of an already dirty node are dirty too
+    for (uint32_t node = m_instance_leaves[instance]; !m_dirty_nodes[node]; node = m_nodes[node].parent)
+    {
+        m_dirty_nodes[node] = 1;
+        if (node == 0) break;
+    }
+    m_needs_refit = true;
+}
+
+void BoundingVolumeHierarchy::refit()
+{
+    if (!m_needs_refit) return;
+
+    // children are always stored after their parents, so traversing the nodes backwards refits the children first
+    for (size_t i = m_nodes.size(); i-- > 0; )
+    {
+        if (!m_dirty_nodes[i]) continue;
+
+        BvhNode& node = m_nodes[i];
+        if (node.right_child)
+        {
+            node.bounds = merge(m_nodes[i + 1].bounds, m_nodes[node.right_child].bounds);
+        }
+        else
+        {
+            node.bounds = m_instance_bounds[m_instance_order[node.first]];
+            for (uint32_t j = node.first + 1; j < node.first + node.count; ++j)
+            {
+                node.bounds = merge(node.bounds, m_instance_bounds[m_instance_order[j]]);
+            }
+        }
+        m_dirty_nodes[i] = 0;
+    }
+    m_needs_refit = false;
+}
+
+void BoundingVolumeHierarchy::cull(FrustumPlanes const& frustum_planes, std::vector<uint32_t>& visible_instances) const
+{
+    assert(!m_needs_refit);
+    if (m_nodes.empty()) return;
+
+    FrustumTester const tester{ frustum_planes };
+
+    uint32_t stack[64];
+    uint32_t stack_size{ 0 };
+    stack[stack_size++] = 0;
+    while (stack_size)
+    {
+        BvhNode const& node = m_nodes[stack[--stack_size]];
+        switch (tester.classify(node.bounds, true))
+        {
+        case FrustumIntersection::outside:
+            break;
+
+        case FrustumIntersection::inside:
+            visible_instances.insert(visible_instances.end(), m_instance_order.begin() + node.first, m_instance_order.begin() + node.first + node.count);
+            break;
+
+        case FrustumIntersection::intersecting:
+            if (node.right_child)
+            {
+                stack[stack_size++] = node.right_child;
+                stack[stack_size++] = static_cast<uint32_t>(&node - m_nodes.data()) + 1;
+            }
+            else
+            {
+                for (uint32_t i = node.first; i < node.first + node.count; ++i)
+                {
+                    uint32_t const instance = m_instance_order[i];
+                    if (tester.classify(m_instance_bounds[instance], false) != FrustumIntersection::outside)
+                    {
+                        visible_instances.push_back(instance);
+                    }
+                }
+            }
+            break;
+        }
+    }
+}
+
+}
@@ -0,0 +1,85 @@
+#ifndef LEXGINE_SCENEGRAPH_BOUNDING_VOLUME_HIERARCHY_H
+#define LEXGINE_SCENEGRAPH_BOUNDING_VOLUME_HIERARCHY_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "engine/core/math/matrix_types.h"
+#include "engine/core/entity.h"
+#include "lexgine_scenegraph_fwd.h"
+#include "class_names.h"
+
+namespace lexgine::scenegraph {
+
+//! Axis-aligned bounding box
+struct Aabb
+{
+    glm::vec3 min;
+    glm::vec3 max;
+
+    //! returns bounding box of this box transformed by the given matrix
+    Aabb transform(core::math::Matrix4f const& m) const;
+};
+
+
+/*! Binary bounding volume hierarchy over world-space bounds of scene instances (e.g. submeshes of the meshes
+ attached to the scene nodes) used for frustum culling. The instances are identified by their indices in the array
+ of bounds passed to build(). Each node of the hierarchy refers to a contiguous range of instances, so that subtrees
+ found to be completely inside of the frustum are accepted without visiting their descendants, while subtrees found
+ to be outside of the frustum are skipped entirely. The result of culling is exactly the same as when testing every
+ instance with Camera::isAabbVisible().
+ When instances move their bounds are updated in place and the hierarchy is refitted, which keeps the topology intact.
+ The hierarchy should be rebuilt if the instances move far from their original locations
+*/
+class BoundingVolumeHierarchy final : public core::NamedEntity<class_names::BoundingVolumeHierarchy>
+{
+public:
+    using FrustumPlanes = std::array<glm::vec4, 6>;
+
+public:
+    //! builds the hierarchy from scratch
+    void build(std::vector<Aabb> const& instance_bounds);
+
+    //! updates bounds of the instance. The change takes effect on the next call of refit()
+    void setInstanceBounds(uint32_t instance, Aabb const& bounds);
+
+    //! recomputes bounds of the nodes, which contain instances updated since the last refit
+    void refit();
+
+    /*! Appends indices of the instances intersecting the frustum to the output list. The planes are expected
+     to point inside of the frustum and to be normalized, as returned by Camera::frustumPlanes()
+    */
+    void cull(FrustumPlanes const& frustum_planes, std::vector<uint32_t>& visible_instances) const;
+
+    uint32_t instanceCount() const { return static_cast<uint32_t>(m_instance_bounds.size()); }
+    uint32_t nodeCount() const { return static_cast<uint32_t>(m_nodes.size()); }
+    Aabb const& instanceBounds(uint32_t instance) const { return m_instance_bounds[instance]; }
+
+private:
+    struct BvhNode
+    {
+        Aabb bounds;
+        uint32_t first;    //!< index of the first instance of the node in m_instance_order
+        uint32_t count;    //!< number of instances contained in the node
+        uint32_t right_child;    //!< index of the right child; the left child always follows its parent. Equals 0 for leaves
+        uint32_t parent;
+    };
+
+private:
+    uint32_t buildNode(uint32_t first, uint32_t count, uint32_t parent, std::vector<glm::vec3> const& centroids);
+
+private:
+    std::vector<Aabb> m_instance_bounds;
+    std::vector<uint32_t> m_instance_order;    //!< instances sorted so that each node of the hierarchy refers to a contiguous range
+    std::vector<uint32_t> m_instance_leaves;    //!< leaf node containing each instance
+    std::vector<BvhNode> m_nodes;    //!< nodes in depth-first order, so that the parents precede their children
+    std::vector<uint8_t> m_dirty_nodes;
+    bool m_needs_refit = false;
+};
+
+}
+
+#endif
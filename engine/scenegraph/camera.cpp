@@ -89,7 +89,7 @@ void Camera::updateFrustumPlanes() {
 	}
 }
 
-bool Camera::isAabbVisible(const glm::vec3& min, const glm::vec3& max) {
+bool Camera::isAabbVisible(const glm::vec3& min, const glm::vec3& max) const {
 	for (const auto& plane : m_frustum_planes) {
 		glm::vec3 positive_vertex = min;
 
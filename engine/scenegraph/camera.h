@@ -29,7 +29,8 @@ public:
 	glm::mat4 getViewProjectionMatrix() const;
 	ProjectionType getProjectionType() const { return m_projection_type; }
 
-	bool isAabbVisible(const glm::vec3& min, const glm::vec3& max);
+	bool isAabbVisible(const glm::vec3& min, const glm::vec3& max) const;
+	const std::array<glm::vec4, 6>& frustumPlanes() const { return m_frustum_planes; }
 
 private:
 	void updateFrustumPlanes();
@@ -5,6 +5,7 @@ namespace lexgine::scenegraph::class_names
 
 extern char const Scene[] = "lexgine::scenegraph::Scene";
 extern char const Node[] = "lexgine::scenegraph::Node";
+extern char const TransformHierarchy[] = "lexgine::scenegraph::TransformHierarchy";
 extern char const Camera[] = "lexgine::scenegraph::Camera";
 extern char const Light[] = "lexgine::scenegraph::Light";
 extern char const Material[] = "lexgine::scenegraph::Material";
@@ -15,5 +16,8 @@ extern char const Image[] = "lexgine::scenegraph::Image";
 extern char const Sampler[] = "lexgine::scenegraph::Sampler";
 extern char const Buffer[] = "lexgine::scenegraph::Buffer";
 extern char const BufferView[] = "lexgine::scenegraph::BufferView";
+extern char const BoundingVolumeHierarchy[] = "lexgine::scenegraph::BoundingVolumeHierarchy";
+extern char const SceneMemoryUploadPlan[] = "lexgine::scenegraph::SceneMemoryUploadPlan";
+extern char const RenderListBuilder[] = "lexgine::scenegraph::RenderListBuilder";
 
 }
@@ -5,6 +5,7 @@ namespace lexgine::scenegraph::class_names {
 
 extern char const Scene[];
 extern char const Node[];
+extern char const TransformHierarchy[];
 extern char const Camera[];
 extern char const Light[];
 extern char const Material[];
@@ -15,6 +16,9 @@ extern char const Image[];
 extern char const Sampler[];
 extern char const Buffer[];
 extern char const BufferView[];
+extern char const BoundingVolumeHierarchy[];
+extern char const SceneMemoryUploadPlan[];
+extern char const RenderListBuilder[];
 
 }
 
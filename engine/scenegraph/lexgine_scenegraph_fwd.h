@@ -6,9 +6,17 @@ class Image;
 class Material;
 class Scene;
 class SceneMeshMemory;
+class SceneMemoryUploadPlan;
 class BufferView;
 class Mesh;
+class Submesh;
 class Node;
+class TransformHierarchy;
+class BoundingVolumeHierarchy;
+struct Aabb;
+class RenderListBuilder;
+struct RenderBatchKey;
+struct InstancedDraw;
 class Light;
 class Camera;
 class VertexBufferView;
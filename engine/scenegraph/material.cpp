@@ -15,6 +15,7 @@
 #include <engine/conversion/texture_converter.h>
 
 #include "image.h"
+#include "submesh.h"
 
 #include "material.h"
 
@@ -156,6 +157,25 @@ void MaterialAssemblyTask::bindMaterialParameters(
     );
 }
 
+void MaterialAssemblyTask::bindMaterialParameters(
+    core::dx::d3d12::CommandList& target_command_list,
+    core::dx::d3d12::ConstantDataCache& material_constants
+)
+{
+    core::dx::d3d12::ConstantBufferStream& constant_data_stream = m_basic_rendering_services.constantDataStream();
+    uint64_t const material_constants_address = material_constants.gpuAddress(constant_data_stream.recordingFrame(),
+        [&constant_data_stream](std::span<uint8_t const> serialized_data)
+        {
+            return constant_data_stream.allocateAndUpdate(serialized_data)->virtualGpuAddress();
+        });
+
+    m_shader_function.bindRootConstantBuffer(
+        target_command_list,
+        core::dx::dxcompilation::ShaderFunctionConstantBufferRootIds::material_uniforms,
+        material_constants_address
+    );
+}
+
 void MaterialAssemblyTask::bindObjectParameters(
 	core::dx::d3d12::CommandList& target_command_list,
 	core::dx::d3d12::ConstantBufferDataMapper& data_mapper
@@ -189,21 +209,26 @@ const char* const Material::c_material_parameters_uniform_buffer_name = "Materia
 
 Material::Material(MaterialAssemblyTask& material_assembly_task)
     : m_material_assembly{ material_assembly_task }
-    , m_material_parameters_cb_data_mapper{ material_assembly_task.getMaterialParametersUniformBufferReflection() }
+    , m_material_parameters_cb_data_mappers{
+        core::dx::d3d12::ConstantBufferDataMapper{ material_assembly_task.getMaterialParametersUniformBufferReflection() },
+        core::dx::d3d12::ConstantBufferDataMapper{ material_assembly_task.getMaterialParametersUniformBufferReflection() } }
+    , m_material_constants{ 0U, constant_group_count }
 {
-    m_material_parameters_cb_data_mapper.addDataBinding("emissive_factor", m_emissive_factor);
-    m_material_parameters_cb_data_mapper.addDataBinding("alpha_mode", static_cast<unsigned int>(m_alpha_mode));
-    m_material_parameters_cb_data_mapper.addDataBinding("alpha_cutoff", m_alpha_cutoff);
-    m_material_parameters_cb_data_mapper.addDataBinding("is_double_sided", m_is_double_sided);
-    m_material_parameters_cb_data_mapper.addDataBinding("base_color_factor", m_base_color_factor);
-    m_material_parameters_cb_data_mapper.addDataBinding("metallic_factor", m_metallic_factor);
-    m_material_parameters_cb_data_mapper.addDataBinding("roughness_factor", m_roughness_factor);
-
-    m_material_parameters_cb_data_mapper.addDataBinding("normal_tex_index", m_normal_texture_binding_id);
-    m_material_parameters_cb_data_mapper.addDataBinding("srv_occlusion", m_occlusion_texture_binding_id);
-    m_material_parameters_cb_data_mapper.addDataBinding("emissive_tex_index", m_emissive_texture_binding_id);
-    m_material_parameters_cb_data_mapper.addDataBinding("albedo_tex_index", m_base_color_texture_binding_id);
-    m_material_parameters_cb_data_mapper.addDataBinding("mr_tex_index", m_metallic_roughness_texture_binding_id);
+    core::dx::d3d12::ConstantBufferDataMapper& factors_data_mapper = m_material_parameters_cb_data_mappers[constant_group_factors];
+    factors_data_mapper.addDataBinding("emissive_factor", m_emissive_factor);
+    factors_data_mapper.addDataBinding("alpha_mode", m_alpha_mode);
+    factors_data_mapper.addDataBinding("alpha_cutoff", m_alpha_cutoff);
+    factors_data_mapper.addDataBinding("is_double_sided", m_is_double_sided);
+    factors_data_mapper.addDataBinding("base_color_factor", m_base_color_factor);
+    factors_data_mapper.addDataBinding("metallic_factor", m_metallic_factor);
+    factors_data_mapper.addDataBinding("roughness_factor", m_roughness_factor);
+
+    core::dx::d3d12::ConstantBufferDataMapper& texture_bindings_data_mapper = m_material_parameters_cb_data_mappers[constant_group_texture_bindings];
+    texture_bindings_data_mapper.addDataBinding("normal_tex_index", m_texture_binding_ids[texture_slot_normal]);
+    texture_bindings_data_mapper.addDataBinding("srv_occlusion", m_texture_binding_ids[texture_slot_occlusion]);
+    texture_bindings_data_mapper.addDataBinding("emissive_tex_index", m_texture_binding_ids[texture_slot_emissive]);
+    texture_bindings_data_mapper.addDataBinding("albedo_tex_index", m_texture_binding_ids[texture_slot_base_color]);
+    texture_bindings_data_mapper.addDataBinding("mr_tex_index", m_texture_binding_ids[texture_slot_metallic_roughness]);
 }
 
 void Material::setStringName(std::string const& entity_string_name)
@@ -216,65 +241,91 @@ void Material::setMetallicRoughness(MetallicRoughness const& value)
     m_base_color_factor = value.base_color_factor;
     m_metallic_factor = value.metallic_factor;
     m_roughness_factor = value.roughness_factor;
-    
-    assert(value.p_base_color->p_texture_conversion_task->getStatus() == lexgine::conversion::TextureConversionStatus::completed);
-    lexgine::conversion::TextureUploadWork* p_base_color_texture_upload_work = value.p_base_color->p_texture_conversion_task->getUploadWork();
-    assert(p_base_color_texture_upload_work->isCompleted());
-    if (core::dx::dxcompilation::BindingResult binding_result =
-        m_material_assembly.getShaderStage(core::dx::dxcompilation::ShaderType::pixel)->bindTexture("gMaterialTextures", p_base_color_texture_upload_work->resource()))
-    {
-        m_base_color_texture_binding_id = binding_result.binding_register;
-    }
-    assert(value.p_metallic_roughness->p_texture_conversion_task->getStatus() == lexgine::conversion::TextureConversionStatus::completed);
-    lexgine::conversion::TextureUploadWork* p_metallic_roughness_texture_upload_work = value.p_metallic_roughness->p_texture_conversion_task->getUploadWork();
-    assert(p_metallic_roughness_texture_upload_work->isCompleted());
-    if (core::dx::dxcompilation::BindingResult binding_result 
-        = m_material_assembly.getShaderStage(core::dx::dxcompilation::ShaderType::pixel)->bindTexture("gMaterialTextures", p_metallic_roughness_texture_upload_work->resource()))
-    {
-        m_metallic_roughness_texture_binding_id = binding_result.binding_register;
-    }
+    m_material_constants.invalidate(constant_group_factors);
+
+    bindTexture(texture_slot_base_color, value.p_base_color);
+    bindTexture(texture_slot_metallic_roughness, value.p_metallic_roughness);
 }
 
 void Material::setNormalTexture(Texture* p_texture)
 {
-    assert(p_texture->p_texture_conversion_task->getStatus() == lexgine::conversion::TextureConversionStatus::completed);
-    lexgine::conversion::TextureUploadWork* p_texture_upload_work = p_texture->p_texture_conversion_task->getUploadWork();
-    assert(p_texture_upload_work->isCompleted());
-    if (core::dx::dxcompilation::BindingResult binding_result =
-        m_material_assembly.getShaderStage(core::dx::dxcompilation::ShaderType::pixel)->bindTexture("gMaterialTextures", p_texture_upload_work->resource()))
-    {
-        m_normal_texture_binding_id = binding_result.binding_register;
-    }
-    
+    bindTexture(texture_slot_normal, p_texture);
 }
 
 void Material::setOcclusionTexture(Texture* p_texture)
 {
-    assert(p_texture->p_texture_conversion_task->getStatus() == lexgine::conversion::TextureConversionStatus::completed);
-    lexgine::conversion::TextureUploadWork* p_texture_upload_work = p_texture->p_texture_conversion_task->getUploadWork();
-    assert(p_texture_upload_work->isCompleted());
-    if (core::dx::dxcompilation::BindingResult binding_result 
-        = m_material_assembly.getShaderStage(core::dx::dxcompilation::ShaderType::pixel)->bindTexture("gMaterialTextures", p_texture_upload_work->resource()))
+    bindTexture(texture_slot_occlusion, p_texture);
+}
+
+void Material::setEmissiveTexture(Texture* p_texture)
+{
+    bindTexture(texture_slot_emissive, p_texture);
+}
+
+void Material::updateTextureResidency(float priority)
+{
+    for (uint32_t slot = 0; slot < texture_slot_count; ++slot)
     {
-        m_occlusion_texture_binding_id = binding_result.binding_register;
+        BoundTexture const& bound_texture = m_bound_textures[slot];
+        if (!bound_texture.p_texture) continue;
+
+        lexgine::conversion::TextureUploadWork const* p_texture_upload_work = bound_texture.p_texture->p_texture_conversion_task->getUploadWork();
+        p_texture_upload_work->requestMipmapLevel(0U, priority);
+        if (p_texture_upload_work->sampledMostDetailedLevel() != bound_texture.sampled_level)
+        {
+            bindTexture(static_cast<TextureSlot>(slot), bound_texture.p_texture);
+        }
     }
 }
 
-void Material::setEmissiveTexture(Texture* p_texture)
+void Material::bindTexture(TextureSlot slot, Texture const* p_texture)
 {
+    if (!p_texture) return;
+
     assert(p_texture->p_texture_conversion_task->getStatus() == lexgine::conversion::TextureConversionStatus::completed);
     lexgine::conversion::TextureUploadWork* p_texture_upload_work = p_texture->p_texture_conversion_task->getUploadWork();
-    assert(p_texture_upload_work->isCompleted());
-    if (core::dx::dxcompilation::BindingResult binding_result 
-        = m_material_assembly.getShaderStage(core::dx::dxcompilation::ShaderType::pixel)->bindTexture("gMaterialTextures", p_texture_upload_work->resource()))
+
+    // streamed textures are bound before their more detailed mipmap levels are uploaded, so the view is clamped to the levels available for sampling
+    uint32_t const sampled_level = p_texture_upload_work->sampledMostDetailedLevel();
+    assert(sampled_level > 0 || p_texture_upload_work->isCompleted());
+    if (core::dx::dxcompilation::BindingResult binding_result =
+        m_material_assembly.getShaderStage(core::dx::dxcompilation::ShaderType::pixel)->bindTexture("gMaterialTextures", p_texture_upload_work->resource(), 0, static_cast<float>(sampled_level)))
     {
-        m_emissive_texture_binding_id = binding_result.binding_register;
+        m_bound_textures[slot] = BoundTexture{ .p_texture = p_texture, .sampled_level = sampled_level };
+        m_texture_binding_ids[slot] = binding_result.binding_register;
+        m_material_constants.invalidate(constant_group_texture_bindings);
     }
 }
 
 void Material::bindMaterialConstants(core::dx::d3d12::CommandList& target_command_list)
 {
-    m_material_assembly.bindMaterialParameters(target_command_list, m_material_parameters_cb_data_mapper);
+    // the reflection of the material constants only becomes available once the material assembly has completed
+    m_material_constants.resize(m_material_parameters_cb_data_mappers[constant_group_factors].mappedDataSize());
+    m_material_constants.update(
+        [this](uint32_t group, void* p_serialized_data)
+        {
+            m_material_parameters_cb_data_mappers[group].writeAllBoundData(reinterpret_cast<uint64_t>(p_serialized_data));
+        });
+
+    m_material_assembly.bindMaterialParameters(target_command_list, m_material_constants);
+}
+
+void Material::bindObjectConstants(core::dx::d3d12::CommandList& target_command_list, core::math::Matrix4f const& model_transform, Submesh const& submesh)
+{
+    // the data sources only have to outlive the write, which happens before bindObjectParameters() returns
+    PositionDequantization const& dequantization = submesh.getPositionDequantization();
+    core::math::Vector4f const position_dequantization_scale{ dequantization.scale, 0.f };
+    core::math::Vector4f const position_dequantization_offset{ dequantization.offset, 0.f };
+
+    core::dx::d3d12::ConstantBufferDataMapper data_mapper{ m_material_assembly.getObjectParametersUniformBufferReflection() };
+    data_mapper.addDataBinding("model", model_transform);
+    if (submesh.hasQuantizedPositions())
+    {
+        // the dequantization constants only exist in the shaders compiled for quantized vertices
+        data_mapper.addDataBinding("position_dequantization_scale", position_dequantization_scale);
+        data_mapper.addDataBinding("position_dequantization_offset", position_dequantization_offset);
+    }
+    m_material_assembly.bindObjectParameters(target_command_list, data_mapper);
 }
 
 
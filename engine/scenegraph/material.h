@@ -9,6 +9,7 @@
 #include <engine/core/dx/d3d12/lexgine_core_dx_d3d12_fwd.h>
 #include <engine/core/dx/d3d12/constant_buffer_reflection.h>
 #include <engine/core/dx/d3d12/constant_buffer_data_mapper.h>
+#include <engine/core/dx/d3d12/constant_data_cache.h>
 #include <engine/core/dx/d3d12/pipeline_state.h>
 #include <engine/core/stream_output.h>
 #include <engine/core/vertex_attributes.h>
@@ -95,6 +96,12 @@ public:
         core::dx::d3d12::ConstantBufferDataMapper& data_mapper
     );
 
+    //! binds material constants pre-serialized by the cache, the data is uploaded only if it has not been uploaded during the current frame yet
+    void bindMaterialParameters(
+        core::dx::d3d12::CommandList& target_command_list,
+        core::dx::d3d12::ConstantDataCache& material_constants
+    );
+
     void bindObjectParameters(
         core::dx::d3d12::CommandList& target_command_list,
         core::dx::d3d12::ConstantBufferDataMapper& data_mapper
@@ -105,7 +112,11 @@ public:
         core::dx::d3d12::ConstantBufferDataMapper& data_mapper
     );
 
+    //! returns PSO compilation task of the material or nullptr if the material has not been assembled yet
+    core::dx::d3d12::tasks::GraphicsPSOCompilationTask const* getPSOCompilationTask() const { return m_pso_compilation_task; }
 
+    //! returns root signature compilation task of the material or nullptr if the material has not been assembled yet
+    core::dx::d3d12::tasks::RootSignatureCompilationTask const* getRootSignatureCompilationTask() const { return m_root_signature_compilation_task; }
 
 private:
     core::dx::d3d12::BasicRenderingServices& m_basic_rendering_services;
@@ -141,21 +152,63 @@ public:
 
     void setStringName(std::string const& entity_string_name);
 
-    void setEmissiveFactor(glm::vec3 const& value) { m_emissive_factor = value; }
-    void setAlphaMode(AlphaMode value) { m_alpha_mode = value; }
-    void setAlphaCutoff(float value) { m_alpha_cutoff = value; }
-    void setDoubleSided(bool value) { m_is_double_sided = value; }
+    void setEmissiveFactor(glm::vec3 const& value) { m_emissive_factor = value; m_material_constants.invalidate(constant_group_factors); }
+    void setAlphaMode(AlphaMode value) { m_alpha_mode = value; m_material_constants.invalidate(constant_group_factors); }
+    void setAlphaCutoff(float value) { m_alpha_cutoff = value; m_material_constants.invalidate(constant_group_factors); }
+    void setDoubleSided(bool value) { m_is_double_sided = value; m_material_constants.invalidate(constant_group_factors); }
 
     void setMetallicRoughness(MetallicRoughness const& value);
     void setNormalTexture(Texture* p_texture);
     void setOcclusionTexture(Texture* p_texture);
     void setEmissiveTexture(Texture* p_texture);
 
+    /*! Requests the textures of the material to be streamed in with the given priority and rebinds the textures, for which
+     more or fewer mipmap levels have become available for sampling since they were bound. Has no effect unless texture streaming is enabled
+    */
+    void updateTextureResidency(float priority);
+
     void bindMaterialConstants(core::dx::d3d12::CommandList& target_command_list);
 
+    /*! binds per-object constants of the submesh drawn with the material: the model transform and, if the positions of the
+     submesh are quantized, the transform restoring them from the normalized integers
+    */
+    void bindObjectConstants(core::dx::d3d12::CommandList& target_command_list, core::math::Matrix4f const& model_transform, Submesh const& submesh);
+
+    MaterialAssemblyTask const& getAssemblyTask() const { return m_material_assembly; }
+
+private:
+    //! groups of material constants, which are re-serialized independently of each other
+    enum ConstantGroup : uint32_t
+    {
+        constant_group_factors = 0,
+        constant_group_texture_bindings,
+        constant_group_count
+    };
+
+    enum TextureSlot : uint32_t
+    {
+        texture_slot_normal = 0,
+        texture_slot_occlusion,
+        texture_slot_emissive,
+        texture_slot_base_color,
+        texture_slot_metallic_roughness,
+        texture_slot_count
+    };
+
+    //! texture bound to a slot of the material together with the most detailed mipmap level, to which its view is clamped
+    struct BoundTexture
+    {
+        Texture const* p_texture = nullptr;
+        uint32_t sampled_level = 0U;
+    };
+
+private:
+    void bindTexture(TextureSlot slot, Texture const* p_texture);
+
 private:
     MaterialAssemblyTask& m_material_assembly;
-    core::dx::d3d12::ConstantBufferDataMapper m_material_parameters_cb_data_mapper;
+    core::dx::d3d12::ConstantBufferDataMapper m_material_parameters_cb_data_mappers[constant_group_count];    //!< data mappers of the constant groups
+    core::dx::d3d12::ConstantDataCache m_material_constants;
 
     std::unique_ptr<MaterialAssemblyTask> m_pso_compilation_task;
     
@@ -169,12 +222,8 @@ private:
     float m_metallic_factor;
     float m_roughness_factor;
 
-    size_t m_normal_texture_binding_id;
-    size_t m_occlusion_texture_binding_id;
-    size_t m_emissive_texture_binding_id;
-
-    size_t m_base_color_texture_binding_id;
-    size_t m_metallic_roughness_texture_binding_id;
+    BoundTexture m_bound_textures[texture_slot_count];
+    size_t m_texture_binding_ids[texture_slot_count];    //!< indices of the bound textures in the material texture table
 };
 
 
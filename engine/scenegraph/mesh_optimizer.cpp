@@ -0,0 +1,338 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+
+#include "mesh_optimizer.h"
+
+namespace lexgine::scenegraph
+{
+
+namespace
+{
+
+constexpr uint32_t c_invalid_index = 0xFFFFFFFF;
+
+// parameters of the vertex scoring function suggested by T. Forsyth
+constexpr float c_cache_decay_power = 1.5f;
+constexpr float c_last_triangle_score = .75f;
+constexpr float c_valence_boost_scale = 2.f;
+constexpr float c_valence_boost_power = .5f;
+
+float vertexScore(int cache_position, uint32_t remaining_triangle_count, uint32_t cache_size)
+{
+    if (remaining_triangle_count == 0) return -1.f;    // the vertex is not used by any of the remaining triangles
+
+    float score{ 0.f };
+    if (cache_position >= 0)
+    {
+        // the vertices of the last added triangle get fixed score, so that the algorithm does not favor any of them
+        score = cache_position < 3
+            ? c_last_triangle_score
+            : std::pow(1.f - static_cast<float>(cache_position - 3) / static_cast<float>(cache_size - 3), c_cache_decay_power);
+    }
+
+    // vertices with few remaining triangles are preferred, so that they could be removed from consideration sooner
+    return score + c_valence_boost_scale * std::pow(static_cast<float>(remaining_triangle_count), -c_valence_boost_power);
+}
+
+std::array<float, 3> vertexPosition(MeshData const& mesh, uint32_t vertex)
+{
+    std::array<float, 3> rv{};
+    std::memcpy(rv.data(), mesh.vertices.data() + static_cast<size_t>(vertex) * mesh.vertex_stride + mesh.position_offset, sizeof(rv));
+    return rv;
+}
+
+//! reorders the vertices in the order of their first use by the index buffer dropping the vertices, which are not referenced
+template<typename VertexKeyMap>
+uint32_t remapVertices(MeshData& mesh, VertexKeyMap& unique_vertices)
+{
+    uint32_t const stride = mesh.vertex_stride;
+    std::vector<uint32_t> remap(mesh.vertexCount(), c_invalid_index);
+    std::vector<uint8_t> remapped_vertices{};
+    remapped_vertices.reserve(mesh.vertices.size());
+
+    uint32_t remapped_vertex_count{ 0 };
+    for (uint32_t& index : mesh.indices)
+    {
+        if (remap[index] == c_invalid_index)
+        {
+            auto [p, is_inserted] = unique_vertices.emplace(index, remapped_vertex_count);
+            if (is_inserted)
+            {
+                auto const vertex_data = mesh.vertices.begin() + static_cast<size_t>(index) * stride;
+                remapped_vertices.insert(remapped_vertices.end(), vertex_data, vertex_data + stride);
+                ++remapped_vertex_count;
+            }
+            remap[index] = p->second;
+        }
+        index = remap[index];
+    }
+
+    mesh.vertices.swap(remapped_vertices);
+    return remapped_vertex_count;
+}
+
+}    // namespace
+
+
+uint32_t weldVertices(MeshData& mesh)
+{
+    uint32_t const stride = mesh.vertex_stride;
+    uint8_t const* p_vertices = mesh.vertices.data();
+
+    // vertices are identified by their binary contents, so that for instance +0 and -0 are considered different
+    auto hash = [p_vertices, stride](uint32_t vertex)
+        {
+            uint8_t const* p_vertex = p_vertices + static_cast<size_t>(vertex) * stride;
+            uint64_t rv{ 0xcbf29ce484222325 };    // FNV-1a
+            for (uint32_t i = 0; i < stride; ++i)
+            {
+                rv = (rv ^ p_vertex[i]) * 0x100000001b3;
+            }
+            return static_cast<size_t>(rv);
+        };
+    auto are_equal = [p_vertices, stride](uint32_t a, uint32_t b)
+        {
+            return std::memcmp(p_vertices + static_cast<size_t>(a) * stride, p_vertices + static_cast<size_t>(b) * stride, stride) == 0;
+        };
+
+    std::unordered_map<uint32_t, uint32_t, decltype(hash), decltype(are_equal)> unique_vertices{ mesh.vertexCount(), hash, are_equal };
+    return remapVertices(mesh, unique_vertices);
+}
+
+void optimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertex_count, uint32_t cache_size)
+{
+    assert(cache_size > 3);
+    uint32_t const triangle_count = static_cast<uint32_t>(indices.size() / 3);
+    if (triangle_count == 0) return;
+
+    // triangles adjacent to each vertex; the first 'remaining_triangle_counts[v]' entries of each list are not yet emitted
+    std::vector<uint32_t> adjacency_offsets(vertex_count + 1, 0U);
+    for (uint32_t index : indices) ++adjacency_offsets[index + 1];
+    std::partial_sum(adjacency_offsets.begin(), adjacency_offsets.end(), adjacency_offsets.begin());
+
+    std::vector<uint32_t> adjacency(indices.size());
+    std::vector<uint32_t> remaining_triangle_counts(vertex_count, 0U);
+    for (uint32_t t = 0; t < triangle_count; ++t)
+    {
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            uint32_t const v = indices[3 * t + i];
+            adjacency[adjacency_offsets[v] + remaining_triangle_counts[v]++] = t;
+        }
+    }
+
+    std::vector<int> cache_positions(vertex_count, -1);
+    std::vector<float> vertex_scores(vertex_count);
+    for (uint32_t v = 0; v < vertex_count; ++v)
+    {
+        vertex_scores[v] = vertexScore(-1, remaining_triangle_counts[v], cache_size);
+    }
+
+    std::vector<float> triangle_scores(triangle_count);
+    std::vector<uint8_t> is_emitted(triangle_count, 0);
+    uint32_t best_triangle{ 0 };
+    for (uint32_t t = 0; t < triangle_count; ++t)
+    {
+        triangle_scores[t] = vertex_scores[indices[3 * t]] + vertex_scores[indices[3 * t + 1]] + vertex_scores[indices[3 * t + 2]];
+        if (triangle_scores[t] > triangle_scores[best_triangle]) best_triangle = t;
+    }
+
+    std::vector<uint32_t> optimized_indices{};
+    optimized_indices.reserve(indices.size());
+    std::vector<uint32_t> cache{}, new_cache{};
+    cache.reserve(cache_size + 3);
+    new_cache.reserve(cache_size + 3);
+    uint32_t first_not_emitted_triangle{ 0 };
+
+    for (uint32_t emitted_triangle_count = 0; emitted_triangle_count < triangle_count; ++emitted_triangle_count)
+    {
+        if (best_triangle == c_invalid_index)
+        {
+            // none of the triangles adjacent to the cached vertices remain, so the search restarts from an arbitrary triangle
+            while (is_emitted[first_not_emitted_triangle]) ++first_not_emitted_triangle;
+            best_triangle = first_not_emitted_triangle;
+        }
+
+        uint32_t const* const p_triangle = &indices[3 * best_triangle];
+        optimized_indices.insert(optimized_indices.end(), p_triangle, p_triangle + 3);
+        is_emitted[best_triangle] = 1;
+
+        // the vertices of the emitted triangle move to the front of the LRU cache
+        new_cache.clear();
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            if (std::find(new_cache.begin(), new_cache.end(), p_triangle[i]) == new_cache.end()) new_cache.push_back(p_triangle[i]);    // degenerate triangles may repeat vertices
+        }
+        for (uint32_t v : cache)
+        {
+            if (v != p_triangle[0] && v != p_triangle[1] && v != p_triangle[2]) new_cache.push_back(v);
+        }
+
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            uint32_t const v = p_triangle[i];
+            uint32_t* const p_adjacency = &adjacency[adjacency_offsets[v]];
+            uint32_t* const p_emitted = std::find(p_adjacency, p_adjacency + remaining_triangle_counts[v], best_triangle);
+            std::swap(*p_emitted, p_adjacency[--remaining_triangle_counts[v]]);
+        }
+
+        for (uint32_t i = 0; i < new_cache.size(); ++i)
+        {
+            uint32_t const v = new_cache[i];
+            cache_positions[v] = i < cache_size ? static_cast<int>(i) : -1;
+            vertex_scores[v] = vertexScore(cache_positions[v], remaining_triangle_counts[v], cache_size);
+        }
+
+        // only the triangles adjacent to the vertices, which have been in the cache, may change their scores
+        best_triangle = c_invalid_index;
+        float best_score{ -1.f };
+        for (uint32_t v : new_cache)
+        {
+            for (uint32_t j = 0; j < remaining_triangle_counts[v]; ++j)
+            {
+                uint32_t const t = adjacency[adjacency_offsets[v] + j];
+                triangle_scores[t] = vertex_scores[indices[3 * t]] + vertex_scores[indices[3 * t + 1]] + vertex_scores[indices[3 * t + 2]];
+                if (triangle_scores[t] > best_score)
+                {
+                    best_score = triangle_scores[t];
+                    best_triangle = t;
+                }
+            }
+        }
+
+        if (new_cache.size() > cache_size) new_cache.resize(cache_size);
+        cache.swap(new_cache);
+    }
+
+    indices.swap(optimized_indices);
+}
+
+void optimizeOverdraw(MeshData& mesh, uint32_t cache_size)
+{
+    uint32_t const triangle_count = static_cast<uint32_t>(mesh.indices.size() / 3);
+    uint32_t const vertex_count = mesh.vertexCount();
+    if (triangle_count == 0) return;
+
+    // clusters start at the triangles, none of which vertices are in the cache, so reordering the clusters does not affect cache efficiency
+    std::vector<uint32_t> cluster_offsets{};
+    {
+        std::vector<uint32_t> cache_timestamps(vertex_count, 0U);
+        uint32_t timestamp{ cache_size + 1 };
+        for (uint32_t t = 0; t < triangle_count; ++t)
+        {
+            uint32_t miss_count{ 0 };
+            for (uint32_t i = 0; i < 3; ++i)
+            {
+                uint32_t const v = mesh.indices[3 * t + i];
+                if (timestamp - cache_timestamps[v] > cache_size)
+                {
+                    cache_timestamps[v] = timestamp++;
+                    ++miss_count;
+                }
+            }
+            if (t == 0 || miss_count == 3) cluster_offsets.push_back(t);
+        }
+        cluster_offsets.push_back(triangle_count);
+    }
+
+    std::array<float, 3> mesh_centroid{};
+    for (uint32_t v = 0; v < vertex_count; ++v)
+    {
+        auto const position = vertexPosition(mesh, v);
+        for (int i = 0; i < 3; ++i) mesh_centroid[i] += position[i] / static_cast<float>(vertex_count);
+    }
+
+    // clusters facing away from the center of the mesh are likely to occlude the others and are drawn first
+    uint32_t const cluster_count = static_cast<uint32_t>(cluster_offsets.size()) - 1;
+    std::vector<float> cluster_sort_keys(cluster_count);
+    for (uint32_t c = 0; c < cluster_count; ++c)
+    {
+        std::array<float, 3> centroid{}, normal{};
+        float area_sum{ 0.f };
+        for (uint32_t t = cluster_offsets[c]; t < cluster_offsets[c + 1]; ++t)
+        {
+            auto const p0 = vertexPosition(mesh, mesh.indices[3 * t]);
+            auto const p1 = vertexPosition(mesh, mesh.indices[3 * t + 1]);
+            auto const p2 = vertexPosition(mesh, mesh.indices[3 * t + 2]);
+
+            std::array<float, 3> const e1{ p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+            std::array<float, 3> const e2{ p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+            std::array<float, 3> const n{ e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+            float const area = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+            for (int i = 0; i < 3; ++i)
+            {
+                centroid[i] += (p0[i] + p1[i] + p2[i]) / 3.f * area;
+                normal[i] += n[i];
+            }
+            area_sum += area;
+        }
+
+        float const normal_length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        if (area_sum == 0.f || normal_length == 0.f)
+        {
+            cluster_sort_keys[c] = 0.f;
+            continue;
+        }
+
+        float key{ 0.f };
+        for (int i = 0; i < 3; ++i) key += (centroid[i] / area_sum - mesh_centroid[i]) * normal[i] / normal_length;
+        cluster_sort_keys[c] = key;
+    }
+
+    std::vector<uint32_t> cluster_order(cluster_count);
+    std::iota(cluster_order.begin(), cluster_order.end(), 0U);
+    std::stable_sort(cluster_order.begin(), cluster_order.end(),
+        [&cluster_sort_keys](uint32_t a, uint32_t b) { return cluster_sort_keys[a] > cluster_sort_keys[b]; });
+
+    std::vector<uint32_t> sorted_indices{};
+    sorted_indices.reserve(mesh.indices.size());
+    for (uint32_t c : cluster_order)
+    {
+        sorted_indices.insert(sorted_indices.end(), mesh.indices.begin() + 3 * cluster_offsets[c], mesh.indices.begin() + 3 * cluster_offsets[c + 1]);
+    }
+    mesh.indices.swap(sorted_indices);
+}
+
+void optimizeVertexFetch(MeshData& mesh)
+{
+    std::unordered_map<uint32_t, uint32_t> remapped_vertices{};
+    remapped_vertices.reserve(mesh.vertexCount());
+    remapVertices(mesh, remapped_vertices);
+}
+
+void optimizeMesh(MeshData& mesh, uint32_t cache_size)
+{
+    weldVertices(mesh);
+    optimizeVertexCache(mesh.indices, mesh.vertexCount(), cache_size);
+    optimizeOverdraw(mesh, cache_size);
+    optimizeVertexFetch(mesh);
+}
+
+VertexCacheStatistics analyzeVertexCache(std::vector<uint32_t> const& indices, uint32_t vertex_count, uint32_t cache_size)
+{
+    std::vector<uint32_t> cache_timestamps(vertex_count, 0U);
+    uint32_t timestamp{ cache_size + 1 };
+    uint32_t miss_count{ 0 };
+    for (uint32_t index : indices)
+    {
+        if (timestamp - cache_timestamps[index] > cache_size)
+        {
+            cache_timestamps[index] = timestamp++;
+            ++miss_count;
+        }
+    }
+
+    uint32_t const triangle_count = static_cast<uint32_t>(indices.size() / 3);
+    return VertexCacheStatistics{
+        .acmr = triangle_count ? static_cast<float>(miss_count) / static_cast<float>(triangle_count) : 0.f,
+        .atvr = vertex_count ? static_cast<float>(miss_count) / static_cast<float>(vertex_count) : 0.f
+    };
+}
+
+}
@@ -0,0 +1,52 @@
+#ifndef LEXGINE_SCENEGRAPH_MESH_OPTIMIZER_H
+#define LEXGINE_SCENEGRAPH_MESH_OPTIMIZER_H
+
+#include <cstdint>
+#include <vector>
+
+namespace lexgine::scenegraph {
+
+//! Triangle list with interleaved vertex data processed on the CPU during scene import
+struct MeshData
+{
+    std::vector<uint32_t> indices;
+    std::vector<uint8_t> vertices;
+    uint32_t vertex_stride;
+    uint32_t position_offset;    //!< offset of the 3-component float32 vertex position from the beginning of the vertex
+
+    uint32_t vertexCount() const { return vertex_stride ? static_cast<uint32_t>(vertices.size() / vertex_stride) : 0U; }
+};
+
+//! Efficiency of the index buffer simulated against the FIFO post-transform vertex cache
+struct VertexCacheStatistics
+{
+    float acmr;    //!< average cache miss ratio, i.e. the number of transformed vertices per triangle (0.5 is the best possible, 3 is the worst)
+    float atvr;    //!< average transformed vertex ratio, i.e. the number of transformed vertices per vertex of the mesh (1 is the best possible)
+};
+
+constexpr uint32_t c_default_vertex_cache_size = 16U;
+
+
+//! Merges binary identical vertices and removes the vertices not referenced by the indices. Returns the new vertex count
+uint32_t weldVertices(MeshData& mesh);
+
+//! Reorders the triangles to improve post-transform vertex cache utilization (T. Forsyth, "Linear-Speed Vertex Cache Optimisation")
+void optimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertex_count, uint32_t cache_size = c_default_vertex_cache_size);
+
+/*! Splits the cache-optimized triangle list into clusters starting at the triangles, which miss the vertex cache completely,
+ and sorts the clusters so that the ones facing outwards from the center of the mesh are drawn first. This reduces overdraw
+ while preserving vertex cache efficiency (P. Sander et al., "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw")
+*/
+void optimizeOverdraw(MeshData& mesh, uint32_t cache_size = c_default_vertex_cache_size);
+
+//! Reorders the vertices in the order of their first use by the index buffer, which makes vertex fetches mostly sequential
+void optimizeVertexFetch(MeshData& mesh);
+
+//! Runs all of the optimizations above in the order, in which they do not counteract each other
+void optimizeMesh(MeshData& mesh, uint32_t cache_size = c_default_vertex_cache_size);
+
+VertexCacheStatistics analyzeVertexCache(std::vector<uint32_t> const& indices, uint32_t vertex_count, uint32_t cache_size = c_default_vertex_cache_size);
+
+}
+
+#endif
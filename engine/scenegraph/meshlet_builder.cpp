@@ -0,0 +1,246 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "engine/core/misc/misc.h"
+#include "meshlet_builder.h"
+
+namespace lexgine::scenegraph
+{
+
+namespace
+{
+
+constexpr uint32_t c_invalid_index = 0xFFFFFFFF;
+
+static_assert(sizeof(Meshlet) == 16 && sizeof(MeshletBounds) == 32, "meshlet data is uploaded to the GPU as is and must not contain padding");
+
+glm::vec3 vertexPosition(MeshData const& mesh, uint32_t vertex)
+{
+    glm::vec3 rv{};
+    std::memcpy(&rv, mesh.vertices.data() + static_cast<size_t>(vertex) * mesh.vertex_stride + mesh.position_offset, sizeof(rv));
+    return rv;
+}
+
+MeshletBounds computeMeshletBounds(MeshData const& mesh, MeshletData const& meshlet_data, Meshlet const& meshlet)
+{
+    MeshletBounds rv{};
+
+    // the sphere is centered at the center of the bounding box of the vertices
+    glm::vec3 bounds_min{ std::numeric_limits<float>::max() }, bounds_max{ std::numeric_limits<float>::lowest() };
+    for (uint32_t i = 0; i < meshlet.vertex_count; ++i)
+    {
+        glm::vec3 const p = vertexPosition(mesh, meshlet_data.vertex_indices[meshlet.vertex_offset + i]);
+        bounds_min = glm::min(bounds_min, p);
+        bounds_max = glm::max(bounds_max, p);
+    }
+    rv.center = (bounds_min + bounds_max) * .5f;
+    for (uint32_t i = 0; i < meshlet.vertex_count; ++i)
+    {
+        rv.radius = (std::max)(rv.radius, glm::length(vertexPosition(mesh, meshlet_data.vertex_indices[meshlet.vertex_offset + i]) - rv.center));
+    }
+
+    // the normal cone is built around the average normal of the triangles, degenerate triangles are not visible and thus ignored
+    std::vector<glm::vec3> normals{};
+    normals.reserve(meshlet.triangle_count);
+    glm::vec3 normal_sum{ 0.f };
+    for (uint32_t t = 0; t < meshlet.triangle_count; ++t)
+    {
+        uint8_t const* p_triangle = meshlet_data.triangle_indices.data() + meshlet.triangle_offset + 3 * t;
+        glm::vec3 const a = vertexPosition(mesh, meshlet_data.vertex_indices[meshlet.vertex_offset + p_triangle[0]]);
+        glm::vec3 const b = vertexPosition(mesh, meshlet_data.vertex_indices[meshlet.vertex_offset + p_triangle[1]]);
+        glm::vec3 const c = vertexPosition(mesh, meshlet_data.vertex_indices[meshlet.vertex_offset + p_triangle[2]]);
+        glm::vec3 const n = glm::cross(b - a, c - a);
+        float const n_length = glm::length(n);
+        if (n_length > 0.f)
+        {
+            normals.push_back(n / n_length);
+            normal_sum += normals.back();
+        }
+    }
+
+    float const normal_sum_length = glm::length(normal_sum);
+    if (normals.empty() || normal_sum_length == 0.f)
+    {
+        rv.cone_axis = glm::vec3{ 0.f, 0.f, 1.f };
+        rv.cone_cos_angle = 0.f;
+        return rv;
+    }
+
+    rv.cone_axis = normal_sum / normal_sum_length;
+    rv.cone_cos_angle = 1.f;
+    for (glm::vec3 const& n : normals)
+    {
+        rv.cone_cos_angle = (std::min)(rv.cone_cos_angle, glm::dot(rv.cone_axis, n));
+    }
+    rv.cone_cos_angle = (std::max)(rv.cone_cos_angle, 0.f);    // cones wider than a hemisphere cannot be used to reject the meshlet
+
+    return rv;
+}
+
+}    // namespace
+
+
+MeshletData buildMeshlets(MeshData const& mesh, uint32_t max_vertices, uint32_t max_triangles)
+{
+    assert(max_vertices >= 3 && max_vertices <= 256 && max_triangles >= 1);
+
+    uint32_t const vertex_count = mesh.vertexCount();
+    uint32_t const triangle_count = static_cast<uint32_t>(mesh.indices.size() / 3);
+
+    // triangles adjacent to each vertex
+    std::vector<uint32_t> adjacency_offsets(vertex_count + 1, 0);
+    for (uint32_t index : mesh.indices) ++adjacency_offsets[index + 1];
+    for (uint32_t v = 0; v < vertex_count; ++v) adjacency_offsets[v + 1] += adjacency_offsets[v];
+    std::vector<uint32_t> adjacent_triangles(mesh.indices.size());
+    {
+        std::vector<uint32_t> fill_offsets(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+        for (uint32_t t = 0; t < triangle_count; ++t)
+        {
+            for (uint32_t i = 0; i < 3; ++i) adjacent_triangles[fill_offsets[mesh.indices[3 * t + i]]++] = t;
+        }
+    }
+
+    MeshletData rv{};
+    std::vector<char> is_triangle_emitted(triangle_count, 0);
+    std::vector<uint32_t> local_indices(vertex_count, c_invalid_index);    // indices of the mesh vertices within the current meshlet
+    std::vector<uint32_t> candidate_triangles{};
+    Meshlet meshlet{ .vertex_offset = 0, .triangle_offset = 0, .vertex_count = 0, .triangle_count = 0 };
+    glm::vec3 meshlet_vertex_sum{ 0.f };    // sum of the positions of the meshlet vertices used to keep the meshlet compact
+    uint32_t next_seed_triangle{ 0 };
+
+    auto new_vertex_count = [&mesh, &local_indices](uint32_t triangle)
+        {
+            uint32_t const a = mesh.indices[3 * triangle], b = mesh.indices[3 * triangle + 1], c = mesh.indices[3 * triangle + 2];
+            return static_cast<uint32_t>(local_indices[a] == c_invalid_index)
+                + static_cast<uint32_t>(local_indices[b] == c_invalid_index && b != a)
+                + static_cast<uint32_t>(local_indices[c] == c_invalid_index && c != a && c != b);
+        };
+
+    auto finish_meshlet = [&]()
+        {
+            for (uint32_t i = 0; i < meshlet.vertex_count; ++i)
+            {
+                local_indices[rv.vertex_indices[meshlet.vertex_offset + i]] = c_invalid_index;
+            }
+            rv.meshlets.push_back(meshlet);
+            rv.bounds.push_back(computeMeshletBounds(mesh, rv, meshlet));
+
+            meshlet = Meshlet{
+                .vertex_offset = static_cast<uint32_t>(rv.vertex_indices.size()),
+                .triangle_offset = static_cast<uint32_t>(rv.triangle_indices.size()),
+                .vertex_count = 0,
+                .triangle_count = 0
+            };
+            candidate_triangles.clear();
+            meshlet_vertex_sum = glm::vec3{ 0.f };
+        };
+
+    for (uint32_t emitted_triangle_count = 0; emitted_triangle_count < triangle_count; ++emitted_triangle_count)
+    {
+        // choose the triangle adding the fewest vertices among the ones adjacent to the meshlet,
+        // ties are resolved in favor of the triangle closest to the center of the meshlet
+        uint32_t best_triangle{ c_invalid_index };
+        uint32_t best_new_vertex_count{ 4 };
+        float best_distance{ std::numeric_limits<float>::max() };
+        glm::vec3 const meshlet_center = meshlet_vertex_sum / static_cast<float>((std::max)(meshlet.vertex_count, 1U));
+        size_t live_candidate_count{ 0 };
+        for (uint32_t t : candidate_triangles)
+        {
+            if (is_triangle_emitted[t]) continue;
+            candidate_triangles[live_candidate_count++] = t;
+
+            uint32_t const n = new_vertex_count(t);
+            if (meshlet.vertex_count + n > max_vertices || n > best_new_vertex_count) continue;
+
+            glm::vec3 const triangle_center = (vertexPosition(mesh, mesh.indices[3 * t])
+                + vertexPosition(mesh, mesh.indices[3 * t + 1]) + vertexPosition(mesh, mesh.indices[3 * t + 2])) / 3.f;
+            float const distance = glm::dot(triangle_center - meshlet_center, triangle_center - meshlet_center);
+            if (n < best_new_vertex_count || distance < best_distance)
+            {
+                best_triangle = t;
+                best_new_vertex_count = n;
+                best_distance = distance;
+            }
+        }
+        candidate_triangles.resize(live_candidate_count);
+
+        if (best_triangle == c_invalid_index)
+        {
+            // the meshlet cannot grow any further, so it is finished and a new one is started from the earliest remaining triangle
+            if (meshlet.triangle_count > 0) finish_meshlet();
+            while (is_triangle_emitted[next_seed_triangle]) ++next_seed_triangle;
+            best_triangle = next_seed_triangle;
+        }
+
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            uint32_t const vertex = mesh.indices[3 * best_triangle + i];
+            if (local_indices[vertex] == c_invalid_index)
+            {
+                local_indices[vertex] = meshlet.vertex_count++;
+                rv.vertex_indices.push_back(vertex);
+                meshlet_vertex_sum += vertexPosition(mesh, vertex);
+
+                for (uint32_t j = adjacency_offsets[vertex]; j < adjacency_offsets[vertex + 1]; ++j)
+                {
+                    if (!is_triangle_emitted[adjacent_triangles[j]]) candidate_triangles.push_back(adjacent_triangles[j]);
+                }
+            }
+            rv.triangle_indices.push_back(static_cast<uint8_t>(local_indices[vertex]));
+        }
+        is_triangle_emitted[best_triangle] = 1;
+
+        if (++meshlet.triangle_count == max_triangles) finish_meshlet();
+    }
+    if (meshlet.triangle_count > 0) finish_meshlet();
+
+    return rv;
+}
+
+std::vector<uint8_t> packMeshlets(MeshletData const& meshlet_data, MeshletBufferLayout& layout)
+{
+    size_t const meshlets_size = meshlet_data.meshlets.size() * sizeof(Meshlet);
+    size_t const bounds_size = meshlet_data.bounds.size() * sizeof(MeshletBounds);
+    size_t const vertex_indices_size = meshlet_data.vertex_indices.size() * sizeof(uint32_t);
+    size_t const triangle_indices_size = meshlet_data.triangle_indices.size();
+
+    layout.meshlet_offset = 0;
+    layout.bounds_offset = static_cast<uint32_t>(core::misc::align(layout.meshlet_offset + meshlets_size, 16));
+    layout.vertex_index_offset = static_cast<uint32_t>(core::misc::align(layout.bounds_offset + bounds_size, 16));
+    layout.triangle_index_offset = static_cast<uint32_t>(core::misc::align(layout.vertex_index_offset + vertex_indices_size, 16));
+
+    std::vector<uint8_t> rv(core::misc::align(layout.triangle_index_offset + triangle_indices_size, 16), 0);
+    if (meshlets_size) std::memcpy(rv.data() + layout.meshlet_offset, meshlet_data.meshlets.data(), meshlets_size);
+    if (bounds_size) std::memcpy(rv.data() + layout.bounds_offset, meshlet_data.bounds.data(), bounds_size);
+    if (vertex_indices_size) std::memcpy(rv.data() + layout.vertex_index_offset, meshlet_data.vertex_indices.data(), vertex_indices_size);
+    if (triangle_indices_size) std::memcpy(rv.data() + layout.triangle_index_offset, meshlet_data.triangle_indices.data(), triangle_indices_size);
+
+    return rv;
+}
+
+void cullMeshlets(MeshletData const& meshlet_data, MeshletFrustumPlanes const& frustum_planes, glm::vec3 const& camera_position,
+    std::vector<uint32_t>& visible_meshlets)
+{
+    for (uint32_t i = 0; i < static_cast<uint32_t>(meshlet_data.bounds.size()); ++i)
+    {
+        MeshletBounds const& bounds = meshlet_data.bounds[i];
+
+        bool const is_outside = std::any_of(frustum_planes.begin(), frustum_planes.end(),
+            [&bounds](glm::vec4 const& plane) { return glm::dot(glm::vec3{ plane }, bounds.center) + plane.w < -bounds.radius; });
+        if (is_outside) continue;
+
+        // every point p of the meshlet lies within the bounding sphere and every normal n deviates from the cone axis by at most the cone angle,
+        // so that dot(n, p - camera) is bounded from below by dot(axis, d) * cos(angle) - |d| * sin(angle) - radius, where d = center - camera.
+        // When this bound is positive all of the triangles face away from the camera
+        glm::vec3 const d = bounds.center - camera_position;
+        float const cone_sin_angle = std::sqrt((std::max)(0.f, 1.f - bounds.cone_cos_angle * bounds.cone_cos_angle));
+        if (glm::dot(bounds.cone_axis, d) * bounds.cone_cos_angle > glm::length(d) * cone_sin_angle + bounds.radius) continue;
+
+        visible_meshlets.push_back(i);
+    }
+}
+
+}
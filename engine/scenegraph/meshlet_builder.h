@@ -0,0 +1,77 @@
+#ifndef LEXGINE_SCENEGRAPH_MESHLET_BUILDER_H
+#define LEXGINE_SCENEGRAPH_MESHLET_BUILDER_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "mesh_optimizer.h"
+
+namespace lexgine::scenegraph {
+
+constexpr uint32_t c_default_meshlet_max_vertices = 64U;
+constexpr uint32_t c_default_meshlet_max_triangles = 124U;
+
+//! Cluster of triangles of a mesh small enough to be culled and processed by a single thread group
+struct Meshlet
+{
+    uint32_t vertex_offset;    //!< offset of the first vertex of the meshlet in MeshletData::vertex_indices
+    uint32_t triangle_offset;    //!< offset of the first triangle of the meshlet in MeshletData::triangle_indices measured in bytes
+    uint32_t vertex_count;
+    uint32_t triangle_count;
+};
+
+//! Bounds of a meshlet in the space of the mesh
+struct MeshletBounds
+{
+    glm::vec3 center;    //!< center of the bounding sphere
+    float radius;
+    glm::vec3 cone_axis;    //!< average direction of the normals of the triangles
+    float cone_cos_angle;    //!< cosine of the largest angle between the cone axis and the normals of the triangles. Zero if the cone is wider than a hemisphere
+};
+
+//! Triangles of a mesh partitioned into meshlets
+struct MeshletData
+{
+    std::vector<Meshlet> meshlets;
+    std::vector<MeshletBounds> bounds;    //!< bounds of each meshlet
+    std::vector<uint32_t> vertex_indices;    //!< indices of the mesh vertices referenced by the meshlets
+    std::vector<uint8_t> triangle_indices;    //!< triangles of the meshlets, each represented by three indices into the vertices of its meshlet
+};
+
+//! Layout of the meshlet data packed into a single buffer. The offsets are measured in bytes from the beginning of the buffer
+struct MeshletBufferLayout
+{
+    uint32_t meshlet_offset;
+    uint32_t bounds_offset;
+    uint32_t vertex_index_offset;
+    uint32_t triangle_index_offset;
+};
+
+using MeshletFrustumPlanes = std::array<glm::vec4, 6>;
+
+
+/*! Partitions the triangles of the mesh into meshlets referencing at most the given number of vertices and triangles.
+ Meshlets are grown greedily from the triangles adjacent to the vertices already in the meshlet preferring the triangles,
+ which add the fewest new vertices, so that meshlets stay compact and the vertices are shared between as many triangles
+ as possible. The mesh should be optimized for the vertex cache beforehand, which makes meshlets follow the triangle order
+*/
+MeshletData buildMeshlets(MeshData const& mesh,
+    uint32_t max_vertices = c_default_meshlet_max_vertices, uint32_t max_triangles = c_default_meshlet_max_triangles);
+
+//! Packs the meshlet data into a single buffer with all sections aligned to 16 bytes
+std::vector<uint8_t> packMeshlets(MeshletData const& meshlet_data, MeshletBufferLayout& layout);
+
+/*! Appends indices of the meshlets, which may have visible triangles, to the output list. The meshlets are rejected if their
+ bounding spheres are outside of the frustum or if all of their triangles face away from the camera (counter-clockwise triangles
+ are considered front-facing). The planes are expected to point inside of the frustum and to be normalized, and both the planes
+ and the camera position must be given in the space of the mesh
+*/
+void cullMeshlets(MeshletData const& meshlet_data, MeshletFrustumPlanes const& frustum_planes, glm::vec3 const& camera_position,
+    std::vector<uint32_t>& visible_meshlets);
+
+}
+
+#endif
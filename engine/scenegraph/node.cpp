@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <utility>
+
+#include "engine/core/misc/log.h"
 #include "node.h"
 
 
@@ -5,20 +9,79 @@ namespace lexgine::scenegraph
 {
 
 Node::Node()
-    : m_parent_to_local_transform{ 1.f }
-    , m_local_to_parent_transform{ 1.f }
-    , m_world_to_local_transform { 1.f }
-    , m_local_to_world_transform { 1.f }
+    : m_own_transforms{ std::make_unique<OwnTransforms>() }
 {
 
 }
 
+Node::Node(TransformHierarchy& transform_hierarchy)
+    : m_transform_hierarchy{ &transform_hierarchy }
+    , m_transform_handle{ transform_hierarchy.addTransform() }
+{
+
+}
+
+Node::Node(Node&& other) noexcept
+    : NamedEntity<class_names::Node>{ std::move(other) }
+    , m_light_ptr{ other.m_light_ptr }
+    , m_camera_ptr{ other.m_camera_ptr }
+    , m_mesh_ptr{ other.m_mesh_ptr }
+    , m_parent{ other.m_parent }
+    , m_lods{ std::move(other.m_lods) }
+    , m_children{ std::move(other.m_children) }
+    , m_instance_transforms{ std::move(other.m_instance_transforms) }
+    , m_transform_hierarchy{ std::exchange(other.m_transform_hierarchy, nullptr) }
+    , m_transform_handle{ std::exchange(other.m_transform_handle, TransformHierarchy::c_invalid_handle) }
+    , m_own_transforms{ std::move(other.m_own_transforms) }
+{
+
+}
+
+Node::~Node()
+{
+    if (m_transform_hierarchy)
+    {
+        m_transform_hierarchy->releaseTransform(m_transform_handle);
+    }
+}
+
+Node& Node::operator=(Node&& other) noexcept
+{
+    if (this == &other) return *this;
+
+    if (m_transform_hierarchy)
+    {
+        m_transform_hierarchy->releaseTransform(m_transform_handle);
+    }
+
+    NamedEntity<class_names::Node>::operator=(std::move(other));
+    m_light_ptr = other.m_light_ptr;
+    m_camera_ptr = other.m_camera_ptr;
+    m_mesh_ptr = other.m_mesh_ptr;
+    m_parent = other.m_parent;
+    m_lods = std::move(other.m_lods);
+    m_children = std::move(other.m_children);
+    m_instance_transforms = std::move(other.m_instance_transforms);
+    m_transform_hierarchy = std::exchange(other.m_transform_hierarchy, nullptr);
+    m_transform_handle = std::exchange(other.m_transform_handle, TransformHierarchy::c_invalid_handle);
+    m_own_transforms = std::move(other.m_own_transforms);
+
+    return *this;
+}
+
 void Node::addChild(Node* child)
 {
+    if (child->m_transform_hierarchy != m_transform_hierarchy)
+    {
+        LEXGINE_LOG_ERROR(this, "Unable to attach node \"" + child->getStringName() + "\": the node does not belong to the same transform hierarchy");
+        return;
+    }
+
+    if (m_transform_hierarchy && !m_transform_hierarchy->setParent(child->m_transform_handle, m_transform_handle)) return;
+
     m_children.push_back(child);
     child->m_parent = this;
-    child->m_isDirty = true;
-    child->m_parent_to_local_transform = child->m_local_to_parent_transform = lexgine::core::math::Matrix4f{ 1.f };
+    child->setLocalTransform(lexgine::core::math::Matrix4f{ 1.f }, lexgine::core::math::Matrix4f{ 1.f });
 }
 
 void Node::removeChild(Node* child)
@@ -27,37 +90,44 @@ void Node::removeChild(Node* child)
     if (it != m_children.end()) {
         m_children.erase(it);
         child->m_parent = nullptr;
-        child->m_isDirty = true;
+
+        if (m_transform_hierarchy)
+        {
+            m_transform_hierarchy->setParent(child->m_transform_handle, TransformHierarchy::c_invalid_handle);
+        }
+        else
+        {
+            child->invalidateOwnTransforms();
+        }
     }
 }
 
 lexgine::core::math::Matrix4f const& Node::parentToLocalTransform() const
 {
     updateTransforms();
-    return m_parent_to_local_transform;
+    return m_transform_hierarchy ? m_transform_hierarchy->parentToLocalTransform(m_transform_handle) : m_own_transforms->parent_to_local;
 }
 
 lexgine::core::math::Matrix4f const& Node::localToParentTransform() const
 {
     updateTransforms();
-    return m_local_to_parent_transform;
+    return m_transform_hierarchy ? m_transform_hierarchy->localToParentTransform(m_transform_handle) : m_own_transforms->local_to_parent;
 }
 
 lexgine::core::math::Matrix4f const& Node::worldToLocalTransform() const
 {
     updateTransforms();
-    return m_world_to_local_transform;
+    return m_transform_hierarchy ? m_transform_hierarchy->worldToLocalTransform(m_transform_handle) : m_own_transforms->world_to_local;
 }
 
 lexgine::core::math::Matrix4f const& Node::localToWorldTransform() const
 {
     updateTransforms();
-    return m_local_to_world_transform;
+    return m_transform_hierarchy ? m_transform_hierarchy->localToWorldTransform(m_transform_handle) : m_own_transforms->local_to_world;
 }
 
 void Node::translate(lexgine::core::math::Vector3f& translation_vector)
 {
-    m_isDirty = true;
     lexgine::core::math::Matrix4f transform{
         lexgine::core::math::Vector4f{1.f, 0.f, 0.f, 0.f},
         lexgine::core::math::Vector4f{0.f, 1.f, 0.f, 0.f},
@@ -72,9 +142,7 @@ void Node::translate(lexgine::core::math::Vector3f& translation_vector)
         lexgine::core::math::Vector4f { -translation_vector.x, -translation_vector.y, -translation_vector.z, 1.f }
     };
 
-    m_parent_to_local_transform = inverse_transform;
-    m_local_to_parent_transform = transform;
-
+    setLocalTransform(transform, inverse_transform);
 }
 
 void Node::rotate(lexgine::core::math::Vector3f& rotation_axis, float angle)
@@ -85,13 +153,12 @@ void Node::rotate(lexgine::core::math::Vector3f& rotation_axis, float angle)
         lexgine::core::math::Vector4f{rotation_axis.y, -rotation_axis.x, 0.f, 0.f},
         lexgine::core::math::Vector4f{0.f, 0.f, 0.f, 1.f}
     };
-    m_local_to_parent_transform = lexgine::core::math::Matrix4f{ 1.f } + std::sinf(angle) * K + (1.f - std::cosf(angle)) * (K * K);
-    m_parent_to_local_transform = glm::inverse(m_local_to_parent_transform);
+    lexgine::core::math::Matrix4f transform = lexgine::core::math::Matrix4f{ 1.f } + std::sinf(angle) * K + (1.f - std::cosf(angle)) * (K * K);
+    setLocalTransform(transform, glm::inverse(transform));
 }
 
 void Node::scale(lexgine::core::math::Vector3f& scaling_vector)
 {
-    m_isDirty = true;
     lexgine::core::math::Matrix4f transform {
         lexgine::core::math::Vector4f { scaling_vector.x, 0.f, 0.f, 0.f },
         lexgine::core::math::Vector4f { 0.f, scaling_vector.y, 0.f, 0.f },
@@ -104,8 +171,7 @@ void Node::scale(lexgine::core::math::Vector3f& scaling_vector)
         lexgine::core::math::Vector4f { 0.f, 0.f, 1.f / scaling_vector.z, 0.f },
         lexgine::core::math::Vector4f { 0.f, 0.f, 0.f, 1.f }
     };
-    m_parent_to_local_transform = inverse_transform;
-    m_local_to_parent_transform = transform;
+    setLocalTransform(transform, inverse_transform);
 }
 
 void Node::setLight(Light* light)
@@ -131,27 +197,62 @@ void Node::setMesh(Mesh* mesh)
 
 void Node::updateTransforms() const
 {
-    if (!m_isDirty)
+    if (m_transform_hierarchy)
+    {
+        // the whole hierarchy is brought up to date at once, so that the following queries of other nodes are cheap
+        if (!m_transform_hierarchy->isUpToDate()) m_transform_hierarchy->update();
+        return;
+    }
+
+    OwnTransforms& transforms = *m_own_transforms;
+    if (!transforms.is_dirty)
     {
         return;
     }
 
+    // same convention as in TransformHierarchy: the local transform of a root is its world transform,
+    // and the local transform of a child is applied before the world transform of its parent
     if (!m_parent)
     {
-        m_parent_to_local_transform = m_local_to_parent_transform
-            = m_world_to_local_transform = m_local_to_world_transform = lexgine::core::math::Matrix4f{ 1.f };
+        transforms.world_to_local = transforms.parent_to_local;
+        transforms.local_to_world = transforms.local_to_parent;
     }
     else
     {
-        if (m_parent->m_isDirty)
+        if (m_parent->m_own_transforms->is_dirty)
         {
             m_parent->updateTransforms();
         }
 
-        m_world_to_local_transform = m_parent->m_world_to_local_transform * m_parent_to_local_transform;
-        m_local_to_world_transform = m_local_to_parent_transform * m_parent->m_local_to_world_transform;
+        OwnTransforms const& parent_transforms = *m_parent->m_own_transforms;
+        transforms.world_to_local = transforms.parent_to_local * parent_transforms.world_to_local;
+        transforms.local_to_world = parent_transforms.local_to_world * transforms.local_to_parent;
+    }
+
+    transforms.is_dirty = false;
+}
+
+void Node::invalidateOwnTransforms()
+{
+    // world transforms of the whole subtree depend on the local transform of this node
+    m_own_transforms->is_dirty = true;
+    for (Node* child : m_children)
+    {
+        if (!child->m_own_transforms->is_dirty) child->invalidateOwnTransforms();
     }
 }
 
+void Node::setLocalTransform(lexgine::core::math::Matrix4f const& local_to_parent, lexgine::core::math::Matrix4f const& parent_to_local)
+{
+    if (m_transform_hierarchy)
+    {
+        m_transform_hierarchy->setLocalTransform(m_transform_handle, local_to_parent, parent_to_local);
+        return;
+    }
+
+    invalidateOwnTransforms();
+    m_own_transforms->local_to_parent = local_to_parent;
+    m_own_transforms->parent_to_local = parent_to_local;
 }
 
+}
@@ -1,12 +1,14 @@
 #ifndef LEXGINE_SCENEGRAPH_NODE_H
 #define LEXGINE_SCENEGRAPH_NODE_H
 
+#include <memory>
 #include <vector>
 #include "lexgine_scenegraph_fwd.h"
 #include "engine/core/math/matrix_types.h"
 #include "engine/core/math/vector_types.h"
 #include "engine/core/entity.h"
 #include "class_names.h"
+#include "transform_hierarchy.h"
 
 namespace lexgine::scenegraph {
 
@@ -15,11 +17,17 @@ class Node : public core::NamedEntity<class_names::Node>
 public:
     Node();
 
+    /*! Creates node, which keeps its transforms in the given flat transform hierarchy instead of computing them on its own.
+     Such node is a thin handle into the hierarchy and can only be attached to the nodes sharing the same transform hierarchy
+    */
+    explicit Node(TransformHierarchy& transform_hierarchy);
+
     Node(Node const&) = delete;
-    Node(Node&&) = default;
+    Node(Node&& other) noexcept;
+    ~Node();
 
     Node& operator=(Node const&) = delete;
-    Node& operator=(Node&&) = default;
+    Node& operator=(Node&& other) noexcept;
 
     Node* getParent() { return m_parent; }
     Node const* getParent() const { return const_cast<Node*>(this)->getParent(); }
@@ -48,8 +56,27 @@ public:
     Camera* getCamera() const { return m_camera_ptr; }
     Mesh* getMesh() const { return m_mesh_ptr; }
 
+    /*! Sets transforms of the instances of the mesh attached to the node relative to the node itself (as defined by EXT_mesh_gpu_instancing).
+     The mesh is drawn once per each transform, or once with the transform of the node when the list is empty
+    */
+    void setInstanceTransforms(std::vector<lexgine::core::math::Matrix4f>&& instance_transforms) { m_instance_transforms = std::move(instance_transforms); }
+    std::vector<lexgine::core::math::Matrix4f> const& instanceTransforms() const { return m_instance_transforms; }
+
 private:
     void updateTransforms() const;
+    void invalidateOwnTransforms();    //!< marks own transforms of the node and of all of its descendants for recomputation
+    void setLocalTransform(lexgine::core::math::Matrix4f const& local_to_parent, lexgine::core::math::Matrix4f const& parent_to_local);
+
+private:
+    //! Transforms of the node computed on its own, only allocated for the nodes not attached to a transform hierarchy
+    struct OwnTransforms
+    {
+        bool is_dirty{ true };
+        lexgine::core::math::Matrix4f parent_to_local{ 1.f };
+        lexgine::core::math::Matrix4f local_to_parent{ 1.f };
+        lexgine::core::math::Matrix4f world_to_local{ 1.f };
+        lexgine::core::math::Matrix4f local_to_world{ 1.f };
+    };
 
 private:
     Light* m_light_ptr{ nullptr };
@@ -60,12 +87,11 @@ private:
 
     std::vector<Node*> m_lods;
     std::vector<Node*> m_children;
+    std::vector<lexgine::core::math::Matrix4f> m_instance_transforms;
 
-    bool m_isDirty = true;
-    mutable lexgine::core::math::Matrix4f m_parent_to_local_transform;
-    mutable lexgine::core::math::Matrix4f m_local_to_parent_transform;
-    mutable lexgine::core::math::Matrix4f m_world_to_local_transform;
-    mutable lexgine::core::math::Matrix4f m_local_to_world_transform;
+    TransformHierarchy* m_transform_hierarchy{ nullptr };    //!< when not null, transforms of the node are stored in the transform hierarchy
+    TransformHierarchy::Handle m_transform_handle{ TransformHierarchy::c_invalid_handle };
+    std::unique_ptr<OwnTransforms> m_own_transforms;    //!< null when the node belongs to a transform hierarchy
 };
 
 }
@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <functional>
+#include <tuple>
+
+#include "render_list.h"
+#include "node.h"
+#include "mesh.h"
+#include "material.h"
+
+namespace lexgine::scenegraph
+{
+
+bool RenderBatchKey::operator<(RenderBatchKey const& other) const
+{
+    // std::less provides total order on pointers, which is not guaranteed by the built-in comparison of unrelated pointers
+    auto less = [](auto const* a, auto const* b) { return std::less<decltype(a)>{}(a, b); };
+
+    if (pso != other.pso) return less(pso, other.pso);
+    if (root_signature != other.root_signature) return less(root_signature, other.root_signature);
+    if (material != other.material) return less(material, other.material);
+    return less(submesh, other.submesh);
+}
+
+
+RenderListBuilder::RenderListBuilder(uint32_t max_instances_per_draw)
+    : m_max_instances_per_draw{ (std::max)(max_instances_per_draw, 1U) }
+{
+
+}
+
+void RenderListBuilder::clear()
+{
+    m_instance_keys.clear();
+    m_submitted_transforms.clear();
+    m_instance_order.clear();
+    m_draws.clear();
+    m_instance_transforms.clear();
+}
+
+void RenderListBuilder::addInstance(RenderBatchKey const& key, core::math::Matrix4f const& local_to_world)
+{
+    m_instance_keys.push_back(key);
+    m_submitted_transforms.push_back(local_to_world);
+}
+
+void RenderListBuilder::addNode(Node const& node)
+{
+    Mesh const* p_mesh = node.getMesh();
+    if (!p_mesh) return;
+
+    for (size_t i = 0; i < p_mesh->getSubmeshCount(); ++i)
+    {
+        Submesh const& submesh = p_mesh->getSubmesh(i);
+        Material const* p_material = submesh.getBaseMaterial();
+        if (!p_material) continue;
+
+        MaterialAssemblyTask const& material_assembly = p_material->getAssemblyTask();
+        RenderBatchKey const key{
+            .pso = material_assembly.getPSOCompilationTask(),
+            .root_signature = material_assembly.getRootSignatureCompilationTask(),
+            .material = p_material,
+            .submesh = &submesh
+        };
+        if (!key.pso || !key.root_signature) continue;
+
+        if (node.instanceTransforms().empty())
+        {
+            addInstance(key, node.localToWorldTransform());
+        }
+        else
+        {
+            for (auto const& instance_transform : node.instanceTransforms())
+            {
+                addInstance(key, node.localToWorldTransform() * instance_transform);
+            }
+        }
+    }
+}
+
+void RenderListBuilder::build()
+{
+    uint32_t const instance_count = instanceCount();
+
+    // stable sort keeps the instances of each draw in the order of their submission
+    m_instance_order.resize(instance_count);
+    for (uint32_t i = 0; i < instance_count; ++i) m_instance_order[i] = i;
+    std::stable_sort(m_instance_order.begin(), m_instance_order.end(),
+        [this](uint32_t a, uint32_t b) { return m_instance_keys[a] < m_instance_keys[b]; });
+
+    m_draws.clear();
+    m_instance_transforms.resize(instance_count);
+    for (uint32_t i = 0; i < instance_count; ++i)
+    {
+        uint32_t const instance = m_instance_order[i];
+        RenderBatchKey const& key = m_instance_keys[instance];
+        m_instance_transforms[i] = m_submitted_transforms[instance];
+
+        if (!m_draws.empty() && m_draws.back().key == key && m_draws.back().instance_count < m_max_instances_per_draw)
+        {
+            ++m_draws.back().instance_count;
+            continue;
+        }
+
+        InstancedDraw const* p_previous_draw = m_draws.empty() ? nullptr : &m_draws.back();
+        m_draws.push_back(InstancedDraw{
+            .key = key,
+            .first_instance = i,
+            .instance_count = 1,
+            .is_new_pipeline_state = !p_previous_draw || p_previous_draw->key.pso != key.pso,
+            .is_new_root_signature = !p_previous_draw || p_previous_draw->key.root_signature != key.root_signature,
+            .is_new_material = !p_previous_draw || p_previous_draw->key.material != key.material
+            });
+    }
+}
+
+}
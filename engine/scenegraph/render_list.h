@@ -0,0 +1,79 @@
+#ifndef LEXGINE_SCENEGRAPH_RENDER_LIST_H
+#define LEXGINE_SCENEGRAPH_RENDER_LIST_H
+
+#include <cstdint>
+#include <vector>
+
+#include "engine/core/math/matrix_types.h"
+#include "engine/core/entity.h"
+#include "engine/core/dx/d3d12/tasks/lexgine_core_dx_d3d12_tasks_fwd.h"
+#include "lexgine_scenegraph_fwd.h"
+#include "class_names.h"
+
+namespace lexgine::scenegraph {
+
+//! State shared by all instances, which can be drawn by a single instanced draw call
+struct RenderBatchKey
+{
+    core::dx::d3d12::tasks::GraphicsPSOCompilationTask const* pso;
+    core::dx::d3d12::tasks::RootSignatureCompilationTask const* root_signature;
+    Material const* material;
+    Submesh const* submesh;
+
+    bool operator==(RenderBatchKey const& other) const = default;
+    bool operator<(RenderBatchKey const& other) const;    //! orders the keys so that the draws sharing pipeline state, root signature and material follow each other
+};
+
+//! Instanced draw of a submesh. The transforms of the instances occupy a contiguous range of RenderListBuilder::instanceTransforms()
+struct InstancedDraw
+{
+    RenderBatchKey key;
+    uint32_t first_instance;
+    uint32_t instance_count;
+    bool is_new_pipeline_state;    //!< 'true' if pipeline state of the draw differs from that of the previous draw in the list
+    bool is_new_root_signature;    //!< 'true' if root signature of the draw differs from that of the previous draw in the list
+    bool is_new_material;    //!< 'true' if material of the draw differs from that of the previous draw in the list, i.e. the material constants must be rebound
+};
+
+
+/*! Collects visible submesh instances and groups them into instanced draws. Instances sharing pipeline state, root signature,
+ material and submesh are merged into a single draw regardless of the order they were added in, and the draws are sorted so that
+ the state changes between them are minimized. Transforms of the instances are laid out so that each draw refers to a contiguous
+ range of them, which is meant to be uploaded as per-instance data. Within a draw the instances keep the order of their submission
+*/
+class RenderListBuilder final : public core::NamedEntity<class_names::RenderListBuilder>
+{
+public:
+    //! draws with more instances than the given limit are split into several draws (e.g. to fit per-instance data into a constant buffer)
+    explicit RenderListBuilder(uint32_t max_instances_per_draw = 0xFFFFFFFF);
+
+    //! removes all instances and draws, so that the builder can be reused for the next frame without reallocations
+    void clear();
+
+    void addInstance(RenderBatchKey const& key, core::math::Matrix4f const& local_to_world);
+
+    /*! Adds an instance of each submesh of the mesh attached to the node, which uses the base material of the submesh.
+     If the node carries GPU instancing transforms, an instance is added per each of them. Nodes without a mesh and submeshes
+     without a material, or with a material that has not been assembled yet, are ignored
+    */
+    void addNode(Node const& node);
+
+    //! groups the instances added since the last call of clear() into draws
+    void build();
+
+    std::vector<InstancedDraw> const& draws() const { return m_draws; }
+    std::vector<core::math::Matrix4f> const& instanceTransforms() const { return m_instance_transforms; }
+    uint32_t instanceCount() const { return static_cast<uint32_t>(m_instance_keys.size()); }
+
+private:
+    uint32_t m_max_instances_per_draw;
+    std::vector<RenderBatchKey> m_instance_keys;
+    std::vector<core::math::Matrix4f> m_submitted_transforms;    //!< transforms of the instances in the order of submission
+    std::vector<uint32_t> m_instance_order;
+    std::vector<InstancedDraw> m_draws;
+    std::vector<core::math::Matrix4f> m_instance_transforms;
+};
+
+}
+
+#endif
@@ -1,11 +1,19 @@
 
 #include <algorithm>
 #include <cctype>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
 #include <future>
 #include <numeric>
+#include <set>
+#include <span>
 #include <thread>
 
 #include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
 
 #define TINYGLTF3_IMPLEMENTATION
 #define TINYGLTF3_ENABLE_FS
@@ -17,8 +25,7 @@
 #include <engine/core/misc/misc.h>
 #include <engine/core/dx/d3d12/dx_resource_factory.h>
 #include <engine/core/dx/d3d12/basic_rendering_services.h>
-#include <engine/core/concurrency/task_graph.h>
-#include <engine/core/concurrency/task_sink.h>
+#include <engine/core/concurrency/asset_scheduler.h>
 #include <engine/core/dx/d3d12/tasks/hlsl_compilation_task.h>
 #include <engine/conversion/image_loader_pool.h>
 #include <engine/conversion/texture_converter.h>
@@ -151,6 +158,226 @@ lexgine::scenegraph::WrapMode gltfCast<lexgine::scenegraph::WrapMode>(int gltf_w
     }
 }
 
+std::chrono::microseconds elapsedSince(std::chrono::steady_clock::time_point const& start_time)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time);
+}
+
+//! Wraps a single job of the scene import pipeline, so that it can be executed by the engine's task sink
+class SceneImportTask final : public core::concurrency::SchedulableTask
+{
+public:
+    SceneImportTask(std::string const& debug_name, std::function<bool()> const& job)
+        : SchedulableTask{ debug_name }
+        , m_job{ job }
+    {
+    }
+
+    bool doTask(uint8_t worker_id, uint64_t user_data) override
+    {
+        m_result = m_job();
+        return true;    // failures are reported through result() so that the remaining jobs of the import still get executed
+    }
+
+    core::concurrency::TaskType type() const override { return core::concurrency::TaskType::cpu; }
+
+    bool result() const { return m_result; }
+
+private:
+    std::function<bool()> m_job;
+    bool m_result{ false };
+};
+
+//! Reads instance attribute of EXT_mesh_gpu_instancing converting its elements to floats. Returns 'false' if the accessor is not readable
+bool readInstanceAttribute(tg3_model const& model, int accessor_id, int expected_type, std::vector<glm::vec4>& values)
+{
+    if (accessor_id < 0 || static_cast<uint32_t>(accessor_id) >= model.accessors_count) return false;
+
+    tg3_accessor const& accessor = model.accessors[accessor_id];
+    if (accessor.type != expected_type || accessor.buffer_view < 0 || accessor.sparse.is_sparse) return false;
+
+    bool const is_float = accessor.component_type == TG3_COMPONENT_TYPE_FLOAT;
+    bool const is_normalized_integer = accessor.normalized
+        && (accessor.component_type == TG3_COMPONENT_TYPE_BYTE || accessor.component_type == TG3_COMPONENT_TYPE_SHORT);
+    if (!is_float && !is_normalized_integer) return false;
+
+    tg3_buffer_view const& buffer_view = model.buffer_views[accessor.buffer_view];
+    int const component_count = tg3_num_components(accessor.type);
+    size_t const component_size = static_cast<size_t>(tg3_component_size(accessor.component_type));
+    size_t const element_size = component_count * component_size;
+    size_t const source_stride = buffer_view.byte_stride ? buffer_view.byte_stride : element_size;
+    size_t const source_offset = buffer_view.byte_offset + accessor.byte_offset;
+    if (accessor.count == 0 || source_offset + (accessor.count - 1) * source_stride + element_size > model.buffers[buffer_view.buffer].data.count) return false;
+
+    uint8_t const* p_source = model.buffers[buffer_view.buffer].data.data + source_offset;
+    values.resize(accessor.count);
+    for (uint64_t i = 0; i < accessor.count; ++i)
+    {
+        uint8_t const* p_element = p_source + i * source_stride;
+        for (int c = 0; c < component_count; ++c)
+        {
+            uint8_t const* p_component = p_element + c * component_size;
+            switch (accessor.component_type)
+            {
+            case TG3_COMPONENT_TYPE_FLOAT:
+                std::memcpy(&values[i][c], p_component, sizeof(float));
+                break;
+
+            case TG3_COMPONENT_TYPE_BYTE:
+                values[i][c] = (std::max)(static_cast<int8_t>(*p_component) / 127.f, -1.f);
+                break;
+
+            case TG3_COMPONENT_TYPE_SHORT:
+            {
+                int16_t component; std::memcpy(&component, p_component, sizeof(int16_t));
+                values[i][c] = (std::max)(component / 32767.f, -1.f);
+                break;
+            }
+            }
+        }
+    }
+
+    return true;
+}
+
+/*! Composes transforms of the instances defined by EXT_mesh_gpu_instancing attached to the node. Returns empty list if the node
+ does not use the extension and std::nullopt if the instance attributes are invalid
+*/
+std::optional<std::vector<core::math::Matrix4f>> readInstanceTransforms(tg3_model const& model, tg3_node const& node, char const* extension_name)
+{
+    tg3_value const* p_instancing = nullptr;
+    for (uint32_t ei = 0; ei < node.ext.extensions_count; ++ei)
+    {
+        if (tg3_str_equals_cstr(node.ext.extensions[ei].name, extension_name))
+        {
+            p_instancing = &node.ext.extensions[ei].value;
+            break;
+        }
+    }
+    if (!p_instancing) return std::vector<core::math::Matrix4f>{};
+
+    tg3_value const* p_attributes = nullptr;
+    for (uint32_t i = 0; p_instancing->type == TG3_VALUE_OBJECT && i < p_instancing->object_count; ++i)
+    {
+        if (tg3_str_equals_cstr(p_instancing->object_data[i].key, "attributes"))
+        {
+            p_attributes = &p_instancing->object_data[i].value;
+        }
+    }
+    if (!p_attributes || p_attributes->type != TG3_VALUE_OBJECT) return std::nullopt;
+
+    // the attributes are optional, but all of the present ones must define the same number of instances
+    std::vector<glm::vec4> translations, rotations, scales;
+    uint64_t instance_count{ 0 };
+    for (uint32_t i = 0; i < p_attributes->object_count; ++i)
+    {
+        tg3_kv_pair const& attribute = p_attributes->object_data[i];
+        if (attribute.value.type != TG3_VALUE_INT) return std::nullopt;
+        int const accessor_id = static_cast<int>(attribute.value.int_val);
+
+        std::vector<glm::vec4>* p_values = nullptr;
+        int expected_type{};
+        if (tg3_str_equals_cstr(attribute.key, "TRANSLATION")) { p_values = &translations; expected_type = TG3_TYPE_VEC3; }
+        else if (tg3_str_equals_cstr(attribute.key, "ROTATION")) { p_values = &rotations; expected_type = TG3_TYPE_VEC4; }
+        else if (tg3_str_equals_cstr(attribute.key, "SCALE")) { p_values = &scales; expected_type = TG3_TYPE_VEC3; }
+        else continue;    // custom per-instance attributes are not supported
+
+        if (!readInstanceAttribute(model, accessor_id, expected_type, *p_values)) return std::nullopt;
+        if (instance_count && p_values->size() != instance_count) return std::nullopt;
+        instance_count = p_values->size();
+    }
+
+    std::vector<core::math::Matrix4f> rv(instance_count);
+    for (uint64_t i = 0; i < instance_count; ++i)
+    {
+        glm::vec3 const translation = translations.empty() ? glm::vec3{ 0.f } : glm::vec3{ translations[i] };
+        glm::quat const rotation = rotations.empty() ? glm::quat{ 1.f, 0.f, 0.f, 0.f } : glm::quat{ rotations[i].w, rotations[i].x, rotations[i].y, rotations[i].z };
+        glm::vec3 const scale = scales.empty() ? glm::vec3{ 1.f } : glm::vec3{ scales[i] };
+        rv[i] = glm::translate(core::math::Matrix4f{ 1.f }, translation) * glm::mat4_cast(glm::normalize(rotation)) * glm::scale(core::math::Matrix4f{ 1.f }, scale);
+    }
+
+    return rv;
+}
+
+//! File system callbacks of the glTF parser reading the external files of the source
+struct GltfFileReader
+{
+    static int32_t readFile(uint8_t** out_data, uint64_t* out_size, char const* path, uint32_t path_len, void* user_data)
+    {
+        std::filesystem::path const file_path = std::filesystem::path{ std::string{ path, path_len } }.lexically_normal();
+
+        std::error_code error_code{};
+        uint64_t const size = std::filesystem::file_size(file_path, error_code);
+        if (error_code) return 0;
+
+        // the parser copies the data out of the returned memory, so even empty files must return a valid pointer
+        std::unique_ptr<uint8_t[]> data{ new uint8_t[(std::max)(size, uint64_t{ 1 })] };
+        if (size)
+        {
+            std::ifstream file{ file_path, std::ios::in | std::ios::binary };
+            if (!file.read(reinterpret_cast<char*>(data.get()), static_cast<std::streamsize>(size))) return 0;
+        }
+
+        *out_data = data.release();
+        *out_size = size;
+        return 1;
+    }
+
+    static void freeFile(uint8_t* data, uint64_t size, void* user_data)
+    {
+        delete[] data;
+    }
+};
+
+//! Returns the binary chunk of the given GLB file or an empty span if the file has no binary chunk
+std::span<uint8_t const> glbBinaryChunk(std::span<uint8_t const> glb_data)
+{
+    constexpr uint32_t c_glb_magic = 0x46546C67;    // "glTF"
+    constexpr uint32_t c_json_chunk_type = 0x4E4F534A;    // "JSON"
+    constexpr uint32_t c_binary_chunk_type = 0x004E4942;    // "BIN\0"
+    constexpr size_t c_header_size = 12;
+    constexpr size_t c_chunk_header_size = 8;
+
+    auto read_uint32 = [&glb_data](size_t offset)
+        {
+            uint32_t rv{};
+            std::memcpy(&rv, glb_data.data() + offset, sizeof(rv));
+            return rv;
+        };
+
+    if (glb_data.size() < c_header_size + c_chunk_header_size
+        || read_uint32(0) != c_glb_magic
+        || read_uint32(c_header_size + 4) != c_json_chunk_type) return {};
+
+    // the binary chunk immediately follows the JSON chunk, which length already includes the padding
+    size_t const json_chunk_length = read_uint32(c_header_size);
+    if (json_chunk_length > glb_data.size() - c_header_size - 2 * c_chunk_header_size) return {};
+    size_t const binary_chunk_offset = c_header_size + c_chunk_header_size + json_chunk_length;
+    size_t const binary_chunk_length = read_uint32(binary_chunk_offset);
+    if (read_uint32(binary_chunk_offset + 4) != c_binary_chunk_type
+        || binary_chunk_length > glb_data.size() - binary_chunk_offset - c_chunk_header_size) return {};
+
+    return glb_data.subspan(binary_chunk_offset + c_chunk_header_size, binary_chunk_length);
+}
+
+//! Returns selector distinguishing baked scenes of the scenes stored in the same source
+std::string bakedSceneSelector(unsigned scene_id)
+{
+    return "index:" + std::to_string(scene_id);
+}
+
+std::string bakedSceneSelector(std::string const& scene_name)
+{
+    return "name:" + scene_name;
+}
+
+uint32_t bakedSceneProcessingOptions(core::GlobalSettings const& global_settings)
+{
+    return (global_settings.isMeshOptimizationOnImportEnabled() ? 1U : 0U)
+        | (global_settings.isVertexQuantizationOnImportEnabled() ? 2U : 0U)
+        | (global_settings.isMeshletGenerationOnImportEnabled() ? 4U : 0U);
+}
+
 std::pair<std::string, unsigned> extractNameAndIndexFromAttributeName(std::string const& attribute_name)
 {
     int name_length = attribute_name.find_last_not_of("0123456789") + 1;
@@ -172,7 +399,7 @@ std::shared_ptr<Scene> Scene::loadScene(
     unsigned scene_id
 )
 {
-    auto rv = std::shared_ptr<Scene>{ new Scene(globals, basic_rendering_services, path_to_scene, scene_id) };
+    auto rv = std::shared_ptr<Scene>{ new Scene(globals, &basic_rendering_services, path_to_scene, scene_id) };
     return rv;
 }
 
@@ -183,51 +410,84 @@ std::shared_ptr<Scene> Scene::loadScene(
     std::string const& scene_name
 )
 {
-    auto rv = std::shared_ptr<Scene>{ new Scene(globals, basic_rendering_services, path_to_scene, scene_name) };
+    auto rv = std::shared_ptr<Scene>{ new Scene(globals, &basic_rendering_services, path_to_scene, scene_name) };
     return rv;
 }
 
+std::optional<SceneImportTimings> Scene::importCpuStages(core::Globals& globals, std::filesystem::path const& path_to_scene, unsigned scene_id)
+{
+    Scene scene{ globals, nullptr, path_to_scene, scene_id };
+    if (!scene.m_scene_source_parse_status) return std::nullopt;
+    return scene.m_import_timings;
+}
+
+void Scene::discardBakedScene(core::GlobalSettings const& global_settings, std::filesystem::path const& path_to_scene, unsigned scene_id)
+{
+    std::optional<BakedSceneKey> const key = makeBakedSceneKey(path_to_scene, bakedSceneSelector(scene_id), bakedSceneProcessingOptions(global_settings));
+    if (!key) return;
+
+    std::error_code error_code{};
+    std::filesystem::remove(global_settings.getCacheDirectory() / bakedSceneFileName(*key), error_code);
+}
+
 Scene::Scene(
     core::Globals& globals,
-    core::dx::d3d12::BasicRenderingServices& basic_rendering_services,
+    core::dx::d3d12::BasicRenderingServices* basic_rendering_services_ptr,
     std::filesystem::path const& path_to_scene, 
     unsigned scene_id
 )
     : m_globals{ globals }
-    , m_basic_rendering_services{ basic_rendering_services }
+    , m_basic_rendering_services_ptr{ basic_rendering_services_ptr }
     , m_global_settings{ *globals.get<core::GlobalSettings>() }
     , m_timestamp{ fetchTimestamp(path_to_scene) }
     , m_scene_path{ path_to_scene }
     , m_scene_index{ static_cast<int>(scene_id) }
+    , m_transform_hierarchy{ globals.get<core::concurrency::AssetScheduler>() }
 {
-    auto gltf_model_opt = readGltfModel(path_to_scene);
-    if (!gltf_model_opt)
+    auto const parse_start_time = std::chrono::steady_clock::now();
+    SourceModel source_model{};
+    if (!openSceneSource(bakedSceneSelector(scene_id), source_model))
+    {
+        return;
+    }
+    m_import_timings.parse = elapsedSince(parse_start_time);
+
+    tg3_model const& gltf_model = *source_model.get();
+    if (scene_id >= gltf_model.scenes_count)
     {
+        LEXGINE_LOG_ERROR(this, std::format("Unable to load gltf file '{}': scene with index {} not found", path_to_scene.string(), scene_id));
         return;
     }
-    tg3_model const& gltf_model = *gltf_model_opt->get();
     setStringName(std::string(gltf_model.scenes[scene_id].name.data, gltf_model.scenes[scene_id].name.len));
     m_scene_source_parse_status = readScene(gltf_model, scene_id);
+
+    // the restored model and the baked primitives refer to the mapped baked scene, which is no longer needed after the import
+    m_baked_scene.reset();
+    m_baked_scene_image.reset();
 }
 
 Scene::Scene(
     core::Globals& globals, 
-    core::dx::d3d12::BasicRenderingServices& basic_rendering_services,
+    core::dx::d3d12::BasicRenderingServices* basic_rendering_services_ptr,
     std::filesystem::path const& path_to_scene, 
     std::string const& scene_name
 )
     : m_globals{ globals }
+    , m_basic_rendering_services_ptr{ basic_rendering_services_ptr }
     , m_global_settings { *globals.get<core::GlobalSettings>() }
-    , m_basic_rendering_services{ basic_rendering_services }
     , m_timestamp{ fetchTimestamp(path_to_scene) }
     , m_scene_path{ path_to_scene }
+    , m_transform_hierarchy{ globals.get<core::concurrency::AssetScheduler>() }
 {
-    auto gltf_model_opt = readGltfModel(path_to_scene);
-    if (!gltf_model_opt)
+    auto const parse_start_time = std::chrono::steady_clock::now();
+    SourceModel source_model{};
+    if (!openSceneSource(bakedSceneSelector(scene_name), source_model))
     {
         return;
     }
-    tg3_model const& gltf_model = *gltf_model_opt->get();
+    m_import_timings.parse = elapsedSince(parse_start_time);
+
+    tg3_model const& gltf_model = *source_model.get();
 
     m_scene_index = getSceneIndexFromName(gltf_model, scene_name);
     setStringName(scene_name);
@@ -240,23 +500,61 @@ Scene::Scene(
     }
 
     m_scene_source_parse_status = readScene(gltf_model, m_scene_index);
+
+    m_baked_scene.reset();
+    m_baked_scene_image.reset();
+}
+
+Scene::~Scene()
+{
+    // the material assembly tasks are owned by the scene, so they must not outlive it in the scheduler queues
+    if (m_material_construction_job)
+    {
+        m_material_construction_job->cancel();
+        m_material_construction_job->wait();
+    }
 }
 
 bool Scene::loadStatus() const
 {
     if (!m_scene_source_parse_status) return false;
     conversion::TextureConverter& texture_converter = *m_globals.get<conversion::TextureConverter>();
-    return !m_material_construction_task_sink->isRunning()
+    return m_material_construction_job && m_material_construction_job->isFinished() && !m_material_construction_job->hasFailed()
         && texture_converter.isTextureConversionCompleted()
         && texture_converter.isTextureUploadCompleted();
 }
 
-[[nodiscard]]
-std::optional<tinygltf3::Model> Scene::readGltfModel(std::filesystem::path const& path)
+void Scene::updateTextureResidency()
+{
+    // the materials are bound to the shaders of their assembly, which must not be touched before the assembly has finished
+    if (!m_material_construction_job || !m_material_construction_job->isFinished() || m_material_construction_job->hasFailed()) return;
+
+    for (size_t i = 0; i < m_materials.size(); ++i)
+    {
+        m_materials[i].updateTextureResidency(m_material_texture_priorities[i]);
+    }
+}
+
+bool Scene::waitForLoadCompletion()
+{
+    if (!m_scene_source_parse_status || !m_material_construction_job) return false;
+
+    m_material_construction_job->wait();
+    m_globals.get<conversion::TextureConverter>()->waitForTextureUploadCompletion();
+
+    // the assembly of the materials has been scheduled at the end of their construction stage and has run in background since then
+    m_import_timings.material_construction = (std::max)(m_import_timings.material_construction,
+        std::chrono::duration_cast<std::chrono::microseconds>(m_material_construction_job->finishTime() - m_material_construction_start_time));
+    m_import_timings.total = m_import_timings.parse + m_import_timings.mesh_processing + m_import_timings.scene_memory_upload + m_import_timings.mesh_decode
+        + m_import_timings.texture_wait + m_import_timings.material_construction;
+
+    return loadStatus();
+}
+
+bool Scene::openSceneSource(std::string_view scene_selector, SourceModel& source_model)
 {
-    std::string gltf_path_to_file = path.string();
     {
-        std::string extension = path.extension().string();
+        std::string extension = m_scene_path.extension().string();
         std::vector<char> buf(extension.size());
         std::transform(extension.begin(), extension.end(), buf.begin(), [](char c) { return static_cast<char>(std::tolower(c)); });
         extension = std::string{ buf.begin(), buf.end() };
@@ -264,26 +562,143 @@ std::optional<tinygltf3::Model> Scene::readGltfModel(std::filesystem::path const
         {
             m_scene_source = SceneSource::gltf;
         }
-        else if (extension == ".bin")
+        else if (extension == ".glb" || extension == ".bin")
         {
             m_scene_source = SceneSource::glb;
         }
         else
         {
-            LEXGINE_LOG_ERROR(this, std::format("Unable to load scene '{}': scene file has unsupported format extension '{}'", gltf_path_to_file, extension));
-            return std::nullopt;
+            LEXGINE_LOG_ERROR(this, std::format("Unable to load scene '{}': scene file has unsupported format extension '{}'", m_scene_path.string(), extension));
+            return false;
+        }
+    }
+
+    source_model.baked_model = findBakedScene(scene_selector, source_model.buffer_files);
+    if (source_model.baked_model) return true;
+
+    source_model.parsed_model = readGltfModel(m_scene_path);
+    return source_model.parsed_model.has_value();
+}
+
+std::unique_ptr<BakedGltfModel> Scene::findBakedScene(std::string_view scene_selector, std::vector<std::unique_ptr<core::misc::MappedFile>>& buffer_files)
+{
+    // the baked scene is keyed on the contents of the source, so that it is neither reused for a modified source nor rebuilt when the source is only touched or moved
+    uint32_t const processing_options = bakedSceneProcessingOptions(m_global_settings);
+    if (!processing_options || !m_global_settings.isCacheEnabled()) return nullptr;
+    m_baked_scene_key = makeBakedSceneKey(m_scene_path, scene_selector, processing_options);
+    if (!m_baked_scene_key) return nullptr;
+
+    std::filesystem::path const baked_scene_path = m_global_settings.getCacheDirectory() / bakedSceneFileName(*m_baked_scene_key);
+    if (!(m_baked_scene_image = core::misc::MappedFile::open(baked_scene_path))) return nullptr;
+    m_baked_scene = readBakedScene(m_baked_scene_image->data(), *m_baked_scene_key);
+
+    // external files are not covered by the key of the baked scene, so their contents are compared separately. The files providing
+    // the buffers of the restored model are kept mapped, so that they are only read once
+    bool is_valid{ m_baked_scene.has_value() };
+    std::vector<core::misc::MappedFile const*> dependency_files(is_valid ? m_baked_scene->dependencies.size() : 0U, nullptr);
+    for (size_t i = 0; is_valid && i < dependency_files.size(); ++i)
+    {
+        BakedSceneDependency const& dependency = m_baked_scene->dependencies[i];
+        std::filesystem::path const dependency_path = (m_scene_path.parent_path() / dependency.uri).lexically_normal();
+        if (dependency.is_needed_on_load)
+        {
+            std::unique_ptr<core::misc::MappedFile> file = core::misc::MappedFile::open(dependency_path);
+            is_valid = file && core::misc::Sha256::hash(file->data()) == dependency.content_hash;
+            dependency_files[i] = file.get();
+            buffer_files.push_back(std::move(file));
+        }
+        else
+        {
+            core::misc::Optional<core::misc::Sha256::Digest> const content_hash = core::misc::Sha256::hashFile(dependency_path);
+            is_valid = content_hash.isValid() && *content_hash == dependency.content_hash;
         }
     }
 
+    std::span<uint8_t const> binary_chunk{};
+    for (uint32_t bi = 0; is_valid && bi < m_baked_scene->buffers.size(); ++bi)
+    {
+        BakedBuffer const& buffer = m_baked_scene->buffers[bi];
+        std::span<uint8_t const> data{};
+        switch (buffer.source)
+        {
+        case BakedBufferSource::dependency:
+            is_valid = dependency_files[buffer.dependency_index] != nullptr;
+            if (is_valid) data = dependency_files[buffer.dependency_index]->data();
+            break;
+
+        case BakedBufferSource::binary_chunk:
+            if (binary_chunk.empty())
+            {
+                std::unique_ptr<core::misc::MappedFile> glb_file = core::misc::MappedFile::open(m_scene_path);
+                if (glb_file) binary_chunk = glbBinaryChunk(glb_file->data());
+                buffer_files.push_back(std::move(glb_file));
+            }
+            is_valid = !binary_chunk.empty();
+            data = binary_chunk;
+            break;
+
+        case BakedBufferSource::baked:
+            data = buffer.data;
+            break;
+
+        default:
+            break;
+        }
+        if (is_valid) m_baked_scene->model->setBufferData(bi, data);
+    }
+
+    if (!is_valid)
+    {
+        // the mapping must be released before the baked scene gets rebuilt
+        logger().out("baked scene '" + baked_scene_path.string() + "' is outdated or corrupted and will be rebuilt", core::misc::LogMessageType::exclamation);
+        m_baked_scene.reset();
+        m_baked_scene_image.reset();
+        buffer_files.clear();
+        return nullptr;
+    }
+
+    return std::move(m_baked_scene->model);
+}
+
+[[nodiscard]]
+std::optional<tinygltf3::Model> Scene::readGltfModel(std::filesystem::path const& path)
+{
+    std::string gltf_path_to_file = path.string();
+
     tinygltf3::Model gltf_model;
     tinygltf3::ErrorStack errors;
     tg3_parse_options options;
     tg3_parse_options_init(&options);
 
-    tg3_error_code result = tg3_parse_file(
-        gltf_model.get(), errors.get(),
-        gltf_path_to_file.c_str(), static_cast<uint32_t>(gltf_path_to_file.size()),
-        &options);
+    // the external files are also read through the reader when the source is binary, since the parser is given the GLB data from memory
+    options.fs.read_file = &GltfFileReader::readFile;
+    options.fs.free_file = &GltfFileReader::freeFile;
+
+    tg3_error_code result{};
+    if (m_scene_source == SceneSource::glb)
+    {
+        // the parser copies the embedded binary chunk out of the GLB data, so the file only has to stay mapped while it is parsed
+        std::unique_ptr<core::misc::MappedFile> glb_file = core::misc::MappedFile::open(path);
+        if (!glb_file)
+        {
+            LEXGINE_LOG_ERROR(this, std::format("Unable to load scene '{}': the file cannot be read", gltf_path_to_file));
+            return std::nullopt;
+        }
+
+        std::string const base_directory = path.parent_path().string();
+        result = tg3_parse_glb(
+            gltf_model.get(), errors.get(),
+            glb_file->data().data(), glb_file->data().size(),
+            base_directory.c_str(), static_cast<uint32_t>(base_directory.size()),
+            &options);
+    }
+    else
+    {
+        result = tg3_parse_file(
+            gltf_model.get(), errors.get(),
+            gltf_path_to_file.c_str(), static_cast<uint32_t>(gltf_path_to_file.size()),
+            &options);
+    }
 
     for (uint32_t i = 0; i < errors.count(); ++i)
     {
@@ -307,6 +722,7 @@ std::optional<tinygltf3::Model> Scene::readGltfModel(std::filesystem::path const
 bool Scene::readScene(tg3_model const& model, unsigned scene_index)
 {
     std::string gltf_path_to_file = m_scene_path.string();
+    auto stage_start_time = std::chrono::steady_clock::now();
 
     // Check used extensions
     for (uint32_t ei = 0; ei < model.extensions_used_count; ++ei)
@@ -343,9 +759,9 @@ bool Scene::readScene(tg3_model const& model, unsigned scene_index)
     std::unordered_map<int, int> scene_mesh_ids;
     std::unordered_map<int, int> scene_camera_ids;
     std::unordered_map<int, int> scene_animation_ids;
-    std::unordered_map<int, int> scene_buffer_ids;
     std::unordered_map<int, int> scene_texture_ids;
     std::unordered_map<int, int> scene_sampler_ids;
+    std::vector<int> node_mesh_ids;    // glTF mesh attached to each node of the scene
     {
         tg3_scene const& scene = model.scenes[scene_index];
 
@@ -353,9 +769,21 @@ bool Scene::readScene(tg3_model const& model, unsigned scene_index)
         {
             int node_id = scene.nodes[ni];
             tg3_node const& node = model.nodes[node_id];
-            m_scene_nodes.emplace_back();
+            m_scene_nodes.emplace_back(m_transform_hierarchy);
             m_scene_nodes.back().setStringName(std::string(node.name.data, node.name.len));
 
+            if (node.mesh >= 0 && m_enabled_extensions[c_ext_mesh_gpu_instancing])
+            {
+                std::optional<std::vector<core::math::Matrix4f>> instance_transforms = readInstanceTransforms(model, node, c_ext_mesh_gpu_instancing);
+                if (!instance_transforms)
+                {
+                    LEXGINE_LOG_ERROR(this, std::string{ c_ext_mesh_gpu_instancing } + ": node " + std::to_string(node_id) + " has invalid instance attributes");
+                    return false;
+                }
+                m_scene_nodes.back().setInstanceTransforms(std::move(*instance_transforms));
+            }
+            node_mesh_ids.push_back(node.mesh);
+
             if (node.light >= 0)
             {
                 scene_light_ids.insert({ node.light, -1 });
@@ -370,27 +798,6 @@ bool Scene::readScene(tg3_model const& model, unsigned scene_index)
                 {
                     tg3_primitive const& p = mesh.primitives[pi];
 
-                    if (p.indices >= 0)
-                    {
-                        // primitive has index buffer
-                        tg3_accessor const& accessor = model.accessors[p.indices];
-                        if (accessor.buffer_view >= 0)
-                        {
-                            tg3_buffer_view const& buffer_view = model.buffer_views[accessor.buffer_view];
-                            scene_buffer_ids.insert({ buffer_view.buffer, -1 });
-                        }
-                    }
-
-                    for (uint32_t ai = 0; ai < p.attributes_count; ++ai)
-                    {
-                        tg3_accessor const& accessor = model.accessors[p.attributes[ai].value];
-                        if (accessor.buffer_view >= 0)
-                        {
-                            tg3_buffer_view const& buffer_view = model.buffer_views[accessor.buffer_view];
-                            scene_buffer_ids.insert({ buffer_view.buffer, -1 });
-                        }
-                    }
-
                     if (p.material >= 0)
                     {
                         scene_material_ids.insert({ p.material, -1 });
@@ -449,38 +856,119 @@ bool Scene::readScene(tg3_model const& model, unsigned scene_index)
     }
 
 
+    m_import_timings.parse += elapsedSince(stage_start_time);
+
+
+    // Rewrite mesh primitives if requested
+    stage_start_time = std::chrono::steady_clock::now();
+    ProcessedPrimitiveMap processed_primitives{};
+    if (m_baked_scene)
+    {
+        loadBakedScene(processed_primitives);
+    }
+    else if (bakedSceneProcessingOptions(m_global_settings))
+    {
+        // the primitives are only rewritten when the source is imported for the first time with the current options
+        processMeshPrimitives(model, scene_mesh_ids, processed_primitives);
+        if (m_baked_scene_key) saveBakedScene(model, processed_primitives);
+    }
+    m_import_timings.mesh_processing += elapsedSince(stage_start_time);
+
+
     // Prepare scene memory
+    stage_start_time = std::chrono::steady_clock::now();
     {
-        uint64_t scene_memory_size = std::accumulate(scene_buffer_ids.cbegin(), scene_buffer_ids.cend(), 0ui64,
-            [&model](uint64_t acc, std::pair<int, int> const& e) {
-                return acc + model.buffers[e.first].data.count;
-            });
+        // only the parts of the buffers referenced by the mesh primitives, which have not been rewritten, are uploaded
+        std::set<int> scene_buffer_view_ids{};
+        for (auto const& [mesh_id, mesh_id_in_scene] : scene_mesh_ids)
+        {
+            tg3_mesh const& mesh = model.meshes[mesh_id];
+            for (uint32_t pi = 0; pi < mesh.primitives_count; ++pi)
+            {
+                if (processed_primitives.contains({ mesh_id, pi })) continue;
 
-        m_scene_memory.scene_memory_buffer.reset(new SceneMeshMemory{ m_globals, scene_memory_size });
+                tg3_primitive const& p = mesh.primitives[pi];
+                if (p.indices >= 0 && model.accessors[p.indices].buffer_view >= 0)
+                {
+                    scene_buffer_view_ids.insert(model.accessors[p.indices].buffer_view);
+                }
 
-        for (auto& [buffer_id, buffer_id_in_scene] : scene_buffer_ids)
+                for (uint32_t ai = 0; ai < p.attributes_count; ++ai)
+                {
+                    tg3_accessor const& accessor = model.accessors[p.attributes[ai].value];
+                    if (accessor.buffer_view >= 0)
+                    {
+                        scene_buffer_view_ids.insert(accessor.buffer_view);
+                    }
+                }
+            }
+        }
+
+        SceneMemoryUploadPlan& upload_plan = m_scene_memory.upload_plan;
+        for (int buffer_view_id : scene_buffer_view_ids)
         {
-            buffer_id_in_scene = m_scene_memory.m_scene_memory_handles.size();
-            tg3_buffer const& buffer = model.buffers[buffer_id];
-            m_scene_memory.m_scene_memory_handles.push_back(
-                m_scene_memory.scene_memory_buffer->addData(
-                    buffer.data.data,
-                    buffer.data.count
-                )
+            tg3_buffer_view const& buffer_view = model.buffer_views[buffer_view_id];
+            upload_plan.addReferencedRange(
+                static_cast<uint32_t>(buffer_view.buffer),
+                buffer_view.byte_offset,
+                buffer_view.byte_length,
+                model.buffers[buffer_view.buffer].data.count
             );
         }
+
+        // the data of the processed primitives is planned as if it was stored in additional buffers following the buffers of the model
+        std::vector<std::span<uint8_t const>> processed_data{};
+        auto add_processed_data = [&model, &upload_plan, &processed_data](std::span<uint8_t const> data)
+            {
+                uint32_t const buffer_id = model.buffers_count + static_cast<uint32_t>(processed_data.size());
+                processed_data.push_back(data);
+                upload_plan.addReferencedRange(buffer_id, 0, data.size(), data.size());
+                return buffer_id;
+            };
+        for (auto& [key, primitive] : processed_primitives)
+        {
+            primitive.vertex_buffer_id = add_processed_data(primitive.vertex_view);
+            primitive.index_buffer_id = add_processed_data(primitive.index_view);
+            if (primitive.meshlets)
+            {
+                primitive.meshlet_buffer_id = add_processed_data(primitive.packed_meshlet_view);
+            }
+        }
+        upload_plan.build();
+
+        if (!m_basic_rendering_services_ptr)
+        {
+            // only the stages, which do not need a GPU, are run
+            m_import_timings.scene_memory_upload = elapsedSince(stage_start_time);
+            m_import_timings.total = m_import_timings.parse + m_import_timings.mesh_processing + m_import_timings.scene_memory_upload;
+            return true;
+        }
+
+        m_scene_memory.scene_memory_buffer.reset(new SceneMeshMemory{ m_globals, upload_plan.totalSize() });
+
+        for (SceneMemoryUploadPlan::Range const& range : upload_plan.ranges())
+        {
+            uint8_t const* p_source_data = range.buffer < model.buffers_count
+                ? model.buffers[range.buffer].data.data
+                : processed_data[range.buffer - model.buffers_count].data();
+
+            [[maybe_unused]] SceneMemoryBufferHandle handle = m_scene_memory.scene_memory_buffer->addData(
+                p_source_data + range.source_offset,
+                range.size,
+                upload_plan.alignment()
+            );
+            assert(handle.offset == range.destination_offset);
+        }
         m_scene_memory.scene_memory_buffer->uploadAllData();    // Upload all remaining scheduled data as soon as possible (some data may have already been uploaded depending on the size of the scene and the size of staging buffer)
     }
+    m_import_timings.scene_memory_upload = elapsedSince(stage_start_time);
 
+    /* The rest of the import is pipelined: the images start decoding on the asset scheduler right away, while the meshes,
+     lights and cameras are decoded in parallel by a job of higher priority on the same scheduler. Materials depend on
+     both the decoded meshes (vertex layouts) and the uploaded textures and are constructed last
+    */
     bool load_result = true;
-    if (!loadLights(
-        model, 
-        scene_light_ids
-    ))
-    {
-        LEXGINE_LOG_ERROR(this, "Unable to load lights when reading scene source \"" + m_scene_path.string() + "\"");
-        load_result = false;
-    }
+    stage_start_time = std::chrono::steady_clock::now();
     if (!loadTextures(
         model, 
         scene_texture_ids, 
@@ -490,17 +978,49 @@ bool Scene::readScene(tg3_model const& model, unsigned scene_index)
         LEXGINE_LOG_ERROR(this, "Unable to load textures when reading scene source \"" + m_scene_path.string() + "\"");
         load_result = false;
     }
-    if (!loadMeshes(
+
+    std::vector<std::vector<ImportedPrimitive>> imported_primitives{};
+    if (!importSceneObjects(
         model,
         scene_mesh_ids,
-        scene_buffer_ids
+        processed_primitives,
+        scene_light_ids,
+        scene_camera_ids,
+        imported_primitives
     ))
     {
-        LEXGINE_LOG_ERROR(this, "Unable to load meshes when reading scene source \"" + m_scene_path.string() + "\"");
+        LEXGINE_LOG_ERROR(this, "Unable to import meshes, lights or cameras when reading scene source \"" + m_scene_path.string() + "\"");
         load_result = false;
     }
+    for (size_t i = 0; i < node_mesh_ids.size(); ++i)
+    {
+        if (node_mesh_ids[i] >= 0) m_scene_nodes[i].setMesh(&m_scene_meshes[scene_mesh_ids[node_mesh_ids[i]]]);
+    }
+    m_import_timings.mesh_decode = elapsedSince(stage_start_time);
+
+    stage_start_time = std::chrono::steady_clock::now();
+    {
+        conversion::TextureConverter& texture_converter = *m_globals.get<conversion::TextureConverter>();
+        texture_converter.uploadTextures();    // waits for the image decoding to complete
+        texture_converter.waitForTextureUploadCompletion();
+    }
+    m_import_timings.texture_wait = elapsedSince(stage_start_time);
 
+    stage_start_time = std::chrono::steady_clock::now();
+    m_material_construction_start_time = stage_start_time;
+    if (!loadMaterials(model, scene_texture_ids, imported_primitives))
+    {
+        LEXGINE_LOG_ERROR(this, "Unable to load materials when reading scene source \"" + m_scene_path.string() + "\"");
+        load_result = false;
+    }
     scheduleMaterialConstruction();
+    m_import_timings.material_construction = elapsedSince(stage_start_time);
+
+    m_import_timings.total = m_import_timings.parse + m_import_timings.mesh_processing + m_import_timings.scene_memory_upload + m_import_timings.mesh_decode
+        + m_import_timings.texture_wait + m_import_timings.material_construction;
+    logger().out(std::format("Scene '{}' imported in {}: parse {}, mesh processing {}, scene memory upload {}, mesh decode {}, texture wait {}, material construction {}",
+        gltf_path_to_file, m_import_timings.total, m_import_timings.parse, m_import_timings.mesh_processing, m_import_timings.scene_memory_upload, m_import_timings.mesh_decode,
+        m_import_timings.texture_wait, m_import_timings.material_construction), core::misc::LogMessageType::information);
 
     return load_result;
 }
@@ -646,174 +1166,662 @@ bool Scene::loadTextures(
         }
         m_textures.back().p_texture_conversion_task = texture_converter.addTextureConversionTask(m_textures.back().image, false);
     }
-    texture_converter.convertTextures();
-    texture_converter.uploadTextures();
-    texture_converter.waitForTextureUploadCompletion();
+    texture_converter.convertTextures();    // returns immediately, the images are decoded and converted in parallel with the rest of the import
     return true;
 }
 
-bool Scene::loadMeshes(
+void Scene::processMeshPrimitives(
     tg3_model const& model,
-    std::unordered_map<int, int>& mesh_ids,
-    std::unordered_map<int, int> const& buffer_ids
-)
+    std::unordered_map<int, int> const& mesh_ids,
+    ProcessedPrimitiveMap& processed_primitives
+) const
 {
-    core::dx::d3d12::DxgiFormatFetcher const& dxgi_format_fetcher = m_globals.get<core::dx::d3d12::DxResourceFactory>()->dxgiFormatFetcher();
+    std::vector<std::pair<int, uint32_t>> primitive_keys{};
+    for (auto const& [mesh_id, mesh_id_in_scene] : mesh_ids)
+    {
+        for (uint32_t pi = 0; pi < model.meshes[mesh_id].primitives_count; ++pi)
+        {
+            primitive_keys.emplace_back(mesh_id, pi);
+        }
+    }
 
-    // Parse meshes
-    for (auto& [mesh_id, mesh_id_in_scene] : mesh_ids)
+    // primitives are independent from each other, so they are extracted and optimized in parallel by the asset scheduler
+    std::vector<ProcessedPrimitive> primitives(primitive_keys.size());
+    bool const optimize_meshes = m_global_settings.isMeshOptimizationOnImportEnabled();
+    bool const quantize_vertices = m_global_settings.isVertexQuantizationOnImportEnabled();
+    bool const build_meshlets = m_global_settings.isMeshletGenerationOnImportEnabled();
+    std::vector<std::unique_ptr<SceneImportTask>> primitive_tasks{};
+    primitive_tasks.reserve(primitive_keys.size());
+    for (size_t i = 0; i < primitive_keys.size(); ++i)
     {
-        tg3_mesh const& mesh = model.meshes[mesh_id];
+        auto const [mesh_id, pi] = primitive_keys[i];
+        primitive_tasks.push_back(std::make_unique<SceneImportTask>("ProcessPrimitive" + std::to_string(mesh_id) + "_" + std::to_string(pi),
+            [&model, &primitive = primitives[i], mesh_id = mesh_id, pi = pi, optimize_meshes, quantize_vertices, build_meshlets]()
+            {
+                if (!extractPrimitive(model, model.meshes[mesh_id].primitives[pi], primitive)) return false;
 
-        // Parse mesh primitives
-        std::vector<double> morph_weights(mesh.weights, mesh.weights + mesh.weights_count);
+                if (optimize_meshes)
+                {
+                    optimizeMesh(primitive.mesh);
+                }
 
-        m_scene_meshes.emplace_back(Mesh{ std::string(mesh.name.data, mesh.name.len) });
-        m_scene_meshes.back().applyMorphWeights(morph_weights);
+                if (build_meshlets)
+                {
+                    auto meshlets = std::make_shared<MeshletData>(buildMeshlets(primitive.mesh));
+                    primitive.packed_meshlets = packMeshlets(*meshlets, primitive.packed_meshlet_layout);
+                    primitive.meshlets = std::move(meshlets);
+                }
+
+                // quantization goes last, since the optimizations and meshlet bounds rely on the positions being stored as floats
+                if (quantize_vertices)
+                {
+                    primitive.position_dequantization = quantizeVertexAttributes(primitive.mesh, primitive.attributes);
+                }
 
-        for (uint32_t pi = 0; pi < mesh.primitives_count; ++pi)
+                // indices are encoded into 16 bits whenever the vertex count permits
+                if (primitive.mesh.vertexCount() <= 0xFFFF)
+                {
+                    primitive.index_type = IndexType::_short;
+                    primitive.index_data.resize(primitive.mesh.indices.size() * sizeof(uint16_t));
+                    uint16_t* p_indices = reinterpret_cast<uint16_t*>(primitive.index_data.data());
+                    for (size_t j = 0; j < primitive.mesh.indices.size(); ++j)
+                    {
+                        p_indices[j] = static_cast<uint16_t>(primitive.mesh.indices[j]);
+                    }
+                }
+                else
+                {
+                    primitive.index_type = IndexType::_default;
+                    primitive.index_data.resize(primitive.mesh.indices.size() * sizeof(uint32_t));
+                    std::memcpy(primitive.index_data.data(), primitive.mesh.indices.data(), primitive.index_data.size());
+                }
+                std::vector<uint32_t>{}.swap(primitive.mesh.indices);    // only the encoded indices are used from now on
+                return true;
+            }));
+    }
+
+    std::vector<core::concurrency::AbstractTask*> tasks{};
+    tasks.reserve(primitive_tasks.size());
+    for (std::unique_ptr<SceneImportTask>& e : primitive_tasks)
+    {
+        tasks.push_back(e.get());
+    }
+    m_globals.get<core::concurrency::AssetScheduler>()->submit(tasks, core::concurrency::AssetJobPriority::high)->wait();
+
+    for (size_t i = 0; i < primitive_keys.size(); ++i)
+    {
+        if (primitive_tasks[i]->result())
         {
-            tg3_primitive const& mesh_primitive = mesh.primitives[pi];
-            Submesh submesh{ *m_scene_memory.scene_memory_buffer };
-            VertexBufferView* vb_view = submesh.getVertexBufferView();
+            ProcessedPrimitive& primitive = processed_primitives.emplace(primitive_keys[i], std::move(primitives[i])).first->second;
+            primitive.vertex_view = primitive.mesh.vertices;
+            primitive.index_view = primitive.index_data;
+            primitive.packed_meshlet_view = primitive.packed_meshlets;
+        }
+    }
+}
 
-            if (mesh_primitive.indices >= 0)
-            {
-                SceneMemoryBufferHandle index_buffer{};
-                IndexType index_type{};
+void Scene::loadBakedScene(ProcessedPrimitiveMap& processed_primitives) const
+{
+    for (BakedPrimitive const& baked_primitive : m_baked_scene->primitives)
+    {
+        ProcessedPrimitive primitive{};
+        primitive.mesh.vertex_stride = baked_primitive.vertex_stride;
+        primitive.mesh.position_offset = baked_primitive.position_offset;
+        primitive.attributes = baked_primitive.attributes;
+        primitive.position_dequantization = baked_primitive.position_dequantization;
+        primitive.index_type = baked_primitive.index_size == sizeof(uint16_t) ? IndexType::_short : IndexType::_default;
+        primitive.vertex_view = baked_primitive.vertices;
+        primitive.index_view = baked_primitive.index_data;
+        if (!baked_primitive.meshlets.empty())
+        {
+            // the culling data of the meshlets are retained by the submeshes, which outlive the mapping of the baked scene
+            primitive.meshlets = std::make_shared<MeshletData const>(MeshletData{
+                .meshlets = { baked_primitive.meshlets.begin(), baked_primitive.meshlets.end() },
+                .bounds = { baked_primitive.meshlet_bounds.begin(), baked_primitive.meshlet_bounds.end() },
+                .vertex_indices = { baked_primitive.meshlet_vertex_indices.begin(), baked_primitive.meshlet_vertex_indices.end() },
+                .triangle_indices = { baked_primitive.meshlet_triangle_indices.begin(), baked_primitive.meshlet_triangle_indices.end() }
+                });
+            primitive.packed_meshlet_view = baked_primitive.packed_meshlets;
+            primitive.packed_meshlet_layout = baked_primitive.packed_meshlet_layout;
+        }
+        processed_primitives.emplace(std::make_pair(baked_primitive.mesh_id, baked_primitive.primitive_index), std::move(primitive));
+    }
+}
+
+void Scene::saveBakedScene(tg3_model const& model, ProcessedPrimitiveMap const& processed_primitives) const
+{
+    // an accessor is only replaced by the baked primitives if no other primitive reads it
+    enum AccessorUsage : uint8_t { unused = 0, used_by_processed_primitive = 1, used_by_other_primitive = 2 };
+    std::vector<uint8_t> accessor_usage(model.accessors_count, unused);
+    auto mark_accessor = [&accessor_usage](int accessor_id, AccessorUsage usage)
+        {
+            if (accessor_id >= 0 && static_cast<size_t>(accessor_id) < accessor_usage.size()) accessor_usage[accessor_id] |= usage;
+        };
+    for (uint32_t mi = 0; mi < model.meshes_count; ++mi)
+    {
+        for (uint32_t pi = 0; pi < model.meshes[mi].primitives_count; ++pi)
+        {
+            tg3_primitive const& primitive = model.meshes[mi].primitives[pi];
+            AccessorUsage const usage = processed_primitives.contains({ static_cast<int>(mi), pi }) ? used_by_processed_primitive : used_by_other_primitive;
+            mark_accessor(primitive.indices, usage);
+            for (uint32_t ai = 0; ai < primitive.attributes_count; ++ai) mark_accessor(primitive.attributes[ai].value, usage);
+        }
+    }
+
+    // buffers are needed on load if any of their data is consumed by something else than the baked primitives (including
+    // the accessors used by animations, skins or extensions and the images stored in buffers)
+    std::vector<bool> is_buffer_needed(model.buffers_count, false);
+    std::vector<bool> is_buffer_view_referenced(model.buffer_views_count, false);
+    auto mark_buffer_view = [&model, &is_buffer_needed, &is_buffer_view_referenced](int buffer_view_id, bool is_needed)
+        {
+            if (buffer_view_id < 0 || static_cast<uint32_t>(buffer_view_id) >= model.buffer_views_count) return;
+            is_buffer_view_referenced[buffer_view_id] = true;
+            int const buffer_id = model.buffer_views[buffer_view_id].buffer;
+            if (is_needed && buffer_id >= 0 && static_cast<uint32_t>(buffer_id) < model.buffers_count) is_buffer_needed[buffer_id] = true;
+        };
+    for (uint32_t ai = 0; ai < model.accessors_count; ++ai)
+    {
+        tg3_accessor const& accessor = model.accessors[ai];
+        bool const is_needed = accessor_usage[ai] != used_by_processed_primitive;
+        mark_buffer_view(accessor.buffer_view, is_needed);
+        if (accessor.sparse.is_sparse)
+        {
+            mark_buffer_view(accessor.sparse.indices.buffer_view, is_needed);
+            mark_buffer_view(accessor.sparse.values.buffer_view, is_needed);
+        }
+    }
+    for (uint32_t ii = 0; ii < model.images_count; ++ii)
+    {
+        mark_buffer_view(model.images[ii].buffer_view, true);
+    }
+    for (uint32_t bvi = 0; bvi < model.buffer_views_count; ++bvi)
+    {
+        if (!is_buffer_view_referenced[bvi]) mark_buffer_view(static_cast<int>(bvi), true);
+    }
 
-                tg3_accessor const& indices_accessor = model.accessors[mesh_primitive.indices];
-                assert(indices_accessor.type == TG3_TYPE_SCALAR);
+    // the restored model reads the buffers needed on load from where the parser would take them, except for the data URIs,
+    // which are decoded once and stored in the baked scene
+    std::vector<BakedSceneDependency> dependencies{};
+    std::vector<BakedBuffer> buffers(model.buffers_count, BakedBuffer{ .source = BakedBufferSource::none, .dependency_index = 0U });
+    for (uint32_t bi = 0; bi < model.buffers_count; ++bi)
+    {
+        tg3_buffer const& buffer = model.buffers[bi];
+        std::string_view const uri{ buffer.uri.data, buffer.uri.len };
+        if (uri.empty())
+        {
+            if (is_buffer_needed[bi]) buffers[bi].source = BakedBufferSource::binary_chunk;
+            continue;
+        }
+        if (tg3_is_data_uri(uri.data(), static_cast<uint32_t>(uri.size())))
+        {
+            if (is_buffer_needed[bi]) buffers[bi] = BakedBuffer{ .source = BakedBufferSource::baked, .dependency_index = 0U, .data = { buffer.data.data, buffer.data.count } };
+            continue;
+        }
 
-                tg3_buffer_view const& indices_buffer_view = model.buffer_views[indices_accessor.buffer_view];
-                assert(indices_buffer_view.target == TG3_TARGET_ELEMENT_ARRAY_BUFFER);
+        core::misc::Optional<core::misc::Sha256::Digest> const content_hash = core::misc::Sha256::hashFile(m_scene_path.parent_path() / uri);
+        if (!content_hash.isValid())
+        {
+            logger().out("unable to bake scene '" + m_scene_path.string() + "': buffer '" + std::string{ uri } + "' cannot be accessed", core::misc::LogMessageType::exclamation);
+            return;
+        }
+        if (is_buffer_needed[bi]) buffers[bi] = BakedBuffer{ .source = BakedBufferSource::dependency, .dependency_index = static_cast<uint32_t>(dependencies.size()) };
+        dependencies.push_back(BakedSceneDependency{ .uri = std::string{ uri }, .content_hash = *content_hash, .is_needed_on_load = is_buffer_needed[bi] });
+    }
 
-                switch (indices_accessor.component_type)
-                {
-                case TG3_COMPONENT_TYPE_INT:
-                case TG3_COMPONENT_TYPE_UNSIGNED_INT:
-                    index_type = IndexType::_default;
-                    break;
+    std::vector<BakedPrimitive> baked_primitives{};
+    baked_primitives.reserve(processed_primitives.size());
+    for (auto const& [primitive_key, primitive] : processed_primitives)
+    {
+        BakedPrimitive baked_primitive{
+            .mesh_id = primitive_key.first,
+            .primitive_index = primitive_key.second,
+            .vertex_stride = primitive.mesh.vertex_stride,
+            .position_offset = primitive.mesh.position_offset,
+            .index_size = primitive.index_type == IndexType::_short ? static_cast<uint32_t>(sizeof(uint16_t)) : static_cast<uint32_t>(sizeof(uint32_t)),
+            .vertices = primitive.vertex_view,
+            .index_data = primitive.index_view,
+            .attributes = primitive.attributes,
+            .position_dequantization = primitive.position_dequantization
+        };
+        if (primitive.meshlets)
+        {
+            baked_primitive.meshlets = primitive.meshlets->meshlets;
+            baked_primitive.meshlet_bounds = primitive.meshlets->bounds;
+            baked_primitive.meshlet_vertex_indices = primitive.meshlets->vertex_indices;
+            baked_primitive.meshlet_triangle_indices = primitive.meshlets->triangle_indices;
+            baked_primitive.packed_meshlets = primitive.packed_meshlet_view;
+            baked_primitive.packed_meshlet_layout = primitive.packed_meshlet_layout;
+        }
+        baked_primitives.push_back(std::move(baked_primitive));
+    }
 
-                case TG3_COMPONENT_TYPE_SHORT:
-                case TG3_COMPONENT_TYPE_UNSIGNED_SHORT:
-                    index_type = IndexType::_short;
-                    break;
+    std::vector<uint8_t> const baked_scene_data = writeBakedScene(*m_baked_scene_key, dependencies, buffers, model, baked_primitives);
+    std::filesystem::path const baked_scene_path = m_global_settings.getCacheDirectory() / bakedSceneFileName(*m_baked_scene_key);
+    std::error_code error_code{};
+    std::filesystem::create_directories(m_global_settings.getCacheDirectory(), error_code);
+    if (!writeBakedSceneFile(baked_scene_path, baked_scene_data))
+    {
+        logger().out("unable to write baked scene '" + baked_scene_path.string() + "'", core::misc::LogMessageType::exclamation);
+    }
+}
 
-                default:
-                    assert(false);
-                }
+bool Scene::extractPrimitive(
+    tg3_model const& model,
+    tg3_primitive const& primitive,
+    ProcessedPrimitive& processed_primitive
+)
+{
+    // only indexed triangle lists without morph targets and sparse accessors are processed, the rest is imported as is
+    if ((primitive.mode != -1 && primitive.mode != TG3_MODE_TRIANGLES)
+        || primitive.indices < 0
+        || primitive.targets_count > 0
+        || primitive.attributes_count == 0)
+    {
+        return false;
+    }
 
-                index_buffer = m_scene_memory.getBuffer(buffer_ids.at(indices_buffer_view.buffer));
-                index_buffer.offset += indices_buffer_view.byte_offset;
-                index_buffer.size = indices_buffer_view.byte_length;
+    auto is_accessor_supported = [](tg3_accessor const& accessor)
+        {
+            return accessor.buffer_view >= 0 && !accessor.sparse.is_sparse && accessor.count > 0;
+        };
 
-                submesh.setIndexBuffer(index_buffer, index_type);
-            }
+    tg3_accessor const& indices_accessor = model.accessors[primitive.indices];
+    if (!is_accessor_supported(indices_accessor) || indices_accessor.count % 3 != 0) return false;
 
-            int current_buffer = -1;
-            int current_vb_slot = -1;
-            size_t const invalid_value = std::numeric_limits<size_t>::max();
-            size_t current_element_count = invalid_value;
-            size_t current_buffer_stride = invalid_value;
-            std::array<SceneMemoryBufferHandle, D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT> vertex_buffers{};
+    // interleave the attributes keeping each of them aligned to 4 bytes
+    uint64_t const vertex_count = model.accessors[primitive.attributes[0].value].count;
+    MeshData& mesh = processed_primitive.mesh;
+    mesh.vertex_stride = 0;
+    bool has_position{ false };
+    for (uint32_t ai = 0; ai < primitive.attributes_count; ++ai)
+    {
+        tg3_accessor const& accessor = model.accessors[primitive.attributes[ai].value];
+        if (!is_accessor_supported(accessor) || accessor.count != vertex_count) return false;
 
-            lexgine::core::VertexAttributeSpecificationList vertex_attributes_for_vb_slot{};
-            lexgine::core::VertexAttributeSpecificationList all_vertex_attributes{};
-            vertex_attributes_for_vb_slot.reserve(D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
+        std::string attribute_name(primitive.attributes[ai].key.data, primitive.attributes[ai].key.len);
+        uint32_t const element_size = static_cast<uint32_t>(tg3_component_size(accessor.component_type) * tg3_num_components(accessor.type));
+        if (attribute_name == "POSITION")
+        {
+            if (accessor.component_type != TG3_COMPONENT_TYPE_FLOAT || accessor.type != TG3_TYPE_VEC3) return false;
+            mesh.position_offset = mesh.vertex_stride;
+            has_position = true;
+        }
 
-            for (uint32_t ai = 0; ai < mesh_primitive.attributes_count; ++ai)
+        processed_primitive.attributes.push_back(VertexAttributeLayout{
+            .name = std::move(attribute_name),
+            .format = gltfCast<lexgine::core::misc::DataFormat>(accessor.component_type),
+            .element_count = static_cast<unsigned char>(tg3_num_components(accessor.type)),
+            .is_normalized = accessor.normalized != 0,
+            .offset = mesh.vertex_stride
+            });
+        mesh.vertex_stride += static_cast<uint32_t>(core::misc::align(element_size, 4));
+    }
+    if (!has_position) return false;
+
+    mesh.vertices.resize(vertex_count * mesh.vertex_stride);
+    for (uint32_t ai = 0; ai < primitive.attributes_count; ++ai)
+    {
+        tg3_accessor const& accessor = model.accessors[primitive.attributes[ai].value];
+        tg3_buffer_view const& buffer_view = model.buffer_views[accessor.buffer_view];
+        size_t const element_size = static_cast<size_t>(tg3_component_size(accessor.component_type) * tg3_num_components(accessor.type));
+        size_t const source_stride = buffer_view.byte_stride ? buffer_view.byte_stride : element_size;
+        size_t const source_offset = buffer_view.byte_offset + accessor.byte_offset;
+        if (source_offset + (vertex_count - 1) * source_stride + element_size > model.buffers[buffer_view.buffer].data.count) return false;
+
+        uint8_t const* p_source = model.buffers[buffer_view.buffer].data.data + source_offset;
+        uint8_t* p_destination = mesh.vertices.data() + processed_primitive.attributes[ai].offset;
+        for (uint64_t v = 0; v < vertex_count; ++v)
+        {
+            std::memcpy(p_destination + v * mesh.vertex_stride, p_source + v * source_stride, element_size);
+        }
+    }
+
+    tg3_buffer_view const& indices_buffer_view = model.buffer_views[indices_accessor.buffer_view];
+    size_t const index_size = static_cast<size_t>(tg3_component_size(indices_accessor.component_type));
+    size_t const indices_offset = indices_buffer_view.byte_offset + indices_accessor.byte_offset;
+    if (indices_offset + indices_accessor.count * index_size > model.buffers[indices_buffer_view.buffer].data.count) return false;
+
+    uint8_t const* p_indices = model.buffers[indices_buffer_view.buffer].data.data + indices_offset;
+    mesh.indices.resize(indices_accessor.count);
+    for (uint64_t i = 0; i < indices_accessor.count; ++i)
+    {
+        switch (indices_accessor.component_type)
+        {
+        case TG3_COMPONENT_TYPE_UNSIGNED_BYTE:
+            mesh.indices[i] = p_indices[i];
+            break;
+
+        case TG3_COMPONENT_TYPE_UNSIGNED_SHORT:
+        {
+            uint16_t index; std::memcpy(&index, p_indices + i * sizeof(uint16_t), sizeof(uint16_t));
+            mesh.indices[i] = index;
+            break;
+        }
+
+        case TG3_COMPONENT_TYPE_UNSIGNED_INT:
+            std::memcpy(&mesh.indices[i], p_indices + i * sizeof(uint32_t), sizeof(uint32_t));
+            break;
+
+        default:
+            return false;
+        }
+
+        if (mesh.indices[i] >= vertex_count) return false;
+    }
+
+    return true;
+}
+
+bool Scene::importSceneObjects(
+    tg3_model const& model,
+    std::unordered_map<int, int>& mesh_ids,
+    ProcessedPrimitiveMap const& processed_primitives,
+    std::unordered_map<int, int>& light_ids,
+    std::unordered_map<int, int>& camera_ids,
+    std::vector<std::vector<ImportedPrimitive>>& imported_primitives
+)
+{
+    // Meshes are created upfront, so that each import task only writes into the mesh it decodes
+    m_scene_meshes.reserve(mesh_ids.size());
+    imported_primitives.resize(mesh_ids.size());
+    std::vector<std::unique_ptr<SceneImportTask>> import_tasks{};
+    import_tasks.reserve(mesh_ids.size() + 2);
+    for (auto& [mesh_id, mesh_id_in_scene] : mesh_ids)
+    {
+        tg3_mesh const& mesh = model.meshes[mesh_id];
+        mesh_id_in_scene = static_cast<int>(m_scene_meshes.size());
+        m_scene_meshes.emplace_back(Mesh{ std::string(mesh.name.data, mesh.name.len) });
+
+        import_tasks.push_back(std::make_unique<SceneImportTask>("DecodeMesh" + std::to_string(mesh_id),
+            [this, &model, &processed_primitives, &imported_primitives, mesh_id = mesh_id, mesh_id_in_scene = mesh_id_in_scene]()
             {
-                std::string attribute_name(mesh_primitive.attributes[ai].key.data, mesh_primitive.attributes[ai].key.len);
-                int accessor_id = mesh_primitive.attributes[ai].value;
-                tg3_accessor const& accessor = model.accessors[accessor_id];
-                assert((accessor.type >= TG3_TYPE_VEC2 && accessor.type <= TG3_TYPE_VEC4)
-                    || accessor.type == TG3_TYPE_SCALAR);
+                return decodeMesh(model, mesh_id, processed_primitives, m_scene_meshes[mesh_id_in_scene], imported_primitives[mesh_id_in_scene]);
+            }));
+    }
+    import_tasks.push_back(std::make_unique<SceneImportTask>("LoadLights", [this, &model, &light_ids]() { return loadLights(model, light_ids); }));
+    import_tasks.push_back(std::make_unique<SceneImportTask>("LoadCameras", [this, &model, &camera_ids]() { return loadCameras(model, camera_ids); }));
+
+    std::vector<core::concurrency::AbstractTask*> tasks{};
+    tasks.reserve(import_tasks.size());
+    for (std::unique_ptr<SceneImportTask>& e : import_tasks)
+    {
+        tasks.push_back(e.get());
+    }
 
-                tg3_buffer_view const& buffer_view = model.buffer_views[accessor.buffer_view];
-                assert(buffer_view.target == TG3_TARGET_ARRAY_BUFFER);
+    // the scene load is waiting for the import, so it goes ahead of the background asset processing
+    std::shared_ptr<core::concurrency::AssetJob> import_job =
+        m_globals.get<core::concurrency::AssetScheduler>()->submit(tasks, core::concurrency::AssetJobPriority::high);
+    import_job->wait();
 
-                if (current_buffer != buffer_view.buffer)
-                {
-                    if (current_buffer >= 0
-                        && current_vb_slot >= 0
-                        && current_element_count != invalid_value
-                        && current_buffer_stride != invalid_value)
-                    {
-                        vb_view->setVertexBuffer(
-                            static_cast<size_t>(current_vb_slot),
-                            vertex_buffers[current_vb_slot],
-                            vertex_attributes_for_vb_slot,
-                            current_element_count,
-                            current_buffer_stride
-                        );
-                        vertex_attributes_for_vb_slot.clear();
-                    }
-                    current_buffer = buffer_view.buffer;
-                    ++current_vb_slot;
-                    assert(current_vb_slot < D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
-                    current_element_count = accessor.count;
-                    current_buffer_stride = buffer_view.byte_stride;
-                    vertex_buffers[current_vb_slot] = m_scene_memory.getBuffer(buffer_ids.at(current_buffer));
-                    vertex_buffers[current_vb_slot].offset += buffer_view.byte_offset;
-                    vertex_buffers[current_vb_slot].size = buffer_view.byte_length;
-                }
+    return !import_job->hasFailed() && std::all_of(import_tasks.begin(), import_tasks.end(), [](std::unique_ptr<SceneImportTask> const& e) { return e->result(); });
+}
 
-                auto [va_name, va_index] = extractNameAndIndexFromAttributeName(attribute_name);
+bool Scene::decodeMesh(
+    tg3_model const& model,
+    int mesh_id,
+    ProcessedPrimitiveMap const& processed_primitives,
+    Mesh& target_mesh,
+    std::vector<ImportedPrimitive>& imported_primitives
+) const
+{
+    core::dx::d3d12::DxgiFormatFetcher const& dxgi_format_fetcher = m_globals.get<core::dx::d3d12::DxResourceFactory>()->dxgiFormatFetcher();
+    tg3_mesh const& mesh = model.meshes[mesh_id];
+
+    // Parse mesh primitives
+    std::vector<double> morph_weights(mesh.weights, mesh.weights + mesh.weights_count);
+    target_mesh.applyMorphWeights(morph_weights);
+
+    imported_primitives.reserve(mesh.primitives_count);
+    for (uint32_t pi = 0; pi < mesh.primitives_count; ++pi)
+    {
+        tg3_primitive const& mesh_primitive = mesh.primitives[pi];
+        Submesh submesh{ *m_scene_memory.scene_memory_buffer };
+        VertexBufferView* vb_view = submesh.getVertexBufferView();
+
+        if (auto p = processed_primitives.find({ mesh_id, pi }); p != processed_primitives.end())
+        {
+            // rewritten primitives have all of their attributes interleaved in a single vertex buffer
+            ProcessedPrimitive const& processed_primitive = p->second;
+            if (!processed_primitive.index_view.empty())
+            {
+                // primitives without indices are drawn non-indexed, same as the primitives that are not processed
+                submesh.setIndexBuffer(
+                    m_scene_memory.getProcessedData(processed_primitive.index_buffer_id, processed_primitive.index_view.size()),
+                    processed_primitive.index_type
+                );
+            }
+
+            lexgine::core::VertexAttributeSpecificationList vertex_attributes{};
+            for (VertexAttributeLayout const& attribute : processed_primitive.attributes)
+            {
+                auto [va_name, va_index] = extractNameAndIndexFromAttributeName(attribute.name);
                 core::dx::d3d12::DxgiFormatFetcher::va_spec vertex_attribute_desc
                 {
-                    .format = gltfCast<lexgine::core::misc::DataFormat>(accessor.component_type),
-                    .element_count = static_cast<unsigned char>(tg3_num_components(accessor.type)),
-                    .is_normalized = accessor.normalized != 0,
-                    .primitive_assembler_input_slot = static_cast<unsigned char>(current_vb_slot),
-                    .element_offset = static_cast<uint32_t>(accessor.byte_offset),
+                    .format = attribute.format,
+                    .element_count = attribute.element_count,
+                    .is_normalized = attribute.is_normalized,
+                    .primitive_assembler_input_slot = 0,
+                    .element_offset = attribute.offset,
                     .name = va_name.c_str(),
                     .name_index = static_cast<uint32_t>(va_index),
                     .instancing_data_rate = 0
                 };
-                auto vertex_attribute = dxgi_format_fetcher.createVertexAttribute(vertex_attribute_desc);
-                vertex_attributes_for_vb_slot.push_back(vertex_attribute);
-                all_vertex_attributes.push_back(vertex_attribute);
+                vertex_attributes.push_back(dxgi_format_fetcher.createVertexAttribute(vertex_attribute_desc));
             }
+            vb_view->setVertexBuffer(
+                0,
+                m_scene_memory.getProcessedData(processed_primitive.vertex_buffer_id, processed_primitive.vertex_view.size()),
+                vertex_attributes,
+                static_cast<uint32_t>(processed_primitive.vertex_view.size() / processed_primitive.mesh.vertex_stride),
+                processed_primitive.mesh.vertex_stride
+            );
+
+            if (processed_primitive.position_dequantization)
+            {
+                submesh.setPositionDequantization(*processed_primitive.position_dequantization);
+            }
+
+            if (processed_primitive.meshlets)
             {
-                vb_view->setVertexBuffer(
-                    static_cast<size_t>(current_vb_slot),
-                    m_scene_memory.getBuffer(buffer_ids.at(current_buffer)),
-                    vertex_attributes_for_vb_slot,
-                    current_element_count,
-                    current_buffer_stride
+                submesh.setMeshlets(
+                    processed_primitive.meshlets,
+                    m_scene_memory.getProcessedData(processed_primitive.meshlet_buffer_id, processed_primitive.packed_meshlet_view.size()),
+                    processed_primitive.packed_meshlet_layout
                 );
             }
 
-            if (mesh_primitive.material >= 0)
+            imported_primitives.push_back(ImportedPrimitive{
+                .material_id = mesh_primitive.material,
+                .vertex_attributes = std::move(vertex_attributes),
+                .has_quantized_vertices = processed_primitive.position_dequantization.has_value()
+                });
+            target_mesh.addSubmesh(std::move(submesh));
+            continue;
+        }
+
+        if (mesh_primitive.indices >= 0)
+        {
+            SceneMemoryBufferHandle index_buffer{};
+            IndexType index_type{};
+
+            tg3_accessor const& indices_accessor = model.accessors[mesh_primitive.indices];
+            assert(indices_accessor.type == TG3_TYPE_SCALAR);
+
+            tg3_buffer_view const& indices_buffer_view = model.buffer_views[indices_accessor.buffer_view];
+            assert(indices_buffer_view.target == TG3_TARGET_ELEMENT_ARRAY_BUFFER);
+
+            switch (indices_accessor.component_type)
             {
-                bool result = loadMaterial(model.materials[mesh_primitive.material], all_vertex_attributes);
-                if (result)
-                {
-                    Material& last_loaded_material = m_materials.back();
-                    submesh.setBaseMaterial(&last_loaded_material);
-                }
-                else
+            case TG3_COMPONENT_TYPE_INT:
+            case TG3_COMPONENT_TYPE_UNSIGNED_INT:
+                index_type = IndexType::_default;
+                break;
+
+            case TG3_COMPONENT_TYPE_SHORT:
+            case TG3_COMPONENT_TYPE_UNSIGNED_SHORT:
+                index_type = IndexType::_short;
+                break;
+
+            default:
+                assert(false);
+            }
+
+            index_buffer = m_scene_memory.getBufferView(indices_buffer_view);
+
+            submesh.setIndexBuffer(index_buffer, index_type);
+        }
+
+        int current_buffer = -1;
+        int current_vb_slot = -1;
+        size_t const invalid_value = std::numeric_limits<size_t>::max();
+        size_t current_element_count = invalid_value;
+        size_t current_buffer_stride = invalid_value;
+        std::array<SceneMemoryBufferHandle, D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT> vertex_buffers{};
+
+        lexgine::core::VertexAttributeSpecificationList vertex_attributes_for_vb_slot{};
+        lexgine::core::VertexAttributeSpecificationList all_vertex_attributes{};
+        vertex_attributes_for_vb_slot.reserve(D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
+
+        for (uint32_t ai = 0; ai < mesh_primitive.attributes_count; ++ai)
+        {
+            std::string attribute_name(mesh_primitive.attributes[ai].key.data, mesh_primitive.attributes[ai].key.len);
+            int accessor_id = mesh_primitive.attributes[ai].value;
+            tg3_accessor const& accessor = model.accessors[accessor_id];
+            assert((accessor.type >= TG3_TYPE_VEC2 && accessor.type <= TG3_TYPE_VEC4)
+                || accessor.type == TG3_TYPE_SCALAR);
+
+            tg3_buffer_view const& buffer_view = model.buffer_views[accessor.buffer_view];
+            assert(buffer_view.target == TG3_TARGET_ARRAY_BUFFER);
+
+            if (current_buffer != buffer_view.buffer)
+            {
+                if (current_buffer >= 0
+                    && current_vb_slot >= 0
+                    && current_element_count != invalid_value
+                    && current_buffer_stride != invalid_value)
                 {
-                    LEXGINE_LOG_ERROR(this, "Unable to load material (id = "
-                        + std::to_string(mesh_primitive.material) + ") for mesh "
-                        + std::string(mesh.name.data, mesh.name.len));
+                    vb_view->setVertexBuffer(
+                        static_cast<size_t>(current_vb_slot),
+                        vertex_buffers[current_vb_slot],
+                        vertex_attributes_for_vb_slot,
+                        current_element_count,
+                        current_buffer_stride
+                    );
+                    vertex_attributes_for_vb_slot.clear();
                 }
+                current_buffer = buffer_view.buffer;
+                ++current_vb_slot;
+                assert(current_vb_slot < D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
+                current_element_count = accessor.count;
+                current_buffer_stride = buffer_view.byte_stride;
+                vertex_buffers[current_vb_slot] = m_scene_memory.getBufferView(buffer_view);
             }
 
-            m_scene_meshes.back().addSubmesh(std::move(submesh));
+            auto [va_name, va_index] = extractNameAndIndexFromAttributeName(attribute_name);
+            core::dx::d3d12::DxgiFormatFetcher::va_spec vertex_attribute_desc
+            {
+                .format = gltfCast<lexgine::core::misc::DataFormat>(accessor.component_type),
+                .element_count = static_cast<unsigned char>(tg3_num_components(accessor.type)),
+                .is_normalized = accessor.normalized != 0,
+                .primitive_assembler_input_slot = static_cast<unsigned char>(current_vb_slot),
+                .element_offset = static_cast<uint32_t>(accessor.byte_offset),
+                .name = va_name.c_str(),
+                .name_index = static_cast<uint32_t>(va_index),
+                .instancing_data_rate = 0
+            };
+            auto vertex_attribute = dxgi_format_fetcher.createVertexAttribute(vertex_attribute_desc);
+            vertex_attributes_for_vb_slot.push_back(vertex_attribute);
+            all_vertex_attributes.push_back(vertex_attribute);
         }
+        if (current_vb_slot >= 0)
+        {
+            vb_view->setVertexBuffer(
+                static_cast<size_t>(current_vb_slot),
+                vertex_buffers[current_vb_slot],
+                vertex_attributes_for_vb_slot,
+                current_element_count,
+                current_buffer_stride
+            );
+        }
+
+        imported_primitives.push_back(ImportedPrimitive{ .material_id = mesh_primitive.material, .vertex_attributes = std::move(all_vertex_attributes), .has_quantized_vertices = false });
+        target_mesh.addSubmesh(std::move(submesh));
     }
 
     return true;
 }
 
-bool Scene::loadMaterial(tg3_material const& gltf_material,
-    const lexgine::core::VertexAttributeSpecificationList& vertex_attributes)
+bool Scene::loadMaterials(
+    tg3_model const& model,
+    std::unordered_map<int, int> const& texture_ids,
+    std::vector<std::vector<ImportedPrimitive>> const& imported_primitives
+)
 {
-    if (!tg3_str_equals_cstr(gltf_material.alpha_mode, "OPAQUE"))
-        return false;
+    // Submeshes refer to their materials by pointer, so the material storage must not get reallocated
+    size_t material_count{ 0 };
+    for (auto const& mesh_primitives : imported_primitives)
+    {
+        material_count += std::count_if(mesh_primitives.begin(), mesh_primitives.end(), [](ImportedPrimitive const& e) { return e.material_id >= 0; });
+    }
+    m_materials.reserve(m_materials.size() + material_count);
+
+    bool result = true;
+    for (size_t mesh_index = 0; mesh_index < imported_primitives.size(); ++mesh_index)
+    {
+        Mesh& mesh = m_scene_meshes[mesh_index];
+        for (size_t submesh_index = 0; submesh_index < imported_primitives[mesh_index].size(); ++submesh_index)
+        {
+            ImportedPrimitive const& primitive = imported_primitives[mesh_index][submesh_index];
+            if (primitive.material_id < 0) continue;
+
+            tg3_material const& gltf_material = model.materials[primitive.material_id];
+            if (!tg3_str_equals_cstr(gltf_material.alpha_mode, "OPAQUE"))
+            {
+                // blended and alpha-tested materials are not supported yet, which must not fail the import of the rest of the scene
+                logger().out("Material (id = " + std::to_string(primitive.material_id) + ") for mesh " + std::to_string(mesh_index)
+                    + " uses unsupported alpha mode " + std::string(gltf_material.alpha_mode.data, gltf_material.alpha_mode.len) + " and is skipped",
+                    core::misc::LogMessageType::exclamation);
+                continue;
+            }
+
+            if (loadMaterial(gltf_material, primitive.vertex_attributes, primitive.has_quantized_vertices, texture_ids))
+            {
+                mesh.getSubmesh(submesh_index).setBaseMaterial(&m_materials.back());
+            }
+            else
+            {
+                LEXGINE_LOG_ERROR(this, "Unable to load material (id = "
+                    + std::to_string(primitive.material_id) + ") for mesh " + std::to_string(mesh_index));
+                result = false;
+            }
+        }
+    }
 
+    // until the renderer is able to estimate screen coverage of the materials, textures are streamed in the order of the number of instances drawn with them
+    m_material_texture_priorities.assign(m_materials.size(), 0.f);
+    for (Node const& node : m_scene_nodes)
+    {
+        Mesh const* p_mesh = node.getMesh();
+        if (!p_mesh) continue;
+
+        float const instance_count = static_cast<float>((std::max)(node.instanceTransforms().size(), size_t{ 1 }));
+        for (size_t i = 0; i < p_mesh->getSubmeshCount(); ++i)
+        {
+            if (Material const* p_material = p_mesh->getSubmesh(i).getBaseMaterial())
+            {
+                m_material_texture_priorities[p_material - m_materials.data()] += instance_count;
+            }
+        }
+    }
+
+    return result;
+}
+
+bool Scene::loadMaterial(tg3_material const& gltf_material,
+    const lexgine::core::VertexAttributeSpecificationList& vertex_attributes,
+    bool has_quantized_vertices,
+    std::unordered_map<int, int> const& texture_ids)
+{
     MaterialPSOCompilationContext context{ vertex_attributes };
     MaterialShaderDesc shader_desc{};
     auto* p_hlsl_compilation_task_cache = m_globals.get<core::dx::d3d12::task_caches::HLSLCompilationTaskCache>();
@@ -824,7 +1832,10 @@ bool Scene::loadMaterial(tg3_material const& gltf_material,
 			translation_unit_vs,
 			lexgine::core::dx::dxcompilation::ShaderModel::model_62,
 			lexgine::core::dx::dxcompilation::ShaderType::vertex,
-			"VSMain"
+			"VSMain",
+			has_quantized_vertices
+				? std::list<lexgine::core::dx::dxcompilation::HLSLMacroDefinition>{ { "QUANTIZED_VERTICES", "1" } }
+				: std::list<lexgine::core::dx::dxcompilation::HLSLMacroDefinition>{}
 		);
         shader_desc.p_vertex_shader_compilation_task->execute(0);
 	}
@@ -839,7 +1850,7 @@ bool Scene::loadMaterial(tg3_material const& gltf_material,
 		);
         shader_desc.p_pixel_shader_compilation_task->execute(0);
 	}
-    m_material_construction_tasks.push_back(std::make_unique<MaterialAssemblyTask>(m_basic_rendering_services, context, shader_desc));
+    m_material_construction_tasks.push_back(std::make_unique<MaterialAssemblyTask>(*m_basic_rendering_services_ptr, context, shader_desc));
     
     m_materials.emplace_back(*m_material_construction_tasks.back());
     Material& new_material = m_materials.back();
@@ -860,24 +1871,24 @@ bool Scene::loadMaterial(tg3_material const& gltf_material,
         };
         mr.metallic_factor = gltf_material.pbr_metallic_roughness.metallic_factor;
         mr.roughness_factor = gltf_material.pbr_metallic_roughness.roughness_factor;
-        mr.p_base_color = gltf_material.pbr_metallic_roughness.base_color_texture.index >= 0 ? &m_textures[gltf_material.pbr_metallic_roughness.base_color_texture.index] : nullptr;
-        mr.p_metallic_roughness = gltf_material.pbr_metallic_roughness.metallic_roughness_texture.index >= 0 ? &m_textures[gltf_material.pbr_metallic_roughness.metallic_roughness_texture.index] : nullptr;
+        mr.p_base_color = gltf_material.pbr_metallic_roughness.base_color_texture.index >= 0 ? &m_textures[texture_ids.at(gltf_material.pbr_metallic_roughness.base_color_texture.index)] : nullptr;
+        mr.p_metallic_roughness = gltf_material.pbr_metallic_roughness.metallic_roughness_texture.index >= 0 ? &m_textures[texture_ids.at(gltf_material.pbr_metallic_roughness.metallic_roughness_texture.index)] : nullptr;
         new_material.setMetallicRoughness(mr);
     }
 
     if (gltf_material.normal_texture.index >= 0)
     {
-        new_material.setNormalTexture(&m_textures[gltf_material.normal_texture.index]);
+        new_material.setNormalTexture(&m_textures[texture_ids.at(gltf_material.normal_texture.index)]);
     }
 
     if (gltf_material.occlusion_texture.index >= 0)
     {
-        new_material.setOcclusionTexture(&m_textures[gltf_material.occlusion_texture.index]);
+        new_material.setOcclusionTexture(&m_textures[texture_ids.at(gltf_material.occlusion_texture.index)]);
     }
 
     if (gltf_material.emissive_texture.index >= 0)
     {
-        new_material.setEmissiveTexture(&m_textures[gltf_material.emissive_texture.index]);
+        new_material.setEmissiveTexture(&m_textures[texture_ids.at(gltf_material.emissive_texture.index)]);
     }
 
     return true;
@@ -885,21 +1896,15 @@ bool Scene::loadMaterial(tg3_material const& gltf_material,
 
 void Scene::scheduleMaterialConstruction()
 {
-    std::unordered_set<core::concurrency::TaskGraphRootNode const*> root_nodes{};
-    root_nodes.reserve(m_material_construction_tasks.size());
+    std::vector<core::concurrency::AbstractTask*> tasks{};
+    tasks.reserve(m_material_construction_tasks.size());
     for (std::unique_ptr<MaterialAssemblyTask>& e : m_material_construction_tasks)
     {
-        root_nodes.insert(ROOT_NODE_CAST(e.get()));
+        tasks.push_back(e.get());
     }
-    m_material_construction_task_graph =
-        std::make_unique<core::concurrency::TaskGraph>(
-            root_nodes,
-            m_globals.get<core::GlobalSettings>()->getNumberOfWorkers(),
-            "MaterialConstructionTaskGraph"
-        );
-    m_material_construction_task_sink = std::make_unique<core::concurrency::TaskSink>(*m_material_construction_task_graph, "MaterialConstruction");
-    m_material_construction_task_sink->start();
-    m_material_construction_task_sink->submit(0);
+
+    // the materials get assembled in background, completion of the assembly is reported by loadStatus()
+    m_material_construction_job = m_globals.get<core::concurrency::AssetScheduler>()->submit(tasks, core::concurrency::AssetJobPriority::normal);
 }
 
 bool Scene::loadCameras(tg3_model const& model, std::unordered_map<int, int>& camera_ids)
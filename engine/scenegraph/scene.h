@@ -1,21 +1,31 @@
 #ifndef LEXGINE_SCENEGRAPH_SCENE_H
 #define LEXGINE_SCENEGRAPH_SCENE_H
 
+#include <chrono>
 #include <filesystem>
 #include <future>
+#include <map>
 #include <optional>
+#include <span>
 #include <unordered_map>
 
 #include <tinygltf/tiny_gltf_v3.h>
 
 #include "engine/core/lexgine_core_fwd.h"
+#include "engine/core/concurrency/lexgine_core_concurrency_fwd.h"
 #include "engine/scenegraph/lexgine_scenegraph_fwd.h"
 #include "engine/core/entity.h"
 #include "engine/core/misc/datetime.h"
 #include "engine/core/misc/optional.h"
+#include "engine/core/misc/mapped_file.h"
 #include "engine/core/dx/d3d12/d3d12_tools.h"
 #include "class_names.h"
 #include "scene_mesh_memory.h"
+#include "scene_memory_upload_plan.h"
+#include "mesh_optimizer.h"
+#include "vertex_quantization.h"
+#include "meshlet_builder.h"
+#include "baked_scene.h"
 #include "mesh.h"
 #include "buffer_view.h"
 #include "light.h"
@@ -33,6 +43,18 @@ enum class SceneSource
     glb
 };
 
+//! Wall-clock durations of the scene import pipeline stages
+struct SceneImportTimings
+{
+    std::chrono::microseconds parse{};    //!< reading and parsing of the glTF source or restoring its tables from the baked scene
+    std::chrono::microseconds mesh_processing{};    //!< optional rewriting of the mesh primitives (e.g. optimization) before they are uploaded, or loading of the rewritten primitives from the baked scene
+    std::chrono::microseconds scene_memory_upload{};    //!< scheduling of the geometry buffers for upload, only their planning if the import runs without a GPU
+    std::chrono::microseconds mesh_decode{};    //!< scheduling of image decoding and parallel decoding of mesh accessors, lights and cameras, which runs while the images are being decoded
+    std::chrono::microseconds texture_wait{};    //!< time spent waiting for image decoding, conversion and upload after the meshes have been decoded
+    std::chrono::microseconds material_construction{};    //!< loading and assembly of the materials
+    std::chrono::microseconds total{};
+};
+
 class Scene : public core::NamedEntity<class_names::Scene>, public std::enable_shared_from_this<Scene>
 {
 public:
@@ -48,36 +70,123 @@ public:
         std::string const& scene_name
     );
 
+    /*! Runs only the stages of the import that do not need a GPU, i.e. parsing of the source, processing of the mesh primitives or loading
+     of the baked scene, and planning of the scene memory, and returns their timings. Nothing is uploaded, so the import stops before decoding
+     of the meshes and the stages following it. Requires the global settings and the asset scheduler to be available from the globals
+    */
+    static std::optional<SceneImportTimings> importCpuStages(core::Globals& globals, std::filesystem::path const& path_to_scene, unsigned scene_id);
+
+    //! Removes the baked scene of the given scene from the cache, so that the next import processes the mesh primitives from scratch
+    static void discardBakedScene(core::GlobalSettings const& global_settings, std::filesystem::path const& path_to_scene, unsigned scene_id);
+
+    ~Scene();
+
     SceneSource getSceneSource() const { return m_scene_source; }
     bool loadStatus() const;
 
+    /*! Blocks until the part of the import running in background, i.e. the assembly of the materials and the upload of the textures,
+     has finished and returns the load status of the scene
+    */
+    bool waitForLoadCompletion();
+
+    //! Durations of the import stages. Assembly of the materials runs in background and is accounted for only once waitForLoadCompletion() has returned
+    SceneImportTimings const& importTimings() const { return m_import_timings; }
+
+    /*! Requests the textures of the scene materials to be streamed in and rebinds the textures, for which the range of the mipmap levels
+     available for sampling has changed. Expected to be called once per frame before TextureConverter::updateTextureResidency()
+    */
+    void updateTextureResidency();
+
 private:
     static constexpr char const* c_khr_light_punctual_ext = "KHR_lights_punctual";
     static constexpr char const* c_ext_mesh_gpu_instancing = "EXT_mesh_gpu_instancing";
 
 private:
+    //! Data of a decoded mesh primitive needed to construct its material
+    struct ImportedPrimitive
+    {
+        int material_id;
+        core::VertexAttributeSpecificationList vertex_attributes;
+        bool has_quantized_vertices;    //!< 'true' if the vertex shader has to decode quantized positions, normals and tangents
+    };
+
+    /*! Mesh primitive, which vertex and index data have been rewritten during import and get uploaded from CPU memory instead of the glTF buffers.
+     The uploaded data are referenced by the views, which point either to the data owned by the primitive or directly to the mapped baked scene
+    */
+    struct ProcessedPrimitive
+    {
+        MeshData mesh;    //!< interleaved vertex attributes. The indices are released once they have been encoded into index_data. Only the layout of the vertices is set when the primitive is loaded from the baked scene
+        std::vector<VertexAttributeLayout> attributes;
+        std::optional<PositionDequantization> position_dequantization;    //!< set if the vertex attributes have been quantized
+        std::shared_ptr<MeshletData const> meshlets;    //!< set if the primitive has been partitioned into meshlets
+        std::vector<uint8_t> packed_meshlets;
+        MeshletBufferLayout packed_meshlet_layout;
+        std::vector<uint8_t> index_data;    //!< indices encoded into the most compact index format
+        IndexType index_type;
+        std::span<uint8_t const> vertex_view;    //!< uploaded interleaved vertices
+        std::span<uint8_t const> index_view;    //!< uploaded encoded indices
+        std::span<uint8_t const> packed_meshlet_view;    //!< uploaded packed meshlets
+        uint32_t vertex_buffer_id;    //!< identifiers of the vertex and the index data in the scene memory upload plan
+        uint32_t index_buffer_id;
+        uint32_t meshlet_buffer_id;
+    };
+
+    //! processed primitives keyed by the glTF mesh and the index of the primitive in the mesh
+    using ProcessedPrimitiveMap = std::map<std::pair<int, uint32_t>, ProcessedPrimitive>;
+
     struct SceneMemory
     {
         std::unique_ptr<SceneMeshMemory> scene_memory_buffer;
-        std::vector<SceneMemoryBufferHandle> m_scene_memory_handles;
+        SceneMemoryUploadPlan upload_plan;
+
+        //! returns location of the buffer view in the scene memory. The buffer view must be referenced by one of the uploaded mesh primitives
+        SceneMemoryBufferHandle getBufferView(tg3_buffer_view const& buffer_view) const
+        {
+            return { .offset = upload_plan.sceneMemoryOffset(static_cast<uint32_t>(buffer_view.buffer), buffer_view.byte_offset).value(), .size = buffer_view.byte_length };
+        }
 
-        SceneMemoryBufferHandle getBuffer(size_t id) { return m_scene_memory_handles[id]; }
+        /*! returns location of the data uploaded from CPU memory under the given identifier. Empty data occupy no scene memory
+         and are not known to the upload plan, so an empty handle is returned for them
+        */
+        SceneMemoryBufferHandle getProcessedData(uint32_t buffer_id, size_t size) const
+        {
+            if (!size) return { .offset = 0, .size = 0 };
+            return { .offset = upload_plan.sceneMemoryOffset(buffer_id, 0).value(), .size = size };
+        }
     };
 
 private:
     Scene(
         core::Globals& globals, 
-        core::dx::d3d12::BasicRenderingServices& basic_rendering_services,
+        core::dx::d3d12::BasicRenderingServices* basic_rendering_services_ptr,
         std::filesystem::path const& path_to_scene,
         unsigned scene_id
     );
     Scene(
         core::Globals& globals, 
-        core::dx::d3d12::BasicRenderingServices& basic_rendering_services,
+        core::dx::d3d12::BasicRenderingServices* basic_rendering_services_ptr,
         std::filesystem::path const& path_to_scene,
         std::string const& scene_name
     );
 
+    //! Owner of the glTF tables of the imported scene, which are either restored from the baked scene or parsed from the source
+    struct SourceModel
+    {
+        std::vector<std::unique_ptr<core::misc::MappedFile>> buffer_files;    //!< files providing the buffers of the restored model
+        std::unique_ptr<BakedGltfModel> baked_model;
+        std::optional<tinygltf3::Model> parsed_model;
+
+        tg3_model const* get() const { return baked_model ? &baked_model->model() : parsed_model ? parsed_model->get() : nullptr; }
+    };
+
+    //! Provides the tables of the scene source, which are only parsed if the scene has no valid baked scene. Returns 'false' if the source cannot be read
+    bool openSceneSource(std::string_view scene_selector, SourceModel& source_model);
+
+    /*! Looks up the baked scene of the imported scene in the cache and keeps it mapped into memory if it is still valid. Returns the
+     glTF model restored from the baked scene, which buffers are provided by the files mapped into 'buffer_files', or nullptr if
+     the scene has to be imported from its source
+    */
+    std::unique_ptr<BakedGltfModel> findBakedScene(std::string_view scene_selector, std::vector<std::unique_ptr<core::misc::MappedFile>>& buffer_files);
     std::optional<tinygltf3::Model> readGltfModel(std::filesystem::path const& path);
     bool readScene(tg3_model const& model, unsigned scene_index);
 
@@ -90,14 +199,46 @@ private:
         std::unordered_map<int, int>& texture_ids,
         std::unordered_map<int, int>& sampler_ids
     );
-    bool loadMeshes(
+    //! Rewrites vertex and index data of the mesh primitives, which can be processed on the CPU, in parallel
+    void processMeshPrimitives(
+        tg3_model const& model,
+        std::unordered_map<int, int> const& mesh_ids,
+        ProcessedPrimitiveMap& processed_primitives
+    ) const;
+    //! Loads processed primitives from the baked scene found by findBakedScene(). The primitives refer to the mapped baked scene in place
+    void loadBakedScene(ProcessedPrimitiveMap& processed_primitives) const;
+    void saveBakedScene(tg3_model const& model, ProcessedPrimitiveMap const& processed_primitives) const;
+    static bool extractPrimitive(
+        tg3_model const& model,
+        tg3_primitive const& primitive,
+        ProcessedPrimitive& processed_primitive
+    );
+    //! Decodes meshes, lights and cameras of the scene in parallel on the engine's task sink
+    bool importSceneObjects(
         tg3_model const& model,
         std::unordered_map<int, int>& mesh_ids,
-        std::unordered_map<int, int> const& buffer_ids
+        ProcessedPrimitiveMap const& processed_primitives,
+        std::unordered_map<int, int>& light_ids,
+        std::unordered_map<int, int>& camera_ids,
+        std::vector<std::vector<ImportedPrimitive>>& imported_primitives
+    );
+    bool decodeMesh(
+        tg3_model const& model,
+        int mesh_id,
+        ProcessedPrimitiveMap const& processed_primitives,
+        Mesh& target_mesh,
+        std::vector<ImportedPrimitive>& imported_primitives
+    ) const;
+    bool loadMaterials(
+        tg3_model const& model,
+        std::unordered_map<int, int> const& texture_ids,
+        std::vector<std::vector<ImportedPrimitive>> const& imported_primitives
     );
     bool loadMaterial(
         tg3_material const& gltf_material,
-        const lexgine::core::VertexAttributeSpecificationList& vertex_attributes
+        const lexgine::core::VertexAttributeSpecificationList& vertex_attributes,
+        bool has_quantized_vertices,
+        std::unordered_map<int, int> const& texture_ids
     );
     void scheduleMaterialConstruction();
     bool loadCameras(
@@ -111,20 +252,26 @@ private:
 
 private:
     core::Globals& m_globals;
-    core::dx::d3d12::BasicRenderingServices& m_basic_rendering_services;
+    core::dx::d3d12::BasicRenderingServices* m_basic_rendering_services_ptr;    //!< nullptr if only the stages of the import, which do not need a GPU, are run
     core::GlobalSettings& m_global_settings;
     core::misc::DateTime const m_timestamp;
     std::filesystem::path m_scene_path;
     SceneSource m_scene_source;
     int m_scene_index{ -1 };
     bool m_scene_source_parse_status{ false };
-    std::unordered_map<std::string, bool> m_enabled_extensions = { {c_khr_light_punctual_ext, false} };
+    SceneImportTimings m_import_timings;
+    std::optional<BakedSceneKey> m_baked_scene_key;    //!< unset if the imported primitives are not baked
+    std::unique_ptr<core::misc::MappedFile> m_baked_scene_image;    //!< valid baked scene mapped into memory, released once the import has finished
+    std::optional<BakedScene> m_baked_scene;    //!< contents of m_baked_scene_image
+    std::unordered_map<std::string, bool> m_enabled_extensions = { {c_khr_light_punctual_ext, false}, {c_ext_mesh_gpu_instancing, false} };
     
+    TransformHierarchy m_transform_hierarchy;    //!< transforms of the scene nodes, must outlive the nodes
     std::vector<Node> m_scene_nodes;
     std::vector<Light> m_lights;
     std::vector<Texture> m_textures;
     std::vector<Sampler> m_samplers;
     std::vector<Material> m_materials;
+    std::vector<float> m_material_texture_priorities;    //!< priorities, with which the textures of the materials are streamed in
     std::vector<Camera> m_cameras;
 
     SceneMemory m_scene_memory;
@@ -132,8 +279,8 @@ private:
     std::vector<Mesh> m_scene_meshes;
     std::vector<BufferView> m_memory_views;
     std::vector<std::unique_ptr<MaterialAssemblyTask>> m_material_construction_tasks;
-    std::unique_ptr<core::concurrency::TaskGraph> m_material_construction_task_graph;
-    std::unique_ptr<core::concurrency::TaskSink> m_material_construction_task_sink;
+    std::shared_ptr<core::concurrency::AssetJob> m_material_construction_job;    //!< assembly of the materials scheduled on the shared asset scheduler
+    std::chrono::steady_clock::time_point m_material_construction_start_time;
 };
 
 }
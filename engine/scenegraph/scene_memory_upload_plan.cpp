@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <cassert>
+
+#include "engine/core/misc/misc.h"
+#include "scene_memory_upload_plan.h"
+
+namespace lexgine::scenegraph
+{
+
+SceneMemoryUploadPlan::SceneMemoryUploadPlan(size_t alignment)
+    : m_alignment{ alignment }
+    , m_total_size{ 0 }
+    , m_is_built{ false }
+{
+    assert(m_alignment > 0);
+}
+
+void SceneMemoryUploadPlan::addReferencedRange(uint32_t buffer, size_t offset, size_t size, size_t buffer_size)
+{
+    assert(!m_is_built);
+    assert(offset + size <= buffer_size);
+
+    size_t const aligned_begin = offset / m_alignment * m_alignment;
+    size_t const aligned_end = (std::min)(core::misc::align(offset + size, m_alignment), buffer_size);
+    m_ranges.push_back(Range{ .buffer = buffer, .source_offset = aligned_begin, .size = aligned_end - aligned_begin, .destination_offset = 0 });
+}
+
+void SceneMemoryUploadPlan::build()
+{
+    std::sort(m_ranges.begin(), m_ranges.end(),
+        [](Range const& a, Range const& b) { return a.buffer < b.buffer || (a.buffer == b.buffer && a.source_offset < b.source_offset); });
+
+    // coalesce overlapping and adjacent ranges of the same buffer
+    size_t coalesced_range_count{ 0 };
+    for (size_t i = 0; i < m_ranges.size(); ++i)
+    {
+        if (coalesced_range_count > 0)
+        {
+            Range& last_range = m_ranges[coalesced_range_count - 1];
+            if (last_range.buffer == m_ranges[i].buffer && m_ranges[i].source_offset <= last_range.source_offset + last_range.size)
+            {
+                last_range.size = (std::max)(last_range.size, m_ranges[i].source_offset + m_ranges[i].size - last_range.source_offset);
+                continue;
+            }
+        }
+        m_ranges[coalesced_range_count++] = m_ranges[i];
+    }
+    m_ranges.resize(coalesced_range_count);
+
+    m_total_size = 0;
+    for (Range& r : m_ranges)
+    {
+        r.destination_offset = core::misc::align(m_total_size, m_alignment);
+        m_total_size = r.destination_offset + r.size;
+    }
+
+    m_is_built = true;
+}
+
+std::optional<size_t> SceneMemoryUploadPlan::sceneMemoryOffset(uint32_t buffer, size_t offset) const
+{
+    assert(m_is_built);
+
+    // find the last range starting at or before the requested location
+    auto p = std::upper_bound(m_ranges.begin(), m_ranges.end(), std::make_pair(buffer, offset),
+        [](std::pair<uint32_t, size_t> const& location, Range const& r)
+        {
+            return location.first < r.buffer || (location.first == r.buffer && location.second < r.source_offset);
+        });
+
+    if (p == m_ranges.begin()) return std::nullopt;
+    --p;
+
+    if (p->buffer != buffer || offset >= p->source_offset + p->size) return std::nullopt;
+    return p->destination_offset + (offset - p->source_offset);
+}
+
+}
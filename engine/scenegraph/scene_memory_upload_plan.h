@@ -0,0 +1,58 @@
+#ifndef LEXGINE_SCENEGRAPH_SCENE_MEMORY_UPLOAD_PLAN_H
+#define LEXGINE_SCENEGRAPH_SCENE_MEMORY_UPLOAD_PLAN_H
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "engine/core/entity.h"
+#include "lexgine_scenegraph_fwd.h"
+#include "class_names.h"
+
+namespace lexgine::scenegraph {
+
+/*! Plans upload of the source buffers of a scene into the scene mesh memory. Instead of uploading the source buffers
+ as a whole (which also contain animation data, embedded images and data of unused accessors) only the byte ranges
+ actually referenced by mesh primitives are uploaded. Overlapping and adjacent ranges of each buffer are coalesced
+ and placed one after another in the scene memory. The ranges are expanded to the alignment boundary, which keeps
+ alignment of the data in the scene memory the same as in the source buffers
+*/
+class SceneMemoryUploadPlan final : public core::NamedEntity<class_names::SceneMemoryUploadPlan>
+{
+public:
+    static constexpr size_t c_default_alignment = 16U;
+
+    struct Range
+    {
+        uint32_t buffer;    //!< index of the source buffer
+        size_t source_offset;    //!< offset of the range from the beginning of the source buffer
+        size_t size;
+        size_t destination_offset;    //!< offset of the range from the beginning of the scene memory
+    };
+
+public:
+    explicit SceneMemoryUploadPlan(size_t alignment = c_default_alignment);
+
+    //! marks range of the source buffer as referenced. The size of the whole buffer is needed to clamp the range after alignment
+    void addReferencedRange(uint32_t buffer, size_t offset, size_t size, size_t buffer_size);
+
+    //! coalesces the referenced ranges and assigns their locations in the scene memory
+    void build();
+
+    std::vector<Range> const& ranges() const { return m_ranges; }    //! ranges to upload sorted by buffer and offset; valid after build()
+    size_t totalSize() const { return m_total_size; }    //! size of scene memory needed to hold all ranges including alignment padding
+    size_t alignment() const { return m_alignment; }
+
+    //! returns offset in the scene memory corresponding to the given location in the source buffer or nothing if the location was not planned for upload
+    std::optional<size_t> sceneMemoryOffset(uint32_t buffer, size_t offset) const;
+
+private:
+    size_t m_alignment;
+    std::vector<Range> m_ranges;
+    size_t m_total_size;
+    bool m_is_built;
+};
+
+}
+
+#endif
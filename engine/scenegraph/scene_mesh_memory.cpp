@@ -42,8 +42,10 @@ SceneMeshMemory::SceneMeshMemory(core::Globals& globals, uint64_t size)
 
 }
 
-SceneMemoryBufferHandle SceneMeshMemory::addData(void const* p_data, size_t size)
+SceneMemoryBufferHandle SceneMeshMemory::addData(void const* p_data, size_t size, size_t alignment)
 {
+    m_data_upload_offset = core::misc::align(m_data_upload_offset, alignment);
+
     core::dx::d3d12::ResourceDataUploader::DestinationDescriptor destination_desc{
             .p_destination_resource = &m_gpu_scene_memory_buffer,
             .destination_resource_state = core::dx::d3d12::ResourceState::base_values::common
@@ -26,7 +26,7 @@ public:
 
     size_t size() const { return m_gpu_scene_memory_buffer.descriptor().width; }
 
-    SceneMemoryBufferHandle addData(void const* p_data, size_t size);    //! Adds new data to be asynchronously uploaded to the scene mesh memory and returns a handle allowing to access it later
+    SceneMemoryBufferHandle addData(void const* p_data, size_t size, size_t alignment = 1);    //! Adds new data to be asynchronously uploaded to the scene mesh memory at the given alignment and returns a handle allowing to access it later
     void uploadAllData();    // upload all previously scheduled data
     
     void reset();
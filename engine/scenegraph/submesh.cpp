@@ -16,4 +16,11 @@ void Submesh::setIndexBuffer(SceneMemoryBufferHandle const& buffer_handle, Index
     m_ib_data_type = index_data_type;
 }
 
+void Submesh::setMeshlets(std::shared_ptr<MeshletData const> const& meshlets, SceneMemoryBufferHandle const& buffer_handle, MeshletBufferLayout const& layout)
+{
+    m_meshlets = meshlets;
+    m_meshlet_buffer = buffer_handle;
+    m_meshlet_buffer_layout = layout;
+}
+
 }
\ No newline at end of file
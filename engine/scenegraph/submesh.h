@@ -4,6 +4,8 @@
 #include "engine/core/dx/d3d12/lexgine_core_dx_d3d12_fwd.h"
 #include "engine/core/dx/d3d12/tasks/pso_compilation_task.h"
 #include "vertex_buffer_view.h"
+#include "vertex_quantization.h"
+#include "meshlet_builder.h"
 
 namespace lexgine::scenegraph
 {
@@ -26,6 +28,15 @@ public:
     void setIndexBuffer(SceneMemoryBufferHandle const& buffer_handle, IndexType index_data_type);
     void setBaseMaterial(Material* p_material) { m_baseMaterialPtr = p_material; }
     Material* getBaseMaterial() const { return m_baseMaterialPtr; }
+    void setPositionDequantization(PositionDequantization const& dequantization) { m_position_dequantization = dequantization; m_has_quantized_positions = true; }
+    PositionDequantization const& getPositionDequantization() const { return m_position_dequantization; }
+    bool hasQuantizedPositions() const { return m_has_quantized_positions; }
+
+    //! attaches meshlets of the submesh: the CPU copy is used for culling, and the packed copy in the scene memory is intended for mesh shaders
+    void setMeshlets(std::shared_ptr<MeshletData const> const& meshlets, SceneMemoryBufferHandle const& buffer_handle, MeshletBufferLayout const& layout);
+    MeshletData const* getMeshlets() const { return m_meshlets.get(); }    //! returns meshlets of the submesh or nullptr if the submesh has not been partitioned into meshlets
+    SceneMemoryBufferHandle const& getMeshletBuffer() const { return m_meshlet_buffer; }
+    MeshletBufferLayout const& getMeshletBufferLayout() const { return m_meshlet_buffer_layout; }
     void draw(core::dx::d3d12::CommandList& recording_command_list) const;
 
 private:
@@ -34,6 +45,11 @@ private:
     IndexType m_ib_data_type;
     SceneMemoryBufferHandle m_ib_view;
     Material* m_baseMaterialPtr{ nullptr };
+    PositionDequantization m_position_dequantization;    //!< transform to apply to the vertex positions before the object transform (identity unless the positions are quantized)
+    bool m_has_quantized_positions{ false };
+    std::shared_ptr<MeshletData const> m_meshlets;
+    SceneMemoryBufferHandle m_meshlet_buffer;
+    MeshletBufferLayout m_meshlet_buffer_layout{};
 };
 
 }
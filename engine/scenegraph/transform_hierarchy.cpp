@@ -0,0 +1,396 @@
+#include <algorithm>
+#include <cassert>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define LEXGINE_TRANSFORM_HIERARCHY_SSE
+#include <xmmintrin.h>
+#endif
+
+#include <engine/core/misc/log.h>
+#include <engine/core/concurrency/abstract_task.h>
+#include <engine/core/concurrency/asset_scheduler.h>
+#include "transform_hierarchy.h"
+
+namespace lexgine::scenegraph
+{
+
+namespace
+{
+
+// depth levels smaller than this are not worth splitting between worker threads
+constexpr uint32_t c_min_nodes_per_worker = 1024U;
+
+// computes a * b, where the result must not alias either of the arguments
+inline void multiply(core::math::Matrix4f const& a, core::math::Matrix4f const& b, core::math::Matrix4f& result)
+{
+#ifdef LEXGINE_TRANSFORM_HIERARCHY_SSE
+    // the matrices are stored by columns, so each column of the result is a linear combination of the columns of 'a'
+    float const* p_a = &a[0][0];
+    float const* p_b = &b[0][0];
+    float* p_result = &result[0][0];
+
+    __m128 const a0 = _mm_loadu_ps(p_a);
+    __m128 const a1 = _mm_loadu_ps(p_a + 4);
+    __m128 const a2 = _mm_loadu_ps(p_a + 8);
+    __m128 const a3 = _mm_loadu_ps(p_a + 12);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        __m128 column = _mm_mul_ps(a0, _mm_set1_ps(p_b[4 * i]));
+        column = _mm_add_ps(column, _mm_mul_ps(a1, _mm_set1_ps(p_b[4 * i + 1])));
+        column = _mm_add_ps(column, _mm_mul_ps(a2, _mm_set1_ps(p_b[4 * i + 2])));
+        column = _mm_add_ps(column, _mm_mul_ps(a3, _mm_set1_ps(p_b[4 * i + 3])));
+        _mm_storeu_ps(p_result + 4 * i, column);
+    }
+#else
+    result = a * b;
+#endif
+}
+
+template<typename T>
+void applyPermutation(std::vector<T>& data, std::vector<uint32_t> const& order)
+{
+    std::vector<T> permuted_data{};
+    permuted_data.reserve(data.size());
+    for (uint32_t i : order) permuted_data.push_back(std::move(data[i]));
+    data.swap(permuted_data);
+}
+
+}    // namespace
+
+
+class TransformHierarchy::RangeUpdateTask final : public core::concurrency::AbstractTask
+{
+public:
+    RangeUpdateTask(TransformHierarchy& hierarchy)
+        : AbstractTask{ "transform_hierarchy_range_update", false }
+        , m_hierarchy{ hierarchy }
+    {
+    }
+
+    void setRange(uint32_t first, uint32_t last) { m_first = first; m_last = last; }
+
+    // AbstractTask protocol implementation
+    bool doTask(uint8_t worker_id, uint64_t user_data) override
+    {
+        m_hierarchy.updateRange(m_first, m_last);
+        return true;
+    }
+
+    core::concurrency::TaskType type() const override { return core::concurrency::TaskType::cpu; }
+
+private:
+    TransformHierarchy& m_hierarchy;
+    uint32_t m_first = 0U;
+    uint32_t m_last = 0U;
+};
+
+
+TransformHierarchy::TransformHierarchy(core::concurrency::AssetScheduler* p_scheduler)
+    : m_scheduler_ptr{ p_scheduler }
+{
+}
+
+TransformHierarchy::~TransformHierarchy() = default;
+
+TransformHierarchy::Handle TransformHierarchy::addTransform(Handle parent)
+{
+    if (parent != c_invalid_handle && !isValid(parent))
+    {
+        LEXGINE_LOG_ERROR(this, "Unable to add transform: parent handle " + std::to_string(parent) + " is not valid");
+        return c_invalid_handle;
+    }
+
+    Handle transform{};
+    if (m_free_slots.empty())
+    {
+        transform = static_cast<Handle>(m_slots.size());
+        m_slots.emplace_back();
+        m_links.push_back(Links{ .first_child = c_invalid_handle, .next_sibling = c_invalid_handle, .previous_sibling = c_invalid_handle });
+    }
+    else
+    {
+        transform = m_free_slots.back();
+        m_free_slots.pop_back();
+    }
+
+    link(transform, parent);
+    m_slots[transform].index = static_cast<uint32_t>(m_index_to_slot.size());
+    m_index_to_slot.push_back(transform);
+    m_parent_slots.push_back(parent);
+    m_parent_indices.push_back(c_invalid_index);
+    m_dirty_flags.push_back(1);
+    m_local_to_parent.emplace_back(1.f);
+    m_parent_to_local.emplace_back(1.f);
+    m_local_to_world.emplace_back(1.f);
+    m_world_to_local.emplace_back(1.f);
+
+    m_is_layout_dirty = true;
+    return transform;
+}
+
+void TransformHierarchy::releaseTransform(Handle transform)
+{
+    if (!isValid(transform)) return;
+
+    // children of the released transform become roots
+    for (Handle child = m_links[transform].first_child; child != c_invalid_handle;)
+    {
+        Handle const next_child = m_links[child].next_sibling;
+        m_parent_slots[m_slots[child].index] = c_invalid_handle;
+        m_links[child].next_sibling = m_links[child].previous_sibling = c_invalid_handle;
+        child = next_child;
+    }
+    m_links[transform].first_child = c_invalid_handle;
+    unlink(transform);
+
+    uint32_t const index = m_slots[transform].index;
+
+    // the released transform is replaced by the last one, the ordering gets restored on the next update
+    uint32_t const last_index = static_cast<uint32_t>(m_index_to_slot.size()) - 1;
+    if (index != last_index)
+    {
+        m_index_to_slot[index] = m_index_to_slot[last_index];
+        m_parent_slots[index] = m_parent_slots[last_index];
+        m_local_to_parent[index] = m_local_to_parent[last_index];
+        m_parent_to_local[index] = m_parent_to_local[last_index];
+        m_local_to_world[index] = m_local_to_world[last_index];
+        m_world_to_local[index] = m_world_to_local[last_index];
+        m_slots[m_index_to_slot[index]].index = index;
+    }
+
+    m_index_to_slot.pop_back();
+    m_parent_slots.pop_back();
+    m_parent_indices.pop_back();
+    m_dirty_flags.pop_back();
+    m_local_to_parent.pop_back();
+    m_parent_to_local.pop_back();
+    m_local_to_world.pop_back();
+    m_world_to_local.pop_back();
+
+    m_slots[transform].index = c_invalid_index;
+    m_free_slots.push_back(transform);
+    m_is_layout_dirty = true;
+}
+
+bool TransformHierarchy::setParent(Handle transform, Handle parent)
+{
+    if (!isValid(transform) || (parent != c_invalid_handle && !isValid(parent)))
+    {
+        LEXGINE_LOG_ERROR(this, "Unable to attach transform " + std::to_string(transform) + " to parent " + std::to_string(parent)
+            + ": invalid transform handle");
+        return false;
+    }
+
+    for (Handle ancestor = parent; ancestor != c_invalid_handle; ancestor = m_parent_slots[m_slots[ancestor].index])
+    {
+        if (ancestor == transform)
+        {
+            LEXGINE_LOG_ERROR(this, "Unable to attach transform " + std::to_string(transform) + " to parent " + std::to_string(parent)
+                + ": the parent is a descendant of the transform");
+            return false;
+        }
+    }
+
+    uint32_t const index = m_slots[transform].index;
+    if (m_parent_slots[index] != parent)
+    {
+        unlink(transform);
+        link(transform, parent);
+        m_parent_slots[index] = parent;
+        m_is_layout_dirty = true;
+    }
+    return true;
+}
+
+void TransformHierarchy::link(Handle transform, Handle parent)
+{
+    if (parent == c_invalid_handle) return;
+
+    Links& links = m_links[transform];
+    links.previous_sibling = c_invalid_handle;
+    links.next_sibling = m_links[parent].first_child;
+    if (links.next_sibling != c_invalid_handle) m_links[links.next_sibling].previous_sibling = transform;
+    m_links[parent].first_child = transform;
+}
+
+void TransformHierarchy::unlink(Handle transform)
+{
+    Handle const parent = m_parent_slots[m_slots[transform].index];
+    if (parent == c_invalid_handle) return;
+
+    Links& links = m_links[transform];
+    if (links.previous_sibling != c_invalid_handle) m_links[links.previous_sibling].next_sibling = links.next_sibling;
+    else m_links[parent].first_child = links.next_sibling;
+    if (links.next_sibling != c_invalid_handle) m_links[links.next_sibling].previous_sibling = links.previous_sibling;
+    links.next_sibling = links.previous_sibling = c_invalid_handle;
+}
+
+TransformHierarchy::Handle TransformHierarchy::getParent(Handle transform) const
+{
+    return m_parent_slots[m_slots[transform].index];
+}
+
+bool TransformHierarchy::isValid(Handle transform) const
+{
+    return transform < m_slots.size() && m_slots[transform].index != c_invalid_index;
+}
+
+void TransformHierarchy::setLocalTransform(Handle transform, core::math::Matrix4f const& local_to_parent, core::math::Matrix4f const& parent_to_local)
+{
+    uint32_t const index = m_slots[transform].index;
+    m_local_to_parent[index] = local_to_parent;
+    m_parent_to_local[index] = parent_to_local;
+    m_dirty_flags[index] = 1;
+    m_has_dirty_transforms = true;
+}
+
+void TransformHierarchy::update()
+{
+    if (m_is_layout_dirty)
+    {
+        rebuildLayout();
+
+        // the nodes that changed their depth or parent cannot be told apart after the sort, so all world transforms are recomputed
+        std::fill(m_dirty_flags.begin(), m_dirty_flags.end(), 1);
+        m_has_dirty_transforms = true;
+    }
+
+    if (!m_has_dirty_transforms) return;
+
+    // the calling thread takes part in the update, hence the extra worker
+    uint32_t const worker_count = m_scheduler_ptr && !m_scheduler_ptr->isWorkerThread()
+        ? m_scheduler_ptr->getNumberOfWorkerThreads() + 1U
+        : 1U;
+
+    std::vector<core::concurrency::AbstractTask*> level_update_tasks{};
+    for (size_t level = 0; level + 1 < m_level_offsets.size(); ++level)
+    {
+        uint32_t const level_begin = m_level_offsets[level];
+        uint32_t const level_end = m_level_offsets[level + 1];
+        uint32_t const level_size = level_end - level_begin;
+        uint32_t const level_worker_count = (std::max)((std::min)(worker_count, level_size / c_min_nodes_per_worker), 1U);
+
+        if (level_worker_count == 1)
+        {
+            updateRange(level_begin, level_end);
+            continue;
+        }
+
+        // the calling thread processes the last chunk of the level while the others are processed by the scheduler
+        uint32_t const chunk_size = (level_size + level_worker_count - 1) / level_worker_count;
+        level_update_tasks.clear();
+        for (uint32_t first = level_begin; first + chunk_size < level_end; first += chunk_size)
+        {
+            if (level_update_tasks.size() == m_range_update_tasks.size())
+            {
+                m_range_update_tasks.push_back(std::make_unique<RangeUpdateTask>(*this));
+            }
+
+            RangeUpdateTask* p_task = m_range_update_tasks[level_update_tasks.size()].get();
+            p_task->setRange(first, first + chunk_size);
+            level_update_tasks.push_back(p_task);
+        }
+
+        // the tasks are reused by the next level, so the job must be finished before moving on
+        std::shared_ptr<core::concurrency::AssetJob> level_update_job =
+            m_scheduler_ptr->submit(level_update_tasks, core::concurrency::AssetJobPriority::high);
+        updateRange(level_begin + static_cast<uint32_t>(level_update_tasks.size()) * chunk_size, level_end);
+        level_update_job->wait();
+    }
+
+    std::fill(m_dirty_flags.begin(), m_dirty_flags.end(), 0);
+    m_has_dirty_transforms = false;
+}
+
+void TransformHierarchy::rebuildLayout()
+{
+    uint32_t const transform_count = static_cast<uint32_t>(m_index_to_slot.size());
+
+    // lists of children of each node are packed into a single array
+    std::vector<uint32_t> children_offsets(transform_count + 1, 0U);
+    for (Handle parent_slot : m_parent_slots)
+    {
+        if (parent_slot != c_invalid_handle) ++children_offsets[m_slots[parent_slot].index + 1];
+    }
+    for (uint32_t i = 0; i < transform_count; ++i)
+    {
+        children_offsets[i + 1] += children_offsets[i];
+    }
+
+    std::vector<uint32_t> children(children_offsets.back());
+    {
+        std::vector<uint32_t> children_counts(transform_count, 0U);
+        for (uint32_t i = 0; i < transform_count; ++i)
+        {
+            if (m_parent_slots[i] == c_invalid_handle) continue;
+            uint32_t const parent_index = m_slots[m_parent_slots[i]].index;
+            children[children_offsets[parent_index] + children_counts[parent_index]++] = i;
+        }
+    }
+
+    // breadth-first traversal starting from the roots places the nodes in the order of increasing depth
+    // with the children of the same parent packed together
+    std::vector<uint32_t> order{};
+    order.reserve(transform_count);
+    for (uint32_t i = 0; i < transform_count; ++i)
+    {
+        if (m_parent_slots[i] == c_invalid_handle) order.push_back(i);
+    }
+
+    m_level_offsets.assign(1, 0U);
+    for (uint32_t level_begin = 0; level_begin < order.size(); )
+    {
+        uint32_t const level_end = static_cast<uint32_t>(order.size());
+        m_level_offsets.push_back(level_end);
+        for (uint32_t i = level_begin; i < level_end; ++i)
+        {
+            order.insert(order.end(), children.begin() + children_offsets[order[i]], children.begin() + children_offsets[order[i] + 1]);
+        }
+        level_begin = level_end;
+    }
+    assert(order.size() == transform_count);
+
+    applyPermutation(m_index_to_slot, order);
+    applyPermutation(m_parent_slots, order);
+    applyPermutation(m_local_to_parent, order);
+    applyPermutation(m_parent_to_local, order);
+    applyPermutation(m_local_to_world, order);
+    applyPermutation(m_world_to_local, order);
+
+    for (uint32_t i = 0; i < transform_count; ++i)
+    {
+        m_slots[m_index_to_slot[i]].index = i;
+    }
+    for (uint32_t i = 0; i < transform_count; ++i)
+    {
+        m_parent_indices[i] = m_parent_slots[i] == c_invalid_handle ? c_invalid_index : m_slots[m_parent_slots[i]].index;
+    }
+
+    m_is_layout_dirty = false;
+}
+
+void TransformHierarchy::updateRange(uint32_t first, uint32_t last)
+{
+    for (uint32_t i = first; i < last; ++i)
+    {
+        uint32_t const parent_index = m_parent_indices[i];
+        if (parent_index == c_invalid_index)
+        {
+            if (m_dirty_flags[i])
+            {
+                m_local_to_world[i] = m_local_to_parent[i];
+                m_world_to_local[i] = m_parent_to_local[i];
+            }
+        }
+        else if (m_dirty_flags[i] || m_dirty_flags[parent_index])
+        {
+            // parents belong to the previous depth level, which has already been updated
+            m_dirty_flags[i] = 1;
+            multiply(m_local_to_world[parent_index], m_local_to_parent[i], m_local_to_world[i]);
+            multiply(m_parent_to_local[i], m_world_to_local[parent_index], m_world_to_local[i]);
+        }
+    }
+}
+
+}
@@ -0,0 +1,124 @@
+#ifndef LEXGINE_SCENEGRAPH_TRANSFORM_HIERARCHY_H
+#define LEXGINE_SCENEGRAPH_TRANSFORM_HIERARCHY_H
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "engine/core/math/matrix_types.h"
+#include "engine/core/entity.h"
+#include "engine/core/concurrency/lexgine_core_concurrency_fwd.h"
+#include "lexgine_scenegraph_fwd.h"
+#include "class_names.h"
+
+namespace lexgine::scenegraph {
+
+/*! Flat structure-of-arrays storage of node transforms. The transforms are kept sorted by depth in the hierarchy
+ and, within each depth level, by the index of the parent, so that world transforms of all dirty nodes are recomputed
+ by a single linear pass over the arrays, in which parents are always visited before their children. Nodes of the same
+ depth level do not depend on each other, which allows to split large levels between the workers of the asset scheduler.
+ World transforms are composed as localToWorld = parent.localToWorld * localToParent, and the world transforms of the roots
+ are given by their local transforms.
+ Transforms are referred to by stable handles, which remain valid until the transform is released. Structural changes
+ (adding, releasing and reparenting transforms) only invalidate the ordering, which is restored on the next update().
+ The hierarchy is not thread-safe.
+*/
+class TransformHierarchy final : public core::NamedEntity<class_names::TransformHierarchy>
+{
+public:
+    using Handle = uint32_t;
+    static constexpr Handle c_invalid_handle = 0xFFFFFFFF;
+
+public:
+    explicit TransformHierarchy(core::concurrency::AssetScheduler* p_scheduler = nullptr);    //! when the scheduler is null the transforms are updated on the calling thread only
+    ~TransformHierarchy();
+    TransformHierarchy(TransformHierarchy const&) = delete;
+    TransformHierarchy& operator=(TransformHierarchy const&) = delete;
+
+    //! allocates new transform initialized to identity and attaches it to the given parent transform
+    Handle addTransform(Handle parent = c_invalid_handle);
+
+    //! releases the transform. The children of the released transform become roots of the hierarchy
+    void releaseTransform(Handle transform);
+
+    /*! attaches the transform to the new parent or makes it a root if the parent is c_invalid_handle.
+     Returns 'false' if the parent is not valid or if attaching the transform would create a cycle
+    */
+    bool setParent(Handle transform, Handle parent);
+    Handle getParent(Handle transform) const;
+
+    bool isValid(Handle transform) const;
+    size_t size() const { return m_index_to_slot.size(); }
+
+    //! sets the transform relative to the parent together with its inverse
+    void setLocalTransform(Handle transform, core::math::Matrix4f const& local_to_parent, core::math::Matrix4f const& parent_to_local);
+
+    core::math::Matrix4f const& localToParentTransform(Handle transform) const { return m_local_to_parent[m_slots[transform].index]; }
+    core::math::Matrix4f const& parentToLocalTransform(Handle transform) const { return m_parent_to_local[m_slots[transform].index]; }
+
+    //! world transforms are only valid after update() and the returned references are invalidated by structural changes
+    core::math::Matrix4f const& localToWorldTransform(Handle transform) const { return m_local_to_world[m_slots[transform].index]; }
+    core::math::Matrix4f const& worldToLocalTransform(Handle transform) const { return m_world_to_local[m_slots[transform].index]; }
+
+    //! returns 'true' if world transforms of all nodes are up to date
+    bool isUpToDate() const { return !m_is_layout_dirty && !m_has_dirty_transforms; }
+
+    core::concurrency::AssetScheduler* scheduler() const { return m_scheduler_ptr; }
+    void setScheduler(core::concurrency::AssetScheduler* p_scheduler) { m_scheduler_ptr = p_scheduler; }
+
+    /*! recomputes world transforms of the nodes, whose local transforms or transforms of any ancestors have changed
+     since the last update. Depth levels containing many nodes are split between the calling thread and the workers of
+     the scheduler. When called from a worker of the scheduler the update runs on the calling thread only, so that
+     the worker never blocks on the tasks queued behind it
+    */
+    void update();
+
+private:
+    struct Slot
+    {
+        uint32_t index;    //!< position of the transform in the sorted arrays or c_invalid_index if the slot is free
+    };
+
+    struct Links
+    {
+        Handle first_child;
+        Handle next_sibling;
+        Handle previous_sibling;
+    };
+
+    class RangeUpdateTask;    //! updates a part of a depth level on a worker of the scheduler
+
+    static constexpr uint32_t c_invalid_index = 0xFFFFFFFF;
+
+private:
+    void rebuildLayout();    //! sorts the transforms by depth and parent index
+    void link(Handle transform, Handle parent);    //! adds the transform to the children of the parent
+    void unlink(Handle transform);    //! removes the transform from the children of its current parent
+    void updateRange(uint32_t first, uint32_t last);    //! updates world transforms of nodes [first, last) belonging to the same depth level
+
+private:
+    core::concurrency::AssetScheduler* m_scheduler_ptr;
+    std::vector<std::unique_ptr<RangeUpdateTask>> m_range_update_tasks;    //!< reused between depth levels and updates
+    std::vector<Slot> m_slots;
+    std::vector<Links> m_links;    //!< children of each slot, which allows to release transforms without looking for their children
+    std::vector<Handle> m_free_slots;
+
+    // the arrays below are indexed by position of the transform in the sorted order
+    std::vector<Handle> m_index_to_slot;
+    std::vector<Handle> m_parent_slots;
+    std::vector<uint32_t> m_parent_indices;    //!< positions of the parents, which are only valid while the layout is not dirty
+    std::vector<uint8_t> m_dirty_flags;
+    std::vector<core::math::Matrix4f> m_local_to_parent;
+    std::vector<core::math::Matrix4f> m_parent_to_local;
+    std::vector<core::math::Matrix4f> m_local_to_world;
+    std::vector<core::math::Matrix4f> m_world_to_local;
+
+    std::vector<uint32_t> m_level_offsets;    //!< depth level 'i' occupies positions [m_level_offsets[i], m_level_offsets[i + 1])
+    bool m_is_layout_dirty = false;
+    bool m_has_dirty_transforms = false;
+};
+
+}
+
+#endif
@@ -0,0 +1,295 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <glm/gtc/packing.hpp>
+
+#include "vertex_quantization.h"
+
+namespace lexgine::scenegraph
+{
+
+namespace
+{
+
+constexpr float c_max_half_value = 65504.f;
+
+enum class AttributeEncoding
+{
+    copy,
+    position,
+    normal,
+    tangent,
+    texture_coordinates
+};
+
+glm::vec2 signNotZero(glm::vec2 const& v)
+{
+    return glm::vec2{ v.x >= 0.f ? 1.f : -1.f, v.y >= 0.f ? 1.f : -1.f };
+}
+
+template<size_t element_count>
+std::array<float, element_count> readFloats(uint8_t const* p_source)
+{
+    std::array<float, element_count> rv{};
+    std::memcpy(rv.data(), p_source, sizeof(rv));
+    return rv;
+}
+
+bool isFloatAttribute(VertexAttributeLayout const& attribute, unsigned char element_count)
+{
+    return attribute.format == core::misc::DataFormat::float32 && attribute.element_count == element_count;
+}
+
+}    // namespace
+
+
+uint32_t dataFormatSize(core::misc::DataFormat format)
+{
+    switch (format)
+    {
+    case core::misc::DataFormat::float64:
+    case core::misc::DataFormat::int64:
+    case core::misc::DataFormat::uint64:
+        return 8;
+
+    case core::misc::DataFormat::float32:
+    case core::misc::DataFormat::int32:
+    case core::misc::DataFormat::uint32:
+        return 4;
+
+    case core::misc::DataFormat::float16:
+    case core::misc::DataFormat::int16:
+    case core::misc::DataFormat::uint16:
+        return 2;
+
+    case core::misc::DataFormat::int8:
+    case core::misc::DataFormat::uint8:
+        return 1;
+
+    default:
+        return 0;
+    }
+}
+
+PositionDequantization computePositionDequantization(glm::vec3 const& bounds_min, glm::vec3 const& bounds_max)
+{
+    return PositionDequantization{ .scale = bounds_max - bounds_min, .offset = bounds_min };
+}
+
+std::array<uint16_t, 4> quantizePosition(glm::vec3 const& position, PositionDequantization const& dequantization)
+{
+    std::array<uint16_t, 4> rv{};
+    for (int i = 0; i < 3; ++i)
+    {
+        // degenerate extent of the bounds means that all positions share the same coordinate, which is restored by the offset alone
+        rv[i] = dequantization.scale[i] > 0.f
+            ? glm::packUnorm1x16((position[i] - dequantization.offset[i]) / dequantization.scale[i])
+            : uint16_t{ 0 };
+    }
+    return rv;
+}
+
+glm::vec3 dequantizePosition(std::array<uint16_t, 4> const& quantized_position, PositionDequantization const& dequantization)
+{
+    glm::vec3 const normalized_position{
+        glm::unpackUnorm1x16(quantized_position[0]),
+        glm::unpackUnorm1x16(quantized_position[1]),
+        glm::unpackUnorm1x16(quantized_position[2])
+    };
+    return dequantization.offset + dequantization.scale * normalized_position;
+}
+
+std::array<int16_t, 2> encodeOctahedral(glm::vec3 const& unit_vector)
+{
+    float const l1_norm = std::abs(unit_vector.x) + std::abs(unit_vector.y) + std::abs(unit_vector.z);
+    if (l1_norm == 0.f) return { 0, 0 };
+
+    // project onto the octahedron and unfold its lower half onto the outer triangles of the square
+    glm::vec3 const p = unit_vector / l1_norm;
+    glm::vec2 e{ p.x, p.y };
+    if (p.z < 0.f)
+    {
+        e = (glm::vec2{ 1.f } - glm::abs(glm::vec2{ p.y, p.x })) * signNotZero(e);
+    }
+
+    // rounding each component independently is not always optimal, so all neighbouring encodings are tested. The candidates
+    // are compared by the angle to the original vector, since the cosine of such small angles is not distinguishable from 1 in floats
+    std::array<int16_t, 2> rv{};
+    float best_error{ std::numeric_limits<float>::infinity() };
+    float const x_candidates[2] = { std::floor(e.x * 32767.f), std::ceil(e.x * 32767.f) };
+    float const y_candidates[2] = { std::floor(e.y * 32767.f), std::ceil(e.y * 32767.f) };
+    for (float x : x_candidates)
+    {
+        for (float y : y_candidates)
+        {
+            std::array<int16_t, 2> const candidate{
+                static_cast<int16_t>(std::clamp(x, -32767.f, 32767.f)),
+                static_cast<int16_t>(std::clamp(y, -32767.f, 32767.f))
+            };
+            glm::vec3 const decoded_vector = decodeOctahedral(candidate);
+            float const error = std::atan2(glm::length(glm::cross(decoded_vector, unit_vector)), glm::dot(decoded_vector, unit_vector));
+            if (error < best_error)
+            {
+                best_error = error;
+                rv = candidate;
+            }
+        }
+    }
+    return rv;
+}
+
+glm::vec3 decodeOctahedral(std::array<int16_t, 2> const& encoded_vector)
+{
+    glm::vec2 const e{
+        glm::unpackSnorm1x16(static_cast<uint16_t>(encoded_vector[0])),
+        glm::unpackSnorm1x16(static_cast<uint16_t>(encoded_vector[1]))
+    };
+
+    glm::vec3 v{ e.x, e.y, 1.f - std::abs(e.x) - std::abs(e.y) };
+    if (v.z < 0.f)
+    {
+        glm::vec2 const folded = (glm::vec2{ 1.f } - glm::abs(glm::vec2{ v.y, v.x })) * signNotZero(glm::vec2{ v.x, v.y });
+        v.x = folded.x;
+        v.y = folded.y;
+    }
+    return glm::normalize(v);
+}
+
+PositionDequantization quantizeVertexAttributes(MeshData& mesh, std::vector<VertexAttributeLayout>& attributes)
+{
+    uint32_t const vertex_count = mesh.vertexCount();
+
+    // choose encoding of each attribute and lay the attributes out again keeping them aligned to 4 bytes
+    std::vector<AttributeEncoding> encodings(attributes.size(), AttributeEncoding::copy);
+    std::vector<VertexAttributeLayout> quantized_attributes = attributes;
+    uint32_t quantized_vertex_stride{ 0 };
+    for (size_t i = 0; i < attributes.size(); ++i)
+    {
+        VertexAttributeLayout const& attribute = attributes[i];
+        VertexAttributeLayout& quantized_attribute = quantized_attributes[i];
+
+        if (attribute.name == "POSITION" && isFloatAttribute(attribute, 3))
+        {
+            encodings[i] = AttributeEncoding::position;
+            quantized_attribute.format = core::misc::DataFormat::uint16;
+            quantized_attribute.element_count = 4;
+            quantized_attribute.is_normalized = true;
+        }
+        else if (attribute.name == "NORMAL" && isFloatAttribute(attribute, 3))
+        {
+            encodings[i] = AttributeEncoding::normal;
+            quantized_attribute.format = core::misc::DataFormat::int16;
+            quantized_attribute.element_count = 2;
+            quantized_attribute.is_normalized = true;
+        }
+        else if (attribute.name == "TANGENT" && isFloatAttribute(attribute, 4))
+        {
+            encodings[i] = AttributeEncoding::tangent;
+            quantized_attribute.format = core::misc::DataFormat::int16;
+            quantized_attribute.element_count = 4;
+            quantized_attribute.is_normalized = true;
+        }
+        else if (attribute.name.starts_with("TEXCOORD") && isFloatAttribute(attribute, 2))
+        {
+            bool fits_half_range{ true };
+            for (uint32_t v = 0; v < vertex_count && fits_half_range; ++v)
+            {
+                auto const uv = readFloats<2>(mesh.vertices.data() + static_cast<size_t>(v) * mesh.vertex_stride + attribute.offset);
+                fits_half_range = std::abs(uv[0]) <= c_max_half_value && std::abs(uv[1]) <= c_max_half_value;
+            }
+
+            if (fits_half_range)
+            {
+                encodings[i] = AttributeEncoding::texture_coordinates;
+                quantized_attribute.format = core::misc::DataFormat::float16;
+                quantized_attribute.is_normalized = false;
+            }
+        }
+
+        uint32_t const element_size = encodings[i] == AttributeEncoding::copy
+            ? dataFormatSize(attribute.format) * attribute.element_count
+            : dataFormatSize(quantized_attribute.format) * quantized_attribute.element_count;
+        quantized_attribute.offset = quantized_vertex_stride;
+        quantized_vertex_stride += static_cast<uint32_t>(core::misc::align(element_size, 4));
+    }
+
+    PositionDequantization dequantization{};
+    auto const position = std::find(encodings.begin(), encodings.end(), AttributeEncoding::position);
+    if (position != encodings.end() && vertex_count > 0)
+    {
+        uint32_t const position_offset = attributes[position - encodings.begin()].offset;
+        glm::vec3 bounds_min{ std::numeric_limits<float>::max() }, bounds_max{ std::numeric_limits<float>::lowest() };
+        for (uint32_t v = 0; v < vertex_count; ++v)
+        {
+            auto const p = readFloats<3>(mesh.vertices.data() + static_cast<size_t>(v) * mesh.vertex_stride + position_offset);
+            bounds_min = glm::min(bounds_min, glm::vec3{ p[0], p[1], p[2] });
+            bounds_max = glm::max(bounds_max, glm::vec3{ p[0], p[1], p[2] });
+        }
+        dequantization = computePositionDequantization(bounds_min, bounds_max);
+    }
+
+    std::vector<uint8_t> quantized_vertices(static_cast<size_t>(vertex_count) * quantized_vertex_stride, 0);
+    for (uint32_t v = 0; v < vertex_count; ++v)
+    {
+        uint8_t const* p_source_vertex = mesh.vertices.data() + static_cast<size_t>(v) * mesh.vertex_stride;
+        uint8_t* p_destination_vertex = quantized_vertices.data() + static_cast<size_t>(v) * quantized_vertex_stride;
+        for (size_t i = 0; i < attributes.size(); ++i)
+        {
+            uint8_t const* p_source = p_source_vertex + attributes[i].offset;
+            uint8_t* p_destination = p_destination_vertex + quantized_attributes[i].offset;
+            switch (encodings[i])
+            {
+            case AttributeEncoding::copy:
+                std::memcpy(p_destination, p_source, dataFormatSize(attributes[i].format) * attributes[i].element_count);
+                break;
+
+            case AttributeEncoding::position:
+            {
+                auto const p = readFloats<3>(p_source);
+                auto const encoded_position = quantizePosition(glm::vec3{ p[0], p[1], p[2] }, dequantization);
+                std::memcpy(p_destination, encoded_position.data(), sizeof(encoded_position));
+                break;
+            }
+
+            case AttributeEncoding::normal:
+            {
+                auto const n = readFloats<3>(p_source);
+                auto const encoded_normal = encodeOctahedral(glm::vec3{ n[0], n[1], n[2] });
+                std::memcpy(p_destination, encoded_normal.data(), sizeof(encoded_normal));
+                break;
+            }
+
+            case AttributeEncoding::tangent:
+            {
+                auto const t = readFloats<4>(p_source);
+                auto const encoded_direction = encodeOctahedral(glm::vec3{ t[0], t[1], t[2] });
+                std::array<int16_t, 4> const encoded_tangent{ encoded_direction[0], encoded_direction[1], static_cast<int16_t>(t[3] < 0.f ? -32767 : 32767), 0 };
+                std::memcpy(p_destination, encoded_tangent.data(), sizeof(encoded_tangent));
+                break;
+            }
+
+            case AttributeEncoding::texture_coordinates:
+            {
+                auto const uv = readFloats<2>(p_source);
+                std::array<uint16_t, 2> const encoded_uv{ glm::packHalf1x16(uv[0]), glm::packHalf1x16(uv[1]) };
+                std::memcpy(p_destination, encoded_uv.data(), sizeof(encoded_uv));
+                break;
+            }
+            }
+        }
+    }
+
+    if (position != encodings.end())
+    {
+        mesh.position_offset = quantized_attributes[position - encodings.begin()].offset;
+    }
+    mesh.vertices.swap(quantized_vertices);
+    mesh.vertex_stride = quantized_vertex_stride;
+    attributes.swap(quantized_attributes);
+
+    return dequantization;
+}
+
+}
@@ -0,0 +1,60 @@
+#ifndef LEXGINE_SCENEGRAPH_VERTEX_QUANTIZATION_H
+#define LEXGINE_SCENEGRAPH_VERTEX_QUANTIZATION_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "engine/core/misc/misc.h"
+#include "mesh_optimizer.h"
+
+namespace lexgine::scenegraph {
+
+//! Layout of a vertex attribute stored in interleaved vertex data
+struct VertexAttributeLayout
+{
+    std::string name;    //!< name of the attribute as defined by glTF
+    core::misc::DataFormat format;
+    unsigned char element_count;
+    bool is_normalized;
+    uint32_t offset;    //!< offset of the attribute from the beginning of the vertex
+};
+
+//! Affine transform restoring positions from their normalized 16-bit representation q as offset + scale * q
+struct PositionDequantization
+{
+    glm::vec3 scale{ 1.f };
+    glm::vec3 offset{ 0.f };
+};
+
+
+//! Returns size of a single element of the given format in bytes or 0 if the format is unknown
+uint32_t dataFormatSize(core::misc::DataFormat format);
+
+//! Returns dequantization mapping the bounding box of the positions onto the unit cube
+PositionDequantization computePositionDequantization(glm::vec3 const& bounds_min, glm::vec3 const& bounds_max);
+
+//! Encodes position into 16-bit normalized integers. The fourth component is padding, since DXGI has no 3-component 16-bit formats
+std::array<uint16_t, 4> quantizePosition(glm::vec3 const& position, PositionDequantization const& dequantization);
+glm::vec3 dequantizePosition(std::array<uint16_t, 4> const& quantized_position, PositionDequantization const& dequantization);
+
+/*! Encodes unit vector into two 16-bit signed normalized integers using octahedral mapping (Q. Meyer et al., "On Floating-Point
+ Normal Vectors"). Of the neighbouring encodings the one decoding into the vector closest to the original is chosen
+*/
+std::array<int16_t, 2> encodeOctahedral(glm::vec3 const& unit_vector);
+glm::vec3 decodeOctahedral(std::array<int16_t, 2> const& encoded_vector);
+
+/*! Re-encodes interleaved vertices into compact formats: positions become 16-bit normalized integers relative to the bounds
+ of the mesh, normals and tangents are octahedral encoded into 16-bit signed normalized integers (the handedness of the tangent
+ frame is kept in the third component), and texture coordinates are converted to half precision when they fit into its range.
+ Other attributes are copied as is. The layouts of the attributes are updated accordingly. Since positions are no longer stored
+ as floats afterwards, quantization must be the last step of mesh processing. Returns dequantization of the positions
+*/
+PositionDequantization quantizeVertexAttributes(MeshData& mesh, std::vector<VertexAttributeLayout>& attributes);
+
+}
+
+#endif
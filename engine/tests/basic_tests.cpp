@@ -1,14 +1,29 @@
 #include <sstream>
+#include <iomanip>
 #include <windows.h>
 #include <utility>
+#include <tuple>
 #include <fstream>
 #include <chrono>
 #include <random>
 #include <set>
+#include <map>
 #include <unordered_set>
 #include <filesystem>
+#include <functional>
+#include <future>
+#include <barrier>
+#include <algorithm>
+#include <numeric>
+#include <format>
+#include <cstdlib>
+#include <cassert>
+#include <thread>
 
 #include <gtest/gtest.h>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/packing.hpp>
 
 #include <engine/core/misc/log.h>
 #include <engine/osinteraction/windows/window.h>
@@ -16,7 +31,10 @@
 #include <engine/core/concurrency/task_graph.h>
 #include <engine/core/concurrency/task_sink.h>
 #include <engine/core/concurrency/schedulable_task.h>
+#include <engine/core/concurrency/asset_scheduler.h>
 #include <engine/core/misc/misc.h>
+#include <engine/core/globals.h>
+#include <engine/core/global_settings.h>
 #include <engine/core/exception.h>
 #include <engine/initializer.h>
 #include <engine/core/dx/d3d12_initializer.h>
@@ -31,11 +49,62 @@
 #include <engine/core/dx/d3d12/task_caches/combined_cache_key.h>
 #include <engine/core/dx/d3d12/tasks/root_signature_compilation_task.h>
 #include <engine/core/dx/d3d12/task_caches/root_signature_compilation_task_cache.h>
+#include <engine/core/dx/d3d12/constant_data_cache.h>
+#include <engine/core/dx/d3d12/constant_buffer_data_mapper.h>
+#include <engine/core/dx/d3d12/upload_buffer_allocator.h>
+#include <engine/core/dx/d3d12/resource_upload_planner.h>
+#include <engine/core/dx/d3d12/descriptor_range_allocator.h>
+#include <engine/core/dx/d3d12/descriptor_cache.h>
+#include <engine/core/dx/d3d12/resource_state_tracker.h>
+#include <engine/core/dx/d3d12/transient_resource_aliasing_planner.h>
+#include <engine/core/dx/d3d12/render_graph.h>
+#include <engine/core/dx/d3d12/command_stream.h>
+#include <engine/core/dx/d3d12/command_list_state_cache.h>
+#include <engine/core/dx/d3d12/basic_rendering_services.h>
 
 #include <engine/core/misc/uuid.h>
+#include <engine/core/misc/sha256.h>
+#include <engine/conversion/texture_residency_manager.h>
+#include <engine/conversion/ktx2_level_stream.h>
+#include <engine/scenegraph/node.h>
+#include <engine/scenegraph/camera.h>
+#include <engine/scenegraph/bounding_volume_hierarchy.h>
+#include <engine/scenegraph/scene_memory_upload_plan.h>
+#include <engine/scenegraph/mesh_optimizer.h>
+#include <engine/scenegraph/vertex_quantization.h>
+#include <engine/scenegraph/meshlet_builder.h>
+#include <engine/scenegraph/render_list.h>
+#include <engine/scenegraph/baked_scene.h>
+#include <engine/scenegraph/transform_hierarchy.h>
+#include <engine/scenegraph/scene.h>
 #include <engine/interaction/console_command.h>
 
 
+/*! Returns storage of the addresses standing in for objects of type T in the tests, which only store and compare addresses of the objects without
+ accessing them. Distinct identifiers map onto distinct addresses inside of a static buffer, so that the addresses are valid pointers
+*/
+template<typename T>
+uint8_t const* fakeObjectStorage()
+{
+    alignas(64) static uint8_t const storage[64 * 64]{};
+    return storage;
+}
+
+template<typename T>
+T const* fakeObject(uint32_t id)
+{
+    assert(id < 64);
+    return reinterpret_cast<T const*>(fakeObjectStorage<T>() + 64 * id);
+}
+
+//! Returns identifier of the fake object
+template<typename T>
+uint32_t fakeObjectId(T const* p_object)
+{
+    return static_cast<uint32_t>((reinterpret_cast<uint8_t const*>(p_object) - fakeObjectStorage<T>()) / 64);
+}
+
+
 class TestErrorBehavioral
 {
 public:
@@ -452,6 +521,466 @@ TEST(EngineTests_Concurrency, TestTaskScheuling)
 }
 
 
+TEST(EngineTests_Concurrency, TestAssetScheduler)
+{
+    using namespace lexgine::core::concurrency;
+    using namespace lexgine::core::misc;
+
+    std::filesystem::path test_logging_path = std::filesystem::current_path() / "test.log";
+    Log::create(test_logging_path, "Test Asset Scheduler", LogMessageType::information);
+
+    class StubAssemblyTask : public SchedulableTask
+    {
+    public:
+        StubAssemblyTask(std::string const& debug_name, std::function<bool(StubAssemblyTask&)> const& work) :
+            SchedulableTask{ debug_name },
+            m_work{ work }
+        {
+
+        }
+
+        void fail() { raiseError("stub task failure"); }
+
+    private:
+        bool doTask(uint8_t worker_id, uint64_t user_data) override
+        {
+            return m_work(*this);
+        }
+
+        TaskType type() const override
+        {
+            return TaskType::cpu;
+        }
+
+        std::function<bool(StubAssemblyTask&)> m_work;
+    };
+
+    {
+        AssetScheduler scheduler{ 1, "TestAssetScheduler" };
+
+        // the only worker is held by the gate task, while the test queues more jobs
+        std::atomic_bool is_gate_entered{ false };
+        std::atomic_bool is_gate_open{ false };
+        StubAssemblyTask gate{ "Gate", [&](StubAssemblyTask&)
+            {
+                is_gate_entered.store(true, std::memory_order_release);
+                while (!is_gate_open.load(std::memory_order_acquire)) std::this_thread::yield();
+                return true;
+            } };
+        auto close_gate = [&]()
+        {
+            is_gate_entered.store(false, std::memory_order_release);
+            is_gate_open.store(false, std::memory_order_release);
+            std::shared_ptr<AssetJob> gate_job = scheduler.submit({ &gate });
+            while (!is_gate_entered.load(std::memory_order_acquire)) std::this_thread::yield();
+            return gate_job;
+        };
+
+        // jobs are dispatched in the order of their priorities, and in the order of submission within the same priority
+        {
+            std::vector<std::string> execution_order{};
+            auto record_execution = [&execution_order](StubAssemblyTask& task) { execution_order.push_back(task.getStringName()); return true; };
+            StubAssemblyTask l0{ "L0", record_execution }, l1{ "L1", record_execution };
+            StubAssemblyTask n0{ "N0", record_execution };
+            StubAssemblyTask h0{ "H0", record_execution }, h1{ "H1", record_execution };
+
+            std::shared_ptr<AssetJob> gate_job = close_gate();
+            std::shared_ptr<AssetJob> low_priority_job = scheduler.submit({ &l0, &l1 }, AssetJobPriority::low);
+            std::shared_ptr<AssetJob> normal_priority_job = scheduler.submit({ &n0 }, AssetJobPriority::normal);
+            std::shared_ptr<AssetJob> high_priority_job = scheduler.submit({ &h0, &h1 }, AssetJobPriority::high);
+            EXPECT_EQ(scheduler.queuedTaskCount(), 5U);
+            EXPECT_FALSE(low_priority_job->isFinished());
+            is_gate_open.store(true, std::memory_order_release);
+
+            for (auto const& job : { gate_job, low_priority_job, normal_priority_job, high_priority_job })
+            {
+                job->wait();
+                EXPECT_TRUE(job->isFinished());
+                EXPECT_FALSE(job->hasFailed());
+            }
+            EXPECT_EQ(execution_order, (std::vector<std::string>{ "H0", "H1", "N0", "L0", "L1" }));
+        }
+
+        // cancelled jobs drop the tasks that have not been started yet
+        {
+            std::atomic_uint32_t execution_count{ 0U };
+            std::vector<std::unique_ptr<StubAssemblyTask>> tasks{};
+            std::vector<AbstractTask*> job_tasks{};
+            for (int i = 0; i < 100; ++i)
+            {
+                tasks.push_back(std::make_unique<StubAssemblyTask>("Cancelled" + std::to_string(i),
+                    [&execution_count](StubAssemblyTask&) { ++execution_count; return true; }));
+                job_tasks.push_back(tasks.back().get());
+            }
+
+            std::shared_ptr<AssetJob> gate_job = close_gate();
+            std::shared_ptr<AssetJob> cancelled_job = scheduler.submit(job_tasks);
+            EXPECT_EQ(cancelled_job->pendingTaskCount(), 100U);
+            cancelled_job->cancel();
+            is_gate_open.store(true, std::memory_order_release);
+
+            cancelled_job->wait();
+            gate_job->wait();
+            EXPECT_TRUE(cancelled_job->isCancelled());
+            EXPECT_FALSE(cancelled_job->hasFailed());
+            EXPECT_EQ(execution_count.load(), 0U);
+            EXPECT_EQ(scheduler.queuedTaskCount(), 0U);
+        }
+
+        // tasks returning 'false' are re-queued, and task graph dependencies are respected
+        {
+            uint32_t attempts{ 0U };
+            std::vector<std::string> execution_order{};
+            StubAssemblyTask dependency{ "Dependency", [&](StubAssemblyTask& task) { ++attempts; execution_order.push_back(task.getStringName()); return attempts == 3; } };
+            StubAssemblyTask dependent{ "Dependent", [&](StubAssemblyTask& task) { execution_order.push_back(task.getStringName()); return true; } };
+            dependent.addDependency(dependency);
+
+            std::shared_ptr<AssetJob> job = scheduler.submit({ &dependent, &dependency });
+            job->wait();
+            EXPECT_FALSE(job->hasFailed());
+            EXPECT_EQ(attempts, 3U);
+            EXPECT_EQ(execution_order, (std::vector<std::string>{ "Dependency", "Dependency", "Dependency", "Dependent" }));
+        }
+
+        // deferred tasks are woken when their dependencies get completed outside of the scheduler, and dropped once their job is cancelled
+        {
+            bool is_dependent_executed{ false };
+            StubAssemblyTask external_dependency{ "ExternalDependency", [](StubAssemblyTask&) { return true; } };
+            StubAssemblyTask dependent{ "Dependent", [&](StubAssemblyTask&) { is_dependent_executed = true; return true; } };
+            dependent.addDependency(external_dependency);
+
+            std::shared_ptr<AssetJob> job = scheduler.submit({ &dependent });
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 10 });    // lets the worker park the dependent task
+            EXPECT_FALSE(is_dependent_executed);
+            EXPECT_EQ(scheduler.queuedTaskCount(), 1U);
+            EXPECT_TRUE(external_dependency.TaskGraphNode::execute(0));    // completed on the test thread
+            scheduler.wakeDeferredTasks();
+            job->wait();
+            EXPECT_TRUE(is_dependent_executed);
+
+            bool is_orphan_executed{ false };
+            StubAssemblyTask never_completed{ "NeverCompleted", [](StubAssemblyTask&) { return true; } };
+            StubAssemblyTask orphan{ "Orphan", [&](StubAssemblyTask&) { is_orphan_executed = true; return true; } };
+            orphan.addDependency(never_completed);
+
+            job = scheduler.submit({ &orphan });
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 10 });
+            job->cancel();
+            job->wait();
+            EXPECT_TRUE(job->isCancelled());
+            EXPECT_FALSE(is_orphan_executed);
+            EXPECT_EQ(scheduler.queuedTaskCount(), 0U);
+        }
+
+        // failure of a task drops the remaining tasks of its job, but does not affect other jobs
+        {
+            bool is_dropped_task_executed{ false };
+            bool is_independent_task_executed{ false };
+            StubAssemblyTask failing{ "Failing", [](StubAssemblyTask& task) { task.fail(); return true; } };
+            StubAssemblyTask dropped{ "Dropped", [&](StubAssemblyTask&) { is_dropped_task_executed = true; return true; } };
+            StubAssemblyTask independent{ "Independent", [&](StubAssemblyTask&) { is_independent_task_executed = true; return true; } };
+
+            std::shared_ptr<AssetJob> gate_job = close_gate();
+            std::shared_ptr<AssetJob> failing_job = scheduler.submit({ &failing, &dropped });
+            std::shared_ptr<AssetJob> independent_job = scheduler.submit({ &independent });
+            is_gate_open.store(true, std::memory_order_release);
+
+            failing_job->wait();
+            independent_job->wait();
+            gate_job->wait();
+            EXPECT_TRUE(failing_job->hasFailed());
+            EXPECT_EQ(failing_job->failedTask(), static_cast<AbstractTask const*>(&failing));
+            EXPECT_FALSE(is_dropped_task_executed);
+            EXPECT_FALSE(independent_job->hasFailed());
+            EXPECT_TRUE(is_independent_task_executed);
+        }
+    }
+
+    // throughput of the scheduler shared by several concurrent scene loads, each submitting stub material assembly tasks
+    {
+        uint32_t const scene_count = 8U;
+        uint32_t const materials_per_scene = 256U;
+
+        AssetScheduler scheduler{ 4, "TestAssetSchedulerThroughput" };
+        std::atomic_uint64_t checksum{ 0U };
+        std::vector<std::unique_ptr<StubAssemblyTask>> tasks{};
+        std::vector<std::vector<AbstractTask*>> scene_tasks(scene_count);
+        for (uint32_t i = 0; i < scene_count * materials_per_scene; ++i)
+        {
+            tasks.push_back(std::make_unique<StubAssemblyTask>("Material" + std::to_string(i), [&checksum, i](StubAssemblyTask&)
+                {
+                    uint64_t hash = i;
+                    for (int j = 0; j < 1000; ++j) hash = hash * 6364136223846793005ULL + 1442695040888963407ULL;
+                    checksum.fetch_add(hash % 1000 + 1, std::memory_order_relaxed);
+                    return true;
+                }));
+            scene_tasks[i % scene_count].push_back(tasks.back().get());
+        }
+
+        auto const start_time = std::chrono::steady_clock::now();
+        std::vector<std::future<std::shared_ptr<AssetJob>>> scene_loads{};
+        for (uint32_t i = 0; i < scene_count; ++i)
+        {
+            scene_loads.push_back(std::async(std::launch::async, [&scheduler, &scene_tasks, i]() { return scheduler.submit(scene_tasks[i]); }));
+        }
+        for (auto& scene_load : scene_loads)
+        {
+            std::shared_ptr<AssetJob> job = scene_load.get();
+            job->wait();
+            EXPECT_FALSE(job->hasFailed());
+        }
+        auto const elapsed_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time);
+
+        uint64_t expected_checksum{ 0U };
+        for (uint32_t i = 0; i < scene_count * materials_per_scene; ++i)
+        {
+            uint64_t hash = i;
+            for (int j = 0; j < 1000; ++j) hash = hash * 6364136223846793005ULL + 1442695040888963407ULL;
+            expected_checksum += hash % 1000 + 1;
+        }
+        EXPECT_EQ(checksum.load(), expected_checksum);
+
+        Log::retrieve()->out("Asset scheduler executed " + std::to_string(tasks.size()) + " stub material assembly tasks in "
+            + std::to_string(elapsed_time.count()) + "us", LogMessageType::information);
+    }
+
+    Log::shutdown();
+}
+
+TEST(EngineTests_Concurrency, TestUploadDataAllocator)
+{
+    using namespace lexgine::core;
+    using namespace lexgine::core::dx::d3d12;
+
+    std::filesystem::path test_logging_path = std::filesystem::current_path() / "test.log";
+    Log::create(test_logging_path, "Test Upload Data Allocator", LogMessageType::information);
+
+    {
+        // emulates upload buffer controlled by a fence, which is signaled by the "GPU" thread
+        class MockFenceUploadDataAllocator final : public UploadDataAllocator
+        {
+        public:
+            MockFenceUploadDataAllocator(std::vector<uint8_t>& upload_memory)
+                : UploadDataAllocator{ upload_memory.data(), 0x100000000, upload_memory.size(), 1U }
+            {
+            }
+
+            void submit() { m_next_value.fetch_add(1, std::memory_order_acq_rel); }
+
+            void signal(uint64_t value)
+            {
+                m_last_signaled_value.store(value, std::memory_order_release);
+                m_last_signaled_value.notify_all();
+            }
+
+        private:
+            void waitUntilControllingSignalValue(uint64_t value) const override
+            {
+                for (uint64_t v = m_last_signaled_value.load(std::memory_order_acquire); v < value; v = m_last_signaled_value.load(std::memory_order_acquire))
+                {
+                    m_last_signaled_value.wait(v, std::memory_order_acquire);
+                }
+            }
+
+            bool waitUntilControllingSignalValue(uint64_t value, uint32_t timeout_in_milliseconds) const override
+            {
+                auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds{ timeout_in_milliseconds };
+                while (m_last_signaled_value.load(std::memory_order_acquire) < value)
+                {
+                    if (std::chrono::steady_clock::now() >= deadline) return false;
+                    std::this_thread::yield();
+                }
+                return true;
+            }
+
+            uint64_t nextValueOfControllingSignal() const override { return m_next_value.load(std::memory_order_acquire); }
+            uint64_t lastSignaledValueOfControllingSignal() const override { return m_last_signaled_value.load(std::memory_order_acquire); }
+            uint64_t lastRecordedValueOfControllingSignal() const override { return m_next_value.load(std::memory_order_acquire) - 1; }
+
+        private:
+            std::atomic_uint64_t m_next_value{ 1U };
+            std::atomic_uint64_t m_last_signaled_value{ 0U };
+        };
+
+        uint32_t const chunk_size = UploadDataAllocator::c_chunk_size;
+
+        {
+            std::vector<uint8_t> upload_memory(4 * chunk_size);
+            MockFenceUploadDataAllocator allocator{ upload_memory };
+            EXPECT_EQ(allocator.getPartitionsCount(), 4U);
+
+            // small allocations made by the same thread are packed into the same chunk
+            auto a = allocator.allocate(100);
+            auto b = allocator.allocate(300);
+            ASSERT_TRUE(a && b);
+            EXPECT_EQ(a->offset() % UploadDataAllocator::c_allocation_alignment, 0U);
+            EXPECT_EQ(a->capacity(), 256U);
+            EXPECT_EQ(b->offset(), a->offset() + 256U);
+            EXPECT_EQ(b->capacity(), 512U);
+            EXPECT_EQ(b->virtualGpuAddress(), 0x100000000 + b->offset());
+            EXPECT_EQ(b->cpuAddress(), upload_memory.data() + b->offset());
+            EXPECT_TRUE(a->isInUse());
+            EXPECT_EQ(allocator.getUnpartitionedCapacity(), 3U * chunk_size);
+
+            // large allocations receive dedicated chunks
+            auto c = allocator.allocate(chunk_size + 1);
+            ASSERT_TRUE(c);
+            EXPECT_EQ(c->offset() % chunk_size, 0U);
+            EXPECT_EQ(c->capacity(), chunk_size + 256U);
+            EXPECT_TRUE(c->offset() >= b->offset() + b->capacity() || c->offset() + c->capacity() <= a->offset());
+
+            // the chunks used by the work being recorded cannot be reclaimed
+            EXPECT_FALSE(allocator.allocate(2 * chunk_size, false));
+            EXPECT_FALSE(allocator.allocate(5 * chunk_size, false));
+
+            allocator.submit();
+            EXPECT_FALSE(allocator.allocate(2 * chunk_size, false));
+            allocator.signal(1);
+            EXPECT_FALSE(a->isInUse());
+
+            auto d = allocator.allocate(2 * chunk_size, false);
+            ASSERT_TRUE(d);
+            EXPECT_EQ(d->offset() % chunk_size, 0U);
+            EXPECT_TRUE(d->isInUse());
+
+            // new work never continues filling the chunk that has been used by the previous work
+            auto e = allocator.allocate(16);
+            ASSERT_TRUE(e);
+            EXPECT_EQ(e->offset() % chunk_size, 0U);
+        }
+
+        // the "GPU" thread verifies the data uploaded by the recording threads before it signals completion of the work,
+        // which allows to detect the cases when the memory still in use gets handed out to another thread
+        uint32_t const recording_thread_count = 8U;
+        uint32_t const frame_count = 64U;
+        uint32_t const allocations_per_thread = 48U;
+
+        std::vector<uint8_t> upload_memory(64 * chunk_size);
+        MockFenceUploadDataAllocator allocator{ upload_memory };
+
+        struct UploadedData
+        {
+            uint32_t* p_data;
+            size_t word_count;
+            uint32_t tag;
+        };
+        std::mutex uploads_access_semaphore;
+        std::vector<std::vector<UploadedData>> uploads(frame_count + 1);
+        std::atomic_uint64_t last_submitted_value{ 0U };
+        std::atomic_uint32_t corrupted_upload_count{ 0U };
+        std::atomic_uint32_t failed_allocation_count{ 0U };
+
+        std::thread gpu_thread{ [&]()
+            {
+                for (uint64_t value = 1; value <= frame_count; ++value)
+                {
+                    while (last_submitted_value.load(std::memory_order_acquire) < value) std::this_thread::yield();
+                    std::this_thread::sleep_for(std::chrono::microseconds{ 200 });
+
+                    std::lock_guard<std::mutex> lock{ uploads_access_semaphore };
+                    for (UploadedData const& upload : uploads[value])
+                    {
+                        if (std::any_of(upload.p_data, upload.p_data + upload.word_count, [&upload](uint32_t word) { return word != upload.tag; }))
+                        {
+                            ++corrupted_upload_count;
+                        }
+                    }
+                    allocator.signal(value);
+                }
+            }
+        };
+
+        auto record = [&](uint32_t thread_index, uint64_t value)
+        {
+            std::mt19937 rng{ static_cast<uint32_t>(value * recording_thread_count + thread_index) };
+            std::vector<UploadedData> recorded_uploads;
+            for (uint32_t i = 0; i < allocations_per_thread; ++i)
+            {
+                size_t size = (i % 16 == 15) ? std::uniform_int_distribution<size_t>{ chunk_size / 4 + 1, 2 * chunk_size }(rng)
+                    : std::uniform_int_distribution<size_t>{ 4, 2048 }(rng);
+                auto allocation = allocator.allocate(size);
+                if (!allocation)
+                {
+                    ++failed_allocation_count;
+                    continue;
+                }
+
+                UploadedData upload{ static_cast<uint32_t*>(allocation->cpuAddress()), size / 4,
+                    static_cast<uint32_t>(value << 16 | thread_index << 8 | i) };
+                std::fill(upload.p_data, upload.p_data + upload.word_count, upload.tag);
+                recorded_uploads.push_back(upload);
+            }
+
+            std::lock_guard<std::mutex> lock{ uploads_access_semaphore };
+            uploads[value].insert(uploads[value].end(), recorded_uploads.begin(), recorded_uploads.end());
+        };
+
+        for (uint64_t value = 1; value <= frame_count; ++value)
+        {
+            std::vector<std::thread> recording_threads;
+            for (uint32_t i = 0; i < recording_thread_count; ++i)
+            {
+                recording_threads.emplace_back(record, i, value);
+            }
+            for (std::thread& t : recording_threads)
+            {
+                t.join();
+            }
+
+            allocator.submit();
+            last_submitted_value.store(value, std::memory_order_release);
+        }
+        gpu_thread.join();
+
+        EXPECT_EQ(failed_allocation_count, 0U);
+        EXPECT_EQ(corrupted_upload_count, 0U);
+        EXPECT_EQ(allocator.completedWork(), frame_count);
+
+        // allocation throughput, the uploads are retired right after each round of recording so that the benchmark measures the allocator alone
+        for (uint32_t thread_count : { 1U, recording_thread_count })
+        {
+            uint32_t const round_count = 256U;
+            uint32_t const allocations_per_round = 256U;
+            std::barrier round_barrier{ static_cast<std::ptrdiff_t>(thread_count), [&allocator]() noexcept
+                {
+                    allocator.submit();
+                    allocator.signal(allocator.scheduledWork());
+                }
+            };
+
+            auto start = std::chrono::high_resolution_clock::now();
+            std::vector<std::thread> threads;
+            for (uint32_t i = 0; i < thread_count; ++i)
+            {
+                threads.emplace_back([&]()
+                    {
+                        for (uint32_t round = 0; round < round_count; ++round)
+                        {
+                            for (uint32_t j = 0; j < allocations_per_round; ++j)
+                            {
+                                if (!allocator.allocate(256)) ++failed_allocation_count;
+                            }
+                            round_barrier.arrive_and_wait();
+                        }
+                    });
+            }
+            for (std::thread& t : threads)
+            {
+                t.join();
+            }
+            auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - start);
+
+            EXPECT_EQ(failed_allocation_count, 0U);
+            double allocations_per_microsecond = 1e3 * thread_count * round_count * allocations_per_round / duration.count();
+            Log::retrieve()->out(misc::formatString("Upload data allocator throughput with %i recording threads: %f allocations per microsecond",
+                thread_count, allocations_per_microsecond), LogMessageType::information);
+        }
+    }
+
+    Log::shutdown();
+}
+
+
 TEST(EngineTests_gpu, TestD3D12PSOXMLParser)
 {
     using namespace lexgine;
@@ -827,70 +1356,3045 @@ TEST(EngineTests_Basic, TestUuid)
     EXPECT_TRUE(uuid1.hiPart() == 0xabcdef1234567890);
 }
 
-class ConsoleCommandTest : public LogTestBase
+TEST(EngineTests_Basic, TestSha256)
 {
-public:
-    ConsoleCommandTest()
-        : LogTestBase{ "ConsoleCommandTest" }
+    using namespace lexgine::core::misc;
+
+    auto to_hex = [](Sha256::Digest const& digest)
+        {
+            std::stringstream ss{};
+            for (uint8_t b : digest) ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(b);
+            return ss.str();
+        };
+
+    std::string const abc{ "abc" };
+    EXPECT_EQ(to_hex(Sha256::hash(std::span<uint8_t const>{ reinterpret_cast<uint8_t const*>(abc.data()), abc.size() })),
+        "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    EXPECT_EQ(to_hex(Sha256::hash(std::span<uint8_t const>{})),
+        "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+
+    // Streaming in chunks that are not aligned with the block size must produce the same result as hashing all data at once
+    std::string const million_a(1000000, 'a');
+    Sha256 streaming_context{};
+    for (size_t offset = 0; offset < million_a.size(); offset += 777)
     {
+        streaming_context.update(million_a.data() + offset, (std::min)(size_t{ 777 }, million_a.size() - offset));
     }
-};
+    EXPECT_EQ(to_hex(streaming_context.finalize()), "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
 
-TEST_F(ConsoleCommandTest, TestConsoleCommandParsing)
+    std::filesystem::path test_file_path = std::filesystem::current_path() / "test_sha256.bin";
+    {
+        std::ofstream ofile{ test_file_path, std::ios::binary | std::ios::trunc };
+        ofile.write(million_a.data(), million_a.size());
+    }
+    auto file_hash = Sha256::hashFile(test_file_path);
+    ASSERT_TRUE(file_hash.isValid());
+    EXPECT_EQ(to_hex(*file_hash), "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+    std::filesystem::remove(test_file_path);
+}
+
+TEST(EngineTests_Basic, TestTextureResidencyManager)
 {
-    using namespace lexgine::interaction::console;
+    using namespace lexgine;
 
-    CommandRegistry registry{};
-    registry.addNamespace("ns", "test namespace");
+    struct StubMipmapUploader : public conversion::TextureMipmapUploader
+    {
+        std::vector<std::tuple<uint64_t, uint32_t, uint32_t>> uploads;
+        std::vector<std::tuple<uint64_t, uint32_t>> releases;
 
-    CommandSpec spec{};
-    spec.name = "testcmd";
-    spec.summary = "test command";
-    spec.args = {
-        { "x", "first arg", value_parsers::int_parser, std::nullopt },
-        { "y", "second arg", value_parsers::int_parser, std::nullopt },
-        { "z", "third arg", value_parsers::int_parser, std::nullopt }
-    };
+        bool uploadMipmapLevels(core::misc::UUID const& texture_uuid, uint32_t first_level, uint32_t level_count) override
+        {
+            uploads.emplace_back(texture_uuid.loPart(), first_level, level_count);
+            return true;
+        }
 
-    registry.addCommand("ns", spec, [](ArgMap const&) -> CommandExecResult
+        void releaseMipmapLevels(core::misc::UUID const& texture_uuid, uint32_t first_level, uint32_t level_count) override
         {
-            return { true, "" };
-        });
+            for (uint32_t level = first_level; level < first_level + level_count; ++level) releases.emplace_back(texture_uuid.loPart(), level);
+        }
+    } uploader{};
+
+    // 4 mipmap levels: the tail budget of 100 bytes makes the two least detailed levels resident on registration
+    std::vector<uint64_t> const mipmap_level_sizes{ 640, 160, 40, 10 };
+    conversion::TextureResidencyManager residency_manager{ uploader, 1000, 100, 10000 };
+
+    core::misc::UUID const a{ 1, 0 }, b{ 2, 0 };
+    ASSERT_TRUE(residency_manager.registerTexture(a, mipmap_level_sizes));
+    ASSERT_TRUE(residency_manager.registerTexture(b, mipmap_level_sizes));
+    EXPECT_EQ(residency_manager.residentMostDetailedLevel(a), 2U);
+    EXPECT_EQ(residency_manager.residentMemory(), 100U);
+    ASSERT_EQ(uploader.uploads.size(), 2U);
+    EXPECT_EQ(uploader.uploads[0], std::make_tuple(uint64_t{ 1 }, 2U, 2U));
+
+    // full chain of 'a' fits into the memory budget
+    residency_manager.requestMipmapLevel(a, 0, 1.f);
+    residency_manager.update();
+    EXPECT_EQ(residency_manager.residentMostDetailedLevel(a), 0U);
+    EXPECT_EQ(residency_manager.residentMemory(), 900U);
+
+    // 'b' has lower priority than 'a', which is still in use, so 'b' can only grow within the remaining budget
+    residency_manager.requestMipmapLevel(a, 0, 1.f);
+    residency_manager.requestMipmapLevel(b, 0, .5f);
+    residency_manager.update();
+    EXPECT_EQ(residency_manager.residentMostDetailedLevel(a), 0U);
+    EXPECT_EQ(residency_manager.residentMostDetailedLevel(b), 2U);
+    EXPECT_TRUE(uploader.releases.empty());
+
+    // once 'a' is no longer requested it becomes the least recently used texture and gets demoted in favor of 'b'
+    residency_manager.requestMipmapLevel(b, 0, .5f);
+    residency_manager.update();
+    EXPECT_EQ(residency_manager.residentMostDetailedLevel(b), 0U);
+    EXPECT_EQ(residency_manager.residentMostDetailedLevel(a), 2U);
+    EXPECT_EQ(uploader.releases, (std::vector<std::tuple<uint64_t, uint32_t>>{ { 1, 0 }, { 1, 1 } }));
+    EXPECT_LE(residency_manager.residentMemory(), residency_manager.memoryBudget());
+
+    // the upload budget limits amount of data streamed in during one update, but never blocks the first level
+    conversion::TextureResidencyManager throttled_residency_manager{ uploader, 10000, 0, 100 };
+    ASSERT_TRUE(throttled_residency_manager.registerTexture(a, mipmap_level_sizes));
+    EXPECT_EQ(throttled_residency_manager.residentMostDetailedLevel(a), 3U);
+    throttled_residency_manager.requestMipmapLevel(a, 0, 1.f);
+    throttled_residency_manager.update();
+    EXPECT_EQ(throttled_residency_manager.residentMostDetailedLevel(a), 2U);
+    throttled_residency_manager.requestMipmapLevel(a, 0, 1.f);
+    throttled_residency_manager.update();
+    EXPECT_EQ(throttled_residency_manager.residentMostDetailedLevel(a), 1U);
+    throttled_residency_manager.requestMipmapLevel(a, 0, 1.f);
+    throttled_residency_manager.update();
+    EXPECT_EQ(throttled_residency_manager.residentMostDetailedLevel(a), 0U);
+}
 
-    registry.setQuery("ns.testcmd 1,2,z=3");
-    auto schema = registry.invokeQuery();
-    ASSERT_TRUE(schema.has_value());
+TEST(EngineTests_Basic, TestTransformHierarchy)
+{
+    using namespace lexgine;
+    using core::math::Matrix4f;
+    using core::math::Vector3f;
 
-    ArgMap const& args = schema->args;
-    EXPECT_EQ(args.size(), 3U);
-    EXPECT_EQ(std::get<int>(args.at("x")), 1);
-    EXPECT_EQ(std::get<int>(args.at("y")), 2);
-    EXPECT_EQ(std::get<int>(args.at("z")), 3);
-}
+    auto are_equal = [](Matrix4f const& a, Matrix4f const& b)
+        {
+            for (int i = 0; i < 4; ++i)
+                for (int j = 0; j < 4; ++j)
+                    if (std::abs(a[i][j] - b[i][j]) > 1e-4f) return false;
+            return true;
+        };
 
+    scenegraph::TransformHierarchy hierarchy{};
+    scenegraph::Node root{ hierarchy }, child{ hierarchy }, grandchild{ hierarchy };
+    root.addChild(&child);
+    child.addChild(&grandchild);
+
+    Vector3f root_translation{ 1.f, 2.f, 3.f }, child_scaling{ 2.f, 2.f, 4.f }, grandchild_translation{ -1.f, 0.f, 5.f };
+    root.translate(root_translation);
+    child.scale(child_scaling);
+    grandchild.translate(grandchild_translation);
+
+    Matrix4f const expected_local_to_world = root.localToParentTransform() * child.localToParentTransform() * grandchild.localToParentTransform();
+    EXPECT_TRUE(are_equal(grandchild.localToWorldTransform(), expected_local_to_world));
+    EXPECT_TRUE(are_equal(grandchild.worldToLocalTransform() * grandchild.localToWorldTransform(), Matrix4f{ 1.f }));
+    EXPECT_TRUE(hierarchy.isUpToDate());
+
+    // reparenting the grandchild directly to the root bypasses scaling of the child
+    child.removeChild(&grandchild);
+    root.addChild(&grandchild);
+    grandchild.translate(grandchild_translation);
+    EXPECT_TRUE(are_equal(grandchild.localToWorldTransform(), root.localToParentTransform() * grandchild.localToParentTransform()));
+
+    // cycles are rejected (handles are allocated in the order of construction of the nodes)
+    EXPECT_EQ(hierarchy.getParent(1), 0U);
+    EXPECT_FALSE(hierarchy.setParent(0, 1));
+
+    // wide levels split between the workers of the scheduler must produce the same result as the serial update
+    core::concurrency::AssetScheduler scheduler{ 3, "transform_hierarchy_test_scheduler" };
+    scenegraph::TransformHierarchy serial_hierarchy{}, parallel_hierarchy{ &scheduler };
+    EXPECT_EQ(parallel_hierarchy.scheduler(), &scheduler);
+    for (scenegraph::TransformHierarchy* p_hierarchy : { &serial_hierarchy, &parallel_hierarchy })
+    {
+        auto root_handle = p_hierarchy->addTransform();
+        p_hierarchy->setLocalTransform(root_handle, root.localToParentTransform(), root.parentToLocalTransform());
+        for (int i = 0; i < 10000; ++i)
+        {
+            auto handle = p_hierarchy->addTransform(root_handle);
+            Matrix4f local_to_parent{ 1.f }, parent_to_local{ 1.f };
+            local_to_parent[3] = core::math::Vector4f{ static_cast<float>(i), 1.f, 0.f, 1.f };
+            parent_to_local[3] = core::math::Vector4f{ -static_cast<float>(i), -1.f, 0.f, 1.f };
+            p_hierarchy->setLocalTransform(handle, local_to_parent, parent_to_local);
+        }
+    }
+    serial_hierarchy.update();
+    parallel_hierarchy.update();
+    for (scenegraph::TransformHierarchy::Handle handle = 0; handle < serial_hierarchy.size(); ++handle)
+    {
+        ASSERT_EQ(serial_hierarchy.localToWorldTransform(handle), parallel_hierarchy.localToWorldTransform(handle));
+    }
+    EXPECT_TRUE(are_equal(serial_hierarchy.localToWorldTransform(5), root.localToParentTransform() * serial_hierarchy.localToParentTransform(5)));
+
+    // releasing the root turns its children into roots
+    serial_hierarchy.releaseTransform(0);
+    serial_hierarchy.update();
+    EXPECT_EQ(serial_hierarchy.size(), 10000U);
+    EXPECT_EQ(serial_hierarchy.getParent(5), scenegraph::TransformHierarchy::c_invalid_handle);
+    EXPECT_TRUE(are_equal(serial_hierarchy.localToWorldTransform(5), serial_hierarchy.localToParentTransform(5)));
+}
 
-TEST(EngineTests_gpu, TestTextureCompression)
+TEST(EngineTests_Basic, TestTransformHierarchyMatchesStandaloneNodes)
 {
     using namespace lexgine;
-    using namespace lexgine::core;
-    using namespace lexgine::conversion;
-    using namespace lexgine::core::dx;
-    using namespace lexgine::core::dx::d3d12;
-    using namespace lexgine::core::misc;
+    using core::math::Matrix4f;
+    using core::math::Vector3f;
 
-    EngineSettings settings{};
-    settings.engine_api = EngineApi::Direct3D12;
-    settings.debug_mode = true;
-    settings.log_name = "TestTextureCompression.log";
+    auto are_equal = [](Matrix4f const& a, Matrix4f const& b)
+        {
+            for (int i = 0; i < 4; ++i)
+                for (int j = 0; j < 4; ++j)
+                    if (std::abs(a[i][j] - b[i][j]) > 1e-3f * (std::max)(1.f, std::abs(a[i][j]))) return false;
+            return true;
+        };
 
-    Initializer initializer{ settings };
-    initializer.setCurrentDevice(0);
+    // the same tree is built from standalone nodes and from the nodes sharing a transform hierarchy
+    constexpr size_t node_count = 341;    // full 4-ary tree of depth 5
+    scenegraph::TransformHierarchy hierarchy{};
+    std::vector<scenegraph::Node> standalone_nodes(node_count);
+    std::vector<scenegraph::Node> hierarchy_nodes{};
+    hierarchy_nodes.reserve(node_count);
+    for (size_t i = 0; i < node_count; ++i) hierarchy_nodes.emplace_back(hierarchy);
+    for (size_t i = 1; i < node_count; ++i)
+    {
+        standalone_nodes[(i - 1) / 4].addChild(&standalone_nodes[i]);
+        hierarchy_nodes[(i - 1) / 4].addChild(&hierarchy_nodes[i]);
+    }
 
+    std::mt19937 generator{ 31 };
+    std::uniform_real_distribution<float> distribution{ -1.f, 1.f };
+    auto check_transforms = [&]()
+        {
+            for (size_t i = 0; i < node_count; ++i)
+            {
+                ASSERT_TRUE(are_equal(standalone_nodes[i].localToWorldTransform(), hierarchy_nodes[i].localToWorldTransform())) << "node " << i;
+                ASSERT_TRUE(are_equal(standalone_nodes[i].worldToLocalTransform(), hierarchy_nodes[i].worldToLocalTransform())) << "node " << i;
+            }
+        };
 
-    conversion::TextureConverter* p_texture_converter = initializer.globals().get<conversion::TextureConverter>();
-    scenegraph::Image test_image{ std::filesystem::path{LEXGINE_GLOBAL_LOOKUP_PREFIX} / "engine/tests/data/Lenna_(test_image).png", *initializer.globals().get<ImageLoaderPool>()};
-    p_texture_converter->addTextureConversionTask(test_image, false);
-    p_texture_converter->convertTextures();
-    p_texture_converter->uploadTextures();
-    p_texture_converter->waitForTextureUploadCompletion();
-}
\ No newline at end of file
+    // the root is transformed too, so that the world transform of the root is compared as well
+    auto transform_nodes = [&](size_t first_node)
+        {
+            for (size_t i = first_node; i < node_count; ++i)
+            {
+                Vector3f v{ distribution(generator), distribution(generator), distribution(generator) };
+                float const angle = distribution(generator) * glm::pi<float>();
+                for (scenegraph::Node* p_node : { &standalone_nodes[i], &hierarchy_nodes[i] })
+                {
+                    switch (i % 3)
+                    {
+                    case 0: p_node->translate(v); break;
+                    case 1: { Vector3f axis = glm::normalize(v); p_node->rotate(axis, angle); break; }
+                    case 2: { Vector3f scaling = Vector3f{ 1.5f } + .5f * v; p_node->scale(scaling); break; }
+                    }
+                }
+            }
+        };
+
+    transform_nodes(0);
+    check_transforms();
+    EXPECT_TRUE(are_equal(hierarchy_nodes[0].localToWorldTransform(), hierarchy_nodes[0].localToParentTransform()));
+
+    // changes of the inner nodes propagate to their descendants in both modes
+    transform_nodes(1);
+    Vector3f root_translation{ 3.f, -2.f, 1.f };
+    standalone_nodes[0].translate(root_translation);
+    hierarchy_nodes[0].translate(root_translation);
+    check_transforms();
+}
+
+TEST(EngineTests_Basic, TestBoundingVolumeHierarchyCulling)
+{
+    using namespace lexgine;
+
+    std::mt19937 generator{ 1234 };
+    std::uniform_real_distribution<float> position_distribution{ -100.f, 100.f }, size_distribution{ .1f, 5.f };
+
+    std::vector<scenegraph::Aabb> instance_bounds(5000);
+    for (auto& bounds : instance_bounds)
+    {
+        glm::vec3 const center{ position_distribution(generator), position_distribution(generator), position_distribution(generator) };
+        glm::vec3 const half_size{ size_distribution(generator), size_distribution(generator), size_distribution(generator) };
+        bounds = scenegraph::Aabb{ center - half_size, center + half_size };
+    }
+
+    scenegraph::BoundingVolumeHierarchy bvh{};
+    bvh.build(instance_bounds);
+
+    scenegraph::Camera camera{ "test_camera" };
+    camera.setPerspective(60.f, 16.f / 9.f, .1f, 80.f);
+
+    auto check_culling = [&bvh, &camera]()
+        {
+            std::vector<uint32_t> visible_instances{};
+            bvh.cull(camera.frustumPlanes(), visible_instances);
+            std::sort(visible_instances.begin(), visible_instances.end());
+
+            std::vector<uint32_t> expected_visible_instances{};
+            for (uint32_t i = 0; i < bvh.instanceCount(); ++i)
+            {
+                if (camera.isAabbVisible(bvh.instanceBounds(i).min, bvh.instanceBounds(i).max)) expected_visible_instances.push_back(i);
+            }
+
+            EXPECT_FALSE(expected_visible_instances.empty());
+            EXPECT_LT(expected_visible_instances.size(), bvh.instanceCount());
+            EXPECT_EQ(visible_instances, expected_visible_instances);
+        };
+
+    camera.setView(glm::vec3{ 0.f, 0.f, 0.f }, glm::vec3{ 1.f, .2f, -1.f }, glm::vec3{ 0.f, 1.f, 0.f });
+    check_culling();
+    camera.setView(glm::vec3{ -120.f, 10.f, 30.f }, glm::vec3{ 0.f, 0.f, 0.f }, glm::vec3{ 0.f, 1.f, 0.f });
+    check_culling();
+
+    // move some of the instances and refit the hierarchy
+    core::math::Matrix4f translation{ 1.f };
+    translation[3] = core::math::Vector4f{ 15.f, -7.f, 3.f, 1.f };
+    for (uint32_t i = 0; i < bvh.instanceCount(); i += 3)
+    {
+        bvh.setInstanceBounds(i, bvh.instanceBounds(i).transform(translation));
+    }
+    bvh.refit();
+    check_culling();
+    EXPECT_FLOAT_EQ(bvh.instanceBounds(3).min.x, instance_bounds[3].min.x + 15.f);
+}
+
+TEST(EngineTests_Basic, TestSceneMemoryUploadPlan)
+{
+    using namespace lexgine;
+
+    // two source buffers: the second one contains an unreferenced region (e.g. an embedded image) between the referenced views
+    std::vector<std::vector<uint8_t>> buffers(2);
+    buffers[0].resize(100);
+    buffers[1].resize(1000);
+    for (auto& buffer : buffers)
+        for (size_t i = 0; i < buffer.size(); ++i) buffer[i] = static_cast<uint8_t>(i * 7 + buffer.size());
+
+    scenegraph::SceneMemoryUploadPlan plan{ 16 };
+    plan.addReferencedRange(1, 800, 100, 1000);
+    plan.addReferencedRange(0, 4, 40, 100);
+    plan.addReferencedRange(0, 36, 40, 100);    // overlaps the previous range of the same buffer
+    plan.addReferencedRange(1, 0, 64, 1000);
+    plan.addReferencedRange(1, 64, 30, 1000);    // adjacent to the previous range
+    plan.addReferencedRange(1, 900, 100, 1000);
+    plan.addReferencedRange(1, 0, 64, 1000);    // the same buffer view referenced by another primitive
+    plan.build();
+
+    using Range = scenegraph::SceneMemoryUploadPlan::Range;
+    auto const& ranges = plan.ranges();
+    ASSERT_EQ(ranges.size(), 3U);
+    EXPECT_TRUE(ranges[0].buffer == 0 && ranges[0].source_offset == 0 && ranges[0].size == 80);
+    EXPECT_TRUE(ranges[1].buffer == 1 && ranges[1].source_offset == 0 && ranges[1].size == 96);
+    EXPECT_TRUE(ranges[2].buffer == 1 && ranges[2].source_offset == 800 && ranges[2].size == 200);
+    EXPECT_EQ(plan.totalSize(), 80U + 96U + 200U);
+    EXPECT_LT(plan.totalSize(), buffers[0].size() + buffers[1].size());
+
+    // stub uploader appending the ranges to the scene memory the same way as SceneMeshMemory::addData() does
+    std::vector<uint8_t> scene_memory{};
+    for (Range const& r : plan.ranges())
+    {
+        scene_memory.resize(core::misc::align(scene_memory.size(), plan.alignment()));
+        EXPECT_EQ(scene_memory.size(), r.destination_offset);
+        scene_memory.insert(scene_memory.end(), buffers[r.buffer].begin() + r.source_offset, buffers[r.buffer].begin() + r.source_offset + r.size);
+    }
+    EXPECT_EQ(scene_memory.size(), plan.totalSize());
+
+    for (auto [buffer, offset, size] : { std::make_tuple(0U, 4U, 72U), std::make_tuple(1U, 0U, 94U), std::make_tuple(1U, 850U, 150U) })
+    {
+        auto scene_memory_offset = plan.sceneMemoryOffset(buffer, offset);
+        ASSERT_TRUE(scene_memory_offset.has_value());
+        EXPECT_EQ(*scene_memory_offset % plan.alignment(), offset % plan.alignment());
+        EXPECT_TRUE(std::equal(buffers[buffer].begin() + offset, buffers[buffer].begin() + offset + size, scene_memory.begin() + *scene_memory_offset));
+    }
+    EXPECT_FALSE(plan.sceneMemoryOffset(1, 500).has_value());
+    EXPECT_FALSE(plan.sceneMemoryOffset(2, 0).has_value());
+}
+
+TEST(EngineTests_Basic, TestMeshOptimizer)
+{
+    using namespace lexgine;
+
+    // unindexed grid of 64x64 quads with triangles in random order: each vertex is stored once per triangle using it
+    uint32_t const grid_size = 64;
+    struct Vertex { float position[3]; float uv[2]; };
+    std::vector<std::array<Vertex, 3>> triangles{};
+    for (uint32_t y = 0; y < grid_size; ++y)
+    {
+        for (uint32_t x = 0; x < grid_size; ++x)
+        {
+            auto vertex = [grid_size](uint32_t i, uint32_t j)
+                {
+                    float const u = static_cast<float>(i) / grid_size, v = static_cast<float>(j) / grid_size;
+                    return Vertex{ { u, v, std::sin(u * 3.f) * std::cos(v * 5.f) }, { u, v } };
+                };
+            triangles.push_back({ vertex(x, y), vertex(x + 1, y), vertex(x + 1, y + 1) });
+            triangles.push_back({ vertex(x, y), vertex(x + 1, y + 1), vertex(x, y + 1) });
+        }
+    }
+    std::shuffle(triangles.begin(), triangles.end(), std::mt19937{ 42 });
+
+    scenegraph::MeshData mesh{ .vertex_stride = sizeof(Vertex), .position_offset = 0 };
+    for (auto const& triangle : triangles)
+    {
+        for (Vertex const& v : triangle)
+        {
+            mesh.indices.push_back(mesh.vertexCount());
+            mesh.vertices.insert(mesh.vertices.end(), reinterpret_cast<uint8_t const*>(&v), reinterpret_cast<uint8_t const*>(&v + 1));
+        }
+    }
+
+    // triangles are compared by their vertex contents starting from the vertex with the smallest contents, which preserves winding
+    auto collect_triangles = [](scenegraph::MeshData const& mesh)
+        {
+            std::vector<std::vector<uint8_t>> rv{};
+            for (size_t t = 0; t < mesh.indices.size(); t += 3)
+            {
+                std::array<std::vector<uint8_t>, 3> vertices{};
+                for (size_t i = 0; i < 3; ++i)
+                {
+                    auto const p = mesh.vertices.begin() + static_cast<size_t>(mesh.indices[t + i]) * mesh.vertex_stride;
+                    vertices[i].assign(p, p + mesh.vertex_stride);
+                }
+                std::rotate(vertices.begin(), std::min_element(vertices.begin(), vertices.end()), vertices.end());
+                rv.emplace_back();
+                for (auto const& v : vertices) rv.back().insert(rv.back().end(), v.begin(), v.end());
+            }
+            std::sort(rv.begin(), rv.end());
+            return rv;
+        };
+
+    auto const original_triangles = collect_triangles(mesh);
+
+    EXPECT_EQ(scenegraph::weldVertices(mesh), (grid_size + 1) * (grid_size + 1));
+    auto const welded_statistics = scenegraph::analyzeVertexCache(mesh.indices, mesh.vertexCount());
+
+    scenegraph::optimizeMesh(mesh);
+    auto const optimized_statistics = scenegraph::analyzeVertexCache(mesh.indices, mesh.vertexCount());
+
+    EXPECT_EQ(mesh.vertexCount(), (grid_size + 1) * (grid_size + 1));
+    EXPECT_EQ(collect_triangles(mesh), original_triangles);
+    EXPECT_LT(optimized_statistics.acmr, .8f);
+    EXPECT_LT(optimized_statistics.acmr, welded_statistics.acmr * .5f);
+
+    // after the vertex fetch optimization the vertices are referenced in the order they are stored
+    uint32_t next_new_vertex{ 0 };
+    for (uint32_t index : mesh.indices)
+    {
+        ASSERT_LE(index, next_new_vertex);
+        if (index == next_new_vertex) ++next_new_vertex;
+    }
+}
+
+TEST(EngineTests_Basic, TestVertexQuantization)
+{
+    using namespace lexgine;
+
+    std::mt19937 generator{ 7 };
+    std::uniform_real_distribution<float> coordinate_distribution{ -50.f, 50.f };
+    std::normal_distribution<float> direction_distribution{};
+    auto random_direction = [&generator, &direction_distribution]()
+        {
+            return glm::normalize(glm::vec3{ direction_distribution(generator), direction_distribution(generator), direction_distribution(generator) });
+        };
+
+    auto angle_between = [](glm::vec3 const& a, glm::vec3 const& b) { return std::atan2(glm::length(glm::cross(a, b)), glm::dot(a, b)); };
+
+    // octahedral encoding of unit vectors including the poles and the vectors on the folded edges
+    float const c_max_angular_error = 1e-4f;
+    std::vector<glm::vec3> directions{ { 0.f, 0.f, 1.f }, { 0.f, 0.f, -1.f }, { 1.f, 0.f, 0.f }, { 0.f, -1.f, 0.f }, glm::normalize(glm::vec3{ 1.f, -1.f, 0.f }) };
+    for (int i = 0; i < 10000; ++i) directions.push_back(random_direction());
+    for (glm::vec3 const& d : directions)
+    {
+        glm::vec3 const decoded_direction = scenegraph::decodeOctahedral(scenegraph::encodeOctahedral(d));
+        EXPECT_NEAR(glm::length(decoded_direction), 1.f, 1e-6f);
+        EXPECT_LT(angle_between(decoded_direction, d), c_max_angular_error);
+    }
+
+    // interleaved vertices: position, normal, tangent and texture coordinates
+    struct Vertex { float position[3]; float normal[3]; float tangent[4]; float uv[2]; };
+    std::vector<Vertex> vertices(1000);
+    for (Vertex& v : vertices)
+    {
+        glm::vec3 const n = random_direction(), t = random_direction();
+        v = Vertex{
+            { coordinate_distribution(generator), coordinate_distribution(generator) * .1f, coordinate_distribution(generator) + 100.f },
+            { n.x, n.y, n.z },
+            { t.x, t.y, t.z, t.x > 0.f ? 1.f : -1.f },
+            { coordinate_distribution(generator) * .02f, coordinate_distribution(generator) * .02f }
+        };
+    }
+
+    scenegraph::MeshData mesh{ .vertex_stride = sizeof(Vertex), .position_offset = offsetof(Vertex, position) };
+    mesh.vertices.assign(reinterpret_cast<uint8_t const*>(vertices.data()), reinterpret_cast<uint8_t const*>(vertices.data() + vertices.size()));
+    std::vector<scenegraph::VertexAttributeLayout> attributes{
+        { "POSITION", core::misc::DataFormat::float32, 3, false, offsetof(Vertex, position) },
+        { "NORMAL", core::misc::DataFormat::float32, 3, false, offsetof(Vertex, normal) },
+        { "TANGENT", core::misc::DataFormat::float32, 4, false, offsetof(Vertex, tangent) },
+        { "TEXCOORD_0", core::misc::DataFormat::float32, 2, false, offsetof(Vertex, uv) }
+    };
+
+    scenegraph::PositionDequantization const dequantization = scenegraph::quantizeVertexAttributes(mesh, attributes);
+    ASSERT_EQ(mesh.vertex_stride, 24U);    // 48 bytes originally
+    ASSERT_EQ(mesh.vertexCount(), vertices.size());
+    EXPECT_EQ(mesh.position_offset, attributes[0].offset);
+    EXPECT_TRUE(attributes[0].format == core::misc::DataFormat::uint16 && attributes[0].element_count == 4 && attributes[0].is_normalized);
+    EXPECT_TRUE(attributes[1].format == core::misc::DataFormat::int16 && attributes[1].element_count == 2 && attributes[1].is_normalized);
+    EXPECT_TRUE(attributes[2].format == core::misc::DataFormat::int16 && attributes[2].element_count == 4 && attributes[2].is_normalized);
+    EXPECT_TRUE(attributes[3].format == core::misc::DataFormat::float16 && attributes[3].element_count == 2 && !attributes[3].is_normalized);
+
+    // positions are restored within half of the quantization step of the bounds, texture coordinates within the precision of half floats
+    glm::vec3 const max_position_error = dequantization.scale / 65535.f * .5f + 1e-5f;
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+        Vertex const& v = vertices[i];
+        uint8_t const* p_vertex = mesh.vertices.data() + i * mesh.vertex_stride;
+
+        std::array<uint16_t, 4> position{};
+        std::memcpy(position.data(), p_vertex + attributes[0].offset, sizeof(position));
+        glm::vec3 const position_error = glm::abs(scenegraph::dequantizePosition(position, dequantization) - glm::vec3{ v.position[0], v.position[1], v.position[2] });
+        EXPECT_TRUE(glm::all(glm::lessThanEqual(position_error, max_position_error)));
+
+        std::array<int16_t, 2> normal{};
+        std::memcpy(normal.data(), p_vertex + attributes[1].offset, sizeof(normal));
+        EXPECT_LT(angle_between(scenegraph::decodeOctahedral(normal), glm::vec3{ v.normal[0], v.normal[1], v.normal[2] }), c_max_angular_error);
+
+        std::array<int16_t, 4> tangent{};
+        std::memcpy(tangent.data(), p_vertex + attributes[2].offset, sizeof(tangent));
+        EXPECT_LT(angle_between(scenegraph::decodeOctahedral({ tangent[0], tangent[1] }), glm::vec3{ v.tangent[0], v.tangent[1], v.tangent[2] }), c_max_angular_error);
+        EXPECT_EQ(tangent[2] > 0, v.tangent[3] > 0.f);
+
+        std::array<uint16_t, 2> uv{};
+        std::memcpy(uv.data(), p_vertex + attributes[3].offset, sizeof(uv));
+        EXPECT_NEAR(glm::unpackHalf1x16(uv[0]), v.uv[0], std::abs(v.uv[0]) / 2048.f);
+        EXPECT_NEAR(glm::unpackHalf1x16(uv[1]), v.uv[1], std::abs(v.uv[1]) / 2048.f);
+    }
+}
+
+TEST(EngineTests_Basic, TestMeshletBuilder)
+{
+    using namespace lexgine;
+
+    // UV-sphere with counter-clockwise triangles when looking from outside
+    uint32_t const stack_count = 48, slice_count = 96;
+    scenegraph::MeshData mesh{ .vertex_stride = sizeof(glm::vec3), .position_offset = 0 };
+    auto add_vertex = [&mesh](glm::vec3 const& p)
+        {
+            mesh.vertices.insert(mesh.vertices.end(), reinterpret_cast<uint8_t const*>(&p), reinterpret_cast<uint8_t const*>(&p + 1));
+        };
+    for (uint32_t i = 0; i <= stack_count; ++i)
+    {
+        for (uint32_t j = 0; j < slice_count; ++j)
+        {
+            float const theta = glm::pi<float>() * i / stack_count, phi = 2.f * glm::pi<float>() * j / slice_count;
+            add_vertex(glm::vec3{ std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta) });
+        }
+    }
+    for (uint32_t i = 0; i < stack_count; ++i)
+    {
+        for (uint32_t j = 0; j < slice_count; ++j)
+        {
+            uint32_t const a = i * slice_count + j, b = i * slice_count + (j + 1) % slice_count;
+            uint32_t const c = a + slice_count, d = b + slice_count;
+            if (i > 0) mesh.indices.insert(mesh.indices.end(), { a, c, b });
+            if (i + 1 < stack_count) mesh.indices.insert(mesh.indices.end(), { b, c, d });
+        }
+    }
+    scenegraph::optimizeVertexCache(mesh.indices, mesh.vertexCount());
+
+    auto position = [&mesh](uint32_t v) { glm::vec3 p; std::memcpy(&p, mesh.vertices.data() + v * sizeof(glm::vec3), sizeof(p)); return p; };
+    auto triangle_normal = [&position](std::array<uint32_t, 3> const& t)
+        {
+            return glm::normalize(glm::cross(position(t[1]) - position(t[0]), position(t[2]) - position(t[0])));
+        };
+
+    scenegraph::MeshletData const meshlet_data = scenegraph::buildMeshlets(mesh);
+    ASSERT_EQ(meshlet_data.bounds.size(), meshlet_data.meshlets.size());
+
+    // the meshlets respect the limits and contain every triangle exactly once preserving the winding
+    std::vector<std::array<uint32_t, 3>> original_triangles{}, meshlet_triangles{};
+    std::vector<std::vector<std::array<uint32_t, 3>>> triangles_of_meshlets{};
+    for (size_t t = 0; t < mesh.indices.size(); t += 3) original_triangles.push_back({ mesh.indices[t], mesh.indices[t + 1], mesh.indices[t + 2] });
+    uint32_t total_vertex_count{ 0 };
+    for (scenegraph::Meshlet const& meshlet : meshlet_data.meshlets)
+    {
+        ASSERT_LE(meshlet.vertex_count, scenegraph::c_default_meshlet_max_vertices);
+        ASSERT_LE(meshlet.triangle_count, scenegraph::c_default_meshlet_max_triangles);
+        total_vertex_count += meshlet.vertex_count;
+
+        triangles_of_meshlets.emplace_back();
+        for (uint32_t t = 0; t < meshlet.triangle_count; ++t)
+        {
+            std::array<uint32_t, 3> triangle{};
+            for (uint32_t i = 0; i < 3; ++i)
+            {
+                uint8_t const local_index = meshlet_data.triangle_indices[meshlet.triangle_offset + 3 * t + i];
+                ASSERT_LT(local_index, meshlet.vertex_count);
+                triangle[i] = meshlet_data.vertex_indices[meshlet.vertex_offset + local_index];
+            }
+            meshlet_triangles.push_back(triangle);
+            triangles_of_meshlets.back().push_back(triangle);
+        }
+    }
+    std::sort(original_triangles.begin(), original_triangles.end());
+    std::sort(meshlet_triangles.begin(), meshlet_triangles.end());
+    EXPECT_EQ(meshlet_triangles, original_triangles);
+
+    // compact meshlets share most of their vertices between the triangles
+    EXPECT_LT(static_cast<float>(total_vertex_count) / original_triangles.size(), .75f);
+    EXPECT_LT(meshlet_data.meshlets.size(), original_triangles.size() / 64);
+
+    // the bounding spheres contain the vertices and the cones contain the normals
+    for (size_t m = 0; m < meshlet_data.meshlets.size(); ++m)
+    {
+        scenegraph::MeshletBounds const& bounds = meshlet_data.bounds[m];
+        for (auto const& t : triangles_of_meshlets[m])
+        {
+            for (uint32_t v : t) EXPECT_LE(glm::length(position(v) - bounds.center), bounds.radius * (1.f + 1e-5f));
+            EXPECT_GE(glm::dot(triangle_normal(t), bounds.cone_axis), bounds.cone_cos_angle - 1e-5f);
+        }
+    }
+
+    // culled meshlets have no triangles, which are inside of the frustum and face the camera
+    float const c_far = 100.f;
+    scenegraph::MeshletFrustumPlanes const frustum_planes{
+        glm::vec4{ 1.f, 0.f, 0.f, .5f }, glm::vec4{ -1.f, 0.f, 0.f, c_far },    // -0.5 <= x <= far
+        glm::vec4{ 0.f, 1.f, 0.f, c_far }, glm::vec4{ 0.f, -1.f, 0.f, c_far },
+        glm::vec4{ 0.f, 0.f, 1.f, c_far }, glm::vec4{ 0.f, 0.f, -1.f, c_far }
+    };
+    std::mt19937 generator{ 3 };
+    std::uniform_real_distribution<float> camera_distribution{ -4.f, 4.f };
+    for (int c = 0; c < 16; ++c)
+    {
+        glm::vec3 camera_position{ camera_distribution(generator), camera_distribution(generator), camera_distribution(generator) };
+        if (glm::length(camera_position) < 1.5f) camera_position = glm::normalize(camera_position) * 1.5f;
+
+        std::vector<uint32_t> visible_meshlets{};
+        scenegraph::cullMeshlets(meshlet_data, frustum_planes, camera_position, visible_meshlets);
+        EXPECT_LT(visible_meshlets.size(), meshlet_data.meshlets.size() * 3 / 4);
+
+        std::vector<char> is_visible(meshlet_data.meshlets.size(), 0);
+        for (uint32_t m : visible_meshlets) is_visible[m] = 1;
+        for (size_t m = 0; m < meshlet_data.meshlets.size(); ++m)
+        {
+            if (is_visible[m]) continue;
+            for (auto const& t : triangles_of_meshlets[m])
+            {
+                bool const is_outside = std::any_of(frustum_planes.begin(), frustum_planes.end(),
+                    [&t, &position](glm::vec4 const& plane)
+                    {
+                        return std::all_of(t.begin(), t.end(), [&plane, &position](uint32_t v) { return glm::dot(glm::vec3{ plane }, position(v)) + plane.w < 0.f; });
+                    });
+                bool const is_back_facing = glm::dot(triangle_normal(t), camera_position - position(t[0])) <= 0.f;
+                EXPECT_TRUE(is_outside || is_back_facing);
+            }
+        }
+    }
+
+    // packed meshlet data keeps all sections aligned
+    scenegraph::MeshletBufferLayout layout{};
+    std::vector<uint8_t> const packed_meshlets = scenegraph::packMeshlets(meshlet_data, layout);
+    EXPECT_EQ(layout.bounds_offset % 16, 0U);
+    EXPECT_EQ(layout.vertex_index_offset % 16, 0U);
+    EXPECT_EQ(layout.triangle_index_offset % 16, 0U);
+    EXPECT_GE(packed_meshlets.size(), layout.triangle_index_offset + meshlet_data.triangle_indices.size());
+    EXPECT_EQ(std::memcmp(packed_meshlets.data() + layout.bounds_offset, meshlet_data.bounds.data(), meshlet_data.bounds.size() * sizeof(scenegraph::MeshletBounds)), 0);
+}
+
+TEST(EngineTests_Basic, TestRenderListBuilder)
+{
+    using namespace lexgine;
+    using core::dx::d3d12::tasks::GraphicsPSOCompilationTask;
+    using core::dx::d3d12::tasks::RootSignatureCompilationTask;
+
+    // synthetic scene: the batch keys only compare addresses, so fake objects stand in for the real ones
+
+    std::vector<scenegraph::RenderBatchKey> keys;
+    for (uint32_t submesh = 0; submesh < 6; ++submesh)
+    {
+        uint32_t const material = submesh % 3;
+        keys.push_back(scenegraph::RenderBatchKey{
+            .pso = fakeObject<GraphicsPSOCompilationTask>(material % 2),
+            .root_signature = fakeObject<RootSignatureCompilationTask>(8),
+            .material = fakeObject<scenegraph::Material>(16 + material),
+            .submesh = fakeObject<scenegraph::Submesh>(32 + submesh)
+            });
+    }
+
+    // the instances are submitted in random order, their transforms carry the submission index
+    std::mt19937 rng{ 7 };
+    uint32_t const instance_count = 1000;
+    std::vector<uint32_t> instance_keys(instance_count);
+    std::vector<uint32_t> key_instance_counts(keys.size(), 0);
+    scenegraph::RenderListBuilder unlimited_builder{};
+    scenegraph::RenderListBuilder limited_builder{ 16 };
+    for (uint32_t i = 0; i < instance_count; ++i)
+    {
+        instance_keys[i] = rng() % keys.size();
+        ++key_instance_counts[instance_keys[i]];
+        core::math::Matrix4f const transform = glm::translate(core::math::Matrix4f{ 1.f }, glm::vec3{ static_cast<float>(i), 0.f, 0.f });
+        unlimited_builder.addInstance(keys[instance_keys[i]], transform);
+        limited_builder.addInstance(keys[instance_keys[i]], transform);
+    }
+    unlimited_builder.build();
+    limited_builder.build();
+
+    auto check_draws = [&](scenegraph::RenderListBuilder const& builder, uint32_t max_instances_per_draw)
+        {
+            std::vector<scenegraph::InstancedDraw> const& draws = builder.draws();
+            ASSERT_EQ(builder.instanceTransforms().size(), instance_count);
+
+            std::vector<uint32_t> key_draw_counts(keys.size(), 0);
+            std::set<void const*> bound_pipeline_states, bound_materials;
+            uint32_t next_instance{ 0 }, pipeline_state_changes{ 0 }, material_changes{ 0 };
+            std::vector<uint32_t> last_submission_index(keys.size(), 0);
+            std::vector<bool> has_instances(keys.size(), false);
+            for (scenegraph::InstancedDraw const& draw : draws)
+            {
+                // draws cover all instances in contiguous ranges
+                EXPECT_EQ(draw.first_instance, next_instance);
+                EXPECT_GT(draw.instance_count, 0U);
+                EXPECT_LE(draw.instance_count, max_instances_per_draw);
+                next_instance += draw.instance_count;
+
+                size_t const key = std::find(keys.begin(), keys.end(), draw.key) - keys.begin();
+                ASSERT_LT(key, keys.size());
+                ++key_draw_counts[key];
+
+                // instances of the draw have its key and keep the order of submission
+                for (uint32_t i = draw.first_instance; i < draw.first_instance + draw.instance_count; ++i)
+                {
+                    uint32_t const submission_index = static_cast<uint32_t>(builder.instanceTransforms()[i][3][0]);
+                    EXPECT_EQ(instance_keys[submission_index], key);
+                    EXPECT_TRUE(!has_instances[key] || submission_index > last_submission_index[key]);
+                    last_submission_index[key] = submission_index;
+                    has_instances[key] = true;
+                }
+
+                // each pipeline state and material is bound only once
+                if (draw.is_new_pipeline_state)
+                {
+                    ++pipeline_state_changes;
+                    bound_pipeline_states.insert(draw.key.pso);
+                }
+                if (draw.is_new_material)
+                {
+                    ++material_changes;
+                    bound_materials.insert(draw.key.material);
+                }
+            }
+            EXPECT_EQ(next_instance, instance_count);
+            EXPECT_EQ(pipeline_state_changes, bound_pipeline_states.size());
+            EXPECT_EQ(pipeline_state_changes, 2U);
+            EXPECT_EQ(material_changes, bound_materials.size());
+            EXPECT_EQ(material_changes, 3U);
+            EXPECT_TRUE(draws.front().is_new_root_signature);
+
+            for (size_t k = 0; k < keys.size(); ++k)
+            {
+                EXPECT_EQ(key_draw_counts[k], (key_instance_counts[k] + uint64_t{ max_instances_per_draw } - 1) / max_instances_per_draw);
+            }
+        };
+
+    check_draws(unlimited_builder, 0xFFFFFFFF);
+    EXPECT_EQ(unlimited_builder.draws().size(), keys.size());
+    check_draws(limited_builder, 16);
+
+    // the builder is reusable after clearing
+    unlimited_builder.clear();
+    unlimited_builder.build();
+    EXPECT_TRUE(unlimited_builder.draws().empty());
+    EXPECT_TRUE(unlimited_builder.instanceTransforms().empty());
+}
+
+TEST(EngineTests_Basic, TestBakedScene)
+{
+    using namespace lexgine;
+
+    // processed primitive: quantized grid partitioned into meshlets
+    uint32_t const grid_size = 32;
+    struct Vertex { float position[3]; float normal[3]; };
+    scenegraph::MeshData mesh{ .vertex_stride = sizeof(Vertex), .position_offset = 0 };
+    for (uint32_t y = 0; y <= grid_size; ++y)
+    {
+        for (uint32_t x = 0; x <= grid_size; ++x)
+        {
+            Vertex const v{ { static_cast<float>(x), static_cast<float>(y), std::sin(x * .3f) }, { 0.f, 0.f, 1.f } };
+            mesh.vertices.insert(mesh.vertices.end(), reinterpret_cast<uint8_t const*>(&v), reinterpret_cast<uint8_t const*>(&v + 1));
+        }
+    }
+    for (uint32_t y = 0; y < grid_size; ++y)
+    {
+        for (uint32_t x = 0; x < grid_size; ++x)
+        {
+            uint32_t const i = y * (grid_size + 1) + x;
+            mesh.indices.insert(mesh.indices.end(), { i, i + 1, i + grid_size + 2, i, i + grid_size + 2, i + grid_size + 1 });
+        }
+    }
+    std::vector<scenegraph::VertexAttributeLayout> attributes{
+        { .name = "POSITION", .format = core::misc::DataFormat::float32, .element_count = 3, .is_normalized = false, .offset = 0 },
+        { .name = "NORMAL", .format = core::misc::DataFormat::float32, .element_count = 3, .is_normalized = false, .offset = 12 }
+    };
+    scenegraph::MeshletData const meshlets = scenegraph::buildMeshlets(mesh);
+    scenegraph::MeshletBufferLayout packed_meshlet_layout{};
+    std::vector<uint8_t> const packed_meshlets = scenegraph::packMeshlets(meshlets, packed_meshlet_layout);
+    scenegraph::PositionDequantization const dequantization = scenegraph::quantizeVertexAttributes(mesh, attributes);
+    std::vector<uint8_t> index_data(mesh.indices.size() * sizeof(uint16_t));
+    for (size_t i = 0; i < mesh.indices.size(); ++i) reinterpret_cast<uint16_t*>(index_data.data())[i] = static_cast<uint16_t>(mesh.indices[i]);
+
+    // second primitive without optional data
+    std::vector<uint8_t> const plain_vertices(36 * 3, 7);
+    std::vector<uint8_t> const plain_indices{ 0, 0, 0, 0, 1, 0, 0, 0, 2, 0, 0, 0 };
+
+    std::vector<scenegraph::BakedPrimitive> const primitives{
+        scenegraph::BakedPrimitive{
+            .mesh_id = 3, .primitive_index = 1, .vertex_stride = mesh.vertex_stride, .position_offset = mesh.position_offset, .index_size = 2,
+            .vertices = mesh.vertices, .index_data = index_data, .attributes = attributes, .position_dequantization = dequantization,
+            .meshlets = meshlets.meshlets, .meshlet_bounds = meshlets.bounds, .meshlet_vertex_indices = meshlets.vertex_indices,
+            .meshlet_triangle_indices = meshlets.triangle_indices, .packed_meshlets = packed_meshlets, .packed_meshlet_layout = packed_meshlet_layout
+        },
+        scenegraph::BakedPrimitive{
+            .mesh_id = 5, .primitive_index = 0, .vertex_stride = 36, .position_offset = 0, .index_size = 4,
+            .vertices = plain_vertices, .index_data = plain_indices,
+            .attributes = { { .name = "POSITION", .format = core::misc::DataFormat::float32, .element_count = 3, .is_normalized = false, .offset = 0 } }
+        }
+    };
+
+    // glTF tables of the source: the baked primitives replace primitives of the meshes 3 and 5
+    tg3_primitive source_primitives[3]{};
+    for (tg3_primitive& primitive : source_primitives)
+    {
+        primitive.indices = -1;
+        primitive.material = -1;
+        primitive.mode = TG3_MODE_TRIANGLES;
+    }
+    tg3_mesh source_meshes[6]{};
+    source_meshes[3].primitives = source_primitives;
+    source_meshes[3].primitives_count = 2;
+    source_meshes[5].primitives = source_primitives + 2;
+    source_meshes[5].primitives_count = 1;
+    tg3_node source_node{ .name = { "root", 4 } };
+    source_node.camera = source_node.skin = source_node.light = -1;
+    source_node.mesh = 3;
+    int32_t const scene_nodes[] = { 0 };
+    tg3_scene const source_scene{ .name = { "main", 4 }, .nodes = scene_nodes, .nodes_count = 1 };
+    uint8_t const embedded_buffer_data[] = { 1, 2, 3, 4, 5 };
+    tg3_buffer const source_buffers[2]{
+        { .uri = { "animation.bin", 13 } },
+        { .data = { embedded_buffer_data, sizeof(embedded_buffer_data) }, .uri = { "data:application/octet-stream;base64,AQIDBAU=", 44 } }
+    };
+    tg3_model source_model{};
+    source_model.meshes = source_meshes;
+    source_model.meshes_count = 6;
+    source_model.nodes = &source_node;
+    source_model.nodes_count = 1;
+    source_model.scenes = &source_scene;
+    source_model.scenes_count = 1;
+    source_model.default_scene = 0;
+    source_model.buffers = source_buffers;
+    source_model.buffers_count = 2;
+
+    scenegraph::BakedSceneKey const key{
+        .source_id = core::misc::Sha256::hash(std::span<uint8_t const>{ packed_meshlets }),
+        .processing_options = 7
+    };
+    std::vector<scenegraph::BakedSceneDependency> const dependencies{
+        { .uri = "geometry.bin", .content_hash = core::misc::Sha256::hash(plain_vertices), .is_needed_on_load = false },
+        { .uri = "animation.bin", .content_hash = core::misc::Sha256::hash(plain_indices), .is_needed_on_load = true }
+    };
+    std::vector<scenegraph::BakedBuffer> const buffers{
+        { .source = scenegraph::BakedBufferSource::dependency, .dependency_index = 1 },
+        { .source = scenegraph::BakedBufferSource::baked, .dependency_index = 0, .data = embedded_buffer_data }
+    };
+    std::vector<uint8_t> const baked_scene = scenegraph::writeBakedScene(key, dependencies, buffers, source_model, primitives);
+
+    auto equal_bytes = [](auto const& a, auto const& b)
+        {
+            return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(),
+                [](auto const& x, auto const& y) { return std::memcmp(&x, &y, sizeof(x)) == 0; });
+        };
+
+    // the primitives read back reference the baked scene and equal the original ones
+    std::optional<scenegraph::BakedScene> const read_scene = scenegraph::readBakedScene(baked_scene, key);
+    ASSERT_TRUE(read_scene.has_value());
+    ASSERT_EQ(read_scene->dependencies.size(), dependencies.size());
+    for (size_t i = 0; i < dependencies.size(); ++i)
+    {
+        EXPECT_EQ(read_scene->dependencies[i].uri, dependencies[i].uri);
+        EXPECT_TRUE(read_scene->dependencies[i].content_hash == dependencies[i].content_hash);
+        EXPECT_EQ(read_scene->dependencies[i].is_needed_on_load, dependencies[i].is_needed_on_load);
+    }
+    ASSERT_EQ(read_scene->buffers.size(), buffers.size());
+    EXPECT_TRUE(read_scene->buffers[0].source == scenegraph::BakedBufferSource::dependency);
+    EXPECT_EQ(read_scene->buffers[0].dependency_index, 1U);
+    EXPECT_TRUE(read_scene->buffers[1].source == scenegraph::BakedBufferSource::baked);
+    EXPECT_TRUE(equal_bytes(read_scene->buffers[1].data, std::span<uint8_t const>{ embedded_buffer_data }));
+
+    // so are the glTF tables, which do not refer to the memory they have been restored from
+    ASSERT_TRUE(read_scene->model != nullptr);
+    tg3_model const& restored_model = read_scene->model->model();
+    ASSERT_EQ(restored_model.meshes_count, 6U);
+    EXPECT_EQ(restored_model.meshes[3].primitives_count, 2U);
+    EXPECT_EQ(restored_model.meshes[5].primitives_count, 1U);
+    EXPECT_EQ(restored_model.meshes[5].primitives[0].mode, TG3_MODE_TRIANGLES);
+    ASSERT_EQ(restored_model.nodes_count, 1U);
+    EXPECT_TRUE(tg3_str_equals_cstr(restored_model.nodes[0].name, "root"));
+    EXPECT_EQ(restored_model.nodes[0].mesh, 3);
+    ASSERT_EQ(restored_model.scenes_count, 1U);
+    EXPECT_TRUE(tg3_str_equals_cstr(restored_model.scenes[0].name, "main"));
+    ASSERT_EQ(restored_model.scenes[0].nodes_count, 1U);
+    EXPECT_EQ(restored_model.scenes[0].nodes[0], 0);
+    ASSERT_EQ(restored_model.buffers_count, 2U);
+    EXPECT_TRUE(tg3_str_equals_cstr(restored_model.buffers[0].uri, "animation.bin"));
+    EXPECT_EQ(restored_model.buffers[1].data.count, 0U);    // the data are provided by the importer
+    EXPECT_TRUE(reinterpret_cast<uint8_t const*>(&restored_model) < baked_scene.data() || reinterpret_cast<uint8_t const*>(&restored_model) >= baked_scene.data() + baked_scene.size());
+    read_scene->model->setBufferData(1, embedded_buffer_data);
+    EXPECT_EQ(restored_model.buffers[1].data.data, embedded_buffer_data);
+
+    ASSERT_EQ(read_scene->primitives.size(), primitives.size());
+    for (size_t i = 0; i < primitives.size(); ++i)
+    {
+        scenegraph::BakedPrimitive const& original = primitives[i];
+        scenegraph::BakedPrimitive const& restored = read_scene->primitives[i];
+        EXPECT_EQ(restored.mesh_id, original.mesh_id);
+        EXPECT_EQ(restored.primitive_index, original.primitive_index);
+        EXPECT_EQ(restored.vertex_stride, original.vertex_stride);
+        EXPECT_EQ(restored.position_offset, original.position_offset);
+        EXPECT_EQ(restored.index_size, original.index_size);
+        EXPECT_TRUE(equal_bytes(restored.vertices, original.vertices));
+        EXPECT_TRUE(equal_bytes(restored.index_data, original.index_data));
+        EXPECT_TRUE(equal_bytes(restored.meshlets, original.meshlets));
+        EXPECT_TRUE(equal_bytes(restored.meshlet_bounds, original.meshlet_bounds));
+        EXPECT_TRUE(equal_bytes(restored.meshlet_vertex_indices, original.meshlet_vertex_indices));
+        EXPECT_TRUE(equal_bytes(restored.meshlet_triangle_indices, original.meshlet_triangle_indices));
+        EXPECT_TRUE(equal_bytes(restored.packed_meshlets, original.packed_meshlets));
+        EXPECT_EQ(std::memcmp(&restored.packed_meshlet_layout, &original.packed_meshlet_layout, sizeof(scenegraph::MeshletBufferLayout)), 0);
+        EXPECT_TRUE(restored.vertices.empty() || (restored.vertices.data() >= baked_scene.data() && restored.vertices.data() < baked_scene.data() + baked_scene.size()));
+
+        EXPECT_EQ(restored.position_dequantization.has_value(), original.position_dequantization.has_value());
+        if (restored.position_dequantization && original.position_dequantization)
+        {
+            EXPECT_TRUE(restored.position_dequantization->scale == original.position_dequantization->scale);
+            EXPECT_TRUE(restored.position_dequantization->offset == original.position_dequantization->offset);
+        }
+
+        ASSERT_EQ(restored.attributes.size(), original.attributes.size());
+        for (size_t j = 0; j < original.attributes.size(); ++j)
+        {
+            EXPECT_EQ(restored.attributes[j].name, original.attributes[j].name);
+            EXPECT_TRUE(restored.attributes[j].format == original.attributes[j].format);
+            EXPECT_EQ(restored.attributes[j].element_count, original.attributes[j].element_count);
+            EXPECT_EQ(restored.attributes[j].is_normalized, original.attributes[j].is_normalized);
+            EXPECT_EQ(restored.attributes[j].offset, original.attributes[j].offset);
+        }
+    }
+
+    // baked scenes produced from another source, from an outdated version of the source or with other options are rejected
+    scenegraph::BakedSceneKey other_key = key;
+    other_key.source_id[0] ^= 1;
+    EXPECT_FALSE(scenegraph::readBakedScene(baked_scene, other_key).has_value());
+    EXPECT_NE(scenegraph::bakedSceneFileName(key), scenegraph::bakedSceneFileName(other_key));
+    other_key = key;
+    other_key.processing_options = 3;
+    EXPECT_FALSE(scenegraph::readBakedScene(baked_scene, other_key).has_value());
+    EXPECT_NE(scenegraph::bakedSceneFileName(key), scenegraph::bakedSceneFileName(other_key));
+
+    // so are the primitives, which attributes would be read outside of the vertices
+    auto is_primitive_accepted = [&key, &dependencies, &buffers, &source_model](scenegraph::BakedPrimitive const& primitive)
+        {
+            return scenegraph::readBakedScene(scenegraph::writeBakedScene(key, dependencies, buffers, source_model, { primitive }), key).has_value();
+        };
+    EXPECT_TRUE(is_primitive_accepted(primitives[1]));
+    scenegraph::BakedPrimitive damaged_primitive = primitives[1];
+    damaged_primitive.attributes[0].offset = 28;    // 12-byte position at the end of a 36-byte vertex
+    damaged_primitive.position_offset = 28;
+    EXPECT_FALSE(is_primitive_accepted(damaged_primitive));
+    damaged_primitive = primitives[1];
+    damaged_primitive.attributes[0].element_count = 10;
+    EXPECT_FALSE(is_primitive_accepted(damaged_primitive));
+    damaged_primitive = primitives[1];
+    damaged_primitive.position_offset = 12;    // does not refer to the position attribute
+    EXPECT_FALSE(is_primitive_accepted(damaged_primitive));
+    damaged_primitive = primitives[1];
+    damaged_primitive.attributes[0].name = "NORMAL";
+    EXPECT_FALSE(is_primitive_accepted(damaged_primitive));
+    damaged_primitive = primitives[1];
+    damaged_primitive.vertices = {};
+    EXPECT_FALSE(is_primitive_accepted(damaged_primitive));
+
+    // and the ones, which refer to the missing parts of the model or index outside of their vertices
+    damaged_primitive = primitives[1];
+    damaged_primitive.mesh_id = 6;
+    EXPECT_FALSE(is_primitive_accepted(damaged_primitive));
+    damaged_primitive = primitives[1];
+    damaged_primitive.mesh_id = -1;
+    EXPECT_FALSE(is_primitive_accepted(damaged_primitive));
+    damaged_primitive = primitives[1];
+    damaged_primitive.primitive_index = 1;
+    EXPECT_FALSE(is_primitive_accepted(damaged_primitive));
+    std::vector<uint8_t> const out_of_range_indices{ 0, 0, 0, 0, 1, 0, 0, 0, 3, 0, 0, 0 };
+    damaged_primitive = primitives[1];
+    damaged_primitive.index_data = out_of_range_indices;
+    EXPECT_FALSE(is_primitive_accepted(damaged_primitive));
+    std::vector<uint32_t> out_of_range_meshlet_vertices{ meshlets.vertex_indices };
+    out_of_range_meshlet_vertices.back() = static_cast<uint32_t>(mesh.vertices.size() / mesh.vertex_stride);
+    damaged_primitive = primitives[0];
+    damaged_primitive.meshlet_vertex_indices = out_of_range_meshlet_vertices;
+    EXPECT_TRUE(is_primitive_accepted(primitives[0]));
+    EXPECT_FALSE(is_primitive_accepted(damaged_primitive));
+    std::vector<scenegraph::BakedBuffer> damaged_buffers{ buffers };
+    damaged_buffers[0].dependency_index = 2;
+    EXPECT_FALSE(scenegraph::readBakedScene(scenegraph::writeBakedScene(key, dependencies, damaged_buffers, source_model, primitives), key).has_value());
+
+    // the cross references of the glTF tables are validated as well
+    source_node.mesh = 6;
+    EXPECT_FALSE(is_primitive_accepted(primitives[1]));
+    source_node.mesh = 3;
+    int32_t const missing_node[] = { 1 };
+    tg3_scene damaged_scene{ source_scene };
+    damaged_scene.nodes = missing_node;
+    source_model.scenes = &damaged_scene;
+    EXPECT_FALSE(is_primitive_accepted(primitives[1]));
+    source_model.scenes = &source_scene;
+    EXPECT_TRUE(is_primitive_accepted(primitives[1]));
+
+    // so are the corrupted ones
+    std::vector<uint8_t> corrupted_scene{ baked_scene.begin(), baked_scene.end() - 16 };
+    EXPECT_FALSE(scenegraph::readBakedScene(corrupted_scene, key).has_value());
+    corrupted_scene = baked_scene;
+    corrupted_scene[8] += 1;    // format version
+    EXPECT_FALSE(scenegraph::readBakedScene(corrupted_scene, key).has_value());
+    for (size_t offset = 0; offset < 512; offset += 4)
+    {
+        // damaged header and primitive records must not produce views outside of the baked scene
+        corrupted_scene = baked_scene;
+        corrupted_scene[offset + 3] ^= 0x80;
+        if (auto const damaged_scene = scenegraph::readBakedScene(corrupted_scene, key))
+        {
+            uint8_t const* p_end = corrupted_scene.data() + corrupted_scene.size();
+            for (scenegraph::BakedPrimitive const& p : damaged_scene->primitives)
+            {
+                for (scenegraph::VertexAttributeLayout const& attribute : p.attributes)
+                {
+                    EXPECT_LE(attribute.offset + scenegraph::dataFormatSize(attribute.format) * attribute.element_count, p.vertex_stride);
+                }
+                EXPECT_TRUE(p.vertices.data() + p.vertices.size() <= p_end);
+                EXPECT_TRUE(p.index_data.data() + p.index_data.size() <= p_end);
+                EXPECT_TRUE(reinterpret_cast<uint8_t const*>(p.meshlets.data() + p.meshlets.size()) <= p_end);
+                for (scenegraph::Meshlet const& meshlet : p.meshlets)
+                {
+                    EXPECT_LE(meshlet.vertex_offset + meshlet.vertex_count, p.meshlet_vertex_indices.size());
+                    EXPECT_LE(meshlet.triangle_offset + 3 * meshlet.triangle_count, p.meshlet_triangle_indices.size());
+                }
+            }
+        }
+    }
+
+    // keys are computed from the contents of the source, so that they neither depend on the location nor on the modification time of the source
+    std::filesystem::path const source_path = std::filesystem::current_path() / "test_baked_scene_source.gltf";
+    std::filesystem::path const copied_source_path = std::filesystem::current_path() / "test_baked_scene_source_copy.gltf";
+    {
+        std::ofstream ofile{ source_path, std::ios::binary | std::ios::trunc };
+        ofile << "{}";
+    }
+    std::filesystem::copy_file(source_path, copied_source_path, std::filesystem::copy_options::overwrite_existing);
+    std::optional<scenegraph::BakedSceneKey> const source_key = scenegraph::makeBakedSceneKey(source_path, "index:0", 7);
+    ASSERT_TRUE(source_key.has_value());
+    EXPECT_EQ(source_key->processing_options, 7U);
+    std::optional<scenegraph::BakedSceneKey> const copied_source_key = scenegraph::makeBakedSceneKey(copied_source_path, "index:0", 7);
+    ASSERT_TRUE(copied_source_key.has_value());
+    EXPECT_TRUE(copied_source_key->source_id == source_key->source_id);
+    std::optional<scenegraph::BakedSceneKey> const other_scene_key = scenegraph::makeBakedSceneKey(source_path, "index:1", 7);
+    ASSERT_TRUE(other_scene_key.has_value());
+    EXPECT_FALSE(other_scene_key->source_id == source_key->source_id);
+    {
+        std::ofstream ofile{ source_path, std::ios::binary | std::ios::app };
+        ofile << " ";
+    }
+    std::optional<scenegraph::BakedSceneKey> const modified_source_key = scenegraph::makeBakedSceneKey(source_path, "index:0", 7);
+    ASSERT_TRUE(modified_source_key.has_value());
+    EXPECT_FALSE(modified_source_key->source_id == source_key->source_id);
+
+    // baked scenes replace the existing files as a whole
+    std::filesystem::path const baked_scene_path = std::filesystem::current_path() / scenegraph::bakedSceneFileName(key);
+    EXPECT_TRUE(scenegraph::writeBakedSceneFile(baked_scene_path, corrupted_scene));
+    EXPECT_TRUE(scenegraph::writeBakedSceneFile(baked_scene_path, baked_scene));
+    {
+        std::ifstream ifile{ baked_scene_path, std::ios::binary };
+        std::vector<uint8_t> const written_scene{ std::istreambuf_iterator<char>{ ifile }, std::istreambuf_iterator<char>{} };
+        EXPECT_TRUE(written_scene == baked_scene);
+    }
+    size_t file_count{ 0 };
+    for ([[maybe_unused]] auto const& entry : std::filesystem::directory_iterator{ std::filesystem::current_path() })
+    {
+        if (entry.path().filename().string().starts_with(baked_scene_path.filename().string())) ++file_count;
+    }
+    EXPECT_EQ(file_count, 1U);    // no temporary files are left behind
+
+    std::filesystem::remove(baked_scene_path);
+    std::filesystem::remove(copied_source_path);
+    std::filesystem::remove(source_path);
+    EXPECT_FALSE(scenegraph::makeBakedSceneKey(source_path, "index:0", 7).has_value());
+}
+
+TEST(EngineTests_Basic, TestConstantDataCache)
+{
+    using namespace lexgine::core::dx::d3d12;
+
+    // two groups of constants: 4 floats followed by 2 texture indices
+    float factors[4] = { 1.f, 2.f, 3.f, 4.f };
+    uint32_t texture_indices[2] = { 7U, 8U };
+    uint32_t group_writes[2] = { 0U, 0U };
+    auto write_group = [&](uint32_t group, void* p_data)
+    {
+        ++group_writes[group];
+        if (group == 0) memcpy(p_data, factors, sizeof(factors));
+        else memcpy(static_cast<uint8_t*>(p_data) + sizeof(factors), texture_indices, sizeof(texture_indices));
+    };
+
+    std::vector<std::vector<uint8_t>> uploads;
+    auto upload = [&uploads](std::span<uint8_t const> data)
+    {
+        uploads.emplace_back(data.begin(), data.end());
+        return static_cast<uint64_t>(uploads.size()) * 0x100;
+    };
+
+    ConstantDataCache cache{ sizeof(factors) + sizeof(texture_indices), 2 };
+    EXPECT_TRUE(cache.isDirty());
+
+    // repeated binds during the same frame serialize and upload the data once
+    for (int i = 0; i < 10; ++i)
+    {
+        cache.update(write_group);
+        EXPECT_EQ(cache.gpuAddress(1, upload), 0x100);
+    }
+    EXPECT_FALSE(cache.isDirty());
+    EXPECT_EQ(group_writes[0], 1U);
+    EXPECT_EQ(group_writes[1], 1U);
+    EXPECT_EQ(cache.uploadCount(), 1U);
+    ASSERT_EQ(uploads.size(), 1U);
+    EXPECT_EQ(memcmp(uploads[0].data(), factors, sizeof(factors)), 0);
+    EXPECT_EQ(memcmp(uploads[0].data() + sizeof(factors), texture_indices, sizeof(texture_indices)), 0);
+
+    // static data is re-uploaded on the next frame without being re-serialized
+    cache.update(write_group);
+    EXPECT_EQ(cache.gpuAddress(2, upload), 0x200);
+    cache.update(write_group);
+    EXPECT_EQ(cache.gpuAddress(2, upload), 0x200);
+    EXPECT_EQ(group_writes[0], 1U);
+    EXPECT_EQ(group_writes[1], 1U);
+    EXPECT_EQ(cache.uploadCount(), 2U);
+    EXPECT_EQ(uploads[1], uploads[0]);
+
+    // invalidation of a group re-serializes only this group and re-uploads the data during the same frame
+    texture_indices[1] = 9U;
+    cache.invalidate(1);
+    EXPECT_TRUE(cache.isDirty());
+    std::span<uint8_t const> serialized_data = cache.update(write_group);
+    EXPECT_EQ(group_writes[0], 1U);
+    EXPECT_EQ(group_writes[1], 2U);
+    EXPECT_EQ(memcmp(serialized_data.data() + sizeof(factors), texture_indices, sizeof(texture_indices)), 0);
+    EXPECT_EQ(cache.gpuAddress(2, upload), 0x300);
+    EXPECT_EQ(cache.gpuAddress(2, upload), 0x300);
+    EXPECT_EQ(cache.uploadCount(), 3U);
+    EXPECT_EQ(memcmp(uploads[2].data(), factors, sizeof(factors)), 0);
+
+    // resizing the block invalidates all groups, while resizing to the same size keeps the data
+    cache.resize(cache.size());
+    EXPECT_FALSE(cache.isDirty());
+    cache.resize(cache.size() + 16);
+    EXPECT_TRUE(cache.isDirty());
+    cache.update(write_group);
+    EXPECT_EQ(group_writes[0], 2U);
+    EXPECT_EQ(group_writes[1], 3U);
+    EXPECT_EQ(cache.gpuAddress(2, upload), 0x400);
+    EXPECT_EQ(uploads[3].size(), sizeof(factors) + sizeof(texture_indices) + 16);
+}
+
+TEST(EngineTests_Basic, TestConstantBufferDataMapper)
+{
+    using namespace lexgine::core;
+    using namespace lexgine::core::dx::d3d12;
+    using namespace lexgine::core::misc;
+    using BaseType = ConstantBufferReflection::ReflectionEntryBaseType;
+
+    std::filesystem::path test_logging_path = std::filesystem::current_path() / "test.log";
+    Log::create(test_logging_path, "Test Constant Buffer Data Mapper", LogMessageType::information);
+
+    {
+        struct ObjectConstants
+        {
+            math::Matrix4f world;
+            math::Vector4f color;
+            math::Vector3f scale;
+            bool is_visible;
+            math::Matrix3f normal_transform;
+            uint32_t object_index;
+            float time;
+        } constants{};
+
+        for (int i = 0; i < 4; ++i)
+            for (int j = 0; j < 4; ++j)
+                constants.world[i][j] = static_cast<float>(i * 4 + j);
+        constants.color = math::Vector4f{ .1f, .2f, .3f, .4f };
+        constants.scale = math::Vector3f{ 2.f, 3.f, 4.f };
+        constants.is_visible = true;
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+                constants.normal_transform[i][j] = static_cast<float>(100 + i * 3 + j);
+        constants.object_index = 42U;
+        std::vector<math::Vector4f> lights{ math::Vector4f{ 1.f }, math::Vector4f{ 2.f } };
+
+        ConstantBufferReflection reflection{};
+        reflection.addElement("world", { BaseType::float4x4, 1 });
+        reflection.addElement("color", { BaseType::float4, 1 });
+        reflection.addElement("scale", { BaseType::float3, 1 });
+        reflection.addElement("is_visible", { BaseType::bool1, 1 });
+        reflection.addElement("normal_transform", { BaseType::float3x3, 1 });
+        reflection.addElement("lights", { BaseType::float4, 4 });
+        reflection.addElement("object_index", { BaseType::uint1, 1 });
+
+        ConstantBufferDataMapper mapper{ reflection };
+        mapper.addDataBinding("world", constants.world);
+        mapper.addDataBinding("color", constants.color);
+        mapper.addDataBinding("scale", constants.scale);
+        mapper.addDataBinding("is_visible", constants.is_visible);
+        mapper.addDataBinding("normal_transform", constants.normal_transform);
+        mapper.addDataBinding("lights", lights);
+        mapper.addDataBinding("object_index", constants.object_index);
+
+        auto offset = [&reflection](char const* name) { return reflection[HashedString{ name }].offset(); };
+        auto find_write_operation = [&mapper](size_t destination_offset)
+        {
+            auto const& plan = mapper.writePlan();
+            auto p = std::find_if(plan.begin(), plan.end(),
+                [destination_offset](ConstantBufferDataMapper::WriteOperation const& op) { return op.destination_offset == destination_offset; });
+            return p != plan.end() ? &*p : nullptr;
+        };
+
+        // the world matrix and the color are adjacent both in the source and in the constant buffer and get copied at once
+        size_t const write_plan_size = mapper.writePlan().size();
+        EXPECT_EQ(write_plan_size, 6U);
+        ConstantBufferDataMapper::WriteOperation const* p_op = find_write_operation(offset("world"));
+        ASSERT_TRUE(p_op);
+        EXPECT_EQ(p_op->p_source, static_cast<void const*>(constants.world.getRawData()));
+        EXPECT_EQ(p_op->size, 80U);
+        EXPECT_EQ(p_op->count, 1U);
+        EXPECT_FALSE(find_write_operation(offset("color")));
+        ASSERT_TRUE(p_op = find_write_operation(offset("is_visible")));
+        EXPECT_EQ(p_op->conversion, ConstantDataConversion::bool_to_uint);
+        ASSERT_TRUE(p_op = find_write_operation(offset("normal_transform")));
+        EXPECT_EQ(p_op->count, 3U);
+        EXPECT_EQ(p_op->destination_stride, 16U);
+        ASSERT_TRUE(p_op = find_write_operation(offset("lights")));
+        EXPECT_EQ(p_op->p_source, nullptr);
+
+        auto check_written_data = [&](std::vector<uint8_t> const& buffer)
+        {
+            EXPECT_EQ(memcmp(buffer.data() + offset("world"), constants.world.getRawData(), 64), 0);
+            EXPECT_EQ(memcmp(buffer.data() + offset("color"), constants.color.getRawData(), 16), 0);
+            EXPECT_EQ(memcmp(buffer.data() + offset("scale"), constants.scale.getRawData(), 12), 0);
+
+            uint32_t is_visible{};
+            memcpy(&is_visible, buffer.data() + offset("is_visible"), 4);
+            EXPECT_EQ(is_visible, constants.is_visible ? 1U : 0U);
+
+            for (size_t i = 0; i < 3; ++i)
+            {
+                EXPECT_EQ(memcmp(buffer.data() + offset("normal_transform") + 16 * i, constants.normal_transform.getRawData() + 3 * i, 12), 0);
+            }
+            for (size_t i = 0; i < lights.size(); ++i)
+            {
+                EXPECT_EQ(memcmp(buffer.data() + offset("lights") + 16 * i, lights[i].getRawData(), 16), 0);
+            }
+            EXPECT_EQ(memcmp(buffer.data() + offset("object_index"), &constants.object_index, 4), 0);
+        };
+
+        std::vector<uint8_t> buffer(mapper.mappedDataSize(), 0);
+        mapper.writeAllBoundData(reinterpret_cast<uint64_t>(buffer.data()));
+        check_written_data(buffer);
+
+        // the plan reads the bound data on every write, and the bindings to vectors follow the changes of their size
+        constants.color.y = 5.f;
+        constants.is_visible = false;
+        lights.push_back(math::Vector4f{ 3.f });
+        mapper.writeAllBoundData(reinterpret_cast<uint64_t>(buffer.data()));
+        check_written_data(buffer);
+
+        // changes of the reflection cause the plan to get recompiled
+        uint64_t const revision = reflection.revision();
+        ConstantBufferReflection extended_reflection = reflection;
+        EXPECT_EQ(extended_reflection.revision(), revision);
+        reflection.addElement("time", { BaseType::float1, 1 });
+        EXPECT_NE(reflection.revision(), revision);
+
+        constants.time = 7.f;
+        mapper.addDataBinding("time", constants.time);
+        EXPECT_EQ(mapper.writePlan().size(), write_plan_size);
+        ASSERT_TRUE(p_op = find_write_operation(offset("object_index")));
+        EXPECT_EQ(p_op->size, 8U);
+        buffer.assign(mapper.mappedDataSize(), 0);
+        mapper.writeAllBoundData(reinterpret_cast<uint64_t>(buffer.data()));
+        check_written_data(buffer);
+        EXPECT_EQ(memcmp(buffer.data() + offset("time"), &constants.time, 4), 0);
+
+        // the bindings survive the move of the mapper, and concurrent writes through a mapper with an outdated plan compile the plan
+        // only once and all write the same data
+        ConstantBufferDataMapper moved_mapper{ std::move(mapper) };
+        reflection.addElement("padding", { BaseType::float1, 1 });
+
+        std::vector<std::vector<uint8_t>> thread_buffers(4, std::vector<uint8_t>(moved_mapper.mappedDataSize(), 0));
+        std::vector<std::thread> threads{};
+        for (auto& thread_buffer : thread_buffers)
+        {
+            threads.emplace_back([&moved_mapper, &thread_buffer]() { moved_mapper.writeAllBoundData(reinterpret_cast<uint64_t>(thread_buffer.data())); });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        for (auto const& thread_buffer : thread_buffers)
+        {
+            check_written_data(thread_buffer);
+            EXPECT_EQ(memcmp(thread_buffer.data() + offset("time"), &constants.time, 4), 0);
+        }
+
+        // microbenchmark of the per-draw constant updates
+        size_t const iteration_count = 100000;
+        auto const start_time = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < iteration_count; ++i)
+        {
+            moved_mapper.writeAllBoundData(reinterpret_cast<uint64_t>(buffer.data()));
+        }
+        auto const elapsed_time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - start_time);
+        Log::retrieve()->out("Constant buffer data mapper throughput: "
+            + std::to_string(static_cast<double>(moved_mapper.mappedDataSize() * iteration_count) / (std::max)(elapsed_time.count(), decltype(elapsed_time.count()){ 1 }))
+            + " bytes/ns", LogMessageType::information);
+    }
+
+    Log::shutdown();
+}
+
+TEST(EngineTests_Basic, TestResourceUploadPlanner)
+{
+    using namespace lexgine::core::dx::d3d12;
+
+    // records the commands without a device, the resources are only used as opaque handles by the planner
+    class RecordingUploadCommandSink final : public AbstractUploadCommandSink
+    {
+    public:
+        struct Command
+        {
+            enum class Type { transition_to_copy_destination, transition_from_copy_destination, buffer_copy, texture_copy } type;
+            std::vector<UploadDestination> destinations;
+            StagedBufferCopy buffer_copy;
+            StagedTextureCopy texture_copy;
+        };
+
+        void transitionDestinations(std::vector<UploadDestination> const& destinations, bool to_copy_destination_state) override
+        {
+            commands.push_back(Command{ .type = to_copy_destination_state ? Command::Type::transition_to_copy_destination : Command::Type::transition_from_copy_destination,
+                .destinations = destinations });
+        }
+
+        void copyBufferRegion(StagedBufferCopy const& copy) override
+        {
+            commands.push_back(Command{ .type = Command::Type::buffer_copy, .buffer_copy = copy });
+        }
+
+        void copyTextureRegion(StagedTextureCopy const& copy) override
+        {
+            commands.push_back(Command{ .type = Command::Type::texture_copy, .texture_copy = copy });
+        }
+
+        std::vector<Command> commands;
+    };
+
+    Resource const* p_buffer_a = fakeObject<Resource>(1);
+    Resource const* p_buffer_b = fakeObject<Resource>(2);
+    Resource const* p_buffer_c = fakeObject<Resource>(3);
+    Resource const* p_texture = fakeObject<Resource>(4);
+    ResourceState const buffer_state = ResourceState::base_values::vertex_and_constant_buffer;
+    ResourceState const texture_state = ResourceState::base_values::pixel_shader;
+
+    ResourceUploadPlanner planner{};
+    RecordingUploadCommandSink sink{};
+    EXPECT_EQ(planner.record(sink), 0U);
+    EXPECT_TRUE(sink.commands.empty());
+
+    // buffer B receives three copies that are adjacent both in the destination and in the staging buffer, but are submitted out of order
+    planner.addBufferCopy(buffer_state, { .p_destination_resource = p_buffer_b, .destination_offset = 256, .staging_offset = 1256, .size = 256 });
+    // buffer A receives two copies adjacent in the destination, but not in the staging buffer
+    planner.addBufferCopy(buffer_state, { .p_destination_resource = p_buffer_a, .destination_offset = 0, .staging_offset = 4000, .size = 100 });
+    planner.addBufferCopy(buffer_state, { .p_destination_resource = p_buffer_b, .destination_offset = 0, .staging_offset = 1000, .size = 256 });
+    planner.addTextureCopy(texture_state, { .p_destination_resource = p_texture, .destination_subresource = 0, .staging_offset = 8192,
+        .format = DXGI_FORMAT_R8G8B8A8_UNORM, .width = 16, .height = 16, .depth = 1, .row_pitch = 256 });
+    planner.addBufferCopy(buffer_state, { .p_destination_resource = p_buffer_a, .destination_offset = 100, .staging_offset = 5000, .size = 100 });
+    planner.addBufferCopy(buffer_state, { .p_destination_resource = p_buffer_b, .destination_offset = 512, .staging_offset = 1512, .size = 256 });
+    planner.addTextureCopy(texture_state, { .p_destination_resource = p_texture, .destination_subresource = 1, .staging_offset = 12288,
+        .format = DXGI_FORMAT_R8G8B8A8_UNORM, .width = 8, .height = 8, .depth = 1, .row_pitch = 256 });
+    // the copies into buffer C overlap, so that the later copy must still be executed after the earlier one
+    planner.addBufferCopy(buffer_state, { .p_destination_resource = p_buffer_c, .destination_offset = 100, .staging_offset = 6000, .size = 200 });
+    planner.addBufferCopy(buffer_state, { .p_destination_resource = p_buffer_c, .destination_offset = 0, .staging_offset = 6200, .size = 200 });
+    EXPECT_EQ(planner.pendingCopyCount(), 9U);
+
+    EXPECT_EQ(planner.record(sink), 7U);
+    EXPECT_TRUE(planner.empty());
+
+    using CommandType = RecordingUploadCommandSink::Command::Type;
+    ASSERT_EQ(sink.commands.size(), 9U);
+
+    // all destinations are transitioned at once, in the order of their first appearance
+    auto const& commands = sink.commands;
+    EXPECT_EQ(commands.front().type, CommandType::transition_to_copy_destination);
+    EXPECT_EQ(commands.back().type, CommandType::transition_from_copy_destination);
+    for (auto const& transition : { commands.front(), commands.back() })
+    {
+        ASSERT_EQ(transition.destinations.size(), 4U);
+        EXPECT_EQ(transition.destinations[0].p_resource, p_buffer_b);
+        EXPECT_EQ(transition.destinations[1].p_resource, p_buffer_a);
+        EXPECT_EQ(transition.destinations[2].p_resource, p_texture);
+        EXPECT_EQ(transition.destinations[3].p_resource, p_buffer_c);
+        EXPECT_TRUE(transition.destinations[0].state == buffer_state);
+        EXPECT_TRUE(transition.destinations[2].state == texture_state);
+    }
+
+    auto expect_buffer_copy = [&commands](size_t index, Resource const* p_destination, uint64_t destination_offset, uint64_t staging_offset, uint64_t size)
+    {
+        ASSERT_EQ(commands[index].type, CommandType::buffer_copy);
+        StagedBufferCopy const& copy = commands[index].buffer_copy;
+        EXPECT_EQ(copy.p_destination_resource, p_destination);
+        EXPECT_EQ(copy.destination_offset, destination_offset);
+        EXPECT_EQ(copy.staging_offset, staging_offset);
+        EXPECT_EQ(copy.size, size);
+    };
+    expect_buffer_copy(1, p_buffer_b, 0, 1000, 768);
+    expect_buffer_copy(2, p_buffer_a, 0, 4000, 100);
+    expect_buffer_copy(3, p_buffer_a, 100, 5000, 100);
+    expect_buffer_copy(4, p_buffer_c, 100, 6000, 200);
+    expect_buffer_copy(5, p_buffer_c, 0, 6200, 200);
+
+    ASSERT_EQ(commands[6].type, CommandType::texture_copy);
+    EXPECT_EQ(commands[6].texture_copy.destination_subresource, 0U);
+    EXPECT_EQ(commands[6].texture_copy.staging_offset, 8192U);
+    ASSERT_EQ(commands[7].type, CommandType::texture_copy);
+    EXPECT_EQ(commands[7].texture_copy.destination_subresource, 1U);
+    EXPECT_EQ(commands[7].texture_copy.width, 8U);
+
+    // the planner starts a new batch after recording
+    sink.commands.clear();
+    planner.addBufferCopy(buffer_state, { .p_destination_resource = p_buffer_a, .destination_offset = 0, .staging_offset = 0, .size = 16 });
+    EXPECT_EQ(planner.record(sink), 1U);
+    ASSERT_EQ(sink.commands.size(), 3U);
+    EXPECT_EQ(sink.commands[0].destinations.size(), 1U);
+}
+
+TEST(EngineTests_Basic, TestDescriptorRangeAllocator)
+{
+    using namespace lexgine::core::dx::d3d12;
+
+    {
+        DescriptorRangeAllocator allocator{ 64 };
+        DescriptorRange a = allocator.allocate(16);
+        DescriptorRange b = allocator.allocate(16);
+        DescriptorRange c = allocator.allocate(32);
+        ASSERT_FALSE(a.isNull() || b.isNull() || c.isNull());
+        EXPECT_EQ(a.offset, 0U);
+        EXPECT_EQ(b.offset, 16U);
+        EXPECT_EQ(c.offset, 32U);
+        EXPECT_TRUE(allocator.allocate(1).isNull());
+
+        // stale handles are rejected
+        EXPECT_TRUE(allocator.free(b));
+        EXPECT_FALSE(allocator.isValid(b));
+        EXPECT_FALSE(allocator.free(b));
+        DescriptorRange b_reused = allocator.allocate(16);
+        EXPECT_EQ(b_reused.offset, 16U);
+        EXPECT_FALSE(allocator.isValid(b));
+        EXPECT_TRUE(allocator.isValid(b_reused));
+
+        // retired ranges are only released after their fence values have been reached
+        EXPECT_TRUE(allocator.retire(a, 1));
+        EXPECT_FALSE(allocator.retire(a, 1));
+        EXPECT_FALSE(allocator.free(a));
+        EXPECT_TRUE(allocator.retire(c, 2));
+        EXPECT_EQ(allocator.retiredCount(), 48U);
+        EXPECT_TRUE(allocator.allocate(16).isNull());
+        EXPECT_EQ(allocator.releaseCompleted(0), 0U);
+        EXPECT_EQ(allocator.releaseCompleted(1), 1U);
+        EXPECT_EQ(allocator.largestFreeRange(), 16U);
+        EXPECT_EQ(allocator.releaseCompleted(5), 1U);
+        EXPECT_EQ(allocator.retiredCount(), 0U);
+        EXPECT_EQ(allocator.allocatedCount(), 16U);
+        EXPECT_EQ(allocator.freeRangeCount(), 2U);
+
+        // coalescing restores the whole heap
+        EXPECT_TRUE(allocator.free(b_reused));
+        EXPECT_EQ(allocator.freeRangeCount(), 1U);
+        EXPECT_EQ(allocator.largestFreeRange(), 64U);
+
+        DescriptorRange d = allocator.allocate(64);
+        EXPECT_FALSE(d.isNull());
+        allocator.reset();
+        EXPECT_FALSE(allocator.isValid(d));
+        EXPECT_EQ(allocator.allocatedCount(), 0U);
+        EXPECT_EQ(allocator.largestFreeRange(), 64U);
+    }
+
+    // randomized allocations, releases and retirements checked against a plain occupancy map of the heap
+    {
+        uint32_t const capacity = 4096;
+        DescriptorRangeAllocator allocator{ capacity };
+        std::vector<bool> occupancy(capacity, false);
+        std::vector<DescriptorRange> live_ranges;
+        std::vector<std::pair<DescriptorRange, uint64_t>> retired_ranges;
+        std::vector<DescriptorRange> stale_ranges;
+        uint64_t fence_value{ 0U };
+        uint64_t completed_fence_value{ 0U };
+        uint32_t expected_allocated_count{ 0U };
+
+        std::mt19937 rng{ 0xDE5C };
+        auto random = [&rng](uint32_t max_value) { return std::uniform_int_distribution<uint32_t>{ 0, max_value }(rng); };
+
+        auto release_occupancy = [&occupancy, &expected_allocated_count](DescriptorRange const& range)
+        {
+            for (uint32_t i = range.offset; i < range.offset + range.count; ++i) occupancy[i] = false;
+            expected_allocated_count -= range.count;
+        };
+
+        for (int step = 0; step < 200000; ++step)
+        {
+            uint32_t action = random(99);
+            if (action < 45)
+            {
+                uint32_t count = random(7) == 0 ? 1 + random(255) : 1 + random(15);
+                DescriptorRange range = allocator.allocate(count);
+                if (range.isNull())
+                {
+                    // allocation may only fail when there is no free range large enough
+                    EXPECT_LT(allocator.largestFreeRange(), count);
+                    continue;
+                }
+                ASSERT_EQ(range.count, count);
+                ASSERT_LE(range.offset + range.count, capacity);
+                for (uint32_t i = range.offset; i < range.offset + range.count; ++i)
+                {
+                    ASSERT_FALSE(occupancy[i]);
+                    occupancy[i] = true;
+                }
+                expected_allocated_count += count;
+                live_ranges.push_back(range);
+            }
+            else if (action < 70 && !live_ranges.empty())
+            {
+                size_t index = random(static_cast<uint32_t>(live_ranges.size() - 1));
+                DescriptorRange range = live_ranges[index];
+                live_ranges[index] = live_ranges.back();
+                live_ranges.pop_back();
+
+                ASSERT_TRUE(allocator.free(range));
+                release_occupancy(range);
+                stale_ranges.push_back(range);
+            }
+            else if (action < 90 && !live_ranges.empty())
+            {
+                size_t index = random(static_cast<uint32_t>(live_ranges.size() - 1));
+                DescriptorRange range = live_ranges[index];
+                live_ranges[index] = live_ranges.back();
+                live_ranges.pop_back();
+
+                ASSERT_TRUE(allocator.retire(range, fence_value + 1));
+                ASSERT_FALSE(allocator.free(range));
+                retired_ranges.emplace_back(range, fence_value + 1);
+            }
+            else if (action < 95)
+            {
+                // next frame: the GPU lags behind by up to 3 frames
+                ++fence_value;
+                completed_fence_value = (std::max)(completed_fence_value, fence_value - (std::min)(fence_value, uint64_t{ random(3) }));
+                size_t released_count = allocator.releaseCompleted(completed_fence_value);
+
+                size_t expected_released_count{ 0U };
+                for (size_t i = 0; i < retired_ranges.size();)
+                {
+                    if (retired_ranges[i].second <= completed_fence_value)
+                    {
+                        release_occupancy(retired_ranges[i].first);
+                        stale_ranges.push_back(retired_ranges[i].first);
+                        retired_ranges[i] = retired_ranges.back();
+                        retired_ranges.pop_back();
+                        ++expected_released_count;
+                    }
+                    else ++i;
+                }
+                ASSERT_EQ(released_count, expected_released_count);
+            }
+            else if (!stale_ranges.empty())
+            {
+                DescriptorRange const& range = stale_ranges[random(static_cast<uint32_t>(stale_ranges.size() - 1))];
+                ASSERT_FALSE(allocator.isValid(range));
+                ASSERT_FALSE(allocator.free(range));
+                ASSERT_FALSE(allocator.retire(range, fence_value + 1));
+            }
+
+            ASSERT_EQ(allocator.allocatedCount(), expected_allocated_count);
+            if (stale_ranges.size() > 1024) stale_ranges.erase(stale_ranges.begin(), stale_ranges.begin() + 512);
+        }
+
+        for (DescriptorRange const& range : live_ranges)
+        {
+            ASSERT_TRUE(allocator.isValid(range));
+            ASSERT_TRUE(allocator.free(range));
+        }
+        allocator.releaseCompleted(fence_value);
+
+        // once everything is released the free ranges must have been coalesced back into the whole heap
+        EXPECT_EQ(allocator.allocatedCount(), 0U);
+        EXPECT_EQ(allocator.retiredCount(), 0U);
+        EXPECT_EQ(allocator.freeRangeCount(), 1U);
+        EXPECT_EQ(allocator.largestFreeRange(), capacity);
+    }
+}
+
+TEST(EngineTests_Basic, TestDescriptorCache)
+{
+    using namespace lexgine::core::dx::d3d12;
+    using lexgine::core::misc::HashValue;
+
+    // the cache is backed by the device-independent allocator, the descriptors are "written" into a plain array mirroring the heap
+    uint32_t const heap_capacity = 64;
+    DescriptorRangeAllocator heap_allocator{ heap_capacity };
+    std::vector<uint32_t> heap(heap_capacity, 0U);
+    std::vector<DescriptorRange> released_ranges;
+
+    auto make_key = [](uint32_t descriptor_id) { return HashValue{ &descriptor_id, sizeof(descriptor_id) }; };
+    auto make_writer = [&heap](uint32_t descriptor_id)
+    {
+        return [&heap, descriptor_id](DescriptorRange const& range)
+        {
+            std::fill(heap.begin() + range.offset, heap.begin() + range.offset + range.count, descriptor_id);
+        };
+    };
+
+    {
+        DescriptorCache cache{
+            [&heap_allocator](uint32_t count) { return heap_allocator.allocate(count); },
+            [&heap_allocator, &released_ranges](DescriptorRange const& range) { released_ranges.push_back(range); return heap_allocator.free(range); },
+            2U, 1U };
+
+        // equivalent descriptors are created once and share the range
+        DescriptorCacheLookup a = cache.acquire(make_key(1), 16, make_writer(1));
+        DescriptorCacheLookup a_again = cache.acquire(make_key(1), 16, make_writer(100));
+        DescriptorCacheLookup b = cache.acquire(make_key(2), 16, make_writer(2));
+        EXPECT_FALSE(a.is_hit);
+        EXPECT_TRUE(a_again.is_hit);
+        EXPECT_FALSE(b.is_hit);
+        EXPECT_EQ(a.range.offset, a_again.range.offset);
+        EXPECT_NE(a.range.offset, b.range.offset);
+        EXPECT_EQ(heap[a.range.offset], 1U);
+        EXPECT_EQ(heap[b.range.offset + 15], 2U);
+
+        DescriptorCacheStatistics statistics = cache.statistics();
+        EXPECT_EQ(statistics.hits, 1U);
+        EXPECT_EQ(statistics.misses, 2U);
+        EXPECT_EQ(statistics.entry_count, 2U);
+        EXPECT_EQ(statistics.unreferenced_entry_count, 0U);
+
+        // unreferenced entries stay cached until the budget is exceeded, then the least recently used ones are evicted first
+        cache.release(make_key(1));
+        EXPECT_EQ(cache.statistics().unreferenced_entry_count, 0U);
+        cache.release(make_key(1));
+        cache.release(make_key(2));
+        EXPECT_EQ(cache.statistics().unreferenced_entry_count, 2U);
+        EXPECT_TRUE(released_ranges.empty());
+
+        DescriptorCacheLookup b_revived = cache.acquire(make_key(2), 16, make_writer(200));
+        EXPECT_TRUE(b_revived.is_hit);
+        EXPECT_EQ(heap[b_revived.range.offset], 2U);
+        cache.release(make_key(2));    // now entry 1 is the least recently used
+
+        cache.acquire(make_key(3), 8, make_writer(3));
+        cache.release(make_key(3));
+        ASSERT_EQ(released_ranges.size(), 1U);
+        EXPECT_EQ(released_ranges[0].offset, a.range.offset);
+        EXPECT_EQ(cache.statistics().evictions, 1U);
+        EXPECT_FALSE(cache.acquire(make_key(1), 16, make_writer(1)).is_hit);
+
+        // exhaustion of the heap evicts unreferenced entries to make room
+        DescriptorCacheLookup large = cache.acquire(make_key(4), 48, make_writer(4));
+        ASSERT_FALSE(large.range.isNull());
+        EXPECT_EQ(heap[large.range.offset + 47], 4U);
+        statistics = cache.statistics();
+        EXPECT_EQ(statistics.entry_count, 2U);    // entries 1 and 4 are referenced, entries 2 and 3 have been evicted
+        EXPECT_EQ(statistics.evictions, 3U);
+
+        // referenced entries are never evicted
+        DescriptorCacheLookup failed = cache.acquire(make_key(5), 8, make_writer(5));
+        EXPECT_TRUE(failed.range.isNull());
+        EXPECT_EQ(cache.statistics().failed_allocations, 1U);
+        EXPECT_EQ(cache.statistics().entry_count, 2U);
+    }
+
+    // the evicted ranges retired until the frames in flight complete do not make room, so that the exhausted heap does not flush the cache
+    {
+        DescriptorRangeAllocator deferring_heap_allocator{ heap_capacity };
+        uint64_t completed_frame_count{ 0U };
+        uint64_t const retirement_latency{ 2U };
+
+        DescriptorCache cache{
+            [&](uint32_t count)
+            {
+                DescriptorRange rv = deferring_heap_allocator.allocate(count);
+                if (rv.isNull())
+                {
+                    deferring_heap_allocator.releaseCompleted(completed_frame_count);
+                    rv = deferring_heap_allocator.allocate(count);
+                }
+                return rv;
+            },
+            [&](DescriptorRange const& range)
+            {
+                deferring_heap_allocator.retire(range, completed_frame_count + retirement_latency);
+                return false;
+            },
+            64U, 4U };
+
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            ASSERT_FALSE(cache.acquire(make_key(i), 8, make_writer(i)).range.isNull());
+            cache.release(make_key(i));
+        }
+
+        DescriptorCacheLookup failed = cache.acquire(make_key(8), 8, make_writer(8));
+        EXPECT_TRUE(failed.range.isNull());
+        DescriptorCacheStatistics statistics = cache.statistics();
+        EXPECT_EQ(statistics.failed_allocations, 1U);
+        EXPECT_EQ(statistics.evictions, 1U);
+        EXPECT_EQ(statistics.entry_count, 7U);
+        EXPECT_EQ(deferring_heap_allocator.retiredCount(), 8U);
+
+        // once the frames that could have referenced the evicted range complete, the range gets reclaimed by the allocation
+        completed_frame_count += retirement_latency;
+        DescriptorCacheLookup reclaimed = cache.acquire(make_key(8), 8, make_writer(8));
+        ASSERT_FALSE(reclaimed.range.isNull());
+        EXPECT_EQ(heap[reclaimed.range.offset], 8U);
+        statistics = cache.statistics();
+        EXPECT_EQ(statistics.evictions, 1U);
+        EXPECT_EQ(statistics.entry_count, 8U);
+        EXPECT_EQ(deferring_heap_allocator.retiredCount(), 0U);
+    }
+
+    // concurrent lookups of overlapping key sets must create each descriptor once while the key stays referenced
+    {
+        DescriptorRangeAllocator shared_heap_allocator{ 1U << 16 };
+        std::mutex heap_allocator_mutex;
+        std::atomic_uint32_t write_count{ 0U };
+
+        DescriptorCache cache{
+            [&](uint32_t count) { std::lock_guard<std::mutex> lock{ heap_allocator_mutex }; return shared_heap_allocator.allocate(count); },
+            [&](DescriptorRange const& range) { std::lock_guard<std::mutex> lock{ heap_allocator_mutex }; return shared_heap_allocator.free(range); },
+            1U << 20 };
+
+        std::vector<std::thread> threads;
+        std::vector<std::vector<DescriptorRange>> ranges_per_thread(4);
+        for (uint32_t t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&cache, &write_count, &ranges_per_thread, &make_key, t]()
+                {
+                    for (uint32_t i = 0; i < 1000; ++i)
+                    {
+                        uint32_t const id = (i * 7 + t) % 1000;
+                        DescriptorCacheLookup lookup = cache.acquire(make_key(id), 1 + id % 4,
+                            [&write_count](DescriptorRange const&) { write_count.fetch_add(1, std::memory_order_relaxed); });
+                        ranges_per_thread[t].push_back(lookup.range);
+                    }
+                });
+        }
+        for (std::thread& thread : threads) thread.join();
+
+        DescriptorCacheStatistics statistics = cache.statistics();
+        EXPECT_EQ(write_count.load(), 1000U);
+        EXPECT_EQ(statistics.misses, 1000U);
+        EXPECT_EQ(statistics.hits, 3000U);
+        EXPECT_EQ(statistics.entry_count, 1000U);
+        EXPECT_EQ(shared_heap_allocator.allocatedCount(), 2500U);
+    }
+}
+
+TEST(EngineTests_Basic, TestResourceStateTracker)
+{
+    using namespace lexgine::core::dx::d3d12;
+
+    class RecordingBarrierSink final : public AbstractResourceBarrierSink
+    {
+    public:
+        void applyBarriers(std::vector<TrackedResourceBarrier> const& barriers) override
+        {
+            batches.push_back(barriers);
+        }
+
+        std::vector<std::vector<TrackedResourceBarrier>> batches;
+    };
+
+    Resource const* p_buffer = fakeObject<Resource>(1);
+    Resource const* p_texture = fakeObject<Resource>(2);    // 4 subresources
+    using state = ResourceState::base_values;
+    uint32_t const all = TrackedResourceBarrier::c_all_subresources;
+
+    // the fake resources are identified by their indices
+    auto fake_resource_id = [](Resource const* p_resource) { return static_cast<uint64_t>(fakeObjectId(p_resource)); };
+
+    // the first use of each resource is not transitioned, but becomes the initial state requirement of the list
+    {
+        ResourceStateTracker tracker{};
+        RecordingBarrierSink sink{};
+        tracker.requestState(p_buffer, 1, state::copy_destination);
+        tracker.requestState(p_texture, 4, state::render_target);
+        EXPECT_EQ(tracker.flush(sink), 0U);
+        EXPECT_TRUE(sink.batches.empty());
+        ASSERT_EQ(tracker.initialStateRequirements().size(), 2U);
+        EXPECT_EQ(tracker.initialStateRequirements()[0].p_resource, p_buffer);
+        EXPECT_EQ(tracker.initialStateRequirements()[0].subresource, all);
+        EXPECT_TRUE(tracker.initialStateRequirements()[0].state == state::copy_destination);
+        EXPECT_EQ(tracker.initialStateRequirements()[1].subresource, all);
+
+        // redundant requests are dropped, the requests for read states made between two flushes are combined
+        tracker.requestState(p_texture, 4, state::pixel_shader);
+        tracker.requestState(p_buffer, 1, state::copy_destination);
+        tracker.requestState(p_texture, 4, state::non_pixel_shader);
+        tracker.requestState(p_buffer, 1, state::vertex_and_constant_buffer);
+        EXPECT_EQ(tracker.flush(sink), 2U);
+        ASSERT_EQ(sink.batches.size(), 1U);
+        auto const& batch = sink.batches[0];
+        EXPECT_EQ(batch[0].p_resource, p_texture);
+        EXPECT_EQ(batch[0].subresource, all);
+        EXPECT_TRUE(batch[0].state_before == state::render_target);
+        EXPECT_TRUE(batch[0].state_after == (ResourceState{ state::pixel_shader } | state::non_pixel_shader));
+        EXPECT_EQ(batch[1].p_resource, p_buffer);
+        EXPECT_TRUE(batch[1].state_after == state::vertex_and_constant_buffer);
+
+        // the subresource already readable in the requested way is not transitioned
+        tracker.requestState(p_texture, 4, state::pixel_shader, 2);
+        EXPECT_EQ(tracker.flush(sink), 0U);
+
+        // the transitions of individual subresources are only merged when all of them are transitioned the same way
+        tracker.requestState(p_texture, 4, state::render_target, 1);
+        tracker.requestState(p_texture, 4, state::render_target, 3);
+        EXPECT_EQ(tracker.flush(sink), 2U);
+        EXPECT_EQ(sink.batches.back()[0].subresource, 1U);
+        EXPECT_EQ(sink.batches.back()[1].subresource, 3U);
+
+        tracker.requestState(p_texture, 4, state::copy_source);
+        EXPECT_EQ(tracker.flush(sink), 4U);
+        tracker.requestState(p_texture, 4, state::copy_destination);
+        EXPECT_EQ(tracker.flush(sink), 1U);
+        EXPECT_EQ(sink.batches.back()[0].subresource, all);
+
+        // UAV barrier is dropped when the resource is transitioned anyway
+        tracker.requestUAVBarrier(p_buffer);
+        tracker.requestUAVBarrier(p_buffer);
+        EXPECT_EQ(tracker.flush(sink), 1U);
+        EXPECT_EQ(sink.batches.back()[0].type, TrackedResourceBarrierType::uav);
+        tracker.requestUAVBarrier(p_buffer);
+        tracker.requestState(p_buffer, 1, state::unordered_access);
+        EXPECT_EQ(tracker.flush(sink), 1U);
+        EXPECT_EQ(sink.batches.back()[0].type, TrackedResourceBarrierType::transition);
+
+        auto final_states = tracker.finalStates();
+        ASSERT_EQ(final_states.size(), 2U);
+        EXPECT_TRUE(final_states[0].state == state::unordered_access);
+        EXPECT_EQ(final_states[1].subresource, all);
+        EXPECT_TRUE(final_states[1].state == state::copy_destination);
+    }
+
+    // split transitions
+    {
+        ResourceStateTracker tracker{};
+        RecordingBarrierSink sink{};
+        tracker.requestState(p_buffer, 1, state::unordered_access);
+        tracker.requestState(p_texture, 4, state::render_target);
+        tracker.flush(sink);
+
+        tracker.beginTransition(p_texture, 4, state::pixel_shader);
+        EXPECT_EQ(tracker.flush(sink), 1U);
+        EXPECT_EQ(sink.batches.back()[0].split_flags, SplitResourceBarrierFlags::begin);
+
+        tracker.requestState(p_texture, 4, state::pixel_shader);
+        EXPECT_EQ(tracker.flush(sink), 1U);
+        EXPECT_EQ(sink.batches.back()[0].split_flags, SplitResourceBarrierFlags::end);
+        EXPECT_TRUE(sink.batches.back()[0].state_before == state::render_target);
+        EXPECT_TRUE(sink.batches.back()[0].state_after == state::pixel_shader);
+
+        // the transition needed before its beginning has been flushed is promoted to the ordinary one
+        tracker.beginTransition(p_buffer, 1, state::non_pixel_shader);
+        tracker.requestState(p_buffer, 1, state::non_pixel_shader);
+        EXPECT_EQ(tracker.flush(sink), 1U);
+        EXPECT_EQ(sink.batches.back()[0].split_flags, SplitResourceBarrierFlags::none);
+        EXPECT_EQ(tracker.statistics().promoted_split_transitions, 1U);
+
+        // the split transition into another state is completed before the resource is transitioned further
+        tracker.beginTransition(p_texture, 4, state::render_target);
+        tracker.flush(sink);
+        tracker.requestState(p_texture, 4, state::copy_source);
+        EXPECT_EQ(tracker.flush(sink), 2U);
+        EXPECT_EQ(sink.batches.back()[0].split_flags, SplitResourceBarrierFlags::end);
+        EXPECT_TRUE(sink.batches.back()[1].state_before == state::render_target);
+        EXPECT_TRUE(sink.batches.back()[1].state_after == state::copy_source);
+
+        // finalization completes the outstanding split transitions
+        tracker.beginTransition(p_buffer, 1, state::unordered_access);
+        tracker.flush(sink);
+        EXPECT_EQ(tracker.finalize(sink), 1U);
+        EXPECT_EQ(sink.batches.back()[0].split_flags, SplitResourceBarrierFlags::end);
+    }
+
+    // random command lists are executed against a model of the GPU, which validates every barrier
+    {
+        struct ModelSubresource
+        {
+            ResourceState state;
+            bool is_in_split_transition;
+            ResourceState split_state_before;
+        };
+
+        ResourceState const states[] = { state::common, state::render_target, state::unordered_access, state::depth_write, state::depth_read,
+            state::pixel_shader, state::non_pixel_shader, state::copy_source, state::copy_destination, state::vertex_and_constant_buffer };
+        uint32_t const subresource_counts[] = { 1, 1, 3, 6 };
+        uint32_t const resource_count = 4;
+
+        std::mt19937 rng{ 12345 };
+        ResourceStateRegistry registry{ fake_resource_id };
+        std::vector<std::vector<ModelSubresource>> gpu(resource_count);
+        for (uint32_t r = 0; r < resource_count; ++r)
+        {
+            registry.registerResource(fakeObject<Resource>(r + 1), subresource_counts[r], state::common);
+            gpu[r].assign(subresource_counts[r], ModelSubresource{ .state = state::common, .is_in_split_transition = false });
+        }
+
+        auto execute = [&](std::vector<TrackedResourceBarrier> const& barriers)
+        {
+            for (auto const& b : barriers)
+            {
+                uint32_t r = fakeObjectId(b.p_resource) - 1;
+                if (b.type == TrackedResourceBarrierType::uav) continue;
+                EXPECT_FALSE(b.state_before == b.state_after);
+
+                uint32_t first = b.subresource == all ? 0 : b.subresource;
+                uint32_t last = b.subresource == all ? subresource_counts[r] : b.subresource + 1;
+                for (uint32_t i = first; i < last; ++i)
+                {
+                    ModelSubresource& s = gpu[r][i];
+                    if (b.split_flags == SplitResourceBarrierFlags::end)
+                    {
+                        ASSERT_TRUE(s.is_in_split_transition);
+                        ASSERT_TRUE(s.split_state_before == b.state_before && s.state == b.state_after);
+                        s.is_in_split_transition = false;
+                        continue;
+                    }
+
+                    ASSERT_FALSE(s.is_in_split_transition);
+                    ASSERT_TRUE(s.state == b.state_before);
+                    s.split_state_before = s.state;
+                    s.state = b.state_after;
+                    s.is_in_split_transition = b.split_flags == SplitResourceBarrierFlags::begin;
+                }
+            }
+        };
+
+        uint32_t const read_only_states = (ResourceState{ state::generic_read } | state::pixel_shader | state::non_pixel_shader | state::depth_read).getValue();
+        auto is_accessible = [read_only_states](ResourceState requested_state, ResourceState current_state)
+        {
+            uint32_t requested = requested_state.getValue(), current = current_state.getValue();
+            return requested == current
+                || requested != 0 && (requested & ~read_only_states) == 0 && (current & ~read_only_states) == 0 && (requested & current) == requested;
+        };
+
+        uint64_t emitted_barrier_count{ 0U }, requested_transition_count{ 0U };
+        for (uint32_t list = 0; list < 500; ++list)
+        {
+            ResourceStateTracker tracker{};
+            RecordingBarrierSink sink{};
+
+            // the list is recorded first and is executed at submission along with the barriers resolved against the registry
+            std::vector<std::vector<TrackedResourceBarrier>> recorded_batches;
+            std::vector<std::map<std::pair<uint32_t, uint32_t>, ResourceState>> accesses_after_batch;
+            for (uint32_t step = 0; step < 30; ++step)
+            {
+                std::map<std::pair<uint32_t, uint32_t>, ResourceState> accesses;
+                uint32_t request_count = 1 + rng() % 4;
+                for (uint32_t k = 0; k < request_count; ++k)
+                {
+                    uint32_t r = rng() % resource_count;
+                    uint32_t subresource = rng() % 3 == 0 ? all : static_cast<uint32_t>(rng() % subresource_counts[r]);
+                    uint32_t first = subresource == all ? 0 : subresource;
+                    uint32_t last = subresource == all ? subresource_counts[r] : subresource + 1;
+                    ResourceState s = states[rng() % std::size(states)];
+                    switch (rng() % 6)
+                    {
+                    case 0:
+                        // the subresources announced for transition are not accessed until requested
+                        tracker.beginTransition(fakeObject<Resource>(r + 1), subresource_counts[r], s, subresource);
+                        for (uint32_t i = first; i < last; ++i) accesses.erase({ r, i });
+                        break;
+                    case 1:
+                        tracker.requestUAVBarrier(fakeObject<Resource>(r + 1));
+                        break;
+                    default:
+                        tracker.requestState(fakeObject<Resource>(r + 1), subresource_counts[r], s, subresource);
+                        requested_transition_count += last - first;
+                        for (uint32_t i = first; i < last; ++i) accesses[{ r, i }] = s;
+                    }
+                }
+
+                size_t batch_count = sink.batches.size();
+                tracker.flush(sink);
+                recorded_batches.push_back(sink.batches.size() > batch_count ? sink.batches.back() : std::vector<TrackedResourceBarrier>{});
+                accesses_after_batch.push_back(std::move(accesses));
+            }
+
+            size_t batch_count = sink.batches.size();
+            tracker.finalize(sink);
+            for (size_t b = batch_count; b < sink.batches.size(); ++b) recorded_batches.push_back(sink.batches[b]);
+            emitted_barrier_count += tracker.statistics().emitted_transitions;
+
+            // every barrier is validated by the model, and the subresources must be accessible as requested after each batch
+            execute(registry.resolve(tracker));
+            for (size_t b = 0; b < recorded_batches.size(); ++b)
+            {
+                execute(recorded_batches[b]);
+                if (b >= accesses_after_batch.size()) continue;
+
+                for (auto const& [subresource, requested_state] : accesses_after_batch[b])
+                {
+                    ModelSubresource const& s = gpu[subresource.first][subresource.second];
+                    ASSERT_FALSE(s.is_in_split_transition);
+                    ASSERT_TRUE(is_accessible(requested_state, s.state));
+                }
+            }
+
+            // the registry must agree with the model on the states, in which the list has left the resources
+            for (uint32_t r = 0; r < resource_count; ++r)
+            {
+                for (uint32_t i = 0; i < subresource_counts[r]; ++i)
+                {
+                    ASSERT_FALSE(gpu[r][i].is_in_split_transition);
+                    ASSERT_TRUE(registry.state(fakeObject<Resource>(r + 1), i) == gpu[r][i].state);
+                }
+            }
+        }
+        EXPECT_LT(emitted_barrier_count, requested_transition_count);
+    }
+
+    // the transitions recorded bypassing the tracker are followed by the registry
+    {
+        ResourceStateRegistry registry{ fake_resource_id };
+        registry.registerResource(p_buffer, 1, state::common);
+
+        ResourceStateTracker tracker{};
+        EXPECT_TRUE(tracker.isEmpty());
+        tracker.recordManualTransition(1, all, state::copy_destination);
+        tracker.recordManualTransition(2, 1, state::render_target);
+        tracker.recordManualTransition(2, 3, state::copy_source);
+        tracker.recordManualTransition(2, 1, state::pixel_shader);
+        EXPECT_FALSE(tracker.isEmpty());
+        EXPECT_TRUE(registry.resolve(tracker).empty());
+        EXPECT_TRUE(registry.state(p_buffer, 0) == state::copy_destination);
+
+        // the manual states of the resource unknown to the registry are replayed once its subresource count becomes known
+        EXPECT_TRUE(registry.adoptResource(p_texture, 4, state::non_pixel_shader));
+        EXPECT_FALSE(registry.adoptResource(p_texture, 4, state::common));
+        EXPECT_TRUE(registry.state(p_texture, 0) == state::non_pixel_shader);
+        EXPECT_TRUE(registry.state(p_texture, 1) == state::pixel_shader);
+        EXPECT_TRUE(registry.state(p_texture, 2) == state::non_pixel_shader);
+        EXPECT_TRUE(registry.state(p_texture, 3) == state::copy_source);
+
+        // the next tracked list is patched from the states left by the manual transitions
+        tracker.reset();
+        EXPECT_TRUE(tracker.isEmpty());
+        RecordingBarrierSink sink{};
+        tracker.requestState(p_texture, 4, state::pixel_shader);
+        tracker.flush(sink);
+        auto patch_barriers = registry.resolve(tracker);
+        ASSERT_EQ(patch_barriers.size(), 3U);
+        EXPECT_EQ(patch_barriers[0].subresource, 0U);
+        EXPECT_TRUE(patch_barriers[0].state_before == state::non_pixel_shader);
+        EXPECT_EQ(patch_barriers[2].subresource, 3U);
+        EXPECT_TRUE(patch_barriers[2].state_before == state::copy_source);
+        EXPECT_TRUE(registry.state(p_texture, 3) == state::pixel_shader);
+
+        registry.unregisterResource(p_buffer);
+        EXPECT_FALSE(registry.isRegistered(p_buffer));
+    }
+}
+
+TEST(EngineTests_Basic, TestTransientResourceAliasingPlanner)
+{
+    using namespace lexgine::core::dx::d3d12;
+
+    uint64_t const c_64kb = 65536U;
+    uint32_t const any = TransientAliasingBarrier::c_any_resource;
+
+    // chain of passes, each reading the output of the previous one: every other resource can share memory
+    {
+        TransientResourceAliasingPlanner planner{};
+        uint32_t a = planner.addResource({ .size = 4 * c_64kb, .alignment = c_64kb, .first_use = 0, .last_use = 1 });
+        uint32_t b = planner.addResource({ .size = 4 * c_64kb, .alignment = c_64kb, .first_use = 1, .last_use = 2 });
+        uint32_t c = planner.addResource({ .size = 4 * c_64kb, .alignment = c_64kb, .first_use = 2, .last_use = 3 });
+        uint32_t d = planner.addResource({ .size = 2 * c_64kb, .alignment = c_64kb, .first_use = 3, .last_use = 4 });
+
+        TransientAliasingPlan plan = planner.plan();
+        EXPECT_EQ(plan.unaliased_heap_size, 14 * c_64kb);
+        EXPECT_EQ(plan.heap_size, 8 * c_64kb);
+        EXPECT_EQ(plan.offsets[a], plan.offsets[c]);
+        EXPECT_NE(plan.offsets[a], plan.offsets[b]);
+        EXPECT_EQ(plan.offsets[d], plan.offsets[b]);
+
+        // the first resources in the shared memory are activated after the resources of the previous frame
+        ASSERT_EQ(plan.barriers.size(), 4U);
+        EXPECT_EQ(plan.barriers[0].use_index, 0U);
+        EXPECT_EQ(plan.barriers[0].resource_after, a);
+        EXPECT_EQ(plan.barriers[0].resource_before, any);
+        EXPECT_EQ(plan.barriers[1].resource_after, b);
+        EXPECT_EQ(plan.barriers[1].resource_before, any);
+        EXPECT_EQ(plan.barriers[2].use_index, 2U);
+        EXPECT_EQ(plan.barriers[2].resource_after, c);
+        EXPECT_EQ(plan.barriers[2].resource_before, a);
+        EXPECT_EQ(plan.barriers[3].use_index, 3U);
+        EXPECT_EQ(plan.barriers[3].resource_after, d);
+        EXPECT_EQ(plan.barriers[3].resource_before, b);
+    }
+
+    // resources alive at the same time never share memory, placement respects alignment and aliasing saves memory
+    {
+        std::mt19937 rng{ 2024 };
+        uint64_t total_heap_size{ 0U }, total_unaliased_heap_size{ 0U };
+        for (uint32_t frame = 0; frame < 200; ++frame)
+        {
+            TransientResourceAliasingPlanner planner{};
+            uint32_t const resource_count = 1 + rng() % 40;
+            uint32_t const pass_count = 4 + rng() % 12;
+            std::vector<TransientResourceRequest> requests;
+            for (uint32_t i = 0; i < resource_count; ++i)
+            {
+                uint32_t first_use = rng() % pass_count;
+                TransientResourceRequest request{ .size = (1 + rng() % 64) * 4096U, .alignment = rng() % 4 == 0 ? 4 * 1024 * 1024U : c_64kb,
+                    .first_use = first_use, .last_use = first_use + static_cast<uint32_t>(rng() % 3) };
+                requests.push_back(request);
+                EXPECT_EQ(planner.addResource(request), i);
+            }
+
+            TransientAliasingPlan plan = planner.plan();
+            ASSERT_EQ(plan.offsets.size(), resource_count);
+            EXPECT_LE(plan.heap_size, plan.unaliased_heap_size);
+            total_heap_size += plan.heap_size;
+            total_unaliased_heap_size += plan.unaliased_heap_size;
+
+            std::vector<uint32_t> barrier_counts(resource_count, 0U);
+            for (auto const& barrier : plan.barriers)
+            {
+                ASSERT_LT(barrier.resource_after, resource_count);
+                EXPECT_EQ(barrier.use_index, requests[barrier.resource_after].first_use);
+                if (barrier.resource_before != any)
+                {
+                    EXPECT_LT(requests[barrier.resource_before].last_use, requests[barrier.resource_after].first_use);
+                }
+                ++barrier_counts[barrier.resource_after];
+            }
+            EXPECT_TRUE(std::is_sorted(plan.barriers.begin(), plan.barriers.end(),
+                [](auto const& x, auto const& y) { return x.use_index < y.use_index; }));
+
+            for (uint32_t i = 0; i < resource_count; ++i)
+            {
+                EXPECT_EQ(plan.offsets[i] % requests[i].alignment, 0U);
+                EXPECT_LE(plan.offsets[i] + requests[i].size, plan.heap_size);
+
+                bool is_memory_shared{ false };
+                for (uint32_t j = 0; j < resource_count; ++j)
+                {
+                    if (i == j) continue;
+
+                    bool do_lifetimes_overlap = requests[i].first_use <= requests[j].last_use && requests[j].first_use <= requests[i].last_use;
+                    bool do_memory_ranges_overlap = plan.offsets[i] < plan.offsets[j] + requests[j].size && plan.offsets[j] < plan.offsets[i] + requests[i].size;
+                    ASSERT_FALSE(do_lifetimes_overlap && do_memory_ranges_overlap);
+                    is_memory_shared = is_memory_shared || do_memory_ranges_overlap;
+                }
+
+                // each resource sharing memory is activated exactly once
+                EXPECT_EQ(barrier_counts[i], is_memory_shared ? 1U : 0U);
+            }
+        }
+        EXPECT_LT(total_heap_size * 10, total_unaliased_heap_size * 7);
+    }
+}
+
+TEST(EngineTests_Basic, TestRenderGraph)
+{
+    using namespace lexgine::core::dx::d3d12;
+    using state = ResourceState::base_values;
+    uint32_t const barrier_only = CompiledRenderGraphPass::c_barrier_only_pass;
+
+    auto expect_barrier = [](RenderGraphBarrier const& barrier, uint32_t resource, ResourceState state_before, ResourceState state_after)
+    {
+        EXPECT_EQ(barrier.resource, resource);
+        EXPECT_TRUE(barrier.state_before == state_before);
+        EXPECT_TRUE(barrier.state_after == state_after);
+    };
+
+    RenderGraph graph{};
+    uint32_t back_buffer = graph.importResource("back buffer", state::present, state::present);
+    uint32_t depth = graph.createResource("depth");
+    uint32_t gbuffer = graph.createResource("gbuffer");
+    uint32_t ssao = graph.createResource("ssao");
+    uint32_t debug = graph.createResource("debug");
+
+    uint32_t depth_prepass = graph.addPass("depth prepass");
+    graph.addWrite(depth_prepass, depth, state::depth_write);
+
+    uint32_t gbuffer_pass = graph.addPass("gbuffer");
+    graph.addRead(gbuffer_pass, depth, state::depth_read);
+    graph.addWrite(gbuffer_pass, depth, state::depth_write);
+    graph.addWrite(gbuffer_pass, gbuffer, state::render_target);
+
+    uint32_t ssao_pass = graph.addPass("ssao", RenderGraphQueue::compute);
+    graph.addRead(ssao_pass, depth, state::non_pixel_shader);
+    graph.addWrite(ssao_pass, ssao, state::unordered_access);
+
+    uint32_t debug_pass = graph.addPass("debug overlay");
+    graph.addRead(debug_pass, gbuffer, state::pixel_shader);
+    graph.addWrite(debug_pass, debug, state::render_target);
+
+    uint32_t lighting_pass = graph.addPass("lighting");
+    graph.addRead(lighting_pass, gbuffer, state::pixel_shader);
+    graph.addRead(lighting_pass, ssao, state::pixel_shader);
+    graph.addRead(lighting_pass, depth, state::pixel_shader);
+    graph.addWrite(lighting_pass, back_buffer, state::render_target);
+
+    // golden schedule with async compute
+    {
+        CompiledRenderGraph compiled = graph.compile();
+        ASSERT_EQ(compiled.culled_passes.size(), 1U);
+        EXPECT_EQ(compiled.culled_passes[0], debug_pass);
+
+        auto const& passes = compiled.passes;
+        ASSERT_EQ(passes.size(), 6U);
+
+        EXPECT_EQ(passes[0].pass, depth_prepass);
+        ASSERT_EQ(passes[0].barriers.size(), 1U);
+        expect_barrier(passes[0].barriers[0], depth, state::common, state::depth_write);
+
+        EXPECT_EQ(passes[1].pass, gbuffer_pass);
+        ASSERT_EQ(passes[1].barriers.size(), 1U);
+        expect_barrier(passes[1].barriers[0], gbuffer, state::common, state::render_target);
+
+        // compute queue cannot transition depth out of the depth write state, the depth is transitioned once for both of its readers
+        EXPECT_EQ(passes[2].pass, barrier_only);
+        EXPECT_EQ(passes[2].queue, RenderGraphQueue::direct);
+        EXPECT_TRUE(passes[2].is_signaling);
+        ASSERT_EQ(passes[2].barriers.size(), 1U);
+        expect_barrier(passes[2].barriers[0], depth, state::depth_write, ResourceState{ state::non_pixel_shader } | state::pixel_shader);
+
+        EXPECT_EQ(passes[3].pass, ssao_pass);
+        EXPECT_EQ(passes[3].queue, RenderGraphQueue::compute);
+        EXPECT_EQ(passes[3].waits, std::vector<uint32_t>{ 2 });
+        EXPECT_TRUE(passes[3].is_signaling);
+        ASSERT_EQ(passes[3].barriers.size(), 1U);
+        expect_barrier(passes[3].barriers[0], ssao, state::common, state::unordered_access);
+
+        EXPECT_EQ(passes[4].pass, lighting_pass);
+        EXPECT_EQ(passes[4].waits, std::vector<uint32_t>{ 3 });
+        ASSERT_EQ(passes[4].barriers.size(), 3U);
+        expect_barrier(passes[4].barriers[0], gbuffer, state::render_target, state::pixel_shader);
+        expect_barrier(passes[4].barriers[1], ssao, state::unordered_access, state::pixel_shader);
+        expect_barrier(passes[4].barriers[2], back_buffer, state::present, state::render_target);
+
+        EXPECT_EQ(passes[5].pass, barrier_only);
+        ASSERT_EQ(passes[5].barriers.size(), 1U);
+        expect_barrier(passes[5].barriers[0], back_buffer, state::render_target, state::present);
+        EXPECT_TRUE(passes[5].waits.empty());
+
+        ASSERT_EQ(compiled.transient_resource_lifetimes.size(), 3U);
+        EXPECT_EQ(compiled.transient_resource_lifetimes[0].resource, depth);
+        EXPECT_EQ(compiled.transient_resource_lifetimes[0].first_use, 0U);
+        EXPECT_EQ(compiled.transient_resource_lifetimes[0].last_use, 4U);
+        EXPECT_EQ(compiled.transient_resource_lifetimes[2].resource, ssao);
+        EXPECT_EQ(compiled.transient_resource_lifetimes[2].first_use, 3U);
+    }
+
+    // without async work everything runs on the direct queue, which needs no waits and no barrier-only passes except the final one
+    {
+        CompiledRenderGraph compiled = graph.compile(false);
+        ASSERT_EQ(compiled.passes.size(), 5U);
+        for (auto const& e : compiled.passes)
+        {
+            EXPECT_EQ(e.queue, RenderGraphQueue::direct);
+            EXPECT_TRUE(e.waits.empty());
+            EXPECT_FALSE(e.is_signaling);
+        }
+        EXPECT_EQ(compiled.passes[2].pass, ssao_pass);
+        ASSERT_EQ(compiled.passes[2].barriers.size(), 2U);
+        EXPECT_EQ(compiled.passes[4].pass, barrier_only);
+    }
+
+    // a wait for the later pass on a queue covers the earlier passes of that queue
+    {
+        RenderGraph g{};
+        uint32_t target = g.importResource("target", state::common, state::common);
+        uint32_t x = g.createResource("x");
+        uint32_t y = g.createResource("y");
+        uint32_t a = g.addPass("a", RenderGraphQueue::compute);
+        g.addWrite(a, x, state::unordered_access);
+        uint32_t b = g.addPass("b", RenderGraphQueue::compute);
+        g.addWrite(b, y, state::unordered_access);
+        uint32_t c = g.addPass("c", RenderGraphQueue::direct);
+        g.addRead(c, x, state::non_pixel_shader);
+        g.addRead(c, y, state::non_pixel_shader);
+        g.addWrite(c, target, state::unordered_access);
+        uint32_t d = g.addPass("d", RenderGraphQueue::copy);
+        g.addRead(d, target, state::copy_source);
+        g.addWrite(d, x, state::copy_destination);    // overwrites x after c has read it
+
+        // the write-only access of d does not consume the contents of x, so that d is culled as its results are never read
+        CompiledRenderGraph compiled = g.compile();
+        EXPECT_EQ(compiled.culled_passes, std::vector<uint32_t>{ d });
+        ASSERT_EQ(compiled.passes.size(), 4U);
+        EXPECT_EQ(compiled.passes[2].pass, c);
+        EXPECT_EQ(compiled.passes[2].waits, std::vector<uint32_t>{ 1 });
+        EXPECT_FALSE(compiled.passes[0].is_signaling);
+        EXPECT_TRUE(compiled.passes[1].is_signaling);
+    }
+
+    // reading undefined contents and requesting states not supported by the queue are errors
+    {
+        RenderGraph g{};
+        uint32_t r = g.createResource("r");
+        uint32_t p = g.addPass("p", RenderGraphQueue::direct, true);
+        g.addRead(p, r, state::pixel_shader);
+        EXPECT_ANY_THROW(g.compile());
+
+        g.clear();
+        r = g.createResource("r");
+        p = g.addPass("p", RenderGraphQueue::compute, true);
+        g.addWrite(p, r, state::render_target);
+        EXPECT_ANY_THROW(g.compile());
+        EXPECT_NO_THROW(g.compile(false));
+        EXPECT_ANY_THROW(g.addWrite(p, r, state::unordered_access));
+    }
+}
+
+TEST(EngineTests_Basic, TestCommandStream)
+{
+    using namespace lexgine::core;
+    using namespace lexgine::core::dx::d3d12;
+    using state = ResourceState::base_values;
+
+    //! Captures the arguments of some of the replayed commands in addition to counting them
+    class CapturingBackend : public NullCommandStreamBackend
+    {
+    public:
+        void setRootSignature(std::string_view cached_root_signature_friendly_name) override
+        {
+            NullCommandStreamBackend::setRootSignature(cached_root_signature_friendly_name);
+            root_signatures.emplace_back(cached_root_signature_friendly_name);
+        }
+
+        void setRoot32BitConstants(uint32_t root_signature_slot, uint32_t const* p_data, uint32_t count, uint32_t offset_in_32bit_values) override
+        {
+            NullCommandStreamBackend::setRoot32BitConstants(root_signature_slot, p_data, count, offset_in_32bit_values);
+            constants.emplace_back(p_data, p_data + count);
+        }
+
+        void setVertexBuffers(uint32_t start_slot, CommandStreamVertexBufferView const* p_views, uint32_t count) override
+        {
+            NullCommandStreamBackend::setVertexBuffers(start_slot, p_views, count);
+            vertex_buffer_start_slot = start_slot;
+            vertex_buffers.assign(p_views, p_views + count);
+        }
+
+        void setRenderTargets(uint64_t const* p_rtv_handles, uint32_t rtv_count, uint64_t dsv_handle) override
+        {
+            NullCommandStreamBackend::setRenderTargets(p_rtv_handles, rtv_count, dsv_handle);
+            render_targets.assign(p_rtv_handles, p_rtv_handles + rtv_count);
+            depth_stencil = dsv_handle;
+        }
+
+        void resourceBarriers(TrackedResourceBarrier const* p_barriers, uint32_t count) override
+        {
+            NullCommandStreamBackend::resourceBarriers(p_barriers, count);
+            barriers.insert(barriers.end(), p_barriers, p_barriers + count);
+        }
+
+        void drawIndexedInstanced(uint32_t index_count_per_instance, uint32_t instance_count,
+            uint32_t start_index_location, int32_t base_vertex_location, uint32_t start_instance_location) override
+        {
+            NullCommandStreamBackend::drawIndexedInstanced(index_count_per_instance, instance_count,
+                start_index_location, base_vertex_location, start_instance_location);
+            base_vertex_locations.push_back(base_vertex_location);
+        }
+
+        std::vector<std::string> root_signatures;
+        std::vector<std::vector<uint32_t>> constants;
+        uint32_t vertex_buffer_start_slot{ 0U };
+        std::vector<CommandStreamVertexBufferView> vertex_buffers;
+        std::vector<uint64_t> render_targets;
+        uint64_t depth_stencil{ 0U };
+        std::vector<TrackedResourceBarrier> barriers;
+        std::vector<int32_t> base_vertex_locations;
+    };
+
+    std::vector<uint32_t> large_constants(100);
+    std::iota(large_constants.begin(), large_constants.end(), 0U);
+
+    auto record_frame = [&](CommandStream& stream)
+    {
+        stream.resourceBarriers({
+            TrackedResourceBarrier{ .type = TrackedResourceBarrierType::transition, .p_resource = fakeObject<Resource>(1),
+                .subresource = TrackedResourceBarrier::c_all_subresources, .state_before = state::present, .state_after = state::render_target,
+                .split_flags = SplitResourceBarrierFlags::none },
+            TrackedResourceBarrier{ .type = TrackedResourceBarrierType::uav, .p_resource = fakeObject<Resource>(2),
+                .subresource = TrackedResourceBarrier::c_all_subresources, .state_before = state::unordered_access, .state_after = state::unordered_access,
+                .split_flags = SplitResourceBarrierFlags::none } });
+        stream.resourceBarriers({});    // empty barrier lists are not recorded
+        stream.setRootSignature("forward_shading_root_signature");
+        stream.setRenderTargets({ 0x1000, 0x1020 }, 0x2000);
+        stream.clearRenderTargetView(0x1000, { 0.f, 0.f, 0.f, 1.f });
+        stream.clearDepthStencilView(0x2000, CommandStreamDSVClearFlags::clear_depth_and_stencil, 1.f, 0U, { CommandStreamRectangle{ 0, 0, 16, 16 } });
+        stream.setViewports({ CommandStreamViewport{ 0.f, 0.f, 1280.f, 720.f, 0.f, 1.f } });
+        stream.setScissorRectangles({ CommandStreamRectangle{ 0, 0, 1280, 720 } });
+        stream.setPrimitiveTopology(PrimitiveTopology::triangle_list);
+        stream.setVertexBuffers(1U, { CommandStreamVertexBufferView{ 0x10000, 4096, 32 }, CommandStreamVertexBufferView{ 0x20000, 2048, 16 } });
+        stream.setIndexBuffer(CommandStreamIndexBufferView{ 0x30000, 1024, 42 });
+        stream.setRoot32BitConstant(0U, 7U, 0U);
+        stream.setRoot32BitConstants(1U, large_constants, 0U);    // exceeds the chunk size used below
+        stream.setRootDescriptorTable(2U, 0xABCD);
+        stream.setRootConstantBufferView(3U, 0x40000);
+        stream.drawIndexedInstanced(36U, 2U, 0U, -4);
+        stream.drawInstanced(3U, 1U);
+        stream.dispatch(8U, 8U, 2U);
+        stream.copyBufferRegion(fakeObject<Resource>(3), 0U, fakeObject<Resource>(4), 256U, 512U);
+        stream.copyResource(fakeObject<Resource>(5), fakeObject<Resource>(6));
+    };
+
+    auto check_frame = [&](CapturingBackend const& backend)
+    {
+        EXPECT_EQ(backend.totalCommandCount(), 19U);
+        EXPECT_EQ(backend.commandCount(CommandStreamCommandType::resource_barriers), 1U);
+        EXPECT_EQ(backend.commandCount(CommandStreamCommandType::set_root_32bit_constants), 2U);
+        EXPECT_EQ(backend.statistics().barrier_count, 2U);
+        EXPECT_EQ(backend.statistics().vertex_count, 36U * 2U + 3U);
+        EXPECT_EQ(backend.statistics().thread_group_count, 128U);
+
+        ASSERT_EQ(backend.root_signatures.size(), 1U);
+        EXPECT_EQ(backend.root_signatures[0], "forward_shading_root_signature");
+        ASSERT_EQ(backend.constants.size(), 2U);
+        EXPECT_EQ(backend.constants[0], std::vector<uint32_t>{ 7U });
+        EXPECT_EQ(backend.constants[1], large_constants);
+        EXPECT_EQ(backend.vertex_buffer_start_slot, 1U);
+        ASSERT_EQ(backend.vertex_buffers.size(), 2U);
+        EXPECT_EQ(backend.vertex_buffers[1].buffer_location, 0x20000U);
+        EXPECT_EQ(backend.vertex_buffers[1].stride_in_bytes, 16U);
+        EXPECT_EQ(backend.render_targets, (std::vector<uint64_t>{ 0x1000, 0x1020 }));
+        EXPECT_EQ(backend.depth_stencil, 0x2000U);
+        ASSERT_EQ(backend.barriers.size(), 2U);
+        EXPECT_EQ(backend.barriers[0].p_resource, fakeObject<Resource>(1));
+        EXPECT_TRUE(backend.barriers[0].state_after == state::render_target);
+        EXPECT_EQ(backend.barriers[1].type, TrackedResourceBarrierType::uav);
+        EXPECT_EQ(backend.base_vertex_locations, std::vector<int32_t>{ -4 });
+    };
+
+    // the commands are replayed in the order of recording regardless of how the stream is split into the chunks
+    for (size_t chunk_size : { size_t{ 64U }, CommandStream::c_default_chunk_size })
+    {
+        CommandStream stream{ chunk_size };
+        EXPECT_TRUE(stream.isEmpty());
+
+        record_frame(stream);
+        EXPECT_EQ(stream.commandCount(), 19U);
+
+        CapturingBackend backend{};
+        stream.replay(backend);
+        check_frame(backend);
+
+        // the memory is retained when the stream is cleared and recorded anew
+        size_t const size = stream.size();
+        size_t const capacity = stream.capacity();
+        EXPECT_LE(size, capacity);
+
+        stream.clear();
+        EXPECT_TRUE(stream.isEmpty());
+        EXPECT_EQ(stream.size(), 0U);
+
+        NullCommandStreamBackend null_backend{};
+        stream.replay(null_backend);
+        EXPECT_EQ(null_backend.totalCommandCount(), 0U);
+
+        record_frame(stream);
+        EXPECT_EQ(stream.size(), size);
+        EXPECT_EQ(stream.capacity(), capacity);
+
+        CapturingBackend second_backend{};
+        stream.replay(second_backend);
+        check_frame(second_backend);
+    }
+
+    // per-thread streams are recorded in parallel and translated in one pass in the order of submission
+    {
+        uint32_t const thread_count = 4U;
+        uint32_t const draws_per_thread = 1000U;
+
+        std::vector<CommandStream> streams(thread_count);
+        std::vector<std::thread> threads{};
+        for (uint32_t i = 0; i < thread_count; ++i)
+        {
+            threads.emplace_back([&streams, i, draws_per_thread]()
+                {
+                    CommandStream& stream = streams[i];
+                    stream.setRootSignature("thread_" + std::to_string(i));
+                    for (uint32_t j = 0; j < draws_per_thread; ++j)
+                    {
+                        stream.setRootDescriptorTable(0U, j);
+                        stream.drawIndexedInstanced(6U, 1U, 0U, static_cast<int32_t>(i * draws_per_thread + j));
+                    }
+                });
+        }
+        for (auto& t : threads) t.join();
+
+        CapturingBackend backend{};
+        for (auto const& stream : streams) stream.replay(backend);
+
+        EXPECT_EQ(backend.commandCount(CommandStreamCommandType::draw_indexed_instanced), thread_count * draws_per_thread);
+        EXPECT_EQ(backend.commandCount(CommandStreamCommandType::set_root_descriptor_table), thread_count * draws_per_thread);
+        ASSERT_EQ(backend.root_signatures.size(), thread_count);
+        EXPECT_EQ(backend.root_signatures[3], "thread_3");
+        ASSERT_EQ(backend.base_vertex_locations.size(), thread_count * draws_per_thread);
+        for (uint32_t i = 0; i < thread_count * draws_per_thread; ++i)
+        {
+            ASSERT_EQ(backend.base_vertex_locations[i], static_cast<int32_t>(i));
+        }
+    }
+}
+
+TEST(EngineTests_Basic, TestCommandListStateCache)
+{
+    using namespace lexgine::core;
+    using namespace lexgine::core::dx::d3d12;
+
+    auto filtered = [](CommandListStateCache const& cache, StateCacheCallType type)
+    {
+        return cache.statistics().filtered_calls[static_cast<size_t>(type)];
+    };
+    auto issued = [](CommandListStateCache const& cache, StateCacheCallType type)
+    {
+        return cache.statistics().issued_calls[static_cast<size_t>(type)];
+    };
+
+    StateCacheBindPoint const graphics = StateCacheBindPoint::graphics;
+    StateCacheBindPoint const compute = StateCacheBindPoint::compute;
+
+    // pipeline state, descriptor heaps and input assembly
+    {
+        CommandListStateCache cache{};
+        EXPECT_TRUE(cache.setPipelineState(fakeObject<PipelineState>(1)));
+        EXPECT_FALSE(cache.setPipelineState(fakeObject<PipelineState>(1)));
+        EXPECT_TRUE(cache.setPipelineState(fakeObject<PipelineState>(2)));
+        EXPECT_EQ(issued(cache, StateCacheCallType::pipeline_state), 2U);
+        EXPECT_EQ(filtered(cache, StateCacheCallType::pipeline_state), 1U);
+
+        EXPECT_TRUE(cache.setDescriptorHeaps(fakeObject<DescriptorHeap>(1), fakeObject<DescriptorHeap>(2)));
+        EXPECT_FALSE(cache.setDescriptorHeaps(fakeObject<DescriptorHeap>(1), fakeObject<DescriptorHeap>(2)));
+        EXPECT_TRUE(cache.setDescriptorHeaps(fakeObject<DescriptorHeap>(1), fakeObject<DescriptorHeap>(3)));
+
+        EXPECT_TRUE(cache.setPrimitiveTopology(PrimitiveTopology::triangle_list));
+        EXPECT_FALSE(cache.setPrimitiveTopology(PrimitiveTopology::triangle_list));
+        EXPECT_TRUE(cache.setPrimitiveTopology(PrimitiveTopology::line_list));
+
+        std::vector<CommandStreamVertexBufferView> views{ { 0x1000, 256, 16 }, { 0x2000, 512, 32 } };
+        EXPECT_TRUE(cache.setVertexBuffers(0U, views.data(), 2U));
+        EXPECT_FALSE(cache.setVertexBuffers(0U, views.data(), 2U));
+        EXPECT_FALSE(cache.setVertexBuffers(1U, views.data() + 1, 1U));    // subset of the bound slots
+        EXPECT_TRUE(cache.setVertexBuffers(1U, views.data(), 2U));    // slot 2 is not bound yet
+        EXPECT_FALSE(cache.setVertexBuffers(0U, views.data(), 1U));    // slot 0 is not affected by rebinding of slots 1 and 2
+        views[0].stride_in_bytes = 8;
+        EXPECT_TRUE(cache.setVertexBuffers(0U, views.data(), 1U));
+
+        CommandStreamIndexBufferView ib{ 0x3000, 128, 42 };
+        EXPECT_TRUE(cache.setIndexBuffer(ib));
+        EXPECT_FALSE(cache.setIndexBuffer(ib));
+        ib.format = 57;
+        EXPECT_TRUE(cache.setIndexBuffer(ib));
+
+        // invalidation forgets the state but retains the counters
+        size_t const issued_call_count = cache.statistics().totalIssuedCallCount();
+        size_t const filtered_call_count = cache.statistics().totalFilteredCallCount();
+        EXPECT_EQ(filtered_call_count, 7U);
+        cache.invalidate();
+        EXPECT_TRUE(cache.setPipelineState(fakeObject<PipelineState>(2)));
+        EXPECT_TRUE(cache.setDescriptorHeaps(fakeObject<DescriptorHeap>(1), fakeObject<DescriptorHeap>(3)));
+        EXPECT_TRUE(cache.setVertexBuffers(0U, views.data(), 1U));
+        EXPECT_TRUE(cache.setIndexBuffer(ib));
+        EXPECT_EQ(cache.statistics().totalIssuedCallCount(), issued_call_count + 4U);
+
+        cache.resetStatistics();
+        EXPECT_EQ(cache.statistics().totalIssuedCallCount(), 0U);
+        EXPECT_EQ(cache.statistics().totalFilteredCallCount(), 0U);
+    }
+
+    // root signatures and root arguments
+    {
+        CommandListStateCache cache{};
+        EXPECT_TRUE(cache.setRootSignature(graphics, fakeObject<void>(1)));
+        EXPECT_FALSE(cache.setRootSignature(graphics, fakeObject<void>(1)));
+        EXPECT_TRUE(cache.setRootSignature(compute, fakeObject<void>(1)));    // the bind points are independent
+
+        EXPECT_TRUE(cache.setRootDescriptorTable(graphics, 0U, 0xA000));
+        EXPECT_FALSE(cache.setRootDescriptorTable(graphics, 0U, 0xA000));
+        EXPECT_TRUE(cache.setRootDescriptorTable(compute, 0U, 0xA000));
+        EXPECT_TRUE(cache.setRootConstantBufferView(graphics, 1U, 0xB000));
+        EXPECT_FALSE(cache.setRootConstantBufferView(graphics, 1U, 0xB000));
+        EXPECT_TRUE(cache.setRootShaderResourceView(graphics, 1U, 0xB000));    // different kind of argument with the same value
+        EXPECT_TRUE(cache.setRootUnorderedAccessView(graphics, 2U, 0xC000));
+        EXPECT_FALSE(cache.setRootUnorderedAccessView(graphics, 2U, 0xC000));
+        EXPECT_EQ(filtered(cache, StateCacheCallType::root_descriptor_table), 1U);
+        EXPECT_EQ(filtered(cache, StateCacheCallType::root_descriptor), 2U);
+
+        // root constants are compared per 32-bit value
+        std::vector<uint32_t> constants{ 1U, 2U, 3U, 4U };
+        EXPECT_TRUE(cache.setRoot32BitConstants(graphics, 3U, constants.data(), 4U, 0U));
+        EXPECT_FALSE(cache.setRoot32BitConstants(graphics, 3U, constants.data(), 4U, 0U));
+        EXPECT_FALSE(cache.setRoot32BitConstants(graphics, 3U, constants.data() + 2, 2U, 2U));
+        EXPECT_TRUE(cache.setRoot32BitConstants(graphics, 3U, constants.data(), 2U, 3U));    // value 3 is not known
+        EXPECT_FALSE(cache.setRoot32BitConstants(graphics, 3U, constants.data() + 1, 1U, 4U));
+        uint32_t const changed_value = 7U;
+        EXPECT_TRUE(cache.setRoot32BitConstants(graphics, 3U, &changed_value, 1U, 0U));
+        EXPECT_EQ(issued(cache, StateCacheCallType::root_constants), 3U);
+        EXPECT_EQ(filtered(cache, StateCacheCallType::root_constants), 3U);
+
+        // dirty root parameters are reported until committed
+        EXPECT_EQ(cache.boundRootParameters(graphics), 0b1111U);
+        EXPECT_EQ(cache.dirtyRootParameters(graphics), 0b1111U);
+        EXPECT_EQ(cache.commitRootParameters(graphics), 0b1111U);
+        EXPECT_EQ(cache.dirtyRootParameters(graphics), 0U);
+        EXPECT_EQ(cache.dirtyRootParameters(compute), 0b1U);
+        EXPECT_FALSE(cache.setRootDescriptorTable(graphics, 0U, 0xA000));
+        EXPECT_TRUE(cache.setRootConstantBufferView(graphics, 1U, 0xD000));
+        EXPECT_EQ(cache.dirtyRootParameters(graphics), 0b10U);
+
+        // changing descriptor heaps discards the descriptor tables of both bind points
+        cache.commitRootParameters(graphics);
+        EXPECT_TRUE(cache.setDescriptorHeaps(fakeObject<DescriptorHeap>(1), fakeObject<DescriptorHeap>(2)));
+        EXPECT_EQ(cache.boundRootParameters(graphics), 0b1110U);
+        EXPECT_EQ(cache.boundRootParameters(compute), 0U);
+        EXPECT_TRUE(cache.setRootDescriptorTable(graphics, 0U, 0xA000));
+        EXPECT_FALSE(cache.setRootConstantBufferView(graphics, 1U, 0xD000));
+
+        // changing the root signature discards the root arguments of its bind point
+        EXPECT_TRUE(cache.setRootSignature(graphics, fakeObject<void>(2)));
+        EXPECT_EQ(cache.boundRootParameters(graphics), 0U);
+        EXPECT_EQ(cache.dirtyRootParameters(graphics), 0U);
+        EXPECT_TRUE(cache.setRootDescriptorTable(graphics, 0U, 0xA000));
+        EXPECT_TRUE(cache.setRoot32BitConstants(graphics, 3U, constants.data(), 4U, 0U));
+        EXPECT_TRUE(cache.setRootDescriptorTable(compute, 0U, 0xA000));
+        EXPECT_FALSE(cache.setRootSignature(compute, fakeObject<void>(1)));
+        EXPECT_FALSE(cache.setRootDescriptorTable(compute, 0U, 0xA000));
+    }
+
+    // typical draw list, in which consecutive draws share most of their state
+    {
+        CommandListStateCache cache{};
+        uint32_t const draw_count = 1000U;
+        uint32_t issued_binds{ 0U };
+        for (uint32_t i = 0; i < draw_count; ++i)
+        {
+            uint32_t const material = i / 100U;
+            uint32_t const mesh = i / 10U;
+            uint32_t const object_constants[] = { i, 0U };
+
+            issued_binds += cache.setPipelineState(fakeObject<PipelineState>(1 + material % 2));
+            issued_binds += cache.setRootSignature(graphics, fakeObject<void>(1));
+            issued_binds += cache.setDescriptorHeaps(fakeObject<DescriptorHeap>(1), fakeObject<DescriptorHeap>(2));
+            issued_binds += cache.setRootDescriptorTable(graphics, 0U, 0x10000 + material * 0x100);
+            issued_binds += cache.setRoot32BitConstants(graphics, 1U, object_constants, 2U, 0U);
+            CommandStreamVertexBufferView const vb{ 0x100000 + mesh * 0x1000, 0x1000, 32 };
+            issued_binds += cache.setVertexBuffers(0U, &vb, 1U);
+            issued_binds += cache.setIndexBuffer(CommandStreamIndexBufferView{ 0x200000 + mesh * 0x1000, 0x1000, 42 });
+            cache.commitRootParameters(graphics);
+        }
+
+        // 10 materials with alternating PSOs, 100 meshes and per-object constants
+        EXPECT_EQ(issued_binds, 10U + 1U + 1U + 10U + draw_count + 100U + 100U);
+        EXPECT_EQ(cache.statistics().totalIssuedCallCount(), issued_binds);
+        EXPECT_EQ(cache.statistics().totalFilteredCallCount(), 7U * draw_count - issued_binds);
+    }
+}
+
+TEST(EngineTests_Basic, TestKtx2LevelStream)
+{
+    using namespace lexgine::conversion;
+
+    // KTX2 file with two uncompressed levels of a 2-layer array texture: the level index follows the 80-byte header,
+    // and the level data are stored from the smallest level to the largest one as required by the format
+    std::vector<uint8_t> file_data(80 + 2 * 24, 0);
+    auto write_u32 = [&file_data](size_t offset, uint32_t value) { for (size_t i = 0; i < 4; ++i) file_data[offset + i] = static_cast<uint8_t>(value >> (8 * i)); };
+    auto write_u64 = [&file_data](size_t offset, uint64_t value) { for (size_t i = 0; i < 8; ++i) file_data[offset + i] = static_cast<uint8_t>(value >> (8 * i)); };
+
+    std::array<uint8_t, 12> const identifier{ 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+    std::copy(identifier.begin(), identifier.end(), file_data.begin());
+    write_u32(12, 37);    // VK_FORMAT_R8G8B8A8_UNORM
+    write_u32(32, 2);    // layer count
+    write_u32(36, 1);    // face count
+    write_u32(40, 2);    // level count
+    write_u32(44, 0);    // no supercompression
+
+    std::vector<uint8_t> const level1(2 * 4, 0x11), level0(2 * 16, 0x22);
+    uint64_t const level1_offset = file_data.size(), level0_offset = level1_offset + level1.size();
+    write_u64(80, level0_offset); write_u64(88, level0.size()); write_u64(96, level0.size());
+    write_u64(104, level1_offset); write_u64(112, level1.size()); write_u64(120, level1.size());
+    file_data.insert(file_data.end(), level1.begin(), level1.end());
+    file_data.insert(file_data.end(), level0.begin(), level0.end());
+
+    std::filesystem::path test_file_path = std::filesystem::current_path() / "test_level_stream.ktx2";
+    {
+        std::ofstream ofile{ test_file_path, std::ios::binary | std::ios::trunc };
+        ofile.write(reinterpret_cast<char const*>(file_data.data()), file_data.size());
+    }
+
+    {
+        Ktx2LevelStream level_stream{ test_file_path };
+        ASSERT_TRUE(level_stream);
+        EXPECT_EQ(level_stream.vkFormat(), 37U);
+        EXPECT_EQ(level_stream.layerCount(), 2U);
+        EXPECT_EQ(level_stream.faceCount(), 1U);
+        EXPECT_EQ(level_stream.imageCountPerLevel(), 2U);
+        EXPECT_EQ(level_stream.levelCount(), 2U);
+        EXPECT_EQ(level_stream.supercompressionScheme(), Ktx2LevelStream::SupercompressionScheme::none);
+        EXPECT_TRUE(level_stream.supportsPerLevelDecoding());
+        EXPECT_EQ(level_stream.levelIndexEntry(0).byte_offset, level0_offset);
+        EXPECT_EQ(level_stream.levelIndexEntry(0).byte_length, level0.size());
+        EXPECT_EQ(level_stream.levelIndexEntry(1).byte_offset, level1_offset);
+        EXPECT_EQ(level_stream.levelIndexEntry(1).uncompressed_byte_length, level1.size());
+
+        // levels are read independently and in any order
+        std::vector<uint8_t> level_data(level1.size());
+        EXPECT_TRUE(level_stream.readLevel(1, level_data));
+        EXPECT_EQ(level_data, level1);
+        level_data.resize(level0.size());
+        EXPECT_TRUE(level_stream.readLevel(0, level_data));
+        EXPECT_EQ(level_data, level0);
+
+        // destination smaller than the level is rejected
+        std::vector<uint8_t> small_destination(level0.size() - 1);
+        EXPECT_FALSE(level_stream.readLevel(0, small_destination));
+    }
+
+    // the header fields are checked against the size of the file, so that corrupt files cannot cause oversized allocations
+    auto write_test_file = [&test_file_path](std::vector<uint8_t> const& data)
+    {
+        std::ofstream ofile{ test_file_path, std::ios::binary | std::ios::trunc };
+        ofile.write(reinterpret_cast<char const*>(data.data()), data.size());
+    };
+
+    {
+        // level index pointing past the end of the file
+        std::vector<uint8_t> truncated_file_data{ file_data.begin(), file_data.begin() + level0_offset };
+        write_test_file(truncated_file_data);
+        EXPECT_FALSE(Ktx2LevelStream{ test_file_path });
+    }
+
+    {
+        // level count, for which the level index cannot fit into the file
+        std::vector<uint8_t> const valid_file_data{ file_data };
+        write_u32(40, 0x7FFFFFFF);
+        write_test_file(file_data);
+        EXPECT_FALSE(Ktx2LevelStream{ test_file_path });
+        file_data = valid_file_data;
+    }
+
+    {
+        // uncompressed length of a level with no supercompression differing from its stored length
+        std::vector<uint8_t> const valid_file_data{ file_data };
+        write_u64(96, uint64_t{ 1 } << 40);
+        write_test_file(file_data);
+        EXPECT_FALSE(Ktx2LevelStream{ test_file_path });
+        file_data = valid_file_data;
+    }
+
+    {
+        // broken identifier
+        file_data[1] = 0;
+        write_test_file(file_data);
+    }
+    EXPECT_FALSE(Ktx2LevelStream{ test_file_path });
+
+    std::filesystem::remove(test_file_path);
+}
+
+class ConsoleCommandTest : public LogTestBase
+{
+public:
+    ConsoleCommandTest()
+        : LogTestBase{ "ConsoleCommandTest" }
+    {
+    }
+};
+
+TEST_F(ConsoleCommandTest, TestConsoleCommandParsing)
+{
+    using namespace lexgine::interaction::console;
+
+    CommandRegistry registry{};
+    registry.addNamespace("ns", "test namespace");
+
+    CommandSpec spec{};
+    spec.name = "testcmd";
+    spec.summary = "test command";
+    spec.args = {
+        { "x", "first arg", value_parsers::int_parser, std::nullopt },
+        { "y", "second arg", value_parsers::int_parser, std::nullopt },
+        { "z", "third arg", value_parsers::int_parser, std::nullopt }
+    };
+
+    registry.addCommand("ns", spec, [](ArgMap const&) -> CommandExecResult
+        {
+            return { true, "" };
+        });
+
+    registry.setQuery("ns.testcmd 1,2,z=3");
+    auto schema = registry.invokeQuery();
+    ASSERT_TRUE(schema.has_value());
+
+    ArgMap const& args = schema->args;
+    EXPECT_EQ(args.size(), 3U);
+    EXPECT_EQ(std::get<int>(args.at("x")), 1);
+    EXPECT_EQ(std::get<int>(args.at("y")), 2);
+    EXPECT_EQ(std::get<int>(args.at("z")), 3);
+}
+
+
+TEST(EngineTests_gpu, TestTextureCompression)
+{
+    using namespace lexgine;
+    using namespace lexgine::core;
+    using namespace lexgine::conversion;
+    using namespace lexgine::core::dx;
+    using namespace lexgine::core::dx::d3d12;
+    using namespace lexgine::core::misc;
+
+    EngineSettings settings{};
+    settings.engine_api = EngineApi::Direct3D12;
+    settings.debug_mode = true;
+    settings.log_name = "TestTextureCompression.log";
+
+    Initializer initializer{ settings };
+    initializer.setCurrentDevice(0);
+
+
+    conversion::TextureConverter* p_texture_converter = initializer.globals().get<conversion::TextureConverter>();
+    scenegraph::Image test_image{ std::filesystem::path{LEXGINE_GLOBAL_LOOKUP_PREFIX} / "engine/tests/data/Lenna_(test_image).png", *initializer.globals().get<ImageLoaderPool>()};
+    p_texture_converter->addTextureConversionTask(test_image, false);
+    p_texture_converter->convertTextures();
+    p_texture_converter->uploadTextures();
+    p_texture_converter->waitForTextureUploadCompletion();
+}
+
+using SceneImportStage = std::pair<char const*, std::chrono::microseconds lexgine::scenegraph::SceneImportTimings::*>;
+
+/*! Reports durations of the import stages of the scene as test properties and into the log. For each stage the duration of the first
+ import, which runs with cold caches, is reported together with the best and the mean durations over all imports
+*/
+void reportSceneImportTimings(std::string const& scene_path, size_t scene_index,
+    std::vector<SceneImportStage> const& stages, std::vector<lexgine::scenegraph::SceneImportTimings> const& timings)
+{
+    using namespace lexgine::core::misc;
+
+    std::string report = std::format("Scene '{}', {} imports (first / best / mean, ms):", scene_path, timings.size());
+    for (auto const& [stage_name, p_stage_timing] : stages)
+    {
+        std::chrono::microseconds best{ (std::numeric_limits<std::chrono::microseconds::rep>::max)() }, sum{};
+        for (auto const& e : timings)
+        {
+            best = (std::min)(best, e.*p_stage_timing);
+            sum += e.*p_stage_timing;
+        }
+        double const first_ms = (timings.front().*p_stage_timing).count() / 1000.0;
+        double const best_ms = best.count() / 1000.0;
+        double const mean_ms = sum.count() / 1000.0 / timings.size();
+
+        std::string const property_prefix = std::format("scene{}_{}", scene_index, stage_name);
+        testing::Test::RecordProperty(property_prefix + "_first_ms", std::format("{:.3f}", first_ms));
+        testing::Test::RecordProperty(property_prefix + "_best_ms", std::format("{:.3f}", best_ms));
+        testing::Test::RecordProperty(property_prefix + "_mean_ms", std::format("{:.3f}", mean_ms));
+        report += std::format("\n    {:<24}{:>12.3f}{:>12.3f}{:>12.3f}", stage_name, first_ms, best_ms, mean_ms);
+    }
+    Log::retrieve()->out(report, LogMessageType::information);
+}
+
+TEST(EngineTests_Basic, BenchmarkSceneImport)
+{
+    using namespace lexgine;
+    using namespace lexgine::core;
+    using namespace lexgine::core::misc;
+
+    // Benchmark of the stages of the scene import that do not need a GPU. The scenes to import are listed in LEXGINE_BENCHMARK_SCENES
+    // separated by semicolons, each of them is imported LEXGINE_BENCHMARK_ITERATIONS times (3 by default)
+    char const* benchmark_scenes = std::getenv("LEXGINE_BENCHMARK_SCENES");
+    if (!benchmark_scenes)
+    {
+        GTEST_SKIP() << "LEXGINE_BENCHMARK_SCENES is not set";
+    }
+    char const* benchmark_iterations = std::getenv("LEXGINE_BENCHMARK_ITERATIONS");
+    int const iteration_count = benchmark_iterations ? (std::max)(std::atoi(benchmark_iterations), 1) : 3;
+
+    std::filesystem::path test_logging_path = std::filesystem::current_path() / "test.log";
+    Log::create(test_logging_path, "Benchmark Scene Import", LogMessageType::information);
+    {
+        std::filesystem::path const global_lookup_prefix{ LEXGINE_GLOBAL_LOOKUP_PREFIX };
+        GlobalSettings global_settings{ global_lookup_prefix / LEXGINE_SETTINGS_PATH / "global_settings.json" };
+        global_settings.setCacheDirectory(global_lookup_prefix / global_settings.getCacheDirectory());
+        std::error_code error_code{};
+        std::filesystem::create_directories(global_settings.getCacheDirectory(), error_code);
+
+        concurrency::AssetScheduler asset_scheduler{ global_settings.getNumberOfWorkers(), "BenchmarkSceneImport" };
+        Globals globals{};
+        globals.put(&global_settings);
+        globals.put(&asset_scheduler);
+
+        std::vector<SceneImportStage> const stages{
+            { "parse", &scenegraph::SceneImportTimings::parse },
+            { "mesh_processing", &scenegraph::SceneImportTimings::mesh_processing },
+            { "scene_memory_planning", &scenegraph::SceneImportTimings::scene_memory_upload },
+            { "total", &scenegraph::SceneImportTimings::total }
+        };
+
+        std::stringstream scene_list{ benchmark_scenes };
+        size_t scene_index{ 0 };
+        for (std::string scene_path; std::getline(scene_list, scene_path, ';');)
+        {
+            if (scene_path.empty()) continue;
+
+            // the first import processes the mesh primitives and bakes them, the following ones load the baked scene
+            scenegraph::Scene::discardBakedScene(global_settings, scene_path, 0);
+
+            std::vector<scenegraph::SceneImportTimings> timings{};
+            for (int i = 0; i < iteration_count; ++i)
+            {
+                std::optional<scenegraph::SceneImportTimings> const import_timings = scenegraph::Scene::importCpuStages(globals, scene_path, 0);
+                ASSERT_TRUE(import_timings) << "Unable to import scene '" << scene_path << "'";
+                timings.push_back(*import_timings);
+            }
+            reportSceneImportTimings(scene_path, scene_index++, stages, timings);
+        }
+    }
+    Log::shutdown();
+}
+
+TEST(EngineTests_gpu, BenchmarkSceneImportUpload)
+{
+    using namespace lexgine;
+    using namespace lexgine::core;
+    using namespace lexgine::core::dx::d3d12;
+
+    // Headless benchmark of the complete scene import including the uploads: no window or swap chain is created. The scenes are given
+    // the same way as for EngineTests_Basic.BenchmarkSceneImport
+    char const* benchmark_scenes = std::getenv("LEXGINE_BENCHMARK_SCENES");
+    if (!benchmark_scenes)
+    {
+        GTEST_SKIP() << "LEXGINE_BENCHMARK_SCENES is not set";
+    }
+    char const* benchmark_iterations = std::getenv("LEXGINE_BENCHMARK_ITERATIONS");
+    int const iteration_count = benchmark_iterations ? (std::max)(std::atoi(benchmark_iterations), 1) : 3;
+
+    EngineSettings settings{};
+    settings.engine_api = EngineApi::Direct3D12;
+    settings.debug_mode = false;
+    settings.log_name = "BenchmarkSceneImportUpload.log";
+
+    Initializer initializer{ settings };
+    initializer.setCurrentDevice(0);
+    BasicRenderingServices basic_rendering_services{ initializer.globals() };
+
+    std::vector<SceneImportStage> const stages{
+        { "parse", &scenegraph::SceneImportTimings::parse },
+        { "mesh_processing", &scenegraph::SceneImportTimings::mesh_processing },
+        { "scene_memory_upload", &scenegraph::SceneImportTimings::scene_memory_upload },
+        { "mesh_decode", &scenegraph::SceneImportTimings::mesh_decode },
+        { "texture_wait", &scenegraph::SceneImportTimings::texture_wait },
+        { "material_construction", &scenegraph::SceneImportTimings::material_construction },
+        { "total", &scenegraph::SceneImportTimings::total }
+    };
+
+    std::stringstream scene_list{ benchmark_scenes };
+    size_t scene_index{ 0 };
+    for (std::string scene_path; std::getline(scene_list, scene_path, ';');)
+    {
+        if (scene_path.empty()) continue;
+
+        scenegraph::Scene::discardBakedScene(*initializer.globals().get<GlobalSettings>(), scene_path, 0);
+
+        std::vector<scenegraph::SceneImportTimings> timings{};
+        for (int i = 0; i < iteration_count; ++i)
+        {
+            // the materials are assembled in background, so the import is only complete and fully timed once they have been assembled
+            auto scene = scenegraph::Scene::loadScene(initializer.globals(), basic_rendering_services, scene_path, 0);
+            ASSERT_TRUE(scene && scene->waitForLoadCompletion()) << "Unable to import scene '" << scene_path << "'";
+            timings.push_back(scene->importTimings());
+        }
+        reportSceneImportTimings(scene_path, scene_index++, stages, timings);
+    }
+}
+
+TEST(EngineTests_Basic, BenchmarkTransformHierarchy)
+{
+    using namespace lexgine;
+    using namespace lexgine::core::misc;
+    using core::math::Vector3f;
+
+    // Headless comparison of the standalone nodes and of the nodes sharing a transform hierarchy. The tree is a 4-ary tree of
+    // LEXGINE_BENCHMARK_TRANSFORM_NODES nodes (65536 by default); on each frame all nodes are moved and their world transforms are read back
+    char const* benchmark_node_count = std::getenv("LEXGINE_BENCHMARK_TRANSFORM_NODES");
+    size_t const node_count = benchmark_node_count ? static_cast<size_t>((std::max)(std::atoi(benchmark_node_count), 1)) : 65536U;
+    constexpr int frame_count = 5;
+    uint8_t const worker_count = static_cast<uint8_t>((std::min)((std::max)(std::thread::hardware_concurrency(), 2U) - 1U, 255U));
+
+    std::filesystem::path test_logging_path = std::filesystem::current_path() / "test.log";
+    Log::create(test_logging_path, "Benchmark Transform Hierarchy", LogMessageType::information);
+
+    auto run_frames = [node_count](std::vector<scenegraph::Node>& nodes)
+        {
+            for (size_t i = 1; i < node_count; ++i) nodes[(i - 1) / 4].addChild(&nodes[i]);
+
+            double checksum{ 0. };
+            auto const start_time = std::chrono::steady_clock::now();
+            for (int frame = 0; frame < frame_count; ++frame)
+            {
+                for (size_t i = 0; i < node_count; ++i)
+                {
+                    Vector3f translation{ static_cast<float>(frame), static_cast<float>(i % 7), 1.f };
+                    nodes[i].translate(translation);
+                }
+                for (auto const& node : nodes) checksum += node.localToWorldTransform()[3][0];
+            }
+            auto const duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time);
+            return std::make_pair(duration, checksum);
+        };
+
+    std::vector<scenegraph::Node> standalone_nodes(node_count);
+    auto const [standalone_duration, standalone_checksum] = run_frames(standalone_nodes);
+
+    core::concurrency::AssetScheduler scheduler{ worker_count, "transform_hierarchy_benchmark_scheduler" };
+    scenegraph::TransformHierarchy hierarchy{ &scheduler };
+    std::vector<scenegraph::Node> hierarchy_nodes{};
+    hierarchy_nodes.reserve(node_count);
+    for (size_t i = 0; i < node_count; ++i) hierarchy_nodes.emplace_back(hierarchy);
+    auto const [hierarchy_duration, hierarchy_checksum] = run_frames(hierarchy_nodes);
+
+    EXPECT_NEAR(standalone_checksum, hierarchy_checksum, 1e-6 * std::abs(standalone_checksum));
+
+    double const standalone_ms = standalone_duration.count() / 1000.0 / frame_count;
+    double const hierarchy_ms = hierarchy_duration.count() / 1000.0 / frame_count;
+    testing::Test::RecordProperty("standalone_ms_per_frame", std::format("{:.3f}", standalone_ms));
+    testing::Test::RecordProperty("hierarchy_ms_per_frame", std::format("{:.3f}", hierarchy_ms));
+    Log::retrieve()->out(std::format("{} nodes, {} frames (ms per frame):"
+        "\n    standalone nodes:                          {:>10.3f}"
+        "\n    transform hierarchy ({:>3} scheduler workers): {:>10.3f}",
+        node_count, frame_count, standalone_ms, worker_count, hierarchy_ms), LogMessageType::information);
+
+    Log::shutdown();
+}
@@ -4,4 +4,13 @@
 #define PI 3.14159265
 #define SHADER_FUNCTION_SPACE space100
 
+// Decodes unit vector stored using octahedral mapping
+float3 decodeOctahedral(float2 e)
+{
+    float3 v = float3(e.xy, 1.0f - abs(e.x) - abs(e.y));
+    float t = saturate(-v.z);
+    v.xy += float2(v.x >= 0.0f ? -t : t, v.y >= 0.0f ? -t : t);
+    return normalize(v);
+}
+
 #endif
\ No newline at end of file
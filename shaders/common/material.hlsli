@@ -5,6 +5,10 @@
 
 struct ObjectData {
     float4x4 model;
+#ifdef QUANTIZED_VERTICES
+    float4 position_dequantization_scale;    // positions are stored as normalized integers relative to the bounds of the submesh
+    float4 position_dequantization_offset;
+#endif
 };
 
 struct MaterialData {
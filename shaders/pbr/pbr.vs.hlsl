@@ -3,9 +3,15 @@
 
 struct VSInput {
     float3 position : POSITION;
+#ifdef QUANTIZED_VERTICES
+    float2 normal : NORMAL;    // octahedral encoded
+    float2 texcoord : TEXCOORD0;
+    float4 tangent : TANGENT;    // octahedral encoded direction in xy, handedness in z
+#else
     float3 normal : NORMAL;
     float2 texcoord : TEXCOORD0;
     float4 tangent : TANGENT;
+#endif
 };
 
 struct VSOutput {
@@ -20,14 +26,24 @@ struct VSOutput {
 VSOutput VSMain(VSInput input) {
     VSOutput output;
 
-    float4 local_pos = float4(input.position, 1.0f);
+#ifdef QUANTIZED_VERTICES
+    float3 position = object_data.position_dequantization_offset.xyz + object_data.position_dequantization_scale.xyz * input.position;
+    float3 normal = decodeOctahedral(input.normal);
+    float4 tangent = float4(decodeOctahedral(input.tangent.xy), input.tangent.z);
+#else
+    float3 position = input.position;
+    float3 normal = input.normal;
+    float4 tangent = input.tangent;
+#endif
+
+    float4 local_pos = float4(position, 1.0f);
     float4 world_pos = mul(object_data.model, local_pos);
     output.position =  mul(environment_data.view_projection, worldPos);
     output.worldPos = worldPos.xyz;
 
-    float3 N = mul((float3x3)object_data.model, input.normal);
-    float3 T = normalize(mul((float3x3)object_data.model, input.tangent.xyz));
-    float3 B = normalize(cross(N, T) * input.tangent.w);
+    float3 N = mul((float3x3)object_data.model, normal);
+    float3 T = normalize(mul((float3x3)object_data.model, tangent.xyz));
+    float3 B = normalize(cross(N, T) * tangent.w);
 
     output.normal = normalize(N);
     output.tangent = T;